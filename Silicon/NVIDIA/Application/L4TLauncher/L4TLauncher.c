@@ -19,6 +19,8 @@
 #include <Library/FileHandleLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/AndroidBootImgLib.h>
+#include <Library/ImageDecompressLib.h>
+#include <Library/TimerLib.h>
 
 #include <Protocol/DevicePath.h>
 #include <Protocol/LoadedImage.h>
@@ -26,6 +28,7 @@
 #include <Protocol/AndroidBootImg.h>
 #include <Protocol/BlockIo.h>
 #include <Protocol/DiskIo.h>
+#include <Protocol/DiskIo2.h>
 #include <Protocol/LoadFile2.h>
 
 #include <Guid/LinuxEfiInitrdMedia.h>
@@ -316,6 +319,137 @@ FindPartitionInfo (
   return EFI_SUCCESS;
 }
 
+/**
+  Find the disk a partition is on
+
+  The disk is located by the partition's device path up to its hard drive
+  node, without walking the handle database.
+
+  @param[in]  PartitionHandle  The partition handle
+  @param[out] DiskHandle       The handle of the disk
+
+  @retval EFI_SUCCESS    The operation completed successfully.
+  @retval !=EFI_SUCCESS  Errors occurred.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+GetPartitionDiskHandle (
+  IN  EFI_HANDLE  PartitionHandle,
+  OUT EFI_HANDLE  *DiskHandle
+  )
+{
+  EFI_STATUS                Status;
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+  EFI_DEVICE_PATH_PROTOCOL  *Node;
+  EFI_DEVICE_PATH_PROTOCOL  *RemainingDevicePath;
+
+  DevicePath = DuplicateDevicePath (DevicePathFromHandle (PartitionHandle));
+  if (DevicePath == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  Status = EFI_NOT_FOUND;
+  for (Node = DevicePath; !IsDevicePathEnd (Node); Node = NextDevicePathNode (Node)) {
+    if ((DevicePathType (Node) == MEDIA_DEVICE_PATH) &&
+        (DevicePathSubType (Node) == MEDIA_HARDDRIVE_DP))
+    {
+      SetDevicePathEndNode (Node);
+      RemainingDevicePath = DevicePath;
+      Status              = gBS->LocateDevicePath (&gEfiBlockIoProtocolGuid, &RemainingDevicePath, DiskHandle);
+      if (!EFI_ERROR (Status) && !IsDevicePathEnd (RemainingDevicePath)) {
+        Status = EFI_NOT_FOUND;
+      }
+
+      break;
+    }
+  }
+
+  FreePool (DevicePath);
+
+  return Status;
+}
+
+/**
+  Check that a partition is on the same disk as the loaded image, the way
+  FindPartitionInfo() selects partitions.  The loaded image's disk is looked
+  up once and cached.
+
+  @param[in]  DeviceHandle     The handle of partition where this file lives on.
+  @param[in]  PartitionHandle  The partition handle to check
+
+  @retval TRUE   The partition is on DeviceHandle's disk.
+  @retval FALSE  The partition is on another disk or the check failed.
+
+**/
+STATIC
+BOOLEAN
+EFIAPI
+IsPartitionOnSameDisk (
+  IN EFI_HANDLE  DeviceHandle,
+  IN EFI_HANDLE  PartitionHandle
+  )
+{
+  STATIC EFI_HANDLE  BootDeviceHandle = NULL;
+  STATIC EFI_HANDLE  BootDiskHandle   = NULL;
+  EFI_HANDLE         DiskHandle;
+
+  if (DeviceHandle != BootDeviceHandle) {
+    if (EFI_ERROR (GetPartitionDiskHandle (DeviceHandle, &BootDiskHandle))) {
+      return FALSE;
+    }
+
+    BootDeviceHandle = DeviceHandle;
+  }
+
+  if (EFI_ERROR (GetPartitionDiskHandle (PartitionHandle, &DiskHandle))) {
+    return FALSE;
+  }
+
+  return (DiskHandle == BootDiskHandle);
+}
+
+/**
+  Check if a partition belongs to the other boot chain, the way
+  FindPartitionInfo() falls back to the alternative boot path.
+
+  @param[in]  PartitionInfo    Partition info of the partition
+  @param[in]  BootChain        Numeric version of the chain
+
+  @retval TRUE   The partition has the other chain's A/B prefix or postfix.
+  @retval FALSE  The partition is of this chain or has no chain.
+
+**/
+STATIC
+BOOLEAN
+EFIAPI
+IsAlternateBootChainPartition (
+  IN CONST EFI_PARTITION_INFO_PROTOCOL  *PartitionInfo,
+  IN UINT32                             BootChain
+  )
+{
+  CONST CHAR16  *Name;
+  UINTN         Length;
+  CHAR16        Chain;
+
+  Name   = PartitionInfo->Info.Gpt.PartitionName;
+  Length = StrnLenS (Name, MAX_PARTITION_NAME_SIZE);
+  if (Length < 2) {
+    return FALSE;
+  }
+
+  if (Name[1] == L'_') {
+    Chain = Name[0];
+  } else if (Name[Length - 2] == L'_') {
+    Chain = Name[Length - 1];
+  } else {
+    return FALSE;
+  }
+
+  return ((Chain == (L'B' - BootChain)) || (Chain == (L'b' - BootChain)));
+}
+
 /**
   Update the grub boot configuration file
 
@@ -987,6 +1121,529 @@ CheckCommandString (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Free the strings referenced by an extlinux boot configuration
+
+  @param[in]  BootConfig   Pointer to an extlinux config object
+
+**/
+STATIC
+VOID
+EFIAPI
+FreeExtLinuxBootConfig (
+  IN EXTLINUX_BOOT_CONFIG  *BootConfig
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < BootConfig->NumberOfBootOptions; Index++) {
+    if (BootConfig->BootOptions[Index].BootArgs != NULL) {
+      FreePool (BootConfig->BootOptions[Index].BootArgs);
+      BootConfig->BootOptions[Index].BootArgs = NULL;
+    }
+
+    if (BootConfig->BootOptions[Index].DtbPath != NULL) {
+      FreePool (BootConfig->BootOptions[Index].DtbPath);
+      BootConfig->BootOptions[Index].DtbPath = NULL;
+    }
+
+    if (BootConfig->BootOptions[Index].InitrdPath != NULL) {
+      FreePool (BootConfig->BootOptions[Index].InitrdPath);
+      BootConfig->BootOptions[Index].InitrdPath = NULL;
+    }
+
+    if (BootConfig->BootOptions[Index].Label != NULL) {
+      FreePool (BootConfig->BootOptions[Index].Label);
+      BootConfig->BootOptions[Index].Label = NULL;
+    }
+
+    if (BootConfig->BootOptions[Index].LinuxPath != NULL) {
+      FreePool (BootConfig->BootOptions[Index].LinuxPath);
+      BootConfig->BootOptions[Index].LinuxPath = NULL;
+    }
+
+    if (BootConfig->BootOptions[Index].MenuLabel != NULL) {
+      FreePool (BootConfig->BootOptions[Index].MenuLabel);
+      BootConfig->BootOptions[Index].MenuLabel = NULL;
+    }
+
+    if (BootConfig->BootOptions[Index].Overlays != NULL) {
+      FreePool (BootConfig->BootOptions[Index].Overlays);
+      BootConfig->BootOptions[Index].Overlays = NULL;
+    }
+  }
+
+  if (BootConfig->MenuTitle != NULL) {
+    FreePool (BootConfig->MenuTitle);
+    BootConfig->MenuTitle = NULL;
+  }
+}
+
+/**
+  Return the address of a cached boot option string field
+
+  @param[in]  BootOption   Boot option
+  @param[in]  Field        Field of the boot option
+
+  @retval Address of the string pointer for the field.
+
+**/
+STATIC
+CHAR16 **
+EFIAPI
+ExtLinuxCacheFieldPointer (
+  IN EXTLINUX_BOOT_OPTION  *BootOption,
+  IN EXTLINUX_CACHE_FIELD  Field
+  )
+{
+  switch (Field) {
+    case ExtLinuxCacheLabel:
+      return &BootOption->Label;
+    case ExtLinuxCacheMenuLabel:
+      return &BootOption->MenuLabel;
+    case ExtLinuxCacheLinuxPath:
+      return &BootOption->LinuxPath;
+    case ExtLinuxCacheDtbPath:
+      return &BootOption->DtbPath;
+    case ExtLinuxCacheInitrdPath:
+      return &BootOption->InitrdPath;
+    case ExtLinuxCacheBootArgs:
+      return &BootOption->BootArgs;
+    case ExtLinuxCacheOverlays:
+    default:
+      ASSERT (Field == ExtLinuxCacheOverlays);
+      return &BootOption->Overlays;
+  }
+}
+
+/**
+  Build the key that identifies the current extlinux.conf contents
+
+  The key is made of the rootfs partition GUID, the boot chain and the size
+  and modification time of the configuration file, so checking it does not
+  read the file.
+
+  @param[in]  RootFsHandle   Handle of the rootfs partition
+  @param[in]  BootChain      Numeric version of the chain
+  @param[out] Key            Key of the configuration
+
+  @retval EFI_SUCCESS    The operation completed successfully.
+  @retval !=EFI_SUCCESS  Errors occurred.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+GetExtLinuxCacheKey (
+  IN  EFI_HANDLE          RootFsHandle,
+  IN  UINT32              BootChain,
+  OUT EXTLINUX_CACHE_KEY  *Key
+  )
+{
+  EFI_STATUS                   Status;
+  EFI_PARTITION_INFO_PROTOCOL  *PartitionInfo;
+  EFI_FILE_HANDLE              FileHandle = NULL;
+  EFI_FILE_INFO                *FileInfo  = NULL;
+  UINT64                       FileSize;
+
+  Status = gBS->HandleProtocol (RootFsHandle, &gEfiPartitionInfoProtocolGuid, (VOID **)&PartitionInfo);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (PartitionInfo->Type != PARTITION_TYPE_GPT) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = OpenAndReadUntrustedFileToBuffer (
+             RootFsHandle,
+             EXTLINUX_CONF_PATH,
+             &FileHandle,
+             NULL,
+             &FileSize
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  FileInfo = FileHandleGetInfo (FileHandle);
+  if (FileInfo == NULL) {
+    Status = EFI_DEVICE_ERROR;
+    goto Exit;
+  }
+
+  ZeroMem (Key, sizeof (EXTLINUX_CACHE_KEY));
+  CopyGuid (&Key->PartitionGuid, &PartitionInfo->Info.Gpt.UniquePartitionGUID);
+  Key->BootChain = BootChain;
+  Key->FileSize  = FileSize;
+  CopyMem (&Key->ModificationTime, &FileInfo->ModificationTime, sizeof (EFI_TIME));
+
+Exit:
+  if (FileInfo != NULL) {
+    FreePool (FileInfo);
+  }
+
+  FileHandleClose (FileHandle);
+
+  return Status;
+}
+
+/**
+  Copy a string out of the cached boot descriptor
+
+  @param[in]  Cache      Cached boot descriptor
+  @param[in]  Offset     Offset of the string in the descriptor, 0 if not present
+  @param[out] String     Allocated copy of the string or NULL
+
+  @retval EFI_SUCCESS            The operation completed successfully.
+  @retval EFI_VOLUME_CORRUPTED   The string is outside of the descriptor.
+  @retval EFI_OUT_OF_RESOURCES   Failed buffer allocation.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+ExtLinuxCacheGetString (
+  IN  CONST EXTLINUX_CACHE_HEADER  *Cache,
+  IN  UINT32                       Offset,
+  OUT CHAR16                       **String
+  )
+{
+  CONST CHAR16  *CachedString;
+  UINTN         MaxLength;
+
+  *String = NULL;
+  if (Offset == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if ((Offset < sizeof (EXTLINUX_CACHE_HEADER)) ||
+      (Offset >= Cache->Size) ||
+      ((Offset % sizeof (CHAR16)) != 0))
+  {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  CachedString = (CONST CHAR16 *)((CONST UINT8 *)Cache + Offset);
+  MaxLength    = (Cache->Size - Offset) / sizeof (CHAR16);
+  if (StrnLenS (CachedString, MaxLength) >= MaxLength) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  *String = AllocateCopyPool (StrSize (CachedString), CachedString);
+  if (*String == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Load the extlinux configuration from the boot descriptor cache
+
+  The cache is only used when its key matches the current rootfs partition
+  and extlinux.conf and the cached rootfs is on the same disk as the loaded
+  image, and never when secure boot is enabled as the detached signature of
+  the configuration must be verified on every boot.
+
+  @param[in]  DeviceHandle     The handle of partition where this file lives on.
+  @param[in]  BootChain        Numeric version of the chain
+  @param[out] BootConfig       Pointer to an extlinux config object
+  @param[out] RootFsHandle     Pointer to the handle of the rootfs partition
+
+  @retval EFI_SUCCESS    The configuration was loaded from the cache.
+  @retval !=EFI_SUCCESS  The cache is not present, stale or not usable.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+LoadExtLinuxConfigFromCache (
+  IN  EFI_HANDLE            DeviceHandle,
+  IN  UINT32                BootChain,
+  OUT EXTLINUX_BOOT_CONFIG  *BootConfig,
+  OUT EFI_HANDLE            *RootFsHandle
+  )
+{
+  EFI_STATUS                   Status;
+  EXTLINUX_CACHE_HEADER        *Cache = NULL;
+  UINTN                        CacheSize;
+  UINT32                       Crc32;
+  EXTLINUX_CACHE_KEY           Key;
+  EFI_DEVICE_PATH_PROTOCOL     *DevicePath = NULL;
+  EFI_DEVICE_PATH_PROTOCOL     *RemainingDevicePath;
+  EFI_HANDLE                   Handle;
+  UINTN                        Index;
+  UINTN                        Field;
+  EFI_PARTITION_INFO_PROTOCOL  *PartitionInfo;
+
+  if (IsSecureBootEnabled ()) {
+    return EFI_UNSUPPORTED;
+  }
+
+  CacheSize = EXTLINUX_CACHE_MAX_SIZE;
+  Cache     = AllocatePool (CacheSize);
+  if (Cache == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = gRT->GetVariable (EXTLINUX_CACHE_VARIABLE_NAME, &gNVIDIATokenSpaceGuid, NULL, &CacheSize, Cache);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  if ((CacheSize < sizeof (EXTLINUX_CACHE_HEADER)) ||
+      (Cache->Signature != EXTLINUX_CACHE_SIGNATURE) ||
+      (Cache->Version != EXTLINUX_CACHE_VERSION) ||
+      (Cache->Size != CacheSize) ||
+      (Cache->NumberOfBootOptions == 0) ||
+      (Cache->NumberOfBootOptions > MAX_EXTLINUX_OPTIONS) ||
+      (Cache->DefaultBootEntry >= Cache->NumberOfBootOptions) ||
+      (Cache->RootFsDevicePathOffset < sizeof (EXTLINUX_CACHE_HEADER)) ||
+      (Cache->RootFsDevicePathOffset > CacheSize) ||
+      (Cache->RootFsDevicePathSize > CacheSize - Cache->RootFsDevicePathOffset))
+  {
+    Status = EFI_VOLUME_CORRUPTED;
+    goto Exit;
+  }
+
+  Crc32        = Cache->Crc32;
+  Cache->Crc32 = 0;
+  if (CalculateCrc32 (Cache, CacheSize) != Crc32) {
+    Status = EFI_CRC_ERROR;
+    goto Exit;
+  }
+
+  DevicePath = AllocateCopyPool (Cache->RootFsDevicePathSize, (UINT8 *)Cache + Cache->RootFsDevicePathOffset);
+  if (DevicePath == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  if (!IsDevicePathValid (DevicePath, Cache->RootFsDevicePathSize)) {
+    Status = EFI_VOLUME_CORRUPTED;
+    goto Exit;
+  }
+
+  RemainingDevicePath = DevicePath;
+  Status              = gBS->LocateDevicePath (&gEfiPartitionInfoProtocolGuid, &RemainingDevicePath, &Handle);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  if (!IsDevicePathEnd (RemainingDevicePath)) {
+    Status = EFI_NOT_FOUND;
+    goto Exit;
+  }
+
+  // a cache saved when booting from another disk must not redirect the rootfs
+  if (!IsPartitionOnSameDisk (DeviceHandle, Handle)) {
+    DEBUG ((DEBUG_INFO, "%a: cached rootfs is not on the boot disk\r\n", __FUNCTION__));
+    Status = EFI_NOT_FOUND;
+    goto Exit;
+  }
+
+  Status = GetExtLinuxCacheKey (Handle, BootChain, &Key);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  if (CompareMem (&Key, &Cache->Key, sizeof (EXTLINUX_CACHE_KEY)) != 0) {
+    DEBUG ((DEBUG_INFO, "%a: %s changed, cache is stale\r\n", __FUNCTION__, EXTLINUX_CONF_PATH));
+    Status = EFI_NOT_FOUND;
+    goto Exit;
+  }
+
+  BootConfig->DefaultBootEntry    = Cache->DefaultBootEntry;
+  BootConfig->Timeout             = Cache->Timeout;
+  BootConfig->NumberOfBootOptions = Cache->NumberOfBootOptions;
+
+  Status = ExtLinuxCacheGetString (Cache, Cache->MenuTitleOffset, &BootConfig->MenuTitle);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  for (Index = 0; Index < BootConfig->NumberOfBootOptions; Index++) {
+    for (Field = 0; Field < ExtLinuxCacheFieldMax; Field++) {
+      Status = ExtLinuxCacheGetString (
+                 Cache,
+                 Cache->OptionOffsets[Index][Field],
+                 ExtLinuxCacheFieldPointer (&BootConfig->BootOptions[Index], Field)
+                 );
+      if (EFI_ERROR (Status)) {
+        goto Exit;
+      }
+    }
+  }
+
+  Status = gBS->HandleProtocol (Handle, &gEfiPartitionInfoProtocolGuid, (VOID **)&PartitionInfo);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  if (IsAlternateBootChainPartition (PartitionInfo, BootChain)) {
+    Print (L"Falling back to alternative boot path\r\n");
+  }
+
+  *RootFsHandle = Handle;
+
+Exit:
+  if (EFI_ERROR (Status)) {
+    FreeExtLinuxBootConfig (BootConfig);
+    ZeroMem (BootConfig, sizeof (EXTLINUX_BOOT_CONFIG));
+  }
+
+  if (DevicePath != NULL) {
+    FreePool (DevicePath);
+  }
+
+  FreePool (Cache);
+
+  return Status;
+}
+
+/**
+  Append a string to the boot descriptor being built
+
+  @param[in]      Cache      Boot descriptor being built
+  @param[in]      String     String to append, may be NULL
+  @param[out]     Offset     Offset of the string in the descriptor, 0 if NULL
+
+**/
+STATIC
+VOID
+EFIAPI
+ExtLinuxCacheAddString (
+  IN  EXTLINUX_CACHE_HEADER  *Cache,
+  IN  CONST CHAR16           *String OPTIONAL,
+  OUT UINT32                 *Offset
+  )
+{
+  UINTN  Size;
+
+  if (String == NULL) {
+    *Offset = 0;
+    return;
+  }
+
+  Size = StrSize (String);
+  CopyMem ((UINT8 *)Cache + Cache->Size, String, Size);
+  *Offset      = Cache->Size;
+  Cache->Size += (UINT32)Size;
+}
+
+/**
+  Store the parsed extlinux configuration in the boot descriptor cache
+
+  Failures are not fatal, the next boot will simply parse the configuration
+  again.
+
+  @param[in]  BootChain        Numeric version of the chain
+  @param[in]  BootConfig       Pointer to a parsed extlinux config object
+  @param[in]  RootFsHandle     Handle of the rootfs partition
+
+**/
+STATIC
+VOID
+EFIAPI
+SaveExtLinuxConfigToCache (
+  IN UINT32                BootChain,
+  IN EXTLINUX_BOOT_CONFIG  *BootConfig,
+  IN EFI_HANDLE            RootFsHandle
+  )
+{
+  EFI_STATUS                Status;
+  EXTLINUX_CACHE_HEADER     *Cache;
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+  UINTN                     DevicePathSize;
+  UINTN                     CacheSize;
+  UINTN                     Index;
+  UINTN                     Field;
+  CHAR16                    *String;
+
+  if (IsSecureBootEnabled ()) {
+    return;
+  }
+
+  DevicePath = DevicePathFromHandle (RootFsHandle);
+  if (DevicePath == NULL) {
+    return;
+  }
+
+  DevicePathSize = GetDevicePathSize (DevicePath);
+
+  CacheSize = sizeof (EXTLINUX_CACHE_HEADER) + DevicePathSize;
+  if (BootConfig->MenuTitle != NULL) {
+    CacheSize += StrSize (BootConfig->MenuTitle);
+  }
+
+  for (Index = 0; Index < BootConfig->NumberOfBootOptions; Index++) {
+    for (Field = 0; Field < ExtLinuxCacheFieldMax; Field++) {
+      String = *ExtLinuxCacheFieldPointer (&BootConfig->BootOptions[Index], Field);
+      if (String != NULL) {
+        CacheSize += StrSize (String);
+      }
+    }
+  }
+
+  if (CacheSize > EXTLINUX_CACHE_MAX_SIZE) {
+    DEBUG ((DEBUG_INFO, "%a: configuration too large to cache (%u bytes)\r\n", __FUNCTION__, CacheSize));
+    gRT->SetVariable (EXTLINUX_CACHE_VARIABLE_NAME, &gNVIDIATokenSpaceGuid, 0, 0, NULL);
+    return;
+  }
+
+  Cache = AllocateZeroPool (CacheSize);
+  if (Cache == NULL) {
+    return;
+  }
+
+  Status = GetExtLinuxCacheKey (RootFsHandle, BootChain, &Cache->Key);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Cache->Signature           = EXTLINUX_CACHE_SIGNATURE;
+  Cache->Version             = EXTLINUX_CACHE_VERSION;
+  Cache->Size                = sizeof (EXTLINUX_CACHE_HEADER);
+  Cache->DefaultBootEntry    = BootConfig->DefaultBootEntry;
+  Cache->Timeout             = BootConfig->Timeout;
+  Cache->NumberOfBootOptions = BootConfig->NumberOfBootOptions;
+
+  ExtLinuxCacheAddString (Cache, BootConfig->MenuTitle, &Cache->MenuTitleOffset);
+  for (Index = 0; Index < BootConfig->NumberOfBootOptions; Index++) {
+    for (Field = 0; Field < ExtLinuxCacheFieldMax; Field++) {
+      ExtLinuxCacheAddString (
+        Cache,
+        *ExtLinuxCacheFieldPointer (&BootConfig->BootOptions[Index], Field),
+        &Cache->OptionOffsets[Index][Field]
+        );
+    }
+  }
+
+  // Device path last so that the strings stay CHAR16 aligned
+  CopyMem ((UINT8 *)Cache + Cache->Size, DevicePath, DevicePathSize);
+  Cache->RootFsDevicePathOffset = Cache->Size;
+  Cache->RootFsDevicePathSize   = (UINT32)DevicePathSize;
+  Cache->Size                  += (UINT32)DevicePathSize;
+  ASSERT (Cache->Size == CacheSize);
+
+  Cache->Crc32 = CalculateCrc32 (Cache, Cache->Size);
+
+  Status = gRT->SetVariable (
+                  EXTLINUX_CACHE_VARIABLE_NAME,
+                  &gNVIDIATokenSpaceGuid,
+                  EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_NON_VOLATILE,
+                  Cache->Size,
+                  Cache
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "%a: failed to store boot descriptor cache: %r\r\n", __FUNCTION__, Status));
+  }
+
+Exit:
+  FreePool (Cache);
+}
+
 /**
   Process the extlinux.conf file
 
@@ -1025,6 +1682,12 @@ ProcessExtLinuxConfig (
     return EFI_INVALID_PARAMETER;
   }
 
+  Status = LoadExtLinuxConfigFromCache (DeviceHandle, BootChain, BootConfig, RootFsHandle);
+  if (!EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "%a: using cached %s\r\n", __FUNCTION__, EXTLINUX_CONF_PATH));
+    return EFI_SUCCESS;
+  }
+
   Status = FindPartitionInfo (DeviceHandle, ROOTFS_BASE_NAME, BootChain, NULL, RootFsHandle);
   if (EFI_ERROR (Status)) {
     ErrorPrint (L"%a: Unable to find partition info\r\n", __FUNCTION__);
@@ -1164,9 +1827,11 @@ ProcessExtLinuxConfig (
 
   if (BootConfig->NumberOfBootOptions == 0) {
     return EFI_NOT_FOUND;
-  } else {
-    return EFI_SUCCESS;
   }
+
+  SaveExtLinuxConfigToCache (BootChain, BootConfig, *RootFsHandle);
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -1624,6 +2289,270 @@ ProcessBootParams (
   return EFI_SUCCESS;
 }
 
+/**
+  Read android style boot image data, from the disk or from memory.
+
+  @param[in]  Context           ANDROID_KERNEL_READ_CONTEXT of the image.
+  @param[in]  Offset            Data offset relative to the context offset.
+  @param[out] Buffer            The memory buffer to transfer the data to.
+  @param[in]  Size              Size of the memory buffer to transfer the data to.
+
+  @retval EFI_SUCCESS    The operation completed successfully.
+  @retval !=EFI_SUCCESS  Errors occurred.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+AndroidKernelRead (
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  OUT VOID    *Buffer,
+  IN  UINTN   Size
+  )
+{
+  ANDROID_KERNEL_READ_CONTEXT  *ReadContext;
+
+  ReadContext = (ANDROID_KERNEL_READ_CONTEXT *)Context;
+  if (ReadContext->Buffer != NULL) {
+    CopyMem (Buffer, ReadContext->Buffer + ReadContext->Offset + Offset, Size);
+    return EFI_SUCCESS;
+  }
+
+  return ReadContext->DiskIo->ReadDisk (
+                                ReadContext->DiskIo,
+                                ReadContext->BlockIo->Media->MediaId,
+                                ReadContext->Offset + Offset,
+                                Size,
+                                Buffer
+                                );
+}
+
+/**
+  Start reading the next chunk of a compressed kernel through DiskIo2, so the
+  disk read overlaps with inflating the previous chunk.
+
+  @param[in]  Context           ANDROID_KERNEL_READ_CONTEXT of the image.
+  @param[in]  Offset            Data offset relative to the context offset.
+  @param[out] Buffer            The memory buffer to transfer the data to.
+  @param[in]  Size              Size of the memory buffer to transfer the data to.
+
+  @retval EFI_SUCCESS      The read was started.
+  @retval EFI_UNSUPPORTED  The image is not read through DiskIo2.
+  @retval !=EFI_SUCCESS    Errors occurred.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+AndroidKernelReadStart (
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  OUT VOID    *Buffer,
+  IN  UINTN   Size
+  )
+{
+  EFI_STATUS                   Status;
+  ANDROID_KERNEL_READ_CONTEXT  *ReadContext;
+
+  ReadContext = (ANDROID_KERNEL_READ_CONTEXT *)Context;
+  if ((ReadContext->DiskIo2 == NULL) || (ReadContext->Buffer != NULL)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (ReadContext->Token.Event == NULL) {
+    Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &ReadContext->Token.Event);
+    if (EFI_ERROR (Status)) {
+      ReadContext->Token.Event = NULL;
+      return Status;
+    }
+  }
+
+  ReadContext->Token.TransactionStatus = EFI_NOT_READY;
+
+  return ReadContext->DiskIo2->ReadDiskEx (
+                                 ReadContext->DiskIo2,
+                                 ReadContext->BlockIo->Media->MediaId,
+                                 ReadContext->Offset + Offset,
+                                 &ReadContext->Token,
+                                 Size,
+                                 Buffer
+                                 );
+}
+
+/**
+  Wait for the read started by AndroidKernelReadStart.
+
+  @param[in]  Context           ANDROID_KERNEL_READ_CONTEXT of the image.
+
+  @retval EFI_SUCCESS    The read completed.
+  @retval !=EFI_SUCCESS  Errors occurred.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+AndroidKernelReadWait (
+  IN  VOID  *Context
+  )
+{
+  ANDROID_KERNEL_READ_CONTEXT  *ReadContext;
+
+  ReadContext = (ANDROID_KERNEL_READ_CONTEXT *)Context;
+  while (gBS->CheckEvent (ReadContext->Token.Event) == EFI_NOT_READY) {
+  }
+
+  return ReadContext->Token.TransactionStatus;
+}
+
+/**
+  Build a copy of an android style boot image with its compressed kernel
+  inflated, as AndroidBootImgBoot() can only start an uncompressed kernel.
+
+  The new image keeps the layout of the original one: the header page, the
+  kernel padded to the page size, then the rest of the images.
+
+  This function allocates memory for Image with AllocatePool; the
+  caller is responsible for passing Image to FreePool after use.
+
+  @param[in]  Header            Header of the boot image.
+  @param[in]  ReadContext       Source of the boot image, at the header.
+  @param[in]  Compression       Compression of the kernel.
+  @param[in]  SourceSize        Size of the boot image.
+  @param[out] Image             Pointer to the new boot image.
+  @param[out] ImageSize         Size of the new boot image.
+
+  @retval EFI_SUCCESS    The operation completed successfully.
+  @retval !=EFI_SUCCESS  Errors occurred.
+
+**/
+STATIC
+EFI_STATUS
+InflateAndroidKernel (
+  IN  CONST ANDROID_BOOTIMG_HEADER       *Header,
+  IN        ANDROID_KERNEL_READ_CONTEXT  *ReadContext,
+  IN        IMAGE_COMPRESSION_TYPE       Compression,
+  IN        UINTN                        SourceSize,
+  OUT       VOID                         **Image,
+  OUT       UINTN                        *ImageSize
+  )
+{
+  EFI_STATUS               Status;
+  UINTN                    KernelPages;
+  UINTN                    TailSize;
+  UINT64                   LoadSize;
+  UINTN                    LoadPages;
+  UINT8                    *NewImage;
+  UINTN                    NewImageSize;
+  IMAGE_DECOMPRESS_READER  Reader;
+  IMAGE_DECOMPRESS_STATS   Stats;
+  UINT64                   StartTime;
+
+  NewImage    = NULL;
+  KernelPages = ALIGN_VALUE (Header->KernelSize, Header->PageSize);
+  if (SourceSize < Header->PageSize + KernelPages) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  TailSize = SourceSize - Header->PageSize - KernelPages;
+
+  ReadContext->Offset += Header->PageSize;
+  Status               = ImageDecompressGetSize (
+                           Compression,
+                           AndroidKernelRead,
+                           ReadContext,
+                           Header->KernelSize,
+                           &LoadSize
+                           );
+  if (EFI_ERROR (Status) || (LoadSize == 0) || (LoadSize > MAX_UINT32)) {
+    ErrorPrint (L"Invalid compressed kernel: %r
+", Status);
+    Status = EFI_ERROR (Status) ? Status : EFI_VOLUME_CORRUPTED;
+    goto Exit;
+  }
+
+  LoadPages    = ALIGN_VALUE ((UINTN)LoadSize, Header->PageSize);
+  NewImageSize = Header->PageSize + LoadPages + TailSize;
+  NewImage     = AllocatePool (NewImageSize);
+  if (NewImage == NULL) {
+    ErrorPrint (L"Failed to allocate buffer for Image
+");
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  // Header page and the images after the kernel are copied as is
+  ReadContext->Offset -= Header->PageSize;
+  Status               = AndroidKernelRead (ReadContext, 0, NewImage, Header->PageSize);
+  if (!EFI_ERROR (Status) && (TailSize != 0)) {
+    Status = AndroidKernelRead (
+               ReadContext,
+               Header->PageSize + KernelPages,
+               NewImage + Header->PageSize + LoadPages,
+               TailSize
+               );
+  }
+
+  if (EFI_ERROR (Status)) {
+    ErrorPrint (L"Failed to read disk
+");
+    goto Exit;
+  }
+
+  ZeroMem (NewImage + Header->PageSize + LoadSize, LoadPages - (UINTN)LoadSize);
+
+  // The next chunk is read through DiskIo2 while the current one is inflated
+  Reader.Read      = AndroidKernelRead;
+  Reader.ReadStart = AndroidKernelReadStart;
+  Reader.ReadWait  = AndroidKernelReadWait;
+
+  ReadContext->Offset += Header->PageSize;
+  StartTime            = GetPerformanceCounter ();
+  Status               = ImageDecompressEx (
+                           Compression,
+                           &Reader,
+                           ReadContext,
+                           Header->KernelSize,
+                           NewImage + Header->PageSize,
+                           (UINTN)LoadSize,
+                           &Stats
+                           );
+  if (EFI_ERROR (Status)) {
+    ErrorPrint (L"Failed to decompress kernel: %r
+", Status);
+    goto Exit;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: kernel decompressed %llu -> %llu bytes in %u reads (%u overlapped), %llu us\n",
+    __FUNCTION__,
+    Stats.CompressedSize,
+    Stats.DecompressedSize,
+    Stats.ReadCount,
+    Stats.ReadAheadCount,
+    DivU64x32 (GetTimeInNanoSecond (GetPerformanceCounter () - StartTime), 1000)
+    ));
+
+  ((ANDROID_BOOTIMG_HEADER *)NewImage)->KernelSize = (UINT32)LoadSize;
+
+  *Image     = NewImage;
+  NewImage   = NULL;
+  *ImageSize = NewImageSize;
+
+Exit:
+  if (ReadContext->Token.Event != NULL) {
+    gBS->CloseEvent (ReadContext->Token.Event);
+    ReadContext->Token.Event = NULL;
+  }
+
+  if (NewImage != NULL) {
+    FreePool (NewImage);
+  }
+
+  return Status;
+}
+
 /**
   Reads an android style kernel partition located with Partition base
   name and bootchain.
@@ -1651,17 +2580,22 @@ ReadAndroidStyleKernelPartition (
   OUT       UINTN            *CONST  ImageSize
   )
 {
-  EFI_STATUS              Status;
-  EFI_HANDLE              PartitionHandle;
-  EFI_BLOCK_IO_PROTOCOL   *BlockIo;
-  EFI_DISK_IO_PROTOCOL    *DiskIo;
-  UINTN                   Offset;
-  ANDROID_BOOTIMG_HEADER  ImageHeader;
-  VOID                    *ImageBuffer = NULL;
-  UINTN                   ImageBufferSize;
-  UINTN                   SignatureOffset;
-  UINT8                   Signature[SIZE_2KB];
-  CONST UINTN             SignatureSize = sizeof (Signature);
+  EFI_STATUS                   Status;
+  EFI_HANDLE                   PartitionHandle;
+  EFI_BLOCK_IO_PROTOCOL        *BlockIo;
+  EFI_DISK_IO_PROTOCOL         *DiskIo;
+  EFI_DISK_IO2_PROTOCOL        *DiskIo2;
+  UINTN                        Offset;
+  ANDROID_BOOTIMG_HEADER       ImageHeader;
+  VOID                         *ImageBuffer = NULL;
+  UINTN                        ImageBufferSize;
+  UINTN                        SignatureOffset;
+  UINT8                        Signature[SIZE_2KB];
+  CONST UINTN                  SignatureSize = sizeof (Signature);
+  UINT32                       Magic;
+  IMAGE_COMPRESSION_TYPE       Compression;
+  ANDROID_KERNEL_READ_CONTEXT  ReadContext;
+  VOID                         *KernelImage;
 
   Status = FindPartitionInfo (
              DeviceHandle,
@@ -1730,6 +2664,41 @@ ReadAndroidStyleKernelPartition (
     }
   }
 
+  if (EFI_ERROR (gBS->HandleProtocol (PartitionHandle, &gEfiDiskIo2ProtocolGuid, (VOID **)&DiskIo2))) {
+    DiskIo2 = NULL;
+  }
+
+  ZeroMem (&ReadContext, sizeof (ReadContext));
+  ReadContext.BlockIo = BlockIo;
+  ReadContext.DiskIo  = DiskIo;
+  ReadContext.DiskIo2 = DiskIo2;
+  ReadContext.Offset  = Offset;
+
+  Compression = ImageCompressionNone;
+  if (ImageHeader.KernelSize >= sizeof (Magic)) {
+    Status = AndroidKernelRead (&ReadContext, ImageHeader.PageSize, &Magic, sizeof (Magic));
+    if (EFI_ERROR (Status)) {
+      ErrorPrint (L"Failed to read disk\r\n");
+      goto Exit;
+    }
+
+    Compression = ImageDecompressGetType (&Magic, sizeof (Magic));
+  }
+
+  // Without a signature to check first, a compressed kernel is inflated
+  // straight from the partition
+  if ((Compression != ImageCompressionNone) && !IsSecureBootEnabled ()) {
+    Status = InflateAndroidKernel (
+               &ImageHeader,
+               &ReadContext,
+               Compression,
+               ImageBufferSize,
+               Image,
+               ImageSize
+               );
+    goto Exit;
+  }
+
   ImageBuffer = AllocatePool (ImageBufferSize);
   if (ImageBuffer == NULL) {
     ErrorPrint (L"Failed to allocate buffer for Image\r\n");
@@ -1775,6 +2744,27 @@ ReadAndroidStyleKernelPartition (
     }
   }
 
+  // The signature covers the compressed image, so nothing is decoded before it
+  // is verified and the kernel is then inflated from memory
+  if (Compression != ImageCompressionNone) {
+    ReadContext.Buffer = ImageBuffer;
+    ReadContext.Offset = 0;
+    Status             = InflateAndroidKernel (
+                           &ImageHeader,
+                           &ReadContext,
+                           Compression,
+                           ImageBufferSize,
+                           &KernelImage,
+                           &ImageBufferSize
+                           );
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+
+    FreePool (ImageBuffer);
+    ImageBuffer = KernelImage;
+  }
+
   *Image      = ImageBuffer;
   ImageBuffer = NULL;
   *ImageSize  = ImageBufferSize;
@@ -2080,7 +3070,6 @@ L4TLauncher (
   L4T_BOOT_PARAMS            BootParams;
   EXTLINUX_BOOT_CONFIG       ExtLinuxConfig;
   UINTN                      ExtLinuxBootOption;
-  UINTN                      Index;
 
   Status = gBS->HandleProtocol (ImageHandle, &gEfiLoadedImageProtocolGuid, (VOID **)&LoadedImage);
   if (EFI_ERROR (Status)) {
@@ -2156,42 +3145,7 @@ L4TLauncher (
       }
     } while (FALSE);
 
-    for (Index = 0; Index < ExtLinuxConfig.NumberOfBootOptions; Index++) {
-      if (ExtLinuxConfig.BootOptions[Index].BootArgs != NULL) {
-        FreePool (ExtLinuxConfig.BootOptions[Index].BootArgs);
-        ExtLinuxConfig.BootOptions[Index].BootArgs = NULL;
-      }
-
-      if (ExtLinuxConfig.BootOptions[Index].DtbPath != NULL) {
-        FreePool (ExtLinuxConfig.BootOptions[Index].DtbPath);
-        ExtLinuxConfig.BootOptions[Index].DtbPath = NULL;
-      }
-
-      if (ExtLinuxConfig.BootOptions[Index].InitrdPath != NULL) {
-        FreePool (ExtLinuxConfig.BootOptions[Index].InitrdPath);
-        ExtLinuxConfig.BootOptions[Index].InitrdPath = NULL;
-      }
-
-      if (ExtLinuxConfig.BootOptions[Index].Label != NULL) {
-        FreePool (ExtLinuxConfig.BootOptions[Index].Label);
-        ExtLinuxConfig.BootOptions[Index].Label = NULL;
-      }
-
-      if (ExtLinuxConfig.BootOptions[Index].LinuxPath != NULL) {
-        FreePool (ExtLinuxConfig.BootOptions[Index].LinuxPath);
-        ExtLinuxConfig.BootOptions[Index].LinuxPath = NULL;
-      }
-
-      if (ExtLinuxConfig.BootOptions[Index].MenuLabel != NULL) {
-        FreePool (ExtLinuxConfig.BootOptions[Index].MenuLabel);
-        ExtLinuxConfig.BootOptions[Index].MenuLabel = NULL;
-      }
-    }
-
-    if (ExtLinuxConfig.MenuTitle != NULL) {
-      FreePool (ExtLinuxConfig.MenuTitle);
-      ExtLinuxConfig.MenuTitle = NULL;
-    }
+    FreeExtLinuxBootConfig (&ExtLinuxConfig);
   }
 
   // Not in else to allow fallback
@@ -69,6 +69,51 @@ typedef struct {
   UINT32                  Timeout;
 } EXTLINUX_BOOT_CONFIG;
 
+//
+// Pre-parsed extlinux.conf descriptor cached in a UEFI variable so that an
+// unchanged configuration skips partition discovery and parsing.
+//
+#define EXTLINUX_CACHE_VARIABLE_NAME  L"L4TExtLinuxCache"
+#define EXTLINUX_CACHE_SIGNATURE      SIGNATURE_32 ('L', '4', 'T', 'X')
+#define EXTLINUX_CACHE_VERSION        2
+#define EXTLINUX_CACHE_MAX_SIZE       SIZE_8KB
+
+typedef enum {
+  ExtLinuxCacheLabel,
+  ExtLinuxCacheMenuLabel,
+  ExtLinuxCacheLinuxPath,
+  ExtLinuxCacheDtbPath,
+  ExtLinuxCacheInitrdPath,
+  ExtLinuxCacheBootArgs,
+  ExtLinuxCacheOverlays,
+  ExtLinuxCacheFieldMax
+} EXTLINUX_CACHE_FIELD;
+
+#pragma pack(1)
+typedef struct {
+  EFI_GUID    PartitionGuid;
+  UINT32      BootChain;
+  UINT64      FileSize;
+  EFI_TIME    ModificationTime;
+} EXTLINUX_CACHE_KEY;
+
+typedef struct {
+  UINT32                Signature;
+  UINT32                Version;
+  UINT32                Size;
+  UINT32                Crc32;
+  EXTLINUX_CACHE_KEY    Key;
+  UINT32                DefaultBootEntry;
+  UINT32                Timeout;
+  UINT32                NumberOfBootOptions;
+  UINT32                MenuTitleOffset;
+  UINT32                RootFsDevicePathOffset;
+  UINT32                RootFsDevicePathSize;
+  UINT32                OptionOffsets[MAX_EXTLINUX_OPTIONS][ExtLinuxCacheFieldMax];
+  // UINT8            Data[];
+} EXTLINUX_CACHE_HEADER;
+#pragma pack()
+
 STATIC VOID   *mRamdiskData = NULL;
 STATIC UINTN  mRamdiskSize  = 0;
 
@@ -77,6 +122,16 @@ typedef struct {
   EFI_DEVICE_PATH_PROTOCOL    EndNode;
 } RAMDISK_DEVICE_PATH;
 
+// Source of an android style boot image being inflated
+typedef struct {
+  EFI_BLOCK_IO_PROTOCOL    *BlockIo;
+  EFI_DISK_IO_PROTOCOL     *DiskIo;
+  EFI_DISK_IO2_PROTOCOL    *DiskIo2;  // NULL if reads can't run in the background
+  EFI_DISK_IO2_TOKEN       Token;
+  CONST UINT8              *Buffer;   // image already in memory, or NULL to read the disk
+  UINT64                   Offset;
+} ANDROID_KERNEL_READ_CONTEXT;
+
 STATIC CONST RAMDISK_DEVICE_PATH  mRamdiskDevicePath =
 {
   {
@@ -235,6 +235,181 @@ AndroidBootRead (
   return EFI_INVALID_PARAMETER;
 }
 
+/**
+  Read compressed kernel data on behalf of the image decompressor.
+
+  @param[in]  Context             ANDROID_BOOT_READ_CONTEXT of the kernel image.
+  @param[in]  Offset              Data offset in the kernel image to read from.
+  @param[out] Buffer              The memory buffer to transfer the data to.
+  @param[in]  Size                Size of the memory buffer to transfer the data to.
+
+  @retval EFI_SUCCESS             Operation successful.
+  @retval others                  Error occurred
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+AndroidBootDecompressRead (
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  OUT VOID    *Buffer,
+  IN  UINTN   Size
+  )
+{
+  ANDROID_BOOT_READ_CONTEXT  *ReadContext;
+
+  ReadContext = (ANDROID_BOOT_READ_CONTEXT *)Context;
+
+  return AndroidBootRead (
+           ReadContext->BlockIo,
+           ReadContext->DiskIo,
+           ReadContext->Offset + (UINT32)Offset,
+           Buffer,
+           Size
+           );
+}
+
+/**
+  Start reading the next chunk of compressed kernel data in the background,
+  so the partition read overlaps with inflating the previous chunk.
+
+  @param[in]  Context             ANDROID_BOOT_READ_CONTEXT of the kernel image.
+  @param[in]  Offset              Data offset in the kernel image to read from.
+  @param[out] Buffer              The memory buffer to transfer the data to.
+  @param[in]  Size                Size of the memory buffer to transfer the data to.
+
+  @retval EFI_SUCCESS             The read was started.
+  @retval EFI_UNSUPPORTED         The partition has no DiskIo2 interface.
+  @retval others                  Error occurred
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+AndroidBootDecompressReadStart (
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  OUT VOID    *Buffer,
+  IN  UINTN   Size
+  )
+{
+  ANDROID_BOOT_READ_CONTEXT  *ReadContext;
+  EFI_STATUS                 Status;
+
+  ReadContext = (ANDROID_BOOT_READ_CONTEXT *)Context;
+  if ((ReadContext->DiskIo2 == NULL) || (ReadContext->BlockIo == NULL)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (ReadContext->Token.Event == NULL) {
+    Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &ReadContext->Token.Event);
+    if (EFI_ERROR (Status)) {
+      ReadContext->Token.Event = NULL;
+      return Status;
+    }
+  }
+
+  ReadContext->Token.TransactionStatus = EFI_NOT_READY;
+
+  return ReadContext->DiskIo2->ReadDiskEx (
+                                 ReadContext->DiskIo2,
+                                 ReadContext->BlockIo->Media->MediaId,
+                                 ReadContext->Offset + Offset,
+                                 &ReadContext->Token,
+                                 Size,
+                                 Buffer
+                                 );
+}
+
+/**
+  Wait for the background read started by AndroidBootDecompressReadStart.
+
+  @param[in]  Context             ANDROID_BOOT_READ_CONTEXT of the kernel image.
+
+  @retval EFI_SUCCESS             The read completed.
+  @retval others                  Error occurred
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+AndroidBootDecompressReadWait (
+  IN  VOID  *Context
+  )
+{
+  ANDROID_BOOT_READ_CONTEXT  *ReadContext;
+
+  ReadContext = (ANDROID_BOOT_READ_CONTEXT *)Context;
+
+  // Polled rather than WaitForEvent() so this works at any caller TPL
+  while (gBS->CheckEvent (ReadContext->Token.Event) == EFI_NOT_READY) {
+  }
+
+  return ReadContext->Token.TransactionStatus;
+}
+
+/**
+  Detect a compressed kernel in the Android Boot image and get the size of the
+  buffer needed to load it.
+
+  @param[in]      BlockIo         BlockIo protocol interface which is already located.
+  @param[in]      DiskIo          DiskIo protocol interface which is already located.
+  @param[in, out] ImgData         Internal data structure with the kernel location
+                                  filled in. KernelCompression and KernelLoadSize
+                                  are set on return.
+
+  @retval EFI_SUCCESS             Operation successful.
+  @retval others                  Error occurred
+**/
+STATIC
+EFI_STATUS
+AndroidBootGetKernelLoadSize (
+  IN     EFI_BLOCK_IO_PROTOCOL  *BlockIo,
+  IN     EFI_DISK_IO_PROTOCOL   *DiskIo,
+  IN OUT ANDROID_BOOT_DATA      *ImgData
+  )
+{
+  EFI_STATUS                 Status;
+  ANDROID_BOOT_READ_CONTEXT  ReadContext;
+  UINT32                     Magic;
+  UINT64                     LoadSize;
+
+  ImgData->KernelCompression = ImageCompressionNone;
+  ImgData->KernelLoadSize    = ImgData->KernelSize;
+
+  if (ImgData->KernelSize < sizeof (Magic)) {
+    return EFI_SUCCESS;
+  }
+
+  ReadContext.BlockIo = BlockIo;
+  ReadContext.DiskIo  = DiskIo;
+  ReadContext.Offset  = ImgData->PageSize + ImgData->Offset;
+
+  Status = AndroidBootDecompressRead (&ReadContext, 0, &Magic, sizeof (Magic));
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ImgData->KernelCompression = ImageDecompressGetType (&Magic, sizeof (Magic));
+  if (ImgData->KernelCompression == ImageCompressionNone) {
+    return EFI_SUCCESS;
+  }
+
+  Status = ImageDecompressGetSize (
+             ImgData->KernelCompression,
+             AndroidBootDecompressRead,
+             &ReadContext,
+             ImgData->KernelSize,
+             &LoadSize
+             );
+  if (EFI_ERROR (Status) || (LoadSize == 0) || (LoadSize > MAX_UINTN)) {
+    DEBUG ((DEBUG_ERROR, "%a: invalid compressed kernel (type %u): %r\n", __FUNCTION__, ImgData->KernelCompression, Status));
+    return EFI_ERROR (Status) ? Status : EFI_VOLUME_CORRUPTED;
+  }
+
+  ImgData->KernelLoadSize = LoadSize;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Verify if there is the Android Boot image file by reading the magic word at the first
   block of the Android Boot image and save the important size information when a container
@@ -358,6 +533,12 @@ AndroidBootGetVerify (
     ImgData->KernelSize  = Header->KernelSize;
     ImgData->RamdiskSize = Header->RamdiskSize;
     ImgData->PageSize    = Header->PageSize;
+
+    // A compressed kernel is inflated into the boot manager buffer at load time
+    Status = AndroidBootGetKernelLoadSize (BlockIo, DiskIo, ImgData);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
   }
 
   if (KernelArgs != NULL) {
@@ -379,6 +560,8 @@ Exit:
 
   @param[in]  BlockIo             BlockIo protocol interface which is already located.
   @param[in]  DiskIo              DiskIo protocol interface which is already located.
+  @param[in]  DiskIo2             DiskIo2 protocol interface used to read a compressed
+                                  kernel ahead of the decompressor, or NULL.
   @param[in]  ImgData             A pointer to the internal data structure to retain
                                   the important size data of kernel and initrd images
                                   contained in the Android Boot image header.
@@ -391,16 +574,22 @@ EFI_STATUS
 AndroidBootLoadFile (
   IN EFI_BLOCK_IO_PROTOCOL  *BlockIo,
   IN EFI_DISK_IO_PROTOCOL   *DiskIo,
+  IN EFI_DISK_IO2_PROTOCOL  *DiskIo2 OPTIONAL,
   IN ANDROID_BOOT_DATA      *ImgData,
   IN VOID                   *Buffer
   )
 {
-  EFI_STATUS  Status;
-  EFI_HANDLE  InitrdHandle;
-  EFI_EVENT   InitrdEvent;
-  UINTN       Addr;
-  UINTN       BufSize;
-  UINTN       BufBase;
+  EFI_STATUS                 Status;
+  EFI_HANDLE                 InitrdHandle;
+  EFI_EVENT                  InitrdEvent;
+  UINTN                      Addr;
+  UINTN                      BufSize;
+  UINTN                      BufBase;
+  ANDROID_BOOT_READ_CONTEXT  ReadContext;
+  IMAGE_DECOMPRESS_READER    Reader;
+  IMAGE_DECOMPRESS_STATS     Stats;
+  UINT64                     StartTime;
+  UINT64                     ElapsedUs;
 
   mInitRdBaseAddress = 0;
   mInitRdSize        = 0;
@@ -420,13 +609,57 @@ AndroidBootLoadFile (
   Addr    = ImgData->PageSize + ImgData->Offset;
   BufSize = ImgData->KernelSize;
   BufBase = (UINTN)Buffer;
-  Status  = AndroidBootRead (
-              BlockIo,
-              DiskIo,
-              Addr,
-              (VOID *)BufBase,
-              BufSize
-              );
+  if (ImgData->KernelCompression != ImageCompressionNone) {
+    // Inflate straight from the partition, one chunk at a time, reading the
+    // next chunk through DiskIo2 while the current one is decoded
+    ZeroMem (&ReadContext, sizeof (ReadContext));
+    ReadContext.BlockIo = BlockIo;
+    ReadContext.DiskIo  = DiskIo;
+    ReadContext.DiskIo2 = DiskIo2;
+    ReadContext.Offset  = Addr;
+
+    Reader.Read      = AndroidBootDecompressRead;
+    Reader.ReadStart = (DiskIo2 != NULL) ? AndroidBootDecompressReadStart : NULL;
+    Reader.ReadWait  = (DiskIo2 != NULL) ? AndroidBootDecompressReadWait : NULL;
+
+    StartTime = GetPerformanceCounter ();
+    Status    = ImageDecompressEx (
+                  ImgData->KernelCompression,
+                  &Reader,
+                  &ReadContext,
+                  BufSize,
+                  (VOID *)BufBase,
+                  (UINTN)ImgData->KernelLoadSize,
+                  &Stats
+                  );
+    if (ReadContext.Token.Event != NULL) {
+      gBS->CloseEvent (ReadContext.Token.Event);
+    }
+
+    if (!EFI_ERROR (Status)) {
+      ElapsedUs = DivU64x32 (GetTimeInNanoSecond (GetPerformanceCounter () - StartTime), 1000);
+      DEBUG ((
+        DEBUG_INFO,
+        "%a: kernel decompressed %llu -> %llu bytes in %u reads (%u overlapped), %llu us (%llu KB/ms)\n",
+        __FUNCTION__,
+        Stats.CompressedSize,
+        Stats.DecompressedSize,
+        Stats.ReadCount,
+        Stats.ReadAheadCount,
+        ElapsedUs,
+        DivU64x64Remainder (Stats.DecompressedSize, MAX (ElapsedUs, 1), NULL)
+        ));
+    }
+  } else {
+    Status = AndroidBootRead (
+               BlockIo,
+               DiskIo,
+               Addr,
+               (VOID *)BufBase,
+               BufSize
+               );
+  }
+
   if (EFI_ERROR (Status)) {
     DEBUG ((
       DEBUG_ERROR,
@@ -603,13 +836,13 @@ AndroidBootDxeLoadFile (
     return EFI_NOT_FOUND;
   }
 
-  if ((Buffer == NULL) || (*BufferSize < ImgData.KernelSize)) {
-    *BufferSize = ImgData.KernelSize;
+  if ((Buffer == NULL) || (*BufferSize < ImgData.KernelLoadSize)) {
+    *BufferSize = (UINTN)ImgData.KernelLoadSize;
     return EFI_BUFFER_TOO_SMALL;
   }
 
   // Load Android Boot image
-  Status = AndroidBootLoadFile (Private->BlockIo, Private->DiskIo, &ImgData, Buffer);
+  Status = AndroidBootLoadFile (Private->BlockIo, Private->DiskIo, Private->DiskIo2, &ImgData, Buffer);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -893,6 +1126,7 @@ AndroidBootDriverBindingStart (
   EFI_STATUS                 Status;
   EFI_BLOCK_IO_PROTOCOL      *BlockIo = NULL;
   EFI_DISK_IO_PROTOCOL       *DiskIo  = NULL;
+  EFI_DISK_IO2_PROTOCOL      *DiskIo2 = NULL;
   EFI_DEVICE_PATH_PROTOCOL   *ParentDevicePath;
   EFI_DEVICE_PATH_PROTOCOL   *AndroidBootDevicePath;
   EFI_DEVICE_PATH_PROTOCOL   *Node;
@@ -947,6 +1181,16 @@ AndroidBootDriverBindingStart (
     return Status;
   }
 
+  // DiskIo2 is optional, it only lets a compressed kernel be read ahead of the decompressor
+  Status = gBS->HandleProtocol (
+                  ControllerHandle,
+                  &gEfiDiskIo2ProtocolGuid,
+                  (VOID **)&DiskIo2
+                  );
+  if (EFI_ERROR (Status)) {
+    DiskIo2 = NULL;
+  }
+
   // Allocate KernelArgs
   KernelArgs = AllocateZeroPool (sizeof (CHAR16) * ANDROID_BOOTIMG_KERNEL_ARGS_SIZE);
   if (KernelArgs == NULL) {
@@ -984,6 +1228,7 @@ AndroidBootDriverBindingStart (
   Private->Signature             = ANDROID_BOOT_SIGNATURE;
   Private->BlockIo               = BlockIo;
   Private->DiskIo                = DiskIo;
+  Private->DiskIo2               = DiskIo2;
   Private->ParentDevicePath      = ParentDevicePath;
   Private->AndroidBootDevicePath = AndroidBootDevicePath;
   Private->ControllerHandle      = ControllerHandle;
@@ -1351,13 +1596,13 @@ RcmLoadFile (
     return EFI_NOT_FOUND;
   }
 
-  if ((Buffer == NULL) || (*BufferSize < ImgData.KernelSize)) {
-    *BufferSize = ImgData.KernelSize;
+  if ((Buffer == NULL) || (*BufferSize < ImgData.KernelLoadSize)) {
+    *BufferSize = (UINTN)ImgData.KernelLoadSize;
     return EFI_BUFFER_TOO_SMALL;
   }
 
   // Load Android Boot image
-  Status = AndroidBootLoadFile (NULL, NULL, &ImgData, Buffer);
+  Status = AndroidBootLoadFile (NULL, NULL, NULL, &ImgData, Buffer);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -27,6 +27,8 @@
 #include <Library/PrintLib.h>
 #include <Library/AndroidBootImgLib.h>
 #include <Library/TegraPlatformInfoLib.h>
+#include <Library/ImageDecompressLib.h>
+#include <Library/TimerLib.h>
 
 #include <Guid/LinuxEfiInitrdMedia.h>
 
@@ -34,6 +36,7 @@
 #include <Protocol/PartitionInfo.h>
 #include <Protocol/BlockIo.h>
 #include <Protocol/DiskIo.h>
+#include <Protocol/DiskIo2.h>
 #include <Protocol/LoadFile.h>
 #include <Protocol/LoadFile2.h>
 
@@ -47,8 +50,19 @@ typedef struct {
   UINT32    KernelSize;
   UINT32    RamdiskSize;
   UINT32    PageSize;
+  UINT32    KernelCompression;
+  UINT64    KernelLoadSize;
 } ANDROID_BOOT_DATA;
 
+// Context of the reads issued while decompressing the kernel
+typedef struct {
+  EFI_BLOCK_IO_PROTOCOL    *BlockIo;
+  EFI_DISK_IO_PROTOCOL     *DiskIo;
+  EFI_DISK_IO2_PROTOCOL    *DiskIo2;
+  EFI_DISK_IO2_TOKEN       Token;     // background read of the next chunk
+  UINT32                   Offset;
+} ANDROID_BOOT_READ_CONTEXT;
+
 // Private data structure
 typedef struct {
   UINT64                         Signature;
@@ -57,6 +71,7 @@ typedef struct {
   EFI_PARTITION_INFO_PROTOCOL    *PartitionInfo;
   EFI_BLOCK_IO_PROTOCOL          *BlockIo;
   EFI_DISK_IO_PROTOCOL           *DiskIo;
+  EFI_DISK_IO2_PROTOCOL          *DiskIo2;
   EFI_DEVICE_PATH_PROTOCOL       *ParentDevicePath;
   EFI_DEVICE_PATH_PROTOCOL       *AndroidBootDevicePath;
   CHAR16                         *KernelArgs;
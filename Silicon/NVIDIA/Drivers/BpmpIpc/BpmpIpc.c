@@ -12,10 +12,15 @@
 #include <Library/ArmLib.h>
 #include <Library/IoLib.h>
 #include <Library/PcdLib.h>
+#include <Library/PerformanceLib.h>
+#include <Library/PrintLib.h>
 
 #define BOTH_ALIGNED(a, b, align)  ((((UINTN)(a) | (UINTN)(b)) & ((align) - 1)) == 0)
 #define PLATFORM_MAX_SOCKETS  (PcdGet32 (PcdTegraMaxSockets))
 
+// Length of the boot performance log measurement strings
+#define BPMP_TRACE_LENGTH  24
+
 /**
   Copy Length bytes from Source to Destination, using mmio accesses for specified direction.
 
@@ -347,6 +352,8 @@ BpmpIpcCommunicate (
   BPMP_PENDING_TRANSACTION      *PendingTransaction = NULL;
   BOOLEAN                       NeedQueue           = FALSE;
   UINT32                        ChannelNo           = 0;
+  BOOLEAN                       Trace               = FALSE;
+  CHAR8                         Measurement[BPMP_TRACE_LENGTH];
 
   if (NULL == This) {
     return EFI_INVALID_PARAMETER;
@@ -388,6 +395,13 @@ BpmpIpcCommunicate (
   }
 
   if (Token == NULL) {
+    // Blocking requests stall the caller, so their latency is logged per MRQ
+    Trace = LogPerformanceMeasurementEnabled (PERF_INMODULE_START_ID);
+    if (Trace) {
+      AsciiSPrint (Measurement, sizeof (Measurement), "BPMP MRQ %u", MessageRequest);
+      PERF_INMODULE_BEGIN (Measurement);
+    }
+
     Blocking           = TRUE;
     PendingTransaction = &LocalPendingTransaction;
     Token              = &LocalToken;
@@ -399,6 +413,10 @@ BpmpIpcCommunicate (
                                 &Token->Event
                                 );
     if (EFI_ERROR (Status)) {
+      if (Trace) {
+        PERF_INMODULE_END (Measurement);
+      }
+
       return Status;
     }
   } else {
@@ -446,6 +464,10 @@ BpmpIpcCommunicate (
     }
 
     gBS->CloseEvent (Token->Event);
+    if (Trace) {
+      PERF_INMODULE_END (Measurement);
+    }
+
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -287,6 +287,12 @@ FvbRead (
 
   FvbOffset = MultU64x32 (Lba, BlockSize) + Offset;
 
+  Status = FvbPendingEraseCheck (Private, FvbOffset, *NumBytes);
+  if (EFI_ERROR (Status)) {
+    *NumBytes = 0;
+    return Status;
+  }
+
   if (Private->PartitionData != NULL) {
     CopyMem (Buffer, Private->PartitionData + FvbOffset, *NumBytes);
     Status = EFI_SUCCESS;
@@ -422,6 +428,13 @@ FvbWrite (
 
   // Modify FVB
   FvbOffset = MultU64x32 (Lba, BlockSize) + Offset;
+
+  Status = FvbPendingEraseCheck (Private, FvbOffset, *NumBytes);
+  if (EFI_ERROR (Status)) {
+    *NumBytes = 0;
+    return Status;
+  }
+
   if (Private->PartitionData != NULL) {
     CopyMem (Private->PartitionData + FvbOffset, Buffer, *NumBytes);
   }
@@ -581,11 +594,20 @@ FvbEraseBlocks (
       SetMem (Private->PartitionData + FvbOffset, FvbBufferSize, FVB_ERASED_BYTE);
     }
 
-    Status = Private->NorFlashProtocol->Erase (
-                                          Private->NorFlashProtocol,
-                                          (FvbOffset + Private->PartitionOffset) / BlockSize,
-                                          NumOfLba
-                                          );
+    //
+    // Leave the erase running in the background when the flash supports it.
+    // A failure is returned by the next read or write of the range.
+    //
+    if (Private->NorFlashProtocol->EraseAsync != NULL) {
+      Status = FvbPendingEraseStart (Private, FvbOffset, FvbBufferSize);
+    } else {
+      Status = Private->NorFlashProtocol->Erase (
+                                            Private->NorFlashProtocol,
+                                            (FvbOffset + Private->PartitionOffset) / BlockSize,
+                                            NumOfLba
+                                            );
+    }
+
     if (EFI_ERROR (Status)) {
       DEBUG ((EFI_D_ERROR, "%a: FVB write failed. Recovered FVB could be corrupt.\n", __FUNCTION__));
       ASSERT (FALSE);
@@ -0,0 +1,195 @@
+/** @file
+
+  Background erase of FVB blocks
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <FvbPrivate.h>
+
+/**
+  Check if two ranges overlap.
+
+  @param[in] Offset1               Offset of the first range
+  @param[in] Size1                 Size of the first range
+  @param[in] Offset2               Offset of the second range
+  @param[in] Size2                 Size of the second range
+
+  @retval TRUE                     The ranges overlap.
+  @retval FALSE                    The ranges don't overlap.
+**/
+STATIC
+BOOLEAN
+FvbRangesOverlap (
+  IN UINT64  Offset1,
+  IN UINT64  Size1,
+  IN UINT64  Offset2,
+  IN UINT64  Size2
+  )
+{
+  return (Offset1 < Offset2 + Size2) && (Offset2 < Offset1 + Size1);
+}
+
+/**
+  Completion of an erase started by FvbPendingEraseStart().
+
+  The caller of EraseBlocks() has already returned, so a failure is kept
+  until the range is accessed again. This may run from within a NOR flash
+  access, so the flash is not accessed here.
+
+  @param[in] Context               FVB private data
+  @param[in] Status                Status of the erase
+
+**/
+STATIC
+VOID
+EFIAPI
+FvbPendingEraseComplete (
+  IN VOID        *Context,
+  IN EFI_STATUS  Status
+  )
+{
+  NVIDIA_FVB_PRIVATE_DATA  *Private;
+  UINT64                   Start;
+  UINT64                   End;
+
+  Private               = (NVIDIA_FVB_PRIVATE_DATA *)Context;
+  Private->ErasePending = FALSE;
+  if (!EFI_ERROR (Status)) {
+    return;
+  }
+
+  DEBUG ((
+    EFI_D_ERROR,
+    "%a: FVB erase of 0x%llx-0x%llx failed: %r\n",
+    __FUNCTION__,
+    Private->PendingEraseOffset,
+    Private->PendingEraseOffset + Private->PendingEraseSize - 1,
+    Status
+    ));
+
+  // Merge with a failure that was not reported yet.
+  Start = Private->PendingEraseOffset;
+  End   = Private->PendingEraseOffset + Private->PendingEraseSize;
+  if (Private->FailedEraseSize != 0) {
+    Start = MIN (Start, Private->FailedEraseOffset);
+    End   = MAX (End, Private->FailedEraseOffset + Private->FailedEraseSize);
+  }
+
+  Private->FailedEraseStatus = Status;
+  Private->FailedEraseOffset = Start;
+  Private->FailedEraseSize   = End - Start;
+}
+
+/**
+  Start erasing a range of the FVB in the background.
+
+  @param[in] Private               FVB private data
+  @param[in] FvbOffset             Offset of the range in the FVB
+  @param[in] Size                  Size of the range
+
+  @retval EFI_SUCCESS              Erase started.
+  @retval others                   Error occurred
+**/
+EFI_STATUS
+FvbPendingEraseStart (
+  IN NVIDIA_FVB_PRIVATE_DATA  *Private,
+  IN UINT64                   FvbOffset,
+  IN UINT64                   Size
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      BlockSize;
+
+  // Only one erase can be pending, a failure of the previous one is kept.
+  if (Private->ErasePending) {
+    Private->NorFlashProtocol->ErasePoll (Private->NorFlashProtocol, TRUE);
+    Private->ErasePending = FALSE;
+  }
+
+  // Erasing the whole failed range again supersedes the failure.
+  if ((Private->FailedEraseSize != 0) &&
+      (FvbOffset <= Private->FailedEraseOffset) &&
+      (FvbOffset + Size >= Private->FailedEraseOffset + Private->FailedEraseSize))
+  {
+    Private->FailedEraseSize = 0;
+  }
+
+  BlockSize                   = Private->FlashAttributes.BlockSize;
+  Private->ErasePending       = TRUE;
+  Private->PendingEraseOffset = FvbOffset;
+  Private->PendingEraseSize   = Size;
+  Status                      = Private->NorFlashProtocol->EraseAsync (
+                                                             Private->NorFlashProtocol,
+                                                             (UINT32)((FvbOffset + Private->PartitionOffset) / BlockSize),
+                                                             (UINT32)(Size / BlockSize),
+                                                             FvbPendingEraseComplete,
+                                                             Private
+                                                             );
+  if (EFI_ERROR (Status)) {
+    Private->ErasePending = FALSE;
+  }
+
+  return Status;
+}
+
+/**
+  Check for a background erase failure before a range of the FVB is accessed.
+
+  An erase still in progress over the range is completed first. A failure is
+  returned once, to the first access to the failed range.
+
+  @param[in] Private               FVB private data
+  @param[in] FvbOffset             Offset of the range in the FVB
+  @param[in] Size                  Size of the range
+
+  @retval EFI_SUCCESS              No erase failed over the range.
+  @retval EFI_DEVICE_ERROR         An erase of the range failed.
+**/
+EFI_STATUS
+FvbPendingEraseCheck (
+  IN NVIDIA_FVB_PRIVATE_DATA  *Private,
+  IN UINT64                   FvbOffset,
+  IN UINT64                   Size
+  )
+{
+  // The cached copy already reads as erased, the flash may not be yet.
+  if (Private->ErasePending &&
+      FvbRangesOverlap (FvbOffset, Size, Private->PendingEraseOffset, Private->PendingEraseSize))
+  {
+    Private->NorFlashProtocol->ErasePoll (Private->NorFlashProtocol, TRUE);
+    Private->ErasePending = FALSE;
+  }
+
+  if ((Private->FailedEraseSize == 0) ||
+      !FvbRangesOverlap (FvbOffset, Size, Private->FailedEraseOffset, Private->FailedEraseSize))
+  {
+    return EFI_SUCCESS;
+  }
+
+  DEBUG ((
+    EFI_D_ERROR,
+    "%a: FVB erase of 0x%llx-0x%llx failed: %r. Recovered FVB could be corrupt.\n",
+    __FUNCTION__,
+    Private->FailedEraseOffset,
+    Private->FailedEraseOffset + Private->FailedEraseSize - 1,
+    Private->FailedEraseStatus
+    ));
+
+  // The flash may have been partially erased.
+  if (Private->PartitionData != NULL) {
+    Private->NorFlashProtocol->Read (
+                                 Private->NorFlashProtocol,
+                                 (UINT32)(Private->FailedEraseOffset + Private->PartitionOffset),
+                                 (UINT32)Private->FailedEraseSize,
+                                 Private->PartitionData + Private->FailedEraseOffset
+                                 );
+  }
+
+  Private->FailedEraseSize = 0;
+
+  return EFI_DEVICE_ERROR;
+}
@@ -2,7 +2,7 @@
 
   Fvb Driver Private Data
 
-  Copyright (c) 2018-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2018-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -45,6 +45,12 @@ typedef struct {
   UINT32                                 PartitionOffset;
   UINT32                                 PartitionSize;
   EFI_PHYSICAL_ADDRESS                   PartitionAddress;
+  BOOLEAN                                ErasePending;
+  UINT64                                 PendingEraseOffset;
+  UINT64                                 PendingEraseSize;
+  EFI_STATUS                             FailedEraseStatus;
+  UINT64                                 FailedEraseOffset;
+  UINT64                                 FailedEraseSize;
   EFI_FIRMWARE_VOLUME_BLOCK2_PROTOCOL    FvbProtocol;
   EFI_HANDLE                             Handle;
 } NVIDIA_FVB_PRIVATE_DATA;
@@ -62,4 +68,41 @@ typedef struct {
 
 #define FVB_ERASED_BYTE  0xFF
 
+/**
+  Start erasing a range of the FVB in the background.
+
+  @param[in] Private               FVB private data
+  @param[in] FvbOffset             Offset of the range in the FVB
+  @param[in] Size                  Size of the range
+
+  @retval EFI_SUCCESS              Erase started.
+  @retval others                   Error occurred
+**/
+EFI_STATUS
+FvbPendingEraseStart (
+  IN NVIDIA_FVB_PRIVATE_DATA  *Private,
+  IN UINT64                   FvbOffset,
+  IN UINT64                   Size
+  );
+
+/**
+  Check for a background erase failure before a range of the FVB is accessed.
+
+  An erase still in progress over the range is completed first. A failure is
+  returned once, to the first access to the failed range.
+
+  @param[in] Private               FVB private data
+  @param[in] FvbOffset             Offset of the range in the FVB
+  @param[in] Size                  Size of the range
+
+  @retval EFI_SUCCESS              No erase failed over the range.
+  @retval EFI_DEVICE_ERROR         An erase of the range failed.
+**/
+EFI_STATUS
+FvbPendingEraseCheck (
+  IN NVIDIA_FVB_PRIVATE_DATA  *Private,
+  IN UINT64                   FvbOffset,
+  IN UINT64                   Size
+  );
+
 #endif
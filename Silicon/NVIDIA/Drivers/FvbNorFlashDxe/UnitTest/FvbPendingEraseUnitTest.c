@@ -0,0 +1,447 @@
+/** @file
+
+  FVB background erase unit test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../FvbPrivate.h"
+
+#define UNIT_TEST_NAME     "FVB Pending Erase Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_BLOCK_SIZE        SIZE_4KB
+#define TEST_FLASH_BLOCKS      16
+#define TEST_PARTITION_OFFSET  (2 * TEST_BLOCK_SIZE)
+#define TEST_PARTITION_BLOCKS  8
+#define TEST_WRITTEN_BYTE      0x5A
+
+//
+// Simulated NOR flash with one erase in flight at a time, completed when
+// polled with Wait or when a read overlaps it, as the NOR flash driver does.
+//
+typedef struct {
+  NVIDIA_NOR_FLASH_PROTOCOL    Protocol;
+  UINT8                        Data[TEST_FLASH_BLOCKS * TEST_BLOCK_SIZE];
+  BOOLEAN                      Pending;
+  UINT32                       Lba;
+  UINT32                       NumLba;
+  NOR_FLASH_ERASE_COMPLETE     Callback;
+  VOID                         *Context;
+  BOOLEAN                      FailNext;
+  UINTN                        SuspendedReads;
+  UINTN                        Completions;
+} SIM_NOR_FLASH;
+
+STATIC SIM_NOR_FLASH            mNor;
+STATIC NVIDIA_FVB_PRIVATE_DATA  mFvb;
+STATIC UINT8                    mCache[TEST_PARTITION_BLOCKS * TEST_BLOCK_SIZE];
+
+/**
+  Complete the erase in flight. A failing erase only erases its first block.
+
+  @param[in, out] Nor      Simulated flash
+
+  @retval EFI_SUCCESS       No erase pending or the erase succeeded
+  @retval EFI_DEVICE_ERROR  The erase failed
+**/
+STATIC
+EFI_STATUS
+SimNorComplete (
+  IN OUT SIM_NOR_FLASH  *Nor
+  )
+{
+  EFI_STATUS                Status;
+  UINT32                    NumLba;
+  NOR_FLASH_ERASE_COMPLETE  Callback;
+
+  if (!Nor->Pending) {
+    return EFI_SUCCESS;
+  }
+
+  Status = Nor->FailNext ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+  NumLba = Nor->FailNext ? 1 : Nor->NumLba;
+  SetMem (&Nor->Data[Nor->Lba * TEST_BLOCK_SIZE], NumLba * TEST_BLOCK_SIZE, FVB_ERASED_BYTE);
+
+  Callback      = Nor->Callback;
+  Nor->Pending  = FALSE;
+  Nor->FailNext = FALSE;
+  Nor->Completions++;
+  if (Callback != NULL) {
+    Callback (Nor->Context, Status);
+  }
+
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+SimNorRead (
+  IN NVIDIA_NOR_FLASH_PROTOCOL  *This,
+  IN UINT32                     Offset,
+  IN UINT32                     Size,
+  IN VOID                       *Buffer
+  )
+{
+  if (mNor.Pending) {
+    if ((Offset < (mNor.Lba + mNor.NumLba) * TEST_BLOCK_SIZE) &&
+        (Offset + Size > mNor.Lba * TEST_BLOCK_SIZE))
+    {
+      SimNorComplete (&mNor);
+    } else {
+      mNor.SuspendedReads++;
+    }
+  }
+
+  CopyMem (Buffer, &mNor.Data[Offset], Size);
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+SimNorEraseAsync (
+  IN NVIDIA_NOR_FLASH_PROTOCOL  *This,
+  IN UINT32                     Lba,
+  IN UINT32                     NumLba,
+  IN NOR_FLASH_ERASE_COMPLETE   Callback OPTIONAL,
+  IN VOID                       *Context OPTIONAL
+  )
+{
+  if (mNor.Pending) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  mNor.Pending  = TRUE;
+  mNor.Lba      = Lba;
+  mNor.NumLba   = NumLba;
+  mNor.Callback = Callback;
+  mNor.Context  = Context;
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+SimNorErasePoll (
+  IN NVIDIA_NOR_FLASH_PROTOCOL  *This,
+  IN BOOLEAN                    Wait
+  )
+{
+  if (!mNor.Pending) {
+    return EFI_SUCCESS;
+  }
+
+  if (!Wait) {
+    return EFI_NOT_READY;
+  }
+
+  return SimNorComplete (&mNor);
+}
+
+/**
+  Read FVB data the way FvbRead() does.
+
+  @param[in]  Block    FVB block to read
+  @param[out] Buffer   Buffer of TEST_BLOCK_SIZE bytes
+
+  @retval EFI_SUCCESS       Block read
+  @retval EFI_DEVICE_ERROR  An erase of the block failed
+**/
+STATIC
+EFI_STATUS
+FvbTestRead (
+  IN  UINTN  Block,
+  OUT UINT8  *Buffer
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = FvbPendingEraseCheck (&mFvb, Block * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE);
+  if (!EFI_ERROR (Status)) {
+    CopyMem (Buffer, mFvb.PartitionData + Block * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE);
+  }
+
+  return Status;
+}
+
+/**
+  Start erasing FVB blocks the way FvbEraseBlocks() does.
+
+  @param[in] Block    First FVB block to erase
+  @param[in] Count    Number of blocks
+
+  @retval EFI_SUCCESS       Erase started
+  @retval others            Error occurred
+**/
+STATIC
+EFI_STATUS
+FvbTestErase (
+  IN UINTN  Block,
+  IN UINTN  Count
+  )
+{
+  SetMem (mFvb.PartitionData + Block * TEST_BLOCK_SIZE, Count * TEST_BLOCK_SIZE, FVB_ERASED_BYTE);
+  return FvbPendingEraseStart (&mFvb, Block * TEST_BLOCK_SIZE, Count * TEST_BLOCK_SIZE);
+}
+
+/**
+  Check that a buffer holds a single byte value.
+
+  @param[in] Buffer   Buffer to check
+  @param[in] Size     Size of the buffer
+  @param[in] Value    Expected byte
+
+  @retval TRUE    All bytes match
+  @retval FALSE   Some byte differs
+**/
+STATIC
+BOOLEAN
+IsFilled (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Size,
+  IN UINT8        Value
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    if (Buffer[Index] != Value) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Reset the simulated flash, its cached copy and the FVB state.
+
+  @param[in] Context  Unused
+
+  @retval UNIT_TEST_PASSED  Setup done
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetupFvb (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ZeroMem (&mNor, sizeof (mNor));
+  mNor.Protocol.Read       = SimNorRead;
+  mNor.Protocol.EraseAsync = SimNorEraseAsync;
+  mNor.Protocol.ErasePoll  = SimNorErasePoll;
+  SetMem (mNor.Data, sizeof (mNor.Data), TEST_WRITTEN_BYTE);
+  SetMem (mCache, sizeof (mCache), TEST_WRITTEN_BYTE);
+
+  ZeroMem (&mFvb, sizeof (mFvb));
+  mFvb.Signature                 = NVIDIA_FVB_SIGNATURE;
+  mFvb.NorFlashProtocol          = &mNor.Protocol;
+  mFvb.FlashAttributes.BlockSize = TEST_BLOCK_SIZE;
+  mFvb.PartitionData             = mCache;
+  mFvb.PartitionOffset           = TEST_PARTITION_OFFSET;
+  mFvb.PartitionSize             = sizeof (mCache);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reads of other blocks go ahead of the erase, a read of the erased block
+  waits for it.
+
+  @param[in] Context  Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EraseReadInterleave (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Buffer[TEST_BLOCK_SIZE];
+  UINT8  Direct[TEST_BLOCK_SIZE];
+
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestErase (2, 2));
+  UT_ASSERT_TRUE (mNor.Pending);
+  UT_ASSERT_EQUAL (mNor.Lba, TEST_PARTITION_OFFSET / TEST_BLOCK_SIZE + 2);
+  UT_ASSERT_EQUAL (mNor.NumLba, 2);
+
+  // Blocks around the erase are read while it runs.
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestRead (1, Buffer));
+  UT_ASSERT_TRUE (IsFilled (Buffer, sizeof (Buffer), TEST_WRITTEN_BYTE));
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestRead (4, Buffer));
+  UT_ASSERT_TRUE (IsFilled (Buffer, sizeof (Buffer), TEST_WRITTEN_BYTE));
+  UT_ASSERT_NOT_EFI_ERROR (mNor.Protocol.Read (&mNor.Protocol, TEST_PARTITION_OFFSET + 6 * TEST_BLOCK_SIZE, sizeof (Direct), Direct));
+  UT_ASSERT_EQUAL (mNor.SuspendedReads, 1);
+  UT_ASSERT_TRUE (mNor.Pending);
+  UT_ASSERT_EQUAL (mNor.Completions, 0);
+
+  // The erased block is only read once the flash is erased.
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestRead (3, Buffer));
+  UT_ASSERT_FALSE (mNor.Pending);
+  UT_ASSERT_FALSE (mFvb.ErasePending);
+  UT_ASSERT_EQUAL (mNor.Completions, 1);
+  UT_ASSERT_TRUE (IsFilled (Buffer, sizeof (Buffer), FVB_ERASED_BYTE));
+  UT_ASSERT_TRUE (IsFilled (&mNor.Data[TEST_PARTITION_OFFSET + 2 * TEST_BLOCK_SIZE], 2 * TEST_BLOCK_SIZE, FVB_ERASED_BYTE));
+
+  // A second erase waits for the first.
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestErase (5, 1));
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestErase (6, 1));
+  UT_ASSERT_EQUAL (mNor.Completions, 2);
+  UT_ASSERT_EQUAL (mNor.Lba, TEST_PARTITION_OFFSET / TEST_BLOCK_SIZE + 6);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A failed erase is returned once, to the next access of the failed block,
+  and the cached copy is reloaded from the partially erased flash.
+
+  @param[in] Context  Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EraseFailure (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Buffer[TEST_BLOCK_SIZE];
+
+  mNor.FailNext = TRUE;
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestErase (2, 2));
+
+  // Completed by a read of the other flash range, not reported to it.
+  UT_ASSERT_NOT_EFI_ERROR (mNor.Protocol.Read (&mNor.Protocol, TEST_PARTITION_OFFSET + 3 * TEST_BLOCK_SIZE, sizeof (Buffer), Buffer));
+  UT_ASSERT_EQUAL (mNor.Completions, 1);
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestRead (0, Buffer));
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestRead (5, Buffer));
+
+  // The first access to the failed range gets the error.
+  UT_ASSERT_STATUS_EQUAL (FvbTestRead (3, Buffer), EFI_DEVICE_ERROR);
+  UT_ASSERT_TRUE (IsFilled (mCache + 2 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, FVB_ERASED_BYTE));
+  UT_ASSERT_TRUE (IsFilled (mCache + 3 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, TEST_WRITTEN_BYTE));
+
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestRead (3, Buffer));
+  UT_ASSERT_TRUE (IsFilled (Buffer, sizeof (Buffer), TEST_WRITTEN_BYTE));
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestRead (2, Buffer));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Failures of two erases are both kept until reported, and erasing the
+  failed range again clears the failure.
+
+  @param[in] Context  Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EraseFailureMerged (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Buffer[TEST_BLOCK_SIZE];
+
+  mNor.FailNext = TRUE;
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestErase (1, 1));
+  UT_ASSERT_STATUS_EQUAL (mNor.Protocol.ErasePoll (&mNor.Protocol, TRUE), EFI_DEVICE_ERROR);
+  mNor.FailNext = TRUE;
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestErase (4, 1));
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestErase (6, 1));
+  UT_ASSERT_EQUAL (mNor.Completions, 2);
+
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestRead (0, Buffer));
+  UT_ASSERT_STATUS_EQUAL (FvbTestRead (4, Buffer), EFI_DEVICE_ERROR);
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestRead (1, Buffer));
+
+  // Erased again before it was accessed.
+  mNor.FailNext = TRUE;
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestErase (2, 1));
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestErase (2, 1));
+  UT_ASSERT_NOT_EFI_ERROR (FvbTestRead (2, Buffer));
+  UT_ASSERT_TRUE (IsFilled (Buffer, sizeof (Buffer), FVB_ERASED_BYTE));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the FVB
+  background erase and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      EraseTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&EraseTests, Framework, "FVB Pending Erase Tests", "UnitTest.FvbPendingErase", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for FVB Pending Erase Tests\n"));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AddTestCase (EraseTests, "Reads interleaved with a background erase", "EraseReadInterleave", EraseReadInterleave, SetupFvb, NULL, NULL);
+  AddTestCase (EraseTests, "Erase failure returned to the next access", "EraseFailure", EraseFailure, SetupFvb, NULL, NULL);
+  AddTestCase (EraseTests, "Erase failures kept until reported", "EraseFailureMerged", EraseFailureMerged, SetupFvb, NULL, NULL);
+
+  // Execute the tests.
+  return RunAllTestSuites (Framework);
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
@@ -12,6 +12,7 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/BootChainInfoLib.h>
 #include <Library/DebugLib.h>
+#include <Library/GptLib.h>
 #include <Library/HobLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
@@ -35,11 +36,25 @@ typedef struct FW_IMAGE_PRIVATE_DATA {
   NVIDIA_FW_PARTITION_PROTOCOL    *FwPartitionA;
   NVIDIA_FW_PARTITION_PROTOCOL    *FwPartitionB;
 
+  // partitions for the current boot chain, see FwImageSelectPartitions()
+  NVIDIA_FW_PARTITION_PROTOCOL    *ActivePartition;
+  NVIDIA_FW_PARTITION_PROTOCOL    *InactivePartition;
+
   // protocol info
   EFI_HANDLE                      Handle;
   NVIDIA_FW_IMAGE_PROTOCOL        Protocol;
 } FW_IMAGE_PRIVATE_DATA;
 
+// FwPartition name index used while initializing the images
+typedef struct {
+  NVIDIA_FW_PARTITION_PROTOCOL    **Protocols;
+
+  // name hash buckets and chains, holding protocol index + 1, 0 ends a chain
+  UINT32                          *NameHash;
+  UINT32                          *NameNext;
+  UINT32                          NameHashSize;
+} FW_PARTITION_INDEX;
+
 STATIC FW_IMAGE_PRIVATE_DATA  *mPrivate           = NULL;
 STATIC UINTN                  mNumFwImages        = 0;
 STATIC UINT32                 mBootChain          = MAX_UINT32;
@@ -90,58 +105,64 @@ HasBImage (
 }
 
 /**
-  Check if the image's 'B' partition is the active partition.
-
+  Get the image's active partition pointer.
 
-  @param[in]  Private               Image private data structure pointer
+  @param[in]  Private                   Image private data structure pointer
 
-  @retval BOOLEAN                   Flag TRUE if image 'B' partition is active
+  @retval NVIDIA_FW_PARTITION_PROTOCOL  Pointer to the active partition
 
 **/
 STATIC
-BOOLEAN
+NVIDIA_FW_PARTITION_PROTOCOL *
 EFIAPI
-BImageIsActive (
+ActiveImagePartition (
   IN  FW_IMAGE_PRIVATE_DATA  *Private
   )
 {
-  return (mBootChain == 1);
+  return Private->ActivePartition;
 }
 
 /**
-  Get the image's active partition pointer.
+  Get the image's inactive partition pointer.
 
   @param[in]  Private                   Image private data structure pointer
 
-  @retval NVIDIA_FW_PARTITION_PROTOCOL  Pointer to the active partition
+  @retval NVIDIA_FW_PARTITION_PROTOCOL  Pointer to the inactive partition
 
 **/
 STATIC
 NVIDIA_FW_PARTITION_PROTOCOL *
 EFIAPI
-ActiveImagePartition (
+InactiveImagePartition (
   IN  FW_IMAGE_PRIVATE_DATA  *Private
   )
 {
-  return (BImageIsActive (Private)) ? Private->FwPartitionB : Private->FwPartitionA;
+  return Private->InactivePartition;
 }
 
 /**
-  Get the image's inactive partition pointer.
+  Select the image's active and inactive partitions for the current boot
+  chain.  Must be called again for every image if mBootChain changes.
 
-  @param[in]  Private                   Image private data structure pointer
+  @param[in]  Private               Image private data structure pointer
 
-  @retval NVIDIA_FW_PARTITION_PROTOCOL  Pointer to the inactive partition
+  @retval None
 
 **/
 STATIC
-NVIDIA_FW_PARTITION_PROTOCOL *
+VOID
 EFIAPI
-InactiveImagePartition (
+FwImageSelectPartitions (
   IN  FW_IMAGE_PRIVATE_DATA  *Private
   )
 {
-  return (BImageIsActive (Private)) ? Private->FwPartitionA : Private->FwPartitionB;
+  if (mBootChain == BOOT_CHAIN_B) {
+    Private->ActivePartition   = Private->FwPartitionB;
+    Private->InactivePartition = Private->FwPartitionA;
+  } else {
+    Private->ActivePartition   = Private->FwPartitionA;
+    Private->InactivePartition = Private->FwPartitionB;
+  }
 }
 
 /**
@@ -175,6 +196,55 @@ FwImageCheckOffsetAndBytes (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the partition an image write with the given flags goes to.
+
+  @param[in]  Private                   Image private data structure pointer
+  @param[in]  Flags                     Flags for write operation
+
+  @retval NVIDIA_FW_PARTITION_PROTOCOL  Pointer to the partition, NULL if
+                                        the image has no such partition
+
+**/
+STATIC
+NVIDIA_FW_PARTITION_PROTOCOL *
+EFIAPI
+WriteImagePartition (
+  IN  FW_IMAGE_PRIVATE_DATA  *Private,
+  IN  UINTN                  Flags
+  )
+{
+  NVIDIA_FW_PARTITION_PROTOCOL  *Partition;
+
+  // Get partition to use based on active boot chain and override flags
+  if (Flags & (FW_IMAGE_RW_FLAG_FORCE_PARTITION_A |
+               FW_IMAGE_RW_FLAG_FORCE_PARTITION_B))
+  {
+    if (Flags & (FW_IMAGE_RW_FLAG_FORCE_PARTITION_A)) {
+      Partition = Private->FwPartitionA;
+    } else {
+      Partition = Private->FwPartitionB;
+    }
+  } else if (HasAImage (Private) && HasBImage (Private)) {
+    Partition = InactiveImagePartition (Private);
+  } else {
+    Partition = Private->FwPartitionA;
+  }
+
+  if (Partition == NULL) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "Image %s, flags=0x%x invalid partition, A=%u, B=%u\n",
+      Private->Name,
+      Flags,
+      HasAImage (Private),
+      HasBImage (Private)
+      ));
+  }
+
+  return Partition;
+}
+
 // NVIDIA_FW_IMAGE_PROTOCOL.Write()
 STATIC
 EFI_STATUS
@@ -226,30 +296,8 @@ FwImageWrite (
     return Status;
   }
 
-  // Get partition to use based on active boot chain and override flags
-  if (Flags & (FW_IMAGE_RW_FLAG_FORCE_PARTITION_A |
-               FW_IMAGE_RW_FLAG_FORCE_PARTITION_B))
-  {
-    if (Flags & (FW_IMAGE_RW_FLAG_FORCE_PARTITION_A)) {
-      Partition = Private->FwPartitionA;
-    } else {
-      Partition = Private->FwPartitionB;
-    }
-  } else if (HasAImage (Private) && HasBImage (Private)) {
-    Partition = InactiveImagePartition (Private);
-  } else {
-    Partition = Private->FwPartitionA;
-  }
-
+  Partition = WriteImagePartition (Private, Flags);
   if (Partition == NULL) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "Image %s, flags=0x%x invalid partition, A=%u, B=%u\n",
-      ImageName,
-      Flags,
-      HasAImage (Private),
-      HasBImage (Private)
-      ));
     return EFI_NOT_FOUND;
   }
 
@@ -280,6 +328,132 @@ FwImageWrite (
   return Status;
 }
 
+// NVIDIA_FW_IMAGE_PROTOCOL.Flush()
+STATIC
+EFI_STATUS
+EFIAPI
+FwImageFlush (
+  IN  NVIDIA_FW_IMAGE_PROTOCOL  *This
+  )
+{
+  FW_IMAGE_PRIVATE_DATA         *Private;
+  NVIDIA_FW_PARTITION_PROTOCOL  *Partitions[2];
+  EFI_STATUS                    Status;
+  EFI_STATUS                    ReturnStatus;
+  UINTN                         Index;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Private = CR (
+              This,
+              FW_IMAGE_PRIVATE_DATA,
+              Protocol,
+              FW_IMAGE_PRIVATE_DATA_SIGNATURE
+              );
+
+  Partitions[0] = Private->FwPartitionA;
+  Partitions[1] = Private->FwPartitionB;
+  ReturnStatus  = EFI_SUCCESS;
+  for (Index = 0; Index < ARRAY_SIZE (Partitions); Index++) {
+    if (Partitions[Index] == NULL) {
+      continue;
+    }
+
+    Status = Partitions[Index]->Flush (Partitions[Index]);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "Error flushing %s: %r\n",
+        Partitions[Index]->PartitionName,
+        Status
+        ));
+      ReturnStatus = Status;
+    }
+  }
+
+  return ReturnStatus;
+}
+
+// NVIDIA_FW_IMAGE_PROTOCOL.EraseAsync()
+STATIC
+EFI_STATUS
+EFIAPI
+FwImageEraseAsync (
+  IN  NVIDIA_FW_IMAGE_PROTOCOL  *This,
+  IN  UINT64                    Offset,
+  IN  UINTN                     Bytes,
+  IN  UINTN                     Flags
+  )
+{
+  FW_IMAGE_PRIVATE_DATA         *Private;
+  EFI_STATUS                    Status;
+  NVIDIA_FW_PARTITION_PROTOCOL  *Partition;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Private = CR (
+              This,
+              FW_IMAGE_PRIVATE_DATA,
+              Protocol,
+              FW_IMAGE_PRIVATE_DATA_SIGNATURE
+              );
+
+  Status = FwImageCheckOffsetAndBytes (Private->Bytes, Offset, Bytes);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: offset=%llu, bytes=%u error: %r\n",
+      __FUNCTION__,
+      Offset,
+      Bytes,
+      Status
+      ));
+    return Status;
+  }
+
+  Partition = WriteImagePartition (Private, Flags);
+  if (Partition == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  return Partition->EraseAsync (Partition, Offset, Bytes);
+}
+
+// NVIDIA_FW_IMAGE_PROTOCOL.ErasePoll()
+STATIC
+EFI_STATUS
+EFIAPI
+FwImageErasePoll (
+  IN  NVIDIA_FW_IMAGE_PROTOCOL  *This,
+  IN  UINTN                     Flags
+  )
+{
+  FW_IMAGE_PRIVATE_DATA         *Private;
+  NVIDIA_FW_PARTITION_PROTOCOL  *Partition;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Private = CR (
+              This,
+              FW_IMAGE_PRIVATE_DATA,
+              Protocol,
+              FW_IMAGE_PRIVATE_DATA_SIGNATURE
+              );
+
+  Partition = WriteImagePartition (Private, Flags);
+  if (Partition == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  return Partition->ErasePoll (Partition);
+}
+
 // NVIDIA_FW_IMAGE_PROTOCOL.Read()
 STATIC
 EFI_STATUS
@@ -438,9 +612,20 @@ FwImageDxeAddressChangeNotify (
       EfiConvertPointer (0x0, (VOID **)&Private->FwPartitionB);
     }
 
+    if (Private->ActivePartition != NULL) {
+      EfiConvertPointer (0x0, (VOID **)&Private->ActivePartition);
+    }
+
+    if (Private->InactivePartition != NULL) {
+      EfiConvertPointer (0x0, (VOID **)&Private->InactivePartition);
+    }
+
     EfiConvertPointer (0x0, (VOID **)&Private->Protocol.ImageName);
     EfiConvertPointer (0x0, (VOID **)&Private->Protocol.Read);
     EfiConvertPointer (0x0, (VOID **)&Private->Protocol.Write);
+    EfiConvertPointer (0x0, (VOID **)&Private->Protocol.Flush);
+    EfiConvertPointer (0x0, (VOID **)&Private->Protocol.EraseAsync);
+    EfiConvertPointer (0x0, (VOID **)&Private->Protocol.ErasePoll);
     EfiConvertPointer (0x0, (VOID **)&Private->Protocol.GetAttributes);
   }
 
@@ -448,11 +633,130 @@ FwImageDxeAddressChangeNotify (
 }
 
 /**
-  Find the FwPartition for an image based on boot chain.
+  Build a name index of the FwPartition protocols.
 
-  @param[in]  ImageName             Name of image (partition base name)
   @param[in]  ProtocolBuffer        Pointer to array of FwPartition protocols
   @param[in]  NumProtocols          Number of entries in ProtocolBuffer array
+  @param[out] PartitionIndex        Index to initialize
+
+  @retval EFI_SUCCESS               Operation completed successfully
+  @retval EFI_OUT_OF_RESOURCES      Failed to allocate the index
+
+**/
+STATIC
+EFI_STATUS
+FwImageBuildPartitionIndex (
+  IN  NVIDIA_FW_PARTITION_PROTOCOL  **ProtocolBuffer,
+  IN  UINTN                         NumProtocols,
+  OUT FW_PARTITION_INDEX            *PartitionIndex
+  )
+{
+  UINTN   Index;
+  UINT32  Bucket;
+
+  PartitionIndex->Protocols    = ProtocolBuffer;
+  PartitionIndex->NameHashSize = 1;
+  while (PartitionIndex->NameHashSize < 2 * NumProtocols) {
+    PartitionIndex->NameHashSize <<= 1;
+  }
+
+  PartitionIndex->NameHash = (UINT32 *)AllocateZeroPool (PartitionIndex->NameHashSize * sizeof (UINT32));
+  PartitionIndex->NameNext = (UINT32 *)AllocateZeroPool (MAX (NumProtocols, 1) * sizeof (UINT32));
+  if ((PartitionIndex->NameHash == NULL) || (PartitionIndex->NameNext == NULL)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // insert in reverse so each chain lists protocols in ProtocolBuffer order
+  for (Index = NumProtocols; Index > 0; Index--) {
+    Bucket                              = GptPartitionNameHash (ProtocolBuffer[Index - 1]->PartitionName) &
+                                          (PartitionIndex->NameHashSize - 1);
+    PartitionIndex->NameNext[Index - 1] = PartitionIndex->NameHash[Bucket];
+    PartitionIndex->NameHash[Bucket]    = (UINT32)Index;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Free the resources of a FwPartition name index.
+
+  @param[in]  PartitionIndex        Index to free
+
+  @retval None
+
+**/
+STATIC
+VOID
+FwImageFreePartitionIndex (
+  IN  FW_PARTITION_INDEX  *PartitionIndex
+  )
+{
+  if (PartitionIndex->NameHash != NULL) {
+    FreePool (PartitionIndex->NameHash);
+  }
+
+  if (PartitionIndex->NameNext != NULL) {
+    FreePool (PartitionIndex->NameNext);
+  }
+
+  ZeroMem (PartitionIndex, sizeof (*PartitionIndex));
+}
+
+/**
+  Find the single FwPartition with the given partition name.
+
+  @param[in]  PartitionIndex        FwPartition name index
+  @param[in]  PartitionName         Partition name to find
+  @param[out] Duplicate             Set TRUE if more than one partition matched
+
+  @retval NVIDIA_FW_PARTITION_PROTOCOL  Pointer to the matching FwPartition
+  @retval NULL                          No partition or duplicate partitions
+
+**/
+STATIC
+NVIDIA_FW_PARTITION_PROTOCOL *
+FwImageLookupPartition (
+  IN  CONST FW_PARTITION_INDEX  *PartitionIndex,
+  IN  CONST CHAR16              *PartitionName,
+  OUT BOOLEAN                   *Duplicate
+  )
+{
+  NVIDIA_FW_PARTITION_PROTOCOL  *Protocol;
+  NVIDIA_FW_PARTITION_PROTOCOL  *FoundProtocol;
+  UINT32                        Index;
+
+  FoundProtocol = NULL;
+  *Duplicate    = FALSE;
+
+  Index = PartitionIndex->NameHash[GptPartitionNameHash (PartitionName) & (PartitionIndex->NameHashSize - 1)];
+  while (Index != 0) {
+    Protocol = PartitionIndex->Protocols[Index - 1];
+    if (StrCmp (Protocol->PartitionName, PartitionName) == 0) {
+      if (FoundProtocol != NULL) {
+        DEBUG ((
+          DEBUG_ERROR,
+          "%a: Duplicate %s partitions\n",
+          __FUNCTION__,
+          PartitionName
+          ));
+        *Duplicate = TRUE;
+        return NULL;
+      }
+
+      FoundProtocol = Protocol;
+    }
+
+    Index = PartitionIndex->NameNext[Index - 1];
+  }
+
+  return FoundProtocol;
+}
+
+/**
+  Find the FwPartition for an image based on boot chain.
+
+  @param[in]  ImageName             Name of image (partition base name)
+  @param[in]  PartitionIndex        FwPartition name index
   @param[in]  BootChain             Boot chain (0=a,1=b)
 
   @retval NVIDIA_FW_PARTITION_PROTOCOL  Pointer to the image's FwPartition
@@ -461,20 +765,16 @@ FwImageDxeAddressChangeNotify (
 STATIC
 NVIDIA_FW_PARTITION_PROTOCOL *
 FwImageFindPartition (
-  IN  CONST CHAR16                  *ImageName,
-  IN  NVIDIA_FW_PARTITION_PROTOCOL  **ProtocolBuffer,
-  IN  UINTN                         NumProtocols,
-  IN  UINTN                         BootChain
+  IN  CONST CHAR16              *ImageName,
+  IN  CONST FW_PARTITION_INDEX  *PartitionIndex,
+  IN  UINTN                     BootChain
   )
 {
-  NVIDIA_FW_PARTITION_PROTOCOL  *Protocol;
   NVIDIA_FW_PARTITION_PROTOCOL  *FoundProtocol;
-  UINTN                         Index;
   EFI_STATUS                    Status;
+  BOOLEAN                       Duplicate;
   CHAR16                        PartitionName[MAX_PARTITION_NAME_LEN];
 
-  FoundProtocol = NULL;
-
   Status = GetBootChainPartitionName (ImageName, BootChain, PartitionName);
   if (EFI_ERROR (Status)) {
     DEBUG ((
@@ -487,41 +787,11 @@ FwImageFindPartition (
   }
 
   // Look for the bootchain-based name, ensure no duplicates
-  for (Index = 0; Index < NumProtocols; Index++) {
-    Protocol = ProtocolBuffer[Index];
-    if (StrCmp (Protocol->PartitionName, PartitionName) == 0) {
-      if (FoundProtocol == NULL) {
-        FoundProtocol = Protocol;
-      } else {
-        DEBUG ((
-          DEBUG_ERROR,
-          "%a: Duplicate %s partitions\n",
-          __FUNCTION__,
-          PartitionName
-          ));
-        return NULL;
-      }
-    }
-  }
+  FoundProtocol = FwImageLookupPartition (PartitionIndex, PartitionName, &Duplicate);
 
   // Look for matching partition name that doesn't have A/B backup, e.g. BCT
-  if (FoundProtocol == NULL) {
-    for (Index = 0; Index < NumProtocols; Index++) {
-      Protocol = ProtocolBuffer[Index];
-      if (StrCmp (Protocol->PartitionName, ImageName) == 0) {
-        if (FoundProtocol == NULL) {
-          FoundProtocol = Protocol;
-        } else {
-          DEBUG ((
-            DEBUG_ERROR,
-            "%a: Duplicate %s partitions\n",
-            __FUNCTION__,
-            ImageName
-            ));
-          return NULL;
-        }
-      }
-    }
+  if ((FoundProtocol == NULL) && !Duplicate) {
+    FoundProtocol = FwImageLookupPartition (PartitionIndex, ImageName, &Duplicate);
   }
 
   return FoundProtocol;
@@ -603,9 +873,11 @@ FwImageDxeInitialize (
   UINTN                         NumHandles;
   EFI_HANDLE                    *HandleBuffer;
   NVIDIA_FW_PARTITION_PROTOCOL  **ProtocolBuffer;
+  FW_PARTITION_INDEX            PartitionIndex;
   VOID                          *Hob;
 
   ProtocolBuffer = NULL;
+  ZeroMem (&PartitionIndex, sizeof (PartitionIndex));
 
   Hob = GetFirstGuidHob (&gNVIDIAPlatformResourceDataGuid);
   if ((Hob != NULL) &&
@@ -673,6 +945,12 @@ FwImageDxeInitialize (
     }
   }
 
+  Status = FwImageBuildPartitionIndex (ProtocolBuffer, NumHandles, &PartitionIndex);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: partition index allocation failed\n", __FUNCTION__));
+    goto Done;
+  }
+
   mPrivate = (FW_IMAGE_PRIVATE_DATA *)AllocateRuntimeZeroPool (
                                         ImageCount * sizeof (FW_IMAGE_PRIVATE_DATA)
                                         );
@@ -698,8 +976,7 @@ FwImageDxeInitialize (
 
     Private->FwPartitionA = FwImageFindPartition (
                               Name,
-                              ProtocolBuffer,
-                              NumHandles,
+                              &PartitionIndex,
                               BOOT_CHAIN_A
                               );
     if (Private->FwPartitionA == NULL) {
@@ -711,8 +988,7 @@ FwImageDxeInitialize (
     if (PcdGetBool (PcdFwImageEnableBPartitions)) {
       Private->FwPartitionB = FwImageFindPartition (
                                 Name,
-                                ProtocolBuffer,
-                                NumHandles,
+                                &PartitionIndex,
                                 BOOT_CHAIN_B
                                 );
       if (Private->FwPartitionB == NULL) {
@@ -727,9 +1003,14 @@ FwImageDxeInitialize (
       goto Done;
     }
 
+    FwImageSelectPartitions (Private);
+
     Private->Protocol.ImageName     = Private->Name;
     Private->Protocol.Read          = FwImageRead;
     Private->Protocol.Write         = FwImageWrite;
+    Private->Protocol.Flush         = FwImageFlush;
+    Private->Protocol.EraseAsync    = FwImageEraseAsync;
+    Private->Protocol.ErasePoll     = FwImageErasePoll;
     Private->Protocol.GetAttributes = FwImageGetAttributes;
 
     Status = gBS->InstallMultipleProtocolInterfaces (
@@ -775,6 +1056,8 @@ FwImageDxeInitialize (
 Done:
   FreePool (ImageList);
 
+  FwImageFreePartitionIndex (&PartitionIndex);
+
   if (ProtocolBuffer != NULL) {
     FreePool (ProtocolBuffer);
     ProtocolBuffer = NULL;
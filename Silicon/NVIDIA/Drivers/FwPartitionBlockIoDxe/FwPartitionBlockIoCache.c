@@ -0,0 +1,419 @@
+/** @file
+  FW Partition BlockIo write cache
+
+  Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "FwPartitionBlockIoCache.h"
+
+EFI_STATUS
+EFIAPI
+FPBlockIoCacheInit (
+  OUT FW_PARTITION_BLOCK_IO_CACHE  *Cache,
+  IN  EFI_BLOCK_IO_PROTOCOL        *BlockIo,
+  IN  UINTN                        ExtentBlocks
+  )
+{
+  UINTN  Alignment;
+  UINTN  ExtentBytes;
+  UINTN  Index;
+
+  ZeroMem (Cache, sizeof (*Cache));
+
+  Alignment     = MAX (BlockIo->Media->IoAlign, EFI_PAGE_SIZE);
+  ExtentBytes   = ExtentBlocks * BlockIo->Media->BlockSize;
+  Cache->Buffer = AllocateAlignedPages (
+                    EFI_SIZE_TO_PAGES (FW_PARTITION_BLOCK_IO_CACHE_EXTENTS * ExtentBytes),
+                    Alignment
+                    );
+  if (Cache->Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Cache->BlockIo      = BlockIo;
+  Cache->ExtentBlocks = ExtentBlocks;
+  for (Index = 0; Index < FW_PARTITION_BLOCK_IO_CACHE_EXTENTS; Index++) {
+    Cache->Extents[Index].Buffer = Cache->Buffer + Index * ExtentBytes;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Write a cached extent to the device and empty it.  The extent is emptied
+  even if the write fails.
+
+  @param[in]  Cache             Cache of the extent
+  @param[in]  Extent            Extent to flush
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error writing the device
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+FPBlockIoCacheFlushExtent (
+  IN  FW_PARTITION_BLOCK_IO_CACHE         *Cache,
+  IN  FW_PARTITION_BLOCK_IO_CACHE_EXTENT  *Extent
+  )
+{
+  EFI_BLOCK_IO_PROTOCOL  *BlockIo;
+  EFI_STATUS             Status;
+  UINTN                  Bytes;
+
+  if (Extent->Blocks == 0) {
+    return EFI_SUCCESS;
+  }
+
+  BlockIo = Cache->BlockIo;
+  Bytes   = Extent->Blocks * BlockIo->Media->BlockSize;
+
+  DEBUG ((DEBUG_VERBOSE, "%a: Lba=%llu, Bytes=%u\n", __FUNCTION__, Extent->Lba, Bytes));
+
+  Status = BlockIo->WriteBlocks (
+                      BlockIo,
+                      BlockIo->Media->MediaId,
+                      Extent->Lba,
+                      Bytes,
+                      Extent->Buffer
+                      );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: Error writing Lba=%llu, Bytes=%u: %r\n",
+      __FUNCTION__,
+      Extent->Lba,
+      Bytes,
+      Status
+      ));
+  }
+
+  Extent->Blocks = 0;
+
+  return Status;
+}
+
+/**
+  Flush the cached extents that overlap a range of blocks.
+
+  @param[in]  Cache             Cache to flush
+  @param[in]  Lba               First block of the range
+  @param[in]  Blocks            Number of blocks in the range
+  @param[in]  Skip              Extent not to flush or NULL
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error writing the device
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+FPBlockIoCacheFlushRange (
+  IN  FW_PARTITION_BLOCK_IO_CACHE         *Cache,
+  IN  EFI_LBA                             Lba,
+  IN  UINTN                               Blocks,
+  IN  FW_PARTITION_BLOCK_IO_CACHE_EXTENT  *Skip OPTIONAL
+  )
+{
+  FW_PARTITION_BLOCK_IO_CACHE_EXTENT  *Extent;
+  EFI_STATUS                          Status;
+  UINTN                               Index;
+
+  for (Index = 0; Index < FW_PARTITION_BLOCK_IO_CACHE_EXTENTS; Index++) {
+    Extent = &Cache->Extents[Index];
+    if ((Extent == Skip) || (Extent->Blocks == 0) ||
+        (Lba >= Extent->Lba + Extent->Blocks) || (Lba + Blocks <= Extent->Lba))
+    {
+      continue;
+    }
+
+    Status = FPBlockIoCacheFlushExtent (Cache, Extent);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Find the cached extent a write to a block merges into: the extent
+  holding the block, else the extent ending right before it.
+
+  @param[in]  Cache             Cache to search
+  @param[in]  Lba               Block to write
+
+  @retval FW_PARTITION_BLOCK_IO_CACHE_EXTENT *  Extent to merge into
+  @retval NULL                                  No extent takes the write
+
+**/
+STATIC
+FW_PARTITION_BLOCK_IO_CACHE_EXTENT *
+EFIAPI
+FPBlockIoCacheFindExtent (
+  IN  FW_PARTITION_BLOCK_IO_CACHE  *Cache,
+  IN  EFI_LBA                      Lba
+  )
+{
+  FW_PARTITION_BLOCK_IO_CACHE_EXTENT  *Extent;
+  FW_PARTITION_BLOCK_IO_CACHE_EXTENT  *Append;
+  UINTN                               Index;
+
+  Append = NULL;
+  for (Index = 0; Index < FW_PARTITION_BLOCK_IO_CACHE_EXTENTS; Index++) {
+    Extent = &Cache->Extents[Index];
+    if ((Extent->Blocks == 0) || (Lba < Extent->Lba)) {
+      continue;
+    }
+
+    if (Lba < Extent->Lba + Extent->Blocks) {
+      return Extent;
+    }
+
+    if (Lba == Extent->Lba + Extent->Blocks) {
+      Append = Extent;
+    }
+  }
+
+  return Append;
+}
+
+/**
+  Get an empty extent, flushing the least recently written extent if all
+  are in use.
+
+  @param[in]  Cache             Cache to get the extent from
+  @param[out] Extent            Address to store the empty extent
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error writing the evicted extent
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+FPBlockIoCacheGetEmptyExtent (
+  IN  FW_PARTITION_BLOCK_IO_CACHE         *Cache,
+  OUT FW_PARTITION_BLOCK_IO_CACHE_EXTENT  **Extent
+  )
+{
+  FW_PARTITION_BLOCK_IO_CACHE_EXTENT  *Oldest;
+  UINTN                               Index;
+
+  Oldest = NULL;
+  for (Index = 0; Index < FW_PARTITION_BLOCK_IO_CACHE_EXTENTS; Index++) {
+    if (Cache->Extents[Index].Blocks == 0) {
+      *Extent = &Cache->Extents[Index];
+      return EFI_SUCCESS;
+    }
+
+    if ((Oldest == NULL) || (Cache->Extents[Index].LastUse < Oldest->LastUse)) {
+      Oldest = &Cache->Extents[Index];
+    }
+  }
+
+  *Extent = Oldest;
+  return FPBlockIoCacheFlushExtent (Cache, Oldest);
+}
+
+EFI_STATUS
+EFIAPI
+FPBlockIoCacheFlush (
+  IN  FW_PARTITION_BLOCK_IO_CACHE  *Cache
+  )
+{
+  FW_PARTITION_BLOCK_IO_CACHE_EXTENT  *Extent;
+  EFI_STATUS                          Status;
+  EFI_STATUS                          ReturnStatus;
+  UINTN                               Index;
+
+  ReturnStatus = EFI_SUCCESS;
+  while (TRUE) {
+    Extent = NULL;
+    for (Index = 0; Index < FW_PARTITION_BLOCK_IO_CACHE_EXTENTS; Index++) {
+      if ((Cache->Extents[Index].Blocks != 0) &&
+          ((Extent == NULL) || (Cache->Extents[Index].Lba < Extent->Lba)))
+      {
+        Extent = &Cache->Extents[Index];
+      }
+    }
+
+    if (Extent == NULL) {
+      break;
+    }
+
+    Status = FPBlockIoCacheFlushExtent (Cache, Extent);
+    if (!EFI_ERROR (ReturnStatus)) {
+      ReturnStatus = Status;
+    }
+  }
+
+  return ReturnStatus;
+}
+
+EFI_STATUS
+EFIAPI
+FPBlockIoCacheWrite (
+  IN  FW_PARTITION_BLOCK_IO_CACHE  *Cache,
+  IN  EFI_LBA                      Lba,
+  IN  UINTN                        Bytes,
+  IN  CONST VOID                   *Buffer
+  )
+{
+  FW_PARTITION_BLOCK_IO_CACHE_EXTENT  *Extent;
+  EFI_BLOCK_IO_PROTOCOL               *BlockIo;
+  EFI_BLOCK_IO_MEDIA                  *Media;
+  EFI_STATUS                          Status;
+  CONST UINT8                         *Data;
+  UINTN                               BlockSize;
+  UINTN                               BlockIndex;
+  UINTN                               CopyBytes;
+  UINTN                               CopyBlocks;
+  UINTN                               DirectBytes;
+
+  BlockIo   = Cache->BlockIo;
+  Media     = BlockIo->Media;
+  BlockSize = Media->BlockSize;
+  Data      = (CONST UINT8 *)Buffer;
+
+  while (Bytes > 0) {
+    Extent = FPBlockIoCacheFindExtent (Cache, Lba);
+    if (Extent == NULL) {
+      // aligned writes of at least an extent full go straight to the device
+      if ((Bytes >= Cache->ExtentBlocks * BlockSize) &&
+          (ALIGN_POINTER (Data, MAX (Media->IoAlign, 1)) == Data))
+      {
+        DirectBytes = Bytes - (Bytes % BlockSize);
+        Status      = FPBlockIoCacheFlushRange (Cache, Lba, DirectBytes / BlockSize, NULL);
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+
+        Status = BlockIo->WriteBlocks (
+                            BlockIo,
+                            Media->MediaId,
+                            Lba,
+                            DirectBytes,
+                            (VOID *)Data
+                            );
+        if (EFI_ERROR (Status)) {
+          DEBUG ((
+            DEBUG_ERROR,
+            "%a: Error writing Lba=%llu, Bytes=%u: %r\n",
+            __FUNCTION__,
+            Lba,
+            DirectBytes,
+            Status
+            ));
+          return Status;
+        }
+
+        Data  += DirectBytes;
+        Bytes -= DirectBytes;
+        Lba   += DirectBytes / BlockSize;
+        continue;
+      }
+
+      Status = FPBlockIoCacheGetEmptyExtent (Cache, &Extent);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      Extent->Lba = Lba;
+    }
+
+    BlockIndex = (UINTN)(Lba - Extent->Lba);
+    ASSERT (BlockIndex < Cache->ExtentBlocks);
+
+    CopyBytes  = MIN (Bytes, (Cache->ExtentBlocks - BlockIndex) * BlockSize);
+    CopyBlocks = ALIGN_VALUE (CopyBytes, BlockSize) / BlockSize;
+
+    // older data of these blocks in other extents must not be written later
+    Status = FPBlockIoCacheFlushRange (Cache, Lba, CopyBlocks, Extent);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    CopyMem (Extent->Buffer + BlockIndex * BlockSize, Data, CopyBytes);
+    if (CopyBytes != CopyBlocks * BlockSize) {
+      ZeroMem (
+        Extent->Buffer + BlockIndex * BlockSize + CopyBytes,
+        CopyBlocks * BlockSize - CopyBytes
+        );
+    }
+
+    Extent->Blocks  = MAX (Extent->Blocks, BlockIndex + CopyBlocks);
+    Extent->LastUse = ++Cache->UseCount;
+    Data           += CopyBytes;
+    Bytes          -= CopyBytes;
+    Lba            += CopyBlocks;
+
+    if (Extent->Blocks == Cache->ExtentBlocks) {
+      Status = FPBlockIoCacheFlushExtent (Cache, Extent);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+FPBlockIoCacheRead (
+  IN  FW_PARTITION_BLOCK_IO_CACHE  *Cache,
+  IN  EFI_LBA                      Lba,
+  IN  UINTN                        Bytes,
+  OUT VOID                         *Buffer
+  )
+{
+  EFI_BLOCK_IO_PROTOCOL  *BlockIo;
+  EFI_STATUS             Status;
+
+  BlockIo = Cache->BlockIo;
+
+  Status = FPBlockIoCacheFlushRange (Cache, Lba, Bytes / BlockIo->Media->BlockSize, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return BlockIo->ReadBlocks (
+                    BlockIo,
+                    BlockIo->Media->MediaId,
+                    Lba,
+                    Bytes,
+                    Buffer
+                    );
+}
+
+VOID
+EFIAPI
+FPBlockIoCacheFree (
+  IN  FW_PARTITION_BLOCK_IO_CACHE  *Cache
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < FW_PARTITION_BLOCK_IO_CACHE_EXTENTS; Index++) {
+    ASSERT (Cache->Extents[Index].Blocks == 0);
+  }
+
+  if (Cache->Buffer != NULL) {
+    FreeAlignedPages (
+      Cache->Buffer,
+      EFI_SIZE_TO_PAGES (FW_PARTITION_BLOCK_IO_CACHE_EXTENTS * Cache->ExtentBlocks * Cache->BlockIo->Media->BlockSize)
+      );
+  }
+
+  ZeroMem (Cache, sizeof (*Cache));
+}
@@ -0,0 +1,134 @@
+/** @file
+  FW Partition BlockIo write cache
+
+  Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __FW_PARTITION_BLOCK_IO_CACHE_H__
+#define __FW_PARTITION_BLOCK_IO_CACHE_H__
+
+#include <Uefi/UefiBaseType.h>
+#include <Protocol/BlockIo.h>
+
+#define FW_PARTITION_BLOCK_IO_CACHE_EXTENTS  4
+
+// block-aligned extent of cached writes
+typedef struct {
+  UINT8      *Buffer;
+  EFI_LBA    Lba;
+  UINTN      Blocks;                    // 0 when empty
+  UINT64     LastUse;
+} FW_PARTITION_BLOCK_IO_CACHE_EXTENT;
+
+// write-back cache of non-overlapping extents of a BlockIo device, so
+// images written in turn each keep their own extent
+typedef struct {
+  EFI_BLOCK_IO_PROTOCOL                 *BlockIo;
+  UINT8                                 *Buffer;
+  UINTN                                 ExtentBlocks;
+  UINT64                                UseCount;
+  FW_PARTITION_BLOCK_IO_CACHE_EXTENT    Extents[FW_PARTITION_BLOCK_IO_CACHE_EXTENTS];
+} FW_PARTITION_BLOCK_IO_CACHE;
+
+/**
+  Initialize a write cache for a BlockIo device.
+
+  @param[out] Cache             Cache to initialize
+  @param[in]  BlockIo           BlockIo protocol of the device
+  @param[in]  ExtentBlocks      Size of each extent buffer in blocks
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the cache buffer
+
+**/
+EFI_STATUS
+EFIAPI
+FPBlockIoCacheInit (
+  OUT FW_PARTITION_BLOCK_IO_CACHE  *Cache,
+  IN  EFI_BLOCK_IO_PROTOCOL        *BlockIo,
+  IN  UINTN                        ExtentBlocks
+  );
+
+/**
+  Write the cached extents to the device in block order and empty the
+  cache.  The cache is emptied even if a write fails.
+
+  @param[in]  Cache             Cache to flush
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error writing the device
+
+**/
+EFI_STATUS
+EFIAPI
+FPBlockIoCacheFlush (
+  IN  FW_PARTITION_BLOCK_IO_CACHE  *Cache
+  );
+
+/**
+  Write data through the cache.  Writes that start inside or right after a
+  cached extent are merged into it, other writes start a new extent,
+  evicting the least recently written extent when all are in use.  Cached
+  extents the write overlaps are flushed first, so each block is cached at
+  most once.  A partial last block is padded with zeros.  Errors writing
+  previously cached data to the device are returned by the write that
+  flushes it.
+
+  @param[in]  Cache             Cache to write through
+  @param[in]  Lba               First block to write
+  @param[in]  Bytes             Number of bytes to write
+  @param[in]  Buffer            Address of write data, no alignment required
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error occurred
+
+**/
+EFI_STATUS
+EFIAPI
+FPBlockIoCacheWrite (
+  IN  FW_PARTITION_BLOCK_IO_CACHE  *Cache,
+  IN  EFI_LBA                      Lba,
+  IN  UINTN                        Bytes,
+  IN  CONST VOID                   *Buffer
+  );
+
+/**
+  Read data from the device, first flushing the cached extents the read
+  overlaps.
+
+  @param[in]  Cache             Cache of the device
+  @param[in]  Lba               First block to read
+  @param[in]  Bytes             Number of bytes to read, multiple of the block size
+  @param[out] Buffer            Address to read data into, aligned to IoAlign
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error occurred
+
+**/
+EFI_STATUS
+EFIAPI
+FPBlockIoCacheRead (
+  IN  FW_PARTITION_BLOCK_IO_CACHE  *Cache,
+  IN  EFI_LBA                      Lba,
+  IN  UINTN                        Bytes,
+  OUT VOID                         *Buffer
+  );
+
+/**
+  Free the resources of a write cache.  Cached data must be flushed first.
+
+  @param[in]  Cache             Cache to free
+
+  @retval None
+
+**/
+VOID
+EFIAPI
+FPBlockIoCacheFree (
+  IN  FW_PARTITION_BLOCK_IO_CACHE  *Cache
+  );
+
+#endif
@@ -23,25 +23,32 @@
 #include <Library/UefiLib.h>
 #include <Library/UefiRuntimeLib.h>
 #include <Protocol/BlockIo.h>
+#include <Protocol/ResetNotification.h>
+#include "FwPartitionBlockIoCache.h"
 
 #define FW_PARTITION_BLOCK_IO_MAX_DEVICES     3
 #define FW_PARTITION_USER_PARTITION           0
 #define FW_PARTITION_BOOT_PARTITION_ZERO      1
 #define FW_PARTITION_BOOT_PARTITION_ONE       2
 #define FW_PARTITION_BLOCK_IO_INFO_SIGNATURE  SIGNATURE_32 ('F','W','B','I')
-#define FW_PARTITION_LOCAL_BUFFER_BLOCKS      8
+#define FW_PARTITION_WRITE_CACHE_SIZE         SIZE_256KB
 
 // private BlockIo device data structure
 typedef struct {
-  UINT32                      Signature;
-  UINT64                      Bytes;
-  EFI_BLOCK_IO_PROTOCOL       *BlockIo;
-  FW_PARTITION_DEVICE_INFO    DeviceInfo;
+  UINT32                         Signature;
+  UINT64                         Bytes;
+  EFI_BLOCK_IO_PROTOCOL          *BlockIo;
+  FW_PARTITION_BLOCK_IO_CACHE    Cache;
+  FW_PARTITION_DEVICE_INFO       DeviceInfo;
 } FW_PARTITION_BLOCK_IO_INFO;
 
-STATIC FW_PARTITION_BLOCK_IO_INFO  *mBlockIoInfo       = NULL;
-STATIC UINTN                       mNumDevices         = 0;
-STATIC EFI_EVENT                   mAddressChangeEvent = NULL;
+STATIC FW_PARTITION_BLOCK_IO_INFO       *mBlockIoInfo            = NULL;
+STATIC UINTN                            mNumDevices              = 0;
+STATIC EFI_EVENT                        mAddressChangeEvent      = NULL;
+STATIC EFI_EVENT                        mExitBootServicesEvent   = NULL;
+STATIC EFI_EVENT                        mResetNotificationEvent  = NULL;
+STATIC VOID                             *mResetNotificationToken = NULL;
+STATIC EFI_RESET_NOTIFICATION_PROTOCOL  *mResetNotification      = NULL;
 
 /**
   Read data from device.
@@ -109,19 +116,19 @@ FPBlockIoRead (
     Bytes
     ));
 
-  return BlockIo->ReadBlocks (
-                    BlockIo,
-                    BlockIo->Media->MediaId,
-                    Offset / BlockIo->Media->BlockSize,
-                    Bytes,
-                    Buffer
-                    );
+  return FPBlockIoCacheRead (
+           &BlockIoInfo->Cache,
+           Offset / BlockIo->Media->BlockSize,
+           Bytes,
+           Buffer
+           );
 }
 
 /**
   Write data to device.  Supports unaligned buffers and partial last block
-  writes using copies through a local buffer, but Offset must be on a
-  block boundary.
+  writes, but Offset must be on a block boundary.  Writes go through the
+  device write cache, so adjacent writes reach the device as one request
+  and data may not reach the media until FPBlockIoFlush() is called.
 
   @param[in]  DeviceInfo        Pointer to device info struct
   @param[in]  Offset            Offset to write
@@ -143,12 +150,8 @@ FPBlockIoWrite (
   )
 {
   FW_PARTITION_BLOCK_IO_INFO  *BlockIoInfo;
-  EFI_BLOCK_IO_PROTOCOL       *BlockIo;
-  EFI_BLOCK_IO_MEDIA          *Media;
   EFI_STATUS                  Status;
   UINTN                       BlockSize;
-  VOID                        *LocalBuffer;
-  UINTN                       LocalBufferSize;
   EFI_LBA                     Lba;
 
   if (EfiAtRuntime ()) {
@@ -161,9 +164,7 @@ FPBlockIoWrite (
                   DeviceInfo,
                   FW_PARTITION_BLOCK_IO_INFO_SIGNATURE
                   );
-  BlockIo   = BlockIoInfo->BlockIo;
-  Media     = BlockIo->Media;
-  BlockSize = Media->BlockSize;
+  BlockSize = BlockIoInfo->BlockIo->Media->BlockSize;
   Lba       = Offset / BlockSize;
 
   if ((Offset % BlockSize) != 0) {
@@ -191,77 +192,7 @@ FPBlockIoWrite (
     Bytes
     ));
 
-  // handle unaligned buffer and/or partial block write using a local buffer
-  LocalBuffer = NULL;
-  if ((ALIGN_POINTER (Buffer, Media->IoAlign) != Buffer) ||
-      ((Bytes % BlockSize) != 0))
-  {
-    DEBUG ((DEBUG_VERBOSE, "Using local buffer for unaligned/partial write\n"));
-
-    LocalBufferSize = FW_PARTITION_LOCAL_BUFFER_BLOCKS * BlockSize;
-    LocalBuffer     = AllocateZeroPool (LocalBufferSize);
-    if (LocalBuffer == NULL) {
-      return EFI_OUT_OF_RESOURCES;
-    }
-
-    ASSERT (LocalBuffer == ALIGN_POINTER (LocalBuffer, Media->IoAlign));
-  }
-
-  while (Bytes > 0) {
-    UINTN  BytesToWrite;
-    VOID   *WriteBuffer;
-
-    if (LocalBuffer == NULL) {
-      BytesToWrite = Bytes;
-      WriteBuffer  = (VOID *)((UINTN)Buffer);     // remove CONST
-    } else {
-      WriteBuffer = LocalBuffer;
-      if (Bytes >= LocalBufferSize) {
-        BytesToWrite = LocalBufferSize;
-      } else {
-        BytesToWrite = Bytes;
-        if (ALIGN_VALUE (BytesToWrite, BlockSize) != BytesToWrite) {
-          BytesToWrite = ALIGN_VALUE (BytesToWrite, BlockSize);
-          SetMem (
-            (UINT8 *)LocalBuffer + Bytes,
-            BytesToWrite - Bytes,
-            0
-            );
-        }
-      }
-
-      CopyMem (LocalBuffer, Buffer, MIN (Bytes, BytesToWrite));
-    }
-
-    Status = BlockIo->WriteBlocks (
-                        BlockIo,
-                        Media->MediaId,
-                        Lba,
-                        BytesToWrite,
-                        WriteBuffer
-                        );
-    if (EFI_ERROR (Status)) {
-      DEBUG ((
-        DEBUG_ERROR,
-        "%a: Error writing Lba=%llu, Bytes=%u: %r\n",
-        __FUNCTION__,
-        Lba,
-        BytesToWrite,
-        Status
-        ));
-      break;
-    }
-
-    Bytes -= MIN (Bytes, BytesToWrite);
-    Buffer = (CONST UINT8 *)Buffer + BytesToWrite;
-    Lba   += (BytesToWrite / BlockSize);
-  }
-
-  if (LocalBuffer != NULL) {
-    FreePool (LocalBuffer);
-  }
-
-  return Status;
+  return FPBlockIoCacheWrite (&BlockIoInfo->Cache, Lba, Bytes, Buffer);
 }
 
 /**
@@ -342,6 +273,194 @@ FPBlockIoWriteBootPartition (
            );
 }
 
+/**
+  Write the device's cached data to the media.
+
+  @param[in]  DeviceInfo        Pointer to device info struct
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error occurred
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+FPBlockIoFlush (
+  IN  FW_PARTITION_DEVICE_INFO  *DeviceInfo
+  )
+{
+  FW_PARTITION_BLOCK_IO_INFO  *BlockIoInfo;
+
+  if (EfiAtRuntime ()) {
+    return EFI_UNSUPPORTED;
+  }
+
+  BlockIoInfo = CR (
+                  DeviceInfo,
+                  FW_PARTITION_BLOCK_IO_INFO,
+                  DeviceInfo,
+                  FW_PARTITION_BLOCK_IO_INFO_SIGNATURE
+                  );
+
+  return FPBlockIoCacheFlush (&BlockIoInfo->Cache);
+}
+
+/**
+  Write the cached data of both device boot partitions to the media.
+
+  @param[in]  DeviceInfo        Pointer to device info struct
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error occurred
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+FPBlockIoFlushBootPartition (
+  IN  FW_PARTITION_DEVICE_INFO  *DeviceInfo
+  )
+{
+  EFI_STATUS  Status;
+  EFI_STATUS  ReturnStatus;
+
+  ReturnStatus = FPBlockIoFlush (&mBlockIoInfo[FW_PARTITION_BOOT_PARTITION_ZERO].DeviceInfo);
+  if (mNumDevices > FW_PARTITION_BOOT_PARTITION_ONE) {
+    Status = FPBlockIoFlush (&mBlockIoInfo[FW_PARTITION_BOOT_PARTITION_ONE].DeviceInfo);
+    if (!EFI_ERROR (ReturnStatus)) {
+      ReturnStatus = Status;
+    }
+  }
+
+  return ReturnStatus;
+}
+
+/**
+  Write the cached data of all devices to the media.  Writers flush their
+  own data, this only catches data a writer left in a cache.
+
+  @retval None
+
+**/
+STATIC
+VOID
+EFIAPI
+FPBlockIoFlushAll (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  for (Index = 0; Index < mNumDevices; Index++) {
+    Status = FPBlockIoCacheFlush (&mBlockIoInfo[Index].Cache);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "%a: %s flush failed: %r\n",
+        __FUNCTION__,
+        mBlockIoInfo[Index].DeviceInfo.DeviceName,
+        Status
+        ));
+    }
+  }
+}
+
+/**
+  Flush the write caches before a system reset.
+
+  @param[in]  ResetType         Type of reset
+  @param[in]  ResetStatus       Status code of the reset
+  @param[in]  DataSize          Size of ResetData in bytes
+  @param[in]  ResetData         Optional reset data
+
+  @retval None
+
+**/
+STATIC
+VOID
+EFIAPI
+FPBlockIoResetNotify (
+  IN EFI_RESET_TYPE  ResetType,
+  IN EFI_STATUS      ResetStatus,
+  IN UINTN           DataSize,
+  IN VOID            *ResetData OPTIONAL
+  )
+{
+  if (!EfiAtRuntime ()) {
+    FPBlockIoFlushAll ();
+  }
+}
+
+/**
+  Register for reset notification once the protocol is installed.
+
+  @param[in]  Event         Event being handled
+  @param[in]  Context       Event context
+
+  @retval None
+
+**/
+STATIC
+VOID
+EFIAPI
+FPBlockIoResetNotificationInstalled (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  EFI_STATUS  Status;
+
+  if (mResetNotification != NULL) {
+    return;
+  }
+
+  Status = gBS->LocateProtocol (
+                  &gEfiResetNotificationProtocolGuid,
+                  mResetNotificationToken,
+                  (VOID **)&mResetNotification
+                  );
+  if (EFI_ERROR (Status)) {
+    mResetNotification = NULL;
+    return;
+  }
+
+  Status = mResetNotification->RegisterResetNotify (mResetNotification, FPBlockIoResetNotify);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Error registering reset notify: %r\n", __FUNCTION__, Status));
+    mResetNotification = NULL;
+  }
+
+  gBS->CloseEvent (Event);
+  mResetNotificationEvent = NULL;
+}
+
+/**
+  Flush the write caches when the OS takes over.  BlockIo requests are
+  rejected at runtime.
+
+  @param[in]  Event         Event being handled
+  @param[in]  Context       Event context
+
+  @retval None
+
+**/
+STATIC
+VOID
+EFIAPI
+FPBlockIoExitBootServicesNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  FPBlockIoFlushAll ();
+
+  if (mResetNotification != NULL) {
+    mResetNotification->UnregisterResetNotify (mResetNotification, FPBlockIoResetNotify);
+    mResetNotification = NULL;
+  }
+}
+
 /**
   Check if device path is a supported BlockIo device:
      eMMC: Type == MESSAGING_DEVICE_PATH (3),  SubType == MSG_EMMC_DP (0x1D)
@@ -498,6 +617,17 @@ FPBlockIoInitDevices (
                               BlockIo->Media->BlockSize);
     BlockIoInfo->BlockIo = BlockIo;
 
+    Status = FPBlockIoCacheInit (
+               &BlockIoInfo->Cache,
+               BlockIo,
+               MAX (FW_PARTITION_WRITE_CACHE_SIZE / FW_PARTITION_BLOCK_IO_CACHE_EXTENTS / BlockIo->Media->BlockSize, 1)
+               );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: write cache allocation failed\n", __FUNCTION__));
+      FreePool (HandleBuffer);
+      return Status;
+    }
+
     DeviceInfo             = &BlockIoInfo->DeviceInfo;
     DeviceInfo->DeviceName = DeviceName;
     DeviceInfo->BlockSize  = BlockIo->Media->BlockSize;
@@ -505,9 +635,11 @@ FPBlockIoInitDevices (
     if (mNumDevices == FW_PARTITION_USER_PARTITION) {
       DeviceInfo->DeviceRead  = FPBlockIoRead;
       DeviceInfo->DeviceWrite = FPBlockIoWrite;
+      DeviceInfo->DeviceFlush = FPBlockIoFlush;
     } else {
       DeviceInfo->DeviceRead  = FPBlockIoReadBootPartition;
       DeviceInfo->DeviceWrite = FPBlockIoWriteBootPartition;
+      DeviceInfo->DeviceFlush = FPBlockIoFlushBootPartition;
     }
 
     mNumDevices++;
@@ -567,6 +699,7 @@ FPBlockIoAddressChangeNotify (
     EfiConvertPointer (0x0, (VOID **)&DeviceInfo->DeviceName);
     EfiConvertPointer (0x0, (VOID **)&DeviceInfo->DeviceRead);
     EfiConvertPointer (0x0, (VOID **)&DeviceInfo->DeviceWrite);
+    EfiConvertPointer (0x0, (VOID **)&DeviceInfo->DeviceFlush);
   }
 
   EfiConvertPointer (0x0, (VOID **)&mBlockIoInfo);
@@ -732,6 +865,37 @@ FwPartitionBlockIoDxeInitialize (
     }
   }
 
+  Status = gBS->CreateEventEx (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  FPBlockIoExitBootServicesNotify,
+                  NULL,
+                  &gEfiEventExitBootServicesGuid,
+                  &mExitBootServicesEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: Error creating exit boot services event Status = %r\n",
+      __FUNCTION__,
+      Status
+      ));
+    goto Done;
+  }
+
+  mResetNotificationEvent = EfiCreateProtocolNotifyEvent (
+                              &gEfiResetNotificationProtocolGuid,
+                              TPL_CALLBACK,
+                              FPBlockIoResetNotificationInstalled,
+                              NULL,
+                              &mResetNotificationToken
+                              );
+  if (mResetNotificationEvent == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Error creating reset notification event\n", __FUNCTION__));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
   Status = gBS->CreateEventEx (
                   EVT_NOTIFY_SIGNAL,
                   TPL_NOTIFY,
@@ -757,6 +921,21 @@ Done:
       mAddressChangeEvent = NULL;
     }
 
+    if (mResetNotificationEvent != NULL) {
+      gBS->CloseEvent (mResetNotificationEvent);
+      mResetNotificationEvent = NULL;
+    }
+
+    if (mResetNotification != NULL) {
+      mResetNotification->UnregisterResetNotify (mResetNotification, FPBlockIoResetNotify);
+      mResetNotification = NULL;
+    }
+
+    if (mExitBootServicesEvent != NULL) {
+      gBS->CloseEvent (mExitBootServicesEvent);
+      mExitBootServicesEvent = NULL;
+    }
+
     if ((BrBctUpdatePrivate != NULL) && (BrBctUpdatePrivate->Handle != NULL)) {
       gBS->UninstallMultipleProtocolInterfaces (
              BrBctUpdatePrivate->Handle,
@@ -796,6 +975,12 @@ Done:
     FwPartitionDeviceLibDeinit ();
 
     if (mBlockIoInfo != NULL) {
+      // protocol users that wrote before the install failed did not flush
+      for (Index = 0; Index < mNumDevices; Index++) {
+        FPBlockIoCacheFlush (&mBlockIoInfo[Index].Cache);
+        FPBlockIoCacheFree (&mBlockIoInfo[Index].Cache);
+      }
+
       FreePool (mBlockIoInfo);
       mBlockIoInfo = NULL;
     }
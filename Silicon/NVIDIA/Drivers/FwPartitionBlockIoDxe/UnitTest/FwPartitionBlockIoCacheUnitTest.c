@@ -0,0 +1,744 @@
+/** @file
+
+  FW partition BlockIo write cache unit test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../FwPartitionBlockIoCache.h"
+
+#define UNIT_TEST_NAME     "FW Partition BlockIo Write Cache Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_BLOCK_SIZE     512
+#define TEST_DISK_BLOCKS    256
+#define TEST_DISK_SIZE      (TEST_BLOCK_SIZE * TEST_DISK_BLOCKS)
+#define TEST_IO_ALIGN       8
+#define TEST_CACHE_BLOCKS   16
+#define TEST_CHUNK_SIZE     (2 * TEST_BLOCK_SIZE)
+#define TEST_MEDIA_ID       0x5a
+#define TEST_MAX_WRITES     64
+#define TEST_NO_LBA         MAX_UINT64
+
+STATIC EFI_BLOCK_IO_MEDIA           mMedia;
+STATIC EFI_BLOCK_IO_PROTOCOL        mBlockIo;
+STATIC FW_PARTITION_BLOCK_IO_CACHE  mCache;
+STATIC UINT8                        *mDisk;
+STATIC UINT8                        *mExpected;
+STATIC UINT8                        *mData;
+STATIC UINTN                        mWriteCount;
+STATIC UINTN                        mReadCount;
+STATIC EFI_LBA                      mWriteLba[TEST_MAX_WRITES];
+STATIC UINTN                        mWriteBytes[TEST_MAX_WRITES];
+STATIC EFI_LBA                      mFailLba;
+
+/**
+  Check a simulated BlockIo request.
+
+  @param[in]  MediaId       Media id of the request
+  @param[in]  Lba           First block of the request
+  @param[in]  BufferSize    Size of the request
+  @param[in]  Buffer        Buffer of the request
+
+  @retval EFI_SUCCESS       Request is valid
+**/
+STATIC
+EFI_STATUS
+TestCheckRequest (
+  IN UINT32   MediaId,
+  IN EFI_LBA  Lba,
+  IN UINTN    BufferSize,
+  IN VOID     *Buffer
+  )
+{
+  if ((MediaId != TEST_MEDIA_ID) ||
+      ((BufferSize % TEST_BLOCK_SIZE) != 0) ||
+      (((UINTN)Buffer % TEST_IO_ALIGN) != 0) ||
+      (Lba * TEST_BLOCK_SIZE + BufferSize > TEST_DISK_SIZE))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Simulated BlockIo ReadBlocks.
+
+  @retval EFI_SUCCESS       Blocks read
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestReadBlocks (
+  IN  EFI_BLOCK_IO_PROTOCOL  *This,
+  IN  UINT32                 MediaId,
+  IN  EFI_LBA                Lba,
+  IN  UINTN                  BufferSize,
+  OUT VOID                   *Buffer
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = TestCheckRequest (MediaId, Lba, BufferSize, Buffer);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  CopyMem (Buffer, mDisk + Lba * TEST_BLOCK_SIZE, BufferSize);
+  mReadCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Simulated BlockIo WriteBlocks.  Records each write and fails writes
+  starting at mFailLba.
+
+  @retval EFI_SUCCESS       Blocks written
+  @retval EFI_DEVICE_ERROR  Write failed
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestWriteBlocks (
+  IN EFI_BLOCK_IO_PROTOCOL  *This,
+  IN UINT32                 MediaId,
+  IN EFI_LBA                Lba,
+  IN UINTN                  BufferSize,
+  IN VOID                   *Buffer
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = TestCheckRequest (MediaId, Lba, BufferSize, Buffer);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (mWriteCount < TEST_MAX_WRITES) {
+    mWriteLba[mWriteCount]   = Lba;
+    mWriteBytes[mWriteCount] = BufferSize;
+  }
+
+  mWriteCount++;
+  if (Lba == mFailLba) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  CopyMem (mDisk + Lba * TEST_BLOCK_SIZE, Buffer, BufferSize);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Fill a buffer with a pattern derived from Seed.
+
+  @param[out] Buffer        Buffer to fill
+  @param[in]  Size          Size of Buffer
+  @param[in]  Seed          Pattern seed
+**/
+STATIC
+VOID
+TestFill (
+  OUT UINT8  *Buffer,
+  IN  UINTN  Size,
+  IN  UINT8  Seed
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    Buffer[Index] = (UINT8)(Seed + Index * 7);
+  }
+}
+
+/**
+  Count the blocks held in the cache.
+
+  @retval UINTN             Number of cached blocks
+**/
+STATIC
+UINTN
+TestCachedBlocks (
+  VOID
+  )
+{
+  UINTN  Index;
+  UINTN  Blocks;
+
+  Blocks = 0;
+  for (Index = 0; Index < FW_PARTITION_BLOCK_IO_CACHE_EXTENTS; Index++) {
+    Blocks += mCache.Extents[Index].Blocks;
+  }
+
+  return Blocks;
+}
+
+/**
+  Count the cached extents.
+
+  @retval UINTN             Number of extents holding data
+**/
+STATIC
+UINTN
+TestCachedExtents (
+  VOID
+  )
+{
+  UINTN  Index;
+  UINTN  Extents;
+
+  Extents = 0;
+  for (Index = 0; Index < FW_PARTITION_BLOCK_IO_CACHE_EXTENTS; Index++) {
+    if (mCache.Extents[Index].Blocks != 0) {
+      Extents++;
+    }
+  }
+
+  return Extents;
+}
+
+/**
+  Write through the cache and record the data the disk must hold, padding
+  a partial last block with zeros like the cache does.
+
+  @param[in]  Offset        Byte offset to write, on a block boundary
+  @param[in]  Bytes         Number of bytes to write
+  @param[in]  Data          Data to write
+
+  @retval UNIT_TEST_PASSED  Write succeeded
+**/
+STATIC
+UNIT_TEST_STATUS
+TestWrite (
+  IN UINTN        Offset,
+  IN UINTN        Bytes,
+  IN CONST UINT8  *Data
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Padded;
+
+  UT_ASSERT_EQUAL (Offset % TEST_BLOCK_SIZE, 0);
+
+  Status = FPBlockIoCacheWrite (&mCache, Offset / TEST_BLOCK_SIZE, Bytes, Data);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Padded = ALIGN_VALUE (Bytes, TEST_BLOCK_SIZE);
+  CopyMem (mExpected + Offset, Data, Bytes);
+  ZeroMem (mExpected + Offset + Bytes, Padded - Bytes);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Setup the simulated device and cache.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Setup succeeded
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+
+  mDisk     = AllocateZeroPool (TEST_DISK_SIZE);
+  mExpected = AllocateZeroPool (TEST_DISK_SIZE);
+  mData     = AllocatePool (TEST_DISK_SIZE + 1);
+  UT_ASSERT_NOT_NULL (mDisk);
+  UT_ASSERT_NOT_NULL (mExpected);
+  UT_ASSERT_NOT_NULL (mData);
+
+  ZeroMem (&mMedia, sizeof (mMedia));
+  mMedia.MediaId       = TEST_MEDIA_ID;
+  mMedia.MediaPresent  = TRUE;
+  mMedia.BlockSize     = TEST_BLOCK_SIZE;
+  mMedia.IoAlign       = TEST_IO_ALIGN;
+  mMedia.LastBlock     = TEST_DISK_BLOCKS - 1;
+  mBlockIo.Media       = &mMedia;
+  mBlockIo.ReadBlocks  = TestReadBlocks;
+  mBlockIo.WriteBlocks = TestWriteBlocks;
+
+  Status = FPBlockIoCacheInit (&mCache, &mBlockIo, TEST_CACHE_BLOCKS);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL ((UINTN)mCache.Buffer % TEST_IO_ALIGN, 0);
+
+  mWriteCount = 0;
+  mReadCount  = 0;
+  mFailLba    = TEST_NO_LBA;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the simulated device and cache.
+
+  @param[in]  Context       Unit test context
+**/
+STATIC
+VOID
+EFIAPI
+TestCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mFailLba = TEST_NO_LBA;
+  FPBlockIoCacheFlush (&mCache);
+  FPBlockIoCacheFree (&mCache);
+  FreePool (mDisk);
+  FreePool (mExpected);
+  FreePool (mData);
+}
+
+/**
+  Sequential small unaligned writes are combined into buffer sized device
+  writes and land on the media unchanged.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SequentialWrites (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8       *Unaligned;
+  UINTN       Offset;
+  UINTN       Calls;
+  EFI_STATUS  Status;
+
+  // odd address so every write has to be copied through the cache buffer
+  Unaligned = mData + 1;
+  TestFill (Unaligned, TEST_DISK_SIZE, 0x11);
+
+  // an image written a chunk at a time, ending in a partial block
+  Calls = 0;
+  for (Offset = 0; Offset < TEST_DISK_SIZE / 2; Offset += TEST_CHUNK_SIZE) {
+    UT_ASSERT_EQUAL (TestWrite (Offset, TEST_CHUNK_SIZE, Unaligned + Offset), UNIT_TEST_PASSED);
+    Calls++;
+  }
+
+  UT_ASSERT_EQUAL (TestWrite (Offset, 100, Unaligned + Offset), UNIT_TEST_PASSED);
+  Calls++;
+
+  Status = FPBlockIoCacheFlush (&mCache);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  UT_ASSERT_EQUAL (Calls, 65);
+  UT_ASSERT_EQUAL (mWriteCount, (TEST_DISK_SIZE / 2) / (TEST_CACHE_BLOCKS * TEST_BLOCK_SIZE) + 1);
+  UT_ASSERT_MEM_EQUAL (mDisk, mExpected, TEST_DISK_SIZE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Block sized writes to consecutive blocks reach the device one extent at
+  a time, and a write elsewhere starts another extent.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+AdjacentAndDistantWrites (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN       Index;
+  EFI_STATUS  Status;
+
+  TestFill (mData, TEST_DISK_SIZE, 0x22);
+
+  for (Index = 0; Index < 4 * TEST_CACHE_BLOCKS; Index++) {
+    UT_ASSERT_EQUAL (
+      TestWrite (Index * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, mData + Index * TEST_BLOCK_SIZE),
+      UNIT_TEST_PASSED
+      );
+  }
+
+  UT_ASSERT_EQUAL (mWriteCount, 4);
+  UT_ASSERT_EQUAL (TestCachedBlocks (), 0);
+
+  // rewrite inside a cached extent, then jump away
+  UT_ASSERT_EQUAL (TestWrite (200 * TEST_BLOCK_SIZE, 3 * TEST_BLOCK_SIZE, mData), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestWrite (201 * TEST_BLOCK_SIZE, 10, mData + 1000), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mWriteCount, 4);
+  UT_ASSERT_EQUAL (TestCachedBlocks (), 3);
+
+  UT_ASSERT_EQUAL (TestWrite (100 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, mData + 3000), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mWriteCount, 4);
+  UT_ASSERT_EQUAL (TestCachedExtents (), 2);
+
+  Status = FPBlockIoCacheFlush (&mCache);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mWriteCount, 6);
+  UT_ASSERT_MEM_EQUAL (mDisk, mExpected, TEST_DISK_SIZE);
+
+  // flushing an empty cache does not touch the device
+  Status = FPBlockIoCacheFlush (&mCache);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mWriteCount, 6);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reads see data still held in the cache, and reads that miss a cached
+  extent leave it in place.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ReadAfterWrite (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8       *ReadBuffer;
+  EFI_STATUS  Status;
+
+  ReadBuffer = AllocatePool (4 * TEST_BLOCK_SIZE);
+  UT_ASSERT_NOT_NULL (ReadBuffer);
+
+  TestFill (mData, TEST_DISK_SIZE, 0x33);
+  UT_ASSERT_EQUAL (TestWrite (8 * TEST_BLOCK_SIZE, 2 * TEST_BLOCK_SIZE + 17, mData), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mWriteCount, 0);
+
+  // ends just before the cached extent
+  Status = FPBlockIoCacheRead (&mCache, 4, 4 * TEST_BLOCK_SIZE, ReadBuffer);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mWriteCount, 0);
+  UT_ASSERT_EQUAL (TestCachedBlocks (), 3);
+
+  // starts just after the cached extent
+  Status = FPBlockIoCacheRead (&mCache, 11, 4 * TEST_BLOCK_SIZE, ReadBuffer);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mWriteCount, 0);
+
+  // overlaps the last cached block
+  Status = FPBlockIoCacheRead (&mCache, 10, 4 * TEST_BLOCK_SIZE, ReadBuffer);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mWriteCount, 1);
+  UT_ASSERT_EQUAL (TestCachedBlocks (), 0);
+  UT_ASSERT_MEM_EQUAL (ReadBuffer, mExpected + 10 * TEST_BLOCK_SIZE, 4 * TEST_BLOCK_SIZE);
+  UT_ASSERT_EQUAL (mReadCount, 3);
+
+  FreePool (ReadBuffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Large aligned writes bypass an empty cache, with only a partial last
+  block copied through the buffer.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LargeWriteBypass (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN       Bytes;
+  EFI_STATUS  Status;
+
+  TestFill (mData, TEST_DISK_SIZE, 0x44);
+
+  Bytes = 4 * TEST_CACHE_BLOCKS * TEST_BLOCK_SIZE + 100;
+  UT_ASSERT_EQUAL (TestWrite (0, Bytes, mData), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mWriteCount, 1);
+  UT_ASSERT_EQUAL (TestCachedBlocks (), 1);
+  UT_ASSERT_EQUAL (mCache.Extents[0].Lba, 4 * TEST_CACHE_BLOCKS);
+
+  // a partial block write is padded with zeros on the media
+  Status = FPBlockIoCacheFlush (&mCache);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mWriteCount, 2);
+  UT_ASSERT_MEM_EQUAL (mDisk, mExpected, TEST_DISK_SIZE);
+
+  // with data cached an adjacent write first fills the buffer, then the
+  // rest of it bypasses the cache
+  UT_ASSERT_EQUAL (TestWrite (128 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, mData), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestWrite (129 * TEST_BLOCK_SIZE, 2 * TEST_CACHE_BLOCKS * TEST_BLOCK_SIZE, mData), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mWriteCount, 4);
+  UT_ASSERT_EQUAL (TestCachedBlocks (), 0);
+  UT_ASSERT_MEM_EQUAL (mDisk, mExpected, TEST_DISK_SIZE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Images written a chunk at a time in turn each fill their own extent, so
+  every device write is a full extent.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+InterleavedWrites (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN       Offset;
+  UINTN       Image;
+  UINTN       Index;
+  UINTN       ImageOffset;
+  EFI_STATUS  Status;
+
+  TestFill (mData, TEST_DISK_SIZE, 0x55);
+
+  for (Offset = 0; Offset < 2 * TEST_CACHE_BLOCKS * TEST_BLOCK_SIZE; Offset += TEST_CHUNK_SIZE) {
+    for (Image = 0; Image < 3; Image++) {
+      ImageOffset = Image * 64 * TEST_BLOCK_SIZE + Offset;
+      UT_ASSERT_EQUAL (TestWrite (ImageOffset, TEST_CHUNK_SIZE, mData + ImageOffset), UNIT_TEST_PASSED);
+    }
+  }
+
+  UT_ASSERT_EQUAL (mWriteCount, 6);
+  UT_ASSERT_EQUAL (TestCachedBlocks (), 0);
+  for (Index = 0; Index < mWriteCount; Index++) {
+    UT_ASSERT_EQUAL (mWriteBytes[Index], TEST_CACHE_BLOCKS * TEST_BLOCK_SIZE);
+  }
+
+  Status = FPBlockIoCacheFlush (&mCache);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mWriteCount, 6);
+  UT_ASSERT_MEM_EQUAL (mDisk, mExpected, TEST_DISK_SIZE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A write continuing an extent merges into it even if it runs into the
+  next extent, and a write overlapping other extents flushes them before
+  caching its newer data.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+OverlappingWrites (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+
+  TestFill (mData, TEST_DISK_SIZE, 0x66);
+
+  UT_ASSERT_EQUAL (TestWrite (10 * TEST_BLOCK_SIZE, 2 * TEST_BLOCK_SIZE, mData), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestWrite (14 * TEST_BLOCK_SIZE, 2 * TEST_BLOCK_SIZE, mData + 100), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestCachedExtents (), 2);
+
+  // continues the first extent into the second one
+  UT_ASSERT_EQUAL (TestWrite (12 * TEST_BLOCK_SIZE, 3 * TEST_BLOCK_SIZE, mData + 200), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mWriteCount, 1);
+  UT_ASSERT_EQUAL (mWriteLba[0], 14);
+  UT_ASSERT_EQUAL (TestCachedExtents (), 1);
+  UT_ASSERT_EQUAL (TestCachedBlocks (), 5);
+
+  // starts before the extent and covers part of it
+  UT_ASSERT_EQUAL (TestWrite (8 * TEST_BLOCK_SIZE, 4 * TEST_BLOCK_SIZE, mData + 300), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mWriteCount, 2);
+  UT_ASSERT_EQUAL (mWriteLba[1], 10);
+  UT_ASSERT_EQUAL (TestCachedBlocks (), 4);
+
+  Status = FPBlockIoCacheFlush (&mCache);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mWriteCount, 3);
+  UT_ASSERT_MEM_EQUAL (mDisk, mExpected, TEST_DISK_SIZE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  With every extent in use a new extent evicts the least recently written
+  one.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EvictOldestExtent (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN       Index;
+  EFI_STATUS  Status;
+
+  TestFill (mData, TEST_DISK_SIZE, 0x77);
+
+  for (Index = 0; Index < FW_PARTITION_BLOCK_IO_CACHE_EXTENTS; Index++) {
+    UT_ASSERT_EQUAL (TestWrite (Index * 32 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, mData + Index), UNIT_TEST_PASSED);
+  }
+
+  UT_ASSERT_EQUAL (TestCachedExtents (), FW_PARTITION_BLOCK_IO_CACHE_EXTENTS);
+  UT_ASSERT_EQUAL (mWriteCount, 0);
+
+  // the first extent is written again, so the second is the oldest
+  UT_ASSERT_EQUAL (TestWrite (TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, mData + 10), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestWrite (200 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, mData + 20), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mWriteCount, 1);
+  UT_ASSERT_EQUAL (mWriteLba[0], 32);
+  UT_ASSERT_EQUAL (mWriteBytes[0], TEST_BLOCK_SIZE);
+  UT_ASSERT_EQUAL (TestCachedExtents (), FW_PARTITION_BLOCK_IO_CACHE_EXTENTS);
+
+  UT_ASSERT_EQUAL (TestWrite (220 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, mData + 30), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mWriteCount, 2);
+  UT_ASSERT_EQUAL (mWriteLba[1], 64);
+
+  Status = FPBlockIoCacheFlush (&mCache);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_MEM_EQUAL (mDisk, mExpected, TEST_DISK_SIZE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A flush writes the extents in block order, and a failed extent write
+  does not keep the other extents from reaching the media.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FlushOrder (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+
+  TestFill (mData, TEST_DISK_SIZE, 0x88);
+
+  UT_ASSERT_EQUAL (TestWrite (150 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, mData), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestWrite (50 * TEST_BLOCK_SIZE, 2 * TEST_BLOCK_SIZE, mData + 1), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestWrite (100 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, mData + 2), UNIT_TEST_PASSED);
+
+  Status = FPBlockIoCacheFlush (&mCache);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mWriteCount, 3);
+  UT_ASSERT_EQUAL (mWriteLba[0], 50);
+  UT_ASSERT_EQUAL (mWriteLba[1], 100);
+  UT_ASSERT_EQUAL (mWriteLba[2], 150);
+  UT_ASSERT_MEM_EQUAL (mDisk, mExpected, TEST_DISK_SIZE);
+
+  UT_ASSERT_EQUAL (TestWrite (30 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, mData + 3), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestWrite (20 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, mData + 4), UNIT_TEST_PASSED);
+  mFailLba = 20;
+  Status   = FPBlockIoCacheFlush (&mCache);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_DEVICE_ERROR);
+  UT_ASSERT_EQUAL (mWriteCount, 5);
+  UT_ASSERT_EQUAL (TestCachedBlocks (), 0);
+  UT_ASSERT_MEM_EQUAL (mDisk + 30 * TEST_BLOCK_SIZE, mExpected + 30 * TEST_BLOCK_SIZE, TEST_BLOCK_SIZE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  write cache and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CacheTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&CacheTests, Framework, "Write Cache Tests", "UnitTest.FwPartitionBlockIoCache", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Write Cache Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    return Status;
+  }
+
+  AddTestCase (CacheTests, "Sequential small writes are combined", "SequentialWrites", SequentialWrites, TestSetup, TestCleanup, NULL);
+  AddTestCase (CacheTests, "Adjacent writes merge, distant writes start an extent", "AdjacentAndDistantWrites", AdjacentAndDistantWrites, TestSetup, TestCleanup, NULL);
+  AddTestCase (CacheTests, "Overlapping reads flush the cache", "ReadAfterWrite", ReadAfterWrite, TestSetup, TestCleanup, NULL);
+  AddTestCase (CacheTests, "Large aligned writes bypass the cache", "LargeWriteBypass", LargeWriteBypass, TestSetup, TestCleanup, NULL);
+  AddTestCase (CacheTests, "Interleaved writes keep their extents", "InterleavedWrites", InterleavedWrites, TestSetup, TestCleanup, NULL);
+  AddTestCase (CacheTests, "Overlapping extents are merged or flushed", "OverlappingWrites", OverlappingWrites, TestSetup, TestCleanup, NULL);
+  AddTestCase (CacheTests, "Least recently written extent is evicted", "EvictOldestExtent", EvictOldestExtent, TestSetup, TestCleanup, NULL);
+  AddTestCase (CacheTests, "Flush writes extents in block order", "FlushOrder", FlushOrder, TestSetup, TestCleanup, NULL);
+
+  // Execute the tests.
+  Status = RunAllTestSuites (Framework);
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
@@ -2,7 +2,7 @@
 
   MM FW partition protocol communication
 
-  Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2022-2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
   Copyright (c) 2010 - 2019, Intel Corporation. All rights reserved.<BR>
   Copyright (c) Microsoft Corporation.<BR>
 
@@ -287,3 +287,80 @@ MmSendWriteData (
 
   return Status;
 }
+
+EFI_STATUS
+EFIAPI
+MmSendEraseAsync (
+  IN  CONST CHAR16  *Name,
+  IN  UINT64        Offset,
+  IN  UINTN         Bytes
+  )
+{
+  EFI_STATUS                     Status;
+  FW_PARTITION_COMM_ERASE_ASYNC  *EraseAsyncPayload;
+  UINTN                          PayloadSize;
+
+  PayloadSize = sizeof (FW_PARTITION_COMM_ERASE_ASYNC);
+  Status      = MmInitCommBuffer (
+                  (VOID **)&EraseAsyncPayload,
+                  PayloadSize,
+                  FW_PARTITION_COMM_FUNCTION_ERASE_ASYNC
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ASSERT (EraseAsyncPayload != NULL);
+
+  ZeroMem (EraseAsyncPayload, sizeof (*EraseAsyncPayload));
+  Status = StrnCpyS (
+             EraseAsyncPayload->Name,
+             sizeof (EraseAsyncPayload->Name),
+             Name,
+             StrLen (Name)
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  EraseAsyncPayload->Offset = Offset;
+  EraseAsyncPayload->Bytes  = Bytes;
+
+  return MmSendCommBuffer (PayloadSize);
+}
+
+EFI_STATUS
+EFIAPI
+MmSendErasePoll (
+  IN  CONST CHAR16  *Name
+  )
+{
+  EFI_STATUS                    Status;
+  FW_PARTITION_COMM_ERASE_POLL  *ErasePollPayload;
+  UINTN                         PayloadSize;
+
+  PayloadSize = sizeof (FW_PARTITION_COMM_ERASE_POLL);
+  Status      = MmInitCommBuffer (
+                  (VOID **)&ErasePollPayload,
+                  PayloadSize,
+                  FW_PARTITION_COMM_FUNCTION_ERASE_POLL
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ASSERT (ErasePollPayload != NULL);
+
+  ZeroMem (ErasePollPayload, sizeof (*ErasePollPayload));
+  Status = StrnCpyS (
+             ErasePollPayload->Name,
+             sizeof (ErasePollPayload->Name),
+             Name,
+             StrLen (Name)
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return MmSendCommBuffer (PayloadSize);
+}
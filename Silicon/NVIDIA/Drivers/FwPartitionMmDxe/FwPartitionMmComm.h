@@ -2,7 +2,7 @@
 
   MM FW partition protocol communication
 
-  Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2022-2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
   Copyright (c) 2010 - 2019, Intel Corporation. All rights reserved.<BR>
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
@@ -24,6 +24,8 @@
 #define FW_PARTITION_COMM_FUNCTION_GET_PARTITIONS  2
 #define FW_PARTITION_COMM_FUNCTION_READ_DATA       3
 #define FW_PARTITION_COMM_FUNCTION_WRITE_DATA      4
+#define FW_PARTITION_COMM_FUNCTION_ERASE_ASYNC     5
+#define FW_PARTITION_COMM_FUNCTION_ERASE_POLL      6
 
 typedef struct {
   UINTN         Function;
@@ -71,6 +73,18 @@ typedef struct {
   UINT8     Data[1];
 } FW_PARTITION_COMM_WRITE_DATA;
 
+typedef struct {
+  // request fields
+  CHAR16    Name[FW_PARTITION_NAME_LENGTH];
+  UINT64    Offset;
+  UINTN     Bytes;
+} FW_PARTITION_COMM_ERASE_ASYNC;
+
+typedef struct {
+  // request fields
+  CHAR16    Name[FW_PARTITION_NAME_LENGTH];
+} FW_PARTITION_COMM_ERASE_POLL;
+
 EFI_STATUS
 EFIAPI
 MmInitCommBuffer (
@@ -119,6 +133,20 @@ MmSendWriteData (
   IN  CONST VOID    *Buffer
   );
 
+EFI_STATUS
+EFIAPI
+MmSendEraseAsync (
+  IN  CONST CHAR16  *Name,
+  IN  UINT64        Offset,
+  IN  UINTN         Bytes
+  );
+
+EFI_STATUS
+EFIAPI
+MmSendErasePoll (
+  IN  CONST CHAR16  *Name
+  );
+
 extern EFI_MM_COMMUNICATION2_PROTOCOL  *mMmCommProtocol;
 extern VOID                            *mMmCommBuffer;
 extern VOID                            *mMmCommBufferPhysical;
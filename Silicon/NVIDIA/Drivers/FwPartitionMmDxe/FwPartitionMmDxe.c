@@ -143,6 +143,71 @@ FPMmWrite (
   return Status;
 }
 
+STATIC
+EFI_STATUS
+EFIAPI
+FPMmEraseAsync (
+  IN  FW_PARTITION_DEVICE_INFO  *DeviceInfo,
+  IN  UINT64                    Offset,
+  IN  UINTN                     Bytes
+  )
+{
+  FW_PARTITION_MM_INFO  *MmInfo;
+  EFI_STATUS            Status;
+
+  MmInfo = CR (
+             DeviceInfo,
+             FW_PARTITION_MM_INFO,
+             DeviceInfo,
+             FW_PARTITION_MM_INFO_SIGNATURE
+             );
+
+  Status = FwPartitionCheckOffsetAndBytes (MmInfo->Bytes, Offset, Bytes);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: erase offset=%llu, bytes=%u error: %r\n",
+      __FUNCTION__,
+      Offset,
+      Bytes,
+      Status
+      ));
+    return Status;
+  }
+
+  Status = MmSendEraseAsync (MmInfo->PartitionName, Offset, Bytes);
+  DEBUG ((
+    DEBUG_VERBOSE,
+    "%a: erase %s Offset=%u, Bytes=%u: %r\n",
+    __FUNCTION__,
+    MmInfo->PartitionName,
+    Offset,
+    Bytes,
+    Status
+    ));
+
+  return Status;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FPMmErasePoll (
+  IN  FW_PARTITION_DEVICE_INFO  *DeviceInfo
+  )
+{
+  FW_PARTITION_MM_INFO  *MmInfo;
+
+  MmInfo = CR (
+             DeviceInfo,
+             FW_PARTITION_MM_INFO,
+             DeviceInfo,
+             FW_PARTITION_MM_INFO_SIGNATURE
+             );
+
+  return MmSendErasePoll (MmInfo->PartitionName);
+}
+
 /**
   Find MM partitions and add private data structures for them
 
@@ -201,10 +266,12 @@ FPMmAddPartitions (
       StrLen (PartitionInfo->Name)
       );
 
-    DeviceInfo->DeviceName  = MmInfo->PartitionName;
-    DeviceInfo->DeviceRead  = FPMmRead;
-    DeviceInfo->DeviceWrite = FPMmWrite;
-    DeviceInfo->BlockSize   = 1;
+    DeviceInfo->DeviceName       = MmInfo->PartitionName;
+    DeviceInfo->DeviceRead       = FPMmRead;
+    DeviceInfo->DeviceWrite      = FPMmWrite;
+    DeviceInfo->DeviceEraseAsync = FPMmEraseAsync;
+    DeviceInfo->DeviceErasePoll  = FPMmErasePoll;
+    DeviceInfo->BlockSize        = 1;
 
     Status = FwPartitionAdd (
                PartitionInfo->Name,
@@ -280,6 +347,8 @@ FPMmAddressChangeNotify (
     EfiConvertPointer (0x0, (VOID **)&DeviceInfo->DeviceName);
     EfiConvertPointer (0x0, (VOID **)&DeviceInfo->DeviceRead);
     EfiConvertPointer (0x0, (VOID **)&DeviceInfo->DeviceWrite);
+    EfiConvertPointer (0x0, (VOID **)&DeviceInfo->DeviceEraseAsync);
+    EfiConvertPointer (0x0, (VOID **)&DeviceInfo->DeviceErasePoll);
   }
 
   EfiConvertPointer (0x0, (VOID **)&mMmInfo);
@@ -24,17 +24,27 @@
 #include <Library/UefiRuntimeLib.h>
 #include <Protocol/NorFlash.h>
 
-#define MAX_NOR_FLASH_DEVICES                  1
+#define MAX_NOR_FLASH_DEVICES                  4  // one per socket
 #define FW_PARTITION_NOR_FLASH_INFO_SIGNATURE  SIGNATURE_32 ('F','W','N','S')
 
-// private device data structure
-typedef struct {
-  UINT32                       Signature;
-  UINT64                       Bytes;
-  NOR_FLASH_ATTRIBUTES         Attributes;
-  NVIDIA_NOR_FLASH_PROTOCOL    *NorFlash;
-  FW_PARTITION_DEVICE_INFO     DeviceInfo;
-} FW_PARTITION_NOR_FLASH_INFO;
+// private device data structure, [ErasedOffset, ErasedEnd) was erased by
+// FPNorFlashEraseAsync() and not written since, which keeps the device busy.
+// Writes and erases of the primary device are repeated on its Mirror chain,
+// the other sockets' devices holding the same partition layout.
+typedef struct _FW_PARTITION_NOR_FLASH_INFO FW_PARTITION_NOR_FLASH_INFO;
+
+struct _FW_PARTITION_NOR_FLASH_INFO {
+  UINT32                         Signature;
+  UINT32                         Socket;
+  UINT64                         Bytes;
+  NOR_FLASH_ATTRIBUTES           Attributes;
+  NVIDIA_NOR_FLASH_PROTOCOL      *NorFlash;
+  UINT64                         ErasedOffset;
+  UINT64                         ErasedEnd;
+  EFI_STATUS                     EraseStatus;
+  FW_PARTITION_NOR_FLASH_INFO    *Mirror;
+  FW_PARTITION_DEVICE_INFO       DeviceInfo;
+};
 
 STATIC FW_PARTITION_NOR_FLASH_INFO  *mNorFlashInfo = NULL;
 STATIC UINTN                        mNumDevices    = 0;
@@ -115,6 +125,189 @@ FPNorFlashErase (
   return NorFlash->Erase (NorFlash, OffsetLba, LbaCount);
 }
 
+/**
+  Record the status of an erase started by FPNorFlashEraseAsync().
+
+  @param[in]  Context           Pointer to NorFlash info struct
+  @param[in]  Status            Status of the erase
+
+  @retval None
+
+**/
+STATIC
+VOID
+EFIAPI
+FPNorFlashEraseComplete (
+  IN  VOID        *Context,
+  IN  EFI_STATUS  Status
+  )
+{
+  FW_PARTITION_NOR_FLASH_INFO  *NorFlashInfo;
+
+  NorFlashInfo              = (FW_PARTITION_NOR_FLASH_INFO *)Context;
+  NorFlashInfo->EraseStatus = Status;
+}
+
+/**
+  Start erasing data from device and its mirrors ahead of writing it.  The
+  mirrors on other sockets erase at the same time.  No other erase is started
+  until the range has been written, so writing the range never waits for an
+  erase of some other range.
+
+  @param[in]  DeviceInfo        Pointer to device info struct
+  @param[in]  Offset            Offset to begin erase
+  @param[in]  Bytes             Number of bytes to erase
+
+  @retval EFI_SUCCESS           Erase started
+  @retval EFI_ALREADY_STARTED   An earlier erased range is not yet written
+  @retval others                Error occurred
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+FPNorFlashEraseAsync (
+  IN  FW_PARTITION_DEVICE_INFO  *DeviceInfo,
+  IN  UINT64                    Offset,
+  IN  UINTN                     Bytes
+  )
+{
+  FW_PARTITION_NOR_FLASH_INFO  *NorFlashInfo;
+  FW_PARTITION_NOR_FLASH_INFO  *Info;
+  NVIDIA_NOR_FLASH_PROTOCOL    *NorFlash;
+  EFI_STATUS                   Status;
+  EFI_STATUS                   EraseStatus;
+  UINT32                       EraseBlockSize;
+  UINT32                       OffsetLba;
+  UINT32                       LbaCount;
+
+  NorFlashInfo = CR (
+                   DeviceInfo,
+                   FW_PARTITION_NOR_FLASH_INFO,
+                   DeviceInfo,
+                   FW_PARTITION_NOR_FLASH_INFO_SIGNATURE
+                   );
+  NorFlash       = NorFlashInfo->NorFlash;
+  EraseBlockSize = NorFlashInfo->Attributes.BlockSize;
+
+  if (NorFlash->EraseAsync == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = FwPartitionCheckOffsetAndBytes (NorFlashInfo->Bytes, Offset, Bytes);
+  if (EFI_ERROR (Status) || ((Offset % EraseBlockSize) != 0) || (Bytes == 0)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: erase offset=%llu, bytes=%u invalid\n",
+      __FUNCTION__,
+      Offset,
+      Bytes
+      ));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Info = NorFlashInfo; Info != NULL; Info = Info->Mirror) {
+    if (Info->ErasedOffset < Info->ErasedEnd) {
+      return EFI_ALREADY_STARTED;
+    }
+  }
+
+  OffsetLba = Offset / EraseBlockSize;
+  LbaCount  = ALIGN_VALUE (Bytes, EraseBlockSize) / EraseBlockSize;
+
+  // A mirror whose erase doesn't start erases the range when it is written
+  Status = EFI_UNSUPPORTED;
+  for (Info = NorFlashInfo; Info != NULL; Info = Info->Mirror) {
+    if (Info->NorFlash->EraseAsync == NULL) {
+      continue;
+    }
+
+    // The NOR flash only starts an erase once the previous one completed
+    EraseStatus = Info->NorFlash->EraseAsync (
+                                    Info->NorFlash,
+                                    OffsetLba,
+                                    LbaCount,
+                                    FPNorFlashEraseComplete,
+                                    Info
+                                    );
+    if (EFI_ERROR (EraseStatus)) {
+      DEBUG ((
+        DEBUG_INFO,
+        "%a: socket %u erase offset=%llu not started: %r\n",
+        __FUNCTION__,
+        Info->Socket,
+        Offset,
+        EraseStatus
+        ));
+      if (EFI_ERROR (Status)) {
+        Status = EraseStatus;
+      }
+
+      continue;
+    }
+
+    Info->EraseStatus  = EFI_SUCCESS;
+    Info->ErasedOffset = Offset;
+    Info->ErasedEnd    = Offset + Bytes;
+    Status             = EFI_SUCCESS;
+  }
+
+  return Status;
+}
+
+/**
+  Progress an erase started by FPNorFlashEraseAsync() on the device and its
+  mirrors.
+
+  @param[in]  DeviceInfo        Pointer to device info struct
+
+  @retval EFI_SUCCESS           No erase pending
+  @retval EFI_NOT_READY         Erase still in progress
+  @retval EFI_UNSUPPORTED       NorFlash can't erase in the background
+  @retval others                Erase failed
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+FPNorFlashErasePoll (
+  IN  FW_PARTITION_DEVICE_INFO  *DeviceInfo
+  )
+{
+  FW_PARTITION_NOR_FLASH_INFO  *NorFlashInfo;
+  FW_PARTITION_NOR_FLASH_INFO  *Info;
+  EFI_STATUS                   Status;
+
+  NorFlashInfo = CR (
+                   DeviceInfo,
+                   FW_PARTITION_NOR_FLASH_INFO,
+                   DeviceInfo,
+                   FW_PARTITION_NOR_FLASH_INFO_SIGNATURE
+                   );
+
+  if (NorFlashInfo->NorFlash->ErasePoll == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  // poll every device so each erase keeps moving
+  Status = EFI_SUCCESS;
+  for (Info = NorFlashInfo; Info != NULL; Info = Info->Mirror) {
+    if (Info->ErasedOffset >= Info->ErasedEnd) {
+      continue;
+    }
+
+    if (Info->NorFlash->ErasePoll (Info->NorFlash, FALSE) == EFI_NOT_READY) {
+      if (!EFI_ERROR (Status)) {
+        Status = EFI_NOT_READY;
+      }
+    } else if (EFI_ERROR (Info->EraseStatus)) {
+      Status = Info->EraseStatus;
+    }
+  }
+
+  return Status;
+}
+
 /**
   Read data from device.
 
@@ -182,9 +375,9 @@ FPNorFlashRead (
 }
 
 /**
-  Write data to device.
+  Write data to one NorFlash device.
 
-  @param[in]  DeviceInfo        Pointer to device info struct
+  @param[in]  NorFlashInfo      Pointer to NorFlash info struct
   @param[in]  Offset            Offset to write
   @param[in]  Bytes             Number of bytes to write
   @param[in]  Buffer            Address of write data
@@ -196,24 +389,17 @@ FPNorFlashRead (
 STATIC
 EFI_STATUS
 EFIAPI
-FPNorFlashWrite (
-  IN  FW_PARTITION_DEVICE_INFO  *DeviceInfo,
-  IN  UINT64                    Offset,
-  IN  UINTN                     Bytes,
-  IN  CONST VOID                *Buffer
+FPNorFlashWriteDevice (
+  IN  FW_PARTITION_NOR_FLASH_INFO  *NorFlashInfo,
+  IN  UINT64                       Offset,
+  IN  UINTN                        Bytes,
+  IN  CONST VOID                   *Buffer
   )
 {
-  VOID                         *NonConstBuffer;
-  FW_PARTITION_NOR_FLASH_INFO  *NorFlashInfo;
-  NVIDIA_NOR_FLASH_PROTOCOL    *NorFlash;
-  EFI_STATUS                   Status;
+  VOID                       *NonConstBuffer;
+  NVIDIA_NOR_FLASH_PROTOCOL  *NorFlash;
+  EFI_STATUS                 Status;
 
-  NorFlashInfo = CR (
-                   DeviceInfo,
-                   FW_PARTITION_NOR_FLASH_INFO,
-                   DeviceInfo,
-                   FW_PARTITION_NOR_FLASH_INFO_SIGNATURE
-                   );
   NorFlash = NorFlashInfo->NorFlash;
 
   // NorFlash protocol Write prototype uses non-const buffer pointer
@@ -232,18 +418,42 @@ FPNorFlashWrite (
     return Status;
   }
 
-  if (Offset % NorFlashInfo->Attributes.BlockSize == 0 ) {
-    Status = FPNorFlashErase (DeviceInfo, Offset, Bytes);
-    if (EFI_ERROR (Status)) {
+  if ((Offset >= NorFlashInfo->ErasedOffset) && ((Offset + Bytes) <= NorFlashInfo->ErasedEnd)) {
+    // erased ahead by FPNorFlashEraseAsync(), which must be complete
+    NorFlash->ErasePoll (NorFlash, TRUE);
+    if (EFI_ERROR (NorFlashInfo->EraseStatus)) {
       DEBUG ((
         DEBUG_ERROR,
-        "%a: erase offset=%llu, bytes=%u error: %r\n",
+        "%a: erase of 0x%llx-0x%llx failed: %r\n",
         __FUNCTION__,
-        Offset,
-        Bytes,
-        Status
+        NorFlashInfo->ErasedOffset,
+        NorFlashInfo->ErasedEnd - 1,
+        NorFlashInfo->EraseStatus
         ));
-      return Status;
+      NorFlashInfo->ErasedOffset = 0;
+      NorFlashInfo->ErasedEnd    = 0;
+      return NorFlashInfo->EraseStatus;
+    }
+
+    NorFlashInfo->ErasedOffset = Offset + Bytes;
+  } else {
+    // a write elsewhere abandons the range erased ahead
+    NorFlashInfo->ErasedOffset = 0;
+    NorFlashInfo->ErasedEnd    = 0;
+
+    if (Offset % NorFlashInfo->Attributes.BlockSize == 0 ) {
+      Status = FPNorFlashErase (&NorFlashInfo->DeviceInfo, Offset, Bytes);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((
+          DEBUG_ERROR,
+          "%a: erase offset=%llu, bytes=%u error: %r\n",
+          __FUNCTION__,
+          Offset,
+          Bytes,
+          Status
+          ));
+        return Status;
+      }
     }
   }
 
@@ -259,7 +469,140 @@ FPNorFlashWrite (
 }
 
 /**
-  Find NorFlash devices and initialize private data structures.
+  Write data to device and its mirrors.
+
+  @param[in]  DeviceInfo        Pointer to device info struct
+  @param[in]  Offset            Offset to write
+  @param[in]  Bytes             Number of bytes to write
+  @param[in]  Buffer            Address of write data
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error occurred
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+FPNorFlashWrite (
+  IN  FW_PARTITION_DEVICE_INFO  *DeviceInfo,
+  IN  UINT64                    Offset,
+  IN  UINTN                     Bytes,
+  IN  CONST VOID                *Buffer
+  )
+{
+  FW_PARTITION_NOR_FLASH_INFO  *NorFlashInfo;
+  EFI_STATUS                   Status;
+
+  NorFlashInfo = CR (
+                   DeviceInfo,
+                   FW_PARTITION_NOR_FLASH_INFO,
+                   DeviceInfo,
+                   FW_PARTITION_NOR_FLASH_INFO_SIGNATURE
+                   );
+
+  for ( ; NorFlashInfo != NULL; NorFlashInfo = NorFlashInfo->Mirror) {
+    Status = FPNorFlashWriteDevice (NorFlashInfo, Offset, Bytes, Buffer);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "%a: socket %u write offset=%llu failed: %r\n",
+        __FUNCTION__,
+        NorFlashInfo->Socket,
+        Offset,
+        Status
+        ));
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Read data from a NorFlash device for GptLib.
+
+  @param[in]  Context           Pointer to NorFlash info struct
+  @param[in]  Offset            Offset to read from
+  @param[in]  Bytes             Number of bytes to read
+  @param[out] Buffer            Address to read data into
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error occurred
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+FPNorFlashGptRead (
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  IN  UINTN   Bytes,
+  OUT VOID    *Buffer
+  )
+{
+  FW_PARTITION_NOR_FLASH_INFO  *NorFlashInfo;
+
+  NorFlashInfo = (FW_PARTITION_NOR_FLASH_INFO *)Context;
+  return FPNorFlashRead (&NorFlashInfo->DeviceInfo, Offset, Bytes, Buffer);
+}
+
+/**
+  Check if a NorFlash device holds the same partition layout as the primary
+  device, so it can be written as a mirror of the primary device.
+
+  @param[in]  Primary           Pointer to primary NorFlash info struct
+  @param[in]  NorFlashInfo      Pointer to NorFlash info struct to check
+
+  @retval BOOLEAN               TRUE if NorFlashInfo can mirror Primary
+
+**/
+STATIC
+BOOLEAN
+EFIAPI
+FPNorFlashIsMirror (
+  IN  FW_PARTITION_NOR_FLASH_INFO  *Primary,
+  IN  FW_PARTITION_NOR_FLASH_INFO  *NorFlashInfo
+  )
+{
+  GPT_TABLE   PrimaryTable;
+  GPT_TABLE   Table;
+  EFI_STATUS  Status;
+  BOOLEAN     IsMirror;
+
+  if ((NorFlashInfo->Bytes != Primary->Bytes) ||
+      (NorFlashInfo->Attributes.BlockSize != Primary->Attributes.BlockSize))
+  {
+    return FALSE;
+  }
+
+  Status = GptTableRead (FPNorFlashGptRead, Primary, Primary->Bytes, &PrimaryTable);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  Status = GptTableRead (FPNorFlashGptRead, NorFlashInfo, NorFlashInfo->Bytes, &Table);
+  if (EFI_ERROR (Status)) {
+    GptTableFree (&PrimaryTable);
+    return FALSE;
+  }
+
+  IsMirror = (Table.Header.NumberOfPartitionEntries == PrimaryTable.Header.NumberOfPartitionEntries) &&
+             (Table.Header.SizeOfPartitionEntry == PrimaryTable.Header.SizeOfPartitionEntry) &&
+             (CompareMem (
+                Table.PartitionTable,
+                PrimaryTable.PartitionTable,
+                GptPartitionTableSizeInBytes (&Table.Header)
+                ) == 0);
+
+  GptTableFree (&Table);
+  GptTableFree (&PrimaryTable);
+
+  return IsMirror;
+}
+
+/**
+  Find NorFlash devices and initialize private data structures.  The device
+  on the lowest socket is placed first as the primary device.
 
   @retval EFI_SUCCESS           Operation successful
   @retval others                Error occurred
@@ -272,12 +615,13 @@ FPNorFlashInitDevices (
   VOID
   )
 {
-  EFI_STATUS            Status;
-  UINTN                 HandleBufferSize;
-  EFI_HANDLE            HandleBuffer[MAX_NOR_FLASH_DEVICES];
-  UINTN                 NumHandles;
-  UINTN                 Index;
-  NOR_FLASH_ATTRIBUTES  Attributes;
+  EFI_STATUS                   Status;
+  UINTN                        HandleBufferSize;
+  EFI_HANDLE                   HandleBuffer[MAX_NOR_FLASH_DEVICES];
+  UINTN                        NumHandles;
+  UINTN                        Index;
+  NOR_FLASH_ATTRIBUTES         Attributes;
+  FW_PARTITION_NOR_FLASH_INFO  Swap;
 
   HandleBufferSize = sizeof (HandleBuffer);
   Status           = gMmst->MmLocateHandle (
@@ -299,6 +643,7 @@ FPNorFlashInitDevices (
     NVIDIA_NOR_FLASH_PROTOCOL    *NorFlash;
     FW_PARTITION_NOR_FLASH_INFO  *NorFlashInfo;
     FW_PARTITION_DEVICE_INFO     *DeviceInfo;
+    UINT32                       *Socket;
 
     Handle = HandleBuffer[Index];
     Status = gMmst->MmHandleProtocol (
@@ -327,9 +672,19 @@ FPNorFlashInitDevices (
       continue;
     }
 
+    Status = gMmst->MmHandleProtocol (
+                      Handle,
+                      &gNVIDIASocketIdProtocolGuid,
+                      (VOID **)&Socket
+                      );
+    if (EFI_ERROR (Status) || (Socket == NULL)) {
+      Socket = NULL;
+    }
+
     DEBUG ((
       DEBUG_INFO,
-      "Found MM-NorFlash BlockSize=%u, MemoryDensity=%llu\n",
+      "Found MM-NorFlash Socket=%u BlockSize=%u, MemoryDensity=%llu\n",
+      (Socket == NULL) ? 0 : *Socket,
       Attributes.BlockSize,
       Attributes.MemoryDensity
       ));
@@ -344,17 +699,26 @@ FPNorFlashInitDevices (
       break;
     }
 
-    NorFlashInfo              = &mNorFlashInfo[mNumDevices];
-    NorFlashInfo->Signature   = FW_PARTITION_NOR_FLASH_INFO_SIGNATURE;
-    mNorFlashInfo->Bytes      = Attributes.MemoryDensity;
-    mNorFlashInfo->Attributes = Attributes;
-    mNorFlashInfo->NorFlash   = NorFlash;
-
-    DeviceInfo              = &NorFlashInfo->DeviceInfo;
-    DeviceInfo->DeviceName  = L"MM-NorFlash";
-    DeviceInfo->DeviceRead  = FPNorFlashRead;
-    DeviceInfo->DeviceWrite = FPNorFlashWrite;
-    DeviceInfo->BlockSize   = Attributes.BlockSize;
+    NorFlashInfo             = &mNorFlashInfo[mNumDevices];
+    NorFlashInfo->Signature  = FW_PARTITION_NOR_FLASH_INFO_SIGNATURE;
+    NorFlashInfo->Socket     = (Socket == NULL) ? 0 : *Socket;
+    NorFlashInfo->Bytes      = Attributes.MemoryDensity;
+    NorFlashInfo->Attributes = Attributes;
+    NorFlashInfo->NorFlash   = NorFlash;
+
+    DeviceInfo                   = &NorFlashInfo->DeviceInfo;
+    DeviceInfo->DeviceName       = L"MM-NorFlash";
+    DeviceInfo->DeviceRead       = FPNorFlashRead;
+    DeviceInfo->DeviceWrite      = FPNorFlashWrite;
+    DeviceInfo->DeviceEraseAsync = FPNorFlashEraseAsync;
+    DeviceInfo->DeviceErasePoll  = FPNorFlashErasePoll;
+    DeviceInfo->BlockSize        = Attributes.BlockSize;
+
+    if ((mNumDevices > 0) && (NorFlashInfo->Socket < mNorFlashInfo[0].Socket)) {
+      CopyMem (&Swap, &mNorFlashInfo[0], sizeof (Swap));
+      CopyMem (&mNorFlashInfo[0], NorFlashInfo, sizeof (Swap));
+      CopyMem (NorFlashInfo, &Swap, sizeof (Swap));
+    }
 
     mNumDevices++;
   }
@@ -362,6 +726,51 @@ FPNorFlashInitDevices (
   return EFI_SUCCESS;
 }
 
+/**
+  Link the other sockets' NorFlash devices holding the same partition layout
+  as the primary device into its mirror chain.  Devices with another layout
+  are not written.
+
+  @retval None
+
+**/
+STATIC
+VOID
+EFIAPI
+FPNorFlashLinkMirrors (
+  VOID
+  )
+{
+  FW_PARTITION_NOR_FLASH_INFO  *Last;
+  UINTN                        Index;
+
+  Last = &mNorFlashInfo[0];
+  for (Index = 1; Index < mNumDevices; Index++) {
+    FW_PARTITION_NOR_FLASH_INFO  *NorFlashInfo = &mNorFlashInfo[Index];
+
+    if (!FPNorFlashIsMirror (&mNorFlashInfo[0], NorFlashInfo)) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "%a: socket %u NorFlash layout differs from socket %u, not updated\n",
+        __FUNCTION__,
+        NorFlashInfo->Socket,
+        mNorFlashInfo[0].Socket
+        ));
+      continue;
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "%a: socket %u NorFlash mirrors socket %u\n",
+      __FUNCTION__,
+      NorFlashInfo->Socket,
+      mNorFlashInfo[0].Socket
+      ));
+    Last->Mirror = NorFlashInfo;
+    Last         = NorFlashInfo;
+  }
+}
+
 /**
   Fw Partition Nor Flash Driver initialization entry point.
 
@@ -380,7 +789,6 @@ FwPartitionNorFlashStmmInitialize (
   )
 {
   EFI_STATUS  Status;
-  UINTN       Index;
 
   Status = FwPartitionDeviceLibInit (ActiveBootChain, MAX_FW_PARTITIONS, OverwriteActiveFwPartition);
   if (EFI_ERROR (Status)) {
@@ -408,21 +816,24 @@ FwPartitionNorFlashStmmInitialize (
     goto Done;
   }
 
-  // add FwPartition structs for all partitions in GPT on each device
-  for (Index = 0; Index < mNumDevices; Index++) {
-    FW_PARTITION_NOR_FLASH_INFO  *NorFlashInfo = &mNorFlashInfo[Index];
-    FW_PARTITION_DEVICE_INFO     *DeviceInfo   = &NorFlashInfo->DeviceInfo;
+  if (mNumDevices == 0) {
+    Status = EFI_NOT_FOUND;
+    goto Done;
+  }
 
-    Status = FwPartitionAddFromDeviceGpt (DeviceInfo, NorFlashInfo->Bytes);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((
-        DEBUG_ERROR,
-        "%a: Error adding partitions from FW device=%s: %r\n",
-        __FUNCTION__,
-        DeviceInfo->DeviceName,
-        Status
-        ));
-    }
+  // add FwPartition structs for all partitions in the primary device GPT,
+  // the other sockets' devices are written as its mirrors
+  FPNorFlashLinkMirrors ();
+
+  Status = FwPartitionAddFromDeviceGpt (&mNorFlashInfo[0].DeviceInfo, mNorFlashInfo[0].Bytes);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: Error adding partitions from FW device=%s: %r\n",
+      __FUNCTION__,
+      mNorFlashInfo[0].DeviceInfo.DeviceName,
+      Status
+      ));
   }
 
 Done:
@@ -2,7 +2,7 @@
 
   FW partition standalone MM
 
-  Copyright (c) 2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2022-2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -162,6 +162,58 @@ FwPartitionMmHandler (
       break;
     }
 
+    case FW_PARTITION_COMM_FUNCTION_ERASE_ASYNC:
+    {
+      FW_PARTITION_COMM_ERASE_ASYNC  *EraseAsyncPayload;
+      FW_PARTITION_PRIVATE_DATA      *Partition;
+
+      EraseAsyncPayload = (FW_PARTITION_COMM_ERASE_ASYNC *)FwImageCommHeader->Data;
+      ASSERT (PayloadSize == sizeof (FW_PARTITION_COMM_ERASE_ASYNC));
+
+      DEBUG ((
+        DEBUG_INFO,
+        "%a: erasing %s offset=%u bytes=%u\n",
+        __FUNCTION__,
+        EraseAsyncPayload->Name,
+        EraseAsyncPayload->Offset,
+        EraseAsyncPayload->Bytes
+        ));
+
+      Partition = FwPartitionFindByName (EraseAsyncPayload->Name);
+      if (Partition == NULL) {
+        FwImageCommHeader->ReturnStatus = EFI_NOT_FOUND;
+        break;
+      }
+
+      // partition protocol keeps the erase within the partition
+      Status = Partition->Protocol.EraseAsync (
+                                     &Partition->Protocol,
+                                     EraseAsyncPayload->Offset,
+                                     EraseAsyncPayload->Bytes
+                                     );
+
+      FwImageCommHeader->ReturnStatus = Status;
+      break;
+    }
+
+    case FW_PARTITION_COMM_FUNCTION_ERASE_POLL:
+    {
+      FW_PARTITION_COMM_ERASE_POLL  *ErasePollPayload;
+      FW_PARTITION_PRIVATE_DATA     *Partition;
+
+      ErasePollPayload = (FW_PARTITION_COMM_ERASE_POLL *)FwImageCommHeader->Data;
+      ASSERT (PayloadSize == sizeof (FW_PARTITION_COMM_ERASE_POLL));
+
+      Partition = FwPartitionFindByName (ErasePollPayload->Name);
+      if (Partition == NULL) {
+        FwImageCommHeader->ReturnStatus = EFI_NOT_FOUND;
+        break;
+      }
+
+      FwImageCommHeader->ReturnStatus = Partition->Protocol.ErasePoll (&Partition->Protocol);
+      break;
+    }
+
     default:
       FwImageCommHeader->ReturnStatus = EFI_INVALID_PARAMETER;
       break;
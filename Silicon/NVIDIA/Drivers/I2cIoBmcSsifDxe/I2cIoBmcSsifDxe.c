@@ -27,62 +27,219 @@
 #include <Protocol/IpmiTransportProtocol.h>
 #include <Protocol/I2cMaster.h>
 #include <Protocol/I2cEnumerate.h>
+#include <Protocol/IpmiAsyncTransport.h>
+
+#include "I2cIoBmcSsifTransport.h"
 
 #define BMC_SSIF_SIGNATURE      SIGNATURE_64 ('B','M','C','_','S','S','I','F')
-#define BMC_RETRY_COUNT         10
-#define BMC_RETRY_DELAY         100000
-#define BMC_SMBALERT_TIMEOUT    500000
 #define BMC_SMBALERT_POLL_TIME  100
+#define BMC_SSIF_POLL_INTERVAL  10000
 
 // Private data structure
 typedef struct {
-  UINT64                     Signature;
-
-  IPMI_TRANSPORT             IpmiTransport;
-  EFI_I2C_MASTER_PROTOCOL    *I2cMaster;
-  UINT32                     SlaveAddress;
+  UINT64                                  Signature;
 
-  VOID                       *ProtocolRegistration;
-  EFI_EVENT                  ProtocolEvent;
+  IPMI_TRANSPORT                          IpmiTransport;
+  NVIDIA_IPMI_ASYNC_TRANSPORT_PROTOCOL    AsyncTransport;
+  EFI_I2C_MASTER_PROTOCOL                 *I2cMaster;
+  UINT32                                  SlaveAddress;
 
-  BMC_STATUS                 BmcStatus;
-  UINT32                     SoftErrorCount;
+  VOID                                    *ProtocolRegistration;
+  EFI_EVENT                               ProtocolEvent;
 
-  EMBEDDED_GPIO              *Gpio;
-  BOOLEAN                    SmbAlertSupported;
-  EMBEDDED_GPIO_PIN          SmbAlertGpio;
-} BMC_SSIF_PRIVATE_DATA;
+  BMC_STATUS                              BmcStatus;
 
-#define BMC_SSIF_PRIVATE_DATA_FROM_IPMI(a)  CR (a, BMC_SSIF_PRIVATE_DATA, IpmiTransport, BMC_SSIF_SIGNATURE)
+  EMBEDDED_GPIO                           *Gpio;
+  BOOLEAN                                 SmbAlertSupported;
+  EMBEDDED_GPIO_PIN                       SmbAlertGpio;
 
-#define BMC_SSIF_SINGLE_PART_WRITE_CMD        0x2
-#define BMC_SSIF_SINGLE_PART_READ_CMD         0x3
-#define BMC_SSIF_MULTI_PART_WRITE_CMD_START   0x6
-#define BMC_SSIF_MULTI_PART_WRITE_CMD_MIDDLE  0x7
-#define BMC_SSIF_MULTI_PART_WRITE_CMD_END     0x8
-// Arm Server Base Manageability Requirements 1.1
-#define BMC_SSIF_MULTI_PART_READ_CMD_MIDDLE_END    0x9
-#define BMC_SSIF_MULTI_PART_READ_CMD_MIDDLE_RETRY  0xA
+  // Queued requests, accessed at TPL_CALLBACK
+  SSIF_TRANSPORT                          Transport;
+  EFI_EVENT                               PollEvent;
+  BOOLEAN                                 PollTimerActive;
+  BOOLEAN                                 Busy;
+} BMC_SSIF_PRIVATE_DATA;
 
-#define SSIF_MAX_DATA            0x20
-#define SSIF_HEADER_SIZE         2
-#define SMBUS_WRITE_HEADER_SIZE  2
-#define SMBUS_READ_HEADER_SIZE   1
+#define BMC_SSIF_PRIVATE_DATA_FROM_IPMI(a)   CR (a, BMC_SSIF_PRIVATE_DATA, IpmiTransport, BMC_SSIF_SIGNATURE)
+#define BMC_SSIF_PRIVATE_DATA_FROM_ASYNC(a)  CR (a, BMC_SSIF_PRIVATE_DATA, AsyncTransport, BMC_SSIF_SIGNATURE)
 
 #define BMC_SLAVE_ADDRESS  0x20
 #define MAX_SOFT_COUNT     10
 
-typedef struct {
-  ///
-  /// Number of elements in the operation array
-  ///
-  UINTN                OperationCount;
+/**
+  Advance the SSIF transport and complete the requests that finished.
+
+  Asynchronous requests have their token signaled and are freed, synchronous
+  requests are left for their submitter to collect.
+
+  @param[in]  Private   SSIF private data
+
+  @retval TRUE    Transport advanced
+  @retval FALSE   Transport is in use by an interrupted caller
+
+**/
+STATIC
+BOOLEAN
+I2cIoBmcSsifProcess (
+  IN BMC_SSIF_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS               Status;
+  SSIF_REQUEST             *Request;
+  NVIDIA_IPMI_ASYNC_TOKEN  *Token;
+  BOOLEAN                  AlertAsserted;
+  UINTN                    GpioValue;
+
+  if (Private->Busy) {
+    return FALSE;
+  }
+
+  Private->Busy = TRUE;
+  do {
+    AlertAsserted = FALSE;
+    if (Private->SmbAlertSupported) {
+      Status = Private->Gpio->Get (Private->Gpio, Private->SmbAlertGpio, &GpioValue);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "%a: Error reading SMBALERT gpio - %r\r\n", __FUNCTION__, Status));
+      } else {
+        AlertAsserted = (GpioValue == 0);
+      }
+    }
+
+    Request = SsifTransportPoll (&Private->Transport, GetTimeInNanoSecond (GetPerformanceCounter ()) / 1000, AlertAsserted);
+    if ((Request != NULL) && (Request->Context != NULL)) {
+      Token                    = (NVIDIA_IPMI_ASYNC_TOKEN *)Request->Context;
+      Token->TransactionStatus = Request->Status;
+      gBS->SignalEvent (Token->Event);
+      FreePool (Request);
+    }
+  } while (Request != NULL);
+
+  Private->Busy = FALSE;
+  return TRUE;
+}
+
+/**
+  Start or stop the poll timer depending on whether requests are pending.
+
+  @param[in]  Private   SSIF private data
+
+**/
+STATIC
+VOID
+I2cIoBmcSsifUpdatePollTimer (
+  IN BMC_SSIF_PRIVATE_DATA  *Private
+  )
+{
+  BOOLEAN  Active;
+
+  Active = !SsifTransportIdle (&Private->Transport);
+  if (Active == Private->PollTimerActive) {
+    return;
+  }
+
+  gBS->SetTimer (Private->PollEvent, Active ? TimerPeriodic : TimerCancel, BMC_SSIF_POLL_INTERVAL);
+  Private->PollTimerActive = Active;
+}
+
+/**
+  Timer callback that drives queued asynchronous requests.
+
+  @param[in]  Event     Timer event
+  @param[in]  Context   SSIF private data
+
+**/
+STATIC
+VOID
+EFIAPI
+I2cIoBmcSsifPollNotify (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  BMC_SSIF_PRIVATE_DATA  *Private;
+
+  Private = (BMC_SSIF_PRIVATE_DATA *)Context;
+  if (I2cIoBmcSsifProcess (Private)) {
+    I2cIoBmcSsifUpdatePollTimer (Private);
+  }
+}
+
+/**
+  Submit a command and wait for it to complete.
+
+  Requests queued ahead of this one are processed first. The transport is only
+  updated at TPL_CALLBACK or above, where it is serialized with the poll timer.
+  The wait between polls runs at the caller's TPL.
+
+  @param[in]      Private           SSIF private data
+  @param[in]      NetFunction       Net function of the command.
+  @param[in]      Lun               Logical unit of the command.
+  @param[in]      Command           IPMI Command.
+  @param[in]      RequestData       Command Request Data.
+  @param[in]      RequestDataSize   Size of Command Request Data.
+  @param[out]     ResponseData      Command Response Data.
+  @param[in, out] ResponseDataSize  Size of Command Response Data.
+
+  @retval EFI_SUCCESS           Command completed
+  @retval EFI_NOT_READY         Transport is in use by an interrupted caller
+  @retval EFI_BAD_BUFFER_SIZE   Request is larger than the BMC supports
+  @retval Others                Command failed
+
+**/
+STATIC
+EFI_STATUS
+I2cIoBmcSsifSubmitSync (
+  IN     BMC_SSIF_PRIVATE_DATA  *Private,
+  IN     UINT8                  NetFunction,
+  IN     UINT8                  Lun,
+  IN     UINT8                  Command,
+  IN     UINT8                  *RequestData,
+  IN     UINT32                 RequestDataSize,
+  OUT    UINT8                  *ResponseData,
+  IN OUT UINT32                 *ResponseDataSize
+  )
+{
+  EFI_STATUS    Status;
+  SSIF_REQUEST  Request;
+  EFI_TPL       Tpl;
+  EFI_TPL       OldTpl;
+  BOOLEAN       Complete;
+
+  SsifRequestInit (&Request, NetFunction, Lun, Command, RequestData, RequestDataSize, ResponseData, ResponseDataSize, NULL);
+
+  // Callers above TPL_CALLBACK may have interrupted a transfer in progress
+  Tpl    = MAX (EfiGetCurrentTpl (), TPL_CALLBACK);
+  OldTpl = gBS->RaiseTPL (Tpl);
+  if (Private->Busy) {
+    gBS->RestoreTPL (OldTpl);
+    return EFI_NOT_READY;
+  }
+
+  Status = SsifTransportQueue (&Private->Transport, &Request);
+  gBS->RestoreTPL (OldTpl);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  while (TRUE) {
+    OldTpl = gBS->RaiseTPL (Tpl);
+    I2cIoBmcSsifProcess (Private);
+    Complete = (Request.State == SsifRequestComplete);
+    if (Complete) {
+      I2cIoBmcSsifUpdatePollTimer (Private);
+    }
+
+    gBS->RestoreTPL (OldTpl);
+    if (Complete) {
+      break;
+    }
+
+    gBS->Stall (BMC_SMBALERT_POLL_TIME);
+  }
 
-  ///
-  /// Description of the I2C operation
-  ///
-  EFI_I2C_OPERATION    Operation[2];
-} SSIF_REQUEST_PACKET;
+  return Request.Status;
+}
 
 /**
   This service enables submitting commands via Ipmi.
@@ -115,274 +272,87 @@ I2cIoBmcSsifIpmiSubmitCommand (
   IN OUT UINT32          *ResponseDataSize
   )
 {
-  EFI_STATUS             Status;
-  BMC_SSIF_PRIVATE_DATA  *BmcSsifPrivate;
-  SSIF_REQUEST_PACKET    Packet;
-  UINT8                  WriteData[SSIF_MAX_DATA + SMBUS_WRITE_HEADER_SIZE];
-  UINT8                  ReadData[SSIF_MAX_DATA + SMBUS_READ_HEADER_SIZE];
-  UINT32                 DataLeft;
-  UINT32                 DataSize;
-  UINT8                  ExpectedBlock;
-  UINT32                 ResponseDataBufferSize;
-  UINT32                 RetryCount;
-  UINT32                 OverallRetryCount;
-  UINT64                 Timeout;
-  UINTN                  GpioValue;
-  UINT64                 StartTime, EndTime;
-
-  BmcSsifPrivate         = BMC_SSIF_PRIVATE_DATA_FROM_IPMI (This);
-  ResponseDataBufferSize = *ResponseDataSize;
-
-  for (OverallRetryCount = 0; OverallRetryCount < BMC_RETRY_COUNT; OverallRetryCount++) {
-    // Transmit data
-    if ((RequestDataSize + SSIF_HEADER_SIZE) <= SSIF_MAX_DATA) {
-      // SinglePart
-      WriteData[0]                           = BMC_SSIF_SINGLE_PART_WRITE_CMD;
-      WriteData[1]                           = RequestDataSize + SSIF_HEADER_SIZE;
-      WriteData[SMBUS_WRITE_HEADER_SIZE + 0] = NetFunction << 2 | (Lun & 0x3);
-      WriteData[SMBUS_WRITE_HEADER_SIZE + 1] = Command;
-      CopyMem (WriteData + SMBUS_WRITE_HEADER_SIZE + SSIF_HEADER_SIZE, RequestData, RequestDataSize);
-
-      Packet.OperationCount             = 1;
-      Packet.Operation[0].Flags         = I2C_FLAG_SMBUS_OPERATION | I2C_FLAG_SMBUS_BLOCK | I2C_FLAG_SMBUS_PEC;
-      Packet.Operation[0].LengthInBytes = RequestDataSize + SSIF_HEADER_SIZE + SMBUS_WRITE_HEADER_SIZE;
-      Packet.Operation[0].Buffer        = WriteData;
-
-      Status = BmcSsifPrivate->I2cMaster->StartRequest (BmcSsifPrivate->I2cMaster, BmcSsifPrivate->SlaveAddress, (EFI_I2C_REQUEST_PACKET *)&Packet, NULL, NULL);
-      if (EFI_ERROR (Status)) {
-        BmcSsifPrivate->SoftErrorCount++;
-        BmcSsifPrivate->BmcStatus = BMC_SOFTFAIL;
-        DEBUG ((DEBUG_ERROR, "%a: Failed to send single part write - %r\r\n", __FUNCTION__, Status));
-        return Status;
-      }
-    } else {
-      // Multi-part
-      WriteData[0]                           = BMC_SSIF_MULTI_PART_WRITE_CMD_START;
-      WriteData[1]                           = SSIF_MAX_DATA;
-      WriteData[SMBUS_WRITE_HEADER_SIZE + 0] = NetFunction << 2;
-      WriteData[SMBUS_WRITE_HEADER_SIZE + 1] = Command;
-      CopyMem (WriteData + SMBUS_WRITE_HEADER_SIZE + SSIF_HEADER_SIZE, RequestData, SSIF_MAX_DATA - SSIF_HEADER_SIZE);
-
-      Packet.OperationCount             = 1;
-      Packet.Operation[0].Flags         = I2C_FLAG_SMBUS_OPERATION | I2C_FLAG_SMBUS_BLOCK | I2C_FLAG_SMBUS_PEC;
-      Packet.Operation[0].LengthInBytes = SSIF_MAX_DATA + SMBUS_WRITE_HEADER_SIZE;
-      Packet.Operation[0].Buffer        = WriteData;
-
-      Status = BmcSsifPrivate->I2cMaster->StartRequest (BmcSsifPrivate->I2cMaster, BmcSsifPrivate->SlaveAddress, (EFI_I2C_REQUEST_PACKET *)&Packet, NULL, NULL);
-      if (EFI_ERROR (Status)) {
-        BmcSsifPrivate->SoftErrorCount++;
-        BmcSsifPrivate->BmcStatus = BMC_SOFTFAIL;
-        DEBUG ((DEBUG_ERROR, "%a: Failed to send multi part write start - %r\r\n", __FUNCTION__, Status));
-        return Status;
-      }
-
-      DataLeft = RequestDataSize - (SSIF_MAX_DATA - SSIF_HEADER_SIZE);
-      while (DataLeft != 0) {
-        if (DataLeft <= SSIF_MAX_DATA) {
-          WriteData[0] = BMC_SSIF_MULTI_PART_WRITE_CMD_END;
-          DataSize     = DataLeft;
-        } else {
-          WriteData[0] = BMC_SSIF_MULTI_PART_WRITE_CMD_MIDDLE;
-          DataSize     = SSIF_MAX_DATA;
-        }
-
-        WriteData[1] = DataSize;
-        CopyMem (WriteData + SMBUS_WRITE_HEADER_SIZE, RequestData + (RequestDataSize - DataLeft), DataSize);
-
-        Packet.OperationCount             = 1;
-        Packet.Operation[0].Flags         = I2C_FLAG_SMBUS_OPERATION | I2C_FLAG_SMBUS_BLOCK | I2C_FLAG_SMBUS_PEC;
-        Packet.Operation[0].LengthInBytes = DataSize + SMBUS_WRITE_HEADER_SIZE;
-        Packet.Operation[0].Buffer        = WriteData;
-
-        Status = BmcSsifPrivate->I2cMaster->StartRequest (BmcSsifPrivate->I2cMaster, BmcSsifPrivate->SlaveAddress, (EFI_I2C_REQUEST_PACKET *)&Packet, NULL, NULL);
-        if (EFI_ERROR (Status)) {
-          BmcSsifPrivate->SoftErrorCount++;
-          BmcSsifPrivate->BmcStatus = BMC_SOFTFAIL;
-          DEBUG ((DEBUG_ERROR, "%a: Failed to send multi part write continue/end - %r\r\n", __FUNCTION__, Status));
-          return Status;
-        }
-
-        DataLeft -= DataSize;
-      }
-    }
-
-    if (ResponseData != NULL) {
-      if (BmcSsifPrivate->SmbAlertSupported) {
-        StartTime = GetTimeInNanoSecond (GetPerformanceCounter ());
-        Timeout   = BMC_SMBALERT_TIMEOUT/BMC_SMBALERT_POLL_TIME;
-        while (Timeout != 0) {
-          Status = BmcSsifPrivate->Gpio->Get (BmcSsifPrivate->Gpio, BmcSsifPrivate->SmbAlertGpio, &GpioValue);
-          if (EFI_ERROR (Status)) {
-            DEBUG ((DEBUG_ERROR, "%a: Error reading SMBALERT gpio - %r\r\n", __FUNCTION__, Status));
-            Timeout = 0;
-            break;
-          }
-
-          if (GpioValue == 0) {
-            break;
-          }
-
-          gBS->Stall (BMC_SMBALERT_POLL_TIME);
-          Timeout--;
-        }
+  return I2cIoBmcSsifSubmitSync (
+           BMC_SSIF_PRIVATE_DATA_FROM_IPMI (This),
+           NetFunction,
+           Lun,
+           Command,
+           RequestData,
+           RequestDataSize,
+           ResponseData,
+           ResponseDataSize
+           );
+}
 
-        if (Timeout == 0) {
-          DEBUG ((DEBUG_ERROR, "%a: Timeout reading SMBALERT gpio\r\n", __FUNCTION__));
-        } else {
-          EndTime = GetTimeInNanoSecond (GetPerformanceCounter ());
-          DEBUG ((DEBUG_INFO, "%a: SMBALERT gpio Time %dus\r\n", __FUNCTION__, (EndTime-StartTime)/1000));
-        }
-      } else {
-        gBS->Stall (BMC_RETRY_DELAY);
-      }
+/**
+  This service submits a command via Ipmi, optionally without waiting for it.
+
+  @param[in]      This              The instance of the NVIDIA_IPMI_ASYNC_TRANSPORT_PROTOCOL.
+  @param[in, out] Token             Optional token, NULL to process the command in a blocking manner.
+  @param[in]      NetFunction       Net function of the command.
+  @param[in]      Lun               Logical unit of the command.
+  @param[in]      Command           IPMI Command.
+  @param[in]      RequestData       Command Request Data.
+  @param[in]      RequestDataSize   Size of Command Request Data.
+  @param[out]     ResponseData      Command Response Data.
+  @param[in, out] ResponseDataSize  Size of Command Response Data.
+
+  @retval EFI_SUCCESS             Command queued, or completed if Token is NULL
+  @retval EFI_INVALID_PARAMETER   Token is not NULL but Token->Event is NULL
+  @retval EFI_BAD_BUFFER_SIZE     Request is larger than the BMC supports
+  @retval EFI_OUT_OF_RESOURCES    Failed to allocate the request
+  @retval Others                  Command failed
 
-      for (RetryCount = 0; RetryCount < BMC_RETRY_COUNT; RetryCount++) {
-        // Get response data
-        WriteData[0] = BMC_SSIF_SINGLE_PART_READ_CMD;
-
-        Packet.OperationCount             = 2;
-        Packet.Operation[0].Flags         = I2C_FLAG_SMBUS_OPERATION | I2C_FLAG_SMBUS_BLOCK | I2C_FLAG_SMBUS_PEC;
-        Packet.Operation[0].LengthInBytes = 1;
-        Packet.Operation[0].Buffer        = WriteData;
-        Packet.Operation[1].Flags         = I2C_FLAG_READ;
-        Packet.Operation[1].LengthInBytes = SSIF_MAX_DATA + SMBUS_READ_HEADER_SIZE;
-        Packet.Operation[1].Buffer        = ReadData;
-
-        Status = BmcSsifPrivate->I2cMaster->StartRequest (BmcSsifPrivate->I2cMaster, BmcSsifPrivate->SlaveAddress, (EFI_I2C_REQUEST_PACKET *)&Packet, NULL, NULL);
-        if (EFI_ERROR (Status)) {
-          BmcSsifPrivate->SoftErrorCount++;
-          BmcSsifPrivate->BmcStatus = BMC_SOFTFAIL;
-          DEBUG ((DEBUG_ERROR, "%a: Failed to send read command - %r\r\n", __FUNCTION__, Status));
-          if ((Status == EFI_NO_RESPONSE) &&
-              !BmcSsifPrivate->SmbAlertSupported)
-          {
-            gBS->Stall (BMC_RETRY_DELAY);
-            continue;
-          } else {
-            break;
-          }
-        }
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+I2cIoBmcSsifAsyncSubmitCommand (
+  IN     NVIDIA_IPMI_ASYNC_TRANSPORT_PROTOCOL  *This,
+  IN OUT NVIDIA_IPMI_ASYNC_TOKEN               *Token OPTIONAL,
+  IN     UINT8                                 NetFunction,
+  IN     UINT8                                 Lun,
+  IN     UINT8                                 Command,
+  IN     UINT8                                 *RequestData,
+  IN     UINT32                                RequestDataSize,
+  OUT    UINT8                                 *ResponseData,
+  IN OUT UINT32                                *ResponseDataSize
+  )
+{
+  EFI_STATUS             Status;
+  BMC_SSIF_PRIVATE_DATA  *Private;
+  SSIF_REQUEST           *Request;
+  EFI_TPL                OldTpl;
 
-        // Sanity check size
-        if (ReadData[0] < SSIF_HEADER_SIZE) {
-          BmcSsifPrivate->SoftErrorCount++;
-          BmcSsifPrivate->BmcStatus = BMC_SOFTFAIL;
-          DEBUG ((DEBUG_ERROR, "%a: Read size less then expected 0x%x\r\n", __FUNCTION__, ReadData[0]));
-          return EFI_NOT_FOUND;
-        }
+  Private = BMC_SSIF_PRIVATE_DATA_FROM_ASYNC (This);
+  if (Token == NULL) {
+    return I2cIoBmcSsifSubmitSync (Private, NetFunction, Lun, Command, RequestData, RequestDataSize, ResponseData, ResponseDataSize);
+  }
 
-        if ((ReadData[1] == 0x00) && (ReadData[2] == 0x01)) {
-          // Multi-part read
-          if (ReadData[0] < (SSIF_HEADER_SIZE + 2)) {
-            BmcSsifPrivate->SoftErrorCount++;
-            DEBUG ((DEBUG_ERROR, "%a: Read size less then expected 0x%x\r\n", __FUNCTION__, ReadData[0]));
-            return EFI_NOT_FOUND;
-          }
-
-          if (((ReadData[3] >> 2) != (NetFunction + 1)) ||
-              (ReadData[4] != Command))
-          {
-            BmcSsifPrivate->SoftErrorCount++;
-            DEBUG ((DEBUG_ERROR, "%a: Unexpected NetFn:Command! Expected: %x:%x. Got: %x:%x\r\n", __FUNCTION__, NetFunction, Command, ReadData[3]>>2, ReadData[4]));
-            return EFI_NOT_FOUND;
-          }
-
-          if (ResponseDataBufferSize < (ReadData[0] - SSIF_HEADER_SIZE - 2)) {
-            BmcSsifPrivate->SoftErrorCount++;
-            DEBUG ((DEBUG_ERROR, "%a: Read size returned is larger than buffer\r\n", __FUNCTION__));
-            return EFI_OUT_OF_RESOURCES;
-          }
-
-          *ResponseDataSize = ReadData[0] - SSIF_HEADER_SIZE - 2;
-          CopyMem (ResponseData, &ReadData[SSIF_HEADER_SIZE + 2 + 1], *ResponseDataSize);
-
-          // Need to get the rest of the data
-          ExpectedBlock = 0;
-          do {
-            WriteData[0]                      = BMC_SSIF_MULTI_PART_READ_CMD_MIDDLE_END;
-            Packet.OperationCount             = 2;
-            Packet.Operation[0].Flags         = I2C_FLAG_SMBUS_OPERATION | I2C_FLAG_SMBUS_BLOCK | I2C_FLAG_SMBUS_PEC;
-            Packet.Operation[0].LengthInBytes = 1;
-            Packet.Operation[0].Buffer        = WriteData;
-            Packet.Operation[1].Flags         = I2C_FLAG_READ;
-            Packet.Operation[1].LengthInBytes = SSIF_MAX_DATA + SMBUS_READ_HEADER_SIZE;
-            Packet.Operation[1].Buffer        = ReadData;
-
-            Status = BmcSsifPrivate->I2cMaster->StartRequest (BmcSsifPrivate->I2cMaster, BmcSsifPrivate->SlaveAddress, (EFI_I2C_REQUEST_PACKET *)&Packet, NULL, NULL);
-            if (EFI_ERROR (Status)) {
-              BmcSsifPrivate->SoftErrorCount++;
-              DEBUG ((DEBUG_ERROR, "%a: Failed to send multi part read middle/end - %r\r\n", __FUNCTION__, Status));
-              return Status;
-            }
-
-            if (ReadData[0] < 2) {
-              BmcSsifPrivate->SoftErrorCount++;
-              DEBUG ((DEBUG_ERROR, "%a: Read size less then expected 0x%x\r\n", __FUNCTION__, ReadData[0]));
-              return EFI_NOT_FOUND;
-            }
-
-            if ((ReadData[1] == ExpectedBlock) || (ReadData[1] == 0xFF)) {
-              if (ResponseDataBufferSize < (*ResponseDataSize + (ReadData[0] - 1))) {
-                BmcSsifPrivate->SoftErrorCount++;
-                DEBUG ((DEBUG_ERROR, "%a: Read size returned is larger than buffer\r\n", __FUNCTION__));
-                return EFI_OUT_OF_RESOURCES;
-              }
-
-              CopyMem (ResponseData + *ResponseDataSize, &ReadData[2], ReadData[0]-1);
-              *ResponseDataSize += (ReadData[0] - 1);
-              if (ReadData[1] == 0xFF) {
-                ExpectedBlock = 0xFF;
-              } else {
-                ExpectedBlock++;
-              }
-            } else {
-              // Out of order block, request retry
-              WriteData[0]                      = BMC_SSIF_MULTI_PART_READ_CMD_MIDDLE_RETRY;
-              WriteData[1]                      = 1;
-              WriteData[2]                      = ExpectedBlock;
-              Packet.OperationCount             = 1;
-              Packet.Operation[0].Flags         = I2C_FLAG_SMBUS_OPERATION | I2C_FLAG_SMBUS_BLOCK | I2C_FLAG_SMBUS_PEC;
-              Packet.Operation[0].LengthInBytes = 3;
-              Packet.Operation[0].Buffer        = WriteData;
-
-              Status = BmcSsifPrivate->I2cMaster->StartRequest (BmcSsifPrivate->I2cMaster, BmcSsifPrivate->SlaveAddress, (EFI_I2C_REQUEST_PACKET *)&Packet, NULL, NULL);
-              if (EFI_ERROR (Status)) {
-                BmcSsifPrivate->SoftErrorCount++;
-                DEBUG ((DEBUG_ERROR, "%a: Failed to send multi part read retry - %r\r\n", __FUNCTION__, Status));
-                return Status;
-              }
-            }
-          } while (ExpectedBlock != 0xFF);
-        } else {
-          // Check netfn and command
-          if (((ReadData[1] >> 2) != (NetFunction + 1)) ||
-              (ReadData[2] != Command))
-          {
-            BmcSsifPrivate->SoftErrorCount++;
-            DEBUG ((DEBUG_ERROR, "%a: Unexpected NetFn:Command! Expected: %x:%x. Got: %x:%x\r\n", __FUNCTION__, NetFunction+1, Command, ReadData[1]>>2, ReadData[2]));
-            return EFI_NOT_FOUND;
-          }
-
-          if (ResponseDataBufferSize < (ReadData[0] - SSIF_HEADER_SIZE)) {
-            DEBUG ((DEBUG_ERROR, "%a: Read size returned is larger than buffer\r\n", __FUNCTION__));
-            return EFI_OUT_OF_RESOURCES;
-          }
-
-          *ResponseDataSize = ReadData[0] - SSIF_HEADER_SIZE;
-          CopyMem (ResponseData, &ReadData[SSIF_HEADER_SIZE + 1], *ResponseDataSize);
-        }
+  if (Token->Event == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
 
-        break;
-      }
+  Request = AllocatePool (sizeof (SSIF_REQUEST));
+  if (Request == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
 
-      if (Status == EFI_NO_RESPONSE) {
-        continue;
-      }
-    }
+  SsifRequestInit (Request, NetFunction, Lun, Command, RequestData, RequestDataSize, ResponseData, ResponseDataSize, Token);
+  Token->TransactionStatus = EFI_NOT_READY;
 
-    break;
+  OldTpl = gBS->RaiseTPL (MAX (EfiGetCurrentTpl (), TPL_CALLBACK));
+  Status = SsifTransportQueue (&Private->Transport, Request);
+  if (EFI_ERROR (Status)) {
+    FreePool (Request);
+  } else {
+    // Start the write now, the poll timer collects the response
+    I2cIoBmcSsifProcess (Private);
+    I2cIoBmcSsifUpdatePollTimer (Private);
   }
 
+  gBS->RestoreTPL (OldTpl);
+
   return Status;
 }
 
@@ -409,9 +379,9 @@ I2cIoBmcSsifGetBmcStatus (
 
   BmcSsifPrivate = BMC_SSIF_PRIVATE_DATA_FROM_IPMI (This);
 
-  if ((BmcSsifPrivate->BmcStatus == BMC_OK) && (BmcSsifPrivate->SoftErrorCount >= MAX_SOFT_COUNT)) {
+  if ((BmcSsifPrivate->BmcStatus == BMC_OK) && (BmcSsifPrivate->Transport.SoftErrorCount >= MAX_SOFT_COUNT)) {
     BmcSsifPrivate->BmcStatus = BMC_HARDFAIL;
-  } else if (BmcSsifPrivate->SoftErrorCount != 0) {
+  } else if (BmcSsifPrivate->Transport.SoftErrorCount != 0) {
     BmcSsifPrivate->BmcStatus = BMC_SOFTFAIL;
   }
 
@@ -453,6 +423,8 @@ I2cIoBmcMasterNotify (
   CONST VOID                        *Property;
   INT32                             PropertyLen;
   CONST UINT32                      *GpioProperty;
+  UINT8                             InterfaceType;
+  UINT8                             Capabilities[SSIF_CAPABILITIES_RESPONSE_SIZE];
 
   I2cMasterProtocol = NULL;
   BmcSsifPrivate    = (BMC_SSIF_PRIVATE_DATA *)Context;
@@ -501,6 +473,7 @@ I2cIoBmcMasterNotify (
   BmcSsifPrivate->I2cMaster                       = I2cMasterProtocol;
   BmcSsifPrivate->IpmiTransport.IpmiSubmitCommand = I2cIoBmcSsifIpmiSubmitCommand;
   BmcSsifPrivate->IpmiTransport.GetBmcStatus      = I2cIoBmcSsifGetBmcStatus;
+  BmcSsifPrivate->AsyncTransport.SubmitCommand    = I2cIoBmcSsifAsyncSubmitCommand;
 
   gBS->CloseEvent (Event);
 
@@ -528,10 +501,35 @@ I2cIoBmcMasterNotify (
     }
   }
 
+  SsifTransportInit (&BmcSsifPrivate->Transport, I2cMasterProtocol, BmcSsifPrivate->SlaveAddress, BmcSsifPrivate->SmbAlertSupported);
+
+  // Size multi-part transactions to what the BMC supports
+  InterfaceType = SSIF_SYSTEM_INTERFACE_TYPE;
+  ResultSize    = sizeof (Capabilities);
+  Status        = I2cIoBmcSsifSubmitSync (
+                    BmcSsifPrivate,
+                    IPMI_NETFN_APP,
+                    0,
+                    SSIF_GET_SYSTEM_INTERFACE_CAPABILITIES,
+                    &InterfaceType,
+                    sizeof (InterfaceType),
+                    Capabilities,
+                    &ResultSize
+                    );
+  if (!EFI_ERROR (Status)) {
+    Status = SsifTransportSetCapabilities (&BmcSsifPrivate->Transport, Capabilities, ResultSize);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "%a: Failed to get SSIF capabilities, using defaults - %r\r\n", __FUNCTION__, Status));
+  }
+
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &Handle,
                   &gIpmiTransportProtocolGuid,
                   &BmcSsifPrivate->IpmiTransport,
+                  &gNVIDIAIpmiAsyncTransportProtocolGuid,
+                  &BmcSsifPrivate->AsyncTransport,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
@@ -599,6 +597,19 @@ I2cIoBmcSsifDxeDriverEntryPoint (
     return Status;
   }
 
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  I2cIoBmcSsifPollNotify,
+                  BmcSsifPrivate,
+                  &BmcSsifPrivate->PollEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to create poll event - %r\r\n", __FUNCTION__, Status));
+    FreePool (BmcSsifPrivate);
+    return Status;
+  }
+
   BmcSsifPrivate->ProtocolEvent = EfiCreateProtocolNotifyEvent (
                                     &gEfiI2cMasterProtocolGuid,
                                     TPL_CALLBACK,
@@ -607,6 +618,7 @@ I2cIoBmcSsifDxeDriverEntryPoint (
                                     &BmcSsifPrivate->ProtocolRegistration
                                     );
   if (BmcSsifPrivate->ProtocolEvent == NULL) {
+    gBS->CloseEvent (BmcSsifPrivate->PollEvent);
     FreePool (BmcSsifPrivate);
     return EFI_OUT_OF_RESOURCES;
   }
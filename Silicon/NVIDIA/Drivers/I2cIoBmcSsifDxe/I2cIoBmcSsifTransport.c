@@ -0,0 +1,548 @@
+/** @file
+
+  I2C IO IPMI driver SSIF transport
+
+  Copyright (c) 2019-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright 1999 - 2021 Intel Corporation. <BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+#include "I2cIoBmcSsifTransport.h"
+
+typedef struct {
+  ///
+  /// Number of elements in the operation array
+  ///
+  UINTN                OperationCount;
+
+  ///
+  /// Description of the I2C operation
+  ///
+  EFI_I2C_OPERATION    Operation[2];
+} SSIF_REQUEST_PACKET;
+
+/**
+  Send an SMBus block write, optionally followed by a block read, to the BMC.
+
+  @param[in]  Transport     SSIF transport
+  @param[in]  WriteData     SMBus command and block data to write
+  @param[in]  WriteLength   Size of WriteData
+  @param[out] ReadData      Buffer for the block read, NULL to only write
+
+  @retval EFI_SUCCESS   Transfer completed
+  @retval Others        Error returned by the I2C master
+
+**/
+STATIC
+EFI_STATUS
+SsifTransportTransfer (
+  IN  SSIF_TRANSPORT  *Transport,
+  IN  UINT8           *WriteData,
+  IN  UINT32          WriteLength,
+  OUT UINT8           *ReadData OPTIONAL
+  )
+{
+  SSIF_REQUEST_PACKET  Packet;
+
+  Packet.OperationCount             = 1;
+  Packet.Operation[0].Flags         = I2C_FLAG_SMBUS_OPERATION | I2C_FLAG_SMBUS_BLOCK | Transport->PecFlag;
+  Packet.Operation[0].LengthInBytes = WriteLength;
+  Packet.Operation[0].Buffer        = WriteData;
+  if (ReadData != NULL) {
+    Packet.OperationCount             = 2;
+    Packet.Operation[1].Flags         = I2C_FLAG_READ;
+    Packet.Operation[1].LengthInBytes = SSIF_MAX_DATA + SMBUS_READ_HEADER_SIZE;
+    Packet.Operation[1].Buffer        = ReadData;
+  }
+
+  return Transport->I2cMaster->StartRequest (Transport->I2cMaster, Transport->SlaveAddress, (EFI_I2C_REQUEST_PACKET *)&Packet, NULL, NULL);
+}
+
+/**
+  Write a request to the BMC, as a single-part or multi-part write.
+
+  @param[in]  Transport   SSIF transport
+  @param[in]  Request     SSIF request
+
+  @retval EFI_SUCCESS   Request written
+  @retval Others        Error returned by the I2C master
+
+**/
+STATIC
+EFI_STATUS
+SsifTransportWrite (
+  IN SSIF_TRANSPORT  *Transport,
+  IN SSIF_REQUEST    *Request
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       WriteData[SSIF_MAX_DATA + SMBUS_WRITE_HEADER_SIZE];
+  UINT32      DataLeft;
+  UINT32      DataSize;
+
+  if ((Request->RequestDataSize + SSIF_HEADER_SIZE) <= SSIF_MAX_DATA) {
+    // SinglePart
+    WriteData[0]                           = BMC_SSIF_SINGLE_PART_WRITE_CMD;
+    WriteData[1]                           = Request->RequestDataSize + SSIF_HEADER_SIZE;
+    WriteData[SMBUS_WRITE_HEADER_SIZE + 0] = Request->NetFunction << 2 | (Request->Lun & 0x3);
+    WriteData[SMBUS_WRITE_HEADER_SIZE + 1] = Request->Command;
+    CopyMem (WriteData + SMBUS_WRITE_HEADER_SIZE + SSIF_HEADER_SIZE, Request->RequestData, Request->RequestDataSize);
+
+    Status = SsifTransportTransfer (Transport, WriteData, Request->RequestDataSize + SSIF_HEADER_SIZE + SMBUS_WRITE_HEADER_SIZE, NULL);
+    if (EFI_ERROR (Status)) {
+      Transport->SoftErrorCount++;
+      DEBUG ((DEBUG_ERROR, "%a: Failed to send single part write - %r\r\n", __FUNCTION__, Status));
+    }
+
+    return Status;
+  }
+
+  // Multi-part
+  WriteData[0]                           = BMC_SSIF_MULTI_PART_WRITE_CMD_START;
+  WriteData[1]                           = SSIF_MAX_DATA;
+  WriteData[SMBUS_WRITE_HEADER_SIZE + 0] = Request->NetFunction << 2 | (Request->Lun & 0x3);
+  WriteData[SMBUS_WRITE_HEADER_SIZE + 1] = Request->Command;
+  CopyMem (WriteData + SMBUS_WRITE_HEADER_SIZE + SSIF_HEADER_SIZE, Request->RequestData, SSIF_MAX_DATA - SSIF_HEADER_SIZE);
+
+  Status = SsifTransportTransfer (Transport, WriteData, SSIF_MAX_DATA + SMBUS_WRITE_HEADER_SIZE, NULL);
+  if (EFI_ERROR (Status)) {
+    Transport->SoftErrorCount++;
+    DEBUG ((DEBUG_ERROR, "%a: Failed to send multi part write start - %r\r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  DataLeft = Request->RequestDataSize - (SSIF_MAX_DATA - SSIF_HEADER_SIZE);
+  while (DataLeft != 0) {
+    if (DataLeft <= SSIF_MAX_DATA) {
+      WriteData[0] = BMC_SSIF_MULTI_PART_WRITE_CMD_END;
+      DataSize     = DataLeft;
+    } else {
+      WriteData[0] = BMC_SSIF_MULTI_PART_WRITE_CMD_MIDDLE;
+      DataSize     = SSIF_MAX_DATA;
+    }
+
+    WriteData[1] = DataSize;
+    CopyMem (WriteData + SMBUS_WRITE_HEADER_SIZE, Request->RequestData + (Request->RequestDataSize - DataLeft), DataSize);
+
+    Status = SsifTransportTransfer (Transport, WriteData, DataSize + SMBUS_WRITE_HEADER_SIZE, NULL);
+    if (EFI_ERROR (Status)) {
+      Transport->SoftErrorCount++;
+      DEBUG ((DEBUG_ERROR, "%a: Failed to send multi part write continue/end - %r\r\n", __FUNCTION__, Status));
+      return Status;
+    }
+
+    DataLeft -= DataSize;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Read the rest of a multi-part response from the BMC.
+
+  @param[in]  Transport   SSIF transport
+  @param[in]  Request     SSIF request, first part already in its response
+
+  @retval EFI_SUCCESS           Response read
+  @retval EFI_NOT_FOUND         Malformed response
+  @retval EFI_OUT_OF_RESOURCES  Response is larger than the response buffer
+  @retval Others                Error returned by the I2C master
+
+**/
+STATIC
+EFI_STATUS
+SsifTransportReadMultiPart (
+  IN SSIF_TRANSPORT  *Transport,
+  IN SSIF_REQUEST    *Request
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       WriteData[SSIF_MAX_DATA + SMBUS_WRITE_HEADER_SIZE];
+  UINT8       ReadData[SSIF_MAX_DATA + SMBUS_READ_HEADER_SIZE];
+  UINT8       ExpectedBlock;
+
+  ExpectedBlock = 0;
+  do {
+    WriteData[0] = BMC_SSIF_MULTI_PART_READ_CMD_MIDDLE_END;
+    Status       = SsifTransportTransfer (Transport, WriteData, 1, ReadData);
+    if (EFI_ERROR (Status)) {
+      Transport->SoftErrorCount++;
+      DEBUG ((DEBUG_ERROR, "%a: Failed to send multi part read middle/end - %r\r\n", __FUNCTION__, Status));
+      return Status;
+    }
+
+    if (ReadData[0] < 2) {
+      Transport->SoftErrorCount++;
+      DEBUG ((DEBUG_ERROR, "%a: Read size less then expected 0x%x\r\n", __FUNCTION__, ReadData[0]));
+      return EFI_NOT_FOUND;
+    }
+
+    if ((ReadData[1] == ExpectedBlock) || (ReadData[1] == 0xFF)) {
+      if (Request->ResponseBufferSize < (*Request->ResponseDataSize + (ReadData[0] - 1))) {
+        Transport->SoftErrorCount++;
+        DEBUG ((DEBUG_ERROR, "%a: Read size returned is larger than buffer\r\n", __FUNCTION__));
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      CopyMem (Request->ResponseData + *Request->ResponseDataSize, &ReadData[2], ReadData[0]-1);
+      *Request->ResponseDataSize += (ReadData[0] - 1);
+      if (ReadData[1] == 0xFF) {
+        ExpectedBlock = 0xFF;
+      } else {
+        ExpectedBlock++;
+      }
+    } else {
+      // Out of order block, request retry
+      WriteData[0] = BMC_SSIF_MULTI_PART_READ_CMD_MIDDLE_RETRY;
+      WriteData[1] = 1;
+      WriteData[2] = ExpectedBlock;
+      Status       = SsifTransportTransfer (Transport, WriteData, 3, NULL);
+      if (EFI_ERROR (Status)) {
+        Transport->SoftErrorCount++;
+        DEBUG ((DEBUG_ERROR, "%a: Failed to send multi part read retry - %r\r\n", __FUNCTION__, Status));
+        return Status;
+      }
+    }
+  } while (ExpectedBlock != 0xFF);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Read the response to a request from the BMC.
+
+  @param[in]  Transport   SSIF transport
+  @param[in]  Request     SSIF request
+
+  @retval EFI_SUCCESS           Response read
+  @retval EFI_NO_RESPONSE       BMC has no response ready yet
+  @retval EFI_NOT_FOUND         Malformed or unexpected response
+  @retval EFI_OUT_OF_RESOURCES  Response is larger than the response buffer
+  @retval Others                Error returned by the I2C master
+
+**/
+STATIC
+EFI_STATUS
+SsifTransportRead (
+  IN SSIF_TRANSPORT  *Transport,
+  IN SSIF_REQUEST    *Request
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       WriteData[1];
+  UINT8       ReadData[SSIF_MAX_DATA + SMBUS_READ_HEADER_SIZE];
+
+  WriteData[0] = BMC_SSIF_SINGLE_PART_READ_CMD;
+  Status       = SsifTransportTransfer (Transport, WriteData, 1, ReadData);
+  if (EFI_ERROR (Status)) {
+    Transport->SoftErrorCount++;
+    DEBUG ((DEBUG_ERROR, "%a: Failed to send read command - %r\r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  // Sanity check size
+  if (ReadData[0] < SSIF_HEADER_SIZE) {
+    Transport->SoftErrorCount++;
+    DEBUG ((DEBUG_ERROR, "%a: Read size less then expected 0x%x\r\n", __FUNCTION__, ReadData[0]));
+    return EFI_NOT_FOUND;
+  }
+
+  if ((ReadData[1] == 0x00) && (ReadData[2] == 0x01)) {
+    // Multi-part read
+    if (ReadData[0] < (SSIF_HEADER_SIZE + 2)) {
+      Transport->SoftErrorCount++;
+      DEBUG ((DEBUG_ERROR, "%a: Read size less then expected 0x%x\r\n", __FUNCTION__, ReadData[0]));
+      return EFI_NOT_FOUND;
+    }
+
+    if (((ReadData[3] >> 2) != (Request->NetFunction + 1)) ||
+        (ReadData[4] != Request->Command))
+    {
+      Transport->SoftErrorCount++;
+      DEBUG ((DEBUG_ERROR, "%a: Unexpected NetFn:Command! Expected: %x:%x. Got: %x:%x\r\n", __FUNCTION__, Request->NetFunction, Request->Command, ReadData[3]>>2, ReadData[4]));
+      return EFI_NOT_FOUND;
+    }
+
+    if (Request->ResponseBufferSize < (ReadData[0] - SSIF_HEADER_SIZE - 2)) {
+      Transport->SoftErrorCount++;
+      DEBUG ((DEBUG_ERROR, "%a: Read size returned is larger than buffer\r\n", __FUNCTION__));
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    *Request->ResponseDataSize = ReadData[0] - SSIF_HEADER_SIZE - 2;
+    CopyMem (Request->ResponseData, &ReadData[SSIF_HEADER_SIZE + 2 + 1], *Request->ResponseDataSize);
+
+    // Need to get the rest of the data
+    return SsifTransportReadMultiPart (Transport, Request);
+  }
+
+  // Check netfn and command
+  if (((ReadData[1] >> 2) != (Request->NetFunction + 1)) ||
+      (ReadData[2] != Request->Command))
+  {
+    Transport->SoftErrorCount++;
+    DEBUG ((DEBUG_ERROR, "%a: Unexpected NetFn:Command! Expected: %x:%x. Got: %x:%x\r\n", __FUNCTION__, Request->NetFunction+1, Request->Command, ReadData[1]>>2, ReadData[2]));
+    return EFI_NOT_FOUND;
+  }
+
+  if (Request->ResponseBufferSize < (ReadData[0] - SSIF_HEADER_SIZE)) {
+    DEBUG ((DEBUG_ERROR, "%a: Read size returned is larger than buffer\r\n", __FUNCTION__));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  *Request->ResponseDataSize = ReadData[0] - SSIF_HEADER_SIZE;
+  CopyMem (Request->ResponseData, &ReadData[SSIF_HEADER_SIZE + 1], *Request->ResponseDataSize);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Complete a request.
+
+  @param[in]  Request   SSIF request
+  @param[in]  Status    Completion status
+
+**/
+STATIC
+VOID
+SsifTransportComplete (
+  IN SSIF_REQUEST  *Request,
+  IN EFI_STATUS    Status
+  )
+{
+  Request->Status = Status;
+  Request->State  = SsifRequestComplete;
+}
+
+/**
+  Write a request to the BMC and start waiting for its response.
+
+  @param[in]  Transport   SSIF transport
+  @param[in]  Request     SSIF request
+  @param[in]  Now         Current time in microseconds
+
+**/
+STATIC
+VOID
+SsifTransportStart (
+  IN SSIF_TRANSPORT  *Transport,
+  IN SSIF_REQUEST    *Request,
+  IN UINT64          Now
+  )
+{
+  EFI_STATUS  Status;
+
+  Request->WriteCount++;
+  Status = SsifTransportWrite (Transport, Request);
+  if (EFI_ERROR (Status) || (Request->ResponseData == NULL)) {
+    SsifTransportComplete (Request, Status);
+    return;
+  }
+
+  Request->State     = SsifRequestWaitResponse;
+  Request->StateTime = Now;
+  Request->ReadCount = 0;
+}
+
+/**
+  Read the response of a request once the BMC may have it ready.
+
+  @param[in]  Transport       SSIF transport
+  @param[in]  Request         SSIF request waiting for its response
+  @param[in]  Now             Current time in microseconds
+  @param[in]  AlertAsserted   SMBALERT# is asserted
+
+**/
+STATIC
+VOID
+SsifTransportCheckResponse (
+  IN SSIF_TRANSPORT  *Transport,
+  IN SSIF_REQUEST    *Request,
+  IN UINT64          Now,
+  IN BOOLEAN         AlertAsserted
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      Elapsed;
+
+  Elapsed = Now - Request->StateTime;
+  if (Transport->SmbAlertSupported) {
+    if (!AlertAsserted) {
+      if (Elapsed < BMC_SMBALERT_TIMEOUT) {
+        return;
+      }
+
+      DEBUG ((DEBUG_ERROR, "%a: Timeout reading SMBALERT gpio\r\n", __FUNCTION__));
+    } else {
+      DEBUG ((DEBUG_INFO, "%a: SMBALERT gpio Time %dus\r\n", __FUNCTION__, Elapsed));
+    }
+  } else if (Elapsed < BMC_RETRY_DELAY) {
+    return;
+  }
+
+  Status = SsifTransportRead (Transport, Request);
+  if (Status == EFI_NO_RESPONSE) {
+    Request->ReadCount++;
+    if (!Transport->SmbAlertSupported && (Request->ReadCount < BMC_RETRY_COUNT)) {
+      Request->StateTime = Now;
+      return;
+    }
+
+    if (Request->WriteCount < BMC_RETRY_COUNT) {
+      SsifTransportStart (Transport, Request, Now);
+      return;
+    }
+  }
+
+  SsifTransportComplete (Request, Status);
+}
+
+VOID
+SsifTransportInit (
+  OUT SSIF_TRANSPORT           *Transport,
+  IN  EFI_I2C_MASTER_PROTOCOL  *I2cMaster,
+  IN  UINTN                    SlaveAddress,
+  IN  BOOLEAN                  SmbAlertSupported
+  )
+{
+  ZeroMem (Transport, sizeof (*Transport));
+  Transport->I2cMaster          = I2cMaster;
+  Transport->SlaveAddress       = SlaveAddress;
+  Transport->SmbAlertSupported  = SmbAlertSupported;
+  Transport->TransactionSupport = SSIF_TRANSACTION_MIDDLE;
+  Transport->InputMessageSize   = SSIF_MAX_MESSAGE_SIZE;
+  Transport->OutputMessageSize  = SSIF_MAX_MESSAGE_SIZE;
+  Transport->PecFlag            = I2C_FLAG_SMBUS_PEC;
+  InitializeListHead (&Transport->Queue);
+}
+
+EFI_STATUS
+SsifTransportSetCapabilities (
+  IN OUT SSIF_TRANSPORT  *Transport,
+  IN     CONST UINT8     *Response,
+  IN     UINT32          ResponseSize
+  )
+{
+  // Completion code, reserved/version, transaction support, input size, output size
+  if ((ResponseSize < SSIF_CAPABILITIES_RESPONSE_SIZE) || (Response[0] != 0) || (Response[3] < SSIF_MAX_DATA)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Transport->TransactionSupport = Response[2] & SSIF_TRANSACTION_SUPPORT_MASK;
+  Transport->PecFlag            = ((Response[2] & SSIF_PEC_SUPPORT) != 0) ? I2C_FLAG_SMBUS_PEC : 0;
+  Transport->InputMessageSize   = Response[3];
+  Transport->OutputMessageSize  = Response[4];
+
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: transactions 0x%x, PEC %u, input %u, output %u\r\n",
+    __FUNCTION__,
+    Transport->TransactionSupport,
+    Transport->PecFlag != 0,
+    Transport->InputMessageSize,
+    Transport->OutputMessageSize
+    ));
+
+  return EFI_SUCCESS;
+}
+
+VOID
+SsifRequestInit (
+  OUT    SSIF_REQUEST  *Request,
+  IN     UINT8         NetFunction,
+  IN     UINT8         Lun,
+  IN     UINT8         Command,
+  IN     UINT8         *RequestData,
+  IN     UINT32        RequestDataSize,
+  OUT    UINT8         *ResponseData,
+  IN OUT UINT32        *ResponseDataSize,
+  IN     VOID          *Context
+  )
+{
+  ZeroMem (Request, sizeof (*Request));
+  Request->NetFunction        = NetFunction;
+  Request->Lun                = Lun;
+  Request->Command            = Command;
+  Request->RequestData        = RequestData;
+  Request->RequestDataSize    = RequestDataSize;
+  Request->ResponseData       = ResponseData;
+  Request->ResponseDataSize   = ResponseDataSize;
+  Request->ResponseBufferSize = (ResponseDataSize != NULL) ? *ResponseDataSize : 0;
+  Request->Context            = Context;
+  Request->State              = SsifRequestQueued;
+  Request->Status             = EFI_NOT_READY;
+}
+
+EFI_STATUS
+SsifTransportQueue (
+  IN OUT SSIF_TRANSPORT  *Transport,
+  IN     SSIF_REQUEST    *Request
+  )
+{
+  UINT32  MessageSize;
+
+  MessageSize = Request->RequestDataSize + SSIF_HEADER_SIZE;
+  if ((MessageSize > Transport->InputMessageSize) ||
+      ((MessageSize > SSIF_MAX_DATA) && (Transport->TransactionSupport == SSIF_TRANSACTION_SINGLE_PART)) ||
+      ((MessageSize > 2 * SSIF_MAX_DATA) && (Transport->TransactionSupport == SSIF_TRANSACTION_START_END)))
+  {
+    DEBUG ((DEBUG_ERROR, "%a: %u byte request not supported by BMC\r\n", __FUNCTION__, MessageSize));
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  if ((Request->ResponseData != NULL) && (Request->ResponseDataSize == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Request->State  = SsifRequestQueued;
+  Request->Status = EFI_NOT_READY;
+  InsertTailList (&Transport->Queue, &Request->Link);
+
+  return EFI_SUCCESS;
+}
+
+SSIF_REQUEST *
+SsifTransportPoll (
+  IN OUT SSIF_TRANSPORT  *Transport,
+  IN     UINT64          Now,
+  IN     BOOLEAN         AlertAsserted
+  )
+{
+  SSIF_REQUEST  *Request;
+
+  Request = Transport->Active;
+  if (Request == NULL) {
+    if (IsListEmpty (&Transport->Queue)) {
+      return NULL;
+    }
+
+    Request = BASE_CR (GetFirstNode (&Transport->Queue), SSIF_REQUEST, Link);
+    RemoveEntryList (&Request->Link);
+    Transport->Active   = Request;
+    Request->WriteCount = 0;
+    SsifTransportStart (Transport, Request, Now);
+  } else {
+    SsifTransportCheckResponse (Transport, Request, Now, AlertAsserted);
+  }
+
+  if (Request->State != SsifRequestComplete) {
+    return NULL;
+  }
+
+  Transport->Active = NULL;
+  return Request;
+}
+
+BOOLEAN
+SsifTransportIdle (
+  IN SSIF_TRANSPORT  *Transport
+  )
+{
+  return (Transport->Active == NULL) && IsListEmpty (&Transport->Queue);
+}
@@ -0,0 +1,214 @@
+/** @file
+
+  I2C IO IPMI driver SSIF transport
+
+  Copyright (c) 2019-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright 1999 - 2021 Intel Corporation. <BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __I2C_IO_BMC_SSIF_TRANSPORT_H__
+#define __I2C_IO_BMC_SSIF_TRANSPORT_H__
+
+#include <Uefi.h>
+#include <Protocol/I2cMaster.h>
+
+#define BMC_RETRY_COUNT       10
+#define BMC_RETRY_DELAY       100000
+#define BMC_SMBALERT_TIMEOUT  500000
+
+#define BMC_SSIF_SINGLE_PART_WRITE_CMD        0x2
+#define BMC_SSIF_SINGLE_PART_READ_CMD         0x3
+#define BMC_SSIF_MULTI_PART_WRITE_CMD_START   0x6
+#define BMC_SSIF_MULTI_PART_WRITE_CMD_MIDDLE  0x7
+#define BMC_SSIF_MULTI_PART_WRITE_CMD_END     0x8
+// Arm Server Base Manageability Requirements 1.1
+#define BMC_SSIF_MULTI_PART_READ_CMD_MIDDLE_END    0x9
+#define BMC_SSIF_MULTI_PART_READ_CMD_MIDDLE_RETRY  0xA
+
+#define SSIF_MAX_DATA            0x20
+#define SSIF_HEADER_SIZE         2
+#define SMBUS_WRITE_HEADER_SIZE  2
+#define SMBUS_READ_HEADER_SIZE   1
+
+// Get System Interface Capabilities, IPMI 2.0 section 22.9
+#define SSIF_GET_SYSTEM_INTERFACE_CAPABILITIES  0x57
+#define SSIF_SYSTEM_INTERFACE_TYPE              0x00
+#define SSIF_CAPABILITIES_RESPONSE_SIZE         5
+#define SSIF_TRANSACTION_SUPPORT_MASK           0xC0
+#define SSIF_TRANSACTION_SINGLE_PART            0x00
+#define SSIF_TRANSACTION_START_END              0x40
+#define SSIF_TRANSACTION_MIDDLE                 0x80
+#define SSIF_PEC_SUPPORT                        BIT3
+#define SSIF_MAX_MESSAGE_SIZE                   0xFF
+
+typedef enum {
+  SsifRequestQueued,
+  SsifRequestWaitResponse,
+  SsifRequestComplete
+} SSIF_REQUEST_STATE;
+
+typedef struct {
+  LIST_ENTRY            Link;
+
+  UINT8                 NetFunction;
+  UINT8                 Lun;
+  UINT8                 Command;
+  UINT8                 *RequestData;
+  UINT32                RequestDataSize;
+  UINT8                 *ResponseData;
+  UINT32                *ResponseDataSize;
+  UINT32                ResponseBufferSize;
+
+  // Caller context, e.g. the token to signal on completion
+  VOID                  *Context;
+
+  SSIF_REQUEST_STATE    State;
+  EFI_STATUS            Status;
+  UINT64                StateTime;
+  UINT32                WriteCount;
+  UINT32                ReadCount;
+} SSIF_REQUEST;
+
+typedef struct {
+  EFI_I2C_MASTER_PROTOCOL    *I2cMaster;
+  UINTN                      SlaveAddress;
+  BOOLEAN                    SmbAlertSupported;
+
+  // From Get System Interface Capabilities
+  UINT8                      TransactionSupport;
+  UINT32                     InputMessageSize;
+  UINT32                     OutputMessageSize;
+  UINT32                     PecFlag;
+
+  LIST_ENTRY                 Queue;
+  SSIF_REQUEST               *Active;
+
+  UINT32                     SoftErrorCount;
+} SSIF_TRANSPORT;
+
+/**
+  Initialize an SSIF transport.
+
+  Until SsifTransportSetCapabilities is called the transport assumes the BMC
+  supports multi-part transactions with middle parts, maximum size messages
+  and PEC, which is how the transport has always talked to the BMC.
+
+  @param[out] Transport           SSIF transport
+  @param[in]  I2cMaster           I2C master the BMC is attached to
+  @param[in]  SlaveAddress        I2C address of the BMC
+  @param[in]  SmbAlertSupported   BMC signals SMBALERT# when a response is ready
+
+**/
+VOID
+SsifTransportInit (
+  OUT SSIF_TRANSPORT           *Transport,
+  IN  EFI_I2C_MASTER_PROTOCOL  *I2cMaster,
+  IN  UINTN                    SlaveAddress,
+  IN  BOOLEAN                  SmbAlertSupported
+  );
+
+/**
+  Apply the response of Get System Interface Capabilities for SSIF.
+
+  @param[in, out] Transport     SSIF transport
+  @param[in]      Response      Response data, starting with the completion code
+  @param[in]      ResponseSize  Size of Response
+
+  @retval EFI_SUCCESS       Capabilities applied
+  @retval EFI_UNSUPPORTED   Response is not valid, defaults kept
+
+**/
+EFI_STATUS
+SsifTransportSetCapabilities (
+  IN OUT SSIF_TRANSPORT  *Transport,
+  IN     CONST UINT8     *Response,
+  IN     UINT32          ResponseSize
+  );
+
+/**
+  Initialize an SSIF request.
+
+  @param[out]     Request           SSIF request
+  @param[in]      NetFunction       Net function of the command
+  @param[in]      Lun               Logical unit of the command
+  @param[in]      Command           IPMI command
+  @param[in]      RequestData       Command request data
+  @param[in]      RequestDataSize   Size of RequestData
+  @param[out]     ResponseData      Command response data, NULL if no response is expected
+  @param[in, out] ResponseDataSize  Size of ResponseData, updated on completion
+  @param[in]      Context           Caller context
+
+**/
+VOID
+SsifRequestInit (
+  OUT    SSIF_REQUEST  *Request,
+  IN     UINT8         NetFunction,
+  IN     UINT8         Lun,
+  IN     UINT8         Command,
+  IN     UINT8         *RequestData,
+  IN     UINT32        RequestDataSize,
+  OUT    UINT8         *ResponseData,
+  IN OUT UINT32        *ResponseDataSize,
+  IN     VOID          *Context
+  );
+
+/**
+  Queue a request on the transport.
+
+  The request is started by a later SsifTransportPoll, and Request and its
+  buffers must stay valid until the poll returns it.
+
+  @param[in, out] Transport   SSIF transport
+  @param[in]      Request     Initialized SSIF request
+
+  @retval EFI_SUCCESS           Request queued
+  @retval EFI_BAD_BUFFER_SIZE   Request does not fit the BMC's input message size or transaction support
+
+**/
+EFI_STATUS
+SsifTransportQueue (
+  IN OUT SSIF_TRANSPORT  *Transport,
+  IN     SSIF_REQUEST    *Request
+  );
+
+/**
+  Advance the SSIF transport.
+
+  Never blocks waiting for the BMC. A request waiting for its response is
+  only read once SMBALERT# is asserted or the retry delay has passed. When a
+  request completes it is returned, and the next poll starts the next queued
+  request right away, so callers should poll until NULL is returned.
+
+  @param[in, out] Transport       SSIF transport
+  @param[in]      Now             Current time in microseconds
+  @param[in]      AlertAsserted   SMBALERT# is asserted
+
+  @retval Completed request, with its Status set
+  @retval NULL if no request completed
+
+**/
+SSIF_REQUEST *
+SsifTransportPoll (
+  IN OUT SSIF_TRANSPORT  *Transport,
+  IN     UINT64          Now,
+  IN     BOOLEAN         AlertAsserted
+  );
+
+/**
+  Check whether the transport has no active or queued requests.
+
+  @param[in]  Transport   SSIF transport
+
+  @retval TRUE    Transport is idle
+  @retval FALSE   Requests are pending
+
+**/
+BOOLEAN
+SsifTransportIdle (
+  IN SSIF_TRANSPORT  *Transport
+  );
+
+#endif
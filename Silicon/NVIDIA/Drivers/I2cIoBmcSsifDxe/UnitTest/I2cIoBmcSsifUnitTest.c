@@ -0,0 +1,596 @@
+/** @file
+
+  I2C IO IPMI driver SSIF transport unit test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../I2cIoBmcSsifTransport.h"
+
+#define UNIT_TEST_NAME     "I2C SSIF Transport Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_NETFN_APP        0x06
+#define TEST_NETFN_OEM        0x30
+#define TEST_POLL_INTERVAL    100
+#define TEST_RUN_TIMEOUT      10000000
+#define TEST_MAX_REQUESTS     8
+#define TEST_SLAVE_ADDRESS    0x10
+#define TEST_PROCESSING_TIME  2000
+
+//
+// Simulated SSIF BMC: assembles single and multi-part writes, echoes the
+// request data back in its response once ProcessingTime has passed, and
+// answers Get System Interface Capabilities
+//
+typedef struct {
+  EFI_I2C_MASTER_PROTOCOL    I2cMaster;
+  UINT64                     Now;
+  UINT64                     ProcessingTime;
+
+  UINT8                      TransactionSupport;
+  UINT8                      InputMessageSize;
+  UINT32                     NakReads;
+  BOOLEAN                    FailWrites;
+
+  UINT8                      Request[SSIF_MAX_MESSAGE_SIZE + SSIF_MAX_DATA];
+  UINT32                     RequestSize;
+  UINT32                     PecFlags;
+
+  UINT8                      Response[SSIF_MAX_MESSAGE_SIZE + SSIF_MAX_DATA];
+  UINT32                     ResponseSize;
+  UINT32                     ResponseOffset;
+  UINT8                      NextBlock;
+  BOOLEAN                    ResponsePending;
+  UINT64                     ReadyTime;
+
+  UINT32                     RequestCount;
+  UINT8                      LastLun;
+} TEST_BMC;
+
+STATIC TEST_BMC  mBmc;
+
+/**
+  Build the simulated BMC's response to the request it received.
+
+**/
+STATIC
+VOID
+TestBmcHandleRequest (
+  VOID
+  )
+{
+  UINT8  NetFunction;
+  UINT8  Command;
+
+  NetFunction  = mBmc.Request[0] >> 2;
+  Command      = mBmc.Request[1];
+  mBmc.LastLun = mBmc.Request[0] & 0x3;
+
+  mBmc.Response[0] = (UINT8)(((NetFunction + 1) << 2) | mBmc.LastLun);
+  mBmc.Response[1] = Command;
+  mBmc.Response[2] = 0;
+  if ((NetFunction == TEST_NETFN_APP) && (Command == SSIF_GET_SYSTEM_INTERFACE_CAPABILITIES)) {
+    mBmc.Response[3]  = 0;
+    mBmc.Response[4]  = mBmc.TransactionSupport;
+    mBmc.Response[5]  = mBmc.InputMessageSize;
+    mBmc.Response[6]  = SSIF_MAX_MESSAGE_SIZE;
+    mBmc.ResponseSize = 7;
+  } else {
+    CopyMem (&mBmc.Response[3], &mBmc.Request[2], mBmc.RequestSize - 2);
+    mBmc.ResponseSize = mBmc.RequestSize + 1;
+  }
+
+  mBmc.ResponsePending = TRUE;
+  mBmc.ReadyTime       = mBmc.Now + mBmc.ProcessingTime;
+  mBmc.RequestCount++;
+}
+
+/**
+  Simulated SSIF BMC behind an I2C master.
+
+  @param[in]  This          I2C master protocol
+  @param[in]  SlaveAddress  Address of the BMC
+  @param[in]  Packet        Request packet
+  @param[in]  Event         Must be NULL
+  @param[out] I2cStatus     Must be NULL
+
+  @retval EFI_SUCCESS       Transfer completed
+  @retval EFI_NO_RESPONSE   Read NAKed, response not ready
+  @retval EFI_DEVICE_ERROR  Transfer not supported by the BMC
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestBmcStartRequest (
+  IN  CONST EFI_I2C_MASTER_PROTOCOL  *This,
+  IN  UINTN                          SlaveAddress,
+  IN  EFI_I2C_REQUEST_PACKET         *Packet,
+  IN  EFI_EVENT                      Event      OPTIONAL,
+  OUT EFI_STATUS                     *I2cStatus OPTIONAL
+  )
+{
+  EFI_I2C_OPERATION  *Write;
+  UINT8              *Read;
+  UINT32             Remaining;
+
+  ASSERT (SlaveAddress == TEST_SLAVE_ADDRESS);
+  ASSERT (Event == NULL);
+
+  Write          = &Packet->Operation[0];
+  mBmc.PecFlags |= Write->Flags & I2C_FLAG_SMBUS_PEC;
+  if ((Write->Buffer[0] != BMC_SSIF_SINGLE_PART_READ_CMD) &&
+      (Write->Buffer[0] != BMC_SSIF_MULTI_PART_READ_CMD_MIDDLE_END) &&
+      mBmc.FailWrites)
+  {
+    return EFI_DEVICE_ERROR;
+  }
+
+  switch (Write->Buffer[0]) {
+    case BMC_SSIF_SINGLE_PART_WRITE_CMD:
+      CopyMem (mBmc.Request, &Write->Buffer[SMBUS_WRITE_HEADER_SIZE], Write->Buffer[1]);
+      mBmc.RequestSize = Write->Buffer[1];
+      TestBmcHandleRequest ();
+      return EFI_SUCCESS;
+
+    case BMC_SSIF_MULTI_PART_WRITE_CMD_START:
+      if ((mBmc.TransactionSupport & SSIF_TRANSACTION_SUPPORT_MASK) == SSIF_TRANSACTION_SINGLE_PART) {
+        return EFI_DEVICE_ERROR;
+      }
+
+      CopyMem (mBmc.Request, &Write->Buffer[SMBUS_WRITE_HEADER_SIZE], Write->Buffer[1]);
+      mBmc.RequestSize = Write->Buffer[1];
+      return EFI_SUCCESS;
+
+    case BMC_SSIF_MULTI_PART_WRITE_CMD_MIDDLE:
+    case BMC_SSIF_MULTI_PART_WRITE_CMD_END:
+      if ((Write->Buffer[0] == BMC_SSIF_MULTI_PART_WRITE_CMD_MIDDLE) &&
+          ((mBmc.TransactionSupport & SSIF_TRANSACTION_SUPPORT_MASK) != SSIF_TRANSACTION_MIDDLE))
+      {
+        return EFI_DEVICE_ERROR;
+      }
+
+      CopyMem (&mBmc.Request[mBmc.RequestSize], &Write->Buffer[SMBUS_WRITE_HEADER_SIZE], Write->Buffer[1]);
+      mBmc.RequestSize += Write->Buffer[1];
+      if (Write->Buffer[0] == BMC_SSIF_MULTI_PART_WRITE_CMD_END) {
+        TestBmcHandleRequest ();
+      }
+
+      return EFI_SUCCESS;
+
+    case BMC_SSIF_SINGLE_PART_READ_CMD:
+      Read = Packet->Operation[1].Buffer;
+      if (!mBmc.ResponsePending || (mBmc.Now < mBmc.ReadyTime)) {
+        return EFI_NO_RESPONSE;
+      }
+
+      if (mBmc.NakReads != 0) {
+        mBmc.NakReads--;
+        return EFI_NO_RESPONSE;
+      }
+
+      if (mBmc.ResponseSize <= SSIF_MAX_DATA) {
+        Read[0] = (UINT8)mBmc.ResponseSize;
+        CopyMem (&Read[1], mBmc.Response, mBmc.ResponseSize);
+        mBmc.ResponsePending = FALSE;
+      } else {
+        Read[0] = SSIF_MAX_DATA;
+        Read[1] = 0x00;
+        Read[2] = 0x01;
+        CopyMem (&Read[3], mBmc.Response, SSIF_MAX_DATA - 2);
+        mBmc.ResponseOffset = SSIF_MAX_DATA - 2;
+        mBmc.NextBlock      = 0;
+      }
+
+      return EFI_SUCCESS;
+
+    case BMC_SSIF_MULTI_PART_READ_CMD_MIDDLE_END:
+      Read      = Packet->Operation[1].Buffer;
+      Remaining = mBmc.ResponseSize - mBmc.ResponseOffset;
+      if (Remaining < SSIF_MAX_DATA) {
+        Read[0]              = (UINT8)(Remaining + 1);
+        Read[1]              = 0xFF;
+        mBmc.ResponsePending = FALSE;
+      } else {
+        Remaining = SSIF_MAX_DATA - 1;
+        Read[0]   = SSIF_MAX_DATA;
+        Read[1]   = mBmc.NextBlock++;
+      }
+
+      CopyMem (&Read[2], &mBmc.Response[mBmc.ResponseOffset], Remaining);
+      mBmc.ResponseOffset += Remaining;
+      return EFI_SUCCESS;
+
+    default:
+      return EFI_DEVICE_ERROR;
+  }
+}
+
+/**
+  Reset the simulated BMC and initialize a transport to talk to it.
+
+  @param[out] Transport           SSIF transport
+  @param[in]  SmbAlertSupported   Transport uses SMBALERT#
+
+**/
+STATIC
+VOID
+TestSetup (
+  OUT SSIF_TRANSPORT  *Transport,
+  IN  BOOLEAN         SmbAlertSupported
+  )
+{
+  ZeroMem (&mBmc, sizeof (mBmc));
+  mBmc.I2cMaster.StartRequest = (EFI_I2C_MASTER_PROTOCOL_START_REQUEST)TestBmcStartRequest;
+  mBmc.ProcessingTime         = TEST_PROCESSING_TIME;
+  mBmc.TransactionSupport     = SSIF_TRANSACTION_MIDDLE | SSIF_PEC_SUPPORT;
+  mBmc.InputMessageSize       = SSIF_MAX_MESSAGE_SIZE;
+
+  SsifTransportInit (Transport, &mBmc.I2cMaster, TEST_SLAVE_ADDRESS, SmbAlertSupported);
+}
+
+/**
+  Poll the transport until Count requests complete or the run times out.
+
+  @param[in]  Transport   SSIF transport
+  @param[out] Completed   Completed requests, in completion order
+  @param[in]  Count       Number of requests to wait for
+
+  @retval Number of requests completed
+
+**/
+STATIC
+UINTN
+TestRun (
+  IN  SSIF_TRANSPORT  *Transport,
+  OUT SSIF_REQUEST    **Completed,
+  IN  UINTN           Count
+  )
+{
+  SSIF_REQUEST  *Request;
+  UINTN         Done;
+  UINT64        End;
+
+  Done = 0;
+  End  = mBmc.Now + TEST_RUN_TIMEOUT;
+  while ((Done < Count) && (mBmc.Now < End)) {
+    do {
+      Request = SsifTransportPoll (Transport, mBmc.Now, mBmc.ResponsePending && (mBmc.Now >= mBmc.ReadyTime));
+      if (Request != NULL) {
+        Completed[Done++] = Request;
+      }
+    } while ((Request != NULL) && (Done < Count));
+
+    mBmc.Now += TEST_POLL_INTERVAL;
+  }
+
+  return Done;
+}
+
+/**
+  Run a single request with the given request size through the transport.
+
+  @param[in]  Transport       SSIF transport
+  @param[in]  Lun             Logical unit of the command
+  @param[in]  RequestSize     Number of request data bytes
+
+  @retval Status of the request
+
+**/
+STATIC
+EFI_STATUS
+TestEcho (
+  IN SSIF_TRANSPORT  *Transport,
+  IN UINT8           Lun,
+  IN UINT32          RequestSize
+  )
+{
+  EFI_STATUS    Status;
+  SSIF_REQUEST  Request;
+  SSIF_REQUEST  *Completed;
+  UINT8         RequestData[SSIF_MAX_MESSAGE_SIZE];
+  UINT8         ResponseData[SSIF_MAX_MESSAGE_SIZE];
+  UINT32        ResponseSize;
+  UINT32        Index;
+
+  for (Index = 0; Index < RequestSize; Index++) {
+    RequestData[Index] = (UINT8)(Index * 7 + 1);
+  }
+
+  ResponseSize = sizeof (ResponseData);
+  SsifRequestInit (&Request, TEST_NETFN_OEM, Lun, 0x42, RequestData, RequestSize, ResponseData, &ResponseSize, NULL);
+  Status = SsifTransportQueue (Transport, &Request);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (TestRun (Transport, &Completed, 1) != 1) {
+    return EFI_TIMEOUT;
+  }
+
+  if ((Completed != &Request) || EFI_ERROR (Request.Status)) {
+    return EFI_ERROR (Request.Status) ? Request.Status : EFI_NOT_FOUND;
+  }
+
+  if ((ResponseSize != RequestSize + 1) || (ResponseData[0] != 0) ||
+      (CompareMem (&ResponseData[1], RequestData, RequestSize) != 0))
+  {
+    return EFI_CRC_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Single-part request is written and its response read after the retry delay.
+
+  @param[in]  Context   Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SinglePart (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SSIF_TRANSPORT  Transport;
+
+  TestSetup (&Transport, FALSE);
+
+  UT_ASSERT_NOT_EFI_ERROR (TestEcho (&Transport, 0, 4));
+  UT_ASSERT_EQUAL (mBmc.RequestCount, 1);
+  UT_ASSERT_EQUAL (mBmc.Now, BMC_RETRY_DELAY + TEST_POLL_INTERVAL);
+  UT_ASSERT_EQUAL (mBmc.PecFlags, I2C_FLAG_SMBUS_PEC);
+  UT_ASSERT_EQUAL (Transport.SoftErrorCount, 0);
+  UT_ASSERT_TRUE (SsifTransportIdle (&Transport));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Large request and response use multi-part writes and reads.
+
+  @param[in]  Context   Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MultiPart (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SSIF_TRANSPORT  Transport;
+
+  TestSetup (&Transport, FALSE);
+
+  UT_ASSERT_NOT_EFI_ERROR (TestEcho (&Transport, 1, 100));
+  UT_ASSERT_EQUAL (mBmc.RequestSize, 102);
+  UT_ASSERT_EQUAL (mBmc.LastLun, 1);
+  UT_ASSERT_NOT_EFI_ERROR (TestEcho (&Transport, 2, SSIF_MAX_MESSAGE_SIZE - SSIF_HEADER_SIZE));
+  UT_ASSERT_EQUAL (mBmc.LastLun, 2);
+  UT_ASSERT_EQUAL (mBmc.RequestCount, 2);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Get System Interface Capabilities limits the transactions used.
+
+  @param[in]  Context   Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Capabilities (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SSIF_TRANSPORT  Transport;
+  SSIF_REQUEST    Request;
+  SSIF_REQUEST    *Completed;
+  UINT8           InterfaceType;
+  UINT8           Response[SSIF_CAPABILITIES_RESPONSE_SIZE];
+  UINT32          ResponseSize;
+
+  TestSetup (&Transport, FALSE);
+  mBmc.TransactionSupport = SSIF_TRANSACTION_START_END;
+  mBmc.InputMessageSize   = 2 * SSIF_MAX_DATA;
+
+  InterfaceType = SSIF_SYSTEM_INTERFACE_TYPE;
+  ResponseSize  = sizeof (Response);
+  SsifRequestInit (&Request, TEST_NETFN_APP, 0, SSIF_GET_SYSTEM_INTERFACE_CAPABILITIES, &InterfaceType, 1, Response, &ResponseSize, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (SsifTransportQueue (&Transport, &Request));
+  UT_ASSERT_EQUAL (TestRun (&Transport, &Completed, 1), 1);
+  UT_ASSERT_NOT_EFI_ERROR (Request.Status);
+  UT_ASSERT_NOT_EFI_ERROR (SsifTransportSetCapabilities (&Transport, Response, ResponseSize));
+  UT_ASSERT_EQUAL (Transport.TransactionSupport, SSIF_TRANSACTION_START_END);
+  UT_ASSERT_EQUAL (Transport.InputMessageSize, 2 * SSIF_MAX_DATA);
+
+  // No middle transactions and no PEC
+  mBmc.PecFlags = 0;
+  UT_ASSERT_STATUS_EQUAL (TestEcho (&Transport, 0, 2 * SSIF_MAX_DATA), EFI_BAD_BUFFER_SIZE);
+  UT_ASSERT_NOT_EFI_ERROR (TestEcho (&Transport, 0, 2 * SSIF_MAX_DATA - SSIF_HEADER_SIZE));
+  UT_ASSERT_EQUAL (mBmc.PecFlags, 0);
+
+  // Single-part only
+  Response[2] = SSIF_TRANSACTION_SINGLE_PART;
+  Response[3] = SSIF_MAX_MESSAGE_SIZE;
+  UT_ASSERT_NOT_EFI_ERROR (SsifTransportSetCapabilities (&Transport, Response, ResponseSize));
+  UT_ASSERT_STATUS_EQUAL (TestEcho (&Transport, 0, SSIF_MAX_DATA), EFI_BAD_BUFFER_SIZE);
+
+  // Failed completion code keeps the current capabilities
+  Response[0] = 0xC1;
+  UT_ASSERT_STATUS_EQUAL (SsifTransportSetCapabilities (&Transport, Response, ResponseSize), EFI_UNSUPPORTED);
+  UT_ASSERT_EQUAL (Transport.TransactionSupport, SSIF_TRANSACTION_SINGLE_PART);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reads NAKed by the BMC are retried after the retry delay.
+
+  @param[in]  Context   Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+NoResponseRetry (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SSIF_TRANSPORT  Transport;
+
+  TestSetup (&Transport, FALSE);
+  mBmc.NakReads = 3;
+
+  UT_ASSERT_NOT_EFI_ERROR (TestEcho (&Transport, 0, 8));
+  UT_ASSERT_EQUAL (mBmc.RequestCount, 1);
+  UT_ASSERT_EQUAL (Transport.SoftErrorCount, 3);
+  UT_ASSERT_TRUE (mBmc.Now > 4 * BMC_RETRY_DELAY);
+
+  // Write failures complete the request
+  mBmc.FailWrites = TRUE;
+  UT_ASSERT_STATUS_EQUAL (TestEcho (&Transport, 0, 8), EFI_DEVICE_ERROR);
+  UT_ASSERT_EQUAL (Transport.SoftErrorCount, 4);
+  UT_ASSERT_TRUE (SsifTransportIdle (&Transport));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Queued requests complete in order, each started as soon as the previous
+  one completes, with SMBALERT# avoiding the retry delay.
+
+  @param[in]  Context   Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+QueuedRequests (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SSIF_TRANSPORT  Transport;
+  SSIF_REQUEST    Requests[TEST_MAX_REQUESTS];
+  SSIF_REQUEST    *Completed[TEST_MAX_REQUESTS];
+  UINT8           RequestData[TEST_MAX_REQUESTS];
+  UINT8           ResponseData[TEST_MAX_REQUESTS][4];
+  UINT32          ResponseSize[TEST_MAX_REQUESTS];
+  UINTN           Index;
+
+  TestSetup (&Transport, TRUE);
+
+  for (Index = 0; Index < TEST_MAX_REQUESTS; Index++) {
+    RequestData[Index]  = (UINT8)Index;
+    ResponseSize[Index] = sizeof (ResponseData[Index]);
+    SsifRequestInit (&Requests[Index], TEST_NETFN_OEM, 0, 0x10, &RequestData[Index], 1, ResponseData[Index], &ResponseSize[Index], NULL);
+    UT_ASSERT_NOT_EFI_ERROR (SsifTransportQueue (&Transport, &Requests[Index]));
+  }
+
+  UT_ASSERT_EQUAL (TestRun (&Transport, Completed, TEST_MAX_REQUESTS), TEST_MAX_REQUESTS);
+  for (Index = 0; Index < TEST_MAX_REQUESTS; Index++) {
+    UT_ASSERT_TRUE (Completed[Index] == &Requests[Index]);
+    UT_ASSERT_NOT_EFI_ERROR (Requests[Index].Status);
+    UT_ASSERT_EQUAL (ResponseSize[Index], 2);
+    UT_ASSERT_EQUAL (ResponseData[Index][1], Index);
+  }
+
+  // Each request only costs the BMC's processing time plus a poll interval
+  UT_ASSERT_TRUE (mBmc.Now <= TEST_MAX_REQUESTS * (TEST_PROCESSING_TIME + TEST_POLL_INTERVAL) + TEST_POLL_INTERVAL);
+  UT_ASSERT_EQUAL (Transport.SoftErrorCount, 0);
+  UT_ASSERT_TRUE (SsifTransportIdle (&Transport));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the SSIF
+  transport and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SsifTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&SsifTests, Framework, "SSIF Transport Tests", "UnitTest.I2cIoBmcSsif", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for SSIF Transport Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    return Status;
+  }
+
+  AddTestCase (SsifTests, "Single-part request and response", "SinglePart", SinglePart, NULL, NULL, NULL);
+  AddTestCase (SsifTests, "Multi-part request and response", "MultiPart", MultiPart, NULL, NULL, NULL);
+  AddTestCase (SsifTests, "BMC capabilities limit transactions", "Capabilities", Capabilities, NULL, NULL, NULL);
+  AddTestCase (SsifTests, "NAKed reads are retried", "NoResponseRetry", NoResponseRetry, NULL, NULL, NULL);
+  AddTestCase (SsifTests, "Queued requests complete back to back", "QueuedRequests", QueuedRequests, NULL, NULL, NULL);
+
+  // Execute the tests.
+  Status = RunAllTestSuites (Framework);
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
@@ -17,6 +17,16 @@
 
 #define PROTOCOL_RESPONSE_OVERHEAD  (4 * sizeof(UINT8))     // 1 byte completion code + 3 bytes OEN
 
+// Transport capability commands, IPMI 2.0 sections 22.9 and 22.10
+#define BLOB_TRANSFER_GET_BT_INTERFACE_CAPABILITIES      0x36
+#define BLOB_TRANSFER_GET_SYSTEM_INTERFACE_CAPABILITIES  0x57
+#define BLOB_TRANSFER_SYSTEM_INTERFACE_SSIF              0x00
+#define BLOB_TRANSFER_SYSTEM_INTERFACE_KCS               0x01
+
+// Message bytes outside of the request/response data: NetFn/LUN and Cmd, plus length and sequence for BT
+#define BLOB_TRANSFER_SSIF_KCS_MESSAGE_OVERHEAD  2
+#define BLOB_TRANSFER_BT_MESSAGE_OVERHEAD        4
+
 // Subcommands for this protocol
 typedef enum {
   IpmiBlobTransferSubcommandGetCount = 0,
@@ -39,6 +49,30 @@ typedef struct {
   UINT8    SubCommand;
 } IPMI_BLOB_TRANSFER_HEADER;
 
+typedef struct {
+  UINT8    CompletionCode;
+  UINT8    Reserved;
+  UINT8    TransactionSupport;
+  UINT8    InputMessageSize;
+  UINT8    OutputMessageSize;
+} IPMI_BLOB_TRANSFER_SSIF_CAPABILITIES_RESPONSE;
+
+typedef struct {
+  UINT8    CompletionCode;
+  UINT8    Reserved;
+  UINT8    InterfaceVersion;
+  UINT8    InputMaximumMessageSize;
+} IPMI_BLOB_TRANSFER_KCS_CAPABILITIES_RESPONSE;
+
+typedef struct {
+  UINT8    CompletionCode;
+  UINT8    OutstandingRequests;
+  UINT8    InputBufferSize;
+  UINT8    OutputBufferSize;
+  UINT8    RequestToResponseTime;
+  UINT8    RecommendedRetries;
+} IPMI_BLOB_TRANSFER_BT_CAPABILITIES_RESPONSE;
+
 //
 // Command 0 - BmcBlobGetCount
 // The BmcBlobGetCount command expects to receive an empty body.
@@ -199,6 +233,21 @@ IpmiBlobTransferSendIpmi (
   OUT UINT32  *ResponseDataSize
   );
 
+/**
+  Size blob reads and writes to the maximum message size of the IPMI transport.
+
+  The transport is queried with the SSIF, KCS and BT capability commands.  If
+  none of them is supported, IPMI_OEM_BLOB_MAX_DATA_PER_PACKET is used.
+
+  @param[out]        MaxWriteData    Optional, data bytes per write command
+  @param[out]        MaxReadData     Optional, data bytes per read command
+**/
+VOID
+IpmiBlobTransferDiscoverPacketSize (
+  OUT UINT32  *MaxWriteData OPTIONAL,
+  OUT UINT32  *MaxReadData OPTIONAL
+  );
+
 /**
   @param[out]        Count       The number of active blobs
 
@@ -239,6 +288,8 @@ IpmiBlobTransferOpen (
   );
 
 /**
+  Read from a blob, split into as many read commands as needed.
+
   @param[in]         SessionId       The session ID returned from a call to BlobOpen
   @param[in]         Offset          The offset of the blob from which to start reading
   @param[in]         RequestedSize   The length of data to read
@@ -256,9 +307,12 @@ IpmiBlobTransferRead (
   );
 
 /**
+  Write to a blob, split into as many write commands as needed.
+
   @param[in]         SessionId       The session ID returned from a call to BlobOpen
   @param[in]         Offset          The offset of the blob from which to start writing
   @param[in]         Data            A pointer to the data to write
+  @param[in]         WriteLength     The length of data to write
 
   @retval EFI_SUCCESS                Successfully wrote to the blob.
   @retval Other                      An error occurred
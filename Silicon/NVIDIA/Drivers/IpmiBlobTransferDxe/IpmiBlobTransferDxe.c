@@ -29,6 +29,10 @@ STATIC CONST IPMI_BLOB_TRANSFER_PROTOCOL  mIpmiBlobTransfer = {
 
 const UINT8  OpenBmcOen[] = { 0xCF, 0xC2, 0x00 };          // OpenBMC OEN code in little endian format
 
+STATIC BOOLEAN  mPacketSizeDiscovered = FALSE;
+STATIC UINT32   mMaxWriteData         = IPMI_OEM_BLOB_MAX_DATA_PER_PACKET;
+STATIC UINT32   mMaxReadData          = IPMI_OEM_BLOB_MAX_DATA_PER_PACKET;
+
 /**
   Calculate CRC-16-CCITT with poly of 0x1021
 
@@ -224,6 +228,147 @@ IpmiBlobTransferSendIpmi (
   }
 }
 
+/**
+  Get the request and response data sizes of the IPMI transport.
+
+  @param[out]        InputData       Request data bytes the BMC accepts
+  @param[out]        OutputData      Response data bytes the BMC can return, including completion code
+
+  @retval EFI_SUCCESS                Sizes returned
+  @retval EFI_UNSUPPORTED            The BMC does not report its transport capabilities
+**/
+STATIC
+EFI_STATUS
+IpmiBlobTransferGetTransportSize (
+  OUT UINT32  *InputData,
+  OUT UINT32  *OutputData
+  )
+{
+  EFI_STATUS                                     Status;
+  UINT8                                          InterfaceType;
+  UINT32                                         ResponseSize;
+  IPMI_BLOB_TRANSFER_SSIF_CAPABILITIES_RESPONSE  SsifResponse;
+  IPMI_BLOB_TRANSFER_KCS_CAPABILITIES_RESPONSE   KcsResponse;
+  IPMI_BLOB_TRANSFER_BT_CAPABILITIES_RESPONSE    BtResponse;
+
+  InterfaceType = BLOB_TRANSFER_SYSTEM_INTERFACE_SSIF;
+  ResponseSize  = sizeof (SsifResponse);
+  Status        = IpmiSubmitCommand (
+                    IPMI_NETFN_APP,
+                    BLOB_TRANSFER_GET_SYSTEM_INTERFACE_CAPABILITIES,
+                    &InterfaceType,
+                    sizeof (InterfaceType),
+                    (UINT8 *)&SsifResponse,
+                    &ResponseSize
+                    );
+  if (!EFI_ERROR (Status) &&
+      (ResponseSize >= sizeof (SsifResponse)) &&
+      (SsifResponse.CompletionCode == IPMI_COMP_CODE_NORMAL) &&
+      (SsifResponse.InputMessageSize > BLOB_TRANSFER_SSIF_KCS_MESSAGE_OVERHEAD) &&
+      (SsifResponse.OutputMessageSize > BLOB_TRANSFER_SSIF_KCS_MESSAGE_OVERHEAD))
+  {
+    *InputData  = SsifResponse.InputMessageSize - BLOB_TRANSFER_SSIF_KCS_MESSAGE_OVERHEAD;
+    *OutputData = SsifResponse.OutputMessageSize - BLOB_TRANSFER_SSIF_KCS_MESSAGE_OVERHEAD;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // KCS only reports the input limit, responses are not limited by the interface
+  //
+  InterfaceType = BLOB_TRANSFER_SYSTEM_INTERFACE_KCS;
+  ResponseSize  = sizeof (KcsResponse);
+  Status        = IpmiSubmitCommand (
+                    IPMI_NETFN_APP,
+                    BLOB_TRANSFER_GET_SYSTEM_INTERFACE_CAPABILITIES,
+                    &InterfaceType,
+                    sizeof (InterfaceType),
+                    (UINT8 *)&KcsResponse,
+                    &ResponseSize
+                    );
+  if (!EFI_ERROR (Status) &&
+      (ResponseSize >= sizeof (KcsResponse)) &&
+      (KcsResponse.CompletionCode == IPMI_COMP_CODE_NORMAL) &&
+      (KcsResponse.InputMaximumMessageSize > BLOB_TRANSFER_SSIF_KCS_MESSAGE_OVERHEAD))
+  {
+    *InputData  = KcsResponse.InputMaximumMessageSize - BLOB_TRANSFER_SSIF_KCS_MESSAGE_OVERHEAD;
+    *OutputData = *InputData;
+    return EFI_SUCCESS;
+  }
+
+  ResponseSize = sizeof (BtResponse);
+  Status       = IpmiSubmitCommand (
+                   IPMI_NETFN_APP,
+                   BLOB_TRANSFER_GET_BT_INTERFACE_CAPABILITIES,
+                   NULL,
+                   0,
+                   (UINT8 *)&BtResponse,
+                   &ResponseSize
+                   );
+  if (!EFI_ERROR (Status) &&
+      (ResponseSize >= sizeof (BtResponse)) &&
+      (BtResponse.CompletionCode == IPMI_COMP_CODE_NORMAL) &&
+      (BtResponse.InputBufferSize > BLOB_TRANSFER_BT_MESSAGE_OVERHEAD) &&
+      (BtResponse.OutputBufferSize > BLOB_TRANSFER_BT_MESSAGE_OVERHEAD))
+  {
+    *InputData  = BtResponse.InputBufferSize - BLOB_TRANSFER_BT_MESSAGE_OVERHEAD;
+    *OutputData = BtResponse.OutputBufferSize - BLOB_TRANSFER_BT_MESSAGE_OVERHEAD;
+    return EFI_SUCCESS;
+  }
+
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Size blob reads and writes to the maximum message size of the IPMI transport.
+
+  The transport is queried with the SSIF, KCS and BT capability commands.  If
+  none of them is supported, IPMI_OEM_BLOB_MAX_DATA_PER_PACKET is used.
+
+  @param[out]        MaxWriteData    Optional, data bytes per write command
+  @param[out]        MaxReadData     Optional, data bytes per read command
+**/
+VOID
+IpmiBlobTransferDiscoverPacketSize (
+  OUT UINT32  *MaxWriteData OPTIONAL,
+  OUT UINT32  *MaxReadData OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      InputData;
+  UINT32      OutputData;
+  UINT32      WriteOverhead;
+  UINT32      ReadOverhead;
+
+  mMaxWriteData = IPMI_OEM_BLOB_MAX_DATA_PER_PACKET;
+  mMaxReadData  = IPMI_OEM_BLOB_MAX_DATA_PER_PACKET;
+
+  Status = IpmiBlobTransferGetTransportSize (&InputData, &OutputData);
+  if (!EFI_ERROR (Status)) {
+    WriteOverhead = sizeof (IPMI_BLOB_TRANSFER_HEADER) + sizeof (UINT16) + OFFSET_OF (IPMI_BLOB_TRANSFER_BLOB_WRITE_SEND_DATA, Data);
+    ReadOverhead  = PROTOCOL_RESPONSE_OVERHEAD + sizeof (UINT16);
+    if (InputData > WriteOverhead) {
+      mMaxWriteData = MAX (mMaxWriteData, InputData - WriteOverhead);
+    }
+
+    if (OutputData > ReadOverhead) {
+      mMaxReadData = MAX (mMaxReadData, OutputData - ReadOverhead);
+    }
+  } else {
+    DEBUG ((DEBUG_INFO, "%a: transport size unknown, using %u byte packets\n", __FUNCTION__, IPMI_OEM_BLOB_MAX_DATA_PER_PACKET));
+  }
+
+  DEBUG ((DEBUG_INFO, "%a: %u bytes per write, %u bytes per read\n", __FUNCTION__, mMaxWriteData, mMaxReadData));
+
+  mPacketSizeDiscovered = TRUE;
+  if (MaxWriteData != NULL) {
+    *MaxWriteData = mMaxWriteData;
+  }
+
+  if (MaxReadData != NULL) {
+    *MaxReadData = mMaxReadData;
+  }
+}
+
 /**
   @param[out]        Count       The number of active blobs
 
@@ -414,43 +559,51 @@ IpmiBlobTransferRead (
   OUT UINT8   *Data
   )
 {
-  EFI_STATUS  Status;
-  UINT8       *SendData;
-  UINT8       *ResponseData;
-  UINT32      SendDataSize;
-  UINT32      ResponseDataSize;
+  EFI_STATUS                              Status;
+  UINT8                                   *ResponseData;
+  UINT32                                  ResponseDataSize;
+  UINT32                                  ChunkSize;
+  IPMI_BLOB_TRANSFER_BLOB_READ_SEND_DATA  SendData;
 
   if (Data == NULL) {
     ASSERT (FALSE);
     return EFI_ABORTED;
   }
 
-  ResponseDataSize = RequestedSize * sizeof (UINT8);
-  ResponseData     = AllocateZeroPool (ResponseDataSize);
-  if (ResponseData == NULL) {
-    return EFI_OUT_OF_RESOURCES;
+  if ((RequestedSize > IPMI_OEM_BLOB_MAX_DATA_PER_PACKET) && !mPacketSizeDiscovered) {
+    IpmiBlobTransferDiscoverPacketSize (NULL, NULL);
   }
 
-  //
-  // Format send data
-  //
-  SendDataSize = sizeof (IPMI_BLOB_TRANSFER_BLOB_READ_SEND_DATA);
-  SendData     = AllocateZeroPool (SendDataSize);
-  if (SendData == NULL) {
+  ResponseData = AllocateZeroPool (MIN (RequestedSize, mMaxReadData));
+  if (ResponseData == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
-  ((IPMI_BLOB_TRANSFER_BLOB_READ_SEND_DATA *)SendData)->SessionId     = SessionId;
-  ((IPMI_BLOB_TRANSFER_BLOB_READ_SEND_DATA *)SendData)->Offset        = Offset;
-  ((IPMI_BLOB_TRANSFER_BLOB_READ_SEND_DATA *)SendData)->RequestedSize = RequestedSize;
+  SendData.SessionId = SessionId;
+  Status             = EFI_SUCCESS;
+  do {
+    ChunkSize              = MIN (RequestedSize, mMaxReadData);
+    SendData.Offset        = Offset;
+    SendData.RequestedSize = ChunkSize;
 
-  Status = IpmiBlobTransferSendIpmi (IpmiBlobTransferSubcommandRead, SendData, SendDataSize, (UINT8 *)ResponseData, &ResponseDataSize);
-  if (!EFI_ERROR (Status)) {
-    CopyMem (Data, ((IPMI_BLOB_TRANSFER_BLOB_READ_RESPONSE *)ResponseData)->Data, ResponseDataSize * sizeof (UINT8));
-  }
+    ResponseDataSize = ChunkSize;
+    Status           = IpmiBlobTransferSendIpmi (IpmiBlobTransferSubcommandRead, (UINT8 *)&SendData, sizeof (SendData), ResponseData, &ResponseDataSize);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    ResponseDataSize = MIN (ResponseDataSize, ChunkSize);
+    CopyMem (Data, ResponseData, ResponseDataSize);
+    Data          += ResponseDataSize;
+    Offset        += ResponseDataSize;
+    RequestedSize -= ResponseDataSize;
+
+    //
+    // A short read is the end of the blob
+    //
+  } while ((RequestedSize > 0) && (ResponseDataSize == ChunkSize));
 
   FreePool (ResponseData);
-  FreePool (SendData);
   return Status;
 }
 
@@ -474,22 +627,44 @@ IpmiBlobTransferWrite (
   UINT8       *SendData;
   UINT32      SendDataSize;
   UINT32      ResponseDataSize;
+  UINT32      ChunkSize;
+
+  if ((WriteLength > IPMI_OEM_BLOB_MAX_DATA_PER_PACKET) && !mPacketSizeDiscovered) {
+    IpmiBlobTransferDiscoverPacketSize (NULL, NULL);
+  }
 
   //
-  // Format send data
+  // Format send data, one buffer is reused for every packet
   //
-  SendDataSize = sizeof (SessionId) + sizeof (Offset) + WriteLength;
+  SendDataSize = sizeof (SessionId) + sizeof (Offset) + MIN (WriteLength, mMaxWriteData);
   SendData     = AllocateZeroPool (SendDataSize);
   if (SendData == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
 
   ((IPMI_BLOB_TRANSFER_BLOB_WRITE_SEND_DATA *)SendData)->SessionId = SessionId;
-  ((IPMI_BLOB_TRANSFER_BLOB_WRITE_SEND_DATA *)SendData)->Offset    = Offset;
-  CopyMem (((IPMI_BLOB_TRANSFER_BLOB_WRITE_SEND_DATA *)SendData)->Data, Data, sizeof (UINT8) * WriteLength);
+  do {
+    ChunkSize = MIN (WriteLength, mMaxWriteData);
+    ((IPMI_BLOB_TRANSFER_BLOB_WRITE_SEND_DATA *)SendData)->Offset = Offset;
+    CopyMem (((IPMI_BLOB_TRANSFER_BLOB_WRITE_SEND_DATA *)SendData)->Data, Data, sizeof (UINT8) * ChunkSize);
+
+    ResponseDataSize = 0;
+    Status           = IpmiBlobTransferSendIpmi (
+                         IpmiBlobTransferSubcommandWrite,
+                         SendData,
+                         sizeof (SessionId) + sizeof (Offset) + ChunkSize,
+                         NULL,
+                         &ResponseDataSize
+                         );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: write of %u bytes at 0x%x failed: %r\n", __FUNCTION__, ChunkSize, Offset, Status));
+      break;
+    }
 
-  ResponseDataSize = 0;
-  Status           = IpmiBlobTransferSendIpmi (IpmiBlobTransferSubcommandWrite, SendData, SendDataSize, NULL, &ResponseDataSize);
+    Data        += ChunkSize;
+    Offset      += ChunkSize;
+    WriteLength -= ChunkSize;
+  } while (WriteLength > 0);
 
   FreePool (SendData);
   return Status;
@@ -659,7 +834,7 @@ IpmiBlobTransferStat (
     *Size           = ((IPMI_BLOB_TRANSFER_BLOB_STAT_RESPONSE *)ResponseData)->Size;
     *MetadataLength = ((IPMI_BLOB_TRANSFER_BLOB_STAT_RESPONSE *)ResponseData)->MetaDataLen;
 
-    CopyMem (&Metadata, &((IPMI_BLOB_TRANSFER_BLOB_STAT_RESPONSE *)ResponseData)->MetaData, sizeof (((IPMI_BLOB_TRANSFER_BLOB_STAT_RESPONSE *)ResponseData)->MetaData));
+    CopyMem (Metadata, ((IPMI_BLOB_TRANSFER_BLOB_STAT_RESPONSE *)ResponseData)->MetaData, MIN (*MetadataLength, sizeof (((IPMI_BLOB_TRANSFER_BLOB_STAT_RESPONSE *)ResponseData)->MetaData)));
   }
 
   FreePool (ResponseData);
@@ -721,7 +896,7 @@ IpmiBlobTransferSessionStat (
     *Size           = ((IPMI_BLOB_TRANSFER_BLOB_SESSION_STAT_RESPONSE *)ResponseData)->Size;
     *MetadataLength = ((IPMI_BLOB_TRANSFER_BLOB_SESSION_STAT_RESPONSE *)ResponseData)->MetaDataLen;
 
-    CopyMem (&Metadata, &((IPMI_BLOB_TRANSFER_BLOB_SESSION_STAT_RESPONSE *)ResponseData)->MetaData, sizeof (((IPMI_BLOB_TRANSFER_BLOB_SESSION_STAT_RESPONSE *)ResponseData)->MetaData));
+    CopyMem (Metadata, ((IPMI_BLOB_TRANSFER_BLOB_SESSION_STAT_RESPONSE *)ResponseData)->MetaData, MIN (*MetadataLength, sizeof (((IPMI_BLOB_TRANSFER_BLOB_SESSION_STAT_RESPONSE *)ResponseData)->MetaData)));
   }
 
   FreePool (ResponseData);
@@ -58,6 +58,17 @@ UINT8  ValidNoDataResponse[] = {
 
 #define VALID_NODATA_RESPONSE_SIZE  4 * sizeof(UINT8)
 
+UINT8  SsifCapabilitiesResponse[] = {
+  0x00,             // CompletionCode
+  0x00,             // Reserved
+  0xC0,             // Multi-part read/write with middle transaction
+  0xFF,             // Input message size
+  0xFF,             // Output message size
+};
+#define SSIF_CAPABILITIES_RESPONSE_SIZE  5 * sizeof(UINT8)
+
+#define TRANSFER_TEST_SIZE  SIZE_1MB
+
 /**
   @param[in]  Context    [Optional] An optional parameter that enables:
                          1) test-case reuse with varied parameters and
@@ -817,6 +828,7 @@ BlobStatValidResponse (
   MetadataLength   = AllocateZeroPool (sizeof (UINT8));
   Metadata         = AllocateZeroPool (4 * sizeof (UINT8));
   ExpectedMetadata = AllocateZeroPool (4 * sizeof (UINT8));
+  CopyMem (ExpectedMetadata, &ValidBlobStatResponse[13], 4);
 
   MockResponseResults = (UINT8 *)AllocateZeroPool (sizeof (VALID_BLOB_STAT_RESPONSE_SIZE));
   CopyMem (MockResponseResults, &ValidBlobStatResponse, VALID_BLOB_STAT_RESPONSE_SIZE);
@@ -910,6 +922,7 @@ SessionStatValidResponse (
   MetadataLength   = AllocateZeroPool (sizeof (UINT8));
   Metadata         = AllocateZeroPool (4 * sizeof (UINT8));
   ExpectedMetadata = AllocateZeroPool (4 * sizeof (UINT8));
+  CopyMem (ExpectedMetadata, &ValidBlobStatResponse[13], 4);
 
   MockResponseResults = (UINT8 *)AllocateZeroPool (sizeof (VALID_BLOB_STAT_RESPONSE_SIZE));
   CopyMem (MockResponseResults, &ValidBlobStatResponse, VALID_BLOB_STAT_RESPONSE_SIZE);
@@ -1008,6 +1021,137 @@ WriteMetaValidResponse (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Write 1MB to a blob with the default packet size and with the packet size
+  reported by an SSIF BMC, and report the IPMI round trips used by each.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+WriteRoundTrips (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       *SendData;
+  UINT32      MaxWriteData;
+  UINTN       DefaultRoundTrips;
+  UINTN       SsifRoundTrips;
+
+  SendData = AllocateZeroPool (TRANSFER_TEST_SIZE);
+  UT_ASSERT_NOT_NULL (SendData);
+
+  //
+  // BMC rejects all of the capability commands
+  //
+  IpmiStubDeInit ();
+  MockIpmiSubmitCommand (InvalidCompletion, INVALID_COMPLETION_SIZE, EFI_SUCCESS);
+  MockIpmiSubmitCommand (InvalidCompletion, INVALID_COMPLETION_SIZE, EFI_SUCCESS);
+  MockIpmiSubmitCommand (InvalidCompletion, INVALID_COMPLETION_SIZE, EFI_SUCCESS);
+  IpmiBlobTransferDiscoverPacketSize (&MaxWriteData, NULL);
+  UT_ASSERT_EQUAL (MaxWriteData, IPMI_OEM_BLOB_MAX_DATA_PER_PACKET);
+
+  MockIpmiSubmitCommandDefault (ValidNoDataResponse, VALID_NODATA_RESPONSE_SIZE, EFI_SUCCESS);
+  DefaultRoundTrips = MockIpmiGetSubmitCount ();
+  Status            = IpmiBlobTransferWrite (0, 0, SendData, TRANSFER_TEST_SIZE);
+  DefaultRoundTrips = MockIpmiGetSubmitCount () - DefaultRoundTrips;
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+  UT_ASSERT_EQUAL (DefaultRoundTrips, TRANSFER_TEST_SIZE / IPMI_OEM_BLOB_MAX_DATA_PER_PACKET);
+
+  //
+  // SSIF BMC accepts 255 byte messages
+  //
+  MockIpmiSubmitCommand (SsifCapabilitiesResponse, SSIF_CAPABILITIES_RESPONSE_SIZE, EFI_SUCCESS);
+  IpmiBlobTransferDiscoverPacketSize (&MaxWriteData, NULL);
+  UT_ASSERT_EQUAL (MaxWriteData, 0xFF - 2 - sizeof (IPMI_BLOB_TRANSFER_HEADER) - sizeof (UINT16) - sizeof (UINT16) - sizeof (UINT32));
+
+  SsifRoundTrips = MockIpmiGetSubmitCount ();
+  Status         = IpmiBlobTransferWrite (0, 0, SendData, TRANSFER_TEST_SIZE);
+  SsifRoundTrips = MockIpmiGetSubmitCount () - SsifRoundTrips;
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+  UT_ASSERT_EQUAL (SsifRoundTrips, (TRANSFER_TEST_SIZE + MaxWriteData - 1) / MaxWriteData);
+
+  UT_LOG_INFO ("IPMI round trips per MB: %u with %u byte packets, %u with %u byte packets\n", DefaultRoundTrips, IPMI_OEM_BLOB_MAX_DATA_PER_PACKET, SsifRoundTrips, MaxWriteData);
+
+  MockIpmiSubmitCommandDefault (NULL, 0, EFI_SUCCESS);
+  FreePool (SendData);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Read across several packets, ending on a short read.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ReadMultiplePackets (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       FirstResponse[PROTOCOL_RESPONSE_OVERHEAD + sizeof (UINT16) + IPMI_OEM_BLOB_MAX_DATA_PER_PACKET];
+  UINT8       LastResponse[PROTOCOL_RESPONSE_OVERHEAD + sizeof (UINT16) + 8];
+  UINT8       Expected[IPMI_OEM_BLOB_MAX_DATA_PER_PACKET + 8];
+  UINT8       ReadData[2 * IPMI_OEM_BLOB_MAX_DATA_PER_PACKET];
+  UINT16      Crc;
+  UINTN       Index;
+  UINTN       RoundTrips;
+
+  for (Index = 0; Index < sizeof (Expected); Index++) {
+    Expected[Index] = (UINT8)Index;
+  }
+
+  CopyMem (FirstResponse, ValidNoDataResponse, VALID_NODATA_RESPONSE_SIZE);
+  CopyMem (&FirstResponse[PROTOCOL_RESPONSE_OVERHEAD + sizeof (UINT16)], Expected, IPMI_OEM_BLOB_MAX_DATA_PER_PACKET);
+  Crc = CalculateCrc16 (Expected, IPMI_OEM_BLOB_MAX_DATA_PER_PACKET);
+  CopyMem (&FirstResponse[PROTOCOL_RESPONSE_OVERHEAD], &Crc, sizeof (Crc));
+
+  CopyMem (LastResponse, ValidNoDataResponse, VALID_NODATA_RESPONSE_SIZE);
+  CopyMem (&LastResponse[PROTOCOL_RESPONSE_OVERHEAD + sizeof (UINT16)], &Expected[IPMI_OEM_BLOB_MAX_DATA_PER_PACKET], 8);
+  Crc = CalculateCrc16 (&Expected[IPMI_OEM_BLOB_MAX_DATA_PER_PACKET], 8);
+  CopyMem (&LastResponse[PROTOCOL_RESPONSE_OVERHEAD], &Crc, sizeof (Crc));
+
+  //
+  // Mock responses are returned last in, first out
+  //
+  IpmiStubDeInit ();
+  MockIpmiSubmitCommand (InvalidCompletion, INVALID_COMPLETION_SIZE, EFI_SUCCESS);
+  MockIpmiSubmitCommand (InvalidCompletion, INVALID_COMPLETION_SIZE, EFI_SUCCESS);
+  MockIpmiSubmitCommand (InvalidCompletion, INVALID_COMPLETION_SIZE, EFI_SUCCESS);
+  IpmiBlobTransferDiscoverPacketSize (NULL, NULL);
+
+  MockIpmiSubmitCommand (LastResponse, sizeof (LastResponse), EFI_SUCCESS);
+  MockIpmiSubmitCommand (FirstResponse, sizeof (FirstResponse), EFI_SUCCESS);
+  RoundTrips = MockIpmiGetSubmitCount ();
+  Status     = IpmiBlobTransferRead (0, 0, sizeof (ReadData), ReadData);
+  RoundTrips = MockIpmiGetSubmitCount () - RoundTrips;
+
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+  UT_ASSERT_EQUAL (RoundTrips, 2);
+  UT_ASSERT_MEM_EQUAL (ReadData, Expected, sizeof (Expected));
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Initialize the unit test framework, suite, and unit tests for the
   sample unit tests and run the unit tests.
@@ -1066,6 +1210,8 @@ SetupAndRunUnitTests (
   Status = AddTestCase (IpmiBlobTransfer, "Read call with invalid buffer", "ReadInvalidBuffer", ReadInvalidBuffer, NULL, NULL, NULL);
   // IpmiBlobTransferWrite
   Status = AddTestCase (IpmiBlobTransfer, "Write call with valid data", "WriteValidResponse", WriteValidResponse, NULL, NULL, NULL);
+  Status = AddTestCase (IpmiBlobTransfer, "Write call sized to the transport", "WriteRoundTrips", WriteRoundTrips, NULL, NULL, NULL);
+  Status = AddTestCase (IpmiBlobTransfer, "Read call across multiple packets", "ReadMultiplePackets", ReadMultiplePackets, NULL, NULL, NULL);
   // IpmiBlobTransferCommit
   Status = AddTestCase (IpmiBlobTransfer, "Commit call with valid data", "CommitValidResponse", CommitValidResponse, NULL, NULL, NULL);
   // IpmiBlobTransferClose
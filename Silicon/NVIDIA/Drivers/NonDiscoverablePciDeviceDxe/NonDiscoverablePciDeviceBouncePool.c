@@ -0,0 +1,220 @@
+/** @file
+
+  Bounce buffer and map info pool for non-coherent DMA mappings
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "NonDiscoverablePciDeviceBouncePool.h"
+
+/**
+  Initialize a bounce pool with all map info slots free and no buffers.
+
+  The pool does no locking, the caller must serialize access to it.
+
+  @param[out] Pool      Bounce pool
+
+**/
+VOID
+BouncePoolInit (
+  OUT BOUNCE_POOL  *Pool
+  )
+{
+  UINTN  Index;
+
+  ZeroMem (Pool, sizeof (*Pool));
+
+  for (Index = 0; Index < BOUNCE_POOL_MAP_INFO_SLOTS; Index++) {
+    Pool->MapInfo[Index].NextFree = Pool->FreeMapInfo;
+    Pool->FreeMapInfo             = &Pool->MapInfo[Index];
+  }
+}
+
+/**
+  Add a class of bounce buffer slots to the pool.
+
+  Buffer is owned by the caller and must already have the attributes needed
+  for DMA; it is split into SlotCount slots of SlotSize bytes.
+
+  @param[in, out] Pool        Bounce pool
+  @param[in]      Buffer      Buffer of SlotSize * SlotCount bytes
+  @param[in]      SlotSize    Size of each slot
+  @param[in]      SlotCount   Number of slots
+
+  @retval EFI_SUCCESS             Class added
+  @retval EFI_INVALID_PARAMETER   SlotSize or SlotCount is invalid
+  @retval EFI_OUT_OF_RESOURCES    The pool has no room for another class
+
+**/
+EFI_STATUS
+BouncePoolAddClass (
+  IN OUT BOUNCE_POOL  *Pool,
+  IN     VOID         *Buffer,
+  IN     UINTN        SlotSize,
+  IN     UINTN        SlotCount
+  )
+{
+  BOUNCE_POOL_CLASS  *Class;
+  UINTN              Index;
+
+  if ((Buffer == NULL) || (SlotSize == 0) ||
+      (SlotCount == 0) || (SlotCount > BOUNCE_POOL_MAX_SLOTS))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Pool->ClassCount == BOUNCE_POOL_MAX_CLASSES) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Keep the classes sorted by slot size so the first class that fits is
+  // the smallest one.
+  //
+  for (Index = Pool->ClassCount; Index > 0; Index--) {
+    if (Pool->Classes[Index - 1].SlotSize <= SlotSize) {
+      break;
+    }
+
+    CopyMem (&Pool->Classes[Index], &Pool->Classes[Index - 1], sizeof (Pool->Classes[Index]));
+  }
+
+  Class            = &Pool->Classes[Index];
+  Class->Base      = Buffer;
+  Class->SlotSize  = SlotSize;
+  Class->SlotCount = SlotCount;
+  Class->FreeCount = SlotCount;
+  for (Index = 0; Index < SlotCount; Index++) {
+    Class->FreeSlots[Index] = (UINT8)(SlotCount - Index - 1);
+  }
+
+  Pool->ClassCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Take a bounce buffer from the smallest class that fits and has a free slot.
+
+  @param[in, out] Pool            Bounce pool
+  @param[in]      NumberOfBytes   Bytes needed
+
+  @retval NULL    No free slot is large enough
+  @retval Other   Bounce buffer
+
+**/
+VOID *
+BouncePoolAcquireBuffer (
+  IN OUT BOUNCE_POOL  *Pool,
+  IN     UINTN        NumberOfBytes
+  )
+{
+  BOUNCE_POOL_CLASS  *Class;
+  UINTN              Index;
+  UINTN              Slot;
+
+  for (Index = 0; Index < Pool->ClassCount; Index++) {
+    Class = &Pool->Classes[Index];
+    if ((Class->SlotSize >= NumberOfBytes) && (Class->FreeCount != 0)) {
+      Slot = Class->FreeSlots[--Class->FreeCount];
+      return Class->Base + Slot * Class->SlotSize;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Return a bounce buffer to the pool.
+
+  @param[in, out] Pool      Bounce pool
+  @param[in]      Buffer    Buffer to return
+
+  @retval TRUE    Buffer returned to the pool
+  @retval FALSE   Buffer was not taken from the pool
+
+**/
+BOOLEAN
+BouncePoolReleaseBuffer (
+  IN OUT BOUNCE_POOL  *Pool,
+  IN     VOID         *Buffer
+  )
+{
+  BOUNCE_POOL_CLASS  *Class;
+  UINTN              Index;
+  UINTN              Offset;
+
+  for (Index = 0; Index < Pool->ClassCount; Index++) {
+    Class = &Pool->Classes[Index];
+    if (((UINT8 *)Buffer < Class->Base) ||
+        ((UINT8 *)Buffer >= Class->Base + Class->SlotSize * Class->SlotCount))
+    {
+      continue;
+    }
+
+    Offset = (UINT8 *)Buffer - Class->Base;
+    ASSERT ((Offset % Class->SlotSize) == 0);
+    ASSERT (Class->FreeCount < Class->SlotCount);
+
+    Class->FreeSlots[Class->FreeCount++] = (UINT8)(Offset / Class->SlotSize);
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**
+  Take a map info from the pool, allocating one if all slots are in use.
+
+  @param[in, out] Pool      Bounce pool
+
+  @retval NULL    Allocation failed
+  @retval Other   Map info
+
+**/
+NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO *
+BouncePoolAcquireMapInfo (
+  IN OUT BOUNCE_POOL  *Pool
+  )
+{
+  NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO  *MapInfo;
+
+  MapInfo = Pool->FreeMapInfo;
+  if (MapInfo != NULL) {
+    Pool->FreeMapInfo = MapInfo->NextFree;
+    return MapInfo;
+  }
+
+  return AllocatePool (sizeof (*MapInfo));
+}
+
+/**
+  Return a map info to the pool, or free it if it was allocated.
+
+  @param[in, out] Pool      Bounce pool
+  @param[in]      MapInfo   Map info to return
+
+**/
+VOID
+BouncePoolReleaseMapInfo (
+  IN OUT BOUNCE_POOL                           *Pool,
+  IN     NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO  *MapInfo
+  )
+{
+  if ((MapInfo < &Pool->MapInfo[0]) ||
+      (MapInfo >= &Pool->MapInfo[BOUNCE_POOL_MAP_INFO_SLOTS]))
+  {
+    FreePool (MapInfo);
+    return;
+  }
+
+  MapInfo->NextFree = Pool->FreeMapInfo;
+  Pool->FreeMapInfo = MapInfo;
+}
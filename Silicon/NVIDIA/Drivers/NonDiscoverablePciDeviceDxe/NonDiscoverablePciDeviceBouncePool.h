@@ -0,0 +1,153 @@
+/** @file
+
+  Bounce buffer and map info pool for non-coherent DMA mappings
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __NON_DISCOVERABLE_PCI_DEVICE_BOUNCE_POOL_H__
+#define __NON_DISCOVERABLE_PCI_DEVICE_BOUNCE_POOL_H__
+
+#include <Uefi.h>
+#include <Protocol/PciIo.h>
+
+#define BOUNCE_POOL_MAX_CLASSES     4
+#define BOUNCE_POOL_MAX_SLOTS       64
+#define BOUNCE_POOL_MAP_INFO_SLOTS  64
+
+typedef struct _NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO;
+
+struct _NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO {
+  EFI_PHYSICAL_ADDRESS                    AllocAddress;
+  VOID                                    *HostAddress;
+  EFI_PCI_IO_PROTOCOL_OPERATION           Operation;
+  UINTN                                   NumberOfBytes;
+
+  // next free map info while in the pool
+  NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO    *NextFree;
+};
+
+//
+// Bounce buffer slots of one size, carved from a single uncached allocation
+//
+typedef struct {
+  UINT8    *Base;
+  UINTN    SlotSize;
+  UINTN    SlotCount;
+
+  // stack of free slot indices
+  UINTN    FreeCount;
+  UINT8    FreeSlots[BOUNCE_POOL_MAX_SLOTS];
+} BOUNCE_POOL_CLASS;
+
+typedef struct {
+  // set once the owner has tried to populate the buffer classes
+  BOOLEAN                                 Populated;
+
+  UINTN                                   ClassCount;
+  BOUNCE_POOL_CLASS                       Classes[BOUNCE_POOL_MAX_CLASSES];
+
+  NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO    *FreeMapInfo;
+  NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO    MapInfo[BOUNCE_POOL_MAP_INFO_SLOTS];
+} BOUNCE_POOL;
+
+/**
+  Initialize a bounce pool with all map info slots free and no buffers.
+
+  The pool does no locking, the caller must serialize access to it.
+
+  @param[out] Pool      Bounce pool
+
+**/
+VOID
+BouncePoolInit (
+  OUT BOUNCE_POOL  *Pool
+  );
+
+/**
+  Add a class of bounce buffer slots to the pool.
+
+  Buffer is owned by the caller and must already have the attributes needed
+  for DMA; it is split into SlotCount slots of SlotSize bytes.
+
+  @param[in, out] Pool        Bounce pool
+  @param[in]      Buffer      Buffer of SlotSize * SlotCount bytes
+  @param[in]      SlotSize    Size of each slot
+  @param[in]      SlotCount   Number of slots
+
+  @retval EFI_SUCCESS             Class added
+  @retval EFI_INVALID_PARAMETER   SlotSize or SlotCount is invalid
+  @retval EFI_OUT_OF_RESOURCES    The pool has no room for another class
+
+**/
+EFI_STATUS
+BouncePoolAddClass (
+  IN OUT BOUNCE_POOL  *Pool,
+  IN     VOID         *Buffer,
+  IN     UINTN        SlotSize,
+  IN     UINTN        SlotCount
+  );
+
+/**
+  Take a bounce buffer from the smallest class that fits and has a free slot.
+
+  @param[in, out] Pool            Bounce pool
+  @param[in]      NumberOfBytes   Bytes needed
+
+  @retval NULL    No free slot is large enough
+  @retval Other   Bounce buffer
+
+**/
+VOID *
+BouncePoolAcquireBuffer (
+  IN OUT BOUNCE_POOL  *Pool,
+  IN     UINTN        NumberOfBytes
+  );
+
+/**
+  Return a bounce buffer to the pool.
+
+  @param[in, out] Pool      Bounce pool
+  @param[in]      Buffer    Buffer to return
+
+  @retval TRUE    Buffer returned to the pool
+  @retval FALSE   Buffer was not taken from the pool
+
+**/
+BOOLEAN
+BouncePoolReleaseBuffer (
+  IN OUT BOUNCE_POOL  *Pool,
+  IN     VOID         *Buffer
+  );
+
+/**
+  Take a map info from the pool, allocating one if all slots are in use.
+
+  @param[in, out] Pool      Bounce pool
+
+  @retval NULL    Allocation failed
+  @retval Other   Map info
+
+**/
+NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO *
+BouncePoolAcquireMapInfo (
+  IN OUT BOUNCE_POOL  *Pool
+  );
+
+/**
+  Return a map info to the pool, or free it if it was allocated.
+
+  @param[in, out] Pool      Bounce pool
+  @param[in]      MapInfo   Map info to return
+
+**/
+VOID
+BouncePoolReleaseMapInfo (
+  IN OUT BOUNCE_POOL                           *Pool,
+  IN     NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO  *MapInfo
+  );
+
+#endif
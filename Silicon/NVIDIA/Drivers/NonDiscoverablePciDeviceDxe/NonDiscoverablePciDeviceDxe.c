@@ -1,7 +1,7 @@
 /** @file
 
   Copyright (C) 2016, Linaro Ltd. All rights reserved.<BR>
-  Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2021-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -258,6 +258,7 @@ NonDiscoverablePciDeviceStop (
          DeviceHandle
          );
 
+  UninitializePciIoProtocol (Dev);
   FreePool (Dev);
 
   return EFI_SUCCESS;
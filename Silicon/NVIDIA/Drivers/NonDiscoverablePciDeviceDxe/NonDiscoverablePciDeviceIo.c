@@ -2,7 +2,7 @@
 
   Copyright (c) 2008 - 2009, Apple Inc. All rights reserved.<BR>
   Copyright (c) 2016, Linaro, Ltd. All rights reserved.<BR>
-  Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2021-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -20,11 +20,19 @@
 #include <PlatformToDriverStructures.h>
 
 typedef struct {
-  EFI_PHYSICAL_ADDRESS             AllocAddress;
-  VOID                             *HostAddress;
-  EFI_PCI_IO_PROTOCOL_OPERATION    Operation;
-  UINTN                            NumberOfBytes;
-} NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO;
+  UINTN    SlotSize;
+  UINTN    SlotCount;
+} NON_DISCOVERABLE_BOUNCE_CLASS_CONFIG;
+
+//
+// Bounce buffers allocated the first time a device needs to bounce a
+// mapping. Transfers too large for these, or made while all slots are in
+// use, get their own bounce buffer as before.
+//
+STATIC CONST NON_DISCOVERABLE_BOUNCE_CLASS_CONFIG  mBounceClasses[] = {
+  { SIZE_4KB,  32 },
+  { SIZE_64KB, 8 },
+};
 
 /**
   Get the resource associated with BAR number 'BarIndex'.
@@ -1148,6 +1156,90 @@ FreeBuffer:
   return Status;
 }
 
+/**
+  Take a bounce buffer from the device's bounce pool, allocating the pool
+  the first time it is needed.
+
+  @param  Dev                   Point to the NON_DISCOVERABLE_PCI_DEVICE instance.
+  @param  NumberOfBytes         The number of bytes to bounce.
+
+  @retval NULL                  No pooled bounce buffer is available.
+  @retval Other                 The uncached bounce buffer.
+
+**/
+STATIC
+VOID *
+NonCoherentPciIoAcquireBounceBuffer (
+  IN NON_DISCOVERABLE_PCI_DEVICE  *Dev,
+  IN UINTN                        NumberOfBytes
+  )
+{
+  EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
+  BOOLEAN     Populate;
+  UINTN       Index;
+  UINTN       Pages;
+  VOID        *Buffer;
+
+  OldTpl                    = gBS->RaiseTPL (TPL_NOTIFY);
+  Populate                  = !Dev->BouncePool.Populated;
+  Dev->BouncePool.Populated = TRUE;
+  gBS->RestoreTPL (OldTpl);
+
+  //
+  // The pool is allocated and its memory attributes set outside of the
+  // raised TPL section; classes are added one at a time as they are ready.
+  //
+  if (Populate) {
+    for (Index = 0; Index < ARRAY_SIZE (mBounceClasses); Index++) {
+      Pages  = EFI_SIZE_TO_PAGES (mBounceClasses[Index].SlotSize * mBounceClasses[Index].SlotCount);
+      Status = NonCoherentPciIoAllocateBuffer (
+                 &Dev->PciIo,
+                 AllocateAnyPages,
+                 EfiBootServicesData,
+                 Pages,
+                 &Buffer,
+                 EFI_PCI_ATTRIBUTE_MEMORY_WRITE_COMBINE
+                 );
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_WARN, "%a: failed to allocate bounce pool: %r\n", __FUNCTION__, Status));
+        continue;
+      }
+
+      OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+      Status = BouncePoolAddClass (
+                 &Dev->BouncePool,
+                 Buffer,
+                 mBounceClasses[Index].SlotSize,
+                 mBounceClasses[Index].SlotCount
+                 );
+      gBS->RestoreTPL (OldTpl);
+      if (EFI_ERROR (Status)) {
+        NonCoherentPciIoFreeBuffer (&Dev->PciIo, Pages, Buffer);
+      }
+    }
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  Buffer = BouncePoolAcquireBuffer (&Dev->BouncePool, NumberOfBytes);
+
+  //
+  // The pool may have been allocated above 4 GB before the dual address
+  // cycle attribute was cleared.
+  //
+  if ((Buffer != NULL) &&
+      ((Dev->Attributes & EFI_PCI_IO_ATTRIBUTE_DUAL_ADDRESS_CYCLE) == 0) &&
+      ((EFI_PHYSICAL_ADDRESS)(UINTN)Buffer + NumberOfBytes > SIZE_4GB))
+  {
+    BouncePoolReleaseBuffer (&Dev->BouncePool, Buffer);
+    Buffer = NULL;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return Buffer;
+}
+
 /**
   Provides the PCI controller-specific addresses needed to access system memory.
 
@@ -1186,6 +1278,7 @@ NonCoherentPciIoMap (
   VOID                                  *AllocAddress;
   EFI_GCD_MEMORY_SPACE_DESCRIPTOR       GcdDescriptor;
   BOOLEAN                               Bounce;
+  EFI_TPL                               OldTpl;
 
   if ((HostAddress   == NULL) ||
       (NumberOfBytes == NULL) ||
@@ -1202,7 +1295,11 @@ NonCoherentPciIoMap (
     return EFI_INVALID_PARAMETER;
   }
 
-  MapInfo = AllocatePool (sizeof *MapInfo);
+  Dev = NON_DISCOVERABLE_PCI_DEVICE_FROM_PCI_IO (This);
+
+  OldTpl  = gBS->RaiseTPL (TPL_NOTIFY);
+  MapInfo = BouncePoolAcquireMapInfo (&Dev->BouncePool);
+  gBS->RestoreTPL (OldTpl);
   if (MapInfo == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -1211,8 +1308,6 @@ NonCoherentPciIoMap (
   MapInfo->Operation     = Operation;
   MapInfo->NumberOfBytes = *NumberOfBytes;
 
-  Dev = NON_DISCOVERABLE_PCI_DEVICE_FROM_PCI_IO (This);
-
   //
   // If this device does not support 64-bit DMA addressing, we need to allocate
   // a bounce buffer and copy over the data in case HostAddress >= 4 GB.
@@ -1262,16 +1357,23 @@ NonCoherentPciIoMap (
       goto FreeMapInfo;
     }
 
-    Status = NonCoherentPciIoAllocateBuffer (
-               This,
-               AllocateAnyPages,
-               EfiBootServicesData,
-               EFI_SIZE_TO_PAGES (MapInfo->NumberOfBytes),
-               &AllocAddress,
-               EFI_PCI_ATTRIBUTE_MEMORY_WRITE_COMBINE
-               );
-    if (EFI_ERROR (Status)) {
-      goto FreeMapInfo;
+    //
+    // Pooled bounce buffers are already uncached, so only the bytes being
+    // transferred are copied and no cache maintenance is needed.
+    //
+    AllocAddress = NonCoherentPciIoAcquireBounceBuffer (Dev, MapInfo->NumberOfBytes);
+    if (AllocAddress == NULL) {
+      Status = NonCoherentPciIoAllocateBuffer (
+                 This,
+                 AllocateAnyPages,
+                 EfiBootServicesData,
+                 EFI_SIZE_TO_PAGES (MapInfo->NumberOfBytes),
+                 &AllocAddress,
+                 EFI_PCI_ATTRIBUTE_MEMORY_WRITE_COMBINE
+                 );
+      if (EFI_ERROR (Status)) {
+        goto FreeMapInfo;
+      }
     }
 
     MapInfo->AllocAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)AllocAddress;
@@ -1306,7 +1408,9 @@ NonCoherentPciIoMap (
   return EFI_SUCCESS;
 
 FreeMapInfo:
-  FreePool (MapInfo);
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  BouncePoolReleaseMapInfo (&Dev->BouncePool, MapInfo);
+  gBS->RestoreTPL (OldTpl);
 
   return Status;
 }
@@ -1328,12 +1432,16 @@ NonCoherentPciIoUnmap (
   IN  VOID                 *Mapping
   )
 {
+  NON_DISCOVERABLE_PCI_DEVICE           *Dev;
   NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO  *MapInfo;
+  BOOLEAN                               Pooled;
+  EFI_TPL                               OldTpl;
 
   if (Mapping == NULL) {
     return EFI_DEVICE_ERROR;
   }
 
+  Dev     = NON_DISCOVERABLE_PCI_DEVICE_FROM_PCI_IO (This);
   MapInfo = Mapping;
   if (MapInfo->AllocAddress != 0) {
     //
@@ -1348,11 +1456,17 @@ NonCoherentPciIoUnmap (
              );
     }
 
-    NonCoherentPciIoFreeBuffer (
-      This,
-      EFI_SIZE_TO_PAGES (MapInfo->NumberOfBytes),
-      (VOID *)(UINTN)MapInfo->AllocAddress
-      );
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    Pooled = BouncePoolReleaseBuffer (&Dev->BouncePool, (VOID *)(UINTN)MapInfo->AllocAddress);
+    gBS->RestoreTPL (OldTpl);
+
+    if (!Pooled) {
+      NonCoherentPciIoFreeBuffer (
+        This,
+        EFI_SIZE_TO_PAGES (MapInfo->NumberOfBytes),
+        (VOID *)(UINTN)MapInfo->AllocAddress
+        );
+    }
   } else {
     //
     // We are *not* using a bounce buffer: if this is a bus master write,
@@ -1369,7 +1483,10 @@ NonCoherentPciIoUnmap (
     }
   }
 
-  FreePool (MapInfo);
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  BouncePoolReleaseMapInfo (&Dev->BouncePool, MapInfo);
+  gBS->RestoreTPL (OldTpl);
+
   return EFI_SUCCESS;
 }
 
@@ -1837,6 +1954,7 @@ InitializePciIoProtocol (
   INTN                               Idx;
 
   InitializeListHead (&Dev->UncachedAllocationList);
+  BouncePoolInit (&Dev->BouncePool);
 
   Dev->ConfigSpace.Hdr.VendorId = PCI_ID_VENDOR_UNKNOWN;
   Dev->ConfigSpace.Hdr.DeviceId = PCI_ID_DEVICE_DONTCARE;
@@ -1894,3 +2012,30 @@ InitializePciIoProtocol (
     Idx++;
   }
 }
+
+/**
+  Release the resources InitializePciIoProtocol and the PciIo protocol
+  acquired for a device.
+
+  @param  Dev               Point to NON_DISCOVERABLE_PCI_DEVICE instance.
+
+**/
+VOID
+UninitializePciIoProtocol (
+  NON_DISCOVERABLE_PCI_DEVICE  *Dev
+  )
+{
+  BOUNCE_POOL_CLASS  *Class;
+  UINTN              Index;
+
+  for (Index = 0; Index < Dev->BouncePool.ClassCount; Index++) {
+    Class = &Dev->BouncePool.Classes[Index];
+    NonCoherentPciIoFreeBuffer (
+      &Dev->PciIo,
+      EFI_SIZE_TO_PAGES (Class->SlotSize * Class->SlotCount),
+      Class->Base
+      );
+  }
+
+  Dev->BouncePool.ClassCount = 0;
+}
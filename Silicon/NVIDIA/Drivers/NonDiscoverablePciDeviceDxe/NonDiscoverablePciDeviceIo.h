@@ -1,7 +1,7 @@
 /** @file
 
   Copyright (C) 2016, Linaro Ltd. All rights reserved.<BR>
-  Copyright (c) 2021-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2021-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -25,6 +25,8 @@
 #include <Protocol/Cpu.h>
 #include <Protocol/PciIo.h>
 
+#include "NonDiscoverablePciDeviceBouncePool.h"
+
 #define NON_DISCOVERABLE_PCI_DEVICE_SIG  SIGNATURE_32 ('P', 'P', 'I', 'D')
 
 #define NON_DISCOVERABLE_PCI_DEVICE_FROM_PCI_IO(PciIoPointer) \
@@ -99,6 +101,10 @@ typedef struct {
   //
   LIST_ENTRY                 UncachedAllocationList;
   //
+  // Pre-allocated bounce buffers and map infos for non-coherent DMA
+  //
+  BOUNCE_POOL                BouncePool;
+  //
   // Unique ID for this device instance: needed so that we can report unique
   // segment/bus/device number for each device instance. Note that this number
   // may change when disconnecting/reconnecting the driver.
@@ -119,6 +125,18 @@ InitializePciIoProtocol (
   EFI_HANDLE                   ControllerHandle
   );
 
+/**
+  Release the resources InitializePciIoProtocol and the PciIo protocol
+  acquired for a device.
+
+  @param  Device            Point to NON_DISCOVERABLE_PCI_DEVICE instance.
+
+**/
+VOID
+UninitializePciIoProtocol (
+  NON_DISCOVERABLE_PCI_DEVICE  *Device
+  );
+
 extern EFI_COMPONENT_NAME_PROTOCOL   gComponentName;
 extern EFI_COMPONENT_NAME2_PROTOCOL  gComponentName2;
 
@@ -0,0 +1,504 @@
+/** @file
+
+  Non-discoverable PCI device bounce pool unit test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../NonDiscoverablePciDeviceBouncePool.h"
+
+#define UNIT_TEST_NAME     "Non-discoverable PCI Device Bounce Pool Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_SMALL_SLOT_SIZE     SIZE_4KB
+#define TEST_SMALL_SLOT_COUNT    32
+#define TEST_LARGE_SLOT_SIZE     SIZE_64KB
+#define TEST_LARGE_SLOT_COUNT    8
+#define TEST_MAX_MAPPINGS        80
+#define TEST_STRESS_ITERATIONS   20000
+#define TEST_MAX_TRANSFER_BYTES  SIZE_256KB
+
+typedef struct {
+  NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO    *MapInfo;
+  UINT8                                   Seed;
+} TEST_MAPPING;
+
+STATIC BOUNCE_POOL   mPool;
+STATIC UINT8         *mSmallBuffer;
+STATIC UINT8         *mLargeBuffer;
+STATIC UINT32        mRandom;
+STATIC TEST_MAPPING  mMappings[TEST_MAX_MAPPINGS];
+STATIC UINTN         mMappingCount;
+STATIC UINTN         mPooledMaps;
+STATIC UINTN         mAllocatedMaps;
+
+/**
+  Simple linear congruential generator, so runs are repeatable.
+
+  @retval Next pseudo-random number
+**/
+STATIC
+UINT32
+TestRandom (
+  VOID
+  )
+{
+  mRandom = mRandom * 1103515245 + 12345;
+  return mRandom >> 8;
+}
+
+/**
+  Fill a buffer with a pattern derived from Seed.
+
+  @param[out] Buffer        Buffer to fill
+  @param[in]  Size          Size of Buffer
+  @param[in]  Seed          Pattern seed
+**/
+STATIC
+VOID
+TestFill (
+  OUT UINT8  *Buffer,
+  IN  UINTN  Size,
+  IN  UINT8  Seed
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    Buffer[Index] = (UINT8)(Seed + Index * 7);
+  }
+}
+
+/**
+  Check a buffer holds the pattern derived from Seed.
+
+  @param[in]  Buffer        Buffer to check
+  @param[in]  Size          Size of Buffer
+  @param[in]  Seed          Pattern seed
+
+  @retval TRUE    Buffer holds the pattern
+  @retval FALSE   Buffer does not hold the pattern
+**/
+STATIC
+BOOLEAN
+TestCheck (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Size,
+  IN UINT8        Seed
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    if (Buffer[Index] != (UINT8)(Seed + Index * 7)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Map a host buffer the way NonCoherentPciIoMap does when it bounces, with
+  an allocated bounce buffer if the pool has none.
+
+  For bus master read the host data is copied to the bounce buffer. For bus
+  master write the simulated device fills the bounce buffer with the pattern.
+
+  @param[in]  Operation     Bus master read or write
+  @param[in]  Size          Size of the transfer
+  @param[in]  Seed          Pattern seed
+  @param[out] Mapping       Map info of the mapping
+
+  @retval UNIT_TEST_PASSED  Mapping made
+**/
+STATIC
+UNIT_TEST_STATUS
+TestMap (
+  IN  EFI_PCI_IO_PROTOCOL_OPERATION         Operation,
+  IN  UINTN                                 Size,
+  IN  UINT8                                 Seed,
+  OUT NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO  **Mapping
+  )
+{
+  NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO  *MapInfo;
+  VOID                                  *Bounce;
+
+  MapInfo = BouncePoolAcquireMapInfo (&mPool);
+  UT_ASSERT_NOT_NULL (MapInfo);
+
+  MapInfo->HostAddress   = AllocatePool (Size);
+  MapInfo->Operation     = Operation;
+  MapInfo->NumberOfBytes = Size;
+  UT_ASSERT_NOT_NULL (MapInfo->HostAddress);
+
+  Bounce = BouncePoolAcquireBuffer (&mPool, Size);
+  if (Bounce != NULL) {
+    mPooledMaps++;
+  } else {
+    Bounce = AllocatePool (Size);
+    UT_ASSERT_NOT_NULL (Bounce);
+    mAllocatedMaps++;
+  }
+
+  MapInfo->AllocAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)Bounce;
+
+  if (Operation == EfiPciIoOperationBusMasterRead) {
+    TestFill (MapInfo->HostAddress, Size, Seed);
+    CopyMem (Bounce, MapInfo->HostAddress, Size);
+  } else {
+    TestFill (Bounce, Size, Seed);
+  }
+
+  *Mapping = MapInfo;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unmap a mapping made by TestMap and check no other mapping touched its
+  bounce buffer.
+
+  @param[in]  MapInfo       Map info of the mapping
+  @param[in]  Seed          Pattern seed
+
+  @retval TRUE    Data was intact
+  @retval FALSE   Data was corrupted
+**/
+STATIC
+BOOLEAN
+TestUnmap (
+  IN NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO  *MapInfo,
+  IN UINT8                                 Seed
+  )
+{
+  VOID     *Bounce;
+  BOOLEAN  Intact;
+
+  Bounce = (VOID *)(UINTN)MapInfo->AllocAddress;
+  Intact = TestCheck (Bounce, MapInfo->NumberOfBytes, Seed);
+
+  if (MapInfo->Operation == EfiPciIoOperationBusMasterWrite) {
+    CopyMem (MapInfo->HostAddress, Bounce, MapInfo->NumberOfBytes);
+    Intact = Intact && TestCheck (MapInfo->HostAddress, MapInfo->NumberOfBytes, Seed);
+  }
+
+  if (!BouncePoolReleaseBuffer (&mPool, Bounce)) {
+    FreePool (Bounce);
+  }
+
+  FreePool (MapInfo->HostAddress);
+  BouncePoolReleaseMapInfo (&mPool, MapInfo);
+
+  return Intact;
+}
+
+/**
+  Check every bounce buffer slot and map info slot is back in the pool.
+
+  @retval TRUE    Pool is idle
+  @retval FALSE   Pool has slots in use
+**/
+STATIC
+BOOLEAN
+TestPoolIdle (
+  VOID
+  )
+{
+  NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO  *MapInfo;
+  UINTN                                 Count;
+  UINTN                                 Index;
+
+  for (Index = 0; Index < mPool.ClassCount; Index++) {
+    if (mPool.Classes[Index].FreeCount != mPool.Classes[Index].SlotCount) {
+      return FALSE;
+    }
+  }
+
+  Count = 0;
+  for (MapInfo = mPool.FreeMapInfo; MapInfo != NULL; MapInfo = MapInfo->NextFree) {
+    Count++;
+  }
+
+  return Count == BOUNCE_POOL_MAP_INFO_SLOTS;
+}
+
+/**
+  Set up a pool with a small and a large class of bounce buffers, adding
+  the large class first to check the pool orders them.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Pool set up
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+TestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+
+  mSmallBuffer = AllocatePool (TEST_SMALL_SLOT_SIZE * TEST_SMALL_SLOT_COUNT);
+  mLargeBuffer = AllocatePool (TEST_LARGE_SLOT_SIZE * TEST_LARGE_SLOT_COUNT);
+  UT_ASSERT_NOT_NULL (mSmallBuffer);
+  UT_ASSERT_NOT_NULL (mLargeBuffer);
+
+  BouncePoolInit (&mPool);
+  Status = BouncePoolAddClass (&mPool, mLargeBuffer, TEST_LARGE_SLOT_SIZE, TEST_LARGE_SLOT_COUNT);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = BouncePoolAddClass (&mPool, mSmallBuffer, TEST_SMALL_SLOT_SIZE, TEST_SMALL_SLOT_COUNT);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  mRandom        = 0x1234;
+  mMappingCount  = 0;
+  mPooledMaps    = 0;
+  mAllocatedMaps = 0;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the pool buffers.
+
+  @param[in]  Context       Unit test context
+**/
+STATIC
+VOID
+EFIAPI
+TestCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FreePool (mSmallBuffer);
+  FreePool (mLargeBuffer);
+}
+
+/**
+  Buffers come from the smallest class that fits and has a free slot, and
+  the pool rejects requests and releases it cannot satisfy.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ClassSelection (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  *Small[TEST_SMALL_SLOT_COUNT];
+  UINT8  *Buffer;
+  UINT8  Foreign;
+  UINTN  Index;
+
+  UT_ASSERT_EQUAL (mPool.Classes[0].SlotSize, TEST_SMALL_SLOT_SIZE);
+  UT_ASSERT_EQUAL (mPool.Classes[1].SlotSize, TEST_LARGE_SLOT_SIZE);
+
+  for (Index = 0; Index < TEST_SMALL_SLOT_COUNT; Index++) {
+    Small[Index] = BouncePoolAcquireBuffer (&mPool, 100);
+    UT_ASSERT_TRUE (Small[Index] >= mSmallBuffer);
+    UT_ASSERT_TRUE (Small[Index] < mSmallBuffer + TEST_SMALL_SLOT_SIZE * TEST_SMALL_SLOT_COUNT);
+  }
+
+  // small class exhausted, small requests spill into the large class
+  Buffer = BouncePoolAcquireBuffer (&mPool, 100);
+  UT_ASSERT_TRUE (Buffer >= mLargeBuffer);
+  UT_ASSERT_TRUE (Buffer < mLargeBuffer + TEST_LARGE_SLOT_SIZE * TEST_LARGE_SLOT_COUNT);
+  UT_ASSERT_TRUE (BouncePoolReleaseBuffer (&mPool, Buffer));
+
+  // last released slot is reused first
+  UT_ASSERT_TRUE (BouncePoolReleaseBuffer (&mPool, Small[3]));
+  UT_ASSERT_EQUAL (BouncePoolAcquireBuffer (&mPool, TEST_SMALL_SLOT_SIZE), Small[3]);
+
+  for (Index = 0; Index < TEST_SMALL_SLOT_COUNT; Index++) {
+    UT_ASSERT_TRUE (BouncePoolReleaseBuffer (&mPool, Small[Index]));
+  }
+
+  UT_ASSERT_EQUAL (BouncePoolAcquireBuffer (&mPool, TEST_LARGE_SLOT_SIZE + 1), NULL);
+  UT_ASSERT_FALSE (BouncePoolReleaseBuffer (&mPool, &Foreign));
+  UT_ASSERT_TRUE (TestPoolIdle ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Map infos come from the pool until it is exhausted, then are allocated,
+  and only pooled map infos go back to the pool.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MapInfoSlots (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NON_DISCOVERABLE_PCI_DEVICE_MAP_INFO  *MapInfo[BOUNCE_POOL_MAP_INFO_SLOTS + 4];
+  UINTN                                 Index;
+  BOOLEAN                               Pooled;
+
+  for (Index = 0; Index < ARRAY_SIZE (MapInfo); Index++) {
+    MapInfo[Index] = BouncePoolAcquireMapInfo (&mPool);
+    UT_ASSERT_NOT_NULL (MapInfo[Index]);
+    Pooled = (MapInfo[Index] >= &mPool.MapInfo[0]) &&
+             (MapInfo[Index] < &mPool.MapInfo[BOUNCE_POOL_MAP_INFO_SLOTS]);
+    UT_ASSERT_EQUAL (Pooled, Index < BOUNCE_POOL_MAP_INFO_SLOTS);
+  }
+
+  UT_ASSERT_EQUAL (mPool.FreeMapInfo, NULL);
+
+  for (Index = 0; Index < ARRAY_SIZE (MapInfo); Index++) {
+    BouncePoolReleaseMapInfo (&mPool, MapInfo[Index]);
+  }
+
+  UT_ASSERT_TRUE (TestPoolIdle ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Stress map and unmap with mixed sizes and directions, more mappings than
+  the pool has slots, and unmaps in random order.
+
+  @param[in]  Context       Unit test context
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MixedSizeStress (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_PCI_IO_PROTOCOL_OPERATION  Operation;
+  UINTN                          Iteration;
+  UINTN                          Index;
+  UINTN                          Size;
+  UINT8                          Seed;
+
+  for (Iteration = 0; Iteration < TEST_STRESS_ITERATIONS; Iteration++) {
+    if ((mMappingCount < TEST_MAX_MAPPINGS) &&
+        ((mMappingCount == 0) || ((TestRandom () % 2) != 0)))
+    {
+      switch (TestRandom () % 4) {
+        case 0:
+          Size = 1 + TestRandom () % 512;
+          break;
+        case 1:
+          Size = 1 + TestRandom () % TEST_SMALL_SLOT_SIZE;
+          break;
+        case 2:
+          Size = 1 + TestRandom () % TEST_LARGE_SLOT_SIZE;
+          break;
+        default:
+          Size = 1 + TestRandom () % TEST_MAX_TRANSFER_BYTES;
+          break;
+      }
+
+      Operation = ((TestRandom () & 1) != 0) ? EfiPciIoOperationBusMasterRead :
+                  EfiPciIoOperationBusMasterWrite;
+      Seed = (UINT8)Iteration;
+
+      UT_ASSERT_EQUAL (TestMap (Operation, Size, Seed, &mMappings[mMappingCount].MapInfo), UNIT_TEST_PASSED);
+      mMappings[mMappingCount].Seed = Seed;
+      mMappingCount++;
+    } else {
+      Index = TestRandom () % mMappingCount;
+      UT_ASSERT_TRUE (TestUnmap (mMappings[Index].MapInfo, mMappings[Index].Seed));
+      mMappings[Index] = mMappings[--mMappingCount];
+    }
+  }
+
+  while (mMappingCount > 0) {
+    mMappingCount--;
+    UT_ASSERT_TRUE (TestUnmap (mMappings[mMappingCount].MapInfo, mMappings[mMappingCount].Seed));
+  }
+
+  UT_ASSERT_TRUE (TestPoolIdle ());
+  UT_ASSERT_TRUE (mPooledMaps > mAllocatedMaps);
+  UT_ASSERT_TRUE (mAllocatedMaps > 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  bounce pool and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      PoolTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&PoolTests, Framework, "Bounce Pool Tests", "UnitTest.NonDiscoverablePciDeviceBouncePool", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Bounce Pool Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    return Status;
+  }
+
+  AddTestCase (PoolTests, "Smallest class that fits is used", "ClassSelection", ClassSelection, TestSetup, TestCleanup, NULL);
+  AddTestCase (PoolTests, "Map infos fall back to allocation", "MapInfoSlots", MapInfoSlots, TestSetup, TestCleanup, NULL);
+  AddTestCase (PoolTests, "Map and unmap with mixed sizes", "MixedSizeStress", MixedSizeStress, TestSetup, TestCleanup, NULL);
+
+  // Execute the tests.
+  Status = RunAllTestSuites (Framework);
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
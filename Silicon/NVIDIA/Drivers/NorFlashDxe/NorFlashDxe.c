@@ -218,6 +218,60 @@ ConfigureNorFlashWriteEnLatch (
   return Status;
 }
 
+/**
+  Check if the quad enable requirements of the NOR flash are met.
+
+  The quad enable bit is non-volatile on most parts, so it is only checked
+  here and never written, leaving it to be configured by the platform.
+
+  @param[in] Private               Driver's private data
+  @param[in] QuadEnableReq         Quad enable requirements from SFDP
+
+  @retval TRUE                     Quad transfers can be used
+  @retval FALSE                    Quad transfers are not enabled or the
+                                   quad enable bit can not be checked
+**/
+STATIC
+BOOLEAN
+NorFlashIsQuadEnabled (
+  IN NOR_FLASH_PRIVATE_DATA  *Private,
+  IN UINT8                   QuadEnableReq
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       RegCmd;
+  UINT8       Mask;
+  UINT8       Resp;
+
+  switch (QuadEnableReq) {
+    case NOR_SFDP_QER_NONE:
+      return TRUE;
+    case NOR_SFDP_QER_SR1_BIT6:
+      RegCmd = NOR_READ_SR1;
+      Mask   = NOR_SR1_QE_BMSK;
+      break;
+    case NOR_SFDP_QER_SR2_BIT7:
+      RegCmd = NOR_READ_SR2_QER3;
+      Mask   = NOR_SR2_QER3_QE_BMSK;
+      break;
+    case NOR_SFDP_QER_SR2_BIT1_READ:
+    case NOR_SFDP_QER_SR2_BIT1_31H:
+      RegCmd = NOR_READ_SR2;
+      Mask   = NOR_SR2_QE_BMSK;
+      break;
+    default:
+      // Status register 2 can not be read
+      return FALSE;
+  }
+
+  Status = ReadNorFlashRegister (Private, &RegCmd, sizeof (RegCmd), &Resp);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
+  }
+
+  return (Resp & Mask) != 0;
+}
+
 /**
   Read NOR Flash's SFDP
 
@@ -250,8 +304,11 @@ ReadNorFlashSFDP (
   NOR_SFDP_PARAM_SECTOR_DESCRIPTOR  *SFDPParamSectorTbl;
   UINT32                            SFDPParamSectorTblSize;
   NOR_SFDP_PARAM_SECTOR_REGION      *SFDPParamSectorTblRegion;
-  NOR_SFDP_PARAM_SECTOR_REGION      *SFDPParamSectorTblFirstRegion;
   UINT8                             NumRegions;
+  UINT32                            Index;
+  NOR_FLASH_ERASE_MAP               *EraseMap;
+  NOR_FLASH_ERASE_REGION            *EraseRegion;
+  NOR_FLASH_ERASE_REGION            *BiggestEraseRegion;
   UINT32                            MemoryDensity;
   QSPI_TRANSACTION_PACKET           Packet;
 
@@ -471,11 +528,74 @@ ReadNorFlashSFDP (
     Private->PrivateFlashAttributes.ReadWaitCycles = NOR_SFDP_FAST_READ_DEF_WAIT;
   }
 
+  // Find the quad read and page program commands that can be used with the
+  // lanes wired to the flash. The quad enable requirements are only part of
+  // JESD216A and later basic parameter tables.
+  ZeroMem (&Private->PrivateFlashAttributes.MultiLaneRead, sizeof (NOR_FLASH_MULTI_LANE_CMD));
+  ZeroMem (&Private->PrivateFlashAttributes.MultiLaneWrite, sizeof (NOR_FLASH_MULTI_LANE_CMD));
+  if ((Private->PrivateFlashAttributes.RxBusWidth == QspiBusWidthQuad) &&
+      (SFDPParamBasicTblSize >= sizeof (NOR_SFDP_PARAM_BASIC_TBL)) &&
+      NorFlashIsQuadEnabled (Private, SFDPParamBasicTbl->QuadEnableReq))
+  {
+    if ((Private->PrivateFlashAttributes.TxBusWidth == QspiBusWidthQuad) &&
+        SFDPParamBasicTbl->QuadIOSupport &&
+        SFDPParam4ByteInstructionTbl->ReadCmdEC)
+    {
+      Private->PrivateFlashAttributes.MultiLaneRead.Command         = NOR_QUAD_IO_READ_CMD;
+      Private->PrivateFlashAttributes.MultiLaneRead.WaitCycles      = SFDPParamBasicTbl->QuadIOModeCycles +
+                                                                      SFDPParamBasicTbl->QuadIODummyCycles;
+      Private->PrivateFlashAttributes.MultiLaneRead.AddressBusWidth = QspiBusWidthQuad;
+      Private->PrivateFlashAttributes.MultiLaneRead.DataBusWidth    = QspiBusWidthQuad;
+    } else if (SFDPParamBasicTbl->QuadOutSupport &&
+               SFDPParam4ByteInstructionTbl->ReadCmd6C)
+    {
+      Private->PrivateFlashAttributes.MultiLaneRead.Command         = NOR_QUAD_OUT_READ_CMD;
+      Private->PrivateFlashAttributes.MultiLaneRead.WaitCycles      = SFDPParamBasicTbl->QuadOutModeCycles +
+                                                                      SFDPParamBasicTbl->QuadOutDummyCycles;
+      Private->PrivateFlashAttributes.MultiLaneRead.AddressBusWidth = QspiBusWidthSingle;
+      Private->PrivateFlashAttributes.MultiLaneRead.DataBusWidth    = QspiBusWidthQuad;
+    }
+
+    if ((Private->PrivateFlashAttributes.MultiLaneRead.Command != 0) &&
+        (Private->PrivateFlashAttributes.TxBusWidth == QspiBusWidthQuad) &&
+        SFDPParam4ByteInstructionTbl->WriteCmd34)
+    {
+      Private->PrivateFlashAttributes.MultiLaneWrite.Command         = NOR_QUAD_WRITE_CMD;
+      Private->PrivateFlashAttributes.MultiLaneWrite.WaitCycles      = 0;
+      Private->PrivateFlashAttributes.MultiLaneWrite.AddressBusWidth = QspiBusWidthSingle;
+      Private->PrivateFlashAttributes.MultiLaneWrite.DataBusWidth    = QspiBusWidthQuad;
+    }
+  }
+
+  // Collect the erase types that have a 4 byte address instruction
+  EraseMap = &Private->PrivateFlashAttributes.EraseMap;
+  ZeroMem (EraseMap, sizeof (NOR_FLASH_ERASE_MAP));
+  for (Count = 0; Count < NOR_SFDP_ERASE_COUNT; Count++) {
+    if ((SFDPParamBasicTbl->EraseType[Count].Size != 0) &&
+        (SFDPParam4ByteInstructionTbl->EraseTypeSupported & (1 << Count)))
+    {
+      EraseMap->Types[Count].Size    = 1 << SFDPParamBasicTbl->EraseType[Count].Size;
+      EraseMap->Types[Count].Command = SFDPParam4ByteInstructionTbl->EraseInstruction[Count];
+    }
+  }
+
   // If uniform 4K erase is supported, use that mode.
   if ((SFDPParamBasicTbl->EraseSupport4KB == NOR_SFDP_4KB_ERS_SUPPORTED) &&
       (SFDPParamBasicTbl->EraseInstruction4KB != NOR_SFDP_4KB_ERS_UNSUPPORTED))
   {
     Private->PrivateFlashAttributes.FlashAttributes.BlockSize = SIZE_4KB;
+
+    // Every erase type can be used anywhere in the flash.
+    Status = NorFlashEraseMapAddRegion (
+               EraseMap,
+               Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity,
+               MAX_UINT8
+               );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's uniform erase table supported in SFDP.\n", __FUNCTION__));
+      Status = EFI_UNSUPPORTED;
+      goto ErrorExit;
+    }
   } else {
     // Find the sector map parameter table header
     for (Count = SFDPHeader.NumParamHdrs; Count >= 0; Count--) {
@@ -547,57 +667,52 @@ ReadNorFlashSFDP (
       goto ErrorExit;
     }
 
-    // Out of the regions found in the map, find the region with biggest size.
-    SFDPParamSectorTblRegion      = (NOR_SFDP_PARAM_SECTOR_REGION *)&SFDPParamSectorTbl[Count++];
-    SFDPParamSectorTblFirstRegion = SFDPParamSectorTblRegion;
-    while (NumRegions > 0) {
-      if (((NOR_SFDP_PARAM_SECTOR_REGION *)&SFDPParamSectorTbl[Count])->RegionSize >
-          SFDPParamSectorTblRegion->RegionSize)
-      {
-        SFDPParamSectorTblRegion = (NOR_SFDP_PARAM_SECTOR_REGION *)&SFDPParamSectorTbl[Count];
+    // Add all regions found in the map, the block size is the smallest erase of
+    // the region with biggest size.
+    BiggestEraseRegion = NULL;
+    for (Index = 0; Index <= NumRegions; Index++, Count++) {
+      if (Count >= SFDPParamSectorTblHeader->ParamTblLen) {
+        DEBUG ((EFI_D_ERROR, "%a: NOR flash's SFDP sector parameter mapping table truncated.\n", __FUNCTION__));
+        Status = EFI_UNSUPPORTED;
+        goto ErrorExit;
       }
 
-      Count++;
-      NumRegions--;
-    }
-
-    for (Count = 0; Count < NOR_SFDP_ERASE_COUNT; Count++) {
-      if (SFDPParamSectorTblRegion->EraseTypeSupported & (1 << Count)) {
-        break;
+      SFDPParamSectorTblRegion = (NOR_SFDP_PARAM_SECTOR_REGION *)&SFDPParamSectorTbl[Count];
+      Status                   = NorFlashEraseMapAddRegion (
+                                   EraseMap,
+                                   (SFDPParamSectorTblRegion->RegionSize + 1) * NOR_SFDP_ERASE_REGION_SIZE,
+                                   SFDPParamSectorTblRegion->EraseTypeSupported
+                                   );
+      if (EFI_ERROR (Status)) {
+        DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's SFDP sector parameter erase table.\n", __FUNCTION__));
+        Status = EFI_UNSUPPORTED;
+        goto ErrorExit;
       }
-    }
 
-    if (Count >=  NOR_SFDP_ERASE_COUNT) {
-      DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's SFDP sector parameter erase table.\n", __FUNCTION__));
-      Status = EFI_UNSUPPORTED;
-      goto ErrorExit;
+      EraseRegion = &EraseMap->Regions[EraseMap->RegionCount - 1];
+      if ((BiggestEraseRegion == NULL) || (EraseRegion->Size > BiggestEraseRegion->Size)) {
+        BiggestEraseRegion = EraseRegion;
+      }
     }
 
-    Private->PrivateFlashAttributes.FlashAttributes.BlockSize = 1 << SFDPParamBasicTbl->EraseType[Count].Size;
-
-    // Out of the regions found in the map, first region is the one used for hybrid.
     for (Count = 0; Count < NOR_SFDP_ERASE_COUNT; Count++) {
-      if (SFDPParamSectorTblFirstRegion->EraseTypeSupported & (1 << Count)) {
+      if (BiggestEraseRegion->EraseTypeMask & (1 << Count)) {
         break;
       }
     }
 
-    if (Count >=  NOR_SFDP_ERASE_COUNT) {
-      DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's SFDP first sector parameter erase table.\n", __FUNCTION__));
-      Status = EFI_UNSUPPORTED;
-      goto ErrorExit;
-    }
+    Private->PrivateFlashAttributes.FlashAttributes.BlockSize = EraseMap->Types[Count].Size;
 
-    Private->PrivateFlashAttributes.HybridMemoryDensity = (SFDPParamSectorTblFirstRegion->RegionSize + 1) *
-                                                          NOR_SFDP_ERASE_REGION_SIZE;
-    Private->PrivateFlashAttributes.HybridBlockSize = 1 << SFDPParamBasicTbl->EraseType[Count].Size;
+    // Any part of the flash not described by the map uses the last region.
+    EraseRegion = &EraseMap->Regions[EraseMap->RegionCount - 1];
+    if (EraseRegion->Offset + EraseRegion->Size < Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity) {
+      EraseRegion->Size = Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity - EraseRegion->Offset;
+    }
   }
 
-  // Look up 4 byte uniform erase command based on the block size.
+  // Erase of a single block has to be supported.
   for (Count = 0; Count < NOR_SFDP_ERASE_COUNT; Count++) {
-    if (Private->PrivateFlashAttributes.FlashAttributes.BlockSize ==
-        (1 << SFDPParamBasicTbl->EraseType[Count].Size))
-    {
+    if (Private->PrivateFlashAttributes.FlashAttributes.BlockSize == EraseMap->Types[Count].Size) {
       break;
     }
   }
@@ -608,40 +723,6 @@ ReadNorFlashSFDP (
     goto ErrorExit;
   }
 
-  if (!(SFDPParam4ByteInstructionTbl->EraseTypeSupported & (1 << Count))) {
-    DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's uniform erase table supported in SFDP.\n", __FUNCTION__));
-    Status = EFI_UNSUPPORTED;
-    goto ErrorExit;
-  }
-
-  Private->PrivateFlashAttributes.UniformEraseCmd = SFDPParam4ByteInstructionTbl->EraseInstruction[Count];
-
-  // Look up 4 byte hybrid erase command based on the block size if uniform block size
-  // is not already 4KB.
-  if (Private->PrivateFlashAttributes.FlashAttributes.BlockSize != SIZE_4KB) {
-    for (Count = 0; Count < NOR_SFDP_ERASE_COUNT; Count++) {
-      if (Private->PrivateFlashAttributes.HybridBlockSize ==
-          (1 << SFDPParamBasicTbl->EraseType[Count].Size))
-      {
-        break;
-      }
-    }
-
-    if (Count >=  NOR_SFDP_ERASE_COUNT) {
-      DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's hybrid block size in SFDP sector parameter erase table.\n", __FUNCTION__));
-      Status = EFI_UNSUPPORTED;
-      goto ErrorExit;
-    }
-
-    if (!(SFDPParam4ByteInstructionTbl->EraseTypeSupported & (1 << Count))) {
-      DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's hybrid erase table supported in SFDP.\n", __FUNCTION__));
-      Status = EFI_UNSUPPORTED;
-      goto ErrorExit;
-    }
-
-    Private->PrivateFlashAttributes.HybridEraseCmd = SFDPParam4ByteInstructionTbl->EraseInstruction[Count];
-  }
-
   // If basic parameter table size is more than NOR_SFDP_PRM_TBL_LEN_JESD216,
   // read page size from the table. Otherwise default to NOR_SFDP_WRITE_DEF_PAGE
   if (SFDPParamBasicTblSize > NOR_SFDP_PRM_TBL_LEN_JESD216) {
@@ -755,9 +836,10 @@ NorFlashRead (
   UINT32                   Count;
   UINT32                   AddressShift;
   QSPI_TRANSACTION_PACKET  Packet;
-  NOR_FLASH_PRIVATE_DATA   *Private;
-  UINT32                   FlashDensity;
-  TEGRA_PLATFORM_TYPE      PlatformType;
+  NOR_FLASH_PRIVATE_DATA    *Private;
+  UINT32                    FlashDensity;
+  TEGRA_PLATFORM_TYPE       PlatformType;
+  NOR_FLASH_MULTI_LANE_CMD  *MultiLaneRead;
 
   if ((This == NULL) ||
       (Buffer == NULL) ||
@@ -791,9 +873,18 @@ NorFlashRead (
    * For Pre Sil
    *   Always use Slow Read
    */
-  PlatformType = TegraGetPlatform ();
+  PlatformType   = TegraGetPlatform ();
+  MultiLaneRead  = &Private->PrivateFlashAttributes.MultiLaneRead;
+  Packet.Control = 0;
   if (PlatformType == TEGRA_PLATFORM_SILICON) {
-    if (Private->PrivateFlashAttributes.FastReadSupport) {
+    if (MultiLaneRead->Command != 0) {
+      Private->CommandBuffer[0] = MultiLaneRead->Command;
+      Packet.WaitCycles         = MultiLaneRead->WaitCycles;
+      Packet.Control            = QSPI_CONTROLLER_CONTROL_MULTI_LANE;
+      Packet.TxSingleLen        = (MultiLaneRead->AddressBusWidth == QspiBusWidthSingle) ? CmdSize : NOR_CMD_SIZE;
+      Packet.TxBusWidth         = MultiLaneRead->AddressBusWidth;
+      Packet.RxBusWidth         = MultiLaneRead->DataBusWidth;
+    } else if (Private->PrivateFlashAttributes.FastReadSupport) {
       Private->CommandBuffer[0] = NOR_FAST_READ_DATA_CMD;
       Packet.WaitCycles         = Private->PrivateFlashAttributes.ReadWaitCycles;
     } else {
@@ -810,7 +901,6 @@ NorFlashRead (
   Packet.RxBuf      = Buffer;
   Packet.RxLen      = Size;
   Packet.ChipSelect = Private->QspiChipSelect;
-  Packet.Control    = 0;
 
   DEBUG ((
     DEBUG_INFO,
@@ -919,10 +1009,12 @@ NorFlashReadBlock (
 /**
   Erase data from NOR Flash.
 
+  The blocks are erased with the fewest erase commands allowed by the erase
+  map of the flash, rather than one command per block.
+
   @param[in] This                  Instance to protocol
-  @param[in] Offset                Logical block to start erasing from
+  @param[in] Lba                   Logical block to start erasing from
   @param[in] NumLba                Number of block to be erased
-  @param[in] Hybrid                Use hybrid region
 
   @retval EFI_SUCCESS              Operation successful.
   @retval others                   Error occurred
@@ -931,22 +1023,23 @@ EFI_STATUS
 NorFlashErase (
   IN NVIDIA_NOR_FLASH_PROTOCOL  *This,
   IN UINT32                     Lba,
-  IN UINT32                     NumLba,
-  IN BOOLEAN                    Hybrid
+  IN UINT32                     NumLba
   )
 {
   EFI_STATUS               Status;
   UINT32                   CmdSize;
   UINT32                   Count;
-  UINT32                   Block;
   UINT32                   AddressShift;
   QSPI_TRANSACTION_PACKET  Packet;
   NOR_FLASH_PRIVATE_DATA   *Private;
-  UINT32                   Offset;
+  UINT32                   Address;
   UINT32                   LastBlock;
-  UINT64                   MemoryDensity;
   UINT32                   BlockSize;
+  UINT64                   Offset;
+  UINT64                   End;
+  UINT64                   EraseEnd;
   UINT8                    EraseCmd;
+  UINT32                   EraseCount;
 
   if ((This == NULL) ||
       (NumLba == 0))
@@ -956,20 +1049,8 @@ NorFlashErase (
 
   Private = NOR_FLASH_PRIVATE_DATA_FROM_NOR_FLASH_PROTOCOL (This);
 
-  if (Hybrid) {
-    MemoryDensity = Private->PrivateFlashAttributes.HybridMemoryDensity;
-    BlockSize     = Private->PrivateFlashAttributes.HybridBlockSize;
-    EraseCmd      = Private->PrivateFlashAttributes.HybridEraseCmd;
-    if ((MemoryDensity == 0) || (BlockSize == 0) || (EraseCmd == 0)) {
-      return EFI_UNSUPPORTED;
-    }
-  } else {
-    MemoryDensity = Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity;
-    BlockSize     = Private->PrivateFlashAttributes.FlashAttributes.BlockSize;
-    EraseCmd      = Private->PrivateFlashAttributes.UniformEraseCmd;
-  }
-
-  LastBlock = (MemoryDensity / BlockSize) - 1;
+  BlockSize = Private->PrivateFlashAttributes.FlashAttributes.BlockSize;
+  LastBlock = (Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity / BlockSize) - 1;
 
   if ((Lba > LastBlock) ||
       ((Lba + NumLba - 1) > LastBlock))
@@ -977,33 +1058,21 @@ NorFlashErase (
     return EFI_INVALID_PARAMETER;
   }
 
-  // To uniform erase first block, must also hybrid erase the hybrid region
-  if (!Hybrid &&
-      (Lba == 0) &&
-      (Private->PrivateFlashAttributes.HybridMemoryDensity > 0))
-  {
-    Status = NorFlashErase (
-               This,
-               0,
-               Private->PrivateFlashAttributes.HybridMemoryDensity /
-               Private->PrivateFlashAttributes.HybridBlockSize,
-               TRUE
-               );
+  CmdSize = NOR_CMD_SIZE + NOR_ADDR_SIZE;
+  ZeroMem (Private->CommandBuffer, CmdSize);
+
+  Offset     = (UINT64)Lba * BlockSize;
+  End        = Offset + (UINT64)NumLba * BlockSize;
+  EraseCount = 0;
+  Status     = EFI_SUCCESS;
+
+  while (Offset < End) {
+    Status = NorFlashEraseMapNext (&Private->PrivateFlashAttributes.EraseMap, Offset, End, &EraseEnd, &EraseCmd);
     if (EFI_ERROR (Status)) {
-      DEBUG ((
-        EFI_D_ERROR,
-        "%a: Failed hybrid erase: %r\n",
-        __FUNCTION__,
-        Status
-        ));
+      DEBUG ((EFI_D_ERROR, "%a: Could not find NOR flash erase for 0x%llx.\n", __FUNCTION__, Offset));
       goto ErrorExit;
     }
-  }
 
-  CmdSize = NOR_CMD_SIZE + NOR_ADDR_SIZE;
-  ZeroMem (Private->CommandBuffer, CmdSize);
-
-  for (Block = Lba; Block < (Lba + NumLba); Block++) {
     Status = ConfigureNorFlashWriteEnLatch (Private, TRUE);
     if (EFI_ERROR (Status)) {
       DEBUG ((EFI_D_ERROR, "%a: Could not enable NOR flash WREN.\n", __FUNCTION__));
@@ -1011,9 +1080,9 @@ NorFlashErase (
     }
 
     AddressShift = 0;
-    Offset       = Block * BlockSize;
+    Address      = (UINT32)Offset;
     for (Count = (CmdSize - 1); Count > 0; Count--) {
-      Private->CommandBuffer[Count] = (Offset & (0xFF << AddressShift)) >> AddressShift;
+      Private->CommandBuffer[Count] = (Address & (0xFF << AddressShift)) >> AddressShift;
       AddressShift                 += 8;
     }
 
@@ -1044,9 +1113,12 @@ NorFlashErase (
       DEBUG ((EFI_D_ERROR, "%a: Could not enable NOR flash WREN.\n", __FUNCTION__));
       goto ErrorExit;
     }
+
+    Offset = EraseEnd;
+    EraseCount++;
   }
 
-  DEBUG ((EFI_D_INFO, "%a: Successfully erased data from NOR flash.\n", __FUNCTION__));
+  DEBUG ((EFI_D_INFO, "%a: Successfully erased %u blocks from NOR flash with %u commands.\n", __FUNCTION__, NumLba, EraseCount));
 
 ErrorExit:
 
@@ -1070,7 +1142,7 @@ NorFlashUniformErase (
   IN UINT32                     NumLba
   )
 {
-  return NorFlashErase (This, Lba, NumLba, FALSE);
+  return NorFlashErase (This, Lba, NumLba);
 }
 
 EFI_STATUS
@@ -1149,8 +1221,7 @@ NorFlashEraseBlock (
   Status = NorFlashErase (
              &Private->NorFlashProtocol,
              LBA,
-             Size / Private->PrivateFlashAttributes.FlashAttributes.BlockSize,
-             FALSE
+             Size / Private->PrivateFlashAttributes.FlashAttributes.BlockSize
              );
 
   if (Token->Event != NULL) {
@@ -1181,13 +1252,14 @@ NorFlashWriteSinglePage (
   IN VOID                       *Buffer
   )
 {
-  EFI_STATUS               Status;
-  UINT32                   CmdSize;
-  UINT32                   Count;
-  UINT32                   AddressShift;
-  QSPI_TRANSACTION_PACKET  Packet;
-  NOR_FLASH_PRIVATE_DATA   *Private;
-  UINT32                   FlashDensity;
+  EFI_STATUS                Status;
+  UINT32                    CmdSize;
+  UINT32                    Count;
+  UINT32                    AddressShift;
+  QSPI_TRANSACTION_PACKET   Packet;
+  NOR_FLASH_PRIVATE_DATA    *Private;
+  UINT32                    FlashDensity;
+  NOR_FLASH_MULTI_LANE_CMD  *MultiLaneWrite;
 
   if ((This == NULL) ||
       (Buffer == NULL) ||
@@ -1220,7 +1292,17 @@ NorFlashWriteSinglePage (
     AddressShift                 += 8;
   }
 
-  Private->CommandBuffer[0] = NOR_WRITE_DATA_CMD;
+  MultiLaneWrite = &Private->PrivateFlashAttributes.MultiLaneWrite;
+  if (MultiLaneWrite->Command != 0) {
+    Private->CommandBuffer[0] = MultiLaneWrite->Command;
+    Packet.Control            = QSPI_CONTROLLER_CONTROL_MULTI_LANE;
+    Packet.TxSingleLen        = (MultiLaneWrite->AddressBusWidth == QspiBusWidthSingle) ? CmdSize : NOR_CMD_SIZE;
+    Packet.TxBusWidth         = MultiLaneWrite->DataBusWidth;
+    Packet.RxBusWidth         = QspiBusWidthSingle;
+  } else {
+    Private->CommandBuffer[0] = NOR_WRITE_DATA_CMD;
+    Packet.Control            = 0;
+  }
 
   Packet.TxBuf      = Private->CommandBuffer;
   Packet.TxLen      = CmdSize + Size;
@@ -1228,7 +1310,6 @@ NorFlashWriteSinglePage (
   Packet.RxLen      = 0;
   Packet.WaitCycles = 0;
   Packet.ChipSelect = Private->QspiChipSelect;
-  Packet.Control    = 0;
 
   Status = Private->QspiController->PerformTransaction (Private->QspiController, &Packet);
   if (EFI_ERROR (Status)) {
@@ -1401,8 +1482,7 @@ NorFlashWriteBlock (
   Status = NorFlashErase (
              &Private->NorFlashProtocol,
              Lba,
-             BufferSize / Private->PrivateFlashAttributes.FlashAttributes.BlockSize,
-             FALSE
+             BufferSize / Private->PrivateFlashAttributes.FlashAttributes.BlockSize
              );
 
   BlockSize = Private->PrivateFlashAttributes.FlashAttributes.BlockSize;
@@ -1524,6 +1604,131 @@ IsValidFlashNode (
   return (IsFlash && !IsDisabled && IsValidCS);
 }
 
+/**
+  Get the number of data lanes wired to a flash device.
+
+  @param[in]  DeviceTreeBase       Pointer to DT
+  @param[in]  NodeOffset           Offset of DT flash device subnode
+  @param[in]  PropertyName         Bus width property to read
+
+  @retval QSPI_BUS_WIDTH           Number of lanes, single if not specified
+
+**/
+STATIC
+QSPI_BUS_WIDTH
+NorFlashGetBusWidth (
+  IN CONST VOID   *DeviceTreeBase,
+  IN INT32        NodeOffset,
+  IN CONST CHAR8  *PropertyName
+  )
+{
+  CONST VOID  *Property;
+  INT32       Length;
+
+  Property = fdt_getprop (DeviceTreeBase, NodeOffset, PropertyName, &Length);
+  if ((Property == NULL) || (Length != sizeof (UINT32))) {
+    return QspiBusWidthSingle;
+  }
+
+  switch (fdt32_to_cpu (*(CONST UINT32 *)Property)) {
+    case 4:
+      return QspiBusWidthQuad;
+    case 2:
+      return QspiBusWidthDual;
+    default:
+      return QspiBusWidthSingle;
+  }
+}
+
+/**
+  Verify multi lane reads of the NOR flash.
+
+  Data read with the multi lane read command is compared to data read on a
+  single lane. If they differ, or the data is not suitable to detect lanes
+  that are not connected, the NOR flash falls back to single lane commands.
+
+  @param[in] Private               Driver's private data
+
+**/
+STATIC
+VOID
+NorFlashVerifyMultiLane (
+  IN NOR_FLASH_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS                Status;
+  NOR_FLASH_MULTI_LANE_CMD  MultiLaneRead;
+  UINT32                    Size;
+  UINT8                     *SingleLaneData;
+  UINT8                     *MultiLaneData;
+  UINT32                    Index;
+
+  if (Private->PrivateFlashAttributes.MultiLaneRead.Command == 0) {
+    return;
+  }
+
+  SingleLaneData = NULL;
+  MultiLaneData  = NULL;
+
+  // Pre silicon platforms always use single lane reads
+  if (TegraGetPlatform () != TEGRA_PLATFORM_SILICON) {
+    Status = EFI_UNSUPPORTED;
+    goto Exit;
+  }
+
+  Size           = (UINT32)MIN (NOR_MULTI_LANE_VERIFY_SIZE, Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity);
+  SingleLaneData = AllocatePool (Size);
+  MultiLaneData  = AllocatePool (Size);
+  if ((SingleLaneData == NULL) || (MultiLaneData == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  CopyMem (&MultiLaneRead, &Private->PrivateFlashAttributes.MultiLaneRead, sizeof (MultiLaneRead));
+  Private->PrivateFlashAttributes.MultiLaneRead.Command = 0;
+  Status                                                = NorFlashRead (&Private->NorFlashProtocol, 0, Size, SingleLaneData);
+  CopyMem (&Private->PrivateFlashAttributes.MultiLaneRead, &MultiLaneRead, sizeof (MultiLaneRead));
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Status = NorFlashRead (&Private->NorFlashProtocol, 0, Size, MultiLaneData);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  if (CompareMem (SingleLaneData, MultiLaneData, Size) != 0) {
+    Status = EFI_DEVICE_ERROR;
+    goto Exit;
+  }
+
+  // Lanes that are not connected read as all ones or all zeros
+  for (Index = 1; Index < Size; Index++) {
+    if (SingleLaneData[Index] != SingleLaneData[0]) {
+      break;
+    }
+  }
+
+  if (Index == Size) {
+    Status = EFI_NOT_READY;
+  }
+
+Exit:
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: NOR flash multi lane read not verified (%r), using single lane.\n", __FUNCTION__, Status));
+    ZeroMem (&Private->PrivateFlashAttributes.MultiLaneRead, sizeof (NOR_FLASH_MULTI_LANE_CMD));
+    ZeroMem (&Private->PrivateFlashAttributes.MultiLaneWrite, sizeof (NOR_FLASH_MULTI_LANE_CMD));
+  }
+
+  if (SingleLaneData != NULL) {
+    FreePool (SingleLaneData);
+  }
+
+  if (MultiLaneData != NULL) {
+    FreePool (MultiLaneData);
+  }
+}
+
 /**
   Check for flash part in device tree.
 
@@ -1734,6 +1939,7 @@ NorFlashDxeDriverBindingStart (
   NVIDIA_DEVICE_TREE_NODE_PROTOCOL  *DeviceTreeNode;
   UINTN                             FlashIndex;
   UINTN                             NumInitialized;
+  UINT32                            RegionIndex;
 
   FlashIndex     = 0;
   NumInitialized = 0;
@@ -1844,6 +2050,16 @@ NorFlashDxeDriverBindingStart (
       }
     }
 
+    // Lanes usable for the flash, limited by the controller and the board.
+    Private->PrivateFlashAttributes.RxBusWidth = QspiBusWidthSingle;
+    Private->PrivateFlashAttributes.TxBusWidth = QspiBusWidthSingle;
+    if ((QspiInstance->DeviceSpecificInit != NULL) &&
+        !EFI_ERROR (QspiInstance->DeviceSpecificInit (QspiInstance, QspiDevFeatMultiLane)))
+    {
+      Private->PrivateFlashAttributes.RxBusWidth = NorFlashGetBusWidth (DeviceTreeNode->DeviceTreeBase, SubNode, "spi-rx-bus-width");
+      Private->PrivateFlashAttributes.TxBusWidth = NorFlashGetBusWidth (DeviceTreeNode->DeviceTreeBase, SubNode, "spi-tx-bus-width");
+    }
+
     // Read NOR flash's SFDP
     Status = ReadNorFlashSFDP (Private);
     if (EFI_ERROR (Status)) {
@@ -1863,18 +2079,18 @@ NorFlashDxeDriverBindingStart (
       __FUNCTION__,
       Private->PrivateFlashAttributes.FlashAttributes.BlockSize
       ));
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: NOR Flash Hybrid Memory Density: 0x%lx\n",
-      __FUNCTION__,
-      Private->PrivateFlashAttributes.HybridMemoryDensity
-      ));
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: NOR Flash Hybrid Block Size: 0x%lx\n",
-      __FUNCTION__,
-      Private->PrivateFlashAttributes.HybridBlockSize
-      ));
+    for (RegionIndex = 0; RegionIndex < Private->PrivateFlashAttributes.EraseMap.RegionCount; RegionIndex++) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "%a: NOR Flash Erase Region 0x%lx-0x%lx Erase Types: 0x%x\n",
+        __FUNCTION__,
+        Private->PrivateFlashAttributes.EraseMap.Regions[RegionIndex].Offset,
+        Private->PrivateFlashAttributes.EraseMap.Regions[RegionIndex].Offset +
+        Private->PrivateFlashAttributes.EraseMap.Regions[RegionIndex].Size - 1,
+        Private->PrivateFlashAttributes.EraseMap.Regions[RegionIndex].EraseTypeMask
+        ));
+    }
+
     DEBUG ((
       DEBUG_ERROR,
       "%a: NOR Flash Write Page Size: 0x%lx\n",
@@ -1911,6 +2127,16 @@ NorFlashDxeDriverBindingStart (
       goto ErrorExit;
     }
 
+    // Check multi lane reads at the restored bus frequency.
+    NorFlashVerifyMultiLane (Private);
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: NOR Flash Multi Lane Read Cmd: 0x%x Write Cmd: 0x%x\n",
+      __FUNCTION__,
+      Private->PrivateFlashAttributes.MultiLaneRead.Command,
+      Private->PrivateFlashAttributes.MultiLaneWrite.Command
+      ));
+
     // Append Vendor device path to parent device path.
     mNorFlashDevicePath.FlashIndex = FlashIndex;
     NorFlashDevicePath             = AppendDevicePathNode (
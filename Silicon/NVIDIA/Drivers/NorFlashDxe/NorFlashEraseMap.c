@@ -0,0 +1,148 @@
+/** @file
+
+  NOR Flash erase map
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/DebugLib.h>
+
+#include "NorFlashEraseMap.h"
+
+/**
+  Append a region to the erase map.
+
+  @param[in, out] Map              Erase map
+  @param[in]      Size             Size of the region in bytes
+  @param[in]      EraseTypeMask    Erase types supported in the region
+
+  @retval EFI_SUCCESS              Region added.
+  @retval EFI_INVALID_PARAMETER    No usable erase type in the region.
+  @retval EFI_OUT_OF_RESOURCES     Too many regions.
+**/
+EFI_STATUS
+NorFlashEraseMapAddRegion (
+  IN OUT NOR_FLASH_ERASE_MAP  *Map,
+  IN     UINT64               Size,
+  IN     UINT8                EraseTypeMask
+  )
+{
+  NOR_FLASH_ERASE_REGION  *Region;
+  UINT32                  Type;
+
+  if (Map->RegionCount >= NOR_FLASH_ERASE_MAX_REGIONS) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // Drop erase types the device does not support
+  for (Type = 0; Type < NOR_FLASH_ERASE_TYPE_COUNT; Type++) {
+    if (Map->Types[Type].Size == 0) {
+      EraseTypeMask &= ~(1 << Type);
+    }
+  }
+
+  if ((Size == 0) || (EraseTypeMask == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Region = &Map->Regions[Map->RegionCount];
+  if (Map->RegionCount == 0) {
+    Region->Offset = 0;
+  } else {
+    Region->Offset = Map->Regions[Map->RegionCount - 1].Offset + Map->Regions[Map->RegionCount - 1].Size;
+  }
+
+  Region->Size          = Size;
+  Region->EraseTypeMask = EraseTypeMask;
+  Map->RegionCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Plan the next erase of a range.
+
+  Picks the erase type that erases the most of the range starting at Offset
+  without touching anything at or beyond End, so erasing a range by repeated
+  calls issues the fewest erase commands.
+
+  @param[in]  Map                  Erase map
+  @param[in]  Offset               Start of the range still to be erased
+  @param[in]  End                  End of the range to erase
+  @param[out] EraseEnd             End of the range erased by the command
+  @param[out] Command              Erase command to issue at Offset
+
+  @retval EFI_SUCCESS              Erase planned.
+  @retval EFI_INVALID_PARAMETER    Offset is outside the map, or the range is
+                                   not aligned to an erase type of its region.
+**/
+EFI_STATUS
+NorFlashEraseMapNext (
+  IN  CONST NOR_FLASH_ERASE_MAP  *Map,
+  IN  UINT64                     Offset,
+  IN  UINT64                     End,
+  OUT UINT64                     *EraseEnd,
+  OUT UINT8                      *Command
+  )
+{
+  CONST NOR_FLASH_ERASE_REGION  *Region;
+  UINT32                        Index;
+  UINT32                        Type;
+  UINT64                        BlockStart;
+  UINT64                        BlockEnd;
+  UINT64                        RegionEnd;
+  UINT64                        BestEnd;
+
+  Region = NULL;
+  for (Index = 0; Index < Map->RegionCount; Index++) {
+    if ((Offset >= Map->Regions[Index].Offset) &&
+        (Offset < Map->Regions[Index].Offset + Map->Regions[Index].Size))
+    {
+      Region = &Map->Regions[Index];
+      break;
+    }
+  }
+
+  if ((Region == NULL) || (End <= Offset)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  RegionEnd = Region->Offset + Region->Size;
+  BestEnd   = Offset;
+  for (Type = 0; Type < NOR_FLASH_ERASE_TYPE_COUNT; Type++) {
+    if ((Region->EraseTypeMask & (1 << Type)) == 0) {
+      continue;
+    }
+
+    // Part of the aligned erase block that lies within the region
+    BlockStart = Offset & ~((UINT64)Map->Types[Type].Size - 1);
+    BlockEnd   = BlockStart + Map->Types[Type].Size;
+    if (BlockStart < Region->Offset) {
+      BlockStart = Region->Offset;
+    }
+
+    if (BlockEnd > RegionEnd) {
+      BlockEnd = RegionEnd;
+    }
+
+    if ((BlockStart != Offset) || (BlockEnd > End)) {
+      continue;
+    }
+
+    if (BlockEnd > BestEnd) {
+      BestEnd  = BlockEnd;
+      *Command = Map->Types[Type].Command;
+    }
+  }
+
+  if (BestEnd == Offset) {
+    DEBUG ((DEBUG_ERROR, "%a: no erase type fits 0x%llx-0x%llx\n", __FUNCTION__, Offset, End));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *EraseEnd = BestEnd;
+  return EFI_SUCCESS;
+}
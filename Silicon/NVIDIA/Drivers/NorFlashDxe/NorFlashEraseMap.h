@@ -0,0 +1,85 @@
+/** @file
+
+  NOR Flash erase map
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __NOR_FLASH_ERASE_MAP_H__
+#define __NOR_FLASH_ERASE_MAP_H__
+
+#include <Uefi/UefiBaseType.h>
+
+#define NOR_FLASH_ERASE_TYPE_COUNT   4
+#define NOR_FLASH_ERASE_MAX_REGIONS  16
+
+typedef struct {
+  UINT32    Size;
+  UINT8     Command;
+} NOR_FLASH_ERASE_TYPE;
+
+//
+// An erase issued in a region erases the part of its aligned erase block that
+// lies within the region, so overlaid sectors (such as 4KB parameter sectors)
+// are erased separately from the rest of the block.
+//
+typedef struct {
+  UINT64    Offset;
+  UINT64    Size;
+  UINT8     EraseTypeMask;
+} NOR_FLASH_ERASE_REGION;
+
+typedef struct {
+  NOR_FLASH_ERASE_TYPE      Types[NOR_FLASH_ERASE_TYPE_COUNT];
+  UINT32                    RegionCount;
+  NOR_FLASH_ERASE_REGION    Regions[NOR_FLASH_ERASE_MAX_REGIONS];
+} NOR_FLASH_ERASE_MAP;
+
+/**
+  Append a region to the erase map.
+
+  @param[in, out] Map              Erase map
+  @param[in]      Size             Size of the region in bytes
+  @param[in]      EraseTypeMask    Erase types supported in the region
+
+  @retval EFI_SUCCESS              Region added.
+  @retval EFI_INVALID_PARAMETER    No usable erase type in the region.
+  @retval EFI_OUT_OF_RESOURCES     Too many regions.
+**/
+EFI_STATUS
+NorFlashEraseMapAddRegion (
+  IN OUT NOR_FLASH_ERASE_MAP  *Map,
+  IN     UINT64               Size,
+  IN     UINT8                EraseTypeMask
+  );
+
+/**
+  Plan the next erase of a range.
+
+  Picks the erase type that erases the most of the range starting at Offset
+  without touching anything at or beyond End, so erasing a range by repeated
+  calls issues the fewest erase commands.
+
+  @param[in]  Map                  Erase map
+  @param[in]  Offset               Start of the range still to be erased
+  @param[in]  End                  End of the range to erase
+  @param[out] EraseEnd             End of the range erased by the command
+  @param[out] Command              Erase command to issue at Offset
+
+  @retval EFI_SUCCESS              Erase planned.
+  @retval EFI_INVALID_PARAMETER    Offset is outside the map, or the range is
+                                   not aligned to an erase type of its region.
+**/
+EFI_STATUS
+NorFlashEraseMapNext (
+  IN  CONST NOR_FLASH_ERASE_MAP  *Map,
+  IN  UINT64                     Offset,
+  IN  UINT64                     End,
+  OUT UINT64                     *EraseEnd,
+  OUT UINT8                      *Command
+  );
+
+#endif
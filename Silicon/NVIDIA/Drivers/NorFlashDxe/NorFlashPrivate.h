@@ -31,6 +31,8 @@
 #include <Protocol/QspiController.h>
 #include <Protocol/DeviceTreeNode.h>
 
+#include "NorFlashEraseMap.h"
+
 #define NOR_FLASH_SIGNATURE  SIGNATURE_32('N','O','R','F')
 #define NOR_SFDP_SIGNATURE   SIGNATURE_32('S','F','D','P')
 #define QSPI_BASE_ADDRESS    0x3270000
@@ -41,6 +43,11 @@
 #define NOR_READ_SR1           0x5
 #define NOR_SR1_WEL_BMSK       0x2
 #define NOR_SR1_WIP_BMSK       0x1
+#define NOR_SR1_QE_BMSK        0x40
+#define NOR_READ_SR2           0x35
+#define NOR_SR2_QE_BMSK        0x2
+#define NOR_READ_SR2_QER3      0x3F
+#define NOR_SR2_QER3_QE_BMSK   0x80
 #define NOR_SR1_WEL_RETRY_CNT  2000
 #define NOR_SR1_WIP_RETRY_CNT  2000
 
@@ -50,6 +57,9 @@
 #define NOR_WRITE_DATA_CMD      0x12
 #define NOR_FAST_READ_DATA_CMD  0x0C
 #define NOR_READ_DATA_CMD       0x13
+#define NOR_QUAD_OUT_READ_CMD   0x6C
+#define NOR_QUAD_IO_READ_CMD    0xEC
+#define NOR_QUAD_WRITE_CMD      0x34
 #define NOR_WREN_DISABLE        0x4
 #define NOR_WREN_ENABLE         0x6
 
@@ -77,6 +87,18 @@
 
 #define NOR_FAST_CMD_THRESH_FREQ  100000000
 
+// Quad enable requirements from the SFDP basic parameter table
+#define NOR_SFDP_QER_NONE           0
+#define NOR_SFDP_QER_SR1_BIT6       2
+#define NOR_SFDP_QER_SR2_BIT7       3
+#define NOR_SFDP_QER_SR2_BIT1_READ  5
+#define NOR_SFDP_QER_SR2_BIT1_31H   6
+
+#define NOR_MULTI_LANE_VERIFY_SIZE  SIZE_4KB
+
+// Time a resumed erase is given to progress before it can be suspended again
+#define NOR_ERASE_RESUME_INTERVAL  100
+
 #define NOR_READ_RDID_CMD              0x9f
 #define NOR_READ_RDID_RESP_SIZE        3
 #define NOR_RDID_MANU_ID_OFFSET        0
@@ -112,32 +134,54 @@ typedef struct {
 } NOR_SFDP_PARAM_ERASE_TYPE;
 
 typedef struct {
-  UINT8                        EraseSupport4KB   : 2;
-  UINT8                        Reserved          : 6;
+  UINT8                        EraseSupport4KB    : 2;
+  UINT8                        Reserved           : 6;
   UINT8                        EraseInstruction4KB;
-  UINT16                       Reserved2;
+  UINT8                        Reserved2          : 5;
+  UINT8                        QuadIOSupport      : 1;
+  UINT8                        QuadOutSupport     : 1;
+  UINT8                        Reserved2a         : 1;
+  UINT8                        Reserved2b;
   UINT32                       MemoryDensity;
-  UINT32                       Reserved3;
+  UINT8                        QuadIODummyCycles  : 5;
+  UINT8                        QuadIOModeCycles   : 3;
+  UINT8                        QuadIOInstruction;
+  UINT8                        QuadOutDummyCycles : 5;
+  UINT8                        QuadOutModeCycles  : 3;
+  UINT8                        QuadOutInstruction;
   UINT16                       Reserved4;
-  UINT8                        DualIODummyCycles : 5;
-  UINT8                        DualIOModeCycles  : 3;
+  UINT8                        DualIODummyCycles  : 5;
+  UINT8                        DualIOModeCycles   : 3;
   UINT8                        DualIOInstruction;
   UINT32                       Reserved5;
   UINT32                       Reserved6;
   UINT32                       Reserved7;
   NOR_SFDP_PARAM_ERASE_TYPE    EraseType[NOR_SFDP_ERASE_COUNT];
   UINT32                       Reserved8;
-  UINT8                        Reserved9         : 4;
-  UINT8                        PageSize          : 4;
-  UINT32                       Reserved10        : 24;
+  UINT8                        Reserved9          : 4;
+  UINT8                        PageSize           : 4;
+  UINT32                       Reserved10         : 24;
+  UINT32                       Reserved11         : 31;
+  UINT32                       SuspendUnsupported : 1;
+  UINT8                        ProgramResumeInstruction;
+  UINT8                        ProgramSuspendInstruction;
+  UINT8                        ResumeInstruction;
+  UINT8                        SuspendInstruction;
+  UINT32                       Reserved13;
+  UINT32                       Reserved14         : 20;
+  UINT32                       QuadEnableReq      : 3;
+  UINT32                       Reserved15         : 9;
 } NOR_SFDP_PARAM_BASIC_TBL;
 
 typedef struct {
   BOOLEAN    ReadCmd13          : 1;
   BOOLEAN    ReadCmd0C          : 1;
-  UINT8      Reserved2          : 4;
+  UINT8      Reserved2          : 2;
+  BOOLEAN    ReadCmd6C          : 1;
+  BOOLEAN    ReadCmdEC          : 1;
   BOOLEAN    WriteCmd12         : 1;
-  UINT8      Reserved3          : 2;
+  BOOLEAN    WriteCmd34         : 1;
+  UINT8      Reserved3          : 1;
   UINT8      EraseTypeSupported : 4;
   UINT32     Reserved4          : 19;
   UINT8      EraseInstruction[NOR_SFDP_ERASE_COUNT];
@@ -158,18 +202,45 @@ typedef struct {
 } NOR_SFDP_PARAM_SECTOR_REGION;
 #pragma pack()
 
+//
+// Multi lane command. Command 0 if not supported.
+//
 typedef struct {
-  NOR_FLASH_ATTRIBUTES    FlashAttributes;
-  UINT8                   UniformEraseCmd;
-  UINT8                   HybridEraseCmd;
-  UINT32                  PageSize;
-  UINT8                   ReadWaitCycles;
-  UINT64                  HybridMemoryDensity;
-  UINT32                  HybridBlockSize;
-  BOOLEAN                 FastReadSupport;
-  NOR_FLASH_MODE          AccessMode;
+  UINT8             Command;
+  UINT8             WaitCycles;
+  QSPI_BUS_WIDTH    AddressBusWidth;
+  QSPI_BUS_WIDTH    DataBusWidth;
+} NOR_FLASH_MULTI_LANE_CMD;
+
+typedef struct {
+  NOR_FLASH_ATTRIBUTES        FlashAttributes;
+  NOR_FLASH_ERASE_MAP         EraseMap;
+  UINT32                      PageSize;
+  UINT8                       ReadWaitCycles;
+  BOOLEAN                     FastReadSupport;
+  NOR_FLASH_MODE              AccessMode;
+  QSPI_BUS_WIDTH              RxBusWidth;
+  QSPI_BUS_WIDTH              TxBusWidth;
+  NOR_FLASH_MULTI_LANE_CMD    MultiLaneRead;
+  NOR_FLASH_MULTI_LANE_CMD    MultiLaneWrite;
+  UINT8                       EraseSuspendCmd;
+  UINT8                       EraseResumeCmd;
 } NOR_FLASH_PRIVATE_ATTRIBUTES;
 
+//
+// Erase started by EraseAsync. Erase commands are issued one at a time and
+// Next is where the command following the one in flight starts.
+//
+typedef struct {
+  BOOLEAN                     Pending;
+  BOOLEAN                     Suspended;
+  UINT64                      Start;
+  UINT64                      Next;
+  UINT64                      End;
+  NOR_FLASH_ERASE_COMPLETE    Callback;
+  VOID                        *Context;
+} NOR_FLASH_PENDING_ERASE;
+
 typedef struct {
   UINT32                             Signature;
   UINT32                             FlashInstance;
@@ -186,6 +257,7 @@ typedef struct {
   NOR_FLASH_PRIVATE_ATTRIBUTES       PrivateFlashAttributes;
   EFI_EVENT                          VirtualAddrChangeEvent;
   UINT8                              *CommandBuffer;
+  NOR_FLASH_PENDING_ERASE            PendingErase;
 } NOR_FLASH_PRIVATE_DATA;
 
 typedef struct {
@@ -244,8 +244,11 @@ ReadNorFlashSFDP (
   NOR_SFDP_PARAM_SECTOR_DESCRIPTOR  *SFDPParamSectorTbl;
   UINT32                            SFDPParamSectorTblSize;
   NOR_SFDP_PARAM_SECTOR_REGION      *SFDPParamSectorTblRegion;
-  NOR_SFDP_PARAM_SECTOR_REGION      *SFDPParamSectorTblFirstRegion;
   UINT8                             NumRegions;
+  UINT32                            Index;
+  NOR_FLASH_ERASE_MAP               *EraseMap;
+  NOR_FLASH_ERASE_REGION            *EraseRegion;
+  NOR_FLASH_ERASE_REGION            *BiggestEraseRegion;
   UINT32                            MemoryDensity;
   QSPI_TRANSACTION_PACKET           Packet;
 
@@ -464,11 +467,35 @@ ReadNorFlashSFDP (
     Private->PrivateFlashAttributes.ReadWaitCycles = NOR_SFDP_FAST_READ_DEF_WAIT;
   }
 
+  // Collect the erase types that have a 4 byte address instruction
+  EraseMap = &Private->PrivateFlashAttributes.EraseMap;
+  ZeroMem (EraseMap, sizeof (NOR_FLASH_ERASE_MAP));
+  for (Count = 0; Count < NOR_SFDP_ERASE_COUNT; Count++) {
+    if ((SFDPParamBasicTbl->EraseType[Count].Size != 0) &&
+        (SFDPParam4ByteInstructionTbl->EraseTypeSupported & (1 << Count)))
+    {
+      EraseMap->Types[Count].Size    = 1 << SFDPParamBasicTbl->EraseType[Count].Size;
+      EraseMap->Types[Count].Command = SFDPParam4ByteInstructionTbl->EraseInstruction[Count];
+    }
+  }
+
   // If uniform 4K erase is supported, use that mode.
   if ((SFDPParamBasicTbl->EraseSupport4KB == NOR_SFDP_4KB_ERS_SUPPORTED) &&
       (SFDPParamBasicTbl->EraseInstruction4KB != NOR_SFDP_4KB_ERS_UNSUPPORTED))
   {
     Private->PrivateFlashAttributes.FlashAttributes.BlockSize = SIZE_4KB;
+
+    // Every erase type can be used anywhere in the flash.
+    Status = NorFlashEraseMapAddRegion (
+               EraseMap,
+               Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity,
+               MAX_UINT8
+               );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's uniform erase table supported in SFDP.\n", __FUNCTION__));
+      Status = EFI_UNSUPPORTED;
+      goto ErrorExit;
+    }
   } else {
     // Find the sector map parameter table header
     for (Count = SFDPHeader.NumParamHdrs; Count >= 0; Count--) {
@@ -540,57 +567,52 @@ ReadNorFlashSFDP (
       goto ErrorExit;
     }
 
-    // Out of the regions found in the map, find the region with biggest size.
-    SFDPParamSectorTblRegion      = (NOR_SFDP_PARAM_SECTOR_REGION *)&SFDPParamSectorTbl[Count++];
-    SFDPParamSectorTblFirstRegion = SFDPParamSectorTblRegion;
-    while (NumRegions > 0) {
-      if (((NOR_SFDP_PARAM_SECTOR_REGION *)&SFDPParamSectorTbl[Count])->RegionSize >
-          SFDPParamSectorTblRegion->RegionSize)
-      {
-        SFDPParamSectorTblRegion = (NOR_SFDP_PARAM_SECTOR_REGION *)&SFDPParamSectorTbl[Count];
+    // Add all regions found in the map, the block size is the smallest erase of
+    // the region with biggest size.
+    BiggestEraseRegion = NULL;
+    for (Index = 0; Index <= NumRegions; Index++, Count++) {
+      if (Count >= SFDPParamSectorTblHeader->ParamTblLen) {
+        DEBUG ((EFI_D_ERROR, "%a: NOR flash's SFDP sector parameter mapping table truncated.\n", __FUNCTION__));
+        Status = EFI_UNSUPPORTED;
+        goto ErrorExit;
       }
 
-      Count++;
-      NumRegions--;
-    }
-
-    for (Count = 0; Count < NOR_SFDP_ERASE_COUNT; Count++) {
-      if (SFDPParamSectorTblRegion->EraseTypeSupported & (1 << Count)) {
-        break;
+      SFDPParamSectorTblRegion = (NOR_SFDP_PARAM_SECTOR_REGION *)&SFDPParamSectorTbl[Count];
+      Status                   = NorFlashEraseMapAddRegion (
+                                   EraseMap,
+                                   (SFDPParamSectorTblRegion->RegionSize + 1) * NOR_SFDP_ERASE_REGION_SIZE,
+                                   SFDPParamSectorTblRegion->EraseTypeSupported
+                                   );
+      if (EFI_ERROR (Status)) {
+        DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's SFDP sector parameter erase table.\n", __FUNCTION__));
+        Status = EFI_UNSUPPORTED;
+        goto ErrorExit;
       }
-    }
 
-    if (Count >=  NOR_SFDP_ERASE_COUNT) {
-      DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's SFDP sector parameter erase table.\n", __FUNCTION__));
-      Status = EFI_UNSUPPORTED;
-      goto ErrorExit;
+      EraseRegion = &EraseMap->Regions[EraseMap->RegionCount - 1];
+      if ((BiggestEraseRegion == NULL) || (EraseRegion->Size > BiggestEraseRegion->Size)) {
+        BiggestEraseRegion = EraseRegion;
+      }
     }
 
-    Private->PrivateFlashAttributes.FlashAttributes.BlockSize = 1 << SFDPParamBasicTbl->EraseType[Count].Size;
-
-    // Out of the regions found in the map, first region is the one used for hybrid.
     for (Count = 0; Count < NOR_SFDP_ERASE_COUNT; Count++) {
-      if (SFDPParamSectorTblFirstRegion->EraseTypeSupported & (1 << Count)) {
+      if (BiggestEraseRegion->EraseTypeMask & (1 << Count)) {
         break;
       }
     }
 
-    if (Count >=  NOR_SFDP_ERASE_COUNT) {
-      DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's SFDP first sector parameter erase table.\n", __FUNCTION__));
-      Status = EFI_UNSUPPORTED;
-      goto ErrorExit;
-    }
+    Private->PrivateFlashAttributes.FlashAttributes.BlockSize = EraseMap->Types[Count].Size;
 
-    Private->PrivateFlashAttributes.HybridMemoryDensity = (SFDPParamSectorTblFirstRegion->RegionSize + 1) *
-                                                          NOR_SFDP_ERASE_REGION_SIZE;
-    Private->PrivateFlashAttributes.HybridBlockSize = 1 << SFDPParamBasicTbl->EraseType[Count].Size;
+    // Any part of the flash not described by the map uses the last region.
+    EraseRegion = &EraseMap->Regions[EraseMap->RegionCount - 1];
+    if (EraseRegion->Offset + EraseRegion->Size < Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity) {
+      EraseRegion->Size = Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity - EraseRegion->Offset;
+    }
   }
 
-  // Look up 4 byte uniform erase command based on the block size.
+  // Erase of a single block has to be supported.
   for (Count = 0; Count < NOR_SFDP_ERASE_COUNT; Count++) {
-    if (Private->PrivateFlashAttributes.FlashAttributes.BlockSize ==
-        (1 << SFDPParamBasicTbl->EraseType[Count].Size))
-    {
+    if (Private->PrivateFlashAttributes.FlashAttributes.BlockSize == EraseMap->Types[Count].Size) {
       break;
     }
   }
@@ -601,40 +623,6 @@ ReadNorFlashSFDP (
     goto ErrorExit;
   }
 
-  if (!(SFDPParam4ByteInstructionTbl->EraseTypeSupported & (1 << Count))) {
-    DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's uniform erase table supported in SFDP.\n", __FUNCTION__));
-    Status = EFI_UNSUPPORTED;
-    goto ErrorExit;
-  }
-
-  Private->PrivateFlashAttributes.UniformEraseCmd = SFDPParam4ByteInstructionTbl->EraseInstruction[Count];
-
-  // Look up 4 byte hybrid erase command based on the block size if uniform block size
-  // is not already 4KB.
-  if (Private->PrivateFlashAttributes.FlashAttributes.BlockSize != SIZE_4KB) {
-    for (Count = 0; Count < NOR_SFDP_ERASE_COUNT; Count++) {
-      if (Private->PrivateFlashAttributes.HybridBlockSize ==
-          (1 << SFDPParamBasicTbl->EraseType[Count].Size))
-      {
-        break;
-      }
-    }
-
-    if (Count >=  NOR_SFDP_ERASE_COUNT) {
-      DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's hybrid block size in SFDP sector parameter erase table.\n", __FUNCTION__));
-      Status = EFI_UNSUPPORTED;
-      goto ErrorExit;
-    }
-
-    if (!(SFDPParam4ByteInstructionTbl->EraseTypeSupported & (1 << Count))) {
-      DEBUG ((EFI_D_ERROR, "%a: Could not find compatible NOR flash's hybrid erase table supported in SFDP.\n", __FUNCTION__));
-      Status = EFI_UNSUPPORTED;
-      goto ErrorExit;
-    }
-
-    Private->PrivateFlashAttributes.HybridEraseCmd = SFDPParam4ByteInstructionTbl->EraseInstruction[Count];
-  }
-
   // If basic parameter table size is more than NOR_SFDP_PRM_TBL_LEN_JESD216,
   // read page size from the table. Otherwise default to NOR_SFDP_WRITE_DEF_PAGE
   if (SFDPParamBasicTblSize > NOR_SFDP_PRM_TBL_LEN_JESD216) {
@@ -650,6 +638,15 @@ ReadNorFlashSFDP (
     Private->PrivateFlashAttributes.PageSize = NOR_SFDP_WRITE_DEF_PAGE;
   }
 
+  // Erase suspend and resume instructions are only described by JESD216A and
+  // later basic parameter tables.
+  if ((SFDPParamBasicTblSize >= sizeof (NOR_SFDP_PARAM_BASIC_TBL)) &&
+      !SFDPParamBasicTbl->SuspendUnsupported)
+  {
+    Private->PrivateFlashAttributes.EraseSuspendCmd = SFDPParamBasicTbl->SuspendInstruction;
+    Private->PrivateFlashAttributes.EraseResumeCmd  = SFDPParamBasicTbl->ResumeInstruction;
+  }
+
   Private->FlashInstance = NOR_SFDP_SIGNATURE;
 
 ErrorExit:
@@ -724,6 +721,322 @@ NorFlashSetMode (
   return EFI_SUCCESS;
 }
 
+/**
+  Send a single byte command to the NOR Flash.
+
+  @param[in] Private               Driver's private data
+  @param[in] Cmd                   Command to send
+
+  @retval EFI_SUCCESS              Operation successful.
+  @retval others                   Error occurred
+**/
+STATIC
+EFI_STATUS
+NorFlashSendCommand (
+  IN NOR_FLASH_PRIVATE_DATA  *Private,
+  IN UINT8                   Cmd
+  )
+{
+  QSPI_TRANSACTION_PACKET  Packet;
+
+  Packet.TxBuf      = &Cmd;
+  Packet.RxBuf      = NULL;
+  Packet.TxLen      = sizeof (Cmd);
+  Packet.RxLen      = 0;
+  Packet.WaitCycles = 0;
+  Packet.ChipSelect = Private->QspiChipSelect;
+  Packet.Control    = Private->PrivateFlashAttributes.AccessMode == NOR_FLASH_MODE_QUICK ? QSPI_CONTROLLER_CONTROL_FAST_MODE : 0;
+
+  return Private->QspiController->PerformTransaction (Private->QspiController, &Packet);
+}
+
+/**
+  Issue the largest erase command that starts at Offset and ends at or before
+  End, without waiting for it to complete.
+
+  @param[in]  Private              Driver's private data
+  @param[in]  Offset               Offset to start erasing from
+  @param[in]  End                  Offset to stop erasing at
+  @param[out] EraseEnd             Offset the issued erase stops at
+
+  @retval EFI_SUCCESS              Operation successful.
+  @retval others                   Error occurred
+**/
+STATIC
+EFI_STATUS
+NorFlashEraseIssue (
+  IN  NOR_FLASH_PRIVATE_DATA  *Private,
+  IN  UINT64                  Offset,
+  IN  UINT64                  End,
+  OUT UINT64                  *EraseEnd
+  )
+{
+  EFI_STATUS               Status;
+  UINT32                   CmdSize;
+  UINT32                   Count;
+  UINT32                   AddressShift;
+  UINT32                   Address;
+  UINT8                    EraseCmd;
+  QSPI_TRANSACTION_PACKET  Packet;
+
+  Status = NorFlashEraseMapNext (&Private->PrivateFlashAttributes.EraseMap, Offset, End, EraseEnd, &EraseCmd);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "%a: Could not find NOR flash erase for 0x%llx.\n", __FUNCTION__, Offset));
+    return Status;
+  }
+
+  Status = ConfigureNorFlashWriteEnLatch (Private, TRUE);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "%a: Could not enable NOR flash WREN.\n", __FUNCTION__));
+    return Status;
+  }
+
+  CmdSize = NOR_CMD_SIZE + NOR_ADDR_SIZE;
+  ZeroMem (Private->CommandBuffer, CmdSize);
+
+  AddressShift = 0;
+  Address      = (UINT32)Offset;
+  for (Count = (CmdSize - 1); Count > 0; Count--) {
+    Private->CommandBuffer[Count] = (Address & (0xFF << AddressShift)) >> AddressShift;
+    AddressShift                 += 8;
+  }
+
+  Private->CommandBuffer[0] = EraseCmd;
+
+  Packet.TxBuf      = Private->CommandBuffer;
+  Packet.TxLen      = CmdSize;
+  Packet.RxBuf      = NULL;
+  Packet.RxLen      = 0;
+  Packet.WaitCycles = 0;
+  Packet.ChipSelect = Private->QspiChipSelect;
+  Packet.Control    = Private->PrivateFlashAttributes.AccessMode == NOR_FLASH_MODE_QUICK ? QSPI_CONTROLLER_CONTROL_FAST_MODE : 0;
+
+  Status = Private->QspiController->PerformTransaction (Private->QspiController, &Packet);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "%a: Could not erase data from NOR flash.\n", __FUNCTION__));
+  }
+
+  return Status;
+}
+
+/**
+  Finish the pending erase and notify its owner.
+
+  @param[in] Private               Driver's private data
+  @param[in] Status                Status of the erase
+**/
+STATIC
+VOID
+NorFlashPendingEraseComplete (
+  IN NOR_FLASH_PRIVATE_DATA  *Private,
+  IN EFI_STATUS              Status
+  )
+{
+  NOR_FLASH_ERASE_COMPLETE  Callback;
+  VOID                      *Context;
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "%a: NOR flash erase of 0x%llx-0x%llx failed: %r\n", __FUNCTION__, Private->PendingErase.Start, Private->PendingErase.End - 1, Status));
+  } else {
+    DEBUG ((EFI_D_INFO, "%a: Successfully erased 0x%llx-0x%llx from NOR flash.\n", __FUNCTION__, Private->PendingErase.Start, Private->PendingErase.End - 1));
+  }
+
+  // The callback is free to start another erase.
+  Callback = Private->PendingErase.Callback;
+  Context  = Private->PendingErase.Context;
+  ZeroMem (&Private->PendingErase, sizeof (Private->PendingErase));
+
+  if (Callback != NULL) {
+    Callback (Context, Status);
+  }
+}
+
+/**
+  Resume the pending erase if it was suspended.
+
+  @param[in] Private               Driver's private data
+
+  @retval EFI_SUCCESS              Operation successful.
+  @retval others                   Error occurred
+**/
+STATIC
+EFI_STATUS
+NorFlashPendingEraseResume (
+  IN NOR_FLASH_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  if (!Private->PendingErase.Suspended) {
+    return EFI_SUCCESS;
+  }
+
+  Status = NorFlashSendCommand (Private, Private->PrivateFlashAttributes.EraseResumeCmd);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "%a: Could not resume NOR flash erase.\n", __FUNCTION__));
+    return Status;
+  }
+
+  Private->PendingErase.Suspended = FALSE;
+
+  // An erase suspended again right away would never make progress.
+  MicroSecondDelay (NOR_ERASE_RESUME_INTERVAL);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Progress the pending erase, issuing the next erase command each time the
+  previous one completes.
+
+  @param[in] Private               Driver's private data
+  @param[in] Wait                  Wait for the erase to complete
+
+  @retval EFI_SUCCESS              No erase pending.
+  @retval EFI_NOT_READY            Erase still in progress.
+  @retval others                   Erase failed
+**/
+STATIC
+EFI_STATUS
+NorFlashPendingEraseProcess (
+  IN NOR_FLASH_PRIVATE_DATA  *Private,
+  IN BOOLEAN                 Wait
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       RegCmd;
+  UINT8       Resp;
+
+  if (!Private->PendingErase.Pending) {
+    return EFI_SUCCESS;
+  }
+
+  Status = NorFlashPendingEraseResume (Private);
+  if (EFI_ERROR (Status)) {
+    goto Complete;
+  }
+
+  RegCmd = NOR_READ_SR1;
+
+  while (TRUE) {
+    if (Wait) {
+      Status = WaitNorFlashWriteComplete (Private);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((EFI_D_ERROR, "%a: Could not complete NOR flash erase.\n", __FUNCTION__));
+        goto Complete;
+      }
+    } else {
+      Status = ReadNorFlashRegister (Private, &RegCmd, sizeof (RegCmd), &Resp);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((EFI_D_ERROR, "%a: Could not read NOR flash status 1 register.\n", __FUNCTION__));
+        goto Complete;
+      }
+
+      if ((Resp & NOR_SR1_WIP_BMSK) != 0) {
+        return EFI_NOT_READY;
+      }
+    }
+
+    Status = ConfigureNorFlashWriteEnLatch (Private, FALSE);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((EFI_D_ERROR, "%a: Could not disable NOR flash WREN.\n", __FUNCTION__));
+      goto Complete;
+    }
+
+    if (Private->PendingErase.Next >= Private->PendingErase.End) {
+      break;
+    }
+
+    Status = NorFlashEraseIssue (
+               Private,
+               Private->PendingErase.Next,
+               Private->PendingErase.End,
+               &Private->PendingErase.Next
+               );
+    if (EFI_ERROR (Status)) {
+      goto Complete;
+    }
+
+    if (!Wait) {
+      return EFI_NOT_READY;
+    }
+  }
+
+Complete:
+  NorFlashPendingEraseComplete (Private, Status);
+
+  return Status;
+}
+
+/**
+  Get the pending erase out of the way of a read. The erase is suspended if
+  the flash supports it and the read is outside the erased range, otherwise
+  the erase is completed first.
+
+  A failure of the erase is reported to its owner through the completion
+  callback, not to the read.
+
+  @param[in] Private               Driver's private data
+  @param[in] Offset                Offset of the read
+  @param[in] Size                  Size of the read
+
+  @retval EFI_SUCCESS              The read can go ahead.
+  @retval others                   The flash status could not be read.
+**/
+STATIC
+EFI_STATUS
+NorFlashPendingEraseSuspend (
+  IN NOR_FLASH_PRIVATE_DATA  *Private,
+  IN UINT32                  Offset,
+  IN UINT32                  Size
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       RegCmd;
+  UINT8       Resp;
+
+  if (!Private->PendingErase.Pending || Private->PendingErase.Suspended) {
+    return EFI_SUCCESS;
+  }
+
+  if ((Private->PrivateFlashAttributes.EraseSuspendCmd == 0) ||
+      ((Offset < Private->PendingErase.End) && ((UINT64)Offset + Size > Private->PendingErase.Start)))
+  {
+    NorFlashPendingEraseProcess (Private, TRUE);
+    return EFI_SUCCESS;
+  }
+
+  // Nothing to suspend between erase commands, the next one is issued later.
+  RegCmd = NOR_READ_SR1;
+  Status = ReadNorFlashRegister (Private, &RegCmd, sizeof (RegCmd), &Resp);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "%a: Could not read NOR flash status 1 register.\n", __FUNCTION__));
+    return Status;
+  }
+
+  if ((Resp & NOR_SR1_WIP_BMSK) == 0) {
+    return EFI_SUCCESS;
+  }
+
+  // Fall back to completing the erase if it can not be suspended.
+  Status = NorFlashSendCommand (Private, Private->PrivateFlashAttributes.EraseSuspendCmd);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "%a: Could not suspend NOR flash erase.\n", __FUNCTION__));
+    NorFlashPendingEraseProcess (Private, TRUE);
+    return EFI_SUCCESS;
+  }
+
+  // Busy clears once the erase is suspended.
+  Private->PendingErase.Suspended = TRUE;
+  Status                          = WaitNorFlashWriteComplete (Private);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "%a: Could not suspend NOR flash erase.\n", __FUNCTION__));
+    NorFlashPendingEraseProcess (Private, TRUE);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Read data from NOR Flash.
 
@@ -768,6 +1081,12 @@ NorFlashRead (
     return EFI_INVALID_PARAMETER;
   }
 
+  Status = NorFlashPendingEraseSuspend (Private, Offset, Size);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "%a: Could not suspend pending NOR flash erase.\n", __FUNCTION__));
+    goto ErrorExit;
+  }
+
   CmdSize = NOR_CMD_SIZE + NOR_ADDR_SIZE;
   ZeroMem (Private->CommandBuffer, CmdSize);
 
@@ -809,6 +1128,8 @@ NorFlashRead (
   DEBUG ((EFI_D_INFO, "%a: Successfully read data from NOR flash.\n", __FUNCTION__));
 
 ErrorExit:
+  // Resume the erase, or start its next command if it got between two.
+  NorFlashPendingEraseProcess (Private, FALSE);
 
   return Status;
 }
@@ -899,10 +1220,12 @@ NorFlashReadBlock (
 /**
   Erase data from NOR Flash.
 
+  The blocks are erased with the fewest erase commands allowed by the erase
+  map of the flash, rather than one command per block.
+
   @param[in] This                  Instance to protocol
-  @param[in] Offset                Logical block to start erasing from
+  @param[in] Lba                   Logical block to start erasing from
   @param[in] NumLba                Number of block to be erased
-  @param[in] Hybrid                Use hybrid region
 
   @retval EFI_SUCCESS              Operation successful.
   @retval others                   Error occurred
@@ -911,22 +1234,17 @@ EFI_STATUS
 NorFlashErase (
   IN NVIDIA_NOR_FLASH_PROTOCOL  *This,
   IN UINT32                     Lba,
-  IN UINT32                     NumLba,
-  IN BOOLEAN                    Hybrid
+  IN UINT32                     NumLba
   )
 {
-  EFI_STATUS               Status;
-  UINT32                   CmdSize;
-  UINT32                   Count;
-  UINT32                   Block;
-  UINT32                   AddressShift;
-  QSPI_TRANSACTION_PACKET  Packet;
-  NOR_FLASH_PRIVATE_DATA   *Private;
-  UINT32                   Offset;
-  UINT32                   LastBlock;
-  UINT64                   MemoryDensity;
-  UINT32                   BlockSize;
-  UINT8                    EraseCmd;
+  EFI_STATUS              Status;
+  NOR_FLASH_PRIVATE_DATA  *Private;
+  UINT32                  LastBlock;
+  UINT32                  BlockSize;
+  UINT64                  Offset;
+  UINT64                  End;
+  UINT64                  EraseEnd;
+  UINT32                  EraseCount;
 
   if ((This == NULL) ||
       (NumLba == 0))
@@ -936,20 +1254,8 @@ NorFlashErase (
 
   Private = NOR_FLASH_PRIVATE_DATA_FROM_NOR_FLASH_PROTOCOL (This);
 
-  if (Hybrid) {
-    MemoryDensity = Private->PrivateFlashAttributes.HybridMemoryDensity;
-    BlockSize     = Private->PrivateFlashAttributes.HybridBlockSize;
-    EraseCmd      = Private->PrivateFlashAttributes.HybridEraseCmd;
-    if ((MemoryDensity == 0) || (BlockSize == 0) || (EraseCmd == 0)) {
-      return EFI_UNSUPPORTED;
-    }
-  } else {
-    MemoryDensity = Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity;
-    BlockSize     = Private->PrivateFlashAttributes.FlashAttributes.BlockSize;
-    EraseCmd      = Private->PrivateFlashAttributes.UniformEraseCmd;
-  }
-
-  LastBlock = (MemoryDensity / BlockSize) - 1;
+  BlockSize = Private->PrivateFlashAttributes.FlashAttributes.BlockSize;
+  LastBlock = (Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity / BlockSize) - 1;
 
   if ((Lba > LastBlock) ||
       ((Lba + NumLba - 1) > LastBlock))
@@ -957,59 +1263,16 @@ NorFlashErase (
     return EFI_INVALID_PARAMETER;
   }
 
-  // To uniform erase first block, must also hybrid erase the hybrid region
-  if (!Hybrid &&
-      (Lba == 0) &&
-      (Private->PrivateFlashAttributes.HybridMemoryDensity > 0))
-  {
-    Status = NorFlashErase (
-               This,
-               0,
-               Private->PrivateFlashAttributes.HybridMemoryDensity /
-               Private->PrivateFlashAttributes.HybridBlockSize,
-               TRUE
-               );
-    if (EFI_ERROR (Status)) {
-      DEBUG ((
-        EFI_D_ERROR,
-        "%a: Failed hybrid erase: %r\n",
-        __FUNCTION__,
-        Status
-        ));
-      goto ErrorExit;
-    }
-  }
-
-  CmdSize = NOR_CMD_SIZE + NOR_ADDR_SIZE;
-  ZeroMem (Private->CommandBuffer, CmdSize);
-
-  for (Block = Lba; Block < (Lba + NumLba); Block++) {
-    Status = ConfigureNorFlashWriteEnLatch (Private, TRUE);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((EFI_D_ERROR, "%a: Could not enable NOR flash WREN.\n", __FUNCTION__));
-      goto ErrorExit;
-    }
-
-    AddressShift = 0;
-    Offset       = Block * BlockSize;
-    for (Count = (CmdSize - 1); Count > 0; Count--) {
-      Private->CommandBuffer[Count] = (Offset & (0xFF << AddressShift)) >> AddressShift;
-      AddressShift                 += 8;
-    }
+  NorFlashPendingEraseProcess (Private, TRUE);
 
-    Private->CommandBuffer[0] = EraseCmd;
-
-    Packet.TxBuf      = Private->CommandBuffer;
-    Packet.TxLen      = CmdSize;
-    Packet.RxBuf      = NULL;
-    Packet.RxLen      = 0;
-    Packet.WaitCycles = 0;
-    Packet.ChipSelect = Private->QspiChipSelect;
-    Packet.Control    = Private->PrivateFlashAttributes.AccessMode == NOR_FLASH_MODE_QUICK ? QSPI_CONTROLLER_CONTROL_FAST_MODE : 0;
+  Offset     = (UINT64)Lba * BlockSize;
+  End        = Offset + (UINT64)NumLba * BlockSize;
+  EraseCount = 0;
+  Status     = EFI_SUCCESS;
 
-    Status = Private->QspiController->PerformTransaction (Private->QspiController, &Packet);
+  while (Offset < End) {
+    Status = NorFlashEraseIssue (Private, Offset, End, &EraseEnd);
     if (EFI_ERROR (Status)) {
-      DEBUG ((EFI_D_ERROR, "%a: Could not erase data from NOR flash.\n", __FUNCTION__));
       goto ErrorExit;
     }
 
@@ -1024,9 +1287,12 @@ NorFlashErase (
       DEBUG ((EFI_D_ERROR, "%a: Could not enable NOR flash WREN.\n", __FUNCTION__));
       goto ErrorExit;
     }
+
+    Offset = EraseEnd;
+    EraseCount++;
   }
 
-  DEBUG ((EFI_D_INFO, "%a: Successfully erased data from NOR flash.\n", __FUNCTION__));
+  DEBUG ((EFI_D_INFO, "%a: Successfully erased %u blocks from NOR flash with %u commands.\n", __FUNCTION__, NumLba, EraseCount));
 
 ErrorExit:
 
@@ -1050,7 +1316,7 @@ NorFlashUniformErase (
   IN UINT32                     NumLba
   )
 {
-  return NorFlashErase (This, Lba, NumLba, FALSE);
+  return NorFlashErase (This, Lba, NumLba);
 }
 
 EFI_STATUS
@@ -1087,6 +1353,107 @@ NorFlashUniformEraseQuick (
   return NorFlashUniformErase (This, Lba, NumLba);
 }
 
+/**
+  Start erasing data from NOR Flash without waiting for it to complete.
+
+  @param[in] This                  Instance to protocol
+  @param[in] Lba                   Logical block to start erasing from
+  @param[in] NumLba                Number of block to be erased
+  @param[in] Callback              Optional function called on completion
+  @param[in] Context               Context passed to Callback
+
+  @retval EFI_SUCCESS              Erase started.
+  @retval EFI_ALREADY_STARTED      Another erase is pending.
+  @retval others                   Error occurred
+**/
+EFI_STATUS
+NorFlashEraseAsync (
+  IN NVIDIA_NOR_FLASH_PROTOCOL  *This,
+  IN UINT32                     Lba,
+  IN UINT32                     NumLba,
+  IN NOR_FLASH_ERASE_COMPLETE   Callback OPTIONAL,
+  IN VOID                       *Context OPTIONAL
+  )
+{
+  EFI_STATUS              Status;
+  NOR_FLASH_PRIVATE_DATA  *Private;
+  UINT32                  LastBlock;
+  UINT32                  BlockSize;
+  UINT64                  Start;
+  UINT64                  End;
+  UINT64                  Next;
+
+  if ((This == NULL) ||
+      (NumLba == 0))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = NorFlashSetMode (This, NOR_FLASH_MODE_SAFE);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Private = NOR_FLASH_PRIVATE_DATA_FROM_NOR_FLASH_PROTOCOL (This);
+
+  BlockSize = Private->PrivateFlashAttributes.FlashAttributes.BlockSize;
+  LastBlock = (Private->PrivateFlashAttributes.FlashAttributes.MemoryDensity / BlockSize) - 1;
+
+  if ((Lba > LastBlock) ||
+      ((Lba + NumLba - 1) > LastBlock))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // Let an erase that already finished complete before checking for one.
+  NorFlashPendingEraseProcess (Private, FALSE);
+  if (Private->PendingErase.Pending) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  Start  = (UINT64)Lba * BlockSize;
+  End    = Start + (UINT64)NumLba * BlockSize;
+  Status = NorFlashEraseIssue (Private, Start, End, &Next);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Private->PendingErase.Pending  = TRUE;
+  Private->PendingErase.Start    = Start;
+  Private->PendingErase.Next     = Next;
+  Private->PendingErase.End      = End;
+  Private->PendingErase.Callback = Callback;
+  Private->PendingErase.Context  = Context;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Progress an erase started by NorFlashEraseAsync.
+
+  @param[in] This                  Instance to protocol
+  @param[in] Wait                  Wait for the erase to complete
+
+  @retval EFI_SUCCESS              No erase pending.
+  @retval EFI_NOT_READY            Erase still in progress.
+  @retval others                   Erase failed
+**/
+EFI_STATUS
+NorFlashErasePoll (
+  IN NVIDIA_NOR_FLASH_PROTOCOL  *This,
+  IN BOOLEAN                    Wait
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = NorFlashSetMode (This, NOR_FLASH_MODE_SAFE);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return NorFlashPendingEraseProcess (NOR_FLASH_PRIVATE_DATA_FROM_NOR_FLASH_PROTOCOL (This), Wait);
+}
+
 /**
   Write single page data to NOR Flash.
 
@@ -1130,6 +1497,8 @@ NorFlashWriteSinglePage (
     return EFI_INVALID_PARAMETER;
   }
 
+  NorFlashPendingEraseProcess (Private, TRUE);
+
   CmdSize = NOR_CMD_SIZE + NOR_ADDR_SIZE;
   ZeroMem (Private->CommandBuffer, CmdSize + Size);
   Status = ConfigureNorFlashWriteEnLatch (Private, TRUE);
@@ -1326,8 +1695,7 @@ NorFlashWriteBlock (
   Status = NorFlashErase (
              &Private->NorFlashProtocol,
              Lba,
-             BufferSize / Private->PrivateFlashAttributes.FlashAttributes.BlockSize,
-             FALSE
+             BufferSize / Private->PrivateFlashAttributes.FlashAttributes.BlockSize
              );
 
   BlockSize = Private->PrivateFlashAttributes.FlashAttributes.BlockSize;
@@ -1404,6 +1772,7 @@ NorFlashInitialise (
   EFI_HANDLE                       *HandleBuffer;
   UINT32                           *QspiSocket;
   UINT32                           *Socket;
+  UINT32                           RegionIndex;
 
   Status = GetProtocolHandleBuffer (
              &gNVIDIAQspiControllerProtocolGuid,
@@ -1480,18 +1849,18 @@ NorFlashInitialise (
       __FUNCTION__,
       Private->PrivateFlashAttributes.FlashAttributes.BlockSize
       ));
-    DEBUG ((
-      DEBUG_INFO,
-      "%a: NOR Flash Hybrid Memory Density: 0x%lx\n",
-      __FUNCTION__,
-      Private->PrivateFlashAttributes.HybridMemoryDensity
-      ));
-    DEBUG ((
-      DEBUG_INFO,
-      "%a: NOR Flash Hybrid Block Size: 0x%lx\n",
-      __FUNCTION__,
-      Private->PrivateFlashAttributes.HybridBlockSize
-      ));
+    for (RegionIndex = 0; RegionIndex < Private->PrivateFlashAttributes.EraseMap.RegionCount; RegionIndex++) {
+      DEBUG ((
+        DEBUG_INFO,
+        "%a: NOR Flash Erase Region 0x%lx-0x%lx Erase Types: 0x%x\n",
+        __FUNCTION__,
+        Private->PrivateFlashAttributes.EraseMap.Regions[RegionIndex].Offset,
+        Private->PrivateFlashAttributes.EraseMap.Regions[RegionIndex].Offset +
+        Private->PrivateFlashAttributes.EraseMap.Regions[RegionIndex].Size - 1,
+        Private->PrivateFlashAttributes.EraseMap.Regions[RegionIndex].EraseTypeMask
+        ));
+    }
+
     DEBUG ((
       DEBUG_INFO,
       "%a: NOR Flash Write Page Size: 0x%lx\n",
@@ -1523,6 +1892,8 @@ NorFlashInitialise (
     Private->NorFlashProtocol.QuickRead        = NorFlashReadQuick;
     Private->NorFlashProtocol.QuickWrite       = NorFlashWriteQuick;
     Private->NorFlashProtocol.QuickErase       = NorFlashUniformEraseQuick;
+    Private->NorFlashProtocol.EraseAsync       = NorFlashEraseAsync;
+    Private->NorFlashProtocol.ErasePoll        = NorFlashErasePoll;
     Private->PrivateFlashAttributes.AccessMode = NOR_FLASH_MODE_SAFE;
 
     Status = gMmst->MmInstallProtocolInterface (
@@ -0,0 +1,486 @@
+/** @file
+
+  NOR Flash erase map unit test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../NorFlashEraseMap.h"
+
+#define UNIT_TEST_NAME     "NOR Flash Erase Map Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define ERASE_CMD_4KB    0x21
+#define ERASE_CMD_32KB   0x5c
+#define ERASE_CMD_64KB   0xdc
+#define ERASE_CMD_256KB  0xdc
+
+#define TEST_ERASED_BYTE   0xff
+#define TEST_WRITTEN_BYTE  0x00
+
+//
+// Simulated NOR flash
+//
+typedef struct {
+  NOR_FLASH_ERASE_MAP    Map;
+  UINT64                 Size;
+  UINT8                  *Data;
+  UINTN                  EraseCount;
+} SIM_NOR_FLASH;
+
+STATIC SIM_NOR_FLASH  mNor;
+
+/**
+  Execute an erase command on the simulated flash.
+
+  The erase block containing Address is erased, limited to the region of the
+  address, as a flash with overlaid sectors does.
+
+  @param[in, out] Nor      Simulated flash
+  @param[in]      Address  Address sent with the command
+  @param[in]      Command  Erase command
+
+  @retval TRUE    Command valid for the address
+  @retval FALSE   Command not supported at the address
+**/
+STATIC
+BOOLEAN
+SimNorErase (
+  IN OUT SIM_NOR_FLASH  *Nor,
+  IN     UINT64         Address,
+  IN     UINT8          Command
+  )
+{
+  NOR_FLASH_ERASE_REGION  *Region;
+  UINT32                  Index;
+  UINT32                  Type;
+  UINT64                  Start;
+  UINT64                  End;
+
+  Region = NULL;
+  for (Index = 0; Index < Nor->Map.RegionCount; Index++) {
+    if ((Address >= Nor->Map.Regions[Index].Offset) &&
+        (Address < Nor->Map.Regions[Index].Offset + Nor->Map.Regions[Index].Size))
+    {
+      Region = &Nor->Map.Regions[Index];
+    }
+  }
+
+  if (Region == NULL) {
+    return FALSE;
+  }
+
+  for (Type = 0; Type < NOR_FLASH_ERASE_TYPE_COUNT; Type++) {
+    if ((Region->EraseTypeMask & (1 << Type)) &&
+        (Nor->Map.Types[Type].Size != 0) &&
+        (Nor->Map.Types[Type].Command == Command))
+    {
+      break;
+    }
+  }
+
+  if (Type == NOR_FLASH_ERASE_TYPE_COUNT) {
+    return FALSE;
+  }
+
+  Start = Address & ~((UINT64)Nor->Map.Types[Type].Size - 1);
+  End   = Start + Nor->Map.Types[Type].Size;
+  Start = MAX (Start, Region->Offset);
+  End   = MIN (End, Region->Offset + Region->Size);
+  SetMem (&Nor->Data[Start], End - Start, TEST_ERASED_BYTE);
+  Nor->EraseCount++;
+
+  return TRUE;
+}
+
+/**
+  Erase a range of the simulated flash the way the NOR flash driver does.
+
+  @param[in, out] Nor      Simulated flash
+  @param[in]      Offset   Start of the range
+  @param[in]      Size     Size of the range
+
+  @retval EFI_SUCCESS            Range erased
+  @retval EFI_DEVICE_ERROR       Planned command not valid for the flash
+  @retval others                 Error from the erase map
+**/
+STATIC
+EFI_STATUS
+SimNorEraseRange (
+  IN OUT SIM_NOR_FLASH  *Nor,
+  IN     UINT64         Offset,
+  IN     UINT64         Size
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      End;
+  UINT64      EraseEnd;
+  UINT8       Command;
+
+  End = Offset + Size;
+  while (Offset < End) {
+    Status = NorFlashEraseMapNext (&Nor->Map, Offset, End, &EraseEnd, &Command);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if ((EraseEnd <= Offset) || (EraseEnd > End) || !SimNorErase (Nor, Offset, Command)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    Offset = EraseEnd;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check that exactly a range of the simulated flash is erased.
+
+  @param[in] Nor      Simulated flash
+  @param[in] Offset   Start of the range
+  @param[in] Size     Size of the range
+
+  @retval TRUE    Only the range is erased
+  @retval FALSE   Data outside the range was erased or data in it was not
+**/
+STATIC
+BOOLEAN
+SimNorIsErased (
+  IN SIM_NOR_FLASH  *Nor,
+  IN UINT64         Offset,
+  IN UINT64         Size
+  )
+{
+  UINT64  Index;
+  UINT8   Expected;
+
+  for (Index = 0; Index < Nor->Size; Index++) {
+    Expected = ((Index >= Offset) && (Index < Offset + Size)) ? TEST_ERASED_BYTE : TEST_WRITTEN_BYTE;
+    if (Nor->Data[Index] != Expected) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Fill the simulated flash with written data and reset the erase count.
+
+  @param[in, out] Nor      Simulated flash
+
+**/
+STATIC
+VOID
+SimNorReset (
+  IN OUT SIM_NOR_FLASH  *Nor
+  )
+{
+  SetMem (Nor->Data, Nor->Size, TEST_WRITTEN_BYTE);
+  Nor->EraseCount = 0;
+}
+
+/**
+  Erase a range, checking the result and the number of erase commands.
+
+  @param[in] Offset           Start of the range
+  @param[in] Size             Size of the range
+  @param[in] ExpectedCount    Expected number of erase commands
+
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckErase (
+  IN UINT64  Offset,
+  IN UINT64  Size,
+  IN UINTN   ExpectedCount
+  )
+{
+  SimNorReset (&mNor);
+  UT_ASSERT_NOT_EFI_ERROR (SimNorEraseRange (&mNor, Offset, Size));
+  UT_ASSERT_TRUE (SimNorIsErased (&mNor, Offset, Size));
+  UT_ASSERT_EQUAL (mNor.EraseCount, ExpectedCount);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Set up a uniform 8MB flash with 4KB, 32KB and 64KB erases.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetupUniform (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ZeroMem (&mNor.Map, sizeof (mNor.Map));
+  mNor.Map.Types[0].Size    = SIZE_4KB;
+  mNor.Map.Types[0].Command = ERASE_CMD_4KB;
+  mNor.Map.Types[1].Size    = SIZE_32KB;
+  mNor.Map.Types[1].Command = ERASE_CMD_32KB;
+  mNor.Map.Types[2].Size    = SIZE_64KB;
+  mNor.Map.Types[2].Command = ERASE_CMD_64KB;
+  mNor.Size                 = SIZE_8MB;
+
+  UT_ASSERT_NOT_EFI_ERROR (NorFlashEraseMapAddRegion (&mNor.Map, mNor.Size, MAX_UINT8));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Set up a 2MB flash with 256KB sectors and 4KB parameter sectors overlaid
+  on the bottom 32KB.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetupHybridBottom (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ZeroMem (&mNor.Map, sizeof (mNor.Map));
+  mNor.Map.Types[0].Size    = SIZE_4KB;
+  mNor.Map.Types[0].Command = ERASE_CMD_4KB;
+  mNor.Map.Types[3].Size    = SIZE_256KB;
+  mNor.Map.Types[3].Command = ERASE_CMD_256KB;
+  mNor.Size                 = SIZE_2MB;
+
+  UT_ASSERT_NOT_EFI_ERROR (NorFlashEraseMapAddRegion (&mNor.Map, SIZE_32KB, BIT0));
+  UT_ASSERT_NOT_EFI_ERROR (NorFlashEraseMapAddRegion (&mNor.Map, SIZE_256KB - SIZE_32KB, BIT3));
+  UT_ASSERT_NOT_EFI_ERROR (NorFlashEraseMapAddRegion (&mNor.Map, SIZE_2MB - SIZE_256KB, BIT3));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Set up a 2MB flash with 256KB sectors and 4KB parameter sectors overlaid
+  on the top 32KB.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetupHybridTop (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ZeroMem (&mNor.Map, sizeof (mNor.Map));
+  mNor.Map.Types[0].Size    = SIZE_4KB;
+  mNor.Map.Types[0].Command = ERASE_CMD_4KB;
+  mNor.Map.Types[3].Size    = SIZE_256KB;
+  mNor.Map.Types[3].Command = ERASE_CMD_256KB;
+  mNor.Size                 = SIZE_2MB;
+
+  UT_ASSERT_NOT_EFI_ERROR (NorFlashEraseMapAddRegion (&mNor.Map, SIZE_2MB - SIZE_32KB, BIT3));
+  UT_ASSERT_NOT_EFI_ERROR (NorFlashEraseMapAddRegion (&mNor.Map, SIZE_32KB, BIT0));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Uniform flash ranges use the largest aligned erases.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EraseUniform (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  // Whole flash: 128 64KB erases rather than 2048 4KB erases
+  UT_ASSERT_EQUAL (CheckErase (0, SIZE_8MB, SIZE_8MB / SIZE_64KB), UNIT_TEST_PASSED);
+
+  // Single blocks
+  UT_ASSERT_EQUAL (CheckErase (SIZE_4KB, SIZE_4KB, 1), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (CheckErase (SIZE_1MB, SIZE_32KB, 1), UNIT_TEST_PASSED);
+
+  // 7x4KB up to 32KB, 1x32KB up to 64KB, 15x64KB up to 1MB, 3x4KB
+  UT_ASSERT_EQUAL (CheckErase (SIZE_4KB, SIZE_1MB + SIZE_8KB, 7 + 1 + 15 + 3), UNIT_TEST_PASSED);
+
+  // 32KB aligned but not 64KB aligned: 1x32KB, 2x64KB, 1x32KB
+  UT_ASSERT_EQUAL (CheckErase (SIZE_32KB, SIZE_64KB * 3, 4), UNIT_TEST_PASSED);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Parameter sectors at the bottom are erased separately from their sector.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EraseHybridBottom (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  // First two sectors: 8x4KB, the rest of sector 0, sector 1
+  UT_ASSERT_EQUAL (CheckErase (0, SIZE_512KB, 8 + 1 + 1), UNIT_TEST_PASSED);
+
+  // Whole flash
+  UT_ASSERT_EQUAL (CheckErase (0, SIZE_2MB, 8 + 1 + 7), UNIT_TEST_PASSED);
+
+  // A single sector past the parameter sectors
+  UT_ASSERT_EQUAL (CheckErase (SIZE_256KB, SIZE_256KB, 1), UNIT_TEST_PASSED);
+
+  // Parameter sectors alone
+  UT_ASSERT_EQUAL (CheckErase (SIZE_4KB, SIZE_8KB, 2), UNIT_TEST_PASSED);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Parameter sectors at the top are erased separately from their sector.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EraseHybridTop (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  // Last sector: the part below the parameter sectors, 8x4KB
+  UT_ASSERT_EQUAL (CheckErase (SIZE_2MB - SIZE_256KB, SIZE_256KB, 1 + 8), UNIT_TEST_PASSED);
+
+  // Whole flash
+  UT_ASSERT_EQUAL (CheckErase (0, SIZE_2MB, 8 + 8), UNIT_TEST_PASSED);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Ranges that can not be erased exactly are rejected.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EraseInvalid (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  EraseEnd;
+  UINT8   Command;
+
+  // Not aligned to the smallest erase
+  UT_ASSERT_EQUAL (NorFlashEraseMapNext (&mNor.Map, SIZE_2KB, SIZE_64KB, &EraseEnd, &Command), EFI_INVALID_PARAMETER);
+  UT_ASSERT_EQUAL (NorFlashEraseMapNext (&mNor.Map, 0, SIZE_2KB, &EraseEnd, &Command), EFI_INVALID_PARAMETER);
+
+  // Outside the flash or empty
+  UT_ASSERT_EQUAL (NorFlashEraseMapNext (&mNor.Map, SIZE_8MB, SIZE_8MB + SIZE_4KB, &EraseEnd, &Command), EFI_INVALID_PARAMETER);
+  UT_ASSERT_EQUAL (NorFlashEraseMapNext (&mNor.Map, SIZE_4KB, SIZE_4KB, &EraseEnd, &Command), EFI_INVALID_PARAMETER);
+
+  // Regions without usable erase types, too many regions
+  UT_ASSERT_EQUAL (NorFlashEraseMapAddRegion (&mNor.Map, SIZE_4KB, BIT3), EFI_INVALID_PARAMETER);
+  UT_ASSERT_EQUAL (NorFlashEraseMapAddRegion (&mNor.Map, 0, BIT0), EFI_INVALID_PARAMETER);
+  while (mNor.Map.RegionCount < NOR_FLASH_ERASE_MAX_REGIONS) {
+    UT_ASSERT_NOT_EFI_ERROR (NorFlashEraseMapAddRegion (&mNor.Map, SIZE_4KB, BIT0));
+  }
+
+  UT_ASSERT_EQUAL (NorFlashEraseMapAddRegion (&mNor.Map, SIZE_4KB, BIT0), EFI_OUT_OF_RESOURCES);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the NOR
+  flash erase map and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      EraseTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  mNor.Data = AllocatePool (SIZE_8MB);
+  if (mNor.Data == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    goto Exit;
+  }
+
+  Status = CreateUnitTestSuite (&EraseTests, Framework, "NOR Flash Erase Map Tests", "UnitTest.NorFlashEraseMap", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for NOR Flash Erase Map Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  AddTestCase (EraseTests, "Uniform flash uses largest aligned erases", "EraseUniform", EraseUniform, SetupUniform, NULL, NULL);
+  AddTestCase (EraseTests, "Bottom parameter sectors", "EraseHybridBottom", EraseHybridBottom, SetupHybridBottom, NULL, NULL);
+  AddTestCase (EraseTests, "Top parameter sectors", "EraseHybridTop", EraseHybridTop, SetupHybridTop, NULL, NULL);
+  AddTestCase (EraseTests, "Invalid ranges and regions", "EraseInvalid", EraseInvalid, SetupUniform, NULL, NULL);
+
+  // Execute the tests.
+  Status = RunAllTestSuites (Framework);
+
+Exit:
+  FreePool (mNor.Data);
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
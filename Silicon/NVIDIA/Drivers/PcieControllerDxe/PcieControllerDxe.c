@@ -43,6 +43,9 @@
 
 STATIC BOOLEAN  mPcieAcpiConfigInstalled = FALSE;
 
+// Controllers whose link training has been started but not completed
+STATIC LIST_ENTRY  mPcieLinkTrainingList = INITIALIZE_LIST_HEAD_VARIABLE (mPcieLinkTrainingList);
+
 /** The platform ACPI table list.
 */
 STATIC
@@ -317,74 +320,19 @@ PCIeFindCap (
   return PCIeFindNextCap (CfgBase, next_cap_ptr, cap);
 }
 
-STATIC
-BOOLEAN
-WaitForBit16 (
-  UINT32   cid,
-  UINT16   *feat,
-  UINT16   pos,
-  UINT32   count,
-  UINT32   time_us,
-  BOOLEAN  status
-  )
-{
-  UINT32  i = 0;
-
-  while (i < count) {
-    if (!!(*feat & BIT (pos)) != status) {
-      MicroSecondDelay (time_us);
-      i++;
-    } else {
-      return TRUE;
-    }
-  }
+/**
+  Get the current time for link training.
 
-  return FALSE;
-}
+  @retval Current time in microseconds
 
+**/
 STATIC
-VOID
-RetrainLink (
-  PCIE_CONTROLLER_PRIVATE  *Private
+UINT64
+PcieGetTimeUs (
+  VOID
   )
 {
-  PCI_CAPABILITY_PCIEXP  *PciExpCap = (PCI_CAPABILITY_PCIEXP *)(Private->EcamBase + Private->PCIeCapOff);
-
-  /* Wait for previous link training to complete */
-  if (WaitForBit16 (Private->CtrlId, &PciExpCap->LinkStatus.Uint16, 11, 10000, 100, FALSE)) {
-    /* Clear Link Bandwith */
-    PciExpCap->LinkStatus.Bits.LinkBandwidthManagement = 1;
-
-    /* Set Retrain Link */
-    PciExpCap->LinkControl2.Bits.TargetLinkSpeed = PciExpCap->LinkCapability.Bits.MaxLinkSpeed;
-    PciExpCap->LinkControl.Bits.RetrainLink      = 1;
-
-    /* Retraining: Wait for link training to clear */
-    if (WaitForBit16 (Private->CtrlId, &PciExpCap->LinkStatus.Uint16, 11, 10000, 100, FALSE)) {
-      /* Wait for Link Bandwith set */
-      if (WaitForBit16 (Private->CtrlId, &PciExpCap->LinkStatus.Uint16, 14, 10000, 100, TRUE)) {
-        /* Clear Link Bandwith */
-        PciExpCap->LinkStatus.Bits.LinkBandwidthManagement = 1;
-        /* Wait for 20 ms for link to appear */
-        MicroSecondDelay (20*1000);
-        DEBUG ((
-          EFI_D_ERROR,
-          "PCIe Controller-0x%x Link Status after re-train (Capable: Gen-%d,x%d  Negotiated: Gen-%d,x%d)\r\n",
-          Private->CtrlId,
-          PciExpCap->LinkCapability.Bits.MaxLinkSpeed,
-          PciExpCap->LinkCapability.Bits.MaxLinkWidth,
-          PciExpCap->LinkStatus.Bits.CurrentLinkSpeed,
-          PciExpCap->LinkStatus.Bits.NegotiatedLinkWidth
-          ));
-      } else {
-        DEBUG ((EFI_D_ERROR, "PCIe Controller-0x%x wait for Link Bandwith Timeout\r\n", Private->CtrlId));
-      }
-    } else {
-      DEBUG ((EFI_D_ERROR, "PCIe Controller-0x%x Link Retrain Timeout\r\n", Private->CtrlId));
-    }
-  } else {
-    DEBUG ((EFI_D_ERROR, "PCIe Controller-0x%x Previous Link train Timeout\r\n", Private->CtrlId));
-  }
+  return DivU64x32 (GetTimeInNanoSecond (GetPerformanceCounter ()), 1000);
 }
 
 STATIC
@@ -397,10 +345,7 @@ InitializeController (
 {
   UINT64                        val;
   UINT32                        Socket, Ctrl;
-  EFI_STATUS                    Status;
-  NVIDIA_C2C_NODE_PROTOCOL      *C2cProtocol = NULL;
-  PCI_CAPABILITY_PCIEXP         *PciExpCap   = NULL;
-  UINT8                         C2cStatus;
+  PCI_CAPABILITY_PCIEXP         *PciExpCap = NULL;
   VOID                          *Hob;
   TEGRABL_EARLY_BOOT_VARIABLES  *Mb1Config = NULL;
 
@@ -464,53 +409,112 @@ InitializeController (
   val |= XTL_RC_MGMT_PERST_CONTROL_PERST_O_N;
   MmioWrite32 (Private->XtlPriBase + XTL_RC_MGMT_PERST_CONTROL, val);
 
-  /* Wait for link up */
+  /*
+   * Link training runs in the background and is completed for all controllers
+   * together. Re-train link if disable_ltssm_auto_train set in BCT.
+   */
   PciExpCap = (PCI_CAPABILITY_PCIEXP *)(Private->EcamBase + Private->PCIeCapOff);
+  PcieLinkTrainingStart (
+    &Private->LinkTraining,
+    Private->CtrlId,
+    PciExpCap,
+    Mb1Config->Data.Mb1Data.PcieConfig[Socket][Ctrl].DisableLTSSMAutoTrain,
+    PcieGetTimeUs ()
+    );
 
-  if ( WaitForBit16 (Private->CtrlId, &PciExpCap->LinkStatus.Uint16, 13, 10000, 100, TRUE)) {
-    DEBUG ((
-      EFI_D_ERROR,
-      "PCIe Controller-0x%x Link is UP (Capable: Gen-%d,x%d  Negotiated: Gen-%d,x%d)\r\n",
-      Private->CtrlId,
-      PciExpCap->LinkCapability.Bits.MaxLinkSpeed,
-      PciExpCap->LinkCapability.Bits.MaxLinkWidth,
-      PciExpCap->LinkStatus.Bits.CurrentLinkSpeed,
-      PciExpCap->LinkStatus.Bits.NegotiatedLinkWidth
-      ));
+  return EFI_SUCCESS;
+}
 
-    /**
-     * Re-train link if disable_ltssm_auto_train set in BCT.
-     */
-    if (Mb1Config->Data.Mb1Data.PcieConfig[Socket][Ctrl].DisableLTSSMAutoTrain) {
-      RetrainLink (Private);
-    }
+/**
+  Finish the bring-up of a controller once its link training completed.
 
-    Status = gBS->HandleProtocol (ControllerHandle, &gNVIDIAC2cNodeProtocolGuid, (VOID **)&C2cProtocol);
-    if (!EFI_ERROR (Status)) {
-      DEBUG ((EFI_D_ERROR, "%a: Requesting C2C Initialization\r\n", __FUNCTION__));
-      Status = C2cProtocol->Init (C2cProtocol, C2cProtocol->Partitions, &C2cStatus);
-      if (EFI_ERROR (Status)) {
-        DEBUG ((EFI_D_ERROR, "%a: C2C initialization mrq failed: %r\r\n", __FUNCTION__, Status));
+  @param[in]  Private   Controller private data
+
+**/
+STATIC
+VOID
+PcieLinkTrainingComplete (
+  IN PCIE_CONTROLLER_PRIVATE  *Private
+  )
+{
+  EFI_STATUS                Status;
+  NVIDIA_C2C_NODE_PROTOCOL  *C2cProtocol;
+  UINT8                     C2cStatus;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "PCIe Controller-0x%x link training %a after %lu us\r\n",
+    Private->CtrlId,
+    (Private->LinkTraining.State == PcieLinkUp) ? "up" : "down",
+    Private->LinkTraining.TrainingTime
+    ));
+
+  if (Private->LinkTraining.State != PcieLinkUp) {
+    return;
+  }
+
+  Status = gBS->HandleProtocol (Private->ControllerHandle, &gNVIDIAC2cNodeProtocolGuid, (VOID **)&C2cProtocol);
+  if (!EFI_ERROR (Status)) {
+    DEBUG ((EFI_D_ERROR, "%a: Requesting C2C Initialization\r\n", __FUNCTION__));
+    Status = C2cProtocol->Init (C2cProtocol, C2cProtocol->Partitions, &C2cStatus);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((EFI_D_ERROR, "%a: C2C initialization mrq failed: %r\r\n", __FUNCTION__, Status));
+    } else {
+      DEBUG ((EFI_D_ERROR, "%a: C2C initialization mrq successful.\r\n", __FUNCTION__));
+      if (C2cStatus == C2C_STATUS_C2C_LINK_TRAIN_PASS) {
+        DEBUG ((EFI_D_ERROR, "%a: C2C link training successful.\r\n", __FUNCTION__));
       } else {
-        DEBUG ((EFI_D_ERROR, "%a: C2C initialization mrq successful.\r\n", __FUNCTION__));
-        if (C2cStatus == C2C_STATUS_C2C_LINK_TRAIN_PASS) {
-          DEBUG ((EFI_D_ERROR, "%a: C2C link training successful.\r\n", __FUNCTION__));
-        } else {
-          DEBUG ((EFI_D_ERROR, "%a: C2C link training failed with error code: 0x%x\r\n", __FUNCTION__, C2cStatus));
-        }
+        DEBUG ((EFI_D_ERROR, "%a: C2C link training failed with error code: 0x%x\r\n", __FUNCTION__, C2cStatus));
       }
     }
-  } else {
-    DEBUG ((
-      EFI_D_ERROR,
-      "PCIe Controller-0x%x Link is DOWN (Capable: Gen-%d,x%d)\r\n",
-      Private->CtrlId,
-      PciExpCap->LinkCapability.Bits.MaxLinkSpeed,
-      PciExpCap->LinkCapability.Bits.MaxLinkWidth
-      ));
   }
+}
 
-  return EFI_SUCCESS;
+/**
+  Poll the link training of all started controllers until every link is up or
+  has timed out, then finish their bring-up.
+
+  Training of all root ports runs concurrently, so the wait is bounded by the
+  slowest link rather than the sum of all of them.
+
+**/
+STATIC
+VOID
+PcieCompleteLinkTraining (
+  VOID
+  )
+{
+  LIST_ENTRY               *Node;
+  PCIE_CONTROLLER_PRIVATE  *Private;
+  BOOLEAN                  Pending;
+  UINT64                   StartTime;
+
+  StartTime = PcieGetTimeUs ();
+  do {
+    Pending = FALSE;
+    for (Node = GetFirstNode (&mPcieLinkTrainingList);
+         !IsNull (&mPcieLinkTrainingList, Node);
+         Node = GetNextNode (&mPcieLinkTrainingList, Node))
+    {
+      Private = PCIE_CONTROLLER_PRIVATE_DATA_FROM_LINK (Node);
+      if (!PcieLinkTrainingPoll (&Private->LinkTraining, PcieGetTimeUs ())) {
+        Pending = TRUE;
+      }
+    }
+
+    if (Pending) {
+      MicroSecondDelay (PCIE_LINK_POLL_INTERVAL_US);
+    }
+  } while (Pending);
+
+  DEBUG ((DEBUG_INFO, "%a: link training completed in %lu us\r\n", __FUNCTION__, PcieGetTimeUs () - StartTime));
+
+  while (!IsListEmpty (&mPcieLinkTrainingList)) {
+    Node    = GetFirstNode (&mPcieLinkTrainingList);
+    Private = PCIE_CONTROLLER_PRIVATE_DATA_FROM_LINK (Node);
+    RemoveEntryList (Node);
+    PcieLinkTrainingComplete (Private);
+  }
 }
 
 STATIC
@@ -1561,7 +1565,8 @@ DeviceDiscoveryNotify (
 
       Private->BusMask = RootBridge->Bus.Limit;
 
-      Status = InitializeController (Private, ControllerHandle);
+      Private->ControllerHandle = ControllerHandle;
+      Status                    = InitializeController (Private, ControllerHandle);
       if (EFI_ERROR (Status)) {
         DEBUG ((EFI_D_ERROR, "%a: Unable to initialize controller (%r)\r\n", __FUNCTION__, Status));
         break;
@@ -1715,9 +1720,11 @@ DeviceDiscoveryNotify (
         break;
       }
 
+      InsertTailList (&mPcieLinkTrainingList, &Private->Link);
       break;
 
     case DeviceDiscoveryEnumerationCompleted:
+      PcieCompleteLinkTraining ();
 
       EfiCreateProtocolNotifyEvent (
         &gNVIDIABdsDeviceConnectCompleteGuid,
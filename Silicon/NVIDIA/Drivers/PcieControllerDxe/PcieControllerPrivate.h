@@ -17,6 +17,8 @@
 #include <Protocol/ConfigurationManagerDataProtocol.h>
 #include <TH500/TH500Definitions.h>
 
+#include "PcieLinkTraining.h"
+
 #define BIT(x)  (1 << (x))
 
 #define upper_32_bits(n)  ((UINT32)((n) >> 32))
@@ -46,6 +48,11 @@ typedef struct {
   NVIDIA_PCI_ROOT_BRIDGE_CONFIGURATION_IO_PROTOCOL    PcieRootBridgeConfigurationIo;
 
   UINT32                                              CtrlId;
+  EFI_HANDLE                                          ControllerHandle;
+
+  // Link training, completed for all controllers together
+  LIST_ENTRY                                          Link;
+  PCIE_LINK_TRAINING                                  LinkTraining;
 
   UINT64                                              XalBase;
   UINT64                                              XalSize;
@@ -77,6 +84,7 @@ typedef struct {
   EDKII_PLATFORM_REPOSITORY_INFO                      RepoInfo[PCIE_REPO_OBJECTS];
 } PCIE_CONTROLLER_PRIVATE;
 #define PCIE_CONTROLLER_PRIVATE_DATA_FROM_THIS(a)  CR(a, PCIE_CONTROLLER_PRIVATE, PcieRootBridgeConfigurationIo, PCIE_CONTROLLER_SIGNATURE)
+#define PCIE_CONTROLLER_PRIVATE_DATA_FROM_LINK(a)  CR(a, PCIE_CONTROLLER_PRIVATE, Link, PCIE_CONTROLLER_SIGNATURE)
 
 #define PCIE_DEVICETREE_PREFETCHABLE  BIT30
 #define PCIE_DEVICETREE_SPACE_CODE    (BIT24 | BIT25)
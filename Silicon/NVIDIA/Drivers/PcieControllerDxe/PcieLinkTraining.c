@@ -0,0 +1,158 @@
+/** @file
+
+  PCIe Controller Driver link training state machine
+
+  Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/DebugLib.h>
+
+#include "PcieLinkTraining.h"
+
+/**
+  Move the link training state machine to a new state.
+
+  @param[in, out] Training  Link training state
+  @param[in]      State     New state
+  @param[in]      Now       Current time in microseconds
+
+**/
+STATIC
+VOID
+PcieLinkTrainingSetState (
+  IN OUT PCIE_LINK_TRAINING  *Training,
+  IN     PCIE_LINK_STATE     State,
+  IN     UINT64              Now
+  )
+{
+  Training->State     = State;
+  Training->StateTime = Now;
+  if ((State == PcieLinkUp) || (State == PcieLinkDown)) {
+    Training->TrainingTime = Now - Training->StartTime;
+  }
+}
+
+VOID
+PcieLinkTrainingStart (
+  OUT PCIE_LINK_TRAINING     *Training,
+  IN  UINT32                 CtrlId,
+  IN  PCI_CAPABILITY_PCIEXP  *PciExpCap,
+  IN  BOOLEAN                Retrain,
+  IN  UINT64                 Now
+  )
+{
+  Training->CtrlId       = CtrlId;
+  Training->PciExpCap    = PciExpCap;
+  Training->Retrain      = Retrain;
+  Training->StartTime    = Now;
+  Training->TrainingTime = 0;
+  PcieLinkTrainingSetState (Training, PcieLinkWaitLinkUp, Now);
+}
+
+BOOLEAN
+PcieLinkTrainingPoll (
+  IN OUT PCIE_LINK_TRAINING  *Training,
+  IN     UINT64              Now
+  )
+{
+  PCI_CAPABILITY_PCIEXP     *PciExpCap;
+  PCI_REG_PCIE_LINK_STATUS  LinkStatus;
+  UINT64                    Elapsed;
+
+  PciExpCap         = Training->PciExpCap;
+  LinkStatus.Uint16 = PciExpCap->LinkStatus.Uint16;
+  Elapsed           = Now - Training->StateTime;
+
+  switch (Training->State) {
+    case PcieLinkWaitLinkUp:
+      if (LinkStatus.Bits.DataLinkLayerLinkActive) {
+        DEBUG ((
+          EFI_D_ERROR,
+          "PCIe Controller-0x%x Link is UP (Capable: Gen-%d,x%d  Negotiated: Gen-%d,x%d)\r\n",
+          Training->CtrlId,
+          PciExpCap->LinkCapability.Bits.MaxLinkSpeed,
+          PciExpCap->LinkCapability.Bits.MaxLinkWidth,
+          LinkStatus.Bits.CurrentLinkSpeed,
+          LinkStatus.Bits.NegotiatedLinkWidth
+          ));
+        PcieLinkTrainingSetState (Training, Training->Retrain ? PcieLinkRetrainWaitIdle : PcieLinkUp, Now);
+      } else if (Elapsed >= PCIE_LINK_UP_TIMEOUT_US) {
+        DEBUG ((
+          EFI_D_ERROR,
+          "PCIe Controller-0x%x Link is DOWN (Capable: Gen-%d,x%d)\r\n",
+          Training->CtrlId,
+          PciExpCap->LinkCapability.Bits.MaxLinkSpeed,
+          PciExpCap->LinkCapability.Bits.MaxLinkWidth
+          ));
+        PcieLinkTrainingSetState (Training, PcieLinkDown, Now);
+      }
+
+      break;
+
+    case PcieLinkRetrainWaitIdle:
+      /* Wait for previous link training to complete */
+      if (!LinkStatus.Bits.LinkTraining) {
+        /* Clear Link Bandwith */
+        PciExpCap->LinkStatus.Bits.LinkBandwidthManagement = 1;
+
+        /* Set Retrain Link */
+        PciExpCap->LinkControl2.Bits.TargetLinkSpeed = PciExpCap->LinkCapability.Bits.MaxLinkSpeed;
+        PciExpCap->LinkControl.Bits.RetrainLink      = 1;
+        PcieLinkTrainingSetState (Training, PcieLinkRetrainWaitTrain, Now);
+      } else if (Elapsed >= PCIE_LINK_RETRAIN_TIMEOUT_US) {
+        DEBUG ((EFI_D_ERROR, "PCIe Controller-0x%x Previous Link train Timeout\r\n", Training->CtrlId));
+        PcieLinkTrainingSetState (Training, PcieLinkUp, Now);
+      }
+
+      break;
+
+    case PcieLinkRetrainWaitTrain:
+      /* Retraining: Wait for link training to clear */
+      if (!LinkStatus.Bits.LinkTraining) {
+        PcieLinkTrainingSetState (Training, PcieLinkRetrainWaitBandwidth, Now);
+      } else if (Elapsed >= PCIE_LINK_RETRAIN_TIMEOUT_US) {
+        DEBUG ((EFI_D_ERROR, "PCIe Controller-0x%x Link Retrain Timeout\r\n", Training->CtrlId));
+        PcieLinkTrainingSetState (Training, PcieLinkUp, Now);
+      }
+
+      break;
+
+    case PcieLinkRetrainWaitBandwidth:
+      /* Wait for Link Bandwith set */
+      if (LinkStatus.Bits.LinkBandwidthManagement) {
+        /* Clear Link Bandwith */
+        PciExpCap->LinkStatus.Bits.LinkBandwidthManagement = 1;
+        PcieLinkTrainingSetState (Training, PcieLinkRetrainSettle, Now);
+      } else if (Elapsed >= PCIE_LINK_RETRAIN_TIMEOUT_US) {
+        DEBUG ((EFI_D_ERROR, "PCIe Controller-0x%x wait for Link Bandwith Timeout\r\n", Training->CtrlId));
+        PcieLinkTrainingSetState (Training, PcieLinkUp, Now);
+      }
+
+      break;
+
+    case PcieLinkRetrainSettle:
+      /* Wait for 20 ms for link to appear */
+      if (Elapsed >= PCIE_LINK_RETRAIN_SETTLE_US) {
+        DEBUG ((
+          EFI_D_ERROR,
+          "PCIe Controller-0x%x Link Status after re-train (Capable: Gen-%d,x%d  Negotiated: Gen-%d,x%d)\r\n",
+          Training->CtrlId,
+          PciExpCap->LinkCapability.Bits.MaxLinkSpeed,
+          PciExpCap->LinkCapability.Bits.MaxLinkWidth,
+          LinkStatus.Bits.CurrentLinkSpeed,
+          LinkStatus.Bits.NegotiatedLinkWidth
+          ));
+        PcieLinkTrainingSetState (Training, PcieLinkUp, Now);
+      }
+
+      break;
+
+    default:
+      break;
+  }
+
+  return (Training->State == PcieLinkUp) || (Training->State == PcieLinkDown);
+}
@@ -0,0 +1,81 @@
+/** @file
+
+  PCIe Controller Driver link training state machine
+
+  Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __PCIE_LINK_TRAINING_H__
+#define __PCIE_LINK_TRAINING_H__
+
+#include <Uefi/UefiBaseType.h>
+#include <IndustryStandard/Pci.h>
+
+#define PCIE_LINK_UP_TIMEOUT_US       1000000
+#define PCIE_LINK_RETRAIN_TIMEOUT_US  1000000
+#define PCIE_LINK_RETRAIN_SETTLE_US   20000
+#define PCIE_LINK_POLL_INTERVAL_US    100
+
+typedef enum {
+  PcieLinkWaitLinkUp,
+  PcieLinkRetrainWaitIdle,
+  PcieLinkRetrainWaitTrain,
+  PcieLinkRetrainWaitBandwidth,
+  PcieLinkRetrainSettle,
+  PcieLinkUp,
+  PcieLinkDown
+} PCIE_LINK_STATE;
+
+typedef struct {
+  UINT32                   CtrlId;
+  PCI_CAPABILITY_PCIEXP    *PciExpCap;
+  BOOLEAN                  Retrain;
+
+  PCIE_LINK_STATE          State;
+  UINT64                   StartTime;
+  UINT64                   StateTime;
+  UINT64                   TrainingTime;
+} PCIE_LINK_TRAINING;
+
+/**
+  Start tracking link training of a root port whose PERST# was just released.
+
+  @param[out] Training    Link training state
+  @param[in]  CtrlId      Controller id, for logging
+  @param[in]  PciExpCap   PCIe capability registers of the root port
+  @param[in]  Retrain     Retrain the link at max speed once it is up
+  @param[in]  Now         Current time in microseconds
+
+**/
+VOID
+PcieLinkTrainingStart (
+  OUT PCIE_LINK_TRAINING     *Training,
+  IN  UINT32                 CtrlId,
+  IN  PCI_CAPABILITY_PCIEXP  *PciExpCap,
+  IN  BOOLEAN                Retrain,
+  IN  UINT64                 Now
+  );
+
+/**
+  Advance the link training state machine of a root port.
+
+  Never blocks, so the links of all controllers can be polled from one loop
+  and their timeouts overlap.
+
+  @param[in, out] Training  Link training state
+  @param[in]      Now       Current time in microseconds
+
+  @retval TRUE    Training finished, State is PcieLinkUp or PcieLinkDown
+  @retval FALSE   Training still in progress
+
+**/
+BOOLEAN
+PcieLinkTrainingPoll (
+  IN OUT PCIE_LINK_TRAINING  *Training,
+  IN     UINT64              Now
+  );
+
+#endif
@@ -0,0 +1,335 @@
+/** @file
+
+  PCIe Controller Driver link training unit test
+
+  Copyright (c) 2023, NVIDIA CORPORATION. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../PcieLinkTraining.h"
+
+#define UNIT_TEST_NAME     "PCIe Link Training Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_MAX_PORTS  8
+
+//
+// Simulated root port: the LTSSM reaches each milestone at a fixed time after
+// PERST# is released, 0 meaning never
+//
+typedef struct {
+  PCI_CAPABILITY_PCIEXP    Regs;
+  UINT64                   LinkUpTime;
+  UINT64                   RetrainTime;
+  UINT64                   RetrainStart;
+  BOOLEAN                  Training;
+} TEST_PORT;
+
+/**
+  Update the simulated link registers of a port for the current time.
+
+  @param[in, out] Port  Simulated port
+  @param[in]      Now   Current time in microseconds
+
+**/
+STATIC
+VOID
+TestPortUpdate (
+  IN OUT TEST_PORT  *Port,
+  IN     UINT64     Now
+  )
+{
+  if ((Port->LinkUpTime != 0) && (Now >= Port->LinkUpTime) && !Port->Regs.LinkStatus.Bits.DataLinkLayerLinkActive) {
+    Port->Regs.LinkStatus.Bits.DataLinkLayerLinkActive = 1;
+    Port->Regs.LinkStatus.Bits.CurrentLinkSpeed        = 1;
+    Port->Regs.LinkStatus.Bits.NegotiatedLinkWidth     = Port->Regs.LinkCapability.Bits.MaxLinkWidth;
+  }
+
+  // Retrain requested: training is in progress until RetrainTime has elapsed
+  if (Port->Regs.LinkControl.Bits.RetrainLink) {
+    Port->Regs.LinkControl.Bits.RetrainLink = 0;
+    Port->RetrainStart                      = Now;
+    Port->Training                          = TRUE;
+  }
+
+  Port->Regs.LinkStatus.Bits.LinkTraining = Port->Training;
+  if (Port->Training && (Port->RetrainTime != 0) && (Now - Port->RetrainStart >= Port->RetrainTime)) {
+    Port->Training                                     = FALSE;
+    Port->Regs.LinkStatus.Bits.LinkTraining            = 0;
+    Port->Regs.LinkStatus.Bits.LinkBandwidthManagement = 1;
+    Port->Regs.LinkStatus.Bits.CurrentLinkSpeed        = Port->Regs.LinkControl2.Bits.TargetLinkSpeed;
+  }
+}
+
+/**
+  Train a set of ports together the way the driver does, advancing the clock
+  by PCIE_LINK_POLL_INTERVAL_US per pass.
+
+  @param[in, out] Ports     Simulated ports
+  @param[out]     Training  Link training state of each port
+  @param[in]      Count     Number of ports
+  @param[in]      Retrain   Retrain the links once up
+
+  @retval Time taken for all links to complete training
+
+**/
+STATIC
+UINT64
+TestTrainPorts (
+  IN OUT TEST_PORT           *Ports,
+  OUT    PCIE_LINK_TRAINING  *Training,
+  IN     UINTN               Count,
+  IN     BOOLEAN             Retrain
+  )
+{
+  UINT64   Now;
+  UINTN    Index;
+  BOOLEAN  Pending;
+
+  Now = 0;
+  for (Index = 0; Index < Count; Index++) {
+    Ports[Index].Regs.LinkCapability.Bits.MaxLinkSpeed = 5;
+    Ports[Index].Regs.LinkCapability.Bits.MaxLinkWidth = 16;
+    PcieLinkTrainingStart (&Training[Index], (UINT32)Index, &Ports[Index].Regs, Retrain, Now);
+  }
+
+  do {
+    Pending = FALSE;
+    for (Index = 0; Index < Count; Index++) {
+      TestPortUpdate (&Ports[Index], Now);
+      if (!PcieLinkTrainingPoll (&Training[Index], Now)) {
+        Pending = TRUE;
+      }
+    }
+
+    if (Pending) {
+      Now += PCIE_LINK_POLL_INTERVAL_US;
+    }
+  } while (Pending);
+
+  return Now;
+}
+
+/**
+  A link that comes up is reported with its training time.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LinkUp (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_PORT           Port;
+  PCIE_LINK_TRAINING  Training;
+  UINT64              Time;
+
+  ZeroMem (&Port, sizeof (Port));
+  Port.LinkUpTime = 5000;
+
+  Time = TestTrainPorts (&Port, &Training, 1, FALSE);
+  UT_ASSERT_EQUAL (Training.State, PcieLinkUp);
+  UT_ASSERT_EQUAL (Training.TrainingTime, 5000);
+  UT_ASSERT_EQUAL (Time, 5000);
+  UT_ASSERT_EQUAL (Port.Regs.LinkControl.Bits.RetrainLink, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  An empty slot times out as down.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LinkDown (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_PORT           Port;
+  PCIE_LINK_TRAINING  Training;
+  UINT64              Time;
+
+  ZeroMem (&Port, sizeof (Port));
+
+  // Not down before the timeout
+  Port.Regs.LinkCapability.Bits.MaxLinkWidth = 4;
+  PcieLinkTrainingStart (&Training, 0, &Port.Regs, FALSE, 100);
+  UT_ASSERT_FALSE (PcieLinkTrainingPoll (&Training, PCIE_LINK_UP_TIMEOUT_US + 99));
+  UT_ASSERT_EQUAL (Training.State, PcieLinkWaitLinkUp);
+  UT_ASSERT_TRUE (PcieLinkTrainingPoll (&Training, PCIE_LINK_UP_TIMEOUT_US + 100));
+  UT_ASSERT_EQUAL (Training.State, PcieLinkDown);
+  UT_ASSERT_EQUAL (Training.TrainingTime, PCIE_LINK_UP_TIMEOUT_US);
+
+  // Finished states are sticky
+  Port.Regs.LinkStatus.Bits.DataLinkLayerLinkActive = 1;
+  UT_ASSERT_TRUE (PcieLinkTrainingPoll (&Training, PCIE_LINK_UP_TIMEOUT_US + 200));
+  UT_ASSERT_EQUAL (Training.State, PcieLinkDown);
+
+  ZeroMem (&Port, sizeof (Port));
+  Time = TestTrainPorts (&Port, &Training, 1, FALSE);
+  UT_ASSERT_EQUAL (Training.State, PcieLinkDown);
+  UT_ASSERT_EQUAL (Time, PCIE_LINK_UP_TIMEOUT_US);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A link is retrained at max speed once up when requested.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LinkRetrain (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_PORT           Port;
+  PCIE_LINK_TRAINING  Training;
+  UINT64              Time;
+
+  ZeroMem (&Port, sizeof (Port));
+  Port.LinkUpTime  = 2000;
+  Port.RetrainTime = 3000;
+
+  Time = TestTrainPorts (&Port, &Training, 1, TRUE);
+  UT_ASSERT_EQUAL (Training.State, PcieLinkUp);
+  UT_ASSERT_EQUAL (Port.Regs.LinkControl2.Bits.TargetLinkSpeed, 5);
+  UT_ASSERT_EQUAL (Port.Regs.LinkStatus.Bits.CurrentLinkSpeed, 5);
+
+  // Link up, retrain, then the settle delay
+  UT_ASSERT_TRUE (Time >= 2000 + 3000 + PCIE_LINK_RETRAIN_SETTLE_US);
+  UT_ASSERT_TRUE (Time <= 2000 + 3000 + PCIE_LINK_RETRAIN_SETTLE_US + 4 * PCIE_LINK_POLL_INTERVAL_US);
+  UT_ASSERT_EQUAL (Training.TrainingTime, Time);
+
+  // A retrain that never completes still leaves the link up
+  ZeroMem (&Port, sizeof (Port));
+  Port.LinkUpTime = 2000;
+
+  Time = TestTrainPorts (&Port, &Training, 1, TRUE);
+  UT_ASSERT_EQUAL (Training.State, PcieLinkUp);
+  UT_ASSERT_EQUAL (Time, 2000 + PCIE_LINK_POLL_INTERVAL_US + PCIE_LINK_RETRAIN_TIMEOUT_US);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Timeouts of empty slots overlap when all ports train together.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LinkParallel (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_PORT           Ports[TEST_MAX_PORTS];
+  PCIE_LINK_TRAINING  Training[TEST_MAX_PORTS];
+  UINT64              Time;
+  UINTN               Index;
+
+  ZeroMem (Ports, sizeof (Ports));
+  for (Index = 0; Index < TEST_MAX_PORTS; Index += 2) {
+    Ports[Index].LinkUpTime = 1000 * (Index + 1);
+  }
+
+  Time = TestTrainPorts (Ports, Training, TEST_MAX_PORTS, FALSE);
+  UT_ASSERT_EQUAL (Time, PCIE_LINK_UP_TIMEOUT_US);
+
+  for (Index = 0; Index < TEST_MAX_PORTS; Index++) {
+    if (Ports[Index].LinkUpTime != 0) {
+      UT_ASSERT_EQUAL (Training[Index].State, PcieLinkUp);
+      UT_ASSERT_EQUAL (Training[Index].TrainingTime, Ports[Index].LinkUpTime);
+    } else {
+      UT_ASSERT_EQUAL (Training[Index].State, PcieLinkDown);
+      UT_ASSERT_EQUAL (Training[Index].TrainingTime, PCIE_LINK_UP_TIMEOUT_US);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the PCIe link
+  training state machine and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      LinkTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&LinkTests, Framework, "PCIe Link Training Tests", "UnitTest.PcieLinkTraining", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for PCIe Link Training Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    return Status;
+  }
+
+  AddTestCase (LinkTests, "Link up is reported with its training time", "LinkUp", LinkUp, NULL, NULL, NULL);
+  AddTestCase (LinkTests, "Empty slot times out as link down", "LinkDown", LinkDown, NULL, NULL, NULL);
+  AddTestCase (LinkTests, "Link is retrained at max speed when requested", "LinkRetrain", LinkRetrain, NULL, NULL, NULL);
+  AddTestCase (LinkTests, "Empty slot timeouts overlap across ports", "LinkParallel", LinkParallel, NULL, NULL, NULL);
+
+  // Execute the tests.
+  Status = RunAllTestSuites (Framework);
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
@@ -99,6 +99,13 @@ QspiControllerPerformTransaction (
     return EFI_UNSUPPORTED;
   }
 
+  // SPI controllers only have a single data lane
+  if ((Private->ControllerType == CONTROLLER_TYPE_SPI) &&
+      ((Packet->Control & QSPI_CONTROLLER_CONTROL_MULTI_LANE) != 0))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
   return QspiPerformTransaction (Private->QspiBaseAddress, Packet);
 }
 
@@ -306,6 +313,16 @@ QspiControllerDeviceSpecificInit (
     }
   }
 
+  //
+  // Dual and quad lane transfers
+  //
+  if (DeviceFeature == QspiDevFeatMultiLane) {
+    if (Private->ControllerType == CONTROLLER_TYPE_SPI) {
+      DEBUG ((DEBUG_INFO, "%a: Multi lane transfers are not supported.\n", __FUNCTION__));
+      return EFI_UNSUPPORTED;
+    }
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -11,9 +11,11 @@
 
 #include <IndustryStandard/SmBios.h>
 
+#include <Library/BaseCryptLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/UefiLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/ReportStatusCodeLib.h>
@@ -25,6 +27,141 @@
 
 #define SMBIOS_TRANSFER_DEBUG  0
 
+#define SMBIOS_TRANSFER_HASH_VARIABLE_NAME  L"SmbiosBmcTransferHash"
+
+/**
+  Compute the hash of the SMBIOS data sent to the BMC.
+
+  @param[in]  EntryPoint        Entry point structure as sent to the BMC.
+  @param[in]  Table             SMBIOS structure table.
+  @param[in]  TableSize         Size of the structure table.
+  @param[out] Hash              Hash of the entry point and table.
+
+  @retval TRUE                  Hash computed.
+  @retval FALSE                 Hash could not be computed.
+
+**/
+STATIC
+BOOLEAN
+SmbiosBmcTransferHash (
+  IN  CONST SMBIOS_TABLE_3_0_ENTRY_POINT  *EntryPoint,
+  IN  CONST VOID                          *Table,
+  IN  UINTN                               TableSize,
+  OUT UINT8                               *Hash
+  )
+{
+  VOID     *HashContext;
+  BOOLEAN  Result;
+
+  HashContext = AllocatePool (Sha256GetContextSize ());
+  if (HashContext == NULL) {
+    return FALSE;
+  }
+
+  Result = Sha256Init (HashContext) &&
+           Sha256Update (HashContext, EntryPoint, sizeof (*EntryPoint)) &&
+           Sha256Update (HashContext, Table, TableSize) &&
+           Sha256Final (HashContext, Hash);
+
+  FreePool (HashContext);
+  return Result;
+}
+
+/**
+  Check if the BMC already has the SMBIOS data.
+
+  The hash of the last successful transfer is saved in a variable.  If the BMC
+  reports the state of the blob, it must also hold a committed blob of the
+  expected size, so that tables lost by the BMC are sent again.
+
+  @param[in]  IpmiBlobTransfer  IPMI blob transfer protocol.
+  @param[in]  BlobId            SMBIOS blob id.
+  @param[in]  Hash              Hash of the SMBIOS data to send.
+  @param[in]  SendDataSize      Size of the SMBIOS data to send.
+
+  @retval TRUE                  Transfer is not needed.
+  @retval FALSE                 Transfer is needed.
+
+**/
+STATIC
+BOOLEAN
+SmbiosBmcTransferIsCurrent (
+  IN  IPMI_BLOB_TRANSFER_PROTOCOL  *IpmiBlobTransfer,
+  IN  CHAR8                        *BlobId,
+  IN  CONST UINT8                  *Hash,
+  IN  UINT32                       SendDataSize
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       StoredHash[SHA256_DIGEST_SIZE];
+  UINTN       VariableSize;
+  UINT16      BlobState;
+  UINT32      BlobSize;
+  UINT8       MetadataLength;
+  UINT8       Metadata[IPMI_OEM_BLOB_MAX_DATA_PER_PACKET];
+
+  VariableSize = sizeof (StoredHash);
+  Status       = gRT->GetVariable (
+                        SMBIOS_TRANSFER_HASH_VARIABLE_NAME,
+                        &gNVIDIATokenSpaceGuid,
+                        NULL,
+                        &VariableSize,
+                        StoredHash
+                        );
+  if (EFI_ERROR (Status) ||
+      (VariableSize != sizeof (StoredHash)) ||
+      (CompareMem (StoredHash, Hash, sizeof (StoredHash)) != 0))
+  {
+    return FALSE;
+  }
+
+  Status = IpmiBlobTransfer->BlobStat (BlobId, &BlobState, &BlobSize, &MetadataLength, Metadata);
+  if (EFI_ERROR (Status)) {
+    // BMC does not report blob state, rely on the saved hash
+    return TRUE;
+  }
+
+  if (((BlobState & BLOB_TRANSFER_STAT_COMMITTED) == 0) || (BlobSize != SendDataSize)) {
+    DEBUG ((DEBUG_INFO, "%a: BMC blob state=0x%x size=%u, resending\n", __FUNCTION__, BlobState, BlobSize));
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+  Write data to the SMBIOS blob, directly from the source buffer.
+
+  @param[in]  IpmiBlobTransfer  IPMI blob transfer protocol.
+  @param[in]  SessionId         Blob session id.
+  @param[in]  Offset            Offset in the blob to write.
+  @param[in]  Data              Data to write.
+  @param[in]  Length            Length of the data.
+
+  @retval EFI_SUCCESS           Data written.
+  @retval Others                Error returned by BlobWrite.
+
+**/
+STATIC
+EFI_STATUS
+SmbiosBmcTransferWrite (
+  IN  IPMI_BLOB_TRANSFER_PROTOCOL  *IpmiBlobTransfer,
+  IN  UINT16                       SessionId,
+  IN  UINT32                       Offset,
+  IN  CONST UINT8                  *Data,
+  IN  UINT32                       Length
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = IpmiBlobTransfer->BlobWrite (SessionId, Offset, (UINT8 *)Data, Length);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failure writing %u bytes at 0x%x to blob: %r\n", __FUNCTION__, Length, Offset, Status));
+  }
+
+  return Status;
+}
+
 /**
   This function will send all installed SMBIOS tables to the BMC
 
@@ -40,13 +177,14 @@ SmbiosBmcTransferSendTables (
 {
   EFI_STATUS                    Status;
   SMBIOS_TABLE_3_0_ENTRY_POINT  *Smbios30Table;
-  SMBIOS_TABLE_3_0_ENTRY_POINT  *Smbios30TableModified;
+  SMBIOS_TABLE_3_0_ENTRY_POINT  Smbios30TableModified;
   IPMI_BLOB_TRANSFER_PROTOCOL   *IpmiBlobTransfer;
-  UINT16                        Index;
+  CHAR8                         *BlobId;
   UINT16                        SessionId;
-  UINT8                         *SendData;
+  UINT8                         *Table;
   UINT32                        SendDataSize;
-  UINT32                        RemainingDataSize;
+  UINT8                         Hash[SHA256_DIGEST_SIZE];
+  BOOLEAN                       HashValid;
 
   gBS->CloseEvent (Event);
 
@@ -72,65 +210,49 @@ SmbiosBmcTransferSendTables (
   //
   // BMC expects the Smbios Entry Point to point to the address within the binary data sent
   // The value is initially pointing to the location in memory where the table lives
-  // So we will save off that value and then modify the entry point to make the BMC happy
-  Smbios30TableModified = AllocateZeroPool (sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT));
-  CopyMem (Smbios30TableModified, Smbios30Table, sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT));
-  Smbios30TableModified->TableAddress = sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT);
+  // So we will send a modified copy of the entry point followed by the table itself
+  CopyMem (&Smbios30TableModified, Smbios30Table, sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT));
+  Smbios30TableModified.TableAddress = sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT);
   //
   // Fixup checksums in the Entry Point Structure
   //
-  Smbios30TableModified->EntryPointStructureChecksum = 0;
-  Smbios30TableModified->EntryPointStructureChecksum =
-    CalculateCheckSum8 ((UINT8 *)Smbios30TableModified, Smbios30TableModified->EntryPointLength);
+  Smbios30TableModified.EntryPointStructureChecksum = 0;
+  Smbios30TableModified.EntryPointStructureChecksum =
+    CalculateCheckSum8 ((UINT8 *)&Smbios30TableModified, Smbios30TableModified.EntryPointLength);
 
-  SendData = AllocateZeroPool (sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT) + Smbios30Table->TableMaximumSize);
-  CopyMem (SendData, Smbios30TableModified, sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT));
-  CopyMem (SendData + sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT), (UINT8 *)Smbios30Table->TableAddress, Smbios30Table->TableMaximumSize);
-  SendDataSize      = sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT) + Smbios30Table->TableMaximumSize;
-  RemainingDataSize = SendDataSize;
+  Table        = (UINT8 *)(UINTN)Smbios30Table->TableAddress;
+  SendDataSize = sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT) + Smbios30Table->TableMaximumSize;
+  BlobId       = (CHAR8 *)PcdGetPtr (PcdBmcSmbiosBlobTransferId);
 
  #if SMBIOS_TRANSFER_DEBUG
-  DEBUG ((DEBUG_INFO, "%a: SMBIOS BINARY DATA OUTPUT\n", __FUNCTION__));
-  DEBUG ((DEBUG_INFO, "%a: Table Address: %x\n", __FUNCTION__, Smbios30Table->TableAddress));
+  DEBUG ((DEBUG_INFO, "%a: Table Address: %lx\n", __FUNCTION__, Smbios30Table->TableAddress));
   DEBUG ((DEBUG_INFO, "%a: Table Length: %x\n", __FUNCTION__, Smbios30Table->TableMaximumSize));
-  for (Index = 0; Index < SendDataSize; Index++) {
-    if ((Index % IPMI_OEM_BLOB_MAX_DATA_PER_PACKET) == 0) {
-      DEBUG ((DEBUG_INFO, "\nIndex:%x ", Index));
-    }
+ #endif
 
-    DEBUG ((DEBUG_INFO, "%02x ", *(SendData + Index)));
+  HashValid = SmbiosBmcTransferHash (&Smbios30TableModified, Table, Smbios30Table->TableMaximumSize, Hash);
+  if (HashValid && SmbiosBmcTransferIsCurrent (IpmiBlobTransfer, BlobId, Hash, SendDataSize)) {
+    DEBUG ((DEBUG_INFO, "%a: SMBIOS tables unchanged, skipping transfer\n", __FUNCTION__));
+    return;
   }
 
- #endif
-
-  Status = IpmiBlobTransfer->BlobOpen ((CHAR8 *)PcdGetPtr (PcdBmcSmbiosBlobTransferId), BLOB_TRANSFER_STAT_OPEN_W, &SessionId);
+  Status = IpmiBlobTransfer->BlobOpen (BlobId, BLOB_TRANSFER_STAT_OPEN_W, &SessionId);
   if (EFI_ERROR (Status)) {
     if (Status == EFI_UNSUPPORTED) {
       return;
     }
 
-    DEBUG ((DEBUG_ERROR, "%a: Unable to open Blob with Id %a: %r\n", __FUNCTION__, PcdGetPtr (PcdBmcSmbiosBlobTransferId), Status));
+    DEBUG ((DEBUG_ERROR, "%a: Unable to open Blob with Id %a: %r\n", __FUNCTION__, BlobId, Status));
     goto ErrorExit;
   }
 
-  for (Index = 0; Index < (SendDataSize / IPMI_OEM_BLOB_MAX_DATA_PER_PACKET); Index++) {
-    Status = IpmiBlobTransfer->BlobWrite (SessionId, Index * IPMI_OEM_BLOB_MAX_DATA_PER_PACKET, SendData, IPMI_OEM_BLOB_MAX_DATA_PER_PACKET);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "%a: Failure writing to blob: %r\n", __FUNCTION__, Status));
-      goto ErrorExit;
-    }
-
-    SendData           = (UINT8 *)SendData + IPMI_OEM_BLOB_MAX_DATA_PER_PACKET;
-    RemainingDataSize -= IPMI_OEM_BLOB_MAX_DATA_PER_PACKET;
+  Status = SmbiosBmcTransferWrite (IpmiBlobTransfer, SessionId, 0, (UINT8 *)&Smbios30TableModified, sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT));
+  if (!EFI_ERROR (Status)) {
+    Status = SmbiosBmcTransferWrite (IpmiBlobTransfer, SessionId, sizeof (SMBIOS_TABLE_3_0_ENTRY_POINT), Table, Smbios30Table->TableMaximumSize);
   }
 
-  ASSERT (RemainingDataSize < IPMI_OEM_BLOB_MAX_DATA_PER_PACKET);
-  if (RemainingDataSize) {
-    Status = IpmiBlobTransfer->BlobWrite (SessionId, Index * IPMI_OEM_BLOB_MAX_DATA_PER_PACKET, SendData, RemainingDataSize);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "%a: Failure writing final block to blob: %r\n", __FUNCTION__, Status));
-      goto ErrorExit;
-    }
+  if (EFI_ERROR (Status)) {
+    IpmiBlobTransfer->BlobClose (SessionId);
+    goto ErrorExit;
   }
 
   Status = IpmiBlobTransfer->BlobCommit (SessionId, 0, NULL);
@@ -145,6 +267,21 @@ SmbiosBmcTransferSendTables (
     goto ErrorExit;
   }
 
+  DEBUG ((DEBUG_INFO, "%a: Sent %u bytes of SMBIOS tables to BMC\n", __FUNCTION__, SendDataSize));
+
+  if (HashValid) {
+    Status = gRT->SetVariable (
+                    SMBIOS_TRANSFER_HASH_VARIABLE_NAME,
+                    &gNVIDIATokenSpaceGuid,
+                    EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_NON_VOLATILE,
+                    sizeof (Hash),
+                    Hash
+                    );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: Failed to save SMBIOS hash: %r\n", __FUNCTION__, Status));
+    }
+  }
+
   return;
 
 ErrorExit:
@@ -537,7 +537,7 @@ TegraI2cStartRequest (
       Crc8 = CalculateCrc8 (&AddressCrc8, 1, Crc8, TYPE_CRC8);
       if (!ReadOperation) {
         if (RequestPacket->Operation[PacketIndex].LengthInBytes != 0) {
-          Crc8 = CalculateCrc8 (RequestPacket->Operation[PacketIndex].Buffer, RequestPacket->Operation[PacketIndex].LengthInBytes, Crc8, TYPE_CRC8);
+          Crc8 = Crc8Update (Crc8, RequestPacket->Operation[PacketIndex].Buffer, RequestPacket->Operation[PacketIndex].LengthInBytes, TYPE_CRC8);
         }
       }
     }
@@ -687,7 +687,7 @@ TegraI2cStartRequest (
 
     if (ReadOperation && PecSupported) {
       if (RequestPacket->Operation[PacketIndex].LengthInBytes != 0) {
-        Crc8 = CalculateCrc8 (RequestPacket->Operation[PacketIndex].Buffer, RequestPacket->Operation[PacketIndex].LengthInBytes, Crc8, TYPE_CRC8);
+        Crc8 = Crc8Update (Crc8, RequestPacket->Operation[PacketIndex].Buffer, RequestPacket->Operation[PacketIndex].LengthInBytes, TYPE_CRC8);
       }
     }
 
@@ -36,4 +36,60 @@ CalculateCrc8 (
   IN UINT8   Type
   );
 
+/**
+  Updates a CRC-8 with the contents of a buffer.
+
+  The CRC-8 types have no final XOR, so a buffer may be processed in pieces by
+  passing the value returned for one piece as the Crc of the next.
+
+  @param[in]  Crc                  CRC-8 of the preceding data, or the seed.
+  @param[in]  Buffer               A pointer to the data buffer.
+  @param[in]  Size                 Size of buffer.
+  @param[in]  Type                 Type of the CRC to use
+
+  @return the updated CRC-8 value, 0 if Type is not supported.
+**/
+UINT8
+EFIAPI
+Crc8Update (
+  IN UINT8       Crc,
+  IN CONST VOID  *Buffer,
+  IN UINTN       Size,
+  IN UINT8       Type
+  );
+
+/**
+  Updates a TYPE_CRC8 CRC-8 with the contents of a buffer.
+
+  @param[in]  Crc                  CRC-8 of the preceding data, or the seed.
+  @param[in]  Buffer               A pointer to the data buffer.
+  @param[in]  Size                 Size of buffer.
+
+  @return the updated CRC-8 value.
+**/
+UINT8
+EFIAPI
+Crc8UpdateCrc8 (
+  IN UINT8       Crc,
+  IN CONST VOID  *Buffer,
+  IN UINTN       Size
+  );
+
+/**
+  Updates a TYPE_CRC8_MAXIM CRC-8 with the contents of a buffer.
+
+  @param[in]  Crc                  CRC-8 of the preceding data, or the seed.
+  @param[in]  Buffer               A pointer to the data buffer.
+  @param[in]  Size                 Size of buffer.
+
+  @return the updated CRC-8 value.
+**/
+UINT8
+EFIAPI
+Crc8UpdateMaxim (
+  IN UINT8       Crc,
+  IN CONST VOID  *Buffer,
+  IN UINTN       Size
+  );
+
 #endif
@@ -1,6 +1,6 @@
 /** @file
 *
-*  Copyright (c) 2018-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+*  Copyright (c) 2018-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 *
 *  SPDX-License-Identifier: BSD-2-Clause-Patent
 *
@@ -26,11 +26,12 @@ typedef struct {
   the carveout regions.
   This function is called by the platform memory initialization library.
 
-  @param  DramRegions              Sorted list of available DRAM regions
+  @param  DramRegions              List of available DRAM regions, sorted in place.
   @param  DramRegionsCount         Number of regions in DramRegions.
-  @param  UefiDramRegionIndex      Index of uefi usable regions in DramRegions.
-  @param  CarveoutRegions          Sorted list of carveout regions that will be
-                                   removed from DramRegions.
+  @param  UefiDramRegionIndex      Index of uefi usable regions in sorted DramRegions.
+  @param  CarveoutRegions          List of carveout regions that will be removed
+                                   from DramRegions, sorted and merged in place.
+                                   Carveouts may overlap each other.
   @param  CarveoutRegionsCount     Number of regions in CarveoutRegions.
   @param  FinalRegionsCount        Number of regions installed into HOB list.
 
@@ -85,6 +85,7 @@ typedef struct {
   // erot state
   BOOLEAN                            ErotIsInitialized;
   BOOLEAN                            HasMessageAvailable;
+  UINT32                             MemBurstBytes;
 
   // protocol
   EFI_HANDLE                         Handle;
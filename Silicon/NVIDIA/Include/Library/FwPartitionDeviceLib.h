@@ -78,12 +78,69 @@ EFI_STATUS
   IN  CONST VOID                        *Buffer
   );
 
-// device information structure
+/**
+  Write any data the device still holds to the media.
+
+  @param[in]  DeviceInfo        Pointer to device info struct
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error occurred
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FW_PARTITION_DEVICE_FLUSH)(
+  IN  FW_PARTITION_DEVICE_INFO          *DeviceInfo
+  );
+
+/**
+  Start erasing data from device ahead of writing it, without waiting for
+  the erase to complete.  Writes within the erased range skip their erase.
+  The device accepts no other erase until the range has been written.
+
+  @param[in]  DeviceInfo        Pointer to device info struct
+  @param[in]  Offset            Offset to begin erase
+  @param[in]  Bytes             Number of bytes to erase
+
+  @retval EFI_SUCCESS           Erase started
+  @retval EFI_ALREADY_STARTED   An earlier erased range is not yet written
+  @retval others                Error occurred
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FW_PARTITION_DEVICE_ERASE_ASYNC)(
+  IN  FW_PARTITION_DEVICE_INFO          *DeviceInfo,
+  IN  UINT64                            Offset,
+  IN  UINTN                             Bytes
+  );
+
+/**
+  Progress an erase started by FW_PARTITION_DEVICE_ERASE_ASYNC.
+
+  @param[in]  DeviceInfo        Pointer to device info struct
+
+  @retval EFI_SUCCESS           No erase pending
+  @retval EFI_NOT_READY         Erase still in progress
+  @retval others                Erase failed
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FW_PARTITION_DEVICE_ERASE_POLL)(
+  IN  FW_PARTITION_DEVICE_INFO          *DeviceInfo
+  );
+
+// device information structure, DeviceFlush is NULL if writes are not deferred,
+// DeviceEraseAsync and DeviceErasePoll are NULL if erases can't run in the background
 struct _FW_PARTITION_DEVICE_INFO {
-  CONST CHAR16                 *DeviceName;
-  FW_PARTITION_DEVICE_READ     DeviceRead;
-  FW_PARTITION_DEVICE_WRITE    DeviceWrite;
-  UINT32                       BlockSize;
+  CONST CHAR16                       *DeviceName;
+  FW_PARTITION_DEVICE_READ           DeviceRead;
+  FW_PARTITION_DEVICE_WRITE          DeviceWrite;
+  FW_PARTITION_DEVICE_FLUSH          DeviceFlush;
+  FW_PARTITION_DEVICE_ERASE_ASYNC    DeviceEraseAsync;
+  FW_PARTITION_DEVICE_ERASE_POLL     DeviceErasePoll;
+  UINT32                             BlockSize;
 };
 
 // partition information structure
@@ -132,7 +189,8 @@ FwPartitionAdd (
   );
 
 /**
-  Add new FW partitions for all partitions in the device's secondary GPT.
+  Add new FW partitions for all partitions in the device's GPT, using the
+  secondary GPT or the primary GPT if the secondary is not valid.
   Initializes a FW_PARTITION_PRIVATE_DATA structure for each partition.
 
   @param[in]  DeviceInfo        Pointer to device info struct
@@ -3,7 +3,7 @@
   GPT - GUID Partition Table Library Public Interface
         This implementation of GPT uses just the secondary GPT table.
 
-  Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2021-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -17,6 +17,39 @@
 
 #define NVIDIA_GPT_BLOCK_SIZE  512
 
+/**
+  Read data from the device holding a GPT.
+
+  @param[in]  Context           Caller context
+  @param[in]  Offset            Offset to read from
+  @param[in]  Bytes             Number of bytes to read
+  @param[out] Buffer            Address to read data into
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error occurred
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *GPT_DEVICE_READ)(
+  IN  VOID                              *Context,
+  IN  UINT64                            Offset,
+  IN  UINTN                             Bytes,
+  OUT VOID                              *Buffer
+  );
+
+// validated GPT with a name index, read-only for consumers
+typedef struct {
+  EFI_PARTITION_TABLE_HEADER    Header;
+  VOID                          *PartitionTable;
+  BOOLEAN                       IsPrimary;
+
+  // name hash buckets and chains, holding entry index + 1, 0 ends a chain
+  UINT32                        *NameHash;
+  UINT32                        *NameNext;
+  UINT32                        NameHashSize;
+} GPT_TABLE;
+
 /**
   Validate GPT header structure
 
@@ -94,6 +127,92 @@ GptFindPartitionByName (
   IN CONST CHAR16                      *Name
   );
 
+/**
+  Hash a partition name, as used by the GPT_TABLE name index
+
+  @param[in]    Name            Pointer to the name string
+
+  @retval       UINT32          Hash of the name
+**/
+UINT32
+EFIAPI
+GptPartitionNameHash (
+  IN CONST CHAR16  *Name
+  );
+
+/**
+  Initialize a GPT_TABLE from a GPT header and partition table.  The
+  partition table is validated once and indexed by name, and the GPT_TABLE
+  keeps its own copy of both.
+
+  @param[in]    Header                  Pointer to GPT header structure
+  @param[in]    PartitionTable          Pointer to GPT partition table first entry
+  @param[out]   Table                   GPT table to initialize
+
+  @retval       EFI_SUCCESS             Table initialized
+  @retval       EFI_CRC_ERROR           Partition table has invalid CRC
+  @retval       EFI_VOLUME_CORRUPTED    Partition table entry had invalid LBA range
+  @retval       EFI_OUT_OF_RESOURCES    Failed to allocate the table
+**/
+EFI_STATUS
+EFIAPI
+GptTableInit (
+  IN  CONST EFI_PARTITION_TABLE_HEADER  *Header,
+  IN  CONST VOID                        *PartitionTable,
+  OUT GPT_TABLE                         *Table
+  );
+
+/**
+  Read and validate the GPT of a device into a GPT_TABLE.  The secondary GPT
+  at the end of the device is used, falling back to the primary GPT if the
+  secondary GPT is not valid.
+
+  @param[in]    Read                    Function to read the device
+  @param[in]    Context                 Context passed to Read
+  @param[in]    DeviceBytes             Size of the device in bytes
+  @param[out]   Table                   GPT table to initialize
+
+  @retval       EFI_SUCCESS             Table read
+  @retval       EFI_VOLUME_CORRUPTED    No valid GPT found
+  @retval       EFI_OUT_OF_RESOURCES    Failed to allocate the table
+  @retval       Others                  Error returned by Read or GptTableInit
+**/
+EFI_STATUS
+EFIAPI
+GptTableRead (
+  IN  GPT_DEVICE_READ  Read,
+  IN  VOID             *Context,
+  IN  UINT64           DeviceBytes,
+  OUT GPT_TABLE        *Table
+  );
+
+/**
+  Find a partition table entry of a GPT_TABLE by its partition name field
+
+  @param[in]    Table           GPT table
+  @param[in]    Name            Pointer to the name string to find
+
+  @retval       NULL            Partition not found with that name
+  @retval       Other           Pointer to the matching partition table entry
+**/
+CONST EFI_PARTITION_ENTRY *
+EFIAPI
+GptTableFindPartitionByName (
+  IN CONST GPT_TABLE  *Table,
+  IN CONST CHAR16     *Name
+  );
+
+/**
+  Free the resources of a GPT_TABLE
+
+  @param[in]    Table           GPT table
+**/
+VOID
+EFIAPI
+GptTableFree (
+  IN GPT_TABLE  *Table
+  );
+
 /**
   Return the size of a partition in blocks
 
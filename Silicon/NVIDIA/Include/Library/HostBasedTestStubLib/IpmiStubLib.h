@@ -44,7 +44,7 @@ IpmiStubInit (
   );
 
 /**
- Cleanup Ipmi stub support
+ Cleanup Ipmi stub support, dropping any responses that were not consumed
 
   @retval None
 
@@ -61,6 +61,32 @@ MockIpmiSubmitCommand (
   IN EFI_STATUS  ReturnStatus
   );
 
+/**
+  Set the response returned once all queued mock responses are consumed.
+
+  @param ResponseData      - Response Data, NULL to clear the default response
+  @param ResponseDataSize  - Response Data Size
+  @param ReturnStatus      - Status returned by IpmiSubmitCommand
+
+**/
+VOID
+MockIpmiSubmitCommandDefault (
+  IN UINT8       *ResponseData,
+  IN UINT32      ResponseDataSize,
+  IN EFI_STATUS  ReturnStatus
+  );
+
+/**
+  Get the number of times IpmiSubmitCommand was called.
+
+  @retval Number of commands submitted
+
+**/
+UINTN
+MockIpmiGetSubmitCount (
+  VOID
+  );
+
 /**
   Routine to send commands to BMC.
 
@@ -0,0 +1,222 @@
+/** @file
+
+  Image Decompress Library
+
+  Streaming decoders for compressed kernel and ramdisk payloads.
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __IMAGE_DECOMPRESS_LIB_H__
+#define __IMAGE_DECOMPRESS_LIB_H__
+
+#include <Uefi/UefiBaseType.h>
+
+#define IMAGE_DECOMPRESS_CHUNK_SIZE  SIZE_1MB
+
+typedef enum {
+  ImageCompressionNone,
+  ImageCompressionGzip,
+  ImageCompressionLz4,        // LZ4 frame format
+  ImageCompressionLz4Legacy,  // LZ4 legacy format, used by the Linux Image.lz4 target
+  ImageCompressionMax
+} IMAGE_COMPRESSION_TYPE;
+
+typedef struct {
+  UINT64    CompressedSize;
+  UINT64    DecompressedSize;
+  UINT32    ReadCount;
+  UINT32    ReadAheadCount;   // reads that overlapped decoding
+} IMAGE_DECOMPRESS_STATS;
+
+/**
+  Read compressed data from the image source.
+
+  @param[in]  Context       Context passed to the decompress call
+  @param[in]  Offset        Offset of the data in the compressed image
+  @param[out] Buffer        Buffer to read the data into
+  @param[in]  Size          Number of bytes to read
+
+  @retval EFI_SUCCESS       Data read successfully
+  @retval Others            Error reading data
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *IMAGE_DECOMPRESS_READ)(
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  OUT VOID    *Buffer,
+  IN  UINTN   Size
+  );
+
+/**
+  Start reading compressed data from the image source without waiting for
+  the read to complete.  Only one read is started at a time, and Buffer is
+  not used until IMAGE_DECOMPRESS_READ_WAIT returns.
+
+  @param[in]  Context       Context passed to the decompress call
+  @param[in]  Offset        Offset of the data in the compressed image
+  @param[out] Buffer        Buffer to read the data into
+  @param[in]  Size          Number of bytes to read
+
+  @retval EFI_SUCCESS       Read started
+  @retval EFI_UNSUPPORTED   Source can't read in the background
+  @retval Others            Error starting the read
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *IMAGE_DECOMPRESS_READ_START)(
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  OUT VOID    *Buffer,
+  IN  UINTN   Size
+  );
+
+/**
+  Wait for the read started by IMAGE_DECOMPRESS_READ_START to complete.
+
+  @param[in]  Context       Context passed to the decompress call
+
+  @retval EFI_SUCCESS       Data read successfully
+  @retval Others            Error reading data
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *IMAGE_DECOMPRESS_READ_WAIT)(
+  IN  VOID    *Context
+  );
+
+// Image source functions. ReadStart and ReadWait are NULL if the source
+// can't read in the background.
+typedef struct {
+  IMAGE_DECOMPRESS_READ          Read;
+  IMAGE_DECOMPRESS_READ_START    ReadStart;
+  IMAGE_DECOMPRESS_READ_WAIT     ReadWait;
+} IMAGE_DECOMPRESS_READER;
+
+/**
+  Identify the compression format of an image from its first bytes.
+
+  @param[in]  Buffer        Start of the image
+  @param[in]  BufferSize    Number of bytes available in Buffer
+
+  @retval Compression type of the image, ImageCompressionNone if not recognized
+
+**/
+IMAGE_COMPRESSION_TYPE
+EFIAPI
+ImageDecompressGetType (
+  IN CONST VOID  *Buffer,
+  IN UINTN       BufferSize
+  );
+
+/**
+  Get the size of the buffer needed to decompress an image.
+
+  Formats that record the decompressed size return it exactly, otherwise an
+  upper bound derived from the block headers is returned.
+
+  @param[in]  Type              Compression type of the image
+  @param[in]  Read              Function to read the compressed image
+  @param[in]  Context           Context passed to Read
+  @param[in]  CompressedSize    Size of the compressed image
+  @param[out] DecompressedSize  Size of the buffer needed to decompress the image
+
+  @retval EFI_SUCCESS            Size returned
+  @retval EFI_INVALID_PARAMETER  Invalid parameter
+  @retval EFI_UNSUPPORTED        Compression type not supported
+  @retval EFI_VOLUME_CORRUPTED   Compressed image is malformed
+  @retval Others                 Error returned by Read
+
+**/
+EFI_STATUS
+EFIAPI
+ImageDecompressGetSize (
+  IN  IMAGE_COMPRESSION_TYPE  Type,
+  IN  IMAGE_DECOMPRESS_READ   Read,
+  IN  VOID                    *Context,
+  IN  UINT64                  CompressedSize,
+  OUT UINT64                  *DecompressedSize
+  );
+
+/**
+  Decompress an image.
+
+  The compressed image is read through Read in IMAGE_DECOMPRESS_CHUNK_SIZE
+  chunks, and each chunk is decoded before the next one is requested, so the
+  compressed image never has to be resident in memory.
+
+  @param[in]  Type              Compression type of the image
+  @param[in]  Read              Function to read the compressed image
+  @param[in]  Context           Context passed to Read
+  @param[in]  CompressedSize    Size of the compressed image
+  @param[out] Destination       Buffer to decompress the image to
+  @param[in]  DestinationSize   Size of Destination
+  @param[out] Stats             Optional decompression statistics
+
+  @retval EFI_SUCCESS            Image decompressed, size in Stats
+  @retval EFI_INVALID_PARAMETER  Invalid parameter
+  @retval EFI_UNSUPPORTED        Compression type or feature not supported
+  @retval EFI_BUFFER_TOO_SMALL   Destination is too small for the image
+  @retval EFI_VOLUME_CORRUPTED   Compressed image is malformed
+  @retval EFI_CRC_ERROR          Decompressed data failed the integrity check
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the stream buffers
+  @retval Others                 Error returned by Read
+
+**/
+EFI_STATUS
+EFIAPI
+ImageDecompress (
+  IN  IMAGE_COMPRESSION_TYPE  Type,
+  IN  IMAGE_DECOMPRESS_READ   Read,
+  IN  VOID                    *Context,
+  IN  UINT64                  CompressedSize,
+  OUT VOID                    *Destination,
+  IN  UINTN                   DestinationSize,
+  OUT IMAGE_DECOMPRESS_STATS  *Stats OPTIONAL
+  );
+
+/**
+  Decompress an image, overlapping reads with decoding.
+
+  Like ImageDecompress(), but if the reader can read in the background the
+  next IMAGE_DECOMPRESS_CHUNK_SIZE chunk is read into a second buffer while
+  the current chunk is decoded.
+
+  @param[in]  Type              Compression type of the image
+  @param[in]  Reader            Functions to read the compressed image
+  @param[in]  Context           Context passed to the Reader functions
+  @param[in]  CompressedSize    Size of the compressed image
+  @param[out] Destination       Buffer to decompress the image to
+  @param[in]  DestinationSize   Size of Destination
+  @param[out] Stats             Optional decompression statistics
+
+  @retval EFI_SUCCESS            Image decompressed, size in Stats
+  @retval EFI_INVALID_PARAMETER  Invalid parameter
+  @retval EFI_UNSUPPORTED        Compression type or feature not supported
+  @retval EFI_BUFFER_TOO_SMALL   Destination is too small for the image
+  @retval EFI_VOLUME_CORRUPTED   Compressed image is malformed
+  @retval EFI_CRC_ERROR          Decompressed data failed the integrity check
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the stream buffers
+  @retval Others                 Error returned by the Reader functions
+
+**/
+EFI_STATUS
+EFIAPI
+ImageDecompressEx (
+  IN  IMAGE_COMPRESSION_TYPE         Type,
+  IN  CONST IMAGE_DECOMPRESS_READER  *Reader,
+  IN  VOID                           *Context,
+  IN  UINT64                         CompressedSize,
+  OUT VOID                           *Destination,
+  IN  UINTN                          DestinationSize,
+  OUT IMAGE_DECOMPRESS_STATS         *Stats OPTIONAL
+  );
+
+#endif
@@ -9,8 +9,25 @@
 #ifndef __QSPI_CONTROLLER_LIB_H__
 #define __QSPI_CONTROLLER_LIB_H__
 
-#define QSPI_CONTROLLER_CONTROL_FAST_MODE  0x01
+#define QSPI_CONTROLLER_CONTROL_FAST_MODE   0x01
+#define QSPI_CONTROLLER_CONTROL_MULTI_LANE  0x02
 
+/**
+  Number of data lanes used for a phase of a transaction
+**/
+typedef enum QspiBusWidth {
+  QspiBusWidthSingle,     ///< 0 - One lane
+  QspiBusWidthDual,       ///< 1 - Two lanes
+  QspiBusWidthQuad,       ///< 2 - Four lanes
+  QspiBusWidthMax
+} QSPI_BUS_WIDTH;
+
+//
+// TxSingleLen, TxBusWidth and RxBusWidth are only used when Control has
+// QSPI_CONTROLLER_CONTROL_MULTI_LANE set, otherwise all phases use one lane.
+// The first TxSingleLen bytes of TxBuf (command, and address for 1-1-x
+// transfers) are sent on one lane, the rest of TxBuf on TxBusWidth lanes.
+//
 typedef struct {
   VOID      *TxBuf;
   UINT32    TxLen;
@@ -19,6 +36,9 @@ typedef struct {
   UINT8     WaitCycles;
   UINT8     ChipSelect;
   UINT8     Control;
+  UINT8     TxSingleLen;
+  UINT8     TxBusWidth;
+  UINT8     RxBusWidth;
 } QSPI_TRANSACTION_PACKET;
 
 /**
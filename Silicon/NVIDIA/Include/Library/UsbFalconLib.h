@@ -2,7 +2,7 @@
 
   Falcon Register Access
 
-  Copyright (c) 2019-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2019-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -52,6 +52,20 @@ struct tegra_xhci_fw_cfgtbl {
   UINT8     padding[137]; /* Padding to make 256-bytes cfgtbl */
 };
 
+/*
+ * Header of a UEFI-compressed Falcon firmware image, followed by the
+ * compressed data.  The decompressed image is ImageSize bytes long and its
+ * fwimg_cksum is a CRC32 of the image after the config table, up to
+ * fwimg_len.  Firmware without this header is a raw image.
+ */
+
+#define FALCON_COMPRESSED_FIRMWARE_SIGNATURE  SIGNATURE_32 ('X', 'F', 'W', 'Z')
+
+typedef struct {
+  UINT32    Signature;
+  UINT32    ImageSize;
+} FALCON_COMPRESSED_FIRMWARE_HEADER;
+
 /* Falcon CSB Registers */
 
 #define IMEM_BLOCK_SIZE  256
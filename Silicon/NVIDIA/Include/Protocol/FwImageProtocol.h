@@ -1,7 +1,7 @@
 /** @file
   FW Image Protocol
 
-  Copyright (c) 2021 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2021-2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -89,6 +89,73 @@ EFI_STATUS
   IN  UINTN                             Flags
   );
 
+/**
+  Write any data still held for the image's partitions to the media.
+  Write() may return before its data reaches the media, so callers must
+  flush before relying on the image's new contents.
+
+  @param[in]  This              Instance to protocol
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error writing the media
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FW_IMAGE_FLUSH)(
+  IN  NVIDIA_FW_IMAGE_PROTOCOL          *This
+  );
+
+/**
+  Start erasing a range of the partition Write() would write with the same
+  Flags, without waiting for the erase to complete.  The erase runs while
+  other images are written, and writes within the range skip their erase.
+
+  @param[in]  This              Instance to protocol
+  @param[in]  Offset            Offset to begin erase
+  @param[in]  Bytes             Number of bytes to erase
+  @param[in]  Flags             Flags for write operation
+
+  @retval EFI_SUCCESS           Erase started
+  @retval EFI_ALREADY_STARTED   The image's device is busy with an earlier
+                                erase whose range is not yet written, retry
+                                once that range has been written
+  @retval EFI_UNSUPPORTED       The image's device can't erase in the
+                                background
+  @retval others                Error occurred
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FW_IMAGE_ERASE_ASYNC)(
+  IN  NVIDIA_FW_IMAGE_PROTOCOL          *This,
+  IN  UINT64                            Offset,
+  IN  UINTN                             Bytes,
+  IN  UINTN                             Flags
+  );
+
+/**
+  Progress an erase started by EraseAsync().  The erase only moves on to
+  its next erase block when the image's device is accessed, so callers busy
+  with other images must poll.
+
+  @param[in]  This              Instance to protocol
+  @param[in]  Flags             Flags for write operation
+
+  @retval EFI_SUCCESS           No erase pending
+  @retval EFI_NOT_READY         Erase still in progress
+  @retval EFI_UNSUPPORTED       The image's device can't erase in the
+                                background
+  @retval others                Erase failed
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FW_IMAGE_ERASE_POLL)(
+  IN  NVIDIA_FW_IMAGE_PROTOCOL          *This,
+  IN  UINTN                             Flags
+  );
+
 /**
   Get image attributes.
 
@@ -112,6 +179,9 @@ struct _NVIDIA_FW_IMAGE_PROTOCOL {
   FW_IMAGE_READ_IMAGE        Read;
   FW_IMAGE_WRITE_IMAGE       Write;
   FW_IMAGE_GET_ATTRIBUTES    GetAttributes;
+  FW_IMAGE_FLUSH             Flush;
+  FW_IMAGE_ERASE_ASYNC       EraseAsync;
+  FW_IMAGE_ERASE_POLL        ErasePoll;
 };
 
 extern EFI_GUID  gNVIDIAFwImageProtocolGuid;
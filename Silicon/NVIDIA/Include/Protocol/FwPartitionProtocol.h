@@ -1,7 +1,7 @@
 /** @file
   FW Partition Protocol
 
-  Copyright (c) 2021 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2021-2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -71,6 +71,70 @@ EFI_STATUS
   IN  CONST VOID                        *Buffer
   );
 
+/**
+  Write any data the partition's device still holds for the partition to
+  the media.  Writes may complete before their data reaches the media, so
+  callers must flush before relying on the partition's new contents.
+
+  @param[in] This                  Instance to protocol
+
+  @retval EFI_SUCCESS              Operation successful
+  @retval others                   Error writing the media
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FW_PARTITION_FLUSH)(
+  IN  NVIDIA_FW_PARTITION_PROTOCOL      *This
+  );
+
+/**
+  Start erasing a range of the partition ahead of writing it, without
+  waiting for the erase to complete.  The erase runs while other devices are
+  accessed, and writes within the range skip their erase.
+
+  @param[in] This                  Instance to protocol
+  @param[in] Offset                Offset to begin erase
+  @param[in] Bytes                 Number of bytes to erase
+
+  @retval EFI_SUCCESS              Erase started
+  @retval EFI_ALREADY_STARTED      The partition's device is busy with an
+                                   earlier erase whose range is not yet
+                                   written, retry once that range has been
+                                   written
+  @retval EFI_UNSUPPORTED          The partition's device can't erase in the
+                                   background
+  @retval others                   Error occurred
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FW_PARTITION_ERASE_ASYNC)(
+  IN  NVIDIA_FW_PARTITION_PROTOCOL      *This,
+  IN  UINT64                            Offset,
+  IN  UINTN                             Bytes
+  );
+
+/**
+  Progress an erase started by EraseAsync().  The erase only moves on to
+  its next erase block when the partition's device is accessed, so callers
+  busy with other devices must poll.
+
+  @param[in] This                  Instance to protocol
+
+  @retval EFI_SUCCESS              No erase pending
+  @retval EFI_NOT_READY            Erase still in progress
+  @retval EFI_UNSUPPORTED          The partition's device can't erase in the
+                                   background
+  @retval others                   Erase failed
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FW_PARTITION_ERASE_POLL)(
+  IN  NVIDIA_FW_PARTITION_PROTOCOL      *This
+  );
+
 /**
   Get partition attributes.
 
@@ -94,6 +158,9 @@ struct _NVIDIA_FW_PARTITION_PROTOCOL {
   FW_PARTITION_GET_ATTRIBUTES    GetAttributes;
   FW_PARTITION_READ              Read;
   FW_PARTITION_WRITE             Write;
+  FW_PARTITION_FLUSH             Flush;
+  FW_PARTITION_ERASE_ASYNC       EraseAsync;
+  FW_PARTITION_ERASE_POLL        ErasePoll;
 };
 
 extern EFI_GUID  gNVIDIAFwPartitionProtocolGuid;
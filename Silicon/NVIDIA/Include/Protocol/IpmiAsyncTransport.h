@@ -0,0 +1,85 @@
+/** @file
+  IPMI Async Transport Protocol
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __IPMI_ASYNC_TRANSPORT_PROTOCOL_H__
+#define __IPMI_ASYNC_TRANSPORT_PROTOCOL_H__
+
+#include <Uefi/UefiSpec.h>
+
+#define NVIDIA_IPMI_ASYNC_TRANSPORT_PROTOCOL_GUID \
+  { \
+  0x4b399fec, 0x9b4f, 0x49a5, { 0x89, 0xf9, 0x3d, 0xf3, 0x42, 0x92, 0x32, 0x3a } \
+  }
+
+//
+// Define for forward reference.
+//
+typedef struct _NVIDIA_IPMI_ASYNC_TRANSPORT_PROTOCOL NVIDIA_IPMI_ASYNC_TRANSPORT_PROTOCOL;
+
+typedef struct {
+  ///
+  /// Event that will be signaled when the IPMI command is completed.
+  ///
+  EFI_EVENT     Event;
+
+  ///
+  /// Defines whether or not the signaled event encountered an error.
+  ///
+  EFI_STATUS    TransactionStatus;
+} NVIDIA_IPMI_ASYNC_TOKEN;
+
+/**
+  This function submits an IPMI command to the BMC.
+
+  Commands are queued and sent to the BMC in order, so a caller may submit
+  several commands and wait for their tokens instead of waiting for each
+  response before sending the next command. Must be called at TPL_CALLBACK
+  or lower.
+
+  @param[in]      This              The instance of the NVIDIA_IPMI_ASYNC_TRANSPORT_PROTOCOL.
+  @param[in, out] Token             Optional pointer to a token structure, if this is NULL
+                                    this API will process the command in a blocking manner.
+  @param[in]      NetFunction       Net function of the command.
+  @param[in]      Lun               Logical unit of the command.
+  @param[in]      Command           IPMI command.
+  @param[in]      RequestData       Command request data, must stay valid until completion.
+  @param[in]      RequestDataSize   Size of RequestData.
+  @param[out]     ResponseData      Command response data, must stay valid until completion.
+                                    The completion code is the first byte of response data.
+  @param[in, out] ResponseDataSize  Size of ResponseData, updated on completion.
+
+  @return EFI_SUCCESS               If Token is not NULL the command has been queued.
+  @return EFI_SUCCESS               If Token is NULL the command has been completed.
+  @return EFI_INVALID_PARAMETER     Token is not NULL but Token->Event is NULL
+  @return EFI_BAD_BUFFER_SIZE       Request is larger than the BMC supports
+  @return EFI_OUT_OF_RESOURCES      Failed to allocate the request
+  @return EFI_DEVICE_ERROR          Failed to send the command
+**/
+typedef
+EFI_STATUS
+(EFIAPI *IPMI_ASYNC_SUBMIT_COMMAND)(
+  IN     NVIDIA_IPMI_ASYNC_TRANSPORT_PROTOCOL  *This,
+  IN OUT NVIDIA_IPMI_ASYNC_TOKEN               *Token, OPTIONAL
+  IN     UINT8                                 NetFunction,
+  IN     UINT8                                 Lun,
+  IN     UINT8                                 Command,
+  IN     UINT8                                 *RequestData,
+  IN     UINT32                                RequestDataSize,
+  OUT    UINT8                                 *ResponseData,
+  IN OUT UINT32                                *ResponseDataSize
+  );
+
+/// NVIDIA_IPMI_ASYNC_TRANSPORT_PROTOCOL protocol structure.
+struct _NVIDIA_IPMI_ASYNC_TRANSPORT_PROTOCOL {
+  IPMI_ASYNC_SUBMIT_COMMAND    SubmitCommand;
+};
+
+extern EFI_GUID  gNVIDIAIpmiAsyncTransportProtocolGuid;
+
+#endif
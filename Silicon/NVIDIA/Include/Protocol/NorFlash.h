@@ -100,6 +100,66 @@ EFI_STATUS
   IN UINT32                    NumLba
   );
 
+/**
+  Callback for the completion of an erase started by EraseAsync.
+
+  @param[in] Context               Context passed to EraseAsync
+  @param[in] Status                Status of the erase
+
+**/
+typedef
+VOID
+(EFIAPI *NOR_FLASH_ERASE_COMPLETE)(
+  IN VOID       *Context,
+  IN EFI_STATUS Status
+  );
+
+/**
+  Start erasing data from NOR Flash without waiting for it to complete.
+
+  Only one erase can be pending at a time. The erase progresses each time the
+  instance is called. Reads outside the erased range suspend the erase if the
+  flash supports it, all other accesses wait for the erase to complete first.
+
+  @param[in] This                  Instance to protocol
+  @param[in] Lba                   Logical block to start erasing from
+  @param[in] NumLba                Number of block to be erased
+  @param[in] Callback              Optional function called on completion
+  @param[in] Context               Context passed to Callback
+
+  @retval EFI_SUCCESS              Erase started.
+  @retval EFI_ALREADY_STARTED      Another erase is pending.
+  @retval others                   Error occurred
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *NOR_FLASH_ERASE_ASYNC)(
+  IN NVIDIA_NOR_FLASH_PROTOCOL *This,
+  IN UINT32                    Lba,
+  IN UINT32                    NumLba,
+  IN NOR_FLASH_ERASE_COMPLETE  Callback OPTIONAL,
+  IN VOID                      *Context OPTIONAL
+  );
+
+/**
+  Progress an erase started by EraseAsync.
+
+  @param[in] This                  Instance to protocol
+  @param[in] Wait                  Wait for the erase to complete
+
+  @retval EFI_SUCCESS              No erase pending.
+  @retval EFI_NOT_READY            Erase still in progress.
+  @retval others                   Erase failed
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *NOR_FLASH_ERASE_POLL)(
+  IN NVIDIA_NOR_FLASH_PROTOCOL *This,
+  IN BOOLEAN                   Wait
+  );
+
 /// NVIDIA_NOR_FLASH_PROTOCOL protocol structure.
 /// Note: The Quick functions run with a TIMEOUT of 0, rather than 100
 struct _NVIDIA_NOR_FLASH_PROTOCOL {
@@ -111,6 +171,9 @@ struct _NVIDIA_NOR_FLASH_PROTOCOL {
   NOR_FLASH_READ              QuickRead;
   NOR_FLASH_WRITE             QuickWrite;
   NOR_FLASH_ERASE             QuickErase;
+  /// Optional, NULL if asynchronous erase is not supported
+  NOR_FLASH_ERASE_ASYNC       EraseAsync;
+  NOR_FLASH_ERASE_POLL        ErasePoll;
 };
 
 extern EFI_GUID  gNVIDIANorFlashProtocolGuid;
@@ -28,6 +28,7 @@ typedef struct _NVIDIA_QSPI_CONTROLLER_PROTOCOL NVIDIA_QSPI_CONTROLLER_PROTOCOL;
 typedef enum QspiDevFeature {
   QspiDevFeatUnknown,     ///< 0 - Unknown feature
   QspiDevFeatWaitState,   ///< 1 - Wait state
+  QspiDevFeatMultiLane,   ///< 2 - Dual and quad lane transfers
   QspiDevFeatMax
 } QSPI_DEV_FEATURE;
 
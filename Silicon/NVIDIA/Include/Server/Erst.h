@@ -52,6 +52,10 @@ typedef enum {
   ERST_OPERATION_READ        = 2,
   ERST_OPERATION_CLEAR       = 3,
   ERST_OPERATION_DUMMY_WRITE = 4,
+
+  /* Vendor extensions, not used by the ACPI ERST actions */
+  ERST_OPERATION_READ_BATCH  = 0x80,
+  ERST_OPERATION_CLEAR_BATCH = 0x81,
 } ERST_OPERATION_TYPE;
 
 typedef struct {
@@ -85,6 +89,19 @@ typedef struct {
 } ERST_COMM_STRUCT;
 STATIC_ASSERT ((sizeof (ERST_COMM_STRUCT) == 8*8), "Expected ERST_COMM_STRUCT to be 64 bytes");
 
+/* Batch operations process the records starting at RecordID (0 for the first
+ * record) in the order they are returned by reads. The batch header is at
+ * RecordOffset in the error log address range, and a batch read places the
+ * records back to back right after it. On completion RecordID is the next
+ * record to process, or ERST_INVALID_RECORD_ID when there are no more records.
+ */
+typedef struct {
+  UINT32    Count;        // In: max records to process, 0 for no limit. Out: records processed
+  UINT32    Length;       // Out: bytes of records read after the header
+  UINT64    LastRecordID; // In: stop after this record, ERST_INVALID_RECORD_ID for no limit
+} ERST_BATCH_HEADER;
+STATIC_ASSERT ((sizeof (ERST_BATCH_HEADER) == 2*8), "Expected ERST_BATCH_HEADER to be 16 bytes");
+
 /* Per ACPI spec: "QWORD:
  * [63:32] value in microseconds that the platform expects would be the maximum amount of time it will take to process and complete an EXECUTE_OPERATION.
  * [31:0] value in microseconds that the platform expects would be the nominal amount of time it will take to process and complete an EXECUTE_OPERATION."
@@ -203,6 +203,19 @@ BrBctWriteSlot (
       Slot,
       Status
       ));
+    return Status;
+  }
+
+  // each slot must be on the media before the next one is touched
+  Status = Protocol->Flush (Protocol);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: Error flushing slot=%u: %r\n",
+      __FUNCTION__,
+      Slot,
+      Status
+      ));
   }
 
   return Status;
@@ -11,50 +11,428 @@
 #include <Library/Crc8Lib.h>
 #include <Library/BaseLib.h>
 
-STATIC CONST UINT8  CRC8MaximTable[256] = {
-  0x00, 0x5e, 0xbc, 0xe2, 0x61, 0x3f, 0xdd, 0x83, 0xc2, 0x9c, 0x7e, 0x20, 0xa3, 0xfd, 0x1f, 0x41,
-  0x9d, 0xc3, 0x21, 0x7f, 0xfc, 0xa2, 0x40, 0x1e, 0x5f, 0x01, 0xe3, 0xbd, 0x3e, 0x60, 0x82, 0xdc,
-  0x23, 0x7d, 0x9f, 0xc1, 0x42, 0x1c, 0xfe, 0xa0, 0xe1, 0xbf, 0x5d, 0x03, 0x80, 0xde, 0x3c, 0x62,
-  0xbe, 0xe0, 0x02, 0x5c, 0xdf, 0x81, 0x63, 0x3d, 0x7c, 0x22, 0xc0, 0x9e, 0x1d, 0x43, 0xa1, 0xff,
-  0x46, 0x18, 0xfa, 0xa4, 0x27, 0x79, 0x9b, 0xc5, 0x84, 0xda, 0x38, 0x66, 0xe5, 0xbb, 0x59, 0x07,
-  0xdb, 0x85, 0x67, 0x39, 0xba, 0xe4, 0x06, 0x58, 0x19, 0x47, 0xa5, 0xfb, 0x78, 0x26, 0xc4, 0x9a,
-  0x65, 0x3b, 0xd9, 0x87, 0x04, 0x5a, 0xb8, 0xe6, 0xa7, 0xf9, 0x1b, 0x45, 0xc6, 0x98, 0x7a, 0x24,
-  0xf8, 0xa6, 0x44, 0x1a, 0x99, 0xc7, 0x25, 0x7b, 0x3a, 0x64, 0x86, 0xd8, 0x5b, 0x05, 0xe7, 0xb9,
-  0x8c, 0xd2, 0x30, 0x6e, 0xed, 0xb3, 0x51, 0x0f, 0x4e, 0x10, 0xf2, 0xac, 0x2f, 0x71, 0x93, 0xcd,
-  0x11, 0x4f, 0xad, 0xf3, 0x70, 0x2e, 0xcc, 0x92, 0xd3, 0x8d, 0x6f, 0x31, 0xb2, 0xec, 0x0e, 0x50,
-  0xaf, 0xf1, 0x13, 0x4d, 0xce, 0x90, 0x72, 0x2c, 0x6d, 0x33, 0xd1, 0x8f, 0x0c, 0x52, 0xb0, 0xee,
-  0x32, 0x6c, 0x8e, 0xd0, 0x53, 0x0d, 0xef, 0xb1, 0xf0, 0xae, 0x4c, 0x12, 0x91, 0xcf, 0x2d, 0x73,
-  0xca, 0x94, 0x76, 0x28, 0xab, 0xf5, 0x17, 0x49, 0x08, 0x56, 0xb4, 0xea, 0x69, 0x37, 0xd5, 0x8b,
-  0x57, 0x09, 0xeb, 0xb5, 0x36, 0x68, 0x8a, 0xd4, 0x95, 0xcb, 0x29, 0x77, 0xf4, 0xaa, 0x48, 0x16,
-  0xe9, 0xb7, 0x55, 0x0b, 0x88, 0xd6, 0x34, 0x6a, 0x2b, 0x75, 0x97, 0xc9, 0x4a, 0x14, 0xf6, 0xa8,
-  0x74, 0x2a, 0xc8, 0x96, 0x15, 0x4b, 0xa9, 0xf7, 0xb6, 0xe8, 0x0a, 0x54, 0xd7, 0x89, 0x6b, 0x35
+//
+// Slice-by-8 tables: entry [k][x] is the CRC-8 of byte x followed by k zero
+// bytes, so eight bytes can be folded into the CRC with eight independent
+// lookups. Row 0 is the usual byte-at-a-time table.
+//
+#define CRC8_SLICES  8
+
+// x^8 + x^2 + x^1 + 1
+STATIC CONST UINT8  mCrc8Tables[CRC8_SLICES][256] = {
+  {
+    0x00, 0x07, 0x0e, 0x09, 0x1c, 0x1b, 0x12, 0x15, 0x38, 0x3f, 0x36, 0x31, 0x24, 0x23, 0x2a, 0x2d,
+    0x70, 0x77, 0x7e, 0x79, 0x6c, 0x6b, 0x62, 0x65, 0x48, 0x4f, 0x46, 0x41, 0x54, 0x53, 0x5a, 0x5d,
+    0xe0, 0xe7, 0xee, 0xe9, 0xfc, 0xfb, 0xf2, 0xf5, 0xd8, 0xdf, 0xd6, 0xd1, 0xc4, 0xc3, 0xca, 0xcd,
+    0x90, 0x97, 0x9e, 0x99, 0x8c, 0x8b, 0x82, 0x85, 0xa8, 0xaf, 0xa6, 0xa1, 0xb4, 0xb3, 0xba, 0xbd,
+    0xc7, 0xc0, 0xc9, 0xce, 0xdb, 0xdc, 0xd5, 0xd2, 0xff, 0xf8, 0xf1, 0xf6, 0xe3, 0xe4, 0xed, 0xea,
+    0xb7, 0xb0, 0xb9, 0xbe, 0xab, 0xac, 0xa5, 0xa2, 0x8f, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9d, 0x9a,
+    0x27, 0x20, 0x29, 0x2e, 0x3b, 0x3c, 0x35, 0x32, 0x1f, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0d, 0x0a,
+    0x57, 0x50, 0x59, 0x5e, 0x4b, 0x4c, 0x45, 0x42, 0x6f, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7d, 0x7a,
+    0x89, 0x8e, 0x87, 0x80, 0x95, 0x92, 0x9b, 0x9c, 0xb1, 0xb6, 0xbf, 0xb8, 0xad, 0xaa, 0xa3, 0xa4,
+    0xf9, 0xfe, 0xf7, 0xf0, 0xe5, 0xe2, 0xeb, 0xec, 0xc1, 0xc6, 0xcf, 0xc8, 0xdd, 0xda, 0xd3, 0xd4,
+    0x69, 0x6e, 0x67, 0x60, 0x75, 0x72, 0x7b, 0x7c, 0x51, 0x56, 0x5f, 0x58, 0x4d, 0x4a, 0x43, 0x44,
+    0x19, 0x1e, 0x17, 0x10, 0x05, 0x02, 0x0b, 0x0c, 0x21, 0x26, 0x2f, 0x28, 0x3d, 0x3a, 0x33, 0x34,
+    0x4e, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5c, 0x5b, 0x76, 0x71, 0x78, 0x7f, 0x6a, 0x6d, 0x64, 0x63,
+    0x3e, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2c, 0x2b, 0x06, 0x01, 0x08, 0x0f, 0x1a, 0x1d, 0x14, 0x13,
+    0xae, 0xa9, 0xa0, 0xa7, 0xb2, 0xb5, 0xbc, 0xbb, 0x96, 0x91, 0x98, 0x9f, 0x8a, 0x8d, 0x84, 0x83,
+    0xde, 0xd9, 0xd0, 0xd7, 0xc2, 0xc5, 0xcc, 0xcb, 0xe6, 0xe1, 0xe8, 0xef, 0xfa, 0xfd, 0xf4, 0xf3
+  },
+  {
+    0x00, 0x15, 0x2a, 0x3f, 0x54, 0x41, 0x7e, 0x6b, 0xa8, 0xbd, 0x82, 0x97, 0xfc, 0xe9, 0xd6, 0xc3,
+    0x57, 0x42, 0x7d, 0x68, 0x03, 0x16, 0x29, 0x3c, 0xff, 0xea, 0xd5, 0xc0, 0xab, 0xbe, 0x81, 0x94,
+    0xae, 0xbb, 0x84, 0x91, 0xfa, 0xef, 0xd0, 0xc5, 0x06, 0x13, 0x2c, 0x39, 0x52, 0x47, 0x78, 0x6d,
+    0xf9, 0xec, 0xd3, 0xc6, 0xad, 0xb8, 0x87, 0x92, 0x51, 0x44, 0x7b, 0x6e, 0x05, 0x10, 0x2f, 0x3a,
+    0x5b, 0x4e, 0x71, 0x64, 0x0f, 0x1a, 0x25, 0x30, 0xf3, 0xe6, 0xd9, 0xcc, 0xa7, 0xb2, 0x8d, 0x98,
+    0x0c, 0x19, 0x26, 0x33, 0x58, 0x4d, 0x72, 0x67, 0xa4, 0xb1, 0x8e, 0x9b, 0xf0, 0xe5, 0xda, 0xcf,
+    0xf5, 0xe0, 0xdf, 0xca, 0xa1, 0xb4, 0x8b, 0x9e, 0x5d, 0x48, 0x77, 0x62, 0x09, 0x1c, 0x23, 0x36,
+    0xa2, 0xb7, 0x88, 0x9d, 0xf6, 0xe3, 0xdc, 0xc9, 0x0a, 0x1f, 0x20, 0x35, 0x5e, 0x4b, 0x74, 0x61,
+    0xb6, 0xa3, 0x9c, 0x89, 0xe2, 0xf7, 0xc8, 0xdd, 0x1e, 0x0b, 0x34, 0x21, 0x4a, 0x5f, 0x60, 0x75,
+    0xe1, 0xf4, 0xcb, 0xde, 0xb5, 0xa0, 0x9f, 0x8a, 0x49, 0x5c, 0x63, 0x76, 0x1d, 0x08, 0x37, 0x22,
+    0x18, 0x0d, 0x32, 0x27, 0x4c, 0x59, 0x66, 0x73, 0xb0, 0xa5, 0x9a, 0x8f, 0xe4, 0xf1, 0xce, 0xdb,
+    0x4f, 0x5a, 0x65, 0x70, 0x1b, 0x0e, 0x31, 0x24, 0xe7, 0xf2, 0xcd, 0xd8, 0xb3, 0xa6, 0x99, 0x8c,
+    0xed, 0xf8, 0xc7, 0xd2, 0xb9, 0xac, 0x93, 0x86, 0x45, 0x50, 0x6f, 0x7a, 0x11, 0x04, 0x3b, 0x2e,
+    0xba, 0xaf, 0x90, 0x85, 0xee, 0xfb, 0xc4, 0xd1, 0x12, 0x07, 0x38, 0x2d, 0x46, 0x53, 0x6c, 0x79,
+    0x43, 0x56, 0x69, 0x7c, 0x17, 0x02, 0x3d, 0x28, 0xeb, 0xfe, 0xc1, 0xd4, 0xbf, 0xaa, 0x95, 0x80,
+    0x14, 0x01, 0x3e, 0x2b, 0x40, 0x55, 0x6a, 0x7f, 0xbc, 0xa9, 0x96, 0x83, 0xe8, 0xfd, 0xc2, 0xd7
+  },
+  {
+    0x00, 0x6b, 0xd6, 0xbd, 0xab, 0xc0, 0x7d, 0x16, 0x51, 0x3a, 0x87, 0xec, 0xfa, 0x91, 0x2c, 0x47,
+    0xa2, 0xc9, 0x74, 0x1f, 0x09, 0x62, 0xdf, 0xb4, 0xf3, 0x98, 0x25, 0x4e, 0x58, 0x33, 0x8e, 0xe5,
+    0x43, 0x28, 0x95, 0xfe, 0xe8, 0x83, 0x3e, 0x55, 0x12, 0x79, 0xc4, 0xaf, 0xb9, 0xd2, 0x6f, 0x04,
+    0xe1, 0x8a, 0x37, 0x5c, 0x4a, 0x21, 0x9c, 0xf7, 0xb0, 0xdb, 0x66, 0x0d, 0x1b, 0x70, 0xcd, 0xa6,
+    0x86, 0xed, 0x50, 0x3b, 0x2d, 0x46, 0xfb, 0x90, 0xd7, 0xbc, 0x01, 0x6a, 0x7c, 0x17, 0xaa, 0xc1,
+    0x24, 0x4f, 0xf2, 0x99, 0x8f, 0xe4, 0x59, 0x32, 0x75, 0x1e, 0xa3, 0xc8, 0xde, 0xb5, 0x08, 0x63,
+    0xc5, 0xae, 0x13, 0x78, 0x6e, 0x05, 0xb8, 0xd3, 0x94, 0xff, 0x42, 0x29, 0x3f, 0x54, 0xe9, 0x82,
+    0x67, 0x0c, 0xb1, 0xda, 0xcc, 0xa7, 0x1a, 0x71, 0x36, 0x5d, 0xe0, 0x8b, 0x9d, 0xf6, 0x4b, 0x20,
+    0x0b, 0x60, 0xdd, 0xb6, 0xa0, 0xcb, 0x76, 0x1d, 0x5a, 0x31, 0x8c, 0xe7, 0xf1, 0x9a, 0x27, 0x4c,
+    0xa9, 0xc2, 0x7f, 0x14, 0x02, 0x69, 0xd4, 0xbf, 0xf8, 0x93, 0x2e, 0x45, 0x53, 0x38, 0x85, 0xee,
+    0x48, 0x23, 0x9e, 0xf5, 0xe3, 0x88, 0x35, 0x5e, 0x19, 0x72, 0xcf, 0xa4, 0xb2, 0xd9, 0x64, 0x0f,
+    0xea, 0x81, 0x3c, 0x57, 0x41, 0x2a, 0x97, 0xfc, 0xbb, 0xd0, 0x6d, 0x06, 0x10, 0x7b, 0xc6, 0xad,
+    0x8d, 0xe6, 0x5b, 0x30, 0x26, 0x4d, 0xf0, 0x9b, 0xdc, 0xb7, 0x0a, 0x61, 0x77, 0x1c, 0xa1, 0xca,
+    0x2f, 0x44, 0xf9, 0x92, 0x84, 0xef, 0x52, 0x39, 0x7e, 0x15, 0xa8, 0xc3, 0xd5, 0xbe, 0x03, 0x68,
+    0xce, 0xa5, 0x18, 0x73, 0x65, 0x0e, 0xb3, 0xd8, 0x9f, 0xf4, 0x49, 0x22, 0x34, 0x5f, 0xe2, 0x89,
+    0x6c, 0x07, 0xba, 0xd1, 0xc7, 0xac, 0x11, 0x7a, 0x3d, 0x56, 0xeb, 0x80, 0x96, 0xfd, 0x40, 0x2b
+  },
+  {
+    0x00, 0x16, 0x2c, 0x3a, 0x58, 0x4e, 0x74, 0x62, 0xb0, 0xa6, 0x9c, 0x8a, 0xe8, 0xfe, 0xc4, 0xd2,
+    0x67, 0x71, 0x4b, 0x5d, 0x3f, 0x29, 0x13, 0x05, 0xd7, 0xc1, 0xfb, 0xed, 0x8f, 0x99, 0xa3, 0xb5,
+    0xce, 0xd8, 0xe2, 0xf4, 0x96, 0x80, 0xba, 0xac, 0x7e, 0x68, 0x52, 0x44, 0x26, 0x30, 0x0a, 0x1c,
+    0xa9, 0xbf, 0x85, 0x93, 0xf1, 0xe7, 0xdd, 0xcb, 0x19, 0x0f, 0x35, 0x23, 0x41, 0x57, 0x6d, 0x7b,
+    0x9b, 0x8d, 0xb7, 0xa1, 0xc3, 0xd5, 0xef, 0xf9, 0x2b, 0x3d, 0x07, 0x11, 0x73, 0x65, 0x5f, 0x49,
+    0xfc, 0xea, 0xd0, 0xc6, 0xa4, 0xb2, 0x88, 0x9e, 0x4c, 0x5a, 0x60, 0x76, 0x14, 0x02, 0x38, 0x2e,
+    0x55, 0x43, 0x79, 0x6f, 0x0d, 0x1b, 0x21, 0x37, 0xe5, 0xf3, 0xc9, 0xdf, 0xbd, 0xab, 0x91, 0x87,
+    0x32, 0x24, 0x1e, 0x08, 0x6a, 0x7c, 0x46, 0x50, 0x82, 0x94, 0xae, 0xb8, 0xda, 0xcc, 0xf6, 0xe0,
+    0x31, 0x27, 0x1d, 0x0b, 0x69, 0x7f, 0x45, 0x53, 0x81, 0x97, 0xad, 0xbb, 0xd9, 0xcf, 0xf5, 0xe3,
+    0x56, 0x40, 0x7a, 0x6c, 0x0e, 0x18, 0x22, 0x34, 0xe6, 0xf0, 0xca, 0xdc, 0xbe, 0xa8, 0x92, 0x84,
+    0xff, 0xe9, 0xd3, 0xc5, 0xa7, 0xb1, 0x8b, 0x9d, 0x4f, 0x59, 0x63, 0x75, 0x17, 0x01, 0x3b, 0x2d,
+    0x98, 0x8e, 0xb4, 0xa2, 0xc0, 0xd6, 0xec, 0xfa, 0x28, 0x3e, 0x04, 0x12, 0x70, 0x66, 0x5c, 0x4a,
+    0xaa, 0xbc, 0x86, 0x90, 0xf2, 0xe4, 0xde, 0xc8, 0x1a, 0x0c, 0x36, 0x20, 0x42, 0x54, 0x6e, 0x78,
+    0xcd, 0xdb, 0xe1, 0xf7, 0x95, 0x83, 0xb9, 0xaf, 0x7d, 0x6b, 0x51, 0x47, 0x25, 0x33, 0x09, 0x1f,
+    0x64, 0x72, 0x48, 0x5e, 0x3c, 0x2a, 0x10, 0x06, 0xd4, 0xc2, 0xf8, 0xee, 0x8c, 0x9a, 0xa0, 0xb6,
+    0x03, 0x15, 0x2f, 0x39, 0x5b, 0x4d, 0x77, 0x61, 0xb3, 0xa5, 0x9f, 0x89, 0xeb, 0xfd, 0xc7, 0xd1
+  },
+  {
+    0x00, 0x62, 0xc4, 0xa6, 0x8f, 0xed, 0x4b, 0x29, 0x19, 0x7b, 0xdd, 0xbf, 0x96, 0xf4, 0x52, 0x30,
+    0x32, 0x50, 0xf6, 0x94, 0xbd, 0xdf, 0x79, 0x1b, 0x2b, 0x49, 0xef, 0x8d, 0xa4, 0xc6, 0x60, 0x02,
+    0x64, 0x06, 0xa0, 0xc2, 0xeb, 0x89, 0x2f, 0x4d, 0x7d, 0x1f, 0xb9, 0xdb, 0xf2, 0x90, 0x36, 0x54,
+    0x56, 0x34, 0x92, 0xf0, 0xd9, 0xbb, 0x1d, 0x7f, 0x4f, 0x2d, 0x8b, 0xe9, 0xc0, 0xa2, 0x04, 0x66,
+    0xc8, 0xaa, 0x0c, 0x6e, 0x47, 0x25, 0x83, 0xe1, 0xd1, 0xb3, 0x15, 0x77, 0x5e, 0x3c, 0x9a, 0xf8,
+    0xfa, 0x98, 0x3e, 0x5c, 0x75, 0x17, 0xb1, 0xd3, 0xe3, 0x81, 0x27, 0x45, 0x6c, 0x0e, 0xa8, 0xca,
+    0xac, 0xce, 0x68, 0x0a, 0x23, 0x41, 0xe7, 0x85, 0xb5, 0xd7, 0x71, 0x13, 0x3a, 0x58, 0xfe, 0x9c,
+    0x9e, 0xfc, 0x5a, 0x38, 0x11, 0x73, 0xd5, 0xb7, 0x87, 0xe5, 0x43, 0x21, 0x08, 0x6a, 0xcc, 0xae,
+    0x97, 0xf5, 0x53, 0x31, 0x18, 0x7a, 0xdc, 0xbe, 0x8e, 0xec, 0x4a, 0x28, 0x01, 0x63, 0xc5, 0xa7,
+    0xa5, 0xc7, 0x61, 0x03, 0x2a, 0x48, 0xee, 0x8c, 0xbc, 0xde, 0x78, 0x1a, 0x33, 0x51, 0xf7, 0x95,
+    0xf3, 0x91, 0x37, 0x55, 0x7c, 0x1e, 0xb8, 0xda, 0xea, 0x88, 0x2e, 0x4c, 0x65, 0x07, 0xa1, 0xc3,
+    0xc1, 0xa3, 0x05, 0x67, 0x4e, 0x2c, 0x8a, 0xe8, 0xd8, 0xba, 0x1c, 0x7e, 0x57, 0x35, 0x93, 0xf1,
+    0x5f, 0x3d, 0x9b, 0xf9, 0xd0, 0xb2, 0x14, 0x76, 0x46, 0x24, 0x82, 0xe0, 0xc9, 0xab, 0x0d, 0x6f,
+    0x6d, 0x0f, 0xa9, 0xcb, 0xe2, 0x80, 0x26, 0x44, 0x74, 0x16, 0xb0, 0xd2, 0xfb, 0x99, 0x3f, 0x5d,
+    0x3b, 0x59, 0xff, 0x9d, 0xb4, 0xd6, 0x70, 0x12, 0x22, 0x40, 0xe6, 0x84, 0xad, 0xcf, 0x69, 0x0b,
+    0x09, 0x6b, 0xcd, 0xaf, 0x86, 0xe4, 0x42, 0x20, 0x10, 0x72, 0xd4, 0xb6, 0x9f, 0xfd, 0x5b, 0x39
+  },
+  {
+    0x00, 0x29, 0x52, 0x7b, 0xa4, 0x8d, 0xf6, 0xdf, 0x4f, 0x66, 0x1d, 0x34, 0xeb, 0xc2, 0xb9, 0x90,
+    0x9e, 0xb7, 0xcc, 0xe5, 0x3a, 0x13, 0x68, 0x41, 0xd1, 0xf8, 0x83, 0xaa, 0x75, 0x5c, 0x27, 0x0e,
+    0x3b, 0x12, 0x69, 0x40, 0x9f, 0xb6, 0xcd, 0xe4, 0x74, 0x5d, 0x26, 0x0f, 0xd0, 0xf9, 0x82, 0xab,
+    0xa5, 0x8c, 0xf7, 0xde, 0x01, 0x28, 0x53, 0x7a, 0xea, 0xc3, 0xb8, 0x91, 0x4e, 0x67, 0x1c, 0x35,
+    0x76, 0x5f, 0x24, 0x0d, 0xd2, 0xfb, 0x80, 0xa9, 0x39, 0x10, 0x6b, 0x42, 0x9d, 0xb4, 0xcf, 0xe6,
+    0xe8, 0xc1, 0xba, 0x93, 0x4c, 0x65, 0x1e, 0x37, 0xa7, 0x8e, 0xf5, 0xdc, 0x03, 0x2a, 0x51, 0x78,
+    0x4d, 0x64, 0x1f, 0x36, 0xe9, 0xc0, 0xbb, 0x92, 0x02, 0x2b, 0x50, 0x79, 0xa6, 0x8f, 0xf4, 0xdd,
+    0xd3, 0xfa, 0x81, 0xa8, 0x77, 0x5e, 0x25, 0x0c, 0x9c, 0xb5, 0xce, 0xe7, 0x38, 0x11, 0x6a, 0x43,
+    0xec, 0xc5, 0xbe, 0x97, 0x48, 0x61, 0x1a, 0x33, 0xa3, 0x8a, 0xf1, 0xd8, 0x07, 0x2e, 0x55, 0x7c,
+    0x72, 0x5b, 0x20, 0x09, 0xd6, 0xff, 0x84, 0xad, 0x3d, 0x14, 0x6f, 0x46, 0x99, 0xb0, 0xcb, 0xe2,
+    0xd7, 0xfe, 0x85, 0xac, 0x73, 0x5a, 0x21, 0x08, 0x98, 0xb1, 0xca, 0xe3, 0x3c, 0x15, 0x6e, 0x47,
+    0x49, 0x60, 0x1b, 0x32, 0xed, 0xc4, 0xbf, 0x96, 0x06, 0x2f, 0x54, 0x7d, 0xa2, 0x8b, 0xf0, 0xd9,
+    0x9a, 0xb3, 0xc8, 0xe1, 0x3e, 0x17, 0x6c, 0x45, 0xd5, 0xfc, 0x87, 0xae, 0x71, 0x58, 0x23, 0x0a,
+    0x04, 0x2d, 0x56, 0x7f, 0xa0, 0x89, 0xf2, 0xdb, 0x4b, 0x62, 0x19, 0x30, 0xef, 0xc6, 0xbd, 0x94,
+    0xa1, 0x88, 0xf3, 0xda, 0x05, 0x2c, 0x57, 0x7e, 0xee, 0xc7, 0xbc, 0x95, 0x4a, 0x63, 0x18, 0x31,
+    0x3f, 0x16, 0x6d, 0x44, 0x9b, 0xb2, 0xc9, 0xe0, 0x70, 0x59, 0x22, 0x0b, 0xd4, 0xfd, 0x86, 0xaf
+  },
+  {
+    0x00, 0xdf, 0xb9, 0x66, 0x75, 0xaa, 0xcc, 0x13, 0xea, 0x35, 0x53, 0x8c, 0x9f, 0x40, 0x26, 0xf9,
+    0xd3, 0x0c, 0x6a, 0xb5, 0xa6, 0x79, 0x1f, 0xc0, 0x39, 0xe6, 0x80, 0x5f, 0x4c, 0x93, 0xf5, 0x2a,
+    0xa1, 0x7e, 0x18, 0xc7, 0xd4, 0x0b, 0x6d, 0xb2, 0x4b, 0x94, 0xf2, 0x2d, 0x3e, 0xe1, 0x87, 0x58,
+    0x72, 0xad, 0xcb, 0x14, 0x07, 0xd8, 0xbe, 0x61, 0x98, 0x47, 0x21, 0xfe, 0xed, 0x32, 0x54, 0x8b,
+    0x45, 0x9a, 0xfc, 0x23, 0x30, 0xef, 0x89, 0x56, 0xaf, 0x70, 0x16, 0xc9, 0xda, 0x05, 0x63, 0xbc,
+    0x96, 0x49, 0x2f, 0xf0, 0xe3, 0x3c, 0x5a, 0x85, 0x7c, 0xa3, 0xc5, 0x1a, 0x09, 0xd6, 0xb0, 0x6f,
+    0xe4, 0x3b, 0x5d, 0x82, 0x91, 0x4e, 0x28, 0xf7, 0x0e, 0xd1, 0xb7, 0x68, 0x7b, 0xa4, 0xc2, 0x1d,
+    0x37, 0xe8, 0x8e, 0x51, 0x42, 0x9d, 0xfb, 0x24, 0xdd, 0x02, 0x64, 0xbb, 0xa8, 0x77, 0x11, 0xce,
+    0x8a, 0x55, 0x33, 0xec, 0xff, 0x20, 0x46, 0x99, 0x60, 0xbf, 0xd9, 0x06, 0x15, 0xca, 0xac, 0x73,
+    0x59, 0x86, 0xe0, 0x3f, 0x2c, 0xf3, 0x95, 0x4a, 0xb3, 0x6c, 0x0a, 0xd5, 0xc6, 0x19, 0x7f, 0xa0,
+    0x2b, 0xf4, 0x92, 0x4d, 0x5e, 0x81, 0xe7, 0x38, 0xc1, 0x1e, 0x78, 0xa7, 0xb4, 0x6b, 0x0d, 0xd2,
+    0xf8, 0x27, 0x41, 0x9e, 0x8d, 0x52, 0x34, 0xeb, 0x12, 0xcd, 0xab, 0x74, 0x67, 0xb8, 0xde, 0x01,
+    0xcf, 0x10, 0x76, 0xa9, 0xba, 0x65, 0x03, 0xdc, 0x25, 0xfa, 0x9c, 0x43, 0x50, 0x8f, 0xe9, 0x36,
+    0x1c, 0xc3, 0xa5, 0x7a, 0x69, 0xb6, 0xd0, 0x0f, 0xf6, 0x29, 0x4f, 0x90, 0x83, 0x5c, 0x3a, 0xe5,
+    0x6e, 0xb1, 0xd7, 0x08, 0x1b, 0xc4, 0xa2, 0x7d, 0x84, 0x5b, 0x3d, 0xe2, 0xf1, 0x2e, 0x48, 0x97,
+    0xbd, 0x62, 0x04, 0xdb, 0xc8, 0x17, 0x71, 0xae, 0x57, 0x88, 0xee, 0x31, 0x22, 0xfd, 0x9b, 0x44
+  },
+  {
+    0x00, 0x13, 0x26, 0x35, 0x4c, 0x5f, 0x6a, 0x79, 0x98, 0x8b, 0xbe, 0xad, 0xd4, 0xc7, 0xf2, 0xe1,
+    0x37, 0x24, 0x11, 0x02, 0x7b, 0x68, 0x5d, 0x4e, 0xaf, 0xbc, 0x89, 0x9a, 0xe3, 0xf0, 0xc5, 0xd6,
+    0x6e, 0x7d, 0x48, 0x5b, 0x22, 0x31, 0x04, 0x17, 0xf6, 0xe5, 0xd0, 0xc3, 0xba, 0xa9, 0x9c, 0x8f,
+    0x59, 0x4a, 0x7f, 0x6c, 0x15, 0x06, 0x33, 0x20, 0xc1, 0xd2, 0xe7, 0xf4, 0x8d, 0x9e, 0xab, 0xb8,
+    0xdc, 0xcf, 0xfa, 0xe9, 0x90, 0x83, 0xb6, 0xa5, 0x44, 0x57, 0x62, 0x71, 0x08, 0x1b, 0x2e, 0x3d,
+    0xeb, 0xf8, 0xcd, 0xde, 0xa7, 0xb4, 0x81, 0x92, 0x73, 0x60, 0x55, 0x46, 0x3f, 0x2c, 0x19, 0x0a,
+    0xb2, 0xa1, 0x94, 0x87, 0xfe, 0xed, 0xd8, 0xcb, 0x2a, 0x39, 0x0c, 0x1f, 0x66, 0x75, 0x40, 0x53,
+    0x85, 0x96, 0xa3, 0xb0, 0xc9, 0xda, 0xef, 0xfc, 0x1d, 0x0e, 0x3b, 0x28, 0x51, 0x42, 0x77, 0x64,
+    0xbf, 0xac, 0x99, 0x8a, 0xf3, 0xe0, 0xd5, 0xc6, 0x27, 0x34, 0x01, 0x12, 0x6b, 0x78, 0x4d, 0x5e,
+    0x88, 0x9b, 0xae, 0xbd, 0xc4, 0xd7, 0xe2, 0xf1, 0x10, 0x03, 0x36, 0x25, 0x5c, 0x4f, 0x7a, 0x69,
+    0xd1, 0xc2, 0xf7, 0xe4, 0x9d, 0x8e, 0xbb, 0xa8, 0x49, 0x5a, 0x6f, 0x7c, 0x05, 0x16, 0x23, 0x30,
+    0xe6, 0xf5, 0xc0, 0xd3, 0xaa, 0xb9, 0x8c, 0x9f, 0x7e, 0x6d, 0x58, 0x4b, 0x32, 0x21, 0x14, 0x07,
+    0x63, 0x70, 0x45, 0x56, 0x2f, 0x3c, 0x09, 0x1a, 0xfb, 0xe8, 0xdd, 0xce, 0xb7, 0xa4, 0x91, 0x82,
+    0x54, 0x47, 0x72, 0x61, 0x18, 0x0b, 0x3e, 0x2d, 0xcc, 0xdf, 0xea, 0xf9, 0x80, 0x93, 0xa6, 0xb5,
+    0x0d, 0x1e, 0x2b, 0x38, 0x41, 0x52, 0x67, 0x74, 0x95, 0x86, 0xb3, 0xa0, 0xd9, 0xca, 0xff, 0xec,
+    0x3a, 0x29, 0x1c, 0x0f, 0x76, 0x65, 0x50, 0x43, 0xa2, 0xb1, 0x84, 0x97, 0xee, 0xfd, 0xc8, 0xdb
+  }
 };
 
-STATIC CONST UINT8  CRC8Table[256] = {
-  0x00, 0x07, 0x0e, 0x09, 0x1c, 0x1b, 0x12, 0x15, 0x38, 0x3f, 0x36, 0x31, 0x24, 0x23, 0x2a, 0x2d,
-  0x70, 0x77, 0x7e, 0x79, 0x6c, 0x6b, 0x62, 0x65, 0x48, 0x4f, 0x46, 0x41, 0x54, 0x53, 0x5a, 0x5d,
-  0xe0, 0xe7, 0xee, 0xe9, 0xfc, 0xfb, 0xf2, 0xf5, 0xd8, 0xdf, 0xd6, 0xd1, 0xc4, 0xc3, 0xca, 0xcd,
-  0x90, 0x97, 0x9e, 0x99, 0x8c, 0x8b, 0x82, 0x85, 0xa8, 0xaf, 0xa6, 0xa1, 0xb4, 0xb3, 0xba, 0xbd,
-  0xc7, 0xc0, 0xc9, 0xce, 0xdb, 0xdc, 0xd5, 0xd2, 0xff, 0xf8, 0xf1, 0xf6, 0xe3, 0xe4, 0xed, 0xea,
-  0xb7, 0xb0, 0xb9, 0xbe, 0xab, 0xac, 0xa5, 0xa2, 0x8f, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9d, 0x9a,
-  0x27, 0x20, 0x29, 0x2e, 0x3b, 0x3c, 0x35, 0x32, 0x1f, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0d, 0x0a,
-  0x57, 0x50, 0x59, 0x5e, 0x4b, 0x4c, 0x45, 0x42, 0x6f, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7d, 0x7a,
-  0x89, 0x8e, 0x87, 0x80, 0x95, 0x92, 0x9b, 0x9c, 0xb1, 0xb6, 0xbf, 0xb8, 0xad, 0xaa, 0xa3, 0xa4,
-  0xf9, 0xfe, 0xf7, 0xf0, 0xe5, 0xe2, 0xeb, 0xec, 0xc1, 0xc6, 0xcf, 0xc8, 0xdd, 0xda, 0xd3, 0xd4,
-  0x69, 0x6e, 0x67, 0x60, 0x75, 0x72, 0x7b, 0x7c, 0x51, 0x56, 0x5f, 0x58, 0x4d, 0x4a, 0x43, 0x44,
-  0x19, 0x1e, 0x17, 0x10, 0x05, 0x02, 0x0b, 0x0c, 0x21, 0x26, 0x2f, 0x28, 0x3d, 0x3a, 0x33, 0x34,
-  0x4e, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5c, 0x5b, 0x76, 0x71, 0x78, 0x7f, 0x6a, 0x6d, 0x64, 0x63,
-  0x3e, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2c, 0x2b, 0x06, 0x01, 0x08, 0x0f, 0x1a, 0x1d, 0x14, 0x13,
-  0xae, 0xa9, 0xa0, 0xa7, 0xb2, 0xb5, 0xbc, 0xbb, 0x96, 0x91, 0x98, 0x9f, 0x8a, 0x8d, 0x84, 0x83,
-  0xde, 0xd9, 0xd0, 0xd7, 0xc2, 0xc5, 0xcc, 0xcb, 0xe6, 0xe1, 0xe8, 0xef, 0xfa, 0xfd, 0xf4, 0xf3
+// x^8 + x^5 + x^4 + 1, reflected
+STATIC CONST UINT8  mCrc8MaximTables[CRC8_SLICES][256] = {
+  {
+    0x00, 0x5e, 0xbc, 0xe2, 0x61, 0x3f, 0xdd, 0x83, 0xc2, 0x9c, 0x7e, 0x20, 0xa3, 0xfd, 0x1f, 0x41,
+    0x9d, 0xc3, 0x21, 0x7f, 0xfc, 0xa2, 0x40, 0x1e, 0x5f, 0x01, 0xe3, 0xbd, 0x3e, 0x60, 0x82, 0xdc,
+    0x23, 0x7d, 0x9f, 0xc1, 0x42, 0x1c, 0xfe, 0xa0, 0xe1, 0xbf, 0x5d, 0x03, 0x80, 0xde, 0x3c, 0x62,
+    0xbe, 0xe0, 0x02, 0x5c, 0xdf, 0x81, 0x63, 0x3d, 0x7c, 0x22, 0xc0, 0x9e, 0x1d, 0x43, 0xa1, 0xff,
+    0x46, 0x18, 0xfa, 0xa4, 0x27, 0x79, 0x9b, 0xc5, 0x84, 0xda, 0x38, 0x66, 0xe5, 0xbb, 0x59, 0x07,
+    0xdb, 0x85, 0x67, 0x39, 0xba, 0xe4, 0x06, 0x58, 0x19, 0x47, 0xa5, 0xfb, 0x78, 0x26, 0xc4, 0x9a,
+    0x65, 0x3b, 0xd9, 0x87, 0x04, 0x5a, 0xb8, 0xe6, 0xa7, 0xf9, 0x1b, 0x45, 0xc6, 0x98, 0x7a, 0x24,
+    0xf8, 0xa6, 0x44, 0x1a, 0x99, 0xc7, 0x25, 0x7b, 0x3a, 0x64, 0x86, 0xd8, 0x5b, 0x05, 0xe7, 0xb9,
+    0x8c, 0xd2, 0x30, 0x6e, 0xed, 0xb3, 0x51, 0x0f, 0x4e, 0x10, 0xf2, 0xac, 0x2f, 0x71, 0x93, 0xcd,
+    0x11, 0x4f, 0xad, 0xf3, 0x70, 0x2e, 0xcc, 0x92, 0xd3, 0x8d, 0x6f, 0x31, 0xb2, 0xec, 0x0e, 0x50,
+    0xaf, 0xf1, 0x13, 0x4d, 0xce, 0x90, 0x72, 0x2c, 0x6d, 0x33, 0xd1, 0x8f, 0x0c, 0x52, 0xb0, 0xee,
+    0x32, 0x6c, 0x8e, 0xd0, 0x53, 0x0d, 0xef, 0xb1, 0xf0, 0xae, 0x4c, 0x12, 0x91, 0xcf, 0x2d, 0x73,
+    0xca, 0x94, 0x76, 0x28, 0xab, 0xf5, 0x17, 0x49, 0x08, 0x56, 0xb4, 0xea, 0x69, 0x37, 0xd5, 0x8b,
+    0x57, 0x09, 0xeb, 0xb5, 0x36, 0x68, 0x8a, 0xd4, 0x95, 0xcb, 0x29, 0x77, 0xf4, 0xaa, 0x48, 0x16,
+    0xe9, 0xb7, 0x55, 0x0b, 0x88, 0xd6, 0x34, 0x6a, 0x2b, 0x75, 0x97, 0xc9, 0x4a, 0x14, 0xf6, 0xa8,
+    0x74, 0x2a, 0xc8, 0x96, 0x15, 0x4b, 0xa9, 0xf7, 0xb6, 0xe8, 0x0a, 0x54, 0xd7, 0x89, 0x6b, 0x35
+  },
+  {
+    0x00, 0xc4, 0x91, 0x55, 0x3b, 0xff, 0xaa, 0x6e, 0x76, 0xb2, 0xe7, 0x23, 0x4d, 0x89, 0xdc, 0x18,
+    0xec, 0x28, 0x7d, 0xb9, 0xd7, 0x13, 0x46, 0x82, 0x9a, 0x5e, 0x0b, 0xcf, 0xa1, 0x65, 0x30, 0xf4,
+    0xc1, 0x05, 0x50, 0x94, 0xfa, 0x3e, 0x6b, 0xaf, 0xb7, 0x73, 0x26, 0xe2, 0x8c, 0x48, 0x1d, 0xd9,
+    0x2d, 0xe9, 0xbc, 0x78, 0x16, 0xd2, 0x87, 0x43, 0x5b, 0x9f, 0xca, 0x0e, 0x60, 0xa4, 0xf1, 0x35,
+    0x9b, 0x5f, 0x0a, 0xce, 0xa0, 0x64, 0x31, 0xf5, 0xed, 0x29, 0x7c, 0xb8, 0xd6, 0x12, 0x47, 0x83,
+    0x77, 0xb3, 0xe6, 0x22, 0x4c, 0x88, 0xdd, 0x19, 0x01, 0xc5, 0x90, 0x54, 0x3a, 0xfe, 0xab, 0x6f,
+    0x5a, 0x9e, 0xcb, 0x0f, 0x61, 0xa5, 0xf0, 0x34, 0x2c, 0xe8, 0xbd, 0x79, 0x17, 0xd3, 0x86, 0x42,
+    0xb6, 0x72, 0x27, 0xe3, 0x8d, 0x49, 0x1c, 0xd8, 0xc0, 0x04, 0x51, 0x95, 0xfb, 0x3f, 0x6a, 0xae,
+    0x2f, 0xeb, 0xbe, 0x7a, 0x14, 0xd0, 0x85, 0x41, 0x59, 0x9d, 0xc8, 0x0c, 0x62, 0xa6, 0xf3, 0x37,
+    0xc3, 0x07, 0x52, 0x96, 0xf8, 0x3c, 0x69, 0xad, 0xb5, 0x71, 0x24, 0xe0, 0x8e, 0x4a, 0x1f, 0xdb,
+    0xee, 0x2a, 0x7f, 0xbb, 0xd5, 0x11, 0x44, 0x80, 0x98, 0x5c, 0x09, 0xcd, 0xa3, 0x67, 0x32, 0xf6,
+    0x02, 0xc6, 0x93, 0x57, 0x39, 0xfd, 0xa8, 0x6c, 0x74, 0xb0, 0xe5, 0x21, 0x4f, 0x8b, 0xde, 0x1a,
+    0xb4, 0x70, 0x25, 0xe1, 0x8f, 0x4b, 0x1e, 0xda, 0xc2, 0x06, 0x53, 0x97, 0xf9, 0x3d, 0x68, 0xac,
+    0x58, 0x9c, 0xc9, 0x0d, 0x63, 0xa7, 0xf2, 0x36, 0x2e, 0xea, 0xbf, 0x7b, 0x15, 0xd1, 0x84, 0x40,
+    0x75, 0xb1, 0xe4, 0x20, 0x4e, 0x8a, 0xdf, 0x1b, 0x03, 0xc7, 0x92, 0x56, 0x38, 0xfc, 0xa9, 0x6d,
+    0x99, 0x5d, 0x08, 0xcc, 0xa2, 0x66, 0x33, 0xf7, 0xef, 0x2b, 0x7e, 0xba, 0xd4, 0x10, 0x45, 0x81
+  },
+  {
+    0x00, 0xab, 0x4f, 0xe4, 0x9e, 0x35, 0xd1, 0x7a, 0x25, 0x8e, 0x6a, 0xc1, 0xbb, 0x10, 0xf4, 0x5f,
+    0x4a, 0xe1, 0x05, 0xae, 0xd4, 0x7f, 0x9b, 0x30, 0x6f, 0xc4, 0x20, 0x8b, 0xf1, 0x5a, 0xbe, 0x15,
+    0x94, 0x3f, 0xdb, 0x70, 0x0a, 0xa1, 0x45, 0xee, 0xb1, 0x1a, 0xfe, 0x55, 0x2f, 0x84, 0x60, 0xcb,
+    0xde, 0x75, 0x91, 0x3a, 0x40, 0xeb, 0x0f, 0xa4, 0xfb, 0x50, 0xb4, 0x1f, 0x65, 0xce, 0x2a, 0x81,
+    0x31, 0x9a, 0x7e, 0xd5, 0xaf, 0x04, 0xe0, 0x4b, 0x14, 0xbf, 0x5b, 0xf0, 0x8a, 0x21, 0xc5, 0x6e,
+    0x7b, 0xd0, 0x34, 0x9f, 0xe5, 0x4e, 0xaa, 0x01, 0x5e, 0xf5, 0x11, 0xba, 0xc0, 0x6b, 0x8f, 0x24,
+    0xa5, 0x0e, 0xea, 0x41, 0x3b, 0x90, 0x74, 0xdf, 0x80, 0x2b, 0xcf, 0x64, 0x1e, 0xb5, 0x51, 0xfa,
+    0xef, 0x44, 0xa0, 0x0b, 0x71, 0xda, 0x3e, 0x95, 0xca, 0x61, 0x85, 0x2e, 0x54, 0xff, 0x1b, 0xb0,
+    0x62, 0xc9, 0x2d, 0x86, 0xfc, 0x57, 0xb3, 0x18, 0x47, 0xec, 0x08, 0xa3, 0xd9, 0x72, 0x96, 0x3d,
+    0x28, 0x83, 0x67, 0xcc, 0xb6, 0x1d, 0xf9, 0x52, 0x0d, 0xa6, 0x42, 0xe9, 0x93, 0x38, 0xdc, 0x77,
+    0xf6, 0x5d, 0xb9, 0x12, 0x68, 0xc3, 0x27, 0x8c, 0xd3, 0x78, 0x9c, 0x37, 0x4d, 0xe6, 0x02, 0xa9,
+    0xbc, 0x17, 0xf3, 0x58, 0x22, 0x89, 0x6d, 0xc6, 0x99, 0x32, 0xd6, 0x7d, 0x07, 0xac, 0x48, 0xe3,
+    0x53, 0xf8, 0x1c, 0xb7, 0xcd, 0x66, 0x82, 0x29, 0x76, 0xdd, 0x39, 0x92, 0xe8, 0x43, 0xa7, 0x0c,
+    0x19, 0xb2, 0x56, 0xfd, 0x87, 0x2c, 0xc8, 0x63, 0x3c, 0x97, 0x73, 0xd8, 0xa2, 0x09, 0xed, 0x46,
+    0xc7, 0x6c, 0x88, 0x23, 0x59, 0xf2, 0x16, 0xbd, 0xe2, 0x49, 0xad, 0x06, 0x7c, 0xd7, 0x33, 0x98,
+    0x8d, 0x26, 0xc2, 0x69, 0x13, 0xb8, 0x5c, 0xf7, 0xa8, 0x03, 0xe7, 0x4c, 0x36, 0x9d, 0x79, 0xd2
+  },
+  {
+    0x00, 0x8f, 0x07, 0x88, 0x0e, 0x81, 0x09, 0x86, 0x1c, 0x93, 0x1b, 0x94, 0x12, 0x9d, 0x15, 0x9a,
+    0x38, 0xb7, 0x3f, 0xb0, 0x36, 0xb9, 0x31, 0xbe, 0x24, 0xab, 0x23, 0xac, 0x2a, 0xa5, 0x2d, 0xa2,
+    0x70, 0xff, 0x77, 0xf8, 0x7e, 0xf1, 0x79, 0xf6, 0x6c, 0xe3, 0x6b, 0xe4, 0x62, 0xed, 0x65, 0xea,
+    0x48, 0xc7, 0x4f, 0xc0, 0x46, 0xc9, 0x41, 0xce, 0x54, 0xdb, 0x53, 0xdc, 0x5a, 0xd5, 0x5d, 0xd2,
+    0xe0, 0x6f, 0xe7, 0x68, 0xee, 0x61, 0xe9, 0x66, 0xfc, 0x73, 0xfb, 0x74, 0xf2, 0x7d, 0xf5, 0x7a,
+    0xd8, 0x57, 0xdf, 0x50, 0xd6, 0x59, 0xd1, 0x5e, 0xc4, 0x4b, 0xc3, 0x4c, 0xca, 0x45, 0xcd, 0x42,
+    0x90, 0x1f, 0x97, 0x18, 0x9e, 0x11, 0x99, 0x16, 0x8c, 0x03, 0x8b, 0x04, 0x82, 0x0d, 0x85, 0x0a,
+    0xa8, 0x27, 0xaf, 0x20, 0xa6, 0x29, 0xa1, 0x2e, 0xb4, 0x3b, 0xb3, 0x3c, 0xba, 0x35, 0xbd, 0x32,
+    0xd9, 0x56, 0xde, 0x51, 0xd7, 0x58, 0xd0, 0x5f, 0xc5, 0x4a, 0xc2, 0x4d, 0xcb, 0x44, 0xcc, 0x43,
+    0xe1, 0x6e, 0xe6, 0x69, 0xef, 0x60, 0xe8, 0x67, 0xfd, 0x72, 0xfa, 0x75, 0xf3, 0x7c, 0xf4, 0x7b,
+    0xa9, 0x26, 0xae, 0x21, 0xa7, 0x28, 0xa0, 0x2f, 0xb5, 0x3a, 0xb2, 0x3d, 0xbb, 0x34, 0xbc, 0x33,
+    0x91, 0x1e, 0x96, 0x19, 0x9f, 0x10, 0x98, 0x17, 0x8d, 0x02, 0x8a, 0x05, 0x83, 0x0c, 0x84, 0x0b,
+    0x39, 0xb6, 0x3e, 0xb1, 0x37, 0xb8, 0x30, 0xbf, 0x25, 0xaa, 0x22, 0xad, 0x2b, 0xa4, 0x2c, 0xa3,
+    0x01, 0x8e, 0x06, 0x89, 0x0f, 0x80, 0x08, 0x87, 0x1d, 0x92, 0x1a, 0x95, 0x13, 0x9c, 0x14, 0x9b,
+    0x49, 0xc6, 0x4e, 0xc1, 0x47, 0xc8, 0x40, 0xcf, 0x55, 0xda, 0x52, 0xdd, 0x5b, 0xd4, 0x5c, 0xd3,
+    0x71, 0xfe, 0x76, 0xf9, 0x7f, 0xf0, 0x78, 0xf7, 0x6d, 0xe2, 0x6a, 0xe5, 0x63, 0xec, 0x64, 0xeb
+  },
+  {
+    0x00, 0xcd, 0x83, 0x4e, 0x1f, 0xd2, 0x9c, 0x51, 0x3e, 0xf3, 0xbd, 0x70, 0x21, 0xec, 0xa2, 0x6f,
+    0x7c, 0xb1, 0xff, 0x32, 0x63, 0xae, 0xe0, 0x2d, 0x42, 0x8f, 0xc1, 0x0c, 0x5d, 0x90, 0xde, 0x13,
+    0xf8, 0x35, 0x7b, 0xb6, 0xe7, 0x2a, 0x64, 0xa9, 0xc6, 0x0b, 0x45, 0x88, 0xd9, 0x14, 0x5a, 0x97,
+    0x84, 0x49, 0x07, 0xca, 0x9b, 0x56, 0x18, 0xd5, 0xba, 0x77, 0x39, 0xf4, 0xa5, 0x68, 0x26, 0xeb,
+    0xe9, 0x24, 0x6a, 0xa7, 0xf6, 0x3b, 0x75, 0xb8, 0xd7, 0x1a, 0x54, 0x99, 0xc8, 0x05, 0x4b, 0x86,
+    0x95, 0x58, 0x16, 0xdb, 0x8a, 0x47, 0x09, 0xc4, 0xab, 0x66, 0x28, 0xe5, 0xb4, 0x79, 0x37, 0xfa,
+    0x11, 0xdc, 0x92, 0x5f, 0x0e, 0xc3, 0x8d, 0x40, 0x2f, 0xe2, 0xac, 0x61, 0x30, 0xfd, 0xb3, 0x7e,
+    0x6d, 0xa0, 0xee, 0x23, 0x72, 0xbf, 0xf1, 0x3c, 0x53, 0x9e, 0xd0, 0x1d, 0x4c, 0x81, 0xcf, 0x02,
+    0xcb, 0x06, 0x48, 0x85, 0xd4, 0x19, 0x57, 0x9a, 0xf5, 0x38, 0x76, 0xbb, 0xea, 0x27, 0x69, 0xa4,
+    0xb7, 0x7a, 0x34, 0xf9, 0xa8, 0x65, 0x2b, 0xe6, 0x89, 0x44, 0x0a, 0xc7, 0x96, 0x5b, 0x15, 0xd8,
+    0x33, 0xfe, 0xb0, 0x7d, 0x2c, 0xe1, 0xaf, 0x62, 0x0d, 0xc0, 0x8e, 0x43, 0x12, 0xdf, 0x91, 0x5c,
+    0x4f, 0x82, 0xcc, 0x01, 0x50, 0x9d, 0xd3, 0x1e, 0x71, 0xbc, 0xf2, 0x3f, 0x6e, 0xa3, 0xed, 0x20,
+    0x22, 0xef, 0xa1, 0x6c, 0x3d, 0xf0, 0xbe, 0x73, 0x1c, 0xd1, 0x9f, 0x52, 0x03, 0xce, 0x80, 0x4d,
+    0x5e, 0x93, 0xdd, 0x10, 0x41, 0x8c, 0xc2, 0x0f, 0x60, 0xad, 0xe3, 0x2e, 0x7f, 0xb2, 0xfc, 0x31,
+    0xda, 0x17, 0x59, 0x94, 0xc5, 0x08, 0x46, 0x8b, 0xe4, 0x29, 0x67, 0xaa, 0xfb, 0x36, 0x78, 0xb5,
+    0xa6, 0x6b, 0x25, 0xe8, 0xb9, 0x74, 0x3a, 0xf7, 0x98, 0x55, 0x1b, 0xd6, 0x87, 0x4a, 0x04, 0xc9
+  },
+  {
+    0x00, 0x37, 0x6e, 0x59, 0xdc, 0xeb, 0xb2, 0x85, 0xa1, 0x96, 0xcf, 0xf8, 0x7d, 0x4a, 0x13, 0x24,
+    0x5b, 0x6c, 0x35, 0x02, 0x87, 0xb0, 0xe9, 0xde, 0xfa, 0xcd, 0x94, 0xa3, 0x26, 0x11, 0x48, 0x7f,
+    0xb6, 0x81, 0xd8, 0xef, 0x6a, 0x5d, 0x04, 0x33, 0x17, 0x20, 0x79, 0x4e, 0xcb, 0xfc, 0xa5, 0x92,
+    0xed, 0xda, 0x83, 0xb4, 0x31, 0x06, 0x5f, 0x68, 0x4c, 0x7b, 0x22, 0x15, 0x90, 0xa7, 0xfe, 0xc9,
+    0x75, 0x42, 0x1b, 0x2c, 0xa9, 0x9e, 0xc7, 0xf0, 0xd4, 0xe3, 0xba, 0x8d, 0x08, 0x3f, 0x66, 0x51,
+    0x2e, 0x19, 0x40, 0x77, 0xf2, 0xc5, 0x9c, 0xab, 0x8f, 0xb8, 0xe1, 0xd6, 0x53, 0x64, 0x3d, 0x0a,
+    0xc3, 0xf4, 0xad, 0x9a, 0x1f, 0x28, 0x71, 0x46, 0x62, 0x55, 0x0c, 0x3b, 0xbe, 0x89, 0xd0, 0xe7,
+    0x98, 0xaf, 0xf6, 0xc1, 0x44, 0x73, 0x2a, 0x1d, 0x39, 0x0e, 0x57, 0x60, 0xe5, 0xd2, 0x8b, 0xbc,
+    0xea, 0xdd, 0x84, 0xb3, 0x36, 0x01, 0x58, 0x6f, 0x4b, 0x7c, 0x25, 0x12, 0x97, 0xa0, 0xf9, 0xce,
+    0xb1, 0x86, 0xdf, 0xe8, 0x6d, 0x5a, 0x03, 0x34, 0x10, 0x27, 0x7e, 0x49, 0xcc, 0xfb, 0xa2, 0x95,
+    0x5c, 0x6b, 0x32, 0x05, 0x80, 0xb7, 0xee, 0xd9, 0xfd, 0xca, 0x93, 0xa4, 0x21, 0x16, 0x4f, 0x78,
+    0x07, 0x30, 0x69, 0x5e, 0xdb, 0xec, 0xb5, 0x82, 0xa6, 0x91, 0xc8, 0xff, 0x7a, 0x4d, 0x14, 0x23,
+    0x9f, 0xa8, 0xf1, 0xc6, 0x43, 0x74, 0x2d, 0x1a, 0x3e, 0x09, 0x50, 0x67, 0xe2, 0xd5, 0x8c, 0xbb,
+    0xc4, 0xf3, 0xaa, 0x9d, 0x18, 0x2f, 0x76, 0x41, 0x65, 0x52, 0x0b, 0x3c, 0xb9, 0x8e, 0xd7, 0xe0,
+    0x29, 0x1e, 0x47, 0x70, 0xf5, 0xc2, 0x9b, 0xac, 0x88, 0xbf, 0xe6, 0xd1, 0x54, 0x63, 0x3a, 0x0d,
+    0x72, 0x45, 0x1c, 0x2b, 0xae, 0x99, 0xc0, 0xf7, 0xd3, 0xe4, 0xbd, 0x8a, 0x0f, 0x38, 0x61, 0x56
+  },
+  {
+    0x00, 0x3d, 0x7a, 0x47, 0xf4, 0xc9, 0x8e, 0xb3, 0xf1, 0xcc, 0x8b, 0xb6, 0x05, 0x38, 0x7f, 0x42,
+    0xfb, 0xc6, 0x81, 0xbc, 0x0f, 0x32, 0x75, 0x48, 0x0a, 0x37, 0x70, 0x4d, 0xfe, 0xc3, 0x84, 0xb9,
+    0xef, 0xd2, 0x95, 0xa8, 0x1b, 0x26, 0x61, 0x5c, 0x1e, 0x23, 0x64, 0x59, 0xea, 0xd7, 0x90, 0xad,
+    0x14, 0x29, 0x6e, 0x53, 0xe0, 0xdd, 0x9a, 0xa7, 0xe5, 0xd8, 0x9f, 0xa2, 0x11, 0x2c, 0x6b, 0x56,
+    0xc7, 0xfa, 0xbd, 0x80, 0x33, 0x0e, 0x49, 0x74, 0x36, 0x0b, 0x4c, 0x71, 0xc2, 0xff, 0xb8, 0x85,
+    0x3c, 0x01, 0x46, 0x7b, 0xc8, 0xf5, 0xb2, 0x8f, 0xcd, 0xf0, 0xb7, 0x8a, 0x39, 0x04, 0x43, 0x7e,
+    0x28, 0x15, 0x52, 0x6f, 0xdc, 0xe1, 0xa6, 0x9b, 0xd9, 0xe4, 0xa3, 0x9e, 0x2d, 0x10, 0x57, 0x6a,
+    0xd3, 0xee, 0xa9, 0x94, 0x27, 0x1a, 0x5d, 0x60, 0x22, 0x1f, 0x58, 0x65, 0xd6, 0xeb, 0xac, 0x91,
+    0x97, 0xaa, 0xed, 0xd0, 0x63, 0x5e, 0x19, 0x24, 0x66, 0x5b, 0x1c, 0x21, 0x92, 0xaf, 0xe8, 0xd5,
+    0x6c, 0x51, 0x16, 0x2b, 0x98, 0xa5, 0xe2, 0xdf, 0x9d, 0xa0, 0xe7, 0xda, 0x69, 0x54, 0x13, 0x2e,
+    0x78, 0x45, 0x02, 0x3f, 0x8c, 0xb1, 0xf6, 0xcb, 0x89, 0xb4, 0xf3, 0xce, 0x7d, 0x40, 0x07, 0x3a,
+    0x83, 0xbe, 0xf9, 0xc4, 0x77, 0x4a, 0x0d, 0x30, 0x72, 0x4f, 0x08, 0x35, 0x86, 0xbb, 0xfc, 0xc1,
+    0x50, 0x6d, 0x2a, 0x17, 0xa4, 0x99, 0xde, 0xe3, 0xa1, 0x9c, 0xdb, 0xe6, 0x55, 0x68, 0x2f, 0x12,
+    0xab, 0x96, 0xd1, 0xec, 0x5f, 0x62, 0x25, 0x18, 0x5a, 0x67, 0x20, 0x1d, 0xae, 0x93, 0xd4, 0xe9,
+    0xbf, 0x82, 0xc5, 0xf8, 0x4b, 0x76, 0x31, 0x0c, 0x4e, 0x73, 0x34, 0x09, 0xba, 0x87, 0xc0, 0xfd,
+    0x44, 0x79, 0x3e, 0x03, 0xb0, 0x8d, 0xca, 0xf7, 0xb5, 0x88, 0xcf, 0xf2, 0x41, 0x7c, 0x3b, 0x06
+  },
+  {
+    0x00, 0x43, 0x86, 0xc5, 0x15, 0x56, 0x93, 0xd0, 0x2a, 0x69, 0xac, 0xef, 0x3f, 0x7c, 0xb9, 0xfa,
+    0x54, 0x17, 0xd2, 0x91, 0x41, 0x02, 0xc7, 0x84, 0x7e, 0x3d, 0xf8, 0xbb, 0x6b, 0x28, 0xed, 0xae,
+    0xa8, 0xeb, 0x2e, 0x6d, 0xbd, 0xfe, 0x3b, 0x78, 0x82, 0xc1, 0x04, 0x47, 0x97, 0xd4, 0x11, 0x52,
+    0xfc, 0xbf, 0x7a, 0x39, 0xe9, 0xaa, 0x6f, 0x2c, 0xd6, 0x95, 0x50, 0x13, 0xc3, 0x80, 0x45, 0x06,
+    0x49, 0x0a, 0xcf, 0x8c, 0x5c, 0x1f, 0xda, 0x99, 0x63, 0x20, 0xe5, 0xa6, 0x76, 0x35, 0xf0, 0xb3,
+    0x1d, 0x5e, 0x9b, 0xd8, 0x08, 0x4b, 0x8e, 0xcd, 0x37, 0x74, 0xb1, 0xf2, 0x22, 0x61, 0xa4, 0xe7,
+    0xe1, 0xa2, 0x67, 0x24, 0xf4, 0xb7, 0x72, 0x31, 0xcb, 0x88, 0x4d, 0x0e, 0xde, 0x9d, 0x58, 0x1b,
+    0xb5, 0xf6, 0x33, 0x70, 0xa0, 0xe3, 0x26, 0x65, 0x9f, 0xdc, 0x19, 0x5a, 0x8a, 0xc9, 0x0c, 0x4f,
+    0x92, 0xd1, 0x14, 0x57, 0x87, 0xc4, 0x01, 0x42, 0xb8, 0xfb, 0x3e, 0x7d, 0xad, 0xee, 0x2b, 0x68,
+    0xc6, 0x85, 0x40, 0x03, 0xd3, 0x90, 0x55, 0x16, 0xec, 0xaf, 0x6a, 0x29, 0xf9, 0xba, 0x7f, 0x3c,
+    0x3a, 0x79, 0xbc, 0xff, 0x2f, 0x6c, 0xa9, 0xea, 0x10, 0x53, 0x96, 0xd5, 0x05, 0x46, 0x83, 0xc0,
+    0x6e, 0x2d, 0xe8, 0xab, 0x7b, 0x38, 0xfd, 0xbe, 0x44, 0x07, 0xc2, 0x81, 0x51, 0x12, 0xd7, 0x94,
+    0xdb, 0x98, 0x5d, 0x1e, 0xce, 0x8d, 0x48, 0x0b, 0xf1, 0xb2, 0x77, 0x34, 0xe4, 0xa7, 0x62, 0x21,
+    0x8f, 0xcc, 0x09, 0x4a, 0x9a, 0xd9, 0x1c, 0x5f, 0xa5, 0xe6, 0x23, 0x60, 0xb0, 0xf3, 0x36, 0x75,
+    0x73, 0x30, 0xf5, 0xb6, 0x66, 0x25, 0xe0, 0xa3, 0x59, 0x1a, 0xdf, 0x9c, 0x4c, 0x0f, 0xca, 0x89,
+    0x27, 0x64, 0xa1, 0xe2, 0x32, 0x71, 0xb4, 0xf7, 0x0d, 0x4e, 0x8b, 0xc8, 0x18, 0x5b, 0x9e, 0xdd
+  }
 };
 
+/**
+  Updates a CRC-8 with the contents of a buffer using slice-by-8 tables.
+
+  Both CRC-8 types are linear in the CRC register, so the contribution of
+  each byte of a block of eight can be looked up independently.
+
+  @param[in]  Tables               Slice-by-8 tables of the CRC type.
+  @param[in]  Crc                  CRC-8 of the preceding data, or the seed.
+  @param[in]  Buffer               A pointer to the data buffer.
+  @param[in]  Size                 Size of buffer.
+
+  @return the updated CRC-8 value.
+**/
+STATIC
+UINT8
+Crc8UpdateSliced (
+  IN CONST UINT8  Tables[CRC8_SLICES][256],
+  IN UINT8        Crc,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Size
+  )
+{
+  while (Size >= CRC8_SLICES) {
+    Crc = Tables[7][Buffer[0] ^ Crc] ^
+          Tables[6][Buffer[1]] ^
+          Tables[5][Buffer[2]] ^
+          Tables[4][Buffer[3]] ^
+          Tables[3][Buffer[4]] ^
+          Tables[2][Buffer[5]] ^
+          Tables[1][Buffer[6]] ^
+          Tables[0][Buffer[7]];
+    Buffer += CRC8_SLICES;
+    Size   -= CRC8_SLICES;
+  }
+
+  while (Size > 0) {
+    Crc = Tables[0][*Buffer ^ Crc];
+    Buffer++;
+    Size--;
+  }
+
+  return Crc;
+}
+
+/**
+  Updates a TYPE_CRC8 CRC-8 with the contents of a buffer.
+
+  @param[in]  Crc                  CRC-8 of the preceding data, or the seed.
+  @param[in]  Buffer               A pointer to the data buffer.
+  @param[in]  Size                 Size of buffer.
+
+  @return the updated CRC-8 value.
+**/
+UINT8
+EFIAPI
+Crc8UpdateCrc8 (
+  IN UINT8       Crc,
+  IN CONST VOID  *Buffer,
+  IN UINTN       Size
+  )
+{
+  return Crc8UpdateSliced (mCrc8Tables, Crc, Buffer, Size);
+}
+
+/**
+  Updates a TYPE_CRC8_MAXIM CRC-8 with the contents of a buffer.
+
+  @param[in]  Crc                  CRC-8 of the preceding data, or the seed.
+  @param[in]  Buffer               A pointer to the data buffer.
+  @param[in]  Size                 Size of buffer.
+
+  @return the updated CRC-8 value.
+**/
+UINT8
+EFIAPI
+Crc8UpdateMaxim (
+  IN UINT8       Crc,
+  IN CONST VOID  *Buffer,
+  IN UINTN       Size
+  )
+{
+  return Crc8UpdateSliced (mCrc8MaximTables, Crc, Buffer, Size);
+}
+
+/**
+  Updates a CRC-8 with the contents of a buffer.
+
+  @param[in]  Crc                  CRC-8 of the preceding data, or the seed.
+  @param[in]  Buffer               A pointer to the data buffer.
+  @param[in]  Size                 Size of buffer.
+  @param[in]  Type                 Type of the CRC to use
+
+  @return the updated CRC-8 value, 0 if Type is not supported.
+**/
+UINT8
+EFIAPI
+Crc8Update (
+  IN UINT8       Crc,
+  IN CONST VOID  *Buffer,
+  IN UINTN       Size,
+  IN UINT8       Type
+  )
+{
+  if (Type == TYPE_CRC8) {
+    return Crc8UpdateCrc8 (Crc, Buffer, Size);
+  } else if (Type == TYPE_CRC8_MAXIM) {
+    return Crc8UpdateMaxim (Crc, Buffer, Size);
+  }
+
+  return 0;
+}
+
 /**
   Calculates CRC-8 for input buffer.
 
   @param[in]  Buffer               A pointer to the data buffer.
   @param[in]  Size                 Size of buffer.
   @param[in]  Seed                 Seed of the CRC to use
+  @param[in]  Type                 Type of the CRC to use
 
   @return the CRC-8 value.
 **/
@@ -67,21 +445,5 @@ CalculateCrc8 (
   IN UINT8   Type
   )
 {
-  UINT8        Crc8 = Seed;
-  UINT16       Index;
-  CONST UINT8  *UsedCr88Table;
-
-  if (Type == TYPE_CRC8) {
-    UsedCr88Table = CRC8Table;
-  } else if (Type == TYPE_CRC8_MAXIM) {
-    UsedCr88Table = CRC8MaximTable;
-  } else {
-    return 0;
-  }
-
-  for (Index = 0; Index < Size; Index++) {
-    Crc8 =  UsedCr88Table[Buffer[Index] ^ Crc8];
-  }
-
-  return Crc8;
+  return Crc8Update (Seed, Buffer, Size, Type);
 }
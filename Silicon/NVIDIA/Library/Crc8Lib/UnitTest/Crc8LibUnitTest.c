@@ -0,0 +1,406 @@
+/** @file
+
+  Crc8 Library Unit Test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/Crc8Lib.h>
+
+#define UNIT_TEST_NAME     "Crc8 Lib Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define CRC8_POLY        0x07   // x^8 + x^2 + x^1 + 1
+#define CRC8_MAXIM_POLY  0x8c   // x^8 + x^5 + x^4 + 1, reflected
+
+#define TEST_BUFFER_SIZE     1024
+#define BENCH_BUFFER_SIZE    SIZE_1MB
+#define BENCH_ITERATIONS     16
+
+STATIC UINT8  mTestBuffer[TEST_BUFFER_SIZE];
+STATIC UINT8  mReferenceTable[2][256];
+
+/**
+  Bitwise CRC-8 reference implementation.
+
+  @param[in]  Buffer    Data buffer
+  @param[in]  Size      Size of buffer
+  @param[in]  Crc       Seed
+  @param[in]  Type      Type of the CRC
+
+  @retval CRC-8 value
+**/
+STATIC
+UINT8
+ReferenceCrc8 (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Size,
+  IN UINT8        Crc,
+  IN UINT8        Type
+  )
+{
+  UINTN  Index;
+  UINTN  Bit;
+
+  for (Index = 0; Index < Size; Index++) {
+    Crc ^= Buffer[Index];
+    for (Bit = 0; Bit < 8; Bit++) {
+      if (Type == TYPE_CRC8) {
+        Crc = (Crc & 0x80) ? (UINT8)((Crc << 1) ^ CRC8_POLY) : (UINT8)(Crc << 1);
+      } else {
+        Crc = (Crc & 0x01) ? (UINT8)((Crc >> 1) ^ CRC8_MAXIM_POLY) : (UINT8)(Crc >> 1);
+      }
+    }
+  }
+
+  return Crc;
+}
+
+/**
+  Byte-at-a-time table CRC-8, as the library used to compute it.
+
+  @param[in]  Buffer    Data buffer
+  @param[in]  Size      Size of buffer
+  @param[in]  Crc       Seed
+  @param[in]  Type      Type of the CRC
+
+  @retval CRC-8 value
+**/
+STATIC
+UINT8
+ByteTableCrc8 (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Size,
+  IN UINT8        Crc,
+  IN UINT8        Type
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    Crc = mReferenceTable[Type][Buffer[Index] ^ Crc];
+  }
+
+  return Crc;
+}
+
+/**
+  Fill the test buffer and reference tables.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc8TestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINT8  Byte;
+
+  for (Index = 0; Index < TEST_BUFFER_SIZE; Index++) {
+    mTestBuffer[Index] = (UINT8)((Index * 167) ^ (Index >> 3) ^ 0x5a);
+  }
+
+  for (Index = 0; Index < 256; Index++) {
+    Byte                                 = (UINT8)Index;
+    mReferenceTable[TYPE_CRC8][Index]       = ReferenceCrc8 (&Byte, 1, 0, TYPE_CRC8);
+    mReferenceTable[TYPE_CRC8_MAXIM][Index] = ReferenceCrc8 (&Byte, 1, 0, TYPE_CRC8_MAXIM);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check values of the standard "123456789" string.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc8CheckValues (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Check[] = "123456789";
+
+  UT_ASSERT_EQUAL (CalculateCrc8 (Check, 9, 0, TYPE_CRC8), 0xf4);
+  UT_ASSERT_EQUAL (CalculateCrc8 (Check, 9, 0, TYPE_CRC8_MAXIM), 0xa1);
+  UT_ASSERT_EQUAL (Crc8UpdateCrc8 (0, Check, 9), 0xf4);
+  UT_ASSERT_EQUAL (Crc8UpdateMaxim (0, Check, 9), 0xa1);
+  UT_ASSERT_EQUAL (Crc8Update (0, Check, 9, TYPE_CRC8), 0xf4);
+  UT_ASSERT_EQUAL (Crc8Update (0, Check, 9, TYPE_CRC8_MAXIM), 0xa1);
+
+  // Unsupported type
+  UT_ASSERT_EQUAL (CalculateCrc8 (Check, 9, 0, 2), 0);
+  UT_ASSERT_EQUAL (Crc8Update (0x55, Check, 9, 2), 0);
+
+  // Empty buffer returns the seed
+  UT_ASSERT_EQUAL (Crc8Update (0x3c, Check, 0, TYPE_CRC8), 0x3c);
+  UT_ASSERT_EQUAL (Crc8Update (0x3c, Check, 0, TYPE_CRC8_MAXIM), 0x3c);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Every length, alignment and seed matches the bitwise reference.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc8MatchesReference (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Offset;
+  UINTN  Size;
+  UINT8  Type;
+  UINT8  Seed;
+
+  for (Type = TYPE_CRC8; Type <= TYPE_CRC8_MAXIM; Type++) {
+    for (Offset = 0; Offset < 8; Offset++) {
+      for (Size = 0; Size <= 300; Size++) {
+        Seed = (UINT8)(Size * 31 + Offset);
+        UT_ASSERT_EQUAL (
+          Crc8Update (Seed, &mTestBuffer[Offset], Size, Type),
+          ReferenceCrc8 (&mTestBuffer[Offset], Size, Seed, Type)
+          );
+        UT_ASSERT_EQUAL (
+          CalculateCrc8 (&mTestBuffer[Offset], (UINT16)Size, Seed, Type),
+          ByteTableCrc8 (&mTestBuffer[Offset], Size, Seed, Type)
+          );
+      }
+    }
+
+    UT_ASSERT_EQUAL (
+      Crc8Update (0, mTestBuffer, TEST_BUFFER_SIZE, Type),
+      ReferenceCrc8 (mTestBuffer, TEST_BUFFER_SIZE, 0, Type)
+      );
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A buffer updated in pieces gives the same CRC as in one call.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc8Streaming (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Split;
+  UINTN  Piece;
+  UINTN  Offset;
+  UINT8  Type;
+  UINT8  Expected;
+  UINT8  Crc;
+
+  for (Type = TYPE_CRC8; Type <= TYPE_CRC8_MAXIM; Type++) {
+    Expected = ReferenceCrc8 (mTestBuffer, TEST_BUFFER_SIZE, 0, Type);
+
+    // Two pieces split at every offset
+    for (Split = 0; Split <= TEST_BUFFER_SIZE; Split++) {
+      Crc = Crc8Update (0, mTestBuffer, Split, Type);
+      Crc = Crc8Update (Crc, &mTestBuffer[Split], TEST_BUFFER_SIZE - Split, Type);
+      UT_ASSERT_EQUAL (Crc, Expected);
+    }
+
+    // Many pieces of odd sizes
+    for (Piece = 1; Piece < 20; Piece++) {
+      Crc = 0;
+      for (Offset = 0; Offset < TEST_BUFFER_SIZE; Offset += Piece) {
+        Crc = Crc8Update (Crc, &mTestBuffer[Offset], MIN (Piece, TEST_BUFFER_SIZE - Offset), Type);
+      }
+
+      UT_ASSERT_EQUAL (Crc, Expected);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Buffers larger than the 64 KiB CalculateCrc8 limit are supported.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc8LargeBuffer (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  *Buffer;
+  UINTN  Size;
+  UINTN  Index;
+  UINT8  Type;
+
+  Size   = SIZE_128KB + 5;
+  Buffer = AllocatePool (Size);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  for (Index = 0; Index < Size; Index++) {
+    Buffer[Index] = (UINT8)(Index ^ (Index >> 8) ^ (Index >> 16));
+  }
+
+  for (Type = TYPE_CRC8; Type <= TYPE_CRC8_MAXIM; Type++) {
+    UT_ASSERT_EQUAL (Crc8Update (0, Buffer, Size, Type), ReferenceCrc8 (Buffer, Size, 0, Type));
+  }
+
+  FreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Compare the throughput of the library with byte-at-a-time table lookups.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Crc8Benchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8    *Buffer;
+  UINTN    Index;
+  UINT8    Type;
+  UINT8    ByteCrc;
+  UINT8    SlicedCrc;
+  clock_t  Start;
+  clock_t  ByteTime;
+  clock_t  SlicedTime;
+
+  Buffer = AllocatePool (BENCH_BUFFER_SIZE);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  for (Index = 0; Index < BENCH_BUFFER_SIZE; Index++) {
+    Buffer[Index] = (UINT8)((Index * 131) ^ (Index >> 9));
+  }
+
+  for (Type = TYPE_CRC8; Type <= TYPE_CRC8_MAXIM; Type++) {
+    ByteCrc = 0;
+    Start   = clock ();
+    for (Index = 0; Index < BENCH_ITERATIONS; Index++) {
+      ByteCrc = ByteTableCrc8 (Buffer, BENCH_BUFFER_SIZE, ByteCrc, Type);
+    }
+
+    ByteTime = clock () - Start;
+
+    SlicedCrc = 0;
+    Start     = clock ();
+    for (Index = 0; Index < BENCH_ITERATIONS; Index++) {
+      SlicedCrc = Crc8Update (SlicedCrc, Buffer, BENCH_BUFFER_SIZE, Type);
+    }
+
+    SlicedTime = clock () - Start;
+
+    UT_LOG_INFO (
+      "Type %u: %u MiB byte table %lu us, slice-by-8 %lu us\n",
+      Type,
+      BENCH_ITERATIONS,
+      (UINT64)ByteTime * 1000000 / CLOCKS_PER_SEC,
+      (UINT64)SlicedTime * 1000000 / CLOCKS_PER_SEC
+      );
+    UT_ASSERT_EQUAL (SlicedCrc, ByteCrc);
+  }
+
+  FreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  Crc8 library and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      Crc8Tests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&Crc8Tests, Framework, "Crc8 Lib Tests", "UnitTest.Crc8Lib", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Crc8 Lib Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    return Status;
+  }
+
+  AddTestCase (Crc8Tests, "Standard check values", "CheckValues", Crc8CheckValues, Crc8TestSetup, NULL, NULL);
+  AddTestCase (Crc8Tests, "Matches bitwise reference", "MatchesReference", Crc8MatchesReference, Crc8TestSetup, NULL, NULL);
+  AddTestCase (Crc8Tests, "Incremental updates", "Streaming", Crc8Streaming, Crc8TestSetup, NULL, NULL);
+  AddTestCase (Crc8Tests, "Buffers over 64 KiB", "LargeBuffer", Crc8LargeBuffer, Crc8TestSetup, NULL, NULL);
+  AddTestCase (Crc8Tests, "Throughput against byte table", "Benchmark", Crc8Benchmark, Crc8TestSetup, NULL, NULL);
+
+  // Execute the tests.
+  Status = RunAllTestSuites (Framework);
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
@@ -19,6 +19,8 @@
 #include <Library/DeviceDiscoveryLib.h>
 #include <Library/DeviceDiscoveryDriverLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/PerformanceLib.h>
+#include <Library/PrintLib.h>
 #include <libfdt.h>
 
 #include <Protocol/NonDiscoverableDevice.h>
@@ -34,6 +36,76 @@ SCMI_CLOCK2_PROTOCOL           *gScmiClockProtocol    = NULL;
 NVIDIA_CLOCK_PARENTS_PROTOCOL  *gClockParentsProtocol = NULL;
 STATIC EFI_HANDLE              mImageHandle           = NULL;
 
+STATIC CONST CHAR8  *mDeviceDiscoveryPhaseNames[DeviceDiscoveryMax] = {
+  "DriverStart",
+  "DtCompat",
+  "Supported",
+  "Start",
+  "Stop",
+  "OnExit",
+  "EnumDone"
+};
+
+/**
+  Invoke the DeviceDiscoveryNotify callback of the driver and record the time
+  spent in it in the boot performance log, attributed to the driver and the
+  device tree node.
+
+  @param[in]  Phase             Current phase of the driver initialization
+  @param[in]  DriverHandle      Handle of the driver.
+  @param[in]  ControllerHandle  Handle of the controller.
+  @param[in]  DeviceTreeNode    Pointer to the device tree node protocol is available.
+
+  @retval Status returned by DeviceDiscoveryNotify
+
+**/
+STATIC
+EFI_STATUS
+DeviceDiscoveryNotifyTraced (
+  IN  NVIDIA_DEVICE_DISCOVERY_PHASES          Phase,
+  IN  EFI_HANDLE                              DriverHandle,
+  IN  EFI_HANDLE                              ControllerHandle,
+  IN  CONST NVIDIA_DEVICE_TREE_NODE_PROTOCOL  *DeviceTreeNode OPTIONAL
+  )
+{
+  EFI_STATUS   Status;
+  BOOLEAN      Trace;
+  CONST CHAR8  *NodeName;
+  CHAR8        Measurement[DEVICE_DISCOVERY_TRACE_LENGTH];
+
+  // Supported, compatibility and exit phases run for every node or after the
+  // log is published, so only the phases that bring up hardware are traced
+  Trace = ((Phase == DeviceDiscoveryDriverStart) ||
+           (Phase == DeviceDiscoveryDriverBindingStart) ||
+           (Phase == DeviceDiscoveryDriverBindingStop) ||
+           (Phase == DeviceDiscoveryEnumerationCompleted)) &&
+          LogPerformanceMeasurementEnabled (PERF_INMODULE_START_ID);
+
+  if (Trace) {
+    NodeName = NULL;
+    if (DeviceTreeNode != NULL) {
+      NodeName = fdt_get_name (DeviceTreeNode->DeviceTreeBase, DeviceTreeNode->NodeOffset, NULL);
+    }
+
+    AsciiSPrint (
+      Measurement,
+      sizeof (Measurement),
+      "DD %a %a",
+      mDeviceDiscoveryPhaseNames[Phase],
+      (NodeName != NULL) ? NodeName : ""
+      );
+    PERF_INMODULE_BEGIN (Measurement);
+  }
+
+  Status = DeviceDiscoveryNotify (Phase, DriverHandle, ControllerHandle, DeviceTreeNode);
+
+  if (Trace) {
+    PERF_INMODULE_END (Measurement);
+  }
+
+  return Status;
+}
+
 VOID
 EFIAPI
 DeviceDiscoveryOnExitBootServices (
@@ -53,7 +125,7 @@ DeviceDiscoveryOnExitBootServices (
 
   Controller = Context;
 
-  Status = DeviceDiscoveryNotify (
+  Status = DeviceDiscoveryNotifyTraced (
              DeviceDiscoveryOnExit,
              mImageHandle,
              Controller,
@@ -186,7 +258,7 @@ DeviceDiscoveryBindingSupported (
   }
 
   if (!EFI_ERROR (Status)) {
-    Status = DeviceDiscoveryNotify (
+    Status = DeviceDiscoveryNotifyTraced (
                DeviceDiscoveryDriverBindingSupported,
                This->DriverBindingHandle,
                Controller,
@@ -360,7 +432,7 @@ DeviceDiscoveryBindingStart (
     }
   }
 
-  Status = DeviceDiscoveryNotify (
+  Status = DeviceDiscoveryNotifyTraced (
              DeviceDiscoveryDriverBindingStart,
              This->DriverBindingHandle,
              Controller,
@@ -390,7 +462,7 @@ DeviceDiscoveryBindingStart (
                     NULL
                     );
     if (EFI_ERROR (Status)) {
-      DeviceDiscoveryNotify (
+      DeviceDiscoveryNotifyTraced (
         DeviceDiscoveryDriverBindingStop,
         This->DriverBindingHandle,
         Controller,
@@ -498,7 +570,7 @@ DeviceDiscoveryBindingStop (
     }
   }
 
-  Status = DeviceDiscoveryNotify (
+  Status = DeviceDiscoveryNotifyTraced (
              DeviceDiscoveryDriverBindingStop,
              This->DriverBindingHandle,
              Controller,
@@ -606,7 +678,7 @@ DeviceTreeIsSupported (
   *DeviceType      = MappingNode->DeviceType;
   *PciIoInitialize = NULL;
 
-  return DeviceDiscoveryNotify (
+  return DeviceDiscoveryNotifyTraced (
            DeviceDiscoveryDeviceTreeCompatibility,
            mDriverBindingProtocol.DriverBindingHandle,
            NULL,
@@ -737,7 +809,7 @@ EnumerateDevices (
     DtNodeInfo = NULL;
   }
 
-  Status = DeviceDiscoveryNotify (
+  Status = DeviceDiscoveryNotifyTraced (
              DeviceDiscoveryEnumerationCompleted,
              mImageHandle,
              NULL,
@@ -794,7 +866,7 @@ DeviceDiscoveryDriverInitialize (
     }
   }
 
-  Status = DeviceDiscoveryNotify (
+  Status = DeviceDiscoveryNotifyTraced (
              DeviceDiscoveryDriverStart,
              mDriverBindingProtocol.DriverBindingHandle,
              NULL,
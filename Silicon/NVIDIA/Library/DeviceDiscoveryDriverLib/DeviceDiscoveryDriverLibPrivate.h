@@ -22,4 +22,7 @@ typedef struct {
   EFI_EVENT    OnExitBootServicesEvent;
 } NVIDIA_DEVICE_DISCOVERY_CONTEXT;
 
+// Length of the boot performance log measurement strings
+#define DEVICE_DISCOVERY_TRACE_LENGTH  64
+
 #endif
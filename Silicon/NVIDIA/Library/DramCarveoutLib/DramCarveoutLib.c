@@ -15,6 +15,14 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/PrePiHobListPointerLib.h>
 
+#ifdef EDKII_UNIT_TEST_FRAMEWORK_ENABLED
+// Region comparisons made by the sort, checked by the host-based unit test
+UINTN  mDramCarveoutSortCompares = 0;
+#define DRAM_CARVEOUT_COUNT_COMPARE()  mDramCarveoutSortCompares++
+#else
+#define DRAM_CARVEOUT_COUNT_COMPARE()
+#endif
+
 /**
   Migrate Hob list to the new region.
 
@@ -96,7 +104,65 @@ MigrateHobList (
 }
 
 /**
-  Simple insertion sort to sort regions entries in ascending order.
+  Check if a region starts above another region.
+
+  @param A [IN]               Region to check
+  @param B [IN]               Region to compare with
+
+  @retval TRUE                A starts above B
+  @retval FALSE               A starts at or below B
+**/
+STATIC
+BOOLEAN
+MemoryRegionIsAbove (
+  IN CONST NVDA_MEMORY_REGION  *A,
+  IN CONST NVDA_MEMORY_REGION  *B
+  )
+{
+  DRAM_CARVEOUT_COUNT_COMPARE ();
+  return (A->MemoryBaseAddress > B->MemoryBaseAddress);
+}
+
+/**
+  Move a region down a max-heap of regions ordered by base address.
+
+  @param Regions [IN, OUT]    Array of regions
+  @param Root [IN]            Index of the region to move down
+  @param RegionsCount [IN]    Number of regions in the heap
+**/
+STATIC
+VOID
+MemoryRegionSiftDown (
+  IN OUT NVDA_MEMORY_REGION  *Regions,
+  IN UINTN                   Root,
+  IN UINTN                   RegionsCount
+  )
+{
+  NVDA_MEMORY_REGION  Region;
+  UINTN               Child;
+
+  Region = Regions[Root];
+  while ((Child = (2 * Root) + 1) < RegionsCount) {
+    if ((Child + 1 < RegionsCount) && MemoryRegionIsAbove (&Regions[Child + 1], &Regions[Child])) {
+      Child++;
+    }
+
+    if (!MemoryRegionIsAbove (&Regions[Child], &Region)) {
+      break;
+    }
+
+    Regions[Root] = Regions[Child];
+    Root          = Child;
+  }
+
+  Regions[Root] = Region;
+}
+
+/**
+  In-place heap sort to sort regions entries in ascending order.
+
+  Retired DRAM pages can add thousands of carveouts, so the sort must not be
+  quadratic and cannot allocate memory this early in boot.
 
   @param Regions [IN, OUT]    Array of regions to sort
   @param RegionsCount [IN]    Number of regions in array
@@ -108,25 +174,69 @@ MemoryRegionSort (
   IN UINTN                   RegionsCount
   )
 {
-  EFI_PHYSICAL_ADDRESS  Address   = 0;
-  UINTN                 Length    = 0;
-  INT32                 PrevIndex = 0;
-  INT32                 Index     = 0;
-
-  for (Index = 1; Index < RegionsCount; Index++) {
-    PrevIndex = Index - 1;
-    Address   = Regions[Index].MemoryBaseAddress;
-    Length    = Regions[Index].MemoryLength;
-
-    while ((PrevIndex >= 0) && (Regions[PrevIndex].MemoryBaseAddress > Address)) {
-      Regions[PrevIndex + 1].MemoryBaseAddress = Regions[PrevIndex].MemoryBaseAddress;
-      Regions[PrevIndex + 1].MemoryLength      = Regions[PrevIndex].MemoryLength;
-      PrevIndex                               -= 1;
+  NVDA_MEMORY_REGION  Region;
+  UINTN               Index;
+
+  if (RegionsCount < 2) {
+    return;
+  }
+
+  for (Index = RegionsCount / 2; Index > 0; Index--) {
+    MemoryRegionSiftDown (Regions, Index - 1, RegionsCount);
+  }
+
+  for (Index = RegionsCount - 1; Index > 0; Index--) {
+    Region         = Regions[0];
+    Regions[0]     = Regions[Index];
+    Regions[Index] = Region;
+    MemoryRegionSiftDown (Regions, 0, Index);
+  }
+}
+
+/**
+  Merge overlapping and adjacent regions of a sorted array in place and drop
+  empty regions.
+
+  @param Regions [IN, OUT]    Sorted array of regions
+  @param RegionsCount [IN]    Number of regions in array
+
+  @retval Number of regions left in array
+**/
+STATIC
+UINTN
+MemoryRegionCoalesce (
+  IN OUT NVDA_MEMORY_REGION  *Regions,
+  IN UINTN                   RegionsCount
+  )
+{
+  UINTN                 Index;
+  UINTN                 Count;
+  EFI_PHYSICAL_ADDRESS  End;
+  EFI_PHYSICAL_ADDRESS  RegionEnd;
+
+  Count = 0;
+  End   = 0;
+  for (Index = 0; Index < RegionsCount; Index++) {
+    if (Regions[Index].MemoryLength == 0) {
+      continue;
+    }
+
+    RegionEnd = Regions[Index].MemoryBaseAddress + Regions[Index].MemoryLength;
+    if ((Count > 0) && (Regions[Index].MemoryBaseAddress <= End)) {
+      if (RegionEnd > End) {
+        End                             = RegionEnd;
+        Regions[Count - 1].MemoryLength = End - Regions[Count - 1].MemoryBaseAddress;
+      }
+
+      continue;
     }
 
-    Regions[PrevIndex + 1].MemoryBaseAddress = Address;
-    Regions[PrevIndex + 1].MemoryLength      = Length;
+    Regions[Count] = Regions[Index];
+    End            = RegionEnd;
+    Count++;
   }
+
+  return Count;
 }
 
 /**
@@ -136,11 +246,11 @@ MemoryRegionSort (
   removing the carveout regions.
   This function is called by the platform memory initialization library.
 
-  @param  DramRegions              Sorted list of available DRAM regions
+  @param  DramRegions              List of available DRAM regions, sorted in place.
   @param  DramRegionsCount         Number of regions in DramRegions.
-  @param  UefiDramRegionIndex      Index of uefi usable regions in DramRegions.
-  @param  CarveoutRegions          Sorted list of carveout regions that will be
-                                   removed from DramRegions.
+  @param  UefiDramRegionIndex      Index of uefi usable regions in sorted DramRegions.
+  @param  CarveoutRegions          List of carveout regions that will be removed
+                                   from DramRegions, sorted and merged in place.
   @param  CarveoutRegionsCount     Number of regions in CarveoutRegions.
   @param  FinalRegionsCount        Number of regions installed into HOB list.
 
@@ -182,6 +292,7 @@ InstallDramWithCarveouts (
   DramIndex = 0;
 
   MemoryRegionSort (CarveoutRegions, CarveoutRegionsCount);
+  CarveoutRegionsCount = MemoryRegionCoalesce (CarveoutRegions, CarveoutRegionsCount);
   for (CarveoutIndex = 0; CarveoutIndex < CarveoutRegionsCount; CarveoutIndex++) {
     DEBUG ((
       EFI_D_VERBOSE,
@@ -0,0 +1,494 @@
+/** @file
+
+  DRAM Carveout Library Unit Test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <PiPei.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DramCarveoutLib.h>
+#include <Library/HobLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrePiHobListPointerLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "DRAM Carveout Lib Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_PAGE_SIZE          SIZE_64KB
+#define TEST_UEFI_REGION_SIZE   SIZE_64KB
+#define TEST_DRAM_BASE          0x800000000000ULL
+#define TEST_DRAM_SIZE          SIZE_2GB
+#define TEST_DRAM_GAP           SIZE_2GB
+#define TEST_DRAM_PAGES         (TEST_DRAM_SIZE / TEST_PAGE_SIZE)
+#define TEST_RETIRED_PAGES      (16 * 1024)
+#define TEST_OEM_CARVEOUTS      3
+#define TEST_MAX_HOBS           (2 * TEST_RETIRED_PAGES)
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    Base;
+  UINT64                  Length;
+} TEST_RESOURCE;
+
+STATIC TEST_RESOURCE  mResources[TEST_MAX_HOBS];
+STATIC UINTN          mResourceCount;
+STATIC VOID           *mUefiRegion;
+STATIC UINT32         mRandom;
+
+// Region comparisons made by the library sort
+extern UINTN  mDramCarveoutSortCompares;
+
+/**
+  Record resource descriptor HOBs instead of building them.
+
+  @param[in]  ResourceType        The type of resource described by this HOB.
+  @param[in]  ResourceAttribute   The resource attributes of the memory described by this HOB.
+  @param[in]  PhysicalStart       The 64 bit physical address of memory described by this HOB.
+  @param[in]  NumberOfBytes       The length of the memory described by this HOB in bytes.
+
+**/
+VOID
+EFIAPI
+__wrap_BuildResourceDescriptorHob (
+  IN EFI_RESOURCE_TYPE            ResourceType,
+  IN EFI_RESOURCE_ATTRIBUTE_TYPE  ResourceAttribute,
+  IN EFI_PHYSICAL_ADDRESS         PhysicalStart,
+  IN UINT64                       NumberOfBytes
+  )
+{
+  if (mResourceCount < TEST_MAX_HOBS) {
+    mResources[mResourceCount].Base   = PhysicalStart;
+    mResources[mResourceCount].Length = NumberOfBytes;
+  }
+
+  mResourceCount++;
+}
+
+/**
+  Find the next HOB of a type in the test HOB list.
+
+  @param[in]  Type      The HOB type to return.
+  @param[in]  HobStart  The starting HOB pointer to search from.
+
+  @return The next instance of a HOB type from the starting HOB, or NULL.
+
+**/
+VOID *
+EFIAPI
+__wrap_GetNextHob (
+  IN UINT16      Type,
+  IN CONST VOID  *HobStart
+  )
+{
+  EFI_PEI_HOB_POINTERS  Hob;
+
+  Hob.Raw = (UINT8 *)HobStart;
+  while (!END_OF_HOB_LIST (Hob)) {
+    if (Hob.Header->HobType == Type) {
+      return Hob.Raw;
+    }
+
+    Hob.Raw = GET_NEXT_HOB (Hob);
+  }
+
+  return NULL;
+}
+
+/**
+  Simple pseudo-random number generator, so runs are reproducible.
+
+  @retval Next pseudo-random number
+**/
+STATIC
+UINT32
+TestRandom (
+  VOID
+  )
+{
+  mRandom = (mRandom * 1103515245) + 12345;
+  return mRandom >> 8;
+}
+
+/**
+  Insertion sort, as the library used to sort regions.
+
+  @param[in, out] Regions       Array of regions to sort
+  @param[in]      RegionsCount  Number of regions in array
+
+  @retval Number of region comparisons made
+**/
+STATIC
+UINT64
+ReferenceSort (
+  IN OUT NVDA_MEMORY_REGION  *Regions,
+  IN UINTN                   RegionsCount
+  )
+{
+  NVDA_MEMORY_REGION  Region;
+  UINTN               Index;
+  UINTN               Prev;
+  UINT64              Compares;
+
+  Compares = 0;
+  for (Index = 1; Index < RegionsCount; Index++) {
+    Region = Regions[Index];
+    for (Prev = Index; Prev > 0; Prev--) {
+      Compares++;
+      if (Regions[Prev - 1].MemoryBaseAddress <= Region.MemoryBaseAddress) {
+        break;
+      }
+
+      Regions[Prev] = Regions[Prev - 1];
+    }
+
+    Regions[Prev] = Region;
+  }
+
+  return Compares;
+}
+
+/**
+  Create a HOB list in the UEFI region and reset the recorded resources.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DramCarveoutTestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_HOB_HANDOFF_INFO_TABLE  *HandOff;
+  EFI_HOB_GENERIC_HEADER      *End;
+  EFI_PHYSICAL_ADDRESS        Base;
+
+  if (mUefiRegion == NULL) {
+    mUefiRegion = AllocatePool (TEST_UEFI_REGION_SIZE);
+    UT_ASSERT_NOT_NULL (mUefiRegion);
+  }
+
+  ZeroMem (mUefiRegion, TEST_UEFI_REGION_SIZE);
+  Base    = (EFI_PHYSICAL_ADDRESS)(UINTN)mUefiRegion;
+  HandOff = (EFI_HOB_HANDOFF_INFO_TABLE *)mUefiRegion;
+  End     = (EFI_HOB_GENERIC_HEADER *)(HandOff + 1);
+
+  HandOff->Header.HobType      = EFI_HOB_TYPE_HANDOFF;
+  HandOff->Header.HobLength    = sizeof (*HandOff);
+  HandOff->EfiMemoryBottom     = Base;
+  HandOff->EfiMemoryTop        = Base + TEST_UEFI_REGION_SIZE;
+  HandOff->EfiFreeMemoryTop    = Base + TEST_UEFI_REGION_SIZE;
+  HandOff->EfiFreeMemoryBottom = (EFI_PHYSICAL_ADDRESS)(UINTN)(End + 1);
+  HandOff->EfiEndOfHobList     = (EFI_PHYSICAL_ADDRESS)(UINTN)End;
+  End->HobType                 = EFI_HOB_TYPE_END_OF_HOB_LIST;
+  End->HobLength               = sizeof (*End);
+  PrePeiSetHobList (HandOff);
+
+  mResourceCount = 0;
+  mRandom        = 0x5eed;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the recorded resources against an expected list.
+
+  @param[in]  Expected        Expected resources
+  @param[in]  ExpectedCount   Number of expected resources
+
+**/
+STATIC
+UNIT_TEST_STATUS
+DramCarveoutCheckResources (
+  IN CONST TEST_RESOURCE  *Expected,
+  IN UINTN                ExpectedCount
+  )
+{
+  UINTN  Index;
+
+  UT_ASSERT_EQUAL (mResourceCount, ExpectedCount);
+  for (Index = 0; Index < ExpectedCount; Index++) {
+    UT_ASSERT_EQUAL (mResources[Index].Base, Expected[Index].Base);
+    UT_ASSERT_EQUAL (mResources[Index].Length, Expected[Index].Length);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Overlapping, adjacent, empty and region spanning carveouts.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DramCarveoutOverlapping (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NVDA_MEMORY_REGION    Dram[3];
+  NVDA_MEMORY_REGION    Carveouts[7];
+  TEST_RESOURCE         Expected[5];
+  EFI_PHYSICAL_ADDRESS  A;
+  EFI_PHYSICAL_ADDRESS  B;
+  UINTN                 Count;
+
+  A = TEST_DRAM_BASE;
+  B = TEST_DRAM_BASE + SIZE_1GB;
+
+  // listed out of order, the UEFI region sorts first
+  Dram[0].MemoryBaseAddress = B;
+  Dram[0].MemoryLength      = SIZE_16MB;
+  Dram[1].MemoryBaseAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)mUefiRegion;
+  Dram[1].MemoryLength      = TEST_UEFI_REGION_SIZE;
+  Dram[2].MemoryBaseAddress = A;
+  Dram[2].MemoryLength      = SIZE_16MB;
+
+  // overlapping pair, adjacent pair and an empty carveout in A
+  Carveouts[0].MemoryBaseAddress = A + SIZE_2MB;
+  Carveouts[0].MemoryLength      = SIZE_2MB;
+  Carveouts[1].MemoryBaseAddress = A + SIZE_1MB;
+  Carveouts[1].MemoryLength      = SIZE_2MB;
+  Carveouts[2].MemoryBaseAddress = A + SIZE_8MB + SIZE_1MB;
+  Carveouts[2].MemoryLength      = SIZE_1MB;
+  Carveouts[3].MemoryBaseAddress = A + SIZE_8MB;
+  Carveouts[3].MemoryLength      = SIZE_1MB;
+  Carveouts[4].MemoryBaseAddress = A + SIZE_4MB + SIZE_2MB;
+  Carveouts[4].MemoryLength      = 0;
+
+  // carveout from the end of A into the gap, and one covering the start of B
+  Carveouts[5].MemoryBaseAddress = A + SIZE_16MB - SIZE_1MB;
+  Carveouts[5].MemoryLength      = SIZE_2MB;
+  Carveouts[6].MemoryBaseAddress = B - SIZE_1MB;
+  Carveouts[6].MemoryLength      = SIZE_4MB;
+
+  Expected[0].Base   = (EFI_PHYSICAL_ADDRESS)(UINTN)mUefiRegion;
+  Expected[0].Length = TEST_UEFI_REGION_SIZE;
+  Expected[1].Base   = A;
+  Expected[1].Length = SIZE_1MB;
+  Expected[2].Base   = A + SIZE_4MB;
+  Expected[2].Length = SIZE_4MB;
+  Expected[3].Base   = A + SIZE_8MB + SIZE_2MB;
+  Expected[3].Length = SIZE_4MB + SIZE_1MB;
+  Expected[4].Base   = B + SIZE_2MB + SIZE_1MB;
+  Expected[4].Length = SIZE_16MB - SIZE_2MB - SIZE_1MB;
+
+  Count = 0;
+  UT_ASSERT_NOT_EFI_ERROR (InstallDramWithCarveouts (Dram, ARRAY_SIZE (Dram), 0, Carveouts, ARRAY_SIZE (Carveouts), &Count));
+  UT_ASSERT_EQUAL (Count, ARRAY_SIZE (Expected));
+  UT_ASSERT_TRUE (PrePeiGetHobList () == mUefiRegion);
+
+  return DramCarveoutCheckResources (Expected, ARRAY_SIZE (Expected));
+}
+
+/**
+  16K randomly retired pages and OEM carveouts over two DRAM regions, checked
+  against a page map.  The region comparisons of the install must stay within
+  the 2 n log2 n bound of a heap sort, which the insertion sort the library
+  used exceeds.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DramCarveoutRetiredPages (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  NVDA_MEMORY_REGION    Dram[3];
+  NVDA_MEMORY_REGION    *Carveouts;
+  NVDA_MEMORY_REGION    *Reference;
+  UINT8                 *Retired;
+  TEST_RESOURCE         *Expected;
+  UINTN                 ExpectedCount;
+  UINTN                 CarveoutCount;
+  UINTN                 Count;
+  UINTN                 Page;
+  UINTN                 Index;
+  EFI_PHYSICAL_ADDRESS  Base;
+  UINT64                RegionCount;
+  UINT64                CompareBound;
+  UINT64                ReferenceCompares;
+  UNIT_TEST_STATUS      TestStatus;
+
+  Dram[0].MemoryBaseAddress = TEST_DRAM_BASE + TEST_DRAM_SIZE + TEST_DRAM_GAP;
+  Dram[0].MemoryLength      = TEST_DRAM_SIZE;
+  Dram[1].MemoryBaseAddress = TEST_DRAM_BASE;
+  Dram[1].MemoryLength      = TEST_DRAM_SIZE;
+  Dram[2].MemoryBaseAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)mUefiRegion;
+  Dram[2].MemoryLength      = TEST_UEFI_REGION_SIZE;
+
+  CarveoutCount = TEST_RETIRED_PAGES + TEST_OEM_CARVEOUTS;
+  Carveouts     = AllocatePool (CarveoutCount * sizeof (NVDA_MEMORY_REGION));
+  Reference     = AllocatePool (CarveoutCount * sizeof (NVDA_MEMORY_REGION));
+  Retired       = AllocateZeroPool (2 * TEST_DRAM_PAGES);
+  Expected      = AllocatePool (TEST_MAX_HOBS * sizeof (TEST_RESOURCE));
+  UT_ASSERT_NOT_NULL (Carveouts);
+  UT_ASSERT_NOT_NULL (Reference);
+  UT_ASSERT_NOT_NULL (Retired);
+  UT_ASSERT_NOT_NULL (Expected);
+
+  // random retired pages over both regions, repeats allowed
+  for (Index = 0; Index < TEST_RETIRED_PAGES; Index++) {
+    Page          = TestRandom () % (2 * TEST_DRAM_PAGES);
+    Retired[Page] = 1;
+    Base          = TEST_DRAM_BASE + (Page * TEST_PAGE_SIZE);
+    if (Page >= TEST_DRAM_PAGES) {
+      Base += TEST_DRAM_GAP;
+    }
+
+    Carveouts[Index].MemoryBaseAddress = Base;
+    Carveouts[Index].MemoryLength      = TEST_PAGE_SIZE;
+  }
+
+  // OEM carveouts spanning the end of the first region, in the gap, and
+  // covering retired pages in the second region
+  Carveouts[Index].MemoryBaseAddress = TEST_DRAM_BASE + TEST_DRAM_SIZE - SIZE_16MB;
+  Carveouts[Index].MemoryLength      = SIZE_32MB;
+  Index++;
+  Carveouts[Index].MemoryBaseAddress = TEST_DRAM_BASE + TEST_DRAM_SIZE + SIZE_1GB;
+  Carveouts[Index].MemoryLength      = SIZE_64MB;
+  Index++;
+  Carveouts[Index].MemoryBaseAddress = Dram[0].MemoryBaseAddress + SIZE_256MB;
+  Carveouts[Index].MemoryLength      = SIZE_64MB;
+
+  for (Page = TEST_DRAM_PAGES - (SIZE_16MB / TEST_PAGE_SIZE); Page < TEST_DRAM_PAGES; Page++) {
+    Retired[Page] = 1;
+  }
+
+  for (Page = 0; Page < SIZE_64MB / TEST_PAGE_SIZE; Page++) {
+    Retired[TEST_DRAM_PAGES + (SIZE_256MB / TEST_PAGE_SIZE) + Page] = 1;
+  }
+
+  // expected map is the UEFI region, then the free page runs of each region
+  Expected[0].Base   = (EFI_PHYSICAL_ADDRESS)(UINTN)mUefiRegion;
+  Expected[0].Length = TEST_UEFI_REGION_SIZE;
+  ExpectedCount      = 1;
+  for (Page = 0; Page < 2 * TEST_DRAM_PAGES; Page++) {
+    if (Retired[Page]) {
+      continue;
+    }
+
+    Base = TEST_DRAM_BASE + (Page * TEST_PAGE_SIZE);
+    if (Page >= TEST_DRAM_PAGES) {
+      Base += TEST_DRAM_GAP;
+    }
+
+    if ((Page % TEST_DRAM_PAGES != 0) && !Retired[Page - 1]) {
+      Expected[ExpectedCount - 1].Length += TEST_PAGE_SIZE;
+    } else {
+      UT_ASSERT_TRUE (ExpectedCount < TEST_MAX_HOBS);
+      Expected[ExpectedCount].Base   = Base;
+      Expected[ExpectedCount].Length = TEST_PAGE_SIZE;
+      ExpectedCount++;
+    }
+  }
+
+  CopyMem (Reference, Carveouts, CarveoutCount * sizeof (NVDA_MEMORY_REGION));
+  ReferenceCompares = ReferenceSort (Reference, CarveoutCount);
+
+  Count                     = 0;
+  mDramCarveoutSortCompares = 0;
+  UT_ASSERT_NOT_EFI_ERROR (InstallDramWithCarveouts (Dram, ARRAY_SIZE (Dram), 0, Carveouts, CarveoutCount, &Count));
+
+  // DRAM and carveout regions are sorted separately, both within the bound of all regions
+  RegionCount  = CarveoutCount + ARRAY_SIZE (Dram);
+  CompareBound = 2 * RegionCount * (HighBitSet64 (RegionCount) + 1);
+
+  UT_LOG_INFO (
+    "%u carveouts, %u regions: %lu compares, bound %lu, insertion sort %lu\n",
+    CarveoutCount,
+    Count,
+    (UINT64)mDramCarveoutSortCompares,
+    CompareBound,
+    ReferenceCompares
+    );
+
+  UT_ASSERT_TRUE (mDramCarveoutSortCompares <= CompareBound);
+  UT_ASSERT_TRUE (ReferenceCompares > CompareBound);
+
+  UT_ASSERT_EQUAL (Count, ExpectedCount);
+  TestStatus = DramCarveoutCheckResources (Expected, ExpectedCount);
+
+  FreePool (Carveouts);
+  FreePool (Reference);
+  FreePool (Retired);
+  FreePool (Expected);
+
+  return TestStatus;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  DRAM carveout library and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      DramCarveoutTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&DramCarveoutTests, Framework, "DRAM Carveout Lib Tests", "UnitTest.DramCarveoutLib", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for DRAM Carveout Lib Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    return Status;
+  }
+
+  AddTestCase (DramCarveoutTests, "Overlapping and adjacent carveouts", "Overlapping", DramCarveoutOverlapping, DramCarveoutTestSetup, NULL, NULL);
+  AddTestCase (DramCarveoutTests, "16K retired pages", "RetiredPages", DramCarveoutRetiredPages, DramCarveoutTestSetup, NULL, NULL);
+
+  // Execute the tests.
+  Status = RunAllTestSuites (Framework);
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
@@ -51,9 +51,11 @@
 #define EROT_RX_MEM_START  0x0000
 #define EROT_TX_MEM_START  0x8000
 
-#define EROT_MEM_MAX_BYTES_PER_XFER     32
-#define EROT_MEM_BYTES_PER_SINGLE_READ  4
+// block commands encode the block count - 1 in the low 5 bits
 #define EROT_MEM_BLOCK_SIZE             4
+#define EROT_MEM_MAX_BLOCKS_PER_XFER    32
+#define EROT_MEM_MAX_BYTES_PER_XFER     (EROT_MEM_MAX_BLOCKS_PER_XFER * EROT_MEM_BLOCK_SIZE)
+#define EROT_MEM_MIN_BYTES_PER_XFER     32
 
 // commands
 #define EROT_CMD_SREG_W8   0x09
@@ -817,6 +819,10 @@ ErotQspiDoWriteMemCommand (
 /**
   Write erot memory.
 
+  Data is sent in bursts of up to the negotiated burst size.  A partial
+  block at the end is padded, the erot only consumes the number of bytes
+  given in its mailbox.
+
   @param[in]  Private       Pointer to private structure for erot.
   @param[in]  Offset        Offset in erot Rx buffer to write.
   @param[in]  Bytes         Number of bytes to write.
@@ -838,43 +844,41 @@ ErotQspiWriteMem (
 {
   EROT_QSPI_WRITE_MEM_TX  Tx;
   CONST UINT8             *Payload;
+  UINT8                   Block[EROT_MEM_BLOCK_SIZE];
   UINT32                  XferBytes;
   UINT32                  XferOffset;
+  UINT32                  BlockBytes;
   UINTN                   Index;
+  EFI_STATUS              Status;
 
   ErotQspiPrintBuffer (__FUNCTION__, Data, Bytes);
 
+  if ((Offset % EROT_MEM_BLOCK_SIZE) != 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
   Payload    = (CONST UINT8 *)Data;
   XferOffset = 0;
   while (Bytes > 0) {
-    XferBytes = (Bytes > EROT_MEM_MAX_BYTES_PER_XFER) ?
-                EROT_MEM_MAX_BYTES_PER_XFER : Bytes;
-    if (XferBytes >= EROT_MEM_BLOCK_SIZE) {
-      XferBytes &= ~(EROT_MEM_BLOCK_SIZE - 1);
-      Tx.Cmd     = EROT_CMD_MEM_BLK_W1 + (XferBytes / EROT_MEM_BLOCK_SIZE - 1);
-      MctpUint16ToBEBuffer (Tx.Addr, Offset + XferOffset);
-      for (Index = 0; Index < XferBytes; Index += EROT_MEM_BLOCK_SIZE) {
-        ErotQSpiCopyAndReverseBuffer (&Tx.Data[Index], &Payload[XferOffset + Index], EROT_MEM_BLOCK_SIZE);
-      }
+    XferBytes  = MIN (Bytes, Private->MemBurstBytes);
+    BlockBytes = ALIGN_VALUE (XferBytes, EROT_MEM_BLOCK_SIZE);
+
+    Tx.Cmd = EROT_CMD_MEM_BLK_W1 + (BlockBytes / EROT_MEM_BLOCK_SIZE - 1);
+    MctpUint16ToBEBuffer (Tx.Addr, Offset + XferOffset);
+    for (Index = 0; Index < BlockBytes; Index += EROT_MEM_BLOCK_SIZE) {
+      ZeroMem (Block, sizeof (Block));
+      CopyMem (Block, &Payload[XferOffset + Index], MIN (XferBytes - Index, EROT_MEM_BLOCK_SIZE));
+      ErotQSpiCopyAndReverseBuffer (&Tx.Data[Index], Block, EROT_MEM_BLOCK_SIZE);
+    }
 
-      DEBUG ((DEBUG_VERBOSE, "%a: writing %u bytes\n", __FUNCTION__, XferBytes));
-      ErotQspiDoWriteMemCommand (
-        Private,
-        OFFSET_OF (EROT_QSPI_WRITE_MEM_TX, Data) + XferBytes,
-        &Tx
-        );
-    } else {
-      for (Index = 0; Index < XferBytes; Index++) {
-        DEBUG ((DEBUG_VERBOSE, "%a: writing single byte\n", __FUNCTION__));
-        Tx.Cmd = EROT_CMD_MEM_W8;
-        MctpUint16ToBEBuffer (Tx.Addr, Offset + XferOffset + Index);
-        Tx.Data[0] = Payload[XferOffset + Index];
-        ErotQspiDoWriteMemCommand (
-          Private,
-          OFFSET_OF (EROT_QSPI_WRITE_MEM_TX, Data) + 1,
-          &Tx
-          );
-      }
+    DEBUG ((DEBUG_VERBOSE, "%a: writing %u bytes\n", __FUNCTION__, XferBytes));
+    Status = ErotQspiDoWriteMemCommand (
+               Private,
+               OFFSET_OF (EROT_QSPI_WRITE_MEM_TX, Data) + BlockBytes,
+               &Tx
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
     }
 
     XferOffset += XferBytes;
@@ -888,8 +892,12 @@ ErotQspiWriteMem (
   Do erot read memory command.
 
   @param[in]  Private       Pointer to private structure for erot.
+  @param[in]  Cmd1          Read memory command.
+  @param[in]  Cmd2          Read FIFO command.
+  @param[in]  Addr          Erot memory address.
   @param[in]  Bytes         Number of bytes to read from erot.
   @param[in]  Buffer        Pointer to store data from erot.
+  @param[out] ReadDone      Pointer to return if erot reported the read done. OPTIONAL
 
   @retval EFI_SUCCESS       Operation completed normally.
   @retval Others            Failure occurred.
@@ -904,7 +912,8 @@ ErotQspiDoReadMemCommand (
   IN UINT8                   Cmd2,
   IN UINT16                  Addr,
   IN UINT32                  Bytes,
-  OUT VOID                   *Buffer
+  OUT VOID                   *Buffer,
+  OUT BOOLEAN                *ReadDone OPTIONAL
   )
 {
   EROT_QSPI_READ_MEM_TX   ReadMemTx;
@@ -946,6 +955,10 @@ ErotQspiDoReadMemCommand (
     DEBUG ((DEBUG_ERROR, "%a: Got bad FIFO read status: 0x%x\n", __FUNCTION__, MctpBEBufferToUint16 (ReadFifoRx.Status)));
   }
 
+  if (ReadDone != NULL) {
+    *ReadDone = ((MctpBEBufferToUint16 (ReadFifoRx.Status) & EROT_SPI_STATUS_MEM_READ_DONE) != 0);
+  }
+
   CopyMem (Buffer, ReadFifoRx.Data, Bytes);
 
   // write memory read done bit to clear it
@@ -955,6 +968,9 @@ ErotQspiDoReadMemCommand (
 /**
   Read erot memory.
 
+  Data is read in bursts of up to the negotiated burst size.  A partial
+  block at the end is read as a whole block.
+
   @param[in]  Private       Pointer to private structure for erot.
   @param[in]  Offset        Offset in erot Tx buffer to read.
   @param[in]  Bytes         Number of bytes to read.
@@ -975,55 +991,45 @@ ErotQspiReadMem (
   )
 {
   UINT8       Buffer[EROT_MEM_MAX_BYTES_PER_XFER];
+  UINT8       Block[EROT_MEM_BLOCK_SIZE];
   UINT32      XferOffset;
   UINT32      XferBytes;
+  UINT32      BlockBytes;
+  UINT32      Blocks;
   UINTN       Index;
   EFI_STATUS  Status;
   UINT8       *Payload;
   UINT32      BytesRequested;
 
+  if ((Offset % EROT_MEM_BLOCK_SIZE) != 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
   BytesRequested = Bytes;
   Payload        = (UINT8 *)Data;
   XferOffset     = 0;
   while (Bytes > 0) {
-    XferBytes = (Bytes > EROT_MEM_MAX_BYTES_PER_XFER) ?
-                EROT_MEM_MAX_BYTES_PER_XFER : Bytes;
-    if (XferBytes >= EROT_MEM_BLOCK_SIZE) {
-      XferBytes &= ~(EROT_MEM_BLOCK_SIZE - 1);
-
-      DEBUG ((DEBUG_VERBOSE, "%a: Reading %u bytes\n", __FUNCTION__, XferBytes));
-      Status = ErotQspiDoReadMemCommand (
-                 Private,
-                 EROT_CMD_MEM_BLK_R1 + ((XferBytes / EROT_MEM_BLOCK_SIZE) - 1),
-                 EROT_CMD_BLK_RD_FIFO_FSR + ((XferBytes / EROT_MEM_BLOCK_SIZE) - 1),
-                 Offset + XferOffset,
-                 XferBytes,
-                 Buffer
-                 );
-      if (EFI_ERROR (Status)) {
-        return Status;
-      }
+    XferBytes  = MIN (Bytes, Private->MemBurstBytes);
+    BlockBytes = ALIGN_VALUE (XferBytes, EROT_MEM_BLOCK_SIZE);
+    Blocks     = BlockBytes / EROT_MEM_BLOCK_SIZE;
+
+    DEBUG ((DEBUG_VERBOSE, "%a: Reading %u bytes\n", __FUNCTION__, XferBytes));
+    Status = ErotQspiDoReadMemCommand (
+               Private,
+               EROT_CMD_MEM_BLK_R1 + (Blocks - 1),
+               EROT_CMD_BLK_RD_FIFO_FSR + (Blocks - 1),
+               Offset + XferOffset,
+               BlockBytes,
+               Buffer,
+               NULL
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
 
-      for (Index = 0; Index < XferBytes; Index += EROT_MEM_BLOCK_SIZE) {
-        ErotQSpiCopyAndReverseBuffer (&Payload[XferOffset + Index], &Buffer[Index], EROT_MEM_BLOCK_SIZE);
-      }
-    } else {
-      for (Index = 0; Index < XferBytes; Index++) {
-        DEBUG ((DEBUG_VERBOSE, "%a: Reading single byte\n", __FUNCTION__));
-        Status = ErotQspiDoReadMemCommand (
-                   Private,
-                   EROT_CMD_MEM_R8,
-                   EROT_CMD_RD_SNGL_FIFO8_FSR,
-                   Offset + XferOffset + Index,
-                   EROT_MEM_BYTES_PER_SINGLE_READ,
-                   Buffer
-                   );
-        if (EFI_ERROR (Status)) {
-          return Status;
-        }
-
-        Payload[XferOffset + Index] = Buffer[EROT_MEM_BYTES_PER_SINGLE_READ - 1];
-      }
+    for (Index = 0; Index < BlockBytes; Index += EROT_MEM_BLOCK_SIZE) {
+      ErotQSpiCopyAndReverseBuffer (Block, &Buffer[Index], EROT_MEM_BLOCK_SIZE);
+      CopyMem (&Payload[XferOffset + Index], Block, MIN (XferBytes - Index, EROT_MEM_BLOCK_SIZE));
     }
 
     XferOffset += XferBytes;
@@ -1035,6 +1041,59 @@ ErotQspiReadMem (
   return EFI_SUCCESS;
 }
 
+/**
+  Find the largest memory burst the erot supports.  Bursts are probed by
+  reading the erot Tx buffer, which has no side effects, starting from the
+  largest useful burst the block commands can encode.
+
+  @param[in]  Private       Pointer to private structure for erot.
+
+  @retval UINT32            Burst size in bytes.
+
+**/
+STATIC
+UINT32
+EFIAPI
+ErotQspiNegotiateMemBurst (
+  IN EROT_QSPI_PRIVATE_DATA  *Private
+  )
+{
+  UINT8       Buffer[EROT_MEM_MAX_BYTES_PER_XFER];
+  UINT32      Bytes;
+  UINT32      Blocks;
+  BOOLEAN     ReadDone;
+  EFI_STATUS  Status;
+
+  // nothing is gained from bursts longer than a packet
+  Bytes = EROT_MEM_MAX_BYTES_PER_XFER;
+  while ((Bytes / 2 >= sizeof (EROT_QSPI_PACKET)) && (Bytes / 2 >= EROT_MEM_MIN_BYTES_PER_XFER)) {
+    Bytes /= 2;
+  }
+
+  for ( ; Bytes > EROT_MEM_MIN_BYTES_PER_XFER; Bytes /= 2) {
+    Blocks = Bytes / EROT_MEM_BLOCK_SIZE;
+    Status = ErotQspiDoReadMemCommand (
+               Private,
+               EROT_CMD_MEM_BLK_R1 + (Blocks - 1),
+               EROT_CMD_BLK_RD_FIFO_FSR + (Blocks - 1),
+               EROT_TX_MEM_START,
+               Bytes,
+               Buffer,
+               &ReadDone
+               );
+    if (!EFI_ERROR (Status) && ReadDone) {
+      break;
+    }
+
+    DEBUG ((DEBUG_INFO, "%a: %s %u byte burst unsupported: %r\n", __FUNCTION__, Private->Name, Bytes, Status));
+
+    // a failed probe may leave the erot interface in a bad state
+    ErotQspiSpbReset (Private);
+  }
+
+  return Bytes;
+}
+
 EFI_STATUS
 EFIAPI
 ErotQspiSendPacket (
@@ -1157,9 +1216,17 @@ ErotQspiSpbInit (
 {
   EFI_STATUS  Status;
 
+  Private->MemBurstBytes = EROT_MEM_MIN_BYTES_PER_XFER;
+
   Status = ErotQspiSpbReset (Private);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
 
-  return Status;
+  Private->MemBurstBytes = ErotQspiNegotiateMemBurst (Private);
+  DEBUG ((DEBUG_INFO, "%a: %s using %u byte bursts\n", __FUNCTION__, Private->Name, Private->MemBurstBytes));
+
+  return EFI_SUCCESS;
 }
 
 EFI_STATUS
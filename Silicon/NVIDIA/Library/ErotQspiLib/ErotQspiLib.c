@@ -103,10 +103,6 @@ ErotQspiWaitForInterrupt (
 
   while (!ErotQspiHasInterruptReq (Private)) {
     if (ErotQspiNsCounter () >= EndNs) {
-      if (TimeoutMs > 0) {
-        DEBUG ((DEBUG_ERROR, "%a: Timed out after %ums\n", __FUNCTION__, TimeoutMs));
-      }
-
       return EFI_TIMEOUT;
     }
   }
@@ -314,6 +310,7 @@ ErotQspiDoRequest (
                             &RecvMsgTag
                             );
   if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: %s response failed after %ums: %r\n", __FUNCTION__, Private->Name, QSPI_MCTP_MT2_MS_MAX, Status));
     return Status;
   }
 
@@ -0,0 +1,468 @@
+/** @file
+
+  Erot Qspi library unit test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ErotQspiLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../ErotQspiCore.h"
+
+#define UNIT_TEST_NAME     "Erot Qspi Lib Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define SIM_MEM_SIZE  0x10000
+
+#define SIM_EROT_MBOX  0x44
+#define SIM_HOST_MBOX  0x48
+
+#define SIM_HOST_MBOX_ACK      0x01000000
+#define SIM_MBOX_CMD_MASK      0x0f000000
+#define SIM_MBOX_REQUEST_WRITE 0x02000000
+#define SIM_MBOX_READY_TO_READ 0x03000000
+#define SIM_MBOX_FINISHED_READ 0x04000000
+#define SIM_MBOX_REQUEST_RESET 0x05000000
+
+#define SIM_POLL_ALL_RX_FIFO_EMPTY      0x0100
+#define SIM_POLL_ALL_TX_FIFO_NOT_EMPTY  0x0400
+
+#define SIM_STATUS_MEM_READ_DONE  0x02
+
+#define SIM_RX_MEM_START  0x0000
+#define SIM_TX_MEM_START  0x8000
+
+//
+// Simulated erot SPB interface.  Block memory commands longer than MaxBurst
+// are not supported: writes are dropped and reads never fill the FIFO.
+//
+typedef struct {
+  NVIDIA_QSPI_CONTROLLER_PROTOCOL    Qspi;
+  EMBEDDED_GPIO                      Gpio;
+  UINT32                             MaxBurst;
+  UINT8                              Mem[SIM_MEM_SIZE];
+  UINT32                             HostMbox;
+  UINT8                              Received[sizeof (EROT_QSPI_PACKET)];
+  UINT32                             ReceivedLength;
+  UINT32                             ResponseLength;
+  UINT16                             ReadAddr;
+  UINT32                             ReadBytes;
+  BOOLEAN                            ReadFailed;
+  UINTN                              Transactions;
+  UINTN                              BusBytes;
+} SIM_EROT;
+
+STATIC SIM_EROT                mSim;
+STATIC EROT_QSPI_PRIVATE_DATA  mErot;
+STATIC UINT64                  mSimTime;
+
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  )
+{
+  return ++mSimTime;
+}
+
+UINT64
+EFIAPI
+GetTimeInNanoSecond (
+  IN UINT64  Ticks
+  )
+{
+  // each tick is a microsecond
+  return Ticks * 1000;
+}
+
+/**
+  Handle a write of the erot mailbox.
+
+  @param[in]  Value         Value written.
+
+**/
+STATIC
+VOID
+SimErotMbox (
+  IN UINT32  Value
+  )
+{
+  switch (Value & SIM_MBOX_CMD_MASK) {
+    case SIM_MBOX_REQUEST_RESET:
+    case SIM_MBOX_REQUEST_WRITE:
+    case SIM_MBOX_FINISHED_READ:
+      mSim.HostMbox = SIM_HOST_MBOX_ACK;
+      break;
+
+    case SIM_MBOX_READY_TO_READ:
+      mSim.HostMbox = mSim.ResponseLength;
+      break;
+
+    case 0:
+      mSim.ReceivedLength = Value;
+      CopyMem (mSim.Received, &mSim.Mem[SIM_RX_MEM_START], Value);
+      mSim.HostMbox = SIM_HOST_MBOX_ACK;
+      break;
+
+    default:
+      break;
+  }
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+SimPerformTransaction (
+  IN NVIDIA_QSPI_CONTROLLER_PROTOCOL  *This,
+  IN QSPI_TRANSACTION_PACKET          *Packet
+  )
+{
+  UINT8   *Tx;
+  UINT8   *Rx;
+  UINT8   Cmd;
+  UINT16  Addr;
+  UINT32  Bytes;
+  UINT32  Value;
+  UINTN   Index;
+
+  Tx  = Packet->TxBuf;
+  Rx  = Packet->RxBuf;
+  Cmd = Tx[0];
+
+  mSim.Transactions++;
+  mSim.BusBytes += Packet->TxLen + Packet->RxLen;
+
+  if (Cmd == 0x2F) {
+    Value = SIM_POLL_ALL_RX_FIFO_EMPTY;
+    if (mSim.ReadFailed) {
+      Value |= SIM_POLL_ALL_TX_FIFO_NOT_EMPTY;
+    }
+
+    MctpUint32ToBEBuffer (Rx, Value);
+    return EFI_SUCCESS;
+  }
+
+  Addr = (Packet->TxLen >= 3) ? MctpBEBufferToUint16 (&Tx[1]) : 0;
+  switch (Cmd) {
+    case 0x09:
+      ZeroMem (Rx, 2);
+      return EFI_SUCCESS;
+
+    case 0x0B:
+      if (Addr == SIM_EROT_MBOX) {
+        SimErotMbox (MctpBEBufferToUint32 (&Tx[3]));
+      }
+
+      ZeroMem (Rx, 2);
+      return EFI_SUCCESS;
+
+    case 0x0F:
+      ZeroMem (Rx, 2);
+      MctpUint32ToBEBuffer (&Rx[2], (Addr == SIM_HOST_MBOX) ? mSim.HostMbox : 0);
+      return EFI_SUCCESS;
+
+    default:
+      break;
+  }
+
+  Bytes = ((Cmd & 0x1F) + 1) * 4;
+  switch (Cmd & 0xE0) {
+    case 0x80:
+      if ((Bytes <= mSim.MaxBurst) && (Packet->TxLen == 3 + Bytes)) {
+        for (Index = 0; Index < Bytes; Index++) {
+          mSim.Mem[Addr + Index] = Tx[3 + (Index & ~3) + 3 - (Index & 3)];
+        }
+      }
+
+      return EFI_SUCCESS;
+
+    case 0xA0:
+      mSim.ReadAddr   = Addr;
+      mSim.ReadBytes  = Bytes;
+      mSim.ReadFailed = (Bytes > mSim.MaxBurst);
+      return EFI_SUCCESS;
+
+    case 0xE0:
+      if (mSim.ReadFailed || (Bytes != mSim.ReadBytes) || (Packet->RxLen != 2 + Bytes)) {
+        ZeroMem (Rx, Packet->RxLen);
+        return EFI_SUCCESS;
+      }
+
+      MctpUint16ToBEBuffer (Rx, SIM_STATUS_MEM_READ_DONE);
+      for (Index = 0; Index < Bytes; Index++) {
+        Rx[2 + (Index & ~3) + 3 - (Index & 3)] = mSim.Mem[mSim.ReadAddr + Index];
+      }
+
+      return EFI_SUCCESS;
+
+    default:
+      return EFI_DEVICE_ERROR;
+  }
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+SimGpioGet (
+  IN  EMBEDDED_GPIO      *This,
+  IN  EMBEDDED_GPIO_PIN  Gpio,
+  OUT UINTN              *Value
+  )
+{
+  // interrupt is active low and always asserted
+  *Value = 0;
+  return EFI_SUCCESS;
+}
+
+/**
+  Reset the simulated erot and initialize its spb interface.
+
+  @param[in]  MaxBurst      Largest memory burst the erot supports.
+
+  @retval EFI_SUCCESS       Interface initialized.
+  @retval Others            Failure occurred.
+
+**/
+STATIC
+EFI_STATUS
+SimInit (
+  IN UINT32  MaxBurst
+  )
+{
+  ZeroMem (&mSim, sizeof (mSim));
+  ZeroMem (&mErot, sizeof (mErot));
+  mSim.Qspi.PerformTransaction = SimPerformTransaction;
+  mSim.Gpio.Get                = SimGpioGet;
+  mSim.MaxBurst                = MaxBurst;
+
+  mErot.Signature     = EROT_QSPI_PRIVATE_DATA_SIGNATURE;
+  mErot.Qspi          = &mSim.Qspi;
+  mErot.Gpio.Protocol = &mSim.Gpio;
+  StrCpyS (mErot.Name, EROT_QSPI_NAME_LENGTH, L"SimErot");
+
+  return ErotQspiSpbInit (&mErot);
+}
+
+/**
+  Send a packet to the simulated erot and read back a response of the same
+  size.
+
+  @param[in]  Length        Packet length.
+
+  @retval UNIT_TEST_PASSED  Packets transferred intact.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+SimSendRecv (
+  IN UINTN  Length
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       Expected[sizeof (EROT_QSPI_PACKET)];
+  UINTN       RecvLength;
+  UINTN       Index;
+
+  for (Index = 0; Index < Length; Index++) {
+    ((UINT8 *)&mErot.Packet)[Index] = (UINT8)(Index * 7 + 1);
+  }
+
+  Status = ErotQspiSendPacket (&mErot, Length);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSim.ReceivedLength, Length);
+  UT_ASSERT_MEM_EQUAL (mSim.Received, &mErot.Packet, Length);
+
+  for (Index = 0; Index < Length; Index++) {
+    Expected[Index]                        = (UINT8)(Index * 13 + 5);
+    mSim.Mem[SIM_TX_MEM_START + Index] = Expected[Index];
+  }
+
+  mSim.ResponseLength = Length;
+  ZeroMem (&mErot.Packet, sizeof (mErot.Packet));
+
+  Status = ErotQspiRecvPacket (&mErot, &RecvLength);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (RecvLength, Length);
+  UT_ASSERT_MEM_EQUAL (&mErot.Packet, Expected, Length);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verify the burst size negotiated with erots of various capability.
+
+  @param[in]  Context       Unused.
+
+  @retval UNIT_TEST_PASSED  Test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BurstNegotiate (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UT_ASSERT_NOT_EFI_ERROR (SimInit (128));
+  UT_ASSERT_EQUAL (mErot.MemBurstBytes, 128);
+
+  UT_ASSERT_NOT_EFI_ERROR (SimInit (64));
+  UT_ASSERT_EQUAL (mErot.MemBurstBytes, 64);
+
+  UT_ASSERT_NOT_EFI_ERROR (SimInit (32));
+  UT_ASSERT_EQUAL (mErot.MemBurstBytes, 32);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verify packets of every length survive a round trip at each burst size.
+
+  @param[in]  Context       Unused.
+
+  @retval UNIT_TEST_PASSED  Test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PacketRoundTrip (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32            MaxBurst;
+  UINTN             Length;
+  UNIT_TEST_STATUS  TestStatus;
+
+  for (MaxBurst = 32; MaxBurst <= 128; MaxBurst *= 2) {
+    UT_ASSERT_NOT_EFI_ERROR (SimInit (MaxBurst));
+    for (Length = 1; Length <= sizeof (EROT_QSPI_PACKET); Length++) {
+      TestStatus = SimSendRecv (Length);
+      if (TestStatus != UNIT_TEST_PASSED) {
+        UT_LOG_INFO ("burst %u length %u failed\n", MaxBurst, Length);
+        return TestStatus;
+      }
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Compare the bus traffic of a full packet round trip with the smallest and
+  largest bursts.
+
+  @param[in]  Context       Unused.
+
+  @retval UNIT_TEST_PASSED  Test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BurstSpeedup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN             SmallTransactions;
+  UINTN             SmallBytes;
+  UNIT_TEST_STATUS  TestStatus;
+
+  UT_ASSERT_NOT_EFI_ERROR (SimInit (32));
+  mSim.Transactions = 0;
+  mSim.BusBytes     = 0;
+  TestStatus        = SimSendRecv (sizeof (EROT_QSPI_PACKET));
+  UT_ASSERT_EQUAL (TestStatus, UNIT_TEST_PASSED);
+  SmallTransactions = mSim.Transactions;
+  SmallBytes        = mSim.BusBytes;
+
+  UT_ASSERT_NOT_EFI_ERROR (SimInit (128));
+  mSim.Transactions = 0;
+  mSim.BusBytes     = 0;
+  TestStatus        = SimSendRecv (sizeof (EROT_QSPI_PACKET));
+  UT_ASSERT_EQUAL (TestStatus, UNIT_TEST_PASSED);
+
+  UT_LOG_INFO (
+    "%u byte round trip: 32 byte bursts %u transactions %u bytes, 128 byte bursts %u transactions %u bytes\n",
+    sizeof (EROT_QSPI_PACKET),
+    SmallTransactions,
+    SmallBytes,
+    mSim.Transactions,
+    mSim.BusBytes
+    );
+
+  // one write and one read burst instead of three of each
+  UT_ASSERT_TRUE (mSim.Transactions + 4 * 4 <= SmallTransactions);
+  UT_ASSERT_TRUE (mSim.BusBytes < SmallBytes);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the erot
+  spb interface and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SpbTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&SpbTests, Framework, "Erot Qspi SPB Tests", "UnitTest.ErotQspiSpb", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Erot Qspi SPB Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    return Status;
+  }
+
+  AddTestCase (SpbTests, "Largest supported burst is negotiated", "BurstNegotiate", BurstNegotiate, NULL, NULL, NULL);
+  AddTestCase (SpbTests, "Packets of every length round trip", "PacketRoundTrip", PacketRoundTrip, NULL, NULL, NULL);
+  AddTestCase (SpbTests, "Large bursts reduce bus traffic", "BurstSpeedup", BurstSpeedup, NULL, NULL, NULL);
+
+  // Execute the tests.
+  Status = RunAllTestSuites (Framework);
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
@@ -0,0 +1,239 @@
+/** @file
+
+  FMP image write scheduling
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include "FmpImageWrite.h"
+
+STATIC FMP_IMAGE_WRITE  *mWrites    = NULL;
+STATIC UINTN            mWriteCount = 0;
+
+/**
+  Start erasing ahead every image whose device is free.  An image whose
+  device is busy with another erase is retried later, an image whose erase
+  can't be started is written without erasing ahead.
+
+**/
+STATIC
+VOID
+EFIAPI
+FmpImageWriteStartErases (
+  VOID
+  )
+{
+  NVIDIA_FW_IMAGE_PROTOCOL  *FwImageProtocol;
+  EFI_STATUS                Status;
+  UINTN                     Index;
+
+  for (Index = 0; Index < mWriteCount; Index++) {
+    if (mWrites[Index].State != FmpImageWriteEraseAhead) {
+      continue;
+    }
+
+    FwImageProtocol = mWrites[Index].FwImageProtocol;
+    Status          = FwImageProtocol->EraseAsync (
+                                         FwImageProtocol,
+                                         0,
+                                         mWrites[Index].Bytes,
+                                         FW_IMAGE_RW_FLAG_NONE
+                                         );
+    if (Status == EFI_ALREADY_STARTED) {
+      continue;
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_INFO,
+        "%a: %s erase not started: %r\n",
+        __FUNCTION__,
+        FwImageProtocol->ImageName,
+        Status
+        ));
+      mWrites[Index].State = FmpImageWriteDirect;
+      continue;
+    }
+
+    mWrites[Index].State = FmpImageWriteErasing;
+  }
+}
+
+/**
+  Poll the erases running ahead during FmpImageWriteAll().  Called between
+  the chunks of an image write to keep the erases moving.  Does nothing
+  when no images are being written.
+
+**/
+VOID
+EFIAPI
+FmpImageWritePollErases (
+  VOID
+  )
+{
+  NVIDIA_FW_IMAGE_PROTOCOL  *FwImageProtocol;
+  EFI_STATUS                Status;
+  UINTN                     Index;
+
+  for (Index = 0; Index < mWriteCount; Index++) {
+    if (mWrites[Index].State != FmpImageWriteErasing) {
+      continue;
+    }
+
+    FwImageProtocol = mWrites[Index].FwImageProtocol;
+    Status          = FwImageProtocol->ErasePoll (FwImageProtocol, FW_IMAGE_RW_FLAG_NONE);
+    if (Status == EFI_NOT_READY) {
+      continue;
+    }
+
+    // a failed erase is returned by the image's write
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "%a: %s erase failed: %r\n",
+        __FUNCTION__,
+        FwImageProtocol->ImageName,
+        Status
+        ));
+    }
+
+    mWrites[Index].State = FmpImageWriteErased;
+  }
+}
+
+/**
+  Get the next image to write: an erased image first, else an image
+  written without erasing ahead.  While erases are running nothing else is
+  written.  With no erase running, an image still waiting for its busy
+  device is written without erasing ahead, which drops the reservation
+  left by an erase that isn't ours.
+
+  @retval UINTN                     Index of image to write, or mWriteCount
+                                    if erases are still running
+
+**/
+STATIC
+UINTN
+EFIAPI
+FmpImageWriteNext (
+  VOID
+  )
+{
+  UINTN    Index;
+  UINTN    Direct;
+  UINTN    Waiting;
+  BOOLEAN  Erasing;
+
+  Direct  = mWriteCount;
+  Waiting = mWriteCount;
+  Erasing = FALSE;
+  for (Index = 0; Index < mWriteCount; Index++) {
+    switch (mWrites[Index].State) {
+      case FmpImageWriteErased:
+        return Index;
+
+      case FmpImageWriteDirect:
+        Direct = MIN (Direct, Index);
+        break;
+
+      case FmpImageWriteErasing:
+        Erasing = TRUE;
+        break;
+
+      case FmpImageWriteEraseAhead:
+        Waiting = MIN (Waiting, Index);
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  if ((Direct < mWriteCount) || Erasing) {
+    return Direct;
+  }
+
+  if (Waiting < mWriteCount) {
+    DEBUG ((
+      DEBUG_INFO,
+      "%a: %s device busy, writing without erase ahead\n",
+      __FUNCTION__,
+      mWrites[Waiting].FwImageProtocol->ImageName
+      ));
+    mWrites[Waiting].State = FmpImageWriteDirect;
+  }
+
+  return Waiting;
+}
+
+/**
+  Write all package images, erasing ahead on every device that can erase in
+  the background.  One erase runs per device at a time: an image whose
+  device is busy with another image's erase is started once that image has
+  been written.  Erased images are written as soon as their erase is done,
+  images on devices that can't erase ahead are written while the erases
+  run, and nothing is written to an image whose erase is still running.
+
+  @param[in]  Writes                Pointer to image write array
+  @param[in]  WriteCount            Number of entries in Writes
+  @param[in]  WriteImage            Function to write an image
+
+  @retval EFI_SUCCESS               The operation completed successfully
+  @retval Others                    An error occurred
+
+**/
+EFI_STATUS
+EFIAPI
+FmpImageWriteAll (
+  IN  FMP_IMAGE_WRITE       *Writes,
+  IN  UINTN                 WriteCount,
+  IN  FMP_IMAGE_WRITE_FUNC  WriteImage
+  )
+{
+  NVIDIA_FW_IMAGE_PROTOCOL  *FwImageProtocol;
+  EFI_STATUS                Status;
+  UINTN                     Index;
+  UINTN                     WritesLeft;
+
+  for (Index = 0; Index < WriteCount; Index++) {
+    FwImageProtocol = Writes[Index].FwImageProtocol;
+    if (FwImageProtocol->ErasePoll (FwImageProtocol, FW_IMAGE_RW_FLAG_NONE) == EFI_UNSUPPORTED) {
+      Writes[Index].State = FmpImageWriteDirect;
+    } else {
+      Writes[Index].State = FmpImageWriteEraseAhead;
+    }
+  }
+
+  mWrites     = Writes;
+  mWriteCount = WriteCount;
+  WritesLeft  = WriteCount;
+  while (WritesLeft > 0) {
+    FmpImageWriteStartErases ();
+    FmpImageWritePollErases ();
+
+    Index = FmpImageWriteNext ();
+    if (Index == WriteCount) {
+      continue;
+    }
+
+    Status = WriteImage (&Writes[Index]);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+
+    Writes[Index].State = FmpImageWriteDone;
+    WritesLeft--;
+  }
+
+  Status = EFI_SUCCESS;
+
+Done:
+  mWrites     = NULL;
+  mWriteCount = 0;
+  return Status;
+}
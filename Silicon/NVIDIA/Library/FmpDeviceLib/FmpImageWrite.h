@@ -0,0 +1,85 @@
+/** @file
+
+  FMP image write scheduling
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __FMP_IMAGE_WRITE_H__
+#define __FMP_IMAGE_WRITE_H__
+
+#include <Uefi.h>
+#include <Protocol/FwImageProtocol.h>
+
+// write state of a package image
+typedef enum {
+  FmpImageWriteEraseAhead,        // erase ahead not started yet
+  FmpImageWriteErasing,           // erase ahead running
+  FmpImageWriteErased,            // erase ahead done, ready to write
+  FmpImageWriteDirect,            // written without erasing ahead
+  FmpImageWriteDone
+} FMP_IMAGE_WRITE_STATE;
+
+// a package image to be written to a FwImage
+typedef struct {
+  NVIDIA_FW_IMAGE_PROTOCOL    *FwImageProtocol;
+  CONST UINT8                 *Data;
+  UINTN                       Bytes;
+  FMP_IMAGE_WRITE_STATE       State;
+} FMP_IMAGE_WRITE;
+
+/**
+  Write a package image to its FwImage.
+
+  @param[in]  Write                 Pointer to image write
+
+  @retval EFI_SUCCESS               The operation completed successfully
+  @retval Others                    An error occurred
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FMP_IMAGE_WRITE_FUNC)(
+  IN  FMP_IMAGE_WRITE  *Write
+  );
+
+/**
+  Write all package images, erasing ahead on every device that can erase in
+  the background.  One erase runs per device at a time: an image whose
+  device is busy with another image's erase is started once that image has
+  been written.  Erased images are written as soon as their erase is done,
+  images on devices that can't erase ahead are written while the erases
+  run, and nothing is written to an image whose erase is still running.
+
+  @param[in]  Writes                Pointer to image write array
+  @param[in]  WriteCount            Number of entries in Writes
+  @param[in]  WriteImage            Function to write an image
+
+  @retval EFI_SUCCESS               The operation completed successfully
+  @retval Others                    An error occurred
+
+**/
+EFI_STATUS
+EFIAPI
+FmpImageWriteAll (
+  IN  FMP_IMAGE_WRITE       *Writes,
+  IN  UINTN                 WriteCount,
+  IN  FMP_IMAGE_WRITE_FUNC  WriteImage
+  );
+
+/**
+  Poll the erases running ahead during FmpImageWriteAll().  Called between
+  the chunks of an image write to keep the erases moving.  Does nothing
+  when no images are being written.
+
+**/
+VOID
+EFIAPI
+FmpImageWritePollErases (
+  VOID
+  );
+
+#endif
@@ -31,6 +31,7 @@
 #include <Protocol/FwImageProtocol.h>
 #include <Protocol/BrBctUpdateProtocol.h>
 #include <Protocol/BootChainProtocol.h>
+#include "FmpImageWrite.h"
 #include "TegraFmp.h"
 
 #define FMP_CAPSULE_SINGLE_PARTITION_CHAIN_VARIABLE  L"FmpCapsuleSinglePartitionChain"
@@ -105,6 +106,7 @@ STATIC UINTN  mTotalBytesFlashed  = 0;
 STATIC UINTN  mTotalBytesToVerify = 0;
 STATIC UINTN  mTotalBytesVerified = 0;
 STATIC UINTN  mCurrentCompletion  = 0;
+STATIC UINTN  mReportedCompletion = MAX_UINTN;
 
 // module variables
 STATIC EFI_EVENT   mAddressChangeEvent      = NULL;
@@ -424,6 +426,31 @@ Done:
   return mTegraVersionStatus;
 }
 
+/**
+  Update FW update progress bar if the completion percentage has changed.
+  Writes and verifies report progress for every chunk, and redrawing the
+  progress bar for each one adds time without changing what is displayed.
+
+  @param[in]  Completion                Current percentage complete (0-100)
+
+  @retval None
+
+**/
+STATIC
+VOID
+EFIAPI
+ReportProgress (
+  IN  UINTN  Completion
+  )
+{
+  if (Completion == mReportedCompletion) {
+    return;
+  }
+
+  mReportedCompletion = Completion;
+  mProgress (Completion);
+}
+
 /**
   Increment image verify bytes complete and update FW update progress bar.
 
@@ -445,7 +472,7 @@ ImageVerifyProgress (
   VerifyCompletion     = (mTotalBytesVerified * FMP_PROGRESS_VERIFY_IMAGES) /
                          mTotalBytesToVerify;
 
-  mProgress (mCurrentCompletion + VerifyCompletion);
+  ReportProgress (mCurrentCompletion + VerifyCompletion);
 }
 
 /**
@@ -469,7 +496,7 @@ ImageWriteProgress (
   WriteCompletion     = (mTotalBytesFlashed * FMP_PROGRESS_WRITE_IMAGES) /
                         mTotalBytesToFlash;
 
-  mProgress (mCurrentCompletion + WriteCompletion);
+  ReportProgress (mCurrentCompletion + WriteCompletion);
 }
 
 /**
@@ -490,7 +517,7 @@ SetImageProgress (
   mCurrentCompletion += CompletionIncrement;
   ASSERT (mCurrentCompletion <= 100);
 
-  mProgress (mCurrentCompletion);
+  ReportProgress (mCurrentCompletion);
 }
 
 /**
@@ -608,7 +635,9 @@ GetPackageImageName (
 }
 
 /**
-  Write a buffer to a FwImage.
+  Write a buffer to a FwImage.  The image is flushed before returning, so
+  the data is on the media when the write succeeds.  Erases running ahead
+  on other images are polled between chunks to keep them moving.
 
   @param[in]  FwImageProtocol       FwImage protocol structure pointer
   @param[in]  Bytes                 Number of bytes to write
@@ -661,6 +690,18 @@ WriteImageFromBuffer (
     WriteOffset += WriteSize;
     Bytes       -= WriteSize;
     ImageWriteProgress (WriteSize);
+
+    FmpImageWritePollErases ();
+  }
+
+  Status = FwImageProtocol->Flush (FwImageProtocol);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "Failed to flush image=%s: %r\n",
+      FwImageProtocol->ImageName,
+      Status
+      ));
   }
 
   return Status;
@@ -736,7 +777,49 @@ WriteImage (
 }
 
 /**
-  Write FW package data to all FwImages except for special images.
+  Write a package image to its FwImage.
+
+  @param[in]  Write                 Pointer to image write
+
+  @retval EFI_SUCCESS               The operation completed successfully
+  @retval Others                    An error occurred
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+WritePackageImage (
+  IN  FMP_IMAGE_WRITE  *Write
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = WriteImageFromBuffer (
+             Write->FwImageProtocol,
+             Write->Bytes,
+             Write->Data,
+             FW_IMAGE_RW_FLAG_NONE
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "Failed to write image=%s: %r\n",
+      Write->FwImageProtocol->ImageName,
+      Status
+      ));
+  }
+
+  return Status;
+}
+
+/**
+  Write FW package data to all FwImages except for special images.  Every
+  image is located in the package before any image is written, so a package
+  missing a required image fails without modifying the inactive FW.
+
+  Images on devices that can erase in the background are erased ahead, one
+  erase per device, while images on other devices are written.  See
+  FmpImageWriteAll().
 
   @param[in]  Header                Pointer to the FW package header
 
@@ -751,16 +834,25 @@ WriteRegularImages (
   IN  CONST FW_PACKAGE_HEADER  *Header
   )
 {
-  EFI_STATUS                Status;
-  UINTN                     Index;
-  UINTN                     PkgImageIndex;
-  UINTN                     ImageCount;
-  NVIDIA_FW_IMAGE_PROTOCOL  **FwImageProtocolArray;
+  EFI_STATUS                   Status;
+  UINTN                        Index;
+  UINTN                        PkgImageIndex;
+  UINTN                        ImageCount;
+  UINTN                        WriteCount;
+  NVIDIA_FW_IMAGE_PROTOCOL     **FwImageProtocolArray;
+  FMP_IMAGE_WRITE              *Writes;
+  CONST FW_PACKAGE_IMAGE_INFO  *PkgImageInfo;
 
   ImageCount           = FwImageGetCount ();
   FwImageProtocolArray = FwImageGetProtocolArray ();
 
-  // Write all images except special ones that are done later
+  Writes = (FMP_IMAGE_WRITE *)AllocateZeroPool (MAX (ImageCount, 1) * sizeof (FMP_IMAGE_WRITE));
+  if (Writes == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // Locate all images except special ones that are done later
+  WriteCount = 0;
   for (Index = 0; Index < ImageCount; Index++) {
     CONST CHAR16              *ImageName;
     NVIDIA_FW_IMAGE_PROTOCOL  *FwImageProtocol;
@@ -773,7 +865,7 @@ WriteRegularImages (
 
     Status = FwPackageGetImageIndex (
                Header,
-               ImageName,
+               GetPackageImageName (ImageName, Header),
                mIsProductionFused,
                mPlatformCompatSpec,
                mPlatformSpec,
@@ -785,20 +877,21 @@ WriteRegularImages (
       }
 
       DEBUG ((DEBUG_ERROR, "%s not found in package: %r\n", ImageName, Status));
-      return Status;
+      goto Done;
     }
 
-    Status = WriteImage (
-               Header,
-               ImageName,
-               FW_IMAGE_RW_FLAG_NONE
-               );
-    if (EFI_ERROR (Status)) {
-      return Status;
-    }
+    PkgImageInfo                       = FwPackageImageInfoPtr (Header, PkgImageIndex);
+    Writes[WriteCount].FwImageProtocol = FwImageProtocol;
+    Writes[WriteCount].Data            = (CONST UINT8 *)FwPackageImageDataPtr (Header, PkgImageIndex);
+    Writes[WriteCount].Bytes           = PkgImageInfo->Bytes;
+    WriteCount++;
   }
 
-  return EFI_SUCCESS;
+  Status = FmpImageWriteAll (Writes, WriteCount, WritePackageImage);
+
+Done:
+  FreePool (Writes);
+  return Status;
 }
 
 /**
@@ -1568,6 +1661,7 @@ FmpTegraSetImage (
   mTotalBytesFlashed  = 0;
   mTotalBytesVerified = 0;
   mCurrentCompletion  = 0;
+  mReportedCompletion = MAX_UINTN;
 
   // Ignore Progress function parameter since it is a null implementation
   // when UpdateCapsule() is the caller.  Use our UpdateProgress() instead.
@@ -0,0 +1,482 @@
+/** @file
+
+  FMP image write scheduling unit test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../FmpImageWrite.h"
+
+#define UNIT_TEST_NAME     "FMP Image Write Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_MAX_DEVICES   4
+#define TEST_MAX_IMAGES    8
+#define TEST_ERASE_POLLS   5
+#define TEST_WRITE_CHUNKS  2
+#define TEST_NO_IMAGE      MAX_UINTN
+
+//
+// Simulated device with one erase in flight at a time, as the MM NOR flash
+// driver does.  The erased range stays reserved until its image is written,
+// a write to any other image of the device drops the reservation.
+//
+typedef struct {
+  BOOLEAN    EraseAhead;
+  BOOLEAN    FailStart;
+  BOOLEAN    Reserved;
+  UINTN      Owner;
+  UINTN      PollsLeft;
+} SIM_DEVICE;
+
+typedef struct {
+  NVIDIA_FW_IMAGE_PROTOCOL    Protocol;
+  UINTN                       Index;
+  UINTN                       Device;
+  BOOLEAN                     ErasedAhead;
+} SIM_IMAGE;
+
+STATIC SIM_DEVICE       mDevices[TEST_MAX_DEVICES];
+STATIC SIM_IMAGE        mImages[TEST_MAX_IMAGES];
+STATIC FMP_IMAGE_WRITE  mWrites[TEST_MAX_IMAGES];
+STATIC UINTN            mImageCount;
+STATIC UINTN            mOrder[TEST_MAX_IMAGES];
+STATIC UINTN            mWritten;
+STATIC UINTN            mBlockedWrites;
+STATIC UINTN            mDroppedReservations;
+STATIC UINTN            mMaxErases;
+STATIC UINTN            mPolls;
+STATIC UINTN            mFailWrite;
+
+/**
+  Count the devices with an erase in flight.
+
+  @retval UINTN   Number of erases running
+**/
+STATIC
+UINTN
+SimErasesRunning (
+  VOID
+  )
+{
+  UINTN  Device;
+  UINTN  Count;
+
+  Count = 0;
+  for (Device = 0; Device < TEST_MAX_DEVICES; Device++) {
+    if (mDevices[Device].PollsLeft > 0) {
+      Count++;
+    }
+  }
+
+  return Count;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+SimEraseAsync (
+  IN  NVIDIA_FW_IMAGE_PROTOCOL  *This,
+  IN  UINT64                    Offset,
+  IN  UINTN                     Bytes,
+  IN  UINTN                     Flags
+  )
+{
+  SIM_IMAGE   *Image;
+  SIM_DEVICE  *Device;
+
+  Image  = (SIM_IMAGE *)This;
+  Device = &mDevices[Image->Device];
+  if (!Device->EraseAhead) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (Device->Reserved) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  if (Device->FailStart) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Device->Reserved  = TRUE;
+  Device->Owner     = Image->Index;
+  Device->PollsLeft = TEST_ERASE_POLLS;
+  mMaxErases        = MAX (mMaxErases, SimErasesRunning ());
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+SimErasePoll (
+  IN  NVIDIA_FW_IMAGE_PROTOCOL  *This,
+  IN  UINTN                     Flags
+  )
+{
+  SIM_DEVICE  *Device;
+
+  Device = &mDevices[((SIM_IMAGE *)This)->Device];
+  if (!Device->EraseAhead) {
+    return EFI_UNSUPPORTED;
+  }
+
+  mPolls++;
+  if (Device->PollsLeft > 0) {
+    Device->PollsLeft--;
+  }
+
+  return (Device->PollsLeft > 0) ? EFI_NOT_READY : EFI_SUCCESS;
+}
+
+/**
+  Write an image the way WriteImageFromBuffer() does, polling the erases
+  between chunks.
+
+  @param[in]  Write     Image write
+
+  @retval EFI_SUCCESS       Image written
+  @retval EFI_DEVICE_ERROR  Write failed
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+SimWriteImage (
+  IN  FMP_IMAGE_WRITE  *Write
+  )
+{
+  SIM_IMAGE   *Image;
+  SIM_DEVICE  *Device;
+  UINTN       Chunk;
+
+  Image  = (SIM_IMAGE *)Write->FwImageProtocol;
+  Device = &mDevices[Image->Device];
+  if (Image->Index == mFailWrite) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (Device->Reserved) {
+    if (Device->Owner == Image->Index) {
+      Image->ErasedAhead = TRUE;
+      if (Device->PollsLeft > 0) {
+        mBlockedWrites++;
+      }
+    } else {
+      mDroppedReservations++;
+    }
+
+    Device->Reserved  = FALSE;
+    Device->PollsLeft = 0;
+  }
+
+  for (Chunk = 0; Chunk < TEST_WRITE_CHUNKS; Chunk++) {
+    FmpImageWritePollErases ();
+  }
+
+  mOrder[mWritten++] = Image->Index;
+  return EFI_SUCCESS;
+}
+
+/**
+  Add an image on a simulated device.
+
+  @param[in]  Device    Device index
+
+**/
+STATIC
+VOID
+SimAddImage (
+  IN  UINTN  Device
+  )
+{
+  SIM_IMAGE  *Image;
+
+  Image                      = &mImages[mImageCount];
+  Image->Protocol.ImageName  = L"image";
+  Image->Protocol.EraseAsync = SimEraseAsync;
+  Image->Protocol.ErasePoll  = SimErasePoll;
+  Image->Index               = mImageCount;
+  Image->Device              = Device;
+
+  mWrites[mImageCount].FwImageProtocol = &Image->Protocol;
+  mWrites[mImageCount].Bytes           = SIZE_4KB;
+  mImageCount++;
+}
+
+/**
+  Reset the simulated devices and images.  Devices 0 and 2 erase ahead,
+  device 1 doesn't.
+
+  @param[in] Context  Unused
+
+  @retval UNIT_TEST_PASSED  Setup done
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetupDevices (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ZeroMem (mDevices, sizeof (mDevices));
+  ZeroMem (mImages, sizeof (mImages));
+  ZeroMem (mWrites, sizeof (mWrites));
+  mImageCount          = 0;
+  mWritten             = 0;
+  mBlockedWrites       = 0;
+  mDroppedReservations = 0;
+  mMaxErases           = 0;
+  mPolls               = 0;
+  mFailWrite           = TEST_NO_IMAGE;
+
+  mDevices[0].EraseAhead = TRUE;
+  mDevices[2].EraseAhead = TRUE;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Images on the other device are written while both erase-ahead devices
+  erase, erased images are written once their erase is done, and the second
+  image on a device is erased once the first has been written.
+
+  @param[in] Context  Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+WriteOrdering (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  SimAddImage (0);
+  SimAddImage (0);
+  SimAddImage (1);
+  SimAddImage (1);
+  SimAddImage (2);
+
+  UT_ASSERT_NOT_EFI_ERROR (FmpImageWriteAll (mWrites, mImageCount, SimWriteImage));
+  UT_ASSERT_EQUAL (mWritten, 5);
+  UT_ASSERT_EQUAL (mOrder[0], 2);
+  UT_ASSERT_EQUAL (mOrder[1], 3);
+  UT_ASSERT_EQUAL (mOrder[2], 0);
+  UT_ASSERT_EQUAL (mOrder[3], 4);
+  UT_ASSERT_EQUAL (mOrder[4], 1);
+  UT_ASSERT_EQUAL (mMaxErases, 2);
+  UT_ASSERT_EQUAL (mBlockedWrites, 0);
+  UT_ASSERT_EQUAL (mDroppedReservations, 0);
+
+  UT_ASSERT_TRUE (mImages[0].ErasedAhead);
+  UT_ASSERT_TRUE (mImages[1].ErasedAhead);
+  UT_ASSERT_FALSE (mImages[2].ErasedAhead);
+  UT_ASSERT_FALSE (mImages[3].ErasedAhead);
+  UT_ASSERT_TRUE (mImages[4].ErasedAhead);
+  for (Index = 0; Index < mImageCount; Index++) {
+    UT_ASSERT_EQUAL (mWrites[Index].State, FmpImageWriteDone);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  With only erase-ahead images on one device, the erases are polled until
+  done instead of writing an image whose erase is running.
+
+  @param[in] Context  Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+PollWhileErasing (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SimAddImage (0);
+  SimAddImage (0);
+
+  UT_ASSERT_NOT_EFI_ERROR (FmpImageWriteAll (mWrites, mImageCount, SimWriteImage));
+  UT_ASSERT_EQUAL (mWritten, 2);
+  UT_ASSERT_EQUAL (mOrder[0], 0);
+  UT_ASSERT_EQUAL (mOrder[1], 1);
+  UT_ASSERT_EQUAL (mMaxErases, 1);
+  UT_ASSERT_EQUAL (mBlockedWrites, 0);
+  UT_ASSERT_TRUE (mImages[0].ErasedAhead);
+  UT_ASSERT_TRUE (mImages[1].ErasedAhead);
+  UT_ASSERT_TRUE (mPolls >= 2 * TEST_ERASE_POLLS);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A device busy with an erase that isn't ours has its first image written
+  without erasing ahead, which frees the device for the next image.
+
+  @param[in] Context  Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+StaleReservation (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SimAddImage (0);
+  SimAddImage (0);
+  mDevices[0].Reserved = TRUE;
+  mDevices[0].Owner    = TEST_NO_IMAGE;
+
+  UT_ASSERT_NOT_EFI_ERROR (FmpImageWriteAll (mWrites, mImageCount, SimWriteImage));
+  UT_ASSERT_EQUAL (mWritten, 2);
+  UT_ASSERT_EQUAL (mOrder[0], 0);
+  UT_ASSERT_EQUAL (mOrder[1], 1);
+  UT_ASSERT_EQUAL (mDroppedReservations, 1);
+  UT_ASSERT_FALSE (mImages[0].ErasedAhead);
+  UT_ASSERT_TRUE (mImages[1].ErasedAhead);
+  UT_ASSERT_EQUAL (mBlockedWrites, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  An image whose erase can't be started is written without erasing ahead
+  while the other device erases.
+
+  @param[in] Context  Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EraseStartFailure (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SimAddImage (0);
+  SimAddImage (2);
+  mDevices[0].FailStart = TRUE;
+
+  UT_ASSERT_NOT_EFI_ERROR (FmpImageWriteAll (mWrites, mImageCount, SimWriteImage));
+  UT_ASSERT_EQUAL (mWritten, 2);
+  UT_ASSERT_EQUAL (mOrder[0], 0);
+  UT_ASSERT_EQUAL (mOrder[1], 1);
+  UT_ASSERT_FALSE (mImages[0].ErasedAhead);
+  UT_ASSERT_TRUE (mImages[1].ErasedAhead);
+  UT_ASSERT_EQUAL (mBlockedWrites, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A failed write stops the update, and polling after the update does
+  nothing.
+
+  @param[in] Context  Unused
+
+  @retval UNIT_TEST_PASSED  Test passed
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+WriteFailure (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Polls;
+
+  SimAddImage (0);
+  SimAddImage (1);
+  SimAddImage (1);
+  mFailWrite = 1;
+
+  UT_ASSERT_STATUS_EQUAL (FmpImageWriteAll (mWrites, mImageCount, SimWriteImage), EFI_DEVICE_ERROR);
+  UT_ASSERT_EQUAL (mWritten, 0);
+  UT_ASSERT_EQUAL (mWrites[2].State, FmpImageWriteDirect);
+
+  Polls = mPolls;
+  FmpImageWritePollErases ();
+  UT_ASSERT_EQUAL (mPolls, Polls);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the FMP
+  image write scheduling and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      WriteTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&WriteTests, Framework, "FMP Image Write Tests", "UnitTest.FmpImageWrite", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for FMP Image Write Tests\n"));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AddTestCase (WriteTests, "Writes ordered around concurrent erases", "WriteOrdering", WriteOrdering, SetupDevices, NULL, NULL);
+  AddTestCase (WriteTests, "Erases polled instead of blocking", "PollWhileErasing", PollWhileErasing, SetupDevices, NULL, NULL);
+  AddTestCase (WriteTests, "Device busy with another erase", "StaleReservation", StaleReservation, SetupDevices, NULL, NULL);
+  AddTestCase (WriteTests, "Erase not started", "EraseStartFailure", EraseStartFailure, SetupDevices, NULL, NULL);
+  AddTestCase (WriteTests, "Write failure stops the update", "WriteFailure", WriteFailure, SetupDevices, NULL, NULL);
+
+  // Execute the tests.
+  return RunAllTestSuites (Framework);
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
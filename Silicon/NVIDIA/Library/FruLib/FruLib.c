@@ -16,6 +16,7 @@
 #include <Library/IpmiBaseLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
+#include <Library/UefiLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <IndustryStandard/Ipmi.h>
 #include <IndustryStandard/IpmiNetFnStorage.h>
@@ -25,6 +26,9 @@
 
 UINT8            mRecordCount = 0;
 FRU_DEVICE_INFO  *mFruRecordInfo[MAX_NUMBER_OF_FRU_DEVICE_IDS];
+UINT8            *mFruInventory[MAX_NUMBER_OF_FRU_DEVICE_IDS];
+UINT16           mFruInventorySize[MAX_NUMBER_OF_FRU_DEVICE_IDS];
+UINT8            mFruReadCount = FRU_MAX_READ_COUNT;
 
 /**
  * Print the contents of each Fru Record that stores the parsed FRU data.
@@ -560,60 +564,42 @@ ParseFruProductArea (
 }
 
 /**
-  Reads and parse FRU Multi Record Area contents
+  Parse FRU Multi Record Area contents
 
-  @Param IN Offset    Offset in multiples of 8 of a specific Area in the Fru
-  @Param IN DevIndex  Device Index of the FruDeviceInfo array
+  @Param IN Inventory      FRU Inventory Area contents
+  @Param IN InventorySize  Size of the FRU Inventory Area
+  @Param IN Offset         Offset of the Multi Record Area in the Fru
+  @Param IN DevIndex       Device Index of the FruDeviceInfo array
 
 **/
 VOID
-ReadFruMultiRecordArea (
+ParseFruMultiRecordArea (
+  IN UINT8   *Inventory,
+  IN UINT16  InventorySize,
   IN UINT16  Offset,
   IN UINT8   DevIndex
   )
 {
-  EFI_STATUS                   Status;
-  IPMI_READ_FRU_DATA_REQUEST   CommandData;
-  IPMI_READ_FRU_DATA_RESPONSE  *ResponseData;
-  UINT32                       ResponseSize;
-  UINT8                        HeaderBuff[IPMI_MULTI_RECORD_HEADER_RESPONSE_SIZE];
-  UINT8                        *DataBuff = NULL;
-  FRU_MULTI_RECORD_HEADER      *MultiHdr = NULL;
-  UINT8                        RecNum    = 0;
+  FRU_MULTI_RECORD_HEADER  *MultiHdr;
+  UINT8                    *Data;
+  UINT8                    RecNum;
 
+  RecNum = 0;
   do {
-    //
-    // Read Multi Record Header
-    //
-    CommandData.DeviceId        = mFruRecordInfo[DevIndex]->FruDeviceId;
-    CommandData.InventoryOffset = Offset;
-    CommandData.CountToRead     = sizeof (FRU_MULTI_RECORD_HEADER);
-
-    ResponseData = (IPMI_READ_FRU_DATA_RESPONSE *)HeaderBuff;
-    ResponseSize = IPMI_MULTI_RECORD_HEADER_RESPONSE_SIZE;
-
-    Status = IpmiSubmitCommand (
-               IPMI_NETFN_STORAGE,
-               IPMI_STORAGE_READ_FRU_DATA,
-               (UINT8 *)&CommandData,
-               sizeof (CommandData),
-               (UINT8 *)ResponseData,
-               &ResponseSize
-               );
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "%a: IpmiSubmitCommand failed - %r\n", __FUNCTION__, Status));
+    if (RecNum >= MAX_FRU_MULTI_RECORDS) {
+      DEBUG ((DEBUG_ERROR, "FRU %d: More than %d Multi Records, ignoring the rest.\n", DevIndex, MAX_FRU_MULTI_RECORDS));
       break;
     }
 
-    if (ResponseData->CompletionCode != IPMI_COMP_CODE_NORMAL) {
-      DEBUG ((DEBUG_ERROR, "%a: Completion code = 0x%x\n", __FUNCTION__, ResponseData->CompletionCode));
+    if ((Offset > InventorySize) || ((InventorySize - Offset) < sizeof (FRU_MULTI_RECORD_HEADER))) {
+      DEBUG ((DEBUG_ERROR, "%a: Unexpected offset\n", __FUNCTION__));
       break;
     }
 
     //
     // Verify Multi Record Header
     //
-    MultiHdr = (FRU_MULTI_RECORD_HEADER *)ResponseData->Data;
+    MultiHdr = (FRU_MULTI_RECORD_HEADER *)&Inventory[Offset];
 
     if (MultiHdr->Version != FRU_MULTI_RECORD_VERSION) {
       DEBUG ((DEBUG_ERROR, "FRU %d: Multi Record %d has unsupported version.\n", DevIndex, RecNum));
@@ -625,50 +611,16 @@ ReadFruMultiRecordArea (
       break;
     }
 
-    if ((Offset > (MAX_FRU_SIZE - sizeof (FRU_MULTI_RECORD_HEADER))) ||
-        (Offset > (MAX_FRU_SIZE - sizeof (FRU_MULTI_RECORD_HEADER) - MultiHdr->Length)))
-    {
+    if (MultiHdr->Length > (InventorySize - Offset - sizeof (FRU_MULTI_RECORD_HEADER))) {
       DEBUG ((DEBUG_ERROR, "%a: Unexpected offset\n", __FUNCTION__));
       break;
     }
 
-    //
-    // Read Multi Record Data
-    //
-    CommandData.DeviceId        = mFruRecordInfo[DevIndex]->FruDeviceId;
-    CommandData.InventoryOffset = Offset + sizeof (FRU_MULTI_RECORD_HEADER);
-    CommandData.CountToRead     = MultiHdr->Length;
-
-    ResponseSize = sizeof (IPMI_READ_FRU_DATA_RESPONSE) + MultiHdr->Length;
-    DataBuff     = AllocatePool (ResponseSize);
-    ResponseData = (IPMI_READ_FRU_DATA_RESPONSE *)DataBuff;
-    if (DataBuff == NULL) {
-      DEBUG ((DEBUG_ERROR, "%a: Failed to allocate pool\n", __FUNCTION__));
-      break;
-    }
-
-    Status = IpmiSubmitCommand (
-               IPMI_NETFN_STORAGE,
-               IPMI_STORAGE_READ_FRU_DATA,
-               (UINT8 *)&CommandData,
-               sizeof (CommandData),
-               (UINT8 *)ResponseData,
-               &ResponseSize
-               );
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "%a: IpmiSubmitCommand failed - %r\n", __FUNCTION__, Status));
-      break;
-    }
-
-    if (ResponseData->CompletionCode != IPMI_COMP_CODE_NORMAL) {
-      DEBUG ((DEBUG_ERROR, "%a: Completion code = 0x%x\n", __FUNCTION__, ResponseData->CompletionCode));
-      break;
-    }
-
     //
     // Verify data
     //
-    if (((CalculateSum8 (ResponseData->Data, MultiHdr->Length) + MultiHdr->RecordChecksum) & 0xFF) != 0) {
+    Data = &Inventory[Offset + sizeof (FRU_MULTI_RECORD_HEADER)];
+    if (((CalculateSum8 (Data, MultiHdr->Length) + MultiHdr->RecordChecksum) & 0xFF) != 0) {
       DEBUG ((DEBUG_ERROR, "FRU %d: Multi Record %d has invalid data checksum.\n", DevIndex, RecNum));
       break;
     }
@@ -683,225 +635,466 @@ ReadFruMultiRecordArea (
     }
 
     CopyMem (&mFruRecordInfo[DevIndex]->MultiRecords[RecNum]->Header, MultiHdr, sizeof (FRU_MULTI_RECORD_HEADER));
-    CopyMem (&mFruRecordInfo[DevIndex]->MultiRecords[RecNum]->Data, ResponseData->Data, MultiHdr->Length);
+    CopyMem (&mFruRecordInfo[DevIndex]->MultiRecords[RecNum]->Data, Data, MultiHdr->Length);
 
     Offset += sizeof (FRU_MULTI_RECORD_HEADER) + MultiHdr->Length;
     RecNum++;
   } while (!MultiHdr->EndOfList);
-
-  if (DataBuff != NULL) {
-    FreePool (DataBuff);
-  }
 }
 
 /**
-  Reads the contents of a specific Fru Area
+  Parse the contents of a specific Fru Area
 
-  @Param IN Offset    Offset in multiples of 8 of a specific Area in the Fru
-  @Param IN AreaType  Enum Value of the Type of Area - Chassis/Board/Product
-  @Param IN DevIndex  Device Index of the FruDeviceInfo array
+  @Param IN Inventory      FRU Inventory Area contents
+  @Param IN InventorySize  Size of the FRU Inventory Area
+  @Param IN Offset         Offset of a specific Area in the Fru
+  @Param IN AreaType       Enum Value of the Type of Area - Chassis/Board/Product
+  @Param IN DevIndex       Device Index of the FruDeviceInfo array
 
-  @Return   Returns the EFI_SUCCESS status if no any Ipmi protocol errors are encountered.
 **/
-EFI_STATUS
-ReadSpecificFruArea (
+VOID
+ParseSpecificFruArea (
+  IN UINT8      *Inventory,
+  IN UINT16     InventorySize,
   IN UINT32     Offset,
   IN AREA_TYPE  Type,
   IN UINT8      DevIndex
   )
 {
-  EFI_STATUS                   Status;
-  IPMI_READ_FRU_DATA_REQUEST   CommandData;
-  IPMI_READ_FRU_DATA_RESPONSE  *FruData;
-  UINT32                       ResponseSize;
-  UINT8                        *FruArea;
-  UINT8                        *temp;
-  UINT32                       FruSize;
-  UINT8                        ResponseData[5];
-  UINT8                        *FruResponse;
+  UINT8   *FruArea;
+  UINT32  FruSize;
 
-  FruData = (IPMI_READ_FRU_DATA_RESPONSE *)&ResponseData;
+  if ((Offset + 2) > InventorySize) {
+    DEBUG ((DEBUG_ERROR, "%a: Area offset 0x%x is outside of FRU %d\n", __FUNCTION__, Offset, DevIndex));
+    return;
+  }
 
-  FruSize = 0;
-  // First read the first 2 bytes of Chassis Area to get this Area size and then read the Area.
-  // IPMI callout to NetFn Storage 0x0A, command 0x11
-  //    Request data:
-  //      Byte 1  : Device ID
-  //      Byte 2,3: Fru Inventory Offset
-  //      Byte 4  : Count to Read
-  CommandData.DeviceId        = mFruRecordInfo[DevIndex]->FruDeviceId;
-  CommandData.InventoryOffset = Offset;
-  CommandData.CountToRead     = 2;
+  // FruArea[0] = Byte 1 - Chassis/Board/Product Info Area Format Version
+  // FruArea[1] = Byte 2 - Chassis/Board/Product Info Area Size
+  FruArea = &Inventory[Offset];
+  FruSize = FruArea[1] * 8;
 
-  //    Response data:
-  //      Byte 1 : Completion Code
-  //      Byte 2 : Count returned
-  //      Byte 3 : Data[0]
-  ResponseSize = sizeof (ResponseData);
+  if (FruSize == 0) {
+    return;
+  }
 
-  Status = IpmiSubmitCommand (
-             IPMI_NETFN_STORAGE,
-             IPMI_STORAGE_READ_FRU_DATA,
-             (UINT8 *)&CommandData,
-             sizeof (CommandData),
-             (UINT8 *)&ResponseData,
-             &ResponseSize
-             );
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a: %r returned from IpmiSubmitCommand()\n", __FUNCTION__, Status));
-    return Status;
+  if (FruSize > (InventorySize - Offset)) {
+    DEBUG ((DEBUG_ERROR, "%a: Area at 0x%x of size 0x%x is outside of FRU %d\n", __FUNCTION__, Offset, FruSize, DevIndex));
+    return;
   }
 
-  if (FruData->CompletionCode != IPMI_COMP_CODE_NORMAL) {
-    DEBUG ((DEBUG_ERROR, "%a: Completion code = 0x%x. Returning\n", __FUNCTION__, FruData->CompletionCode));
+  FruSize = MIN (FruSize, MAX_UINT8);
+  if (Type == CHASSIS_AREA) {
+    ParseFruChassisArea (FruArea, FruSize, DevIndex);
+  } else if (Type == BOARD_AREA) {
+    ParseFruBoardArea (FruArea, FruSize, DevIndex);
+  } else if (Type == PRODUCT_AREA) {
+    ParseFruProductArea (FruArea, FruSize, DevIndex);
+  } else {
+    ASSERT (FALSE);
+  }
+}
+
+/**
+  Parses the Fru header to see what areas are present and calls the specific functions
+  to parse the Area contents.
+
+  @Param IN Inventory      FRU Inventory Area contents
+  @Param IN InventorySize  Size of the FRU Inventory Area
+  @Param IN DevIndex       Device Index of the FruDeviceInfo array
+
+  @Return            Returns EFI_SUCCESS if the FRU header is valid.
+**/
+EFI_STATUS
+ParseFruHeader (
+  IN UINT8   *Inventory,
+  IN UINT16  InventorySize,
+  IN UINT8   DevIndex
+  )
+{
+  FRU_HEADER  *Header;
+
+  if (InventorySize < sizeof (FRU_HEADER)) {
+    DEBUG ((DEBUG_ERROR, "%a: FRU %d is too small for a header: %d\n", __FUNCTION__, DevIndex, InventorySize));
     return EFI_PROTOCOL_ERROR;
   }
 
-  temp =  FruData->Data;
-  // temp[0] = Byte 1 - Chassis/Board/Product Info Area Format Version
-  // temp[1] = Byte 2 - Chassis/Board/Product Info Area Size
-  FruSize = *(temp + 1) * 8;
+  Header = (FRU_HEADER *)Inventory;
+  if (Header->Version != 1) {
+    DEBUG ((DEBUG_ERROR, "%a: Unknown FRU Header Version, Returning: 0x%x\n", __FUNCTION__, Header->Version));
+    return EFI_PROTOCOL_ERROR;
+  }
 
-  if (FruSize == 0) {
-    return EFI_SUCCESS;
+  // Print the header data
+  // Each of the area offsets are converted in to bytes and printed
+  DEBUG ((DEBUG_VERBOSE, "%a: FRU Area Offsets for Device Id: %d\n", __FUNCTION__, mFruRecordInfo[DevIndex]->FruDeviceId));
+  DEBUG ((DEBUG_VERBOSE, " Header.Version = 0x%x\n", Header->Version));
+  DEBUG ((DEBUG_VERBOSE, " Internal Area Offset = 0x%x\n", Header->Offset.Internal * 8));
+  DEBUG ((DEBUG_VERBOSE, " Chassis Area Offset = 0x%x\n", Header->Offset.Chassis * 8));
+  DEBUG ((DEBUG_VERBOSE, " Board Area Offset = 0x%x\n", Header->Offset.Board * 8));
+  DEBUG ((DEBUG_VERBOSE, " Product Area Offset = 0x%x\n", Header->Offset.Product * 8));
+  DEBUG ((DEBUG_VERBOSE, " Multi Record Area Offset = 0x%x\n", Header->Offset.Multi * 8));
+
+  // If a specific area is not present in the Fru data, the area offset will be set to 0x00
+  // Parse FRU Chassis Area
+  if (Header->Offset.Chassis * 8 >= sizeof (FRU_HEADER)) {
+    ParseSpecificFruArea (Inventory, InventorySize, Header->Offset.Chassis * 8, CHASSIS_AREA, DevIndex);
+  }
+
+  // Parse FRU Board Area
+  if (Header->Offset.Board * 8  >= sizeof (FRU_HEADER)) {
+    ParseSpecificFruArea (Inventory, InventorySize, Header->Offset.Board * 8, BOARD_AREA, DevIndex);
+  }
+
+  // Parse FRU Product Area
+  if (Header->Offset.Product * 8 >= sizeof (FRU_HEADER)) {
+    ParseSpecificFruArea (Inventory, InventorySize, Header->Offset.Product * 8, PRODUCT_AREA, DevIndex);
+  }
+
+  // Parse FRU Multi Record Area
+  if (Header->Offset.Multi * 8 >= sizeof (FRU_HEADER)) {
+    ParseFruMultiRecordArea (Inventory, InventorySize, Header->Offset.Multi * 8, DevIndex);
   }
 
-  // Read full Fru Chassis/Board/Product Info Area
-  CommandData.CountToRead = FruSize;
-  ResponseSize            = FruSize + sizeof (IPMI_READ_FRU_DATA_RESPONSE);
-  FruResponse             = (UINT8 *)AllocateZeroPool (ResponseSize);
-  FruData                 = (IPMI_READ_FRU_DATA_RESPONSE *)FruResponse;
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the size of the FRU Inventory Area of a device.
+
+  @Param  IN  FruDeviceId    FRU Device ID
+  @Param  OUT FruSize        Size of the FRU Inventory Area reported by the BMC
+
+  @Return   Returns EFI_SUCCESS if no Ipmi protocol errors are encountered.
+**/
+STATIC
+EFI_STATUS
+GetFruInventorySize (
+  IN  UINT8   FruDeviceId,
+  OUT UINT16  *FruSize
+  )
+{
+  EFI_STATUS                                 Status;
+  IPMI_GET_FRU_INVENTORY_AREA_INFO_REQUEST   InfoCommandData;
+  IPMI_GET_FRU_INVENTORY_AREA_INFO_RESPONSE  *FruInventoryInfo;
+  UINT32                                     ResponseSize;
+  UINT8                                      InfoResponseData[8];
+
+  // Get the FRU inventory Area Information
+  // IPMI callout to NetFn Storage 0x0A, command 0x10
+  //    Request data:
+  //      Byte 1: Device ID
+  InfoCommandData.DeviceId = FruDeviceId;
+
+  //    Response data:
+  //      Byte 1    : Completion Code
+  //      Byte 2,3  : Inventory Area Size
+  //      Byte 4    : Access Type
+  FruInventoryInfo = (IPMI_GET_FRU_INVENTORY_AREA_INFO_RESPONSE *)&InfoResponseData;
+  ResponseSize     = sizeof (InfoResponseData);
 
   Status = IpmiSubmitCommand (
              IPMI_NETFN_STORAGE,
-             IPMI_STORAGE_READ_FRU_DATA,
-             (UINT8 *)&CommandData,
-             sizeof (CommandData),
-             FruResponse,
+             IPMI_STORAGE_GET_FRU_INVENTORY_AREAINFO,
+             (UINT8 *)&InfoCommandData,
+             sizeof (InfoCommandData),
+             (UINT8 *)&InfoResponseData,
              &ResponseSize
              );
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a: %r returned from IpmiSubmitCommand()\n", __FUNCTION__, Status));
-    FreePool (FruResponse);
     return Status;
   }
 
-  if (FruData->CompletionCode != IPMI_COMP_CODE_NORMAL) {
-    DEBUG ((DEBUG_ERROR, "%a: Completion code = 0x%x. Returning\n", __FUNCTION__, FruData->CompletionCode));
-    FreePool (FruResponse);
+  if (FruInventoryInfo->CompletionCode != IPMI_COMP_CODE_NORMAL) {
+    DEBUG ((DEBUG_ERROR, "%a: Completion code = 0x%x. Returning\n", __FUNCTION__, FruInventoryInfo->CompletionCode));
     return EFI_PROTOCOL_ERROR;
   }
 
-  FruArea = FruData->Data;
-  if (Type == CHASSIS_AREA) {
-    ParseFruChassisArea (FruArea, FruSize, DevIndex);
-  } else if (Type == BOARD_AREA) {
-    ParseFruBoardArea (FruArea, FruSize, DevIndex);
-  } else if (Type == PRODUCT_AREA) {
-    ParseFruProductArea (FruArea, FruSize, DevIndex);
+  *FruSize = FruInventoryInfo->InventoryAreaSize;
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the largest Read FRU Data count that fits in one response of the system
+  interface to the BMC.
+
+  SSIF and BT report their response size limit, KCS responses are not limited
+  by the interface. ReadFruData() still reduces the count when the BMC rejects
+  it.
+
+  @Return   Read FRU Data count to start with.
+**/
+STATIC
+UINT8
+GetFruMaxReadCount (
+  VOID
+  )
+{
+  EFI_STATUS                      Status;
+  UINT8                           InterfaceType;
+  UINT32                          ResponseSize;
+  UINT32                          OutputSize;
+  UINT32                          Overhead;
+  FRU_SSIF_CAPABILITIES_RESPONSE  SsifResponse;
+  FRU_BT_CAPABILITIES_RESPONSE    BtResponse;
+
+  OutputSize    = 0;
+  Overhead      = 0;
+  InterfaceType = FRU_SYSTEM_INTERFACE_SSIF;
+  ResponseSize  = sizeof (SsifResponse);
+  Status        = IpmiSubmitCommand (
+                    IPMI_NETFN_APP,
+                    FRU_GET_SYSTEM_INTERFACE_CAPABILITIES,
+                    &InterfaceType,
+                    sizeof (InterfaceType),
+                    (UINT8 *)&SsifResponse,
+                    &ResponseSize
+                    );
+  if (!EFI_ERROR (Status) &&
+      (ResponseSize >= sizeof (SsifResponse)) &&
+      (SsifResponse.CompletionCode == IPMI_COMP_CODE_NORMAL))
+  {
+    OutputSize = SsifResponse.OutputMessageSize;
+    Overhead   = FRU_SSIF_MESSAGE_OVERHEAD;
   } else {
-    ASSERT (FALSE);
+    ResponseSize = sizeof (BtResponse);
+    Status       = IpmiSubmitCommand (
+                     IPMI_NETFN_APP,
+                     FRU_GET_BT_INTERFACE_CAPABILITIES,
+                     NULL,
+                     0,
+                     (UINT8 *)&BtResponse,
+                     &ResponseSize
+                     );
+    if (!EFI_ERROR (Status) &&
+        (ResponseSize >= sizeof (BtResponse)) &&
+        (BtResponse.CompletionCode == IPMI_COMP_CODE_NORMAL))
+    {
+      OutputSize = BtResponse.OutputBufferSize;
+      Overhead   = FRU_BT_MESSAGE_OVERHEAD;
+    }
   }
 
-  FreePool (FruResponse);
+  if (OutputSize == 0) {
+    return FRU_MAX_READ_COUNT;
+  }
 
-  return EFI_SUCCESS;
+  if (OutputSize < (Overhead + sizeof (IPMI_READ_FRU_DATA_RESPONSE) + FRU_MIN_READ_COUNT)) {
+    DEBUG ((DEBUG_ERROR, "%a: Response size %u is too small, reading %d bytes at a time\n", __FUNCTION__, OutputSize, FRU_MIN_READ_COUNT));
+    return FRU_MIN_READ_COUNT;
+  }
+
+  return (UINT8)MIN (OutputSize - Overhead - sizeof (IPMI_READ_FRU_DATA_RESPONSE), FRU_MAX_READ_COUNT);
 }
 
 /**
-  Parses the Fru header to see what areas are present and calls the specific functions
-  to parse the Area contents.
+  Read a range of the FRU Inventory Area of a device, using the largest read
+  count the BMC accepts.
 
-  @Param IN DevId       Device Id of the Fru to parse
-  @Param IN DevIndex    Device Index of the FruDeviceInfo array
+  @Param  IN  FruDeviceId    FRU Device ID
+  @Param  IN  Offset         Offset in the FRU Inventory Area
+  @Param  IN  Length         Number of bytes to read
+  @Param  OUT Buffer         Buffer to read the bytes into
 
-  @Return            Returns if EFI_SUCCESS if no Ipmi Protocol errors are encountered.
+  @Return   Returns EFI_SUCCESS if no Ipmi protocol errors are encountered.
 **/
+STATIC
 EFI_STATUS
-ReadFruHeader (
-  IN UINT8  DevId,
-  IN UINT8  DevIndex
+ReadFruData (
+  IN  UINT8   FruDeviceId,
+  IN  UINT16  Offset,
+  IN  UINT16  Length,
+  OUT UINT8   *Buffer
   )
 {
   EFI_STATUS                   Status;
   IPMI_READ_FRU_DATA_REQUEST   CommandData;
-  IPMI_READ_FRU_DATA_RESPONSE  *FruReadResponse;
+  IPMI_READ_FRU_DATA_RESPONSE  *FruData;
   UINT32                       ResponseSize;
-  UINT8                        ResponseData[16];
-  FRU_HEADER                   *Header;
+  UINT8                        ResponseData[sizeof (IPMI_READ_FRU_DATA_RESPONSE) + FRU_MAX_READ_COUNT];
+  UINT16                       Count;
 
-  FruReadResponse = (IPMI_READ_FRU_DATA_RESPONSE *)&ResponseData;
-  Header          = (FRU_HEADER *)&FruReadResponse->Data;
   // IPMI callout to NetFn Storage 0x0A, command 0x11
   //    Request data:
   //      Byte 1  : Device ID
   //      Byte 2,3: Fru Inventory Offset
   //      Byte 4  : Count to Read
-  CommandData.DeviceId        = DevId;
-  CommandData.InventoryOffset = 0x0000;
-  CommandData.CountToRead     = sizeof (FRU_HEADER);
-
   //    Response data:
   //      Byte 1 : Completion Code
   //      Byte 2 : Count returned
   //      Byte 3 : Data[0]
-  ResponseSize = sizeof (ResponseData);
+  FruData = (IPMI_READ_FRU_DATA_RESPONSE *)&ResponseData;
+  Count   = 0;
+  while (Count < Length) {
+    CommandData.DeviceId        = FruDeviceId;
+    CommandData.InventoryOffset = Offset + Count;
+    CommandData.CountToRead     = (UINT8)MIN (Length - Count, mFruReadCount);
+    ResponseSize                = sizeof (ResponseData);
 
-  Status = IpmiSubmitCommand (
-             IPMI_NETFN_STORAGE,
-             IPMI_STORAGE_READ_FRU_DATA,
-             (UINT8 *)&CommandData,
-             sizeof (CommandData),
-             (UINT8 *)&ResponseData,
-             &ResponseSize
-             );
+    Status = IpmiSubmitCommand (
+               IPMI_NETFN_STORAGE,
+               IPMI_STORAGE_READ_FRU_DATA,
+               (UINT8 *)&CommandData,
+               sizeof (CommandData),
+               (UINT8 *)&ResponseData,
+               &ResponseSize
+               );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: %r returned from IpmiSubmitCommand()\n", __FUNCTION__, Status));
+      return Status;
+    }
+
+    //
+    // The BMC can not return this many bytes in one response, retry with a smaller count
+    //
+    if (((FruData->CompletionCode == FRU_READ_LENGTH_INVALID) ||
+         (FruData->CompletionCode == FRU_READ_LENGTH_EXCEEDED) ||
+         (FruData->CompletionCode == FRU_READ_CANNOT_RETURN_BYTES)) &&
+        (mFruReadCount > FRU_MIN_READ_COUNT))
+    {
+      mFruReadCount = MAX (mFruReadCount / 2, FRU_MIN_READ_COUNT);
+      DEBUG ((DEBUG_INFO, "%a: Completion code = 0x%x, reading %d bytes at a time\n", __FUNCTION__, FruData->CompletionCode, mFruReadCount));
+      continue;
+    }
+
+    if (FruData->CompletionCode != IPMI_COMP_CODE_NORMAL) {
+      DEBUG ((DEBUG_ERROR, "%a: Completion code = 0x%x. Returning\n", __FUNCTION__, FruData->CompletionCode));
+      return EFI_PROTOCOL_ERROR;
+    }
+
+    if ((FruData->CountReturned == 0) ||
+        (FruData->CountReturned > CommandData.CountToRead) ||
+        (ResponseSize < (sizeof (IPMI_READ_FRU_DATA_RESPONSE) + FruData->CountReturned)))
+    {
+      DEBUG ((DEBUG_ERROR, "%a: Invalid count %d returned for FRU %d at 0x%x\n", __FUNCTION__, FruData->CountReturned, FruDeviceId, Offset + Count));
+      return EFI_PROTOCOL_ERROR;
+    }
+
+    CopyMem (&Buffer[Count], FruData->Data, FruData->CountReturned);
+    Count += FruData->CountReturned;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Read the complete FRU Inventory Area of a device.
+
+  @Param  IN  DevIndex       Device Index of the FruDeviceInfo array
+  @Param  OUT Inventory      Allocated FRU Inventory Area contents, NULL if the FRU is empty
+  @Param  OUT InventorySize  Size of the FRU Inventory Area
+
+  @Return   Returns EFI_SUCCESS if no Ipmi protocol errors are encountered.
+**/
+EFI_STATUS
+ReadFruInventory (
+  IN  UINT8   DevIndex,
+  OUT UINT8   **Inventory,
+  OUT UINT16  *InventorySize
+  )
+{
+  EFI_STATUS  Status;
+  UINT16      FruSize;
+  UINT8       *Buffer;
+
+  *Inventory     = NULL;
+  *InventorySize = 0;
+
+  Status = GetFruInventorySize (mFruRecordInfo[DevIndex]->FruDeviceId, &FruSize);
   if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a: %r returned from IpmiSubmitCommand()\n", __FUNCTION__, Status));
     return Status;
   }
 
-  if (FruReadResponse->CompletionCode != IPMI_COMP_CODE_NORMAL) {
-    DEBUG ((DEBUG_ERROR, "%a: Completion code = 0x%x. Returning\n", __FUNCTION__, FruReadResponse->CompletionCode));
-    return EFI_PROTOCOL_ERROR;
+  if (FruSize < 1) {
+    DEBUG ((DEBUG_ERROR, "%a: Invalid FRU Size : %d\n", __FUNCTION__, FruSize));
+    return EFI_SUCCESS;
   }
 
-  if (Header->Version != 1) {
-    DEBUG ((DEBUG_ERROR, "%a: Unknown FRU Header Version, Returning: 0x%x\n", __FUNCTION__, Header->Version));
-    return EFI_PROTOCOL_ERROR;
+  if (FruSize > MAX_FRU_SIZE) {
+    DEBUG ((DEBUG_ERROR, "%a: FRU %d size 0x%x truncated to 0x%x\n", __FUNCTION__, DevIndex, FruSize, MAX_FRU_SIZE));
+    FruSize = MAX_FRU_SIZE;
   }
 
-  // Print the header data
-  // Each of the area offsets are converted in to bytes and printed
-  DEBUG ((DEBUG_VERBOSE, "%a: FRU Area Offsets for Device Id: %d\n", __FUNCTION__, DevId));
-  DEBUG ((DEBUG_VERBOSE, " Header.Version = 0x%x\n", Header->Version));
-  DEBUG ((DEBUG_VERBOSE, " Internal Area Offset = 0x%x\n", Header->Offset.Internal * 8));
-  DEBUG ((DEBUG_VERBOSE, " Chassis Area Offset = 0x%x\n", Header->Offset.Chassis * 8));
-  DEBUG ((DEBUG_VERBOSE, " Board Area Offset = 0x%x\n", Header->Offset.Board * 8));
-  DEBUG ((DEBUG_VERBOSE, " Product Area Offset = 0x%x\n", Header->Offset.Product * 8));
-  DEBUG ((DEBUG_VERBOSE, " Multi Record Area Offset = 0x%x\n", Header->Offset.Multi * 8));
+  Buffer = AllocateZeroPool (FruSize);
+  if (Buffer == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Memory allocation failed, returning\n", __FUNCTION__));
+    return EFI_OUT_OF_RESOURCES;
+  }
 
-  // If a specific area is not present in the Fru data, the area offset will be set to 0x00
-  // Read FRU Chassis Area
-  if (Header->Offset.Chassis * 8 >= sizeof (FRU_HEADER)) {
-    ReadSpecificFruArea (Header->Offset.Chassis * 8, CHASSIS_AREA, DevIndex);
+  Status = ReadFruData (mFruRecordInfo[DevIndex]->FruDeviceId, 0, FruSize, Buffer);
+  if (EFI_ERROR (Status)) {
+    FreePool (Buffer);
+    return Status;
   }
 
-  // Read FRU Board Area
-  if (Header->Offset.Board * 8  >= sizeof (FRU_HEADER)) {
-    ReadSpecificFruArea (Header->Offset.Board * 8, BOARD_AREA, DevIndex);
+  *Inventory     = Buffer;
+  *InventorySize = FruSize;
+  return EFI_SUCCESS;
+}
+
+/**
+  Check that a cached FRU Inventory Area still matches the FRU on the BMC.
+
+  The change indicator does not cover FRU EEPROM contents, so the start of the
+  inventory is read back with a single Read FRU Data command and compared.
+  That covers the common header and its checksum, whose area offsets move with
+  any resize, and all of an inventory that fits in one read. A rewrite that
+  keeps the layout of a larger inventory beyond the first read is not seen.
+
+  @Param  IN  Device         Cached FRU device, followed by its inventory
+
+  @Return   Returns TRUE if the cached FRU is current.
+**/
+STATIC
+BOOLEAN
+FruCacheDeviceIsCurrent (
+  IN FRU_CACHE_DEVICE  *Device
+  )
+{
+  EFI_STATUS  Status;
+  UINT16      FruSize;
+  UINT16      Length;
+  UINT8       Buffer[FRU_MAX_READ_COUNT];
+
+  //
+  // An empty FRU has nothing to read back, only its size can change
+  //
+  if (Device->InventorySize == 0) {
+    Status = GetFruInventorySize (Device->FruDeviceId, &FruSize);
+    return (!EFI_ERROR (Status) && (FruSize == 0));
   }
 
-  // Read FRU Product Area
-  if (Header->Offset.Product * 8 >= sizeof (FRU_HEADER)) {
-    ReadSpecificFruArea (Header->Offset.Product * 8, PRODUCT_AREA, DevIndex);
+  Length = MIN (Device->InventorySize, mFruReadCount);
+  Status = ReadFruData (Device->FruDeviceId, 0, Length, Buffer);
+  if (EFI_ERROR (Status)) {
+    return FALSE;
   }
 
-  // Read FRU Multi Record Area
-  if (Header->Offset.Multi * 8 >= sizeof (FRU_HEADER)) {
-    ReadFruMultiRecordArea (Header->Offset.Multi * 8, DevIndex);
+  if (CompareMem (Buffer, Device + 1, Length) != 0) {
+    DEBUG ((DEBUG_INFO, "%a: FRU %d changed\n", __FUNCTION__, Device->FruDeviceId));
+    return FALSE;
   }
 
-  return EFI_SUCCESS;
+  return TRUE;
+}
+
+/**
+  Delete the FRU cache variable.
+
+**/
+STATIC
+VOID
+DeleteFruCache (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = gRT->SetVariable (FRU_CACHE_VARIABLE_NAME, &gNVIDIATokenSpaceGuid, 0, 0, NULL);
+  if (EFI_ERROR (Status) && (Status != EFI_NOT_FOUND)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to delete FRU cache: %r\n", __FUNCTION__, Status));
+  }
 }
 
 /**
@@ -915,62 +1108,278 @@ ReadFru (
   VOID
   )
 {
-  EFI_STATUS                                 Status;
-  IPMI_GET_FRU_INVENTORY_AREA_INFO_REQUEST   CommandData;
-  IPMI_GET_FRU_INVENTORY_AREA_INFO_RESPONSE  *FruInventoryInfo;
-  UINT32                                     ResponseSize;
-  UINT8                                      DevIndex;
-  UINT16                                     FruSize;
-  UINT8                                      ResponseData[8];
+  EFI_STATUS  Status;
+  UINT8       DevIndex;
 
-  FruInventoryInfo =  (IPMI_GET_FRU_INVENTORY_AREA_INFO_RESPONSE *)&ResponseData;
   for (DevIndex = 0; DevIndex < mRecordCount; DevIndex++) {
     // for each of the device ID in the list, Read the FRU data and populate the structure fields.
-    // Get the FRU inventory Area Information
-    // IPMI callout to NetFn Storage 0x0A, command 0x10
-    //    Request data:
-    //      Byte 1: Device ID
-    CommandData.DeviceId = mFruRecordInfo[DevIndex]->FruDeviceId;
-
-    //    Response data:
-    //      Byte 1    : Completion Code
-    //      Byte 2,3  : Inventory Area Size
-    //      Byte 4    : Access Type
-    ResponseSize = sizeof (ResponseData);
-
-    Status = IpmiSubmitCommand (
-               IPMI_NETFN_STORAGE,
-               IPMI_STORAGE_GET_FRU_INVENTORY_AREAINFO,
-               (UINT8 *)&CommandData,
-               sizeof (CommandData),
-               (UINT8 *)&ResponseData,
-               &ResponseSize
-               );
+    Status = ReadFruInventory (DevIndex, &mFruInventory[DevIndex], &mFruInventorySize[DevIndex]);
     if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "%a: %r returned from IpmiSubmitCommand()\n", __FUNCTION__, Status));
       return Status;
     }
 
-    if (FruInventoryInfo->CompletionCode != IPMI_COMP_CODE_NORMAL) {
-      DEBUG ((DEBUG_ERROR, "%a: Completion code = 0x%x. Returning\n", __FUNCTION__, FruInventoryInfo->CompletionCode));
-      return EFI_PROTOCOL_ERROR;
+    if (mFruInventory[DevIndex] != NULL) {
+      ParseFruHeader (mFruInventory[DevIndex], mFruInventorySize[DevIndex], DevIndex);
     }
+  }
 
-    FruSize = FruInventoryInfo->InventoryAreaSize;
+  PrintRecords ();
+  return EFI_SUCCESS;
+}
 
-    if (FruSize < 1) {
-      DEBUG ((DEBUG_ERROR, "%a: Invalid FRU Size : %d\n", __FUNCTION__, FruSize));
-      continue;
+/**
+  Get the FRU inventory change indicator of the BMC.
+
+  The SDR repository timestamps change whenever FRU device locators are added
+  or removed, and the device id changes with the BMC firmware that owns the
+  FRU contents.
+
+  @Param OUT Indicator   FRU inventory change indicator
+
+  @Return   Returns EFI_SUCCESS if no Ipmi protocol errors are encountered.
+**/
+EFI_STATUS
+GetFruChangeIndicator (
+  OUT FRU_CACHE_HEADER  *Indicator
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      ResponseSize;
+
+  ZeroMem (&Indicator->DeviceId, sizeof (Indicator->DeviceId));
+  ResponseSize = sizeof (Indicator->DeviceId);
+  Status       = IpmiSubmitCommand (
+                   IPMI_NETFN_APP,
+                   IPMI_APP_GET_DEVICE_ID,
+                   NULL,
+                   0,
+                   (UINT8 *)&Indicator->DeviceId,
+                   &ResponseSize
+                   );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: %r returned from IpmiSubmitCommand()\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  if (Indicator->DeviceId.CompletionCode != IPMI_COMP_CODE_NORMAL) {
+    DEBUG ((DEBUG_ERROR, "%a: Completion code = 0x%x. Returning\n", __FUNCTION__, Indicator->DeviceId.CompletionCode));
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  ZeroMem (&Indicator->SdrInfo, sizeof (Indicator->SdrInfo));
+  ResponseSize = sizeof (Indicator->SdrInfo);
+  Status       = IpmiSubmitCommand (
+                   IPMI_NETFN_STORAGE,
+                   IPMI_STORAGE_GET_SDR_REPOSITORY_INFO,
+                   NULL,
+                   0,
+                   (UINT8 *)&Indicator->SdrInfo,
+                   &ResponseSize
+                   );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: %r returned from IpmiSubmitCommand()\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  if (Indicator->SdrInfo.CompletionCode != IPMI_COMP_CODE_NORMAL) {
+    DEBUG ((DEBUG_ERROR, "%a: Completion code = 0x%x. Returning\n", __FUNCTION__, Indicator->SdrInfo.CompletionCode));
+    return EFI_PROTOCOL_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Populate the Fru Records from the FRU cache variable.
+
+  @Param IN Indicator    Current FRU inventory change indicator of the BMC
+
+  @Return   Returns EFI_SUCCESS if the cache is valid for the current FRU inventory.
+**/
+EFI_STATUS
+LoadFruCache (
+  IN FRU_CACHE_HEADER  *Indicator
+  )
+{
+  EFI_STATUS        Status;
+  UINT8             *Cache;
+  UINTN             CacheSize;
+  FRU_CACHE_HEADER  *Header;
+  FRU_CACHE_DEVICE  *Device;
+  UINTN             Offset;
+  UINT8             DevIndex;
+
+  Cache  = NULL;
+  Status = GetVariable2 (FRU_CACHE_VARIABLE_NAME, &gNVIDIATokenSpaceGuid, (VOID **)&Cache, &CacheSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "%a: No FRU cache: %r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  Header = (FRU_CACHE_HEADER *)Cache;
+  if ((CacheSize < sizeof (FRU_CACHE_HEADER)) ||
+      (Header->Version != FRU_CACHE_VERSION) ||
+      (Header->Size != CacheSize) ||
+      (Header->DeviceCount > MAX_NUMBER_OF_FRU_DEVICE_IDS) ||
+      (Header->ReadCount < FRU_MIN_READ_COUNT) ||
+      (CompareMem (&Header->DeviceId, &Indicator->DeviceId, sizeof (Header->DeviceId)) != 0) ||
+      (CompareMem (&Header->SdrInfo, &Indicator->SdrInfo, sizeof (Header->SdrInfo)) != 0))
+  {
+    DEBUG ((DEBUG_INFO, "%a: FRU inventory changed\n", __FUNCTION__));
+    FreePool (Cache);
+    DeleteFruCache ();
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // Validate all entries before creating any records, with the read count
+  // found when the cache was saved
+  //
+  mFruReadCount = Header->ReadCount;
+  Offset        = sizeof (FRU_CACHE_HEADER);
+  for (DevIndex = 0; DevIndex < Header->DeviceCount; DevIndex++) {
+    Device = (FRU_CACHE_DEVICE *)&Cache[Offset];
+    if (((CacheSize - Offset) < sizeof (FRU_CACHE_DEVICE)) ||
+        ((CacheSize - Offset - sizeof (FRU_CACHE_DEVICE)) < Device->InventorySize))
+    {
+      DEBUG ((DEBUG_ERROR, "%a: FRU cache is corrupted\n", __FUNCTION__));
+      FreePool (Cache);
+      DeleteFruCache ();
+      return EFI_VOLUME_CORRUPTED;
     }
 
-    // Read the FRU HEADER, 8 byte size and continue reading fru data if area offsets are valid.
-    ReadFruHeader (mFruRecordInfo[DevIndex]->FruDeviceId, DevIndex);
+    if (!FruCacheDeviceIsCurrent (Device)) {
+      FreePool (Cache);
+      DeleteFruCache ();
+      return EFI_NOT_FOUND;
+    }
+
+    Offset += sizeof (FRU_CACHE_DEVICE) + Device->InventorySize;
   }
 
+  Offset = sizeof (FRU_CACHE_HEADER);
+  for (DevIndex = 0; DevIndex < Header->DeviceCount; DevIndex++) {
+    Device                   = (FRU_CACHE_DEVICE *)&Cache[Offset];
+    mFruRecordInfo[DevIndex] = (FRU_DEVICE_INFO *)AllocateZeroPool (sizeof (FRU_DEVICE_INFO));
+    if (mFruRecordInfo[DevIndex] == NULL) {
+      DEBUG ((DEBUG_ERROR, "%a: Memory allocation failed, returning\n", __FUNCTION__));
+      mRecordCount = DevIndex;
+      FreePool (Cache);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    mFruRecordInfo[DevIndex]->FruDeviceId = Device->FruDeviceId;
+    CopyMem (mFruRecordInfo[DevIndex]->FruDeviceDescription, Device->FruDeviceDescription, sizeof (Device->FruDeviceDescription));
+    mFruRecordInfo[DevIndex]->FruDeviceDescription[MAX_FRU_STR_LENGTH] = '\0';
+
+    if (Device->InventorySize > 0) {
+      ParseFruHeader ((UINT8 *)(Device + 1), Device->InventorySize, DevIndex);
+    }
+
+    Offset += sizeof (FRU_CACHE_DEVICE) + Device->InventorySize;
+  }
+
+  mRecordCount = Header->DeviceCount;
+  FreePool (Cache);
+
+  DEBUG ((DEBUG_INFO, "%a: %d FRUs read from cache\n", __FUNCTION__, mRecordCount));
   PrintRecords ();
   return EFI_SUCCESS;
 }
 
+/**
+  Save the FRU Inventory Areas read from the BMC in the FRU cache variable.
+
+  @Param IN Indicator    FRU inventory change indicator the contents were read with
+
+**/
+VOID
+SaveFruCache (
+  IN FRU_CACHE_HEADER  *Indicator
+  )
+{
+  EFI_STATUS        Status;
+  UINT8             *Cache;
+  UINTN             CacheSize;
+  FRU_CACHE_DEVICE  *Device;
+  UINTN             Offset;
+  UINT8             DevIndex;
+
+  CacheSize = sizeof (FRU_CACHE_HEADER);
+  for (DevIndex = 0; DevIndex < mRecordCount; DevIndex++) {
+    CacheSize += sizeof (FRU_CACHE_DEVICE) + mFruInventorySize[DevIndex];
+  }
+
+  //
+  // A stale cache must not survive a read that can not be cached
+  //
+  if ((CacheSize + StrSize (FRU_CACHE_VARIABLE_NAME)) > PcdGet32 (PcdMaxVariableSize)) {
+    DEBUG ((DEBUG_INFO, "%a: %u byte FRU cache exceeds the maximum variable size\n", __FUNCTION__, CacheSize));
+    DeleteFruCache ();
+    return;
+  }
+
+  Cache = AllocateZeroPool (CacheSize);
+  if (Cache == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Memory allocation failed\n", __FUNCTION__));
+    return;
+  }
+
+  CopyMem (Cache, Indicator, sizeof (FRU_CACHE_HEADER));
+  ((FRU_CACHE_HEADER *)Cache)->Version     = FRU_CACHE_VERSION;
+  ((FRU_CACHE_HEADER *)Cache)->Size        = (UINT32)CacheSize;
+  ((FRU_CACHE_HEADER *)Cache)->ReadCount   = mFruReadCount;
+  ((FRU_CACHE_HEADER *)Cache)->DeviceCount = mRecordCount;
+
+  Offset = sizeof (FRU_CACHE_HEADER);
+  for (DevIndex = 0; DevIndex < mRecordCount; DevIndex++) {
+    Device                = (FRU_CACHE_DEVICE *)&Cache[Offset];
+    Device->FruDeviceId   = mFruRecordInfo[DevIndex]->FruDeviceId;
+    Device->InventorySize = mFruInventorySize[DevIndex];
+    CopyMem (Device->FruDeviceDescription, mFruRecordInfo[DevIndex]->FruDeviceDescription, sizeof (Device->FruDeviceDescription));
+    if (mFruInventorySize[DevIndex] > 0) {
+      CopyMem (Device + 1, mFruInventory[DevIndex], mFruInventorySize[DevIndex]);
+    }
+
+    Offset += sizeof (FRU_CACHE_DEVICE) + mFruInventorySize[DevIndex];
+  }
+
+  Status = gRT->SetVariable (
+                  FRU_CACHE_VARIABLE_NAME,
+                  &gNVIDIATokenSpaceGuid,
+                  EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS,
+                  CacheSize,
+                  Cache
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to save %u byte FRU cache: %r\n", __FUNCTION__, CacheSize, Status));
+    DeleteFruCache ();
+  }
+
+  FreePool (Cache);
+}
+
+/**
+  Free the FRU Inventory Areas read from the BMC.
+
+**/
+VOID
+FreeFruInventory (
+  VOID
+  )
+{
+  UINT8  DevIndex;
+
+  for (DevIndex = 0; DevIndex < MAX_NUMBER_OF_FRU_DEVICE_IDS; DevIndex++) {
+    if (mFruInventory[DevIndex] != NULL) {
+      FreePool (mFruInventory[DevIndex]);
+      mFruInventory[DevIndex] = NULL;
+    }
+
+    mFruInventorySize[DevIndex] = 0;
+  }
+}
+
 /**
   ReadAllFrus
   The Functions Calls the FRU reader functions to get the
@@ -989,13 +1398,39 @@ ReadAllFrus (
   OUT UINT8            *FruCount
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS        Status;
+  EFI_STATUS        IndicatorStatus;
+  FRU_CACHE_HEADER  Indicator;
 
   if ((FruCount == NULL) || (FruInfo == NULL)) {
     DEBUG ((DEBUG_ERROR, "%a: Invalid FruInfo or FrusCount pointer\n", __FUNCTION__));
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // FRU contents only change with the BMC inventory, reuse the last read if it is current
+  //
+  if (PcdGetBool (PcdFruCacheEnable)) {
+    IndicatorStatus = GetFruChangeIndicator (&Indicator);
+  } else {
+    IndicatorStatus = EFI_UNSUPPORTED;
+    DeleteFruCache ();
+  }
+
+  if (!EFI_ERROR (IndicatorStatus)) {
+    Status = LoadFruCache (&Indicator);
+    if (!EFI_ERROR (Status)) {
+      *FruInfo  = mFruRecordInfo;
+      *FruCount = mRecordCount;
+      return EFI_SUCCESS;
+    }
+
+    FreeAllFruRecords ();
+  }
+
+  mFruReadCount = GetFruMaxReadCount ();
+  DEBUG ((DEBUG_INFO, "%a: Reading up to %d FRU bytes at a time\n", __FUNCTION__, mFruReadCount));
+
   Status = UpdateFruDeviceIdList ();
   if ( Status != EFI_SUCCESS) {
     DEBUG ((DEBUG_ERROR, "%a: %r returned from UpdateFruDeviceIdList()", __FUNCTION__, Status));
@@ -1005,9 +1440,16 @@ ReadAllFrus (
   Status = ReadFru ();
   if ( Status != EFI_SUCCESS) {
     DEBUG ((DEBUG_ERROR, "%a: %r returned from ReadFru()", __FUNCTION__, Status));
+    FreeFruInventory ();
     return Status;
   }
 
+  if (!EFI_ERROR (IndicatorStatus)) {
+    SaveFruCache (&Indicator);
+  }
+
+  FreeFruInventory ();
+
   *FruInfo  = mFruRecordInfo;
   *FruCount = mRecordCount;
 
@@ -1101,7 +1543,9 @@ FreeAllFruRecords (
     }
 
     FreePool (mFruRecordInfo[Index]);
+    mFruRecordInfo[Index] = NULL;
   }
 
+  mRecordCount = 0;
   return EFI_SUCCESS;
 }
@@ -20,6 +20,26 @@
 
 #define MAX_FRU_SIZE  0x1000
 
+// Read FRU Data count limits, the count is capped by the transport response
+// size and reduced when the BMC rejects it
+#define FRU_MAX_READ_COUNT            MAX_UINT8
+#define FRU_MIN_READ_COUNT            0x10
+#define FRU_READ_LENGTH_INVALID       0xC7
+#define FRU_READ_LENGTH_EXCEEDED      0xC8
+#define FRU_READ_CANNOT_RETURN_BYTES  0xCA
+
+// Transport capability commands, IPMI 2.0 sections 22.9 and 22.10
+#define FRU_GET_BT_INTERFACE_CAPABILITIES      0x36
+#define FRU_GET_SYSTEM_INTERFACE_CAPABILITIES  0x57
+#define FRU_SYSTEM_INTERFACE_SSIF              0x00
+
+// Message bytes outside of the response data: NetFn/LUN and Cmd, plus length and sequence for BT
+#define FRU_SSIF_MESSAGE_OVERHEAD  2
+#define FRU_BT_MESSAGE_OVERHEAD    4
+
+#define FRU_CACHE_VARIABLE_NAME  L"FruCache"
+#define FRU_CACHE_VERSION        2
+
 #define IPMI_MULTI_RECORD_HEADER_RESPONSE_SIZE   \
   (sizeof (IPMI_READ_FRU_DATA_RESPONSE) + sizeof (FRU_MULTI_RECORD_HEADER))
 
@@ -85,3 +105,43 @@ typedef enum {
   BOARD_AREA,
   PRODUCT_AREA
 } AREA_TYPE;
+
+#pragma pack(1)
+
+typedef struct {
+  UINT8    CompletionCode;
+  UINT8    Reserved;
+  UINT8    TransactionSupport;
+  UINT8    InputMessageSize;
+  UINT8    OutputMessageSize;
+} FRU_SSIF_CAPABILITIES_RESPONSE;
+
+typedef struct {
+  UINT8    CompletionCode;
+  UINT8    OutstandingRequests;
+  UINT8    InputBufferSize;
+  UINT8    OutputBufferSize;
+  UINT8    RequestToResponseTime;
+  UINT8    RecommendedRetries;
+} FRU_BT_CAPABILITIES_RESPONSE;
+
+//
+// FRU cache variable, the header is followed by DeviceCount FRU_CACHE_DEVICE
+// entries, each followed by InventorySize bytes of FRU Inventory Area
+//
+typedef struct {
+  UINT32                                   Version;
+  UINT32                                   Size;
+  IPMI_GET_DEVICE_ID_RESPONSE              DeviceId;
+  IPMI_GET_SDR_REPOSITORY_INFO_RESPONSE    SdrInfo;
+  UINT8                                    ReadCount;
+  UINT8                                    DeviceCount;
+} FRU_CACHE_HEADER;
+
+typedef struct {
+  UINT8     FruDeviceId;
+  CHAR8     FruDeviceDescription[MAX_FRU_STR_LENGTH + 1];
+  UINT16    InventorySize;
+} FRU_CACHE_DEVICE;
+
+#pragma pack()
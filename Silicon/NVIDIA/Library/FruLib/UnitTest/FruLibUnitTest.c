@@ -0,0 +1,658 @@
+/** @file
+
+  FRU library unit test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/FruLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/UnitTestLib.h>
+#include <IndustryStandard/Ipmi.h>
+#include <IndustryStandard/IpmiNetFnStorage.h>
+#include <HostBasedTestStubLib/UefiRuntimeServicesTableStubLib.h>
+
+#include "../FruLibPrivate.h"
+
+#define UNIT_TEST_NAME     "FRU Library Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_FRU_COUNT     2
+#define TEST_FRU_MAX_SIZE  512
+#define TEST_SSIF_SIZE     0x24
+
+#define TEST_COMP_CODE_INVALID_COMMAND  0xC1
+#define TEST_COMP_CODE_INVALID_DATA     0xCC
+
+typedef enum {
+  TestChangeFruContents,
+  TestChangeSdrRepository,
+  TestChangeDeviceId
+} TEST_FRU_CHANGE;
+
+//
+// Simulated BMC with one FRU device locator SDR per FRU, answering the
+// commands the FRU library sends and counting them.
+//
+typedef struct {
+  UINT8          DeviceId;
+  CONST CHAR8    *Description;
+  UINT16         Size;
+  UINT8          Data[TEST_FRU_MAX_SIZE];
+} TEST_FRU;
+
+typedef struct {
+  TEST_FRU                                 Fru[TEST_FRU_COUNT];
+  IPMI_GET_DEVICE_ID_RESPONSE              DeviceId;
+  IPMI_GET_SDR_REPOSITORY_INFO_RESPONSE    SdrInfo;
+  UINT8                                    SsifOutputSize;
+  UINTN                                    Commands;
+  UINTN                                    SdrCommands;
+  UINTN                                    ReadCommands;
+  UINTN                                    ReadBytes;
+  UINTN                                    RejectedReads;
+  UINTN                                    LargestRead;
+} TEST_BMC;
+
+STATIC TEST_BMC  mBmc;
+
+/**
+  Calculate the zero checksum of a FRU header or area.
+
+  @param[in]  Data   Bytes to sum
+  @param[in]  Size   Number of bytes to sum
+
+  @retval Byte that makes the sum of Data and itself zero
+**/
+STATIC
+UINT8
+TestChecksum (
+  IN CONST UINT8  *Data,
+  IN UINTN        Size
+  )
+{
+  UINT8  Sum;
+
+  Sum = 0;
+  while (Size-- > 0) {
+    Sum += *Data++;
+  }
+
+  return (UINT8)(0 - Sum);
+}
+
+/**
+  Add an 8-bit ASCII field to a FRU area.
+
+  @param[in]  Area     FRU area
+  @param[in]  Offset   Offset of the field in the area
+  @param[in]  String   Field contents
+
+  @retval Offset of the next field
+**/
+STATIC
+UINTN
+TestAddField (
+  IN UINT8        *Area,
+  IN UINTN        Offset,
+  IN CONST CHAR8  *String
+  )
+{
+  UINTN  Length;
+
+  Length         = AsciiStrLen (String);
+  Area[Offset++] = (UINT8)(0xC0 | Length);
+  CopyMem (&Area[Offset], String, Length);
+  return Offset + Length;
+}
+
+/**
+  Fill a simulated FRU with a common header and a board area.
+
+  @param[in]  Fru      FRU to fill
+  @param[in]  Size     FRU inventory size, a multiple of 8
+  @param[in]  Serial   Board serial number
+**/
+STATIC
+VOID
+TestBuildFru (
+  IN TEST_FRU     *Fru,
+  IN UINT16       Size,
+  IN CONST CHAR8  *Serial
+  )
+{
+  FRU_HEADER  *Header;
+  UINT8       *Area;
+  UINTN       AreaSize;
+  UINTN       Offset;
+
+  ZeroMem (Fru->Data, sizeof (Fru->Data));
+  Fru->Size = Size;
+
+  Header                = (FRU_HEADER *)Fru->Data;
+  Header->Version       = 1;
+  Header->Offset.Board  = sizeof (FRU_HEADER) / 8;
+  Header->Checksum      = TestChecksum (Fru->Data, sizeof (FRU_HEADER) - 1);
+
+  // Area version, length, language code and manufacturing date
+  Area     = &Fru->Data[sizeof (FRU_HEADER)];
+  AreaSize = Size - sizeof (FRU_HEADER);
+  Area[0]  = 1;
+  Area[1]  = (UINT8)(AreaSize / 8);
+  Offset   = 6;
+
+  Offset         = TestAddField (Area, Offset, "NVIDIA");
+  Offset         = TestAddField (Area, Offset, Fru->Description);
+  Offset         = TestAddField (Area, Offset, Serial);
+  Offset         = TestAddField (Area, Offset, "699-0001");
+  Area[Offset++] = FRU_END_OF_FIELDS;
+
+  Area[AreaSize - 1] = TestChecksum (Area, AreaSize - 1);
+}
+
+/**
+  Find a simulated FRU by its FRU device id.
+
+  @param[in]  DeviceId   FRU device id
+
+  @retval Simulated FRU, NULL if there is none
+**/
+STATIC
+TEST_FRU *
+TestFindFru (
+  IN UINT8  DeviceId
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < TEST_FRU_COUNT; Index++) {
+    if (mBmc.Fru[Index].DeviceId == DeviceId) {
+      return &mBmc.Fru[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Answer Get SDR with the FRU device locator record of a simulated FRU.
+  Record ids start at 1, record id 0 is the first record.
+
+  @param[in]   Request        Get SDR request
+  @param[out]  Response       Get SDR response
+  @param[in]   ResponseSize   Size of the response buffer
+**/
+STATIC
+VOID
+TestGetSdr (
+  IN  IPMI_GET_SDR_REQUEST   *Request,
+  OUT IPMI_GET_SDR_RESPONSE  *Response,
+  IN  UINT32                 ResponseSize
+  )
+{
+  IPMI_SDR_RECORD_STRUCT_11  *Record;
+  TEST_FRU                   *Fru;
+  UINTN                      Index;
+
+  Index = (Request->RecordId == 0) ? 0 : Request->RecordId - 1;
+  ASSERT (Index < TEST_FRU_COUNT);
+  Fru = &mBmc.Fru[Index];
+
+  ZeroMem (Response, ResponseSize);
+  Response->CompletionCode                      = IPMI_COMP_CODE_NORMAL;
+  Response->NextRecordId                        = ((Index + 1) < TEST_FRU_COUNT) ? (UINT16)(Index + 2) : END_OF_SDR_RECORDS;
+  Response->RecordData.SensorHeader.RecordId    = (UINT16)(Index + 1);
+  Response->RecordData.SensorHeader.RecordType  = SDR_RECORD_TYPE_FRU_DEVICE_LOCATOR;
+  Record                                        = &Response->RecordData.SensorType11;
+  Record->FruDeviceData.Bits.FruDeviceId        = Fru->DeviceId;
+  Record->StringTypeLength.Bits.Length          = (UINT8)AsciiStrLen (Fru->Description);
+  CopyMem (Record->String, Fru->Description, AsciiStrLen (Fru->Description));
+}
+
+/**
+  Answer Read FRU Data from a simulated FRU, rejecting counts that do not fit
+  in one SSIF response.
+
+  @param[in]   Request        Read FRU Data request
+  @param[out]  Response       Read FRU Data response
+  @param[out]  ResponseSize   Size of the response
+
+**/
+STATIC
+VOID
+TestReadFruData (
+  IN  IPMI_READ_FRU_DATA_REQUEST   *Request,
+  OUT IPMI_READ_FRU_DATA_RESPONSE  *Response,
+  IN OUT UINT32                    *ResponseSize
+  )
+{
+  TEST_FRU  *Fru;
+  UINTN     Count;
+
+  mBmc.ReadCommands++;
+  mBmc.LargestRead = MAX (mBmc.LargestRead, Request->CountToRead);
+
+  if ((mBmc.SsifOutputSize != 0) &&
+      ((FRU_SSIF_MESSAGE_OVERHEAD + sizeof (IPMI_READ_FRU_DATA_RESPONSE) + Request->CountToRead) > mBmc.SsifOutputSize))
+  {
+    mBmc.RejectedReads++;
+    Response->CompletionCode = FRU_READ_CANNOT_RETURN_BYTES;
+    *ResponseSize            = 1;
+    return;
+  }
+
+  Fru = TestFindFru (Request->DeviceId);
+  ASSERT (Fru != NULL);
+  ASSERT (Request->InventoryOffset < Fru->Size);
+
+  Count = MIN (Request->CountToRead, Fru->Size - Request->InventoryOffset);
+  ASSERT (*ResponseSize >= sizeof (IPMI_READ_FRU_DATA_RESPONSE) + Count);
+
+  Response->CompletionCode = IPMI_COMP_CODE_NORMAL;
+  Response->CountReturned  = (UINT8)Count;
+  CopyMem (Response->Data, &Fru->Data[Request->InventoryOffset], Count);
+  *ResponseSize   = (UINT32)(sizeof (IPMI_READ_FRU_DATA_RESPONSE) + Count);
+  mBmc.ReadBytes += Count;
+}
+
+/**
+  Simulated BMC handling of the IPMI commands sent by the FRU library.
+
+**/
+EFI_STATUS
+__wrap_IpmiSubmitCommand (
+  IN     UINT8   NetFunction,
+  IN     UINT8   Command,
+  IN     UINT8   *RequestData,
+  IN     UINT32  RequestDataSize,
+  OUT    UINT8   *ResponseData,
+  IN OUT UINT32  *ResponseDataSize
+  )
+{
+  FRU_SSIF_CAPABILITIES_RESPONSE             *Ssif;
+  IPMI_GET_FRU_INVENTORY_AREA_INFO_RESPONSE  *Info;
+  TEST_FRU                                   *Fru;
+
+  mBmc.Commands++;
+
+  if ((NetFunction == IPMI_NETFN_APP) && (Command == IPMI_APP_GET_DEVICE_ID)) {
+    ASSERT (*ResponseDataSize >= sizeof (mBmc.DeviceId));
+    CopyMem (ResponseData, &mBmc.DeviceId, sizeof (mBmc.DeviceId));
+    *ResponseDataSize = sizeof (mBmc.DeviceId);
+  } else if ((NetFunction == IPMI_NETFN_APP) && (Command == FRU_GET_SYSTEM_INTERFACE_CAPABILITIES)) {
+    if ((mBmc.SsifOutputSize == 0) || (*RequestData != FRU_SYSTEM_INTERFACE_SSIF)) {
+      ResponseData[0]   = TEST_COMP_CODE_INVALID_DATA;
+      *ResponseDataSize = 1;
+    } else {
+      Ssif = (FRU_SSIF_CAPABILITIES_RESPONSE *)ResponseData;
+      ZeroMem (Ssif, sizeof (*Ssif));
+      Ssif->InputMessageSize  = mBmc.SsifOutputSize;
+      Ssif->OutputMessageSize = mBmc.SsifOutputSize;
+      *ResponseDataSize       = sizeof (*Ssif);
+    }
+  } else if (NetFunction != IPMI_NETFN_STORAGE) {
+    ResponseData[0]   = TEST_COMP_CODE_INVALID_COMMAND;
+    *ResponseDataSize = 1;
+  } else if (Command == IPMI_STORAGE_GET_SDR_REPOSITORY_INFO) {
+    ASSERT (*ResponseDataSize >= sizeof (mBmc.SdrInfo));
+    CopyMem (ResponseData, &mBmc.SdrInfo, sizeof (mBmc.SdrInfo));
+    *ResponseDataSize = sizeof (mBmc.SdrInfo);
+  } else if (Command == IPMI_STORAGE_GET_SDR) {
+    mBmc.SdrCommands++;
+    TestGetSdr ((IPMI_GET_SDR_REQUEST *)RequestData, (IPMI_GET_SDR_RESPONSE *)ResponseData, *ResponseDataSize);
+  } else if (Command == IPMI_STORAGE_GET_FRU_INVENTORY_AREAINFO) {
+    Fru = TestFindFru (*RequestData);
+    ASSERT (Fru != NULL);
+    Info = (IPMI_GET_FRU_INVENTORY_AREA_INFO_RESPONSE *)ResponseData;
+    ZeroMem (Info, sizeof (*Info));
+    Info->InventoryAreaSize = Fru->Size;
+    *ResponseDataSize       = sizeof (*Info);
+  } else if (Command == IPMI_STORAGE_READ_FRU_DATA) {
+    TestReadFruData ((IPMI_READ_FRU_DATA_REQUEST *)RequestData, (IPMI_READ_FRU_DATA_RESPONSE *)ResponseData, ResponseDataSize);
+  } else {
+    ResponseData[0]   = TEST_COMP_CODE_INVALID_COMMAND;
+    *ResponseDataSize = 1;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Clear the simulated BMC command counters.
+
+**/
+STATIC
+VOID
+TestResetCounters (
+  VOID
+  )
+{
+  mBmc.Commands      = 0;
+  mBmc.SdrCommands   = 0;
+  mBmc.ReadCommands  = 0;
+  mBmc.ReadBytes     = 0;
+  mBmc.RejectedReads = 0;
+  mBmc.LargestRead   = 0;
+}
+
+/**
+  Read all FRUs and check the board serial numbers they report.
+
+  @param[in]  Serial0   Expected board serial number of the first FRU
+  @param[in]  Serial1   Expected board serial number of the second FRU
+
+  @retval  UNIT_TEST_PASSED             The FRUs were read as expected.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+TestReadAllFrus (
+  IN CONST CHAR8  *Serial0,
+  IN CONST CHAR8  *Serial1
+  )
+{
+  FRU_DEVICE_INFO  **FruInfo;
+  UINT8            FruCount;
+
+  FreeAllFruRecords ();
+  TestResetCounters ();
+
+  UT_ASSERT_NOT_EFI_ERROR (ReadAllFrus (&FruInfo, &FruCount));
+  UT_ASSERT_EQUAL (FruCount, TEST_FRU_COUNT);
+
+  UT_ASSERT_EQUAL (FruInfo[0]->FruDeviceId, mBmc.Fru[0].DeviceId);
+  UT_ASSERT_EQUAL (AsciiStrCmp (FruInfo[0]->FruDeviceDescription, mBmc.Fru[0].Description), 0);
+  UT_ASSERT_NOT_NULL (FruInfo[0]->BoardSerial);
+  UT_ASSERT_EQUAL (AsciiStrCmp (FruInfo[0]->BoardSerial, Serial0), 0);
+
+  UT_ASSERT_EQUAL (FruInfo[1]->FruDeviceId, mBmc.Fru[1].DeviceId);
+  UT_ASSERT_NOT_NULL (FruInfo[1]->BoardSerial);
+  UT_ASSERT_EQUAL (AsciiStrCmp (FruInfo[1]->BoardSerial, Serial1), 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that the FRUs were read from the BMC, rather than from the cache. The
+  reads that found the cache stale may come first.
+
+  @retval  UNIT_TEST_PASSED             The FRUs were read from the BMC.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+TestCheckFullRead (
+  VOID
+  )
+{
+  UT_ASSERT_EQUAL (mBmc.SdrCommands, 2 * TEST_FRU_COUNT);
+  UT_ASSERT_TRUE (mBmc.ReadBytes >= mBmc.Fru[0].Size + mBmc.Fru[1].Size);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Set up the simulated BMC and an empty variable store.
+
+  @param[in]  Context    Unused
+
+  @retval  UNIT_TEST_PASSED   Setup succeeded.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FruTestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ZeroMem (&mBmc, sizeof (mBmc));
+
+  mBmc.Fru[0].DeviceId    = 1;
+  mBmc.Fru[0].Description = "Board";
+  TestBuildFru (&mBmc.Fru[0], 64, "B0001");
+
+  // Larger than one Read FRU Data command
+  mBmc.Fru[1].DeviceId    = 2;
+  mBmc.Fru[1].Description = "Module";
+  TestBuildFru (&mBmc.Fru[1], TEST_FRU_MAX_SIZE, "M0001");
+
+  mBmc.DeviceId.DeviceId               = 0x20;
+  mBmc.SdrInfo.Version                 = 0x51;
+  mBmc.SdrInfo.RecordCount             = TEST_FRU_COUNT;
+  mBmc.SdrInfo.RecentAdditionTimeStamp = 0x1000;
+
+  UefiRuntimeServicesTableInit (FALSE);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Free the FRU records and the variable store.
+
+  @param[in]  Context    Unused
+**/
+STATIC
+VOID
+EFIAPI
+FruTestCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FreeAllFruRecords ();
+  UefiRuntimeServicesTableDeinit (FALSE);
+}
+
+/**
+  Without a cache, every FRU is read from the BMC and then cached.
+
+  @param[in]  Context    Unused
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FruCacheMiss (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  CacheSize;
+
+  UT_ASSERT_EQUAL (TestReadAllFrus ("B0001", "M0001"), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestCheckFullRead (), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mBmc.RejectedReads, 0);
+
+  CacheSize = 0;
+  UT_ASSERT_STATUS_EQUAL (
+    gRT->GetVariable (FRU_CACHE_VARIABLE_NAME, &gNVIDIATokenSpaceGuid, NULL, &CacheSize, NULL),
+    EFI_BUFFER_TOO_SMALL
+    );
+  UT_ASSERT_TRUE (CacheSize > mBmc.Fru[0].Size + mBmc.Fru[1].Size);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  With a current cache, each FRU is revalidated with one Read FRU Data
+  command after the change indicator is read.
+
+  @param[in]  Context    Unused
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FruCacheHit (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UT_ASSERT_EQUAL (TestReadAllFrus ("B0001", "M0001"), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestReadAllFrus ("B0001", "M0001"), UNIT_TEST_PASSED);
+
+  // Get Device ID and Get SDR Repository Info, then one read per FRU
+  UT_ASSERT_EQUAL (mBmc.SdrCommands, 0);
+  UT_ASSERT_EQUAL (mBmc.ReadCommands, TEST_FRU_COUNT);
+  UT_ASSERT_EQUAL (mBmc.Commands, 2 + TEST_FRU_COUNT);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A change to the FRU contents or to the change indicator invalidates the
+  cache, and the FRUs are read from the BMC again.
+
+  @param[in]  Context    TEST_FRU_CHANGE to make
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FruCacheInvalidate (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST CHAR8  *Serial1;
+
+  UT_ASSERT_EQUAL (TestReadAllFrus ("B0001", "M0001"), UNIT_TEST_PASSED);
+
+  Serial1 = "M0001";
+  switch ((TEST_FRU_CHANGE)(UINTN)Context) {
+    case TestChangeFruContents:
+      Serial1 = "M0002";
+      TestBuildFru (&mBmc.Fru[1], mBmc.Fru[1].Size, Serial1);
+      break;
+    case TestChangeSdrRepository:
+      mBmc.SdrInfo.RecentAdditionTimeStamp++;
+      break;
+    case TestChangeDeviceId:
+      mBmc.DeviceId.MinorFirmwareRev++;
+      break;
+  }
+
+  UT_ASSERT_EQUAL (TestReadAllFrus ("B0001", Serial1), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestCheckFullRead (), UNIT_TEST_PASSED);
+
+  // The new contents are cached
+  UT_ASSERT_EQUAL (TestReadAllFrus ("B0001", Serial1), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mBmc.SdrCommands, 0);
+  UT_ASSERT_EQUAL (mBmc.Commands, 2 + TEST_FRU_COUNT);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The Read FRU Data count is capped by the SSIF response size, and the cache
+  keeps that count for revalidation.
+
+  @param[in]  Context    Unused
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+FruReadCountCap (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  ReadCount;
+
+  mBmc.SsifOutputSize = TEST_SSIF_SIZE;
+  ReadCount           = TEST_SSIF_SIZE - FRU_SSIF_MESSAGE_OVERHEAD - sizeof (IPMI_READ_FRU_DATA_RESPONSE);
+
+  UT_ASSERT_EQUAL (TestReadAllFrus ("B0001", "M0001"), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (TestCheckFullRead (), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mBmc.RejectedReads, 0);
+  UT_ASSERT_EQUAL (mBmc.LargestRead, ReadCount);
+  UT_ASSERT_EQUAL (
+    mBmc.ReadCommands,
+    (mBmc.Fru[0].Size + ReadCount - 1) / ReadCount + (mBmc.Fru[1].Size + ReadCount - 1) / ReadCount
+    );
+
+  UT_ASSERT_EQUAL (TestReadAllFrus ("B0001", "M0001"), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mBmc.RejectedReads, 0);
+  UT_ASSERT_EQUAL (mBmc.Commands, 2 + TEST_FRU_COUNT);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the FRU
+  library and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CacheTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&CacheTests, Framework, "FRU Cache Tests", "UnitTest.FruCache", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for FRU Cache Tests\n"));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AddTestCase (CacheTests, "FRUs read from the BMC and cached", "FruCacheMiss", FruCacheMiss, FruTestSetup, FruTestCleanup, NULL);
+  AddTestCase (CacheTests, "FRUs revalidated with one read each", "FruCacheHit", FruCacheHit, FruTestSetup, FruTestCleanup, NULL);
+  AddTestCase (CacheTests, "Cache invalidated by FRU contents", "FruCacheInvalidateContents", FruCacheInvalidate, FruTestSetup, FruTestCleanup, (UNIT_TEST_CONTEXT)TestChangeFruContents);
+  AddTestCase (CacheTests, "Cache invalidated by SDR repository", "FruCacheInvalidateSdr", FruCacheInvalidate, FruTestSetup, FruTestCleanup, (UNIT_TEST_CONTEXT)TestChangeSdrRepository);
+  AddTestCase (CacheTests, "Cache invalidated by device id", "FruCacheInvalidateDeviceId", FruCacheInvalidate, FruTestSetup, FruTestCleanup, (UNIT_TEST_CONTEXT)TestChangeDeviceId);
+  AddTestCase (CacheTests, "Read count capped by the SSIF response size", "FruReadCountCap", FruReadCountCap, FruTestSetup, FruTestCleanup, NULL);
+
+  // Execute the tests.
+  return RunAllTestSuites (Framework);
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
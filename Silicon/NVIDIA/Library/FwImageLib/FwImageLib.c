@@ -12,6 +12,7 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/FwImageLib.h>
+#include <Library/GptLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Uefi/UefiBaseType.h>
@@ -19,6 +20,11 @@
 STATIC UINTN                     mNumImages  = 0;
 STATIC NVIDIA_FW_IMAGE_PROTOCOL  **mFwImages = NULL;
 
+// image name hash buckets and chains, holding image index + 1, 0 ends a chain
+STATIC UINT32  *mNameHash    = NULL;
+STATIC UINT32  *mNameNext    = NULL;
+STATIC UINT32  mNameHashSize = 0;
+
 NVIDIA_FW_IMAGE_PROTOCOL *
 EFIAPI
 FwImageFindProtocol (
@@ -26,22 +32,23 @@ FwImageFindProtocol (
   )
 {
   NVIDIA_FW_IMAGE_PROTOCOL  *Protocol;
-  UINTN                     ProtocolIndex;
-
-  Protocol = NULL;
-  for (ProtocolIndex = 0; ProtocolIndex < mNumImages; ProtocolIndex++) {
-    if (StrnCmp (
-          mFwImages[ProtocolIndex]->ImageName,
-          Name,
-          FW_IMAGE_NAME_LENGTH
-          ) == 0)
-    {
-      Protocol = mFwImages[ProtocolIndex];
-      break;
+  UINT32                    Index;
+
+  if (mNameHash == NULL) {
+    return NULL;
+  }
+
+  Index = mNameHash[GptPartitionNameHash (Name) & (mNameHashSize - 1)];
+  while (Index != 0) {
+    Protocol = mFwImages[Index - 1];
+    if (StrnCmp (Protocol->ImageName, Name, FW_IMAGE_NAME_LENGTH) == 0) {
+      return Protocol;
     }
+
+    Index = mNameNext[Index - 1];
   }
 
-  return Protocol;
+  return NULL;
 }
 
 UINTN
@@ -83,6 +90,7 @@ FwImageLibConstructor (
   UINTN       Index;
   UINTN       NumHandles;
   EFI_HANDLE  *HandleBuffer;
+  UINT32      Bucket;
 
   HandleBuffer = NULL;
   Status       = gBS->LocateHandleBuffer (
@@ -112,6 +120,19 @@ FwImageLibConstructor (
     goto Done;
   }
 
+  mNameHashSize = 1;
+  while (mNameHashSize < 2 * NumHandles) {
+    mNameHashSize <<= 1;
+  }
+
+  mNameHash = (UINT32 *)AllocateRuntimeZeroPool (mNameHashSize * sizeof (UINT32));
+  mNameNext = (UINT32 *)AllocateRuntimeZeroPool (NumHandles * sizeof (UINT32));
+  if ((mNameHash == NULL) || (mNameNext == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    DEBUG ((DEBUG_ERROR, "%a: name index allocate failed\n", __FUNCTION__));
+    goto Done;
+  }
+
   mNumImages = 0;
   for (Index = 0; Index < NumHandles; Index++) {
     Status = gBS->HandleProtocol (
@@ -149,6 +170,9 @@ FwImageLibConstructor (
       goto Done;
     }
 
+    Bucket            = GptPartitionNameHash (mFwImages[Index]->ImageName) & (mNameHashSize - 1);
+    mNameNext[Index]  = mNameHash[Bucket];
+    mNameHash[Bucket] = (UINT32)(Index + 1);
     mNumImages++;
   }
 
@@ -164,7 +188,18 @@ Done:
       mFwImages = NULL;
     }
 
-    mNumImages = 0;
+    if (mNameHash != NULL) {
+      FreePool (mNameHash);
+      mNameHash = NULL;
+    }
+
+    if (mNameNext != NULL) {
+      FreePool (mNameNext);
+      mNameNext = NULL;
+    }
+
+    mNameHashSize = 0;
+    mNumImages    = 0;
   }
 
   // If an error occurred above, library API reports no images.
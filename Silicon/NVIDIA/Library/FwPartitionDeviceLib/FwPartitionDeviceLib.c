@@ -2,7 +2,7 @@
 
   FW Partition Device Library
 
-  Copyright (c) 2021-2022 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2021-2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -17,12 +17,29 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Uefi/UefiBaseType.h>
 
+#define FW_PARTITION_NAME_HASH_SIZE   256
+#define FW_PARTITION_MAX_GPT_DEVICES  4
+
+// GPT read and validated once per device
+typedef struct {
+  FW_PARTITION_DEVICE_INFO    *DeviceInfo;
+  UINT64                      DeviceSizeInBytes;
+  GPT_TABLE                   Table;
+} FW_PARTITION_GPT_CACHE;
+
 STATIC FW_PARTITION_PRIVATE_DATA  *mPrivate                   = NULL;
 STATIC UINTN                      mNumFwPartitions            = 0;
 STATIC UINTN                      mMaxFwPartitions            = 0;
 STATIC UINT32                     mActiveBootChain            = MAX_UINT32;
 STATIC BOOLEAN                    mOverwriteActiveFwPartition = FALSE;
 
+// name hash buckets and chains, holding partition index + 1, 0 ends a chain
+STATIC UINT32  mNameHash[FW_PARTITION_NAME_HASH_SIZE];
+STATIC UINT32  *mNameNext = NULL;
+
+STATIC FW_PARTITION_GPT_CACHE  mGptCache[FW_PARTITION_MAX_GPT_DEVICES];
+STATIC UINTN                   mNumGptCache = 0;
+
 // non-A/B partition names
 STATIC CONST CHAR16  *NonABPartitionNames[] = {
   L"BCT",
@@ -280,6 +297,163 @@ FwPartitionWrite (
   return Status;
 }
 
+// NVIDIA_FW_PARTITION_PROTOCOL.Flush()
+EFI_STATUS
+EFIAPI
+FwPartitionFlush (
+  IN  NVIDIA_FW_PARTITION_PROTOCOL  *This
+  )
+{
+  FW_PARTITION_PRIVATE_DATA  *Private;
+  FW_PARTITION_DEVICE_INFO   *DeviceInfo;
+  EFI_STATUS                 Status;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Private = CR (
+              This,
+              FW_PARTITION_PRIVATE_DATA,
+              Protocol,
+              FW_PARTITION_PRIVATE_DATA_SIGNATURE
+              );
+  DeviceInfo = Private->DeviceInfo;
+
+  if (DeviceInfo->DeviceFlush == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Status = DeviceInfo->DeviceFlush (DeviceInfo);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: flush of %s failed: %r\n",
+      __FUNCTION__,
+      Private->PartitionInfo.Name,
+      Status
+      ));
+  }
+
+  return Status;
+}
+
+// NVIDIA_FW_PARTITION_PROTOCOL.EraseAsync()
+EFI_STATUS
+EFIAPI
+FwPartitionEraseAsync (
+  IN  NVIDIA_FW_PARTITION_PROTOCOL  *This,
+  IN  UINT64                        Offset,
+  IN  UINTN                         Bytes
+  )
+{
+  FW_PARTITION_PRIVATE_DATA  *Private;
+  FW_PARTITION_INFO          *PartitionInfo;
+  FW_PARTITION_DEVICE_INFO   *DeviceInfo;
+  EFI_STATUS                 Status;
+  UINT64                     EraseStart;
+  UINT64                     EraseEnd;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Private = CR (
+              This,
+              FW_PARTITION_PRIVATE_DATA,
+              Protocol,
+              FW_PARTITION_PRIVATE_DATA_SIGNATURE
+              );
+  PartitionInfo = &Private->PartitionInfo;
+  DeviceInfo    = Private->DeviceInfo;
+
+  if (DeviceInfo->DeviceEraseAsync == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  // the device erases whole blocks, which must not reach past the partition
+  Status = FwPartitionCheckOffsetAndBytes (PartitionInfo->Bytes, Offset, Bytes);
+  if (!EFI_ERROR (Status)) {
+    EraseStart = PartitionInfo->Offset + Offset;
+    EraseEnd   = ALIGN_VALUE (EraseStart + Bytes, (UINT64)DeviceInfo->BlockSize);
+    if (((EraseStart % DeviceInfo->BlockSize) != 0) ||
+        (EraseEnd > PartitionInfo->Offset + PartitionInfo->Bytes))
+    {
+      Status = EFI_INVALID_PARAMETER;
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: %s erase offset=%llu, bytes=%u error: %r\n",
+      __FUNCTION__,
+      PartitionInfo->Name,
+      Offset,
+      Bytes,
+      Status
+      ));
+    return Status;
+  }
+
+  if (PartitionInfo->IsActivePartition && !mOverwriteActiveFwPartition) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "Erasing active %s partition not allowed\n",
+      PartitionInfo->Name
+      ));
+    return EFI_WRITE_PROTECTED;
+  }
+
+  Status = DeviceInfo->DeviceEraseAsync (
+                         DeviceInfo,
+                         Offset + PartitionInfo->Offset,
+                         Bytes
+                         );
+  if (EFI_ERROR (Status) && (Status != EFI_ALREADY_STARTED)) {
+    DEBUG ((
+      DEBUG_INFO,
+      "%a: erase of %s, Offset=%llu, Bytes=%u not started: %r\n",
+      __FUNCTION__,
+      PartitionInfo->Name,
+      Offset,
+      Bytes,
+      Status
+      ));
+  }
+
+  return Status;
+}
+
+// NVIDIA_FW_PARTITION_PROTOCOL.ErasePoll()
+EFI_STATUS
+EFIAPI
+FwPartitionErasePoll (
+  IN  NVIDIA_FW_PARTITION_PROTOCOL  *This
+  )
+{
+  FW_PARTITION_PRIVATE_DATA  *Private;
+  FW_PARTITION_DEVICE_INFO   *DeviceInfo;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Private = CR (
+              This,
+              FW_PARTITION_PRIVATE_DATA,
+              Protocol,
+              FW_PARTITION_PRIVATE_DATA_SIGNATURE
+              );
+  DeviceInfo = Private->DeviceInfo;
+
+  if (DeviceInfo->DeviceErasePoll == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return DeviceInfo->DeviceErasePoll (DeviceInfo);
+}
+
 EFI_STATUS
 EFIAPI
 FwPartitionAdd (
@@ -291,6 +465,7 @@ FwPartitionAdd (
 {
   FW_PARTITION_PRIVATE_DATA  *Private;
   FW_PARTITION_INFO          *PartitionInfo;
+  UINT32                     Bucket;
 
   if (mNumFwPartitions >= mMaxFwPartitions) {
     DEBUG ((
@@ -328,8 +503,15 @@ FwPartitionAdd (
   Private->Protocol.PartitionName = Private->PartitionInfo.Name;
   Private->Protocol.Read          = FwPartitionRead;
   Private->Protocol.Write         = FwPartitionWrite;
+  Private->Protocol.Flush         = FwPartitionFlush;
+  Private->Protocol.EraseAsync    = FwPartitionEraseAsync;
+  Private->Protocol.ErasePoll     = FwPartitionErasePoll;
   Private->Protocol.GetAttributes = FwPartitionGetAttributes;
 
+  Bucket                      = GptPartitionNameHash (PartitionInfo->Name) & (FW_PARTITION_NAME_HASH_SIZE - 1);
+  mNameNext[mNumFwPartitions] = mNameHash[Bucket];
+  mNameHash[Bucket]           = (UINT32)(mNumFwPartitions + 1);
+
   mNumFwPartitions++;
 
   DEBUG ((
@@ -343,106 +525,188 @@ FwPartitionAdd (
   return EFI_SUCCESS;
 }
 
+/**
+  Read data from a FW partition device for GptLib.
+
+  @param[in]  Context           Pointer to device info struct
+  @param[in]  Offset            Offset to read from
+  @param[in]  Bytes             Number of bytes to read
+  @param[out] Buffer            Address to read data into
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error occurred
+
+**/
+STATIC
 EFI_STATUS
 EFIAPI
-FwPartitionAddFromDeviceGpt (
+FwPartitionGptRead (
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  IN  UINTN   Bytes,
+  OUT VOID    *Buffer
+  )
+{
+  FW_PARTITION_DEVICE_INFO  *DeviceInfo;
+
+  DeviceInfo = (FW_PARTITION_DEVICE_INFO *)Context;
+  return DeviceInfo->DeviceRead (DeviceInfo, Offset, Bytes, Buffer);
+}
+
+/**
+  Add new FW partitions for all used entries of a validated partition table.
+
+  @param[in]  GptHeader         Pointer to the GPT header structure
+  @param[in]  PartitionTable    Pointer to the partition table entry array
+  @param[in]  DeviceInfo        Pointer to device info struct
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error occurred
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+FwPartitionAddEntries (
+  IN  CONST EFI_PARTITION_TABLE_HEADER  *GptHeader,
+  IN  CONST VOID                        *PartitionTable,
+  IN  FW_PARTITION_DEVICE_INFO          *DeviceInfo
+  )
+{
+  UINTN                      BlockSize;
+  CONST EFI_PARTITION_ENTRY  *Partition;
+  EFI_STATUS                 Status;
+  UINTN                      Index;
+
+  BlockSize = NVIDIA_GPT_BLOCK_SIZE;
+  Status    = EFI_SUCCESS;
+
+  // initialize a private struct for each partition in the table
+  for (Index = 0; Index < GptHeader->NumberOfPartitionEntries; Index++) {
+    Partition = (CONST EFI_PARTITION_ENTRY *)((CONST UINT8 *)PartitionTable +
+                                              (Index * GptHeader->SizeOfPartitionEntry));
+    if (StrLen (Partition->PartitionName) > 0) {
+      Status = FwPartitionAdd (
+                 Partition->PartitionName,
+                 DeviceInfo,
+                 Partition->StartingLBA * BlockSize,
+                 GptPartitionSizeInBlocks (Partition) * BlockSize
+                 );
+      if (EFI_ERROR (Status)) {
+        DEBUG ((
+          DEBUG_ERROR,
+          "%a: Error adding %s partition: %r\n",
+          __FUNCTION__,
+          Partition->PartitionName,
+          Status
+          ));
+        break;
+      }
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Get the GPT of a device.  The GPT is read and validated on the first call
+  for a device and the cached table is returned by later calls.  The
+  secondary GPT is used, or the primary GPT if the secondary is not valid.
+
+  @param[in]  DeviceInfo        Pointer to device info struct
+  @param[in]  DeviceSizeInBytes Size of device in bytes
+  @param[out] Table             Pointer to the device's GPT table
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval others                Error occurred
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+FwPartitionGetDeviceGpt (
   IN  FW_PARTITION_DEVICE_INFO  *DeviceInfo,
-  IN  UINT64                    DeviceSizeInBytes
+  IN  UINT64                    DeviceSizeInBytes,
+  OUT CONST GPT_TABLE           **Table
   )
 {
-  EFI_STATUS                  Status;
-  EFI_PARTITION_TABLE_HEADER  *GptHeader;
-  EFI_PARTITION_ENTRY         *PartitionTable;
-  UINT64                      PartitionTableOffset;
-  UINTN                       PartitionCount;
-  UINTN                       BlockSize;
-
-  BlockSize      = NVIDIA_GPT_BLOCK_SIZE;
-  PartitionCount = mNumFwPartitions;
-  PartitionTable = NULL;
+  FW_PARTITION_GPT_CACHE  *Cache;
+  EFI_STATUS              Status;
+  UINTN                   Index;
+
+  for (Index = 0; Index < mNumGptCache; Index++) {
+    Cache = &mGptCache[Index];
+    if ((Cache->DeviceInfo == DeviceInfo) && (Cache->DeviceSizeInBytes == DeviceSizeInBytes)) {
+      *Table = &Cache->Table;
+      return EFI_SUCCESS;
+    }
+  }
 
-  // read and validate GPT header
-  GptHeader = (EFI_PARTITION_TABLE_HEADER *)AllocatePool (BlockSize);
-  if (GptHeader == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto Done;
+  if (mNumGptCache >= FW_PARTITION_MAX_GPT_DEVICES) {
+    DEBUG ((DEBUG_ERROR, "%a: no GPT cache entry for %s\n", __FUNCTION__, DeviceInfo->DeviceName));
+    return EFI_OUT_OF_RESOURCES;
   }
 
+  Cache = &mGptCache[mNumGptCache];
+
   DEBUG ((
     DEBUG_INFO,
-    "Reading secondary GPT header DeviceSizeInBytes=%llu, BlockSize=%u\n",
-    DeviceSizeInBytes,
-    BlockSize
+    "Reading GPT on %s DeviceSizeInBytes=%llu\n",
+    DeviceInfo->DeviceName,
+    DeviceSizeInBytes
     ));
 
-  Status = DeviceInfo->DeviceRead (
-                         DeviceInfo,
-                         DeviceSizeInBytes - BlockSize,
-                         BlockSize,
-                         GptHeader
-                         );
+  Status = GptTableRead (FwPartitionGptRead, DeviceInfo, DeviceSizeInBytes, &Cache->Table);
   if (EFI_ERROR (Status)) {
     DEBUG ((
       DEBUG_ERROR,
-      "Secondary GPT header read failed on %s: %r\n",
+      "No valid GPT on %s: %r\n",
       DeviceInfo->DeviceName,
       Status
       ));
-    goto Done;
-  }
-
-  Status = GptValidateHeader (GptHeader);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "Invalid secondary GPT header on %s: %r\n",
-      DeviceInfo->DeviceName,
-      Status
-      ));
-    goto Done;
+    return Status;
   }
 
-  // read the GPT partition table
-  PartitionTable = AllocateZeroPool (GptPartitionTableSizeInBytes (GptHeader));
-  if (PartitionTable == NULL) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto Done;
+  if (Cache->Table.IsPrimary) {
+    DEBUG ((DEBUG_ERROR, "Invalid secondary GPT on %s, using primary GPT\n", DeviceInfo->DeviceName));
   }
 
-  PartitionTableOffset = GptPartitionTableLba (GptHeader, DeviceSizeInBytes) *
-                         BlockSize;
-
   DEBUG ((
     DEBUG_INFO,
-    "Reading partition table on %s, Offset=%llu, entries=%u, size=%u\n",
+    "Read partition table on %s, entries=%u, size=%u\n",
     DeviceInfo->DeviceName,
-    PartitionTableOffset,
-    GptHeader->NumberOfPartitionEntries,
-    GptPartitionTableSizeInBytes (GptHeader)
+    Cache->Table.Header.NumberOfPartitionEntries,
+    GptPartitionTableSizeInBytes (&Cache->Table.Header)
     ));
 
-  Status = DeviceInfo->DeviceRead (
-                         DeviceInfo,
-                         PartitionTableOffset,
-                         GptPartitionTableSizeInBytes (GptHeader),
-                         PartitionTable
-                         );
+  Cache->DeviceInfo        = DeviceInfo;
+  Cache->DeviceSizeInBytes = DeviceSizeInBytes;
+  mNumGptCache++;
+
+  *Table = &Cache->Table;
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+FwPartitionAddFromDeviceGpt (
+  IN  FW_PARTITION_DEVICE_INFO  *DeviceInfo,
+  IN  UINT64                    DeviceSizeInBytes
+  )
+{
+  EFI_STATUS       Status;
+  CONST GPT_TABLE  *Table;
+  UINTN            PartitionCount;
+
+  PartitionCount = mNumFwPartitions;
+
+  Status = FwPartitionGetDeviceGpt (DeviceInfo, DeviceSizeInBytes, &Table);
   if (EFI_ERROR (Status)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: Failed to read partition table: %r\n",
-      __FUNCTION__,
-      Status
-      ));
-    goto Done;
+    return Status;
   }
 
-  // add all the partitions from the table
-  Status = FwPartitionAddFromPartitionTable (
-             GptHeader,
-             PartitionTable,
-             DeviceInfo
-             );
+  // add all the partitions from the table, already validated when read
+  Status = FwPartitionAddEntries (&Table->Header, Table->PartitionTable, DeviceInfo);
   if (EFI_ERROR (Status)) {
     DEBUG ((
       DEBUG_ERROR,
@@ -450,7 +714,7 @@ FwPartitionAddFromDeviceGpt (
       __FUNCTION__,
       Status
       ));
-    goto Done;
+    return Status;
   }
 
   PartitionCount = mNumFwPartitions - PartitionCount;
@@ -462,21 +726,11 @@ FwPartitionAddFromDeviceGpt (
     DeviceInfo->DeviceName
     ));
 
-  Status = EFI_SUCCESS;
   if (PartitionCount == 0) {
-    Status = EFI_NOT_FOUND;
-  }
-
-Done:
-  if (PartitionTable != NULL) {
-    FreePool (PartitionTable);
-  }
-
-  if (GptHeader != NULL) {
-    FreePool (GptHeader);
+    return EFI_NOT_FOUND;
   }
 
-  return Status;
+  return EFI_SUCCESS;
 }
 
 EFI_STATUS
@@ -487,12 +741,7 @@ FwPartitionAddFromPartitionTable (
   IN  FW_PARTITION_DEVICE_INFO          *DeviceInfo
   )
 {
-  UINTN                      BlockSize;
-  CONST EFI_PARTITION_ENTRY  *Partition;
-  EFI_STATUS                 Status;
-  UINTN                      Index;
-
-  BlockSize = NVIDIA_GPT_BLOCK_SIZE;
+  EFI_STATUS  Status;
 
   Status = GptValidatePartitionTable (GptHeader, PartitionTable);
   if (EFI_ERROR (Status)) {
@@ -502,34 +751,10 @@ FwPartitionAddFromPartitionTable (
       __FUNCTION__,
       Status
       ));
-    goto Done;
-  }
-
-  // initialize a private struct for each partition in the table
-  Partition = PartitionTable;
-  for (Index = 0; Index < GptHeader->NumberOfPartitionEntries; Index++, Partition++) {
-    if (StrLen (Partition->PartitionName) > 0) {
-      Status = FwPartitionAdd (
-                 Partition->PartitionName,
-                 DeviceInfo,
-                 Partition->StartingLBA * BlockSize,
-                 GptPartitionSizeInBlocks (Partition) * BlockSize
-                 );
-      if (EFI_ERROR (Status)) {
-        DEBUG ((
-          DEBUG_ERROR,
-          "%a: Error adding %s partition: %r\n",
-          __FUNCTION__,
-          Partition->PartitionName,
-          Status
-          ));
-        goto Done;
-      }
-    }
+    return Status;
   }
 
-Done:
-  return Status;
+  return FwPartitionAddEntries (GptHeader, PartitionTable, DeviceInfo);
 }
 
 VOID
@@ -547,10 +772,17 @@ FwPartitionAddressChangeHandler (
     ConvertFunction ((VOID **)&Private->Protocol.PartitionName);
     ConvertFunction ((VOID **)&Private->Protocol.Read);
     ConvertFunction ((VOID **)&Private->Protocol.Write);
+    ConvertFunction ((VOID **)&Private->Protocol.Flush);
+    ConvertFunction ((VOID **)&Private->Protocol.EraseAsync);
+    ConvertFunction ((VOID **)&Private->Protocol.ErasePoll);
     ConvertFunction ((VOID **)&Private->Protocol.GetAttributes);
   }
 
   ConvertFunction ((VOID **)&mPrivate);
+  ConvertFunction ((VOID **)&mNameNext);
+
+  // cached GPTs are in boot services memory
+  mNumGptCache = 0;
 }
 
 EFI_STATUS
@@ -579,13 +811,16 @@ FwPartitionFindByName (
   )
 {
   FW_PARTITION_PRIVATE_DATA  *Private;
-  UINTN                      Index;
+  UINT32                     Index;
 
-  Private = mPrivate;
-  for (Index = 0; Index < mNumFwPartitions; Index++, Private++) {
+  Index = mNameHash[GptPartitionNameHash (Name) & (FW_PARTITION_NAME_HASH_SIZE - 1)];
+  while (Index != 0) {
+    Private = &mPrivate[Index - 1];
     if (StrCmp (Private->PartitionInfo.Name, Name) == 0) {
       return Private;
     }
+
+    Index = mNameNext[Index - 1];
   }
 
   return NULL;
@@ -615,11 +850,25 @@ FwPartitionDeviceLibDeinit (
   VOID
   )
 {
+  UINTN  Index;
+
   if (mPrivate != NULL) {
     FreePool (mPrivate);
     mPrivate = NULL;
   }
 
+  if (mNameNext != NULL) {
+    FreePool (mNameNext);
+    mNameNext = NULL;
+  }
+
+  for (Index = 0; Index < mNumGptCache; Index++) {
+    GptTableFree (&mGptCache[Index].Table);
+  }
+
+  ZeroMem (mNameHash, sizeof (mNameHash));
+  ZeroMem (mGptCache, sizeof (mGptCache));
+  mNumGptCache                = 0;
   mNumFwPartitions            = 0;
   mMaxFwPartitions            = 0;
   mActiveBootChain            = MAX_UINT32;
@@ -651,5 +900,14 @@ FwPartitionDeviceLibInit (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  mNameNext = (UINT32 *)AllocateRuntimeZeroPool (mMaxFwPartitions * sizeof (UINT32));
+  if (mNameNext == NULL) {
+    FreePool (mPrivate);
+    mPrivate = NULL;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (mNameHash, sizeof (mNameHash));
+
   return EFI_SUCCESS;
 }
@@ -3,7 +3,7 @@
   GPT - GUID Partition Table Library
         This implementation of GPT uses just the secondary GPT table.
 
-  Copyright (c) 2021, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2021-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
 
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -11,6 +11,12 @@
 
 #include <Library/GptLib.h>
 #include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#define GPT_PARTITION_NAME_LENGTH  (sizeof (((EFI_PARTITION_ENTRY *)0)->PartitionName) / sizeof (CHAR16))
+#define GPT_FNV_OFFSET_BASIS       0x811C9DC5
+#define GPT_FNV_PRIME              0x01000193
 
 EFI_STATUS
 EFIAPI
@@ -145,6 +151,244 @@ GptFindPartitionByName (
   return NULL;
 }
 
+UINT32
+EFIAPI
+GptPartitionNameHash (
+  IN CONST CHAR16  *Name
+  )
+{
+  UINT32  Hash;
+  UINTN   Index;
+
+  // FNV-1a over the characters, bounded like the name compare
+  Hash = GPT_FNV_OFFSET_BASIS;
+  for (Index = 0; (Index < GPT_PARTITION_NAME_LENGTH) && (Name[Index] != L'\0'); Index++) {
+    Hash = (Hash ^ (Name[Index] & 0xFF)) * GPT_FNV_PRIME;
+    Hash = (Hash ^ (Name[Index] >> 8)) * GPT_FNV_PRIME;
+  }
+
+  return Hash;
+}
+
+/**
+  Get a partition table entry of a GPT_TABLE
+
+  @param[in]    Table           GPT table
+  @param[in]    Index           Index of the entry
+
+  @retval       Pointer to the partition table entry
+**/
+STATIC
+CONST EFI_PARTITION_ENTRY *
+GptTableEntry (
+  IN CONST GPT_TABLE  *Table,
+  IN UINTN            Index
+  )
+{
+  return (CONST EFI_PARTITION_ENTRY *)((CONST UINT8 *)Table->PartitionTable +
+                                       (Index * Table->Header.SizeOfPartitionEntry));
+}
+
+/**
+  Initialize a GPT_TABLE from a validated partition table, taking ownership
+  of the partition table buffer.
+
+  @param[in]    Header                  Pointer to GPT header structure
+  @param[in]    PartitionTable          Allocated partition table
+  @param[out]   Table                   GPT table to initialize
+
+  @retval       EFI_SUCCESS             Table initialized
+  @retval       EFI_OUT_OF_RESOURCES    Failed to allocate the name index
+**/
+STATIC
+EFI_STATUS
+GptTableBuildIndex (
+  IN  CONST EFI_PARTITION_TABLE_HEADER  *Header,
+  IN  VOID                              *PartitionTable,
+  OUT GPT_TABLE                         *Table
+  )
+{
+  CONST EFI_PARTITION_ENTRY  *Partition;
+  UINT32                     Count;
+  UINT32                     Index;
+  UINT32                     Bucket;
+
+  CopyMem (&Table->Header, Header, sizeof (Table->Header));
+  Table->PartitionTable = PartitionTable;
+
+  Count               = Header->NumberOfPartitionEntries;
+  Table->NameHashSize = 1;
+  while ((Table->NameHashSize < 2 * (UINT64)Count) && (Table->NameHashSize < BIT30)) {
+    Table->NameHashSize <<= 1;
+  }
+
+  Table->NameHash = AllocateZeroPool (Table->NameHashSize * sizeof (UINT32));
+  Table->NameNext = AllocateZeroPool (MAX (Count, 1) * sizeof (UINT32));
+  if ((Table->NameHash == NULL) || (Table->NameNext == NULL)) {
+    GptTableFree (Table);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // insert from the end so chains return the first matching entry first
+  for (Index = Count; Index > 0; Index--) {
+    Partition = GptTableEntry (Table, Index - 1);
+    if (Partition->PartitionName[0] == L'\0') {
+      continue;
+    }
+
+    Bucket                     = GptPartitionNameHash (Partition->PartitionName) & (Table->NameHashSize - 1);
+    Table->NameNext[Index - 1] = Table->NameHash[Bucket];
+    Table->NameHash[Bucket]    = Index;
+  }
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+GptTableInit (
+  IN  CONST EFI_PARTITION_TABLE_HEADER  *Header,
+  IN  CONST VOID                        *PartitionTable,
+  OUT GPT_TABLE                         *Table
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Copy;
+
+  ZeroMem (Table, sizeof (*Table));
+
+  Status = GptValidatePartitionTable (Header, (VOID *)PartitionTable);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Copy = AllocateCopyPool (GptPartitionTableSizeInBytes (Header), PartitionTable);
+  if (Copy == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  return GptTableBuildIndex (Header, Copy, Table);
+}
+
+EFI_STATUS
+EFIAPI
+GptTableRead (
+  IN  GPT_DEVICE_READ  Read,
+  IN  VOID             *Context,
+  IN  UINT64           DeviceBytes,
+  OUT GPT_TABLE        *Table
+  )
+{
+  EFI_STATUS                  Status;
+  EFI_STATUS                  SecondaryStatus;
+  EFI_PARTITION_TABLE_HEADER  *Header;
+  VOID                        *PartitionTable;
+  UINTN                       TableSize;
+  UINTN                       Copy;
+  UINT64                      HeaderOffset;
+
+  ZeroMem (Table, sizeof (*Table));
+
+  if (DeviceBytes < 2 * NVIDIA_GPT_BLOCK_SIZE) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  Header = AllocatePool (NVIDIA_GPT_BLOCK_SIZE);
+  if (Header == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // secondary GPT header is in the last block, primary in the second block
+  SecondaryStatus = EFI_VOLUME_CORRUPTED;
+  for (Copy = 0; Copy < 2; Copy++) {
+    HeaderOffset = (Copy == 0) ? DeviceBytes - NVIDIA_GPT_BLOCK_SIZE : NVIDIA_GPT_BLOCK_SIZE;
+    Status       = Read (Context, HeaderOffset, NVIDIA_GPT_BLOCK_SIZE, Header);
+    if (!EFI_ERROR (Status)) {
+      Status = GptValidateHeader (Header);
+    }
+
+    if (!EFI_ERROR (Status)) {
+      TableSize      = GptPartitionTableSizeInBytes (Header);
+      PartitionTable = AllocatePool (TableSize);
+      if (PartitionTable == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        break;
+      }
+
+      Status = Read (Context, GptPartitionTableLba (Header, DeviceBytes) * NVIDIA_GPT_BLOCK_SIZE, TableSize, PartitionTable);
+      if (!EFI_ERROR (Status)) {
+        Status = GptValidatePartitionTable (Header, PartitionTable);
+      }
+
+      if (EFI_ERROR (Status)) {
+        FreePool (PartitionTable);
+      } else {
+        Status           = GptTableBuildIndex (Header, PartitionTable, Table);
+        Table->IsPrimary = (Copy != 0);
+        break;
+      }
+    }
+
+    if (Copy == 0) {
+      SecondaryStatus = Status;
+    } else {
+      Status = SecondaryStatus;
+    }
+  }
+
+  FreePool (Header);
+
+  return Status;
+}
+
+CONST EFI_PARTITION_ENTRY *
+EFIAPI
+GptTableFindPartitionByName (
+  IN CONST GPT_TABLE  *Table,
+  IN CONST CHAR16     *Name
+  )
+{
+  CONST EFI_PARTITION_ENTRY  *Partition;
+  UINT32                     Index;
+
+  if (Table->NameHash == NULL) {
+    return NULL;
+  }
+
+  Index = Table->NameHash[GptPartitionNameHash (Name) & (Table->NameHashSize - 1)];
+  while (Index != 0) {
+    Partition = GptTableEntry (Table, Index - 1);
+    if (StrnCmp (Partition->PartitionName, Name, GPT_PARTITION_NAME_LENGTH) == 0) {
+      return Partition;
+    }
+
+    Index = Table->NameNext[Index - 1];
+  }
+
+  return NULL;
+}
+
+VOID
+EFIAPI
+GptTableFree (
+  IN GPT_TABLE  *Table
+  )
+{
+  if (Table->PartitionTable != NULL) {
+    FreePool (Table->PartitionTable);
+  }
+
+  if (Table->NameHash != NULL) {
+    FreePool (Table->NameHash);
+  }
+
+  if (Table->NameNext != NULL) {
+    FreePool (Table->NameNext);
+  }
+
+  ZeroMem (Table, sizeof (*Table));
+}
+
 UINT64
 EFIAPI
 GptPartitionSizeInBlocks (
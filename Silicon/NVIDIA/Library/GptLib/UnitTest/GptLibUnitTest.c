@@ -0,0 +1,406 @@
+/** @file
+
+  GPT Library Unit Test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/GptLib.h>
+
+#define UNIT_TEST_NAME     "GPT Lib Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_DEVICE_BYTES       SIZE_1MB
+#define TEST_DEVICE_BLOCKS      (TEST_DEVICE_BYTES / NVIDIA_GPT_BLOCK_SIZE)
+#define TEST_NUM_PARTITIONS     128
+#define TEST_NUM_NAMED          100
+#define TEST_TABLE_BLOCKS       ((TEST_NUM_PARTITIONS * sizeof (EFI_PARTITION_ENTRY)) / NVIDIA_GPT_BLOCK_SIZE)
+#define TEST_FIRST_USABLE_LBA   (2 + TEST_TABLE_BLOCKS)
+#define TEST_LAST_USABLE_LBA    (TEST_DEVICE_BLOCKS - 2 - TEST_TABLE_BLOCKS)
+#define TEST_PARTITION_BLOCKS   8
+#define TEST_PRIMARY_HEADER     NVIDIA_GPT_BLOCK_SIZE
+#define TEST_SECONDARY_HEADER   (TEST_DEVICE_BYTES - NVIDIA_GPT_BLOCK_SIZE)
+#define TEST_PRIMARY_TABLE      (2 * NVIDIA_GPT_BLOCK_SIZE)
+#define TEST_SECONDARY_TABLE    (TEST_SECONDARY_HEADER - (TEST_TABLE_BLOCKS * NVIDIA_GPT_BLOCK_SIZE))
+
+STATIC UINT8  mDevice[TEST_DEVICE_BYTES];
+STATIC UINTN  mReadCount;
+
+/**
+  Build the name of a test partition.
+
+  @param[in]  Index   Partition index
+  @param[out] Name    Name buffer, at least 12 characters
+
+**/
+STATIC
+VOID
+GptTestName (
+  IN  UINTN   Index,
+  OUT CHAR16  *Name
+  )
+{
+  CONST CHAR16  Prefix[] = L"part-";
+  UINTN         Char;
+
+  for (Char = 0; Prefix[Char] != L'\0'; Char++) {
+    Name[Char] = Prefix[Char];
+  }
+
+  Name[Char++] = (CHAR16)(L'0' + ((Index / 100) % 10));
+  Name[Char++] = (CHAR16)(L'0' + ((Index / 10) % 10));
+  Name[Char++] = (CHAR16)(L'0' + (Index % 10));
+  Name[Char]   = L'\0';
+}
+
+/**
+  Write one copy of the GPT to the test device.
+
+  @param[in]  IsPrimary   Write the primary copy, else the secondary
+
+**/
+STATIC
+VOID
+GptTestWriteCopy (
+  IN BOOLEAN  IsPrimary
+  )
+{
+  EFI_PARTITION_TABLE_HEADER  *Header;
+  EFI_PARTITION_ENTRY         *Table;
+
+  Header = (EFI_PARTITION_TABLE_HEADER *)&mDevice[IsPrimary ? TEST_PRIMARY_HEADER : TEST_SECONDARY_HEADER];
+  Table  = (EFI_PARTITION_ENTRY *)&mDevice[IsPrimary ? TEST_PRIMARY_TABLE : TEST_SECONDARY_TABLE];
+
+  Header->Header.Signature         = EFI_PTAB_HEADER_ID;
+  Header->Header.Revision          = 0x00010000;
+  Header->Header.HeaderSize        = sizeof (EFI_PARTITION_TABLE_HEADER);
+  Header->Header.CRC32             = 0;
+  Header->MyLBA                    = IsPrimary ? 1 : TEST_DEVICE_BLOCKS - 1;
+  Header->AlternateLBA             = IsPrimary ? TEST_DEVICE_BLOCKS - 1 : 1;
+  Header->FirstUsableLBA           = TEST_FIRST_USABLE_LBA;
+  Header->LastUsableLBA            = TEST_LAST_USABLE_LBA;
+  Header->PartitionEntryLBA        = (IsPrimary ? TEST_PRIMARY_TABLE : TEST_SECONDARY_TABLE) / NVIDIA_GPT_BLOCK_SIZE;
+  Header->NumberOfPartitionEntries = TEST_NUM_PARTITIONS;
+  Header->SizeOfPartitionEntry     = sizeof (EFI_PARTITION_ENTRY);
+  Header->PartitionEntryArrayCRC32 = CalculateCrc32 (Table, TEST_NUM_PARTITIONS * sizeof (EFI_PARTITION_ENTRY));
+  Header->Header.CRC32             = CalculateCrc32 (Header, sizeof (EFI_PARTITION_TABLE_HEADER));
+}
+
+/**
+  Build a device with matching primary and secondary GPTs.  The first
+  TEST_NUM_NAMED entries are named, the rest are unused.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+GptTestSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_PARTITION_ENTRY  *Table;
+  UINTN                Index;
+
+  ZeroMem (mDevice, sizeof (mDevice));
+  mReadCount = 0;
+
+  Table = (EFI_PARTITION_ENTRY *)&mDevice[TEST_PRIMARY_TABLE];
+  for (Index = 0; Index < TEST_NUM_NAMED; Index++) {
+    Table[Index].StartingLBA = TEST_FIRST_USABLE_LBA + (Index * TEST_PARTITION_BLOCKS);
+    Table[Index].EndingLBA   = Table[Index].StartingLBA + TEST_PARTITION_BLOCKS - 1;
+    GptTestName (Index, Table[Index].PartitionName);
+  }
+
+  CopyMem (&mDevice[TEST_SECONDARY_TABLE], Table, TEST_NUM_PARTITIONS * sizeof (EFI_PARTITION_ENTRY));
+  GptTestWriteCopy (TRUE);
+  GptTestWriteCopy (FALSE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  GPT_DEVICE_READ for the test device.
+
+  @param[in]  Context           Unused
+  @param[in]  Offset            Offset to read from
+  @param[in]  Bytes             Number of bytes to read
+  @param[out] Buffer            Address to read data into
+
+  @retval EFI_SUCCESS           Operation successful
+  @retval EFI_INVALID_PARAMETER Read beyond the end of the device
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+GptTestRead (
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  IN  UINTN   Bytes,
+  OUT VOID    *Buffer
+  )
+{
+  if ((Offset > TEST_DEVICE_BYTES) || (Bytes > TEST_DEVICE_BYTES - Offset)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mReadCount++;
+  CopyMem (Buffer, &mDevice[Offset], Bytes);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check every name lookup of a table against the linear search.
+
+  @param[in]  Table   GPT table
+
+**/
+STATIC
+UNIT_TEST_STATUS
+GptTestCheckNames (
+  IN CONST GPT_TABLE  *Table
+  )
+{
+  CONST EFI_PARTITION_ENTRY  *Partition;
+  CONST EFI_PARTITION_ENTRY  *Linear;
+  CHAR16                     Name[16];
+  UINTN                      Index;
+
+  for (Index = 0; Index < TEST_NUM_NAMED; Index++) {
+    GptTestName (Index, Name);
+    Partition = GptTableFindPartitionByName (Table, Name);
+    Linear    = GptFindPartitionByName (&Table->Header, Table->PartitionTable, Name);
+    UT_ASSERT_NOT_NULL (Partition);
+    UT_ASSERT_TRUE (Partition == Linear);
+    UT_ASSERT_EQUAL (Partition->StartingLBA, TEST_FIRST_USABLE_LBA + (Index * TEST_PARTITION_BLOCKS));
+  }
+
+  GptTestName (TEST_NUM_NAMED, Name);
+  UT_ASSERT_TRUE (GptTableFindPartitionByName (Table, Name) == NULL);
+  UT_ASSERT_TRUE (GptTableFindPartitionByName (Table, L"part-") == NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Read the secondary GPT and look up every partition.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+GptTestReadSecondary (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  GPT_TABLE         Table;
+  EFI_STATUS        Status;
+  UNIT_TEST_STATUS  TestStatus;
+
+  Status = GptTableRead (GptTestRead, NULL, TEST_DEVICE_BYTES, &Table);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_FALSE (Table.IsPrimary);
+  UT_ASSERT_EQUAL (Table.Header.MyLBA, TEST_DEVICE_BLOCKS - 1);
+
+  // one header and one partition table read
+  UT_ASSERT_EQUAL (mReadCount, 2);
+
+  TestStatus = GptTestCheckNames (&Table);
+  GptTableFree (&Table);
+  UT_ASSERT_TRUE (Table.PartitionTable == NULL);
+
+  return TestStatus;
+}
+
+/**
+  Fall back to the primary GPT when the secondary is corrupt.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+GptTestPrimaryFallback (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  GPT_TABLE         Table;
+  EFI_STATUS        Status;
+  UNIT_TEST_STATUS  TestStatus;
+
+  mDevice[TEST_SECONDARY_TABLE + 1] ^= 0xFF;
+
+  Status = GptTableRead (GptTestRead, NULL, TEST_DEVICE_BYTES, &Table);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (Table.IsPrimary);
+  UT_ASSERT_EQUAL (Table.Header.MyLBA, 1);
+
+  TestStatus = GptTestCheckNames (&Table);
+  GptTableFree (&Table);
+
+  return TestStatus;
+}
+
+/**
+  Return the secondary GPT's error when both copies are corrupt.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+GptTestBothCorrupt (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  GPT_TABLE   Table;
+  EFI_STATUS  Status;
+
+  mDevice[TEST_SECONDARY_TABLE + 1] ^= 0xFF;
+  mDevice[TEST_PRIMARY_HEADER]      ^= 0xFF;
+
+  Status = GptTableRead (GptTestRead, NULL, TEST_DEVICE_BYTES, &Table);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_CRC_ERROR);
+  UT_ASSERT_TRUE (Table.PartitionTable == NULL);
+  UT_ASSERT_TRUE (Table.NameHash == NULL);
+
+  Status = GptTableRead (GptTestRead, NULL, NVIDIA_GPT_BLOCK_SIZE, &Table);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_VOLUME_CORRUPTED);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize a table from memory, where duplicate names return the first
+  entry like the linear search, and an invalid table is rejected.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+GptTestInit (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_PARTITION_TABLE_HEADER  *Header;
+  EFI_PARTITION_ENTRY         *Partitions;
+  CONST EFI_PARTITION_ENTRY   *Partition;
+  GPT_TABLE                   Table;
+  EFI_STATUS                  Status;
+
+  Header     = (EFI_PARTITION_TABLE_HEADER *)&mDevice[TEST_PRIMARY_HEADER];
+  Partitions = (EFI_PARTITION_ENTRY *)&mDevice[TEST_PRIMARY_TABLE];
+
+  GptTestName (7, Partitions[TEST_NUM_NAMED + 3].PartitionName);
+  Partitions[TEST_NUM_NAMED + 3].StartingLBA = TEST_FIRST_USABLE_LBA;
+  Partitions[TEST_NUM_NAMED + 3].EndingLBA   = TEST_FIRST_USABLE_LBA;
+  Header->PartitionEntryArrayCRC32           = CalculateCrc32 (Partitions, TEST_NUM_PARTITIONS * sizeof (EFI_PARTITION_ENTRY));
+
+  Status = GptTableInit (Header, Partitions, &Table);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (Table.PartitionTable != Partitions);
+
+  Partition = GptTableFindPartitionByName (&Table, L"part-007");
+  UT_ASSERT_NOT_NULL (Partition);
+  UT_ASSERT_EQUAL (Partition->StartingLBA, TEST_FIRST_USABLE_LBA + (7 * TEST_PARTITION_BLOCKS));
+  UT_ASSERT_EQUAL (
+    (CONST UINT8 *)Partition - (CONST UINT8 *)Table.PartitionTable,
+    (CONST UINT8 *)GptFindPartitionByName (Header, Partitions, L"part-007") - (CONST UINT8 *)Partitions
+    );
+  GptTableFree (&Table);
+
+  Partitions[0].EndingLBA = TEST_LAST_USABLE_LBA + 1;
+  Status                  = GptTableInit (Header, Partitions, &Table);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_CRC_ERROR);
+
+  Header->PartitionEntryArrayCRC32 = CalculateCrc32 (Partitions, TEST_NUM_PARTITIONS * sizeof (EFI_PARTITION_ENTRY));
+  Status                           = GptTableInit (Header, Partitions, &Table);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_VOLUME_CORRUPTED);
+  UT_ASSERT_TRUE (Table.NameHash == NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  GPT library and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      GptTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&GptTests, Framework, "GPT Lib Tests", "UnitTest.GptLib", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for GPT Lib Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    return Status;
+  }
+
+  AddTestCase (GptTests, "Read secondary GPT and find names", "ReadSecondary", GptTestReadSecondary, GptTestSetup, NULL, NULL);
+  AddTestCase (GptTests, "Fall back to primary GPT", "PrimaryFallback", GptTestPrimaryFallback, GptTestSetup, NULL, NULL);
+  AddTestCase (GptTests, "Both GPT copies corrupt", "BothCorrupt", GptTestBothCorrupt, GptTestSetup, NULL, NULL);
+  AddTestCase (GptTests, "Initialize from memory", "Init", GptTestInit, GptTestSetup, NULL, NULL);
+
+  // Execute the tests.
+  Status = RunAllTestSuites (Framework);
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
@@ -19,6 +19,8 @@
 
 IPMI_COMMAND  *mStubIpmiCommand;
 UINT8         mIpmiCommandCounter = 0;
+IPMI_COMMAND  mStubIpmiDefault;
+UINTN         mIpmiSubmitCount = 0;
 
 #define MAX_IPMI_COMMAND_SUPPORTED  10
 
@@ -37,7 +39,7 @@ IpmiStubInit (
 }
 
 /**
- Cleanup Ipmi stub support
+ Cleanup Ipmi stub support, dropping any responses that were not consumed
 
   @retval None
 
@@ -47,7 +49,12 @@ IpmiStubDeInit (
   VOID
   )
 {
-  FreePool (mStubIpmiCommand);
+  if (mStubIpmiCommand != NULL) {
+    FreePool (mStubIpmiCommand);
+    mStubIpmiCommand = NULL;
+  }
+
+  mIpmiCommandCounter = 0;
 }
 
 EFI_STATUS
@@ -72,6 +79,40 @@ MockIpmiSubmitCommand (
   return EFI_SUCCESS;
 }
 
+/**
+  Set the response returned once all queued mock responses are consumed.
+
+  @param ResponseData      - Response Data, NULL to clear the default response
+  @param ResponseDataSize  - Response Data Size
+  @param ReturnStatus      - Status returned by IpmiSubmitCommand
+
+**/
+VOID
+MockIpmiSubmitCommandDefault (
+  IN UINT8       *ResponseData,
+  IN UINT32      ResponseDataSize,
+  IN EFI_STATUS  ReturnStatus
+  )
+{
+  mStubIpmiDefault.ResponseData     = ResponseData;
+  mStubIpmiDefault.ResponseDataSize = ResponseDataSize;
+  mStubIpmiDefault.ForcedStatus     = ReturnStatus;
+}
+
+/**
+  Get the number of times IpmiSubmitCommand was called.
+
+  @retval Number of commands submitted
+
+**/
+UINTN
+MockIpmiGetSubmitCount (
+  VOID
+  )
+{
+  return mIpmiSubmitCount;
+}
+
 /**
   Routine to send commands to BMC.
 
@@ -98,6 +139,17 @@ IpmiSubmitCommand (
   EFI_STATUS  Status;
 
   Status = EFI_SUCCESS;
+  mIpmiSubmitCount++;
+  if (mIpmiCommandCounter == 0) {
+    if (mStubIpmiDefault.ResponseData == NULL) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    CopyMem (ResponseData, mStubIpmiDefault.ResponseData, mStubIpmiDefault.ResponseDataSize);
+    *ResponseDataSize = mStubIpmiDefault.ResponseDataSize;
+    return mStubIpmiDefault.ForcedStatus;
+  }
+
   mIpmiCommandCounter--;
   CopyMem (ResponseData, mStubIpmiCommand[mIpmiCommandCounter].ResponseData, mStubIpmiCommand[mIpmiCommandCounter].ResponseDataSize);
   *ResponseDataSize = mStubIpmiCommand[mIpmiCommandCounter].ResponseDataSize;
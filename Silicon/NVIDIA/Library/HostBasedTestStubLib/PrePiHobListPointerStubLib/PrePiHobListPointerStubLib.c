@@ -0,0 +1,46 @@
+/** @file
+
+  PrePi HOB List Pointer Lib stubs for host based tests
+
+  Copyright (c) 2023 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+#include <Library/PrePiHobListPointerLib.h>
+
+STATIC VOID  *mHobList = NULL;
+
+/**
+  Returns the pointer to the HOB list.
+
+  @return The pointer to the HOB list.
+
+**/
+VOID *
+EFIAPI
+PrePeiGetHobList (
+  VOID
+  )
+{
+  return mHobList;
+}
+
+/**
+  Updates the pointer to the HOB list.
+
+  @param  HobList       Hob list pointer to store
+
+**/
+EFI_STATUS
+EFIAPI
+PrePeiSetHobList (
+  IN  VOID  *HobList
+  )
+{
+  mHobList = HobList;
+
+  return EFI_SUCCESS;
+}
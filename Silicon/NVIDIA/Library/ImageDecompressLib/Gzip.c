@@ -0,0 +1,660 @@
+/** @file
+
+  gzip (RFC 1952) and DEFLATE (RFC 1951) decoder
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "ImageDecompressLibPrivate.h"
+
+#define GZIP_CM_DEFLATE  8
+#define GZIP_FTEXT       BIT0
+#define GZIP_FHCRC       BIT1
+#define GZIP_FEXTRA      BIT2
+#define GZIP_FNAME       BIT3
+#define GZIP_FCOMMENT    BIT4
+#define GZIP_FRESERVED   (BIT5 | BIT6 | BIT7)
+
+#define INFLATE_MAX_BITS       15
+#define INFLATE_FAST_BITS      10
+#define INFLATE_MAX_LIT_CODES  288
+#define INFLATE_MAX_DIST_CODES 30
+#define INFLATE_MAX_CL_CODES   19
+#define INFLATE_END_OF_BLOCK   256
+
+#define INFLATE_FAST_SYMBOL_MASK   0x1FF
+#define INFLATE_FAST_LENGTH_SHIFT  9
+
+typedef struct {
+  // (Length << INFLATE_FAST_LENGTH_SHIFT) | Symbol for codes that fit in
+  // INFLATE_FAST_BITS, 0 otherwise
+  UINT16    Fast[1 << INFLATE_FAST_BITS];
+  UINT16    Count[INFLATE_MAX_BITS + 1];
+  UINT16    Symbol[INFLATE_MAX_LIT_CODES];
+} INFLATE_HUFFMAN;
+
+typedef struct {
+  INFLATE_HUFFMAN    LitLen;
+  INFLATE_HUFFMAN    Dist;
+  INFLATE_HUFFMAN    CodeLen;
+  UINT8              Lengths[INFLATE_MAX_LIT_CODES + INFLATE_MAX_DIST_CODES];
+} INFLATE_STATE;
+
+STATIC CONST UINT16  mLengthBase[29] = {
+  3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+  31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+STATIC CONST UINT8  mLengthExtra[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+STATIC CONST UINT16  mDistBase[30] = {
+  1,    2,    3,    4,    5,    7,     9,     13,    17,  25,   33,   49,   65,   97,   129,
+  193,  257,  385,  513,  769,  1025,  1537,  2049,  3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+STATIC CONST UINT8  mDistExtra[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+STATIC CONST UINT8  mCodeLenOrder[INFLATE_MAX_CL_CODES] = {
+  16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+/**
+  Make sure at least Count bits are in the bit buffer.
+
+  @param[in]  Stream    Decompress stream
+  @param[in]  Count     Number of bits needed, at most 32
+
+**/
+STATIC
+VOID
+InflateNeedBits (
+  IN DECOMPRESS_STREAM  *Stream,
+  IN UINT32             Count
+  )
+{
+  while (Stream->BitCount < Count) {
+    Stream->BitBuffer |= (UINT64)DecompressStreamGetByte (Stream) << Stream->BitCount;
+    Stream->BitCount  += 8;
+  }
+}
+
+/**
+  Consume Count bits from the bit buffer.
+
+  @param[in]  Stream    Decompress stream
+  @param[in]  Count     Number of bits, at most 32
+
+  @retval Bits consumed, least significant bit first
+
+**/
+STATIC
+UINT32
+InflateGetBits (
+  IN DECOMPRESS_STREAM  *Stream,
+  IN UINT32             Count
+  )
+{
+  UINT32  Value;
+
+  if (Count == 0) {
+    return 0;
+  }
+
+  InflateNeedBits (Stream, Count);
+  Value               = (UINT32)(Stream->BitBuffer & ((1ULL << Count) - 1));
+  Stream->BitBuffer >>= Count;
+  Stream->BitCount   -= Count;
+
+  return Value;
+}
+
+/**
+  Discard bits up to the next byte boundary.
+
+  @param[in]  Stream    Decompress stream
+
+**/
+STATIC
+VOID
+InflateAlignToByte (
+  IN DECOMPRESS_STREAM  *Stream
+  )
+{
+  InflateGetBits (Stream, Stream->BitCount % 8);
+}
+
+/**
+  Build the decoding tables for a canonical Huffman code.
+
+  @param[out] Huffman   Decoding tables
+  @param[in]  Lengths   Code length of each symbol
+  @param[in]  Count     Number of symbols
+
+  @retval EFI_SUCCESS           Tables built
+  @retval EFI_VOLUME_CORRUPTED  The code is over-subscribed
+
+**/
+STATIC
+EFI_STATUS
+InflateBuildHuffman (
+  OUT INFLATE_HUFFMAN  *Huffman,
+  IN  CONST UINT8      *Lengths,
+  IN  UINTN            Count
+  )
+{
+  UINT16  Offsets[INFLATE_MAX_BITS + 1];
+  INT32   Left;
+  UINTN   Symbol;
+  UINTN   Length;
+  UINTN   Index;
+  UINTN   Entry;
+  UINT32  Code;
+  UINT32  Reversed;
+  UINTN   Bit;
+
+  ZeroMem (Huffman->Count, sizeof (Huffman->Count));
+  ZeroMem (Huffman->Fast, sizeof (Huffman->Fast));
+
+  for (Symbol = 0; Symbol < Count; Symbol++) {
+    Huffman->Count[Lengths[Symbol]]++;
+  }
+
+  Huffman->Count[0] = 0;
+
+  Left = 1;
+  for (Length = 1; Length <= INFLATE_MAX_BITS; Length++) {
+    Left <<= 1;
+    Left  -= Huffman->Count[Length];
+    if (Left < 0) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+  }
+
+  Offsets[1] = 0;
+  for (Length = 1; Length < INFLATE_MAX_BITS; Length++) {
+    Offsets[Length + 1] = Offsets[Length] + Huffman->Count[Length];
+  }
+
+  for (Symbol = 0; Symbol < Count; Symbol++) {
+    if (Lengths[Symbol] != 0) {
+      Huffman->Symbol[Offsets[Lengths[Symbol]]++] = (UINT16)Symbol;
+    }
+  }
+
+  // Canonical codes are assigned in (length, symbol) order, which is the
+  // order of the Symbol table. DEFLATE sends them most significant bit
+  // first so the lookup index is the bit-reversed code.
+  Code  = 0;
+  Index = 0;
+  for (Length = 1; Length <= INFLATE_FAST_BITS; Length++) {
+    for (Entry = 0; Entry < Huffman->Count[Length]; Entry++) {
+      Reversed = 0;
+      for (Bit = 0; Bit < Length; Bit++) {
+        Reversed |= ((Code >> Bit) & 1) << (Length - 1 - Bit);
+      }
+
+      for ( ; Reversed < (1 << INFLATE_FAST_BITS); Reversed += (1 << Length)) {
+        Huffman->Fast[Reversed] = (UINT16)((Length << INFLATE_FAST_LENGTH_SHIFT) | Huffman->Symbol[Index]);
+      }
+
+      Code++;
+      Index++;
+    }
+
+    Code <<= 1;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Decode one symbol.
+
+  @param[in]  Stream    Decompress stream
+  @param[in]  Huffman   Decoding tables
+
+  @retval Symbol decoded, MAX_UINT32 if the input is not a valid code
+
+**/
+STATIC
+UINT32
+InflateDecodeSymbol (
+  IN DECOMPRESS_STREAM      *Stream,
+  IN CONST INFLATE_HUFFMAN  *Huffman
+  )
+{
+  UINT16  Entry;
+  UINT32  Bits;
+  INT32   Code;
+  INT32   First;
+  INT32   Index;
+  INT32   Count;
+  UINT32  Length;
+
+  InflateNeedBits (Stream, INFLATE_MAX_BITS);
+
+  Entry = Huffman->Fast[Stream->BitBuffer & ((1 << INFLATE_FAST_BITS) - 1)];
+  if (Entry != 0) {
+    InflateGetBits (Stream, Entry >> INFLATE_FAST_LENGTH_SHIFT);
+    return Entry & INFLATE_FAST_SYMBOL_MASK;
+  }
+
+  Bits  = (UINT32)Stream->BitBuffer;
+  Code  = 0;
+  First = 0;
+  Index = 0;
+  for (Length = 1; Length <= INFLATE_MAX_BITS; Length++) {
+    Code |= Bits & 1;
+    Bits >>= 1;
+    Count = Huffman->Count[Length];
+    if (Code - First < Count) {
+      InflateGetBits (Stream, Length);
+      return Huffman->Symbol[Index + (Code - First)];
+    }
+
+    Index  += Count;
+    First  += Count;
+    First <<= 1;
+    Code  <<= 1;
+  }
+
+  return MAX_UINT32;
+}
+
+/**
+  Decode the compressed data of a block.
+
+  @param[in]  Stream    Decompress stream
+  @param[in]  State     Inflate state with the block's code tables
+
+  @retval EFI_SUCCESS   Block decoded
+  @retval Others        Error decoding the block
+
+**/
+STATIC
+EFI_STATUS
+InflateCodes (
+  IN DECOMPRESS_STREAM  *Stream,
+  IN INFLATE_STATE      *State
+  )
+{
+  UINT32  Symbol;
+  UINTN   Length;
+  UINTN   Distance;
+  UINT8   *Output;
+  UINTN   Position;
+
+  Output   = Stream->Output;
+  Position = Stream->OutputPosition;
+
+  while (!EFI_ERROR (Stream->Status)) {
+    Symbol = InflateDecodeSymbol (Stream, &State->LitLen);
+    if (Symbol < INFLATE_END_OF_BLOCK) {
+      if (Position >= Stream->OutputSize) {
+        return EFI_BUFFER_TOO_SMALL;
+      }
+
+      Output[Position++] = (UINT8)Symbol;
+      continue;
+    }
+
+    if (Symbol == INFLATE_END_OF_BLOCK) {
+      Stream->OutputPosition = Position;
+      return EFI_SUCCESS;
+    }
+
+    Symbol -= INFLATE_END_OF_BLOCK + 1;
+    if (Symbol >= ARRAY_SIZE (mLengthBase)) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    Length = mLengthBase[Symbol] + InflateGetBits (Stream, mLengthExtra[Symbol]);
+
+    Symbol = InflateDecodeSymbol (Stream, &State->Dist);
+    if (Symbol >= ARRAY_SIZE (mDistBase)) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    Distance = mDistBase[Symbol] + InflateGetBits (Stream, mDistExtra[Symbol]);
+    if (Distance > Position) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    if (Length > Stream->OutputSize - Position) {
+      return EFI_BUFFER_TOO_SMALL;
+    }
+
+    // Byte copy as source and destination overlap when Distance < Length
+    while (Length-- > 0) {
+      Output[Position] = Output[Position - Distance];
+      Position++;
+    }
+  }
+
+  return Stream->Status;
+}
+
+/**
+  Decode a stored block.
+
+  @param[in]  Stream    Decompress stream
+
+  @retval EFI_SUCCESS   Block decoded
+  @retval Others        Error decoding the block
+
+**/
+STATIC
+EFI_STATUS
+InflateStored (
+  IN DECOMPRESS_STREAM  *Stream
+  )
+{
+  UINT32  Length;
+  UINT32  NotLength;
+
+  InflateAlignToByte (Stream);
+  Length    = InflateGetBits (Stream, 16);
+  NotLength = InflateGetBits (Stream, 16);
+  if (Length != (~NotLength & 0xFFFF)) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  if (Length > Stream->OutputSize - Stream->OutputPosition) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  // Drain whole bytes still held in the bit buffer before copying directly
+  while ((Length > 0) && (Stream->BitCount >= 8)) {
+    Stream->Output[Stream->OutputPosition++] = (UINT8)InflateGetBits (Stream, 8);
+    Length--;
+  }
+
+  return DecompressStreamCopy (Stream, Length);
+}
+
+/**
+  Build the code tables of a fixed Huffman block.
+
+  @param[in]  State     Inflate state
+
+  @retval EFI_SUCCESS   Tables built
+
+**/
+STATIC
+EFI_STATUS
+InflateFixedTables (
+  IN INFLATE_STATE  *State
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Symbol;
+
+  for (Symbol = 0; Symbol < 144; Symbol++) {
+    State->Lengths[Symbol] = 8;
+  }
+
+  for ( ; Symbol < 256; Symbol++) {
+    State->Lengths[Symbol] = 9;
+  }
+
+  for ( ; Symbol < 280; Symbol++) {
+    State->Lengths[Symbol] = 7;
+  }
+
+  for ( ; Symbol < INFLATE_MAX_LIT_CODES; Symbol++) {
+    State->Lengths[Symbol] = 8;
+  }
+
+  Status = InflateBuildHuffman (&State->LitLen, State->Lengths, INFLATE_MAX_LIT_CODES);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  SetMem (State->Lengths, INFLATE_MAX_DIST_CODES, 5);
+  return InflateBuildHuffman (&State->Dist, State->Lengths, INFLATE_MAX_DIST_CODES);
+}
+
+/**
+  Read and build the code tables of a dynamic Huffman block.
+
+  @param[in]  Stream    Decompress stream
+  @param[in]  State     Inflate state
+
+  @retval EFI_SUCCESS   Tables built
+  @retval Others        Error reading the tables
+
+**/
+STATIC
+EFI_STATUS
+InflateDynamicTables (
+  IN DECOMPRESS_STREAM  *Stream,
+  IN INFLATE_STATE      *State
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       LitCount;
+  UINTN       DistCount;
+  UINTN       CodeLenCount;
+  UINTN       Index;
+  UINT32      Symbol;
+  UINT8       Repeat;
+  UINTN       RepeatCount;
+
+  LitCount     = InflateGetBits (Stream, 5) + 257;
+  DistCount    = InflateGetBits (Stream, 5) + 1;
+  CodeLenCount = InflateGetBits (Stream, 4) + 4;
+  if ((LitCount > INFLATE_MAX_LIT_CODES) || (DistCount > INFLATE_MAX_DIST_CODES)) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  ZeroMem (State->Lengths, INFLATE_MAX_CL_CODES);
+  for (Index = 0; Index < CodeLenCount; Index++) {
+    State->Lengths[mCodeLenOrder[Index]] = (UINT8)InflateGetBits (Stream, 3);
+  }
+
+  Status = InflateBuildHuffman (&State->CodeLen, State->Lengths, INFLATE_MAX_CL_CODES);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Index = 0;
+  while (Index < LitCount + DistCount) {
+    if (EFI_ERROR (Stream->Status)) {
+      return Stream->Status;
+    }
+
+    Symbol = InflateDecodeSymbol (Stream, &State->CodeLen);
+    if (Symbol < 16) {
+      State->Lengths[Index++] = (UINT8)Symbol;
+      continue;
+    }
+
+    if (Symbol == 16) {
+      if (Index == 0) {
+        return EFI_VOLUME_CORRUPTED;
+      }
+
+      Repeat      = State->Lengths[Index - 1];
+      RepeatCount = 3 + InflateGetBits (Stream, 2);
+    } else if (Symbol == 17) {
+      Repeat      = 0;
+      RepeatCount = 3 + InflateGetBits (Stream, 3);
+    } else if (Symbol == 18) {
+      Repeat      = 0;
+      RepeatCount = 11 + InflateGetBits (Stream, 7);
+    } else {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    if (Index + RepeatCount > LitCount + DistCount) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    SetMem (&State->Lengths[Index], RepeatCount, Repeat);
+    Index += RepeatCount;
+  }
+
+  if (State->Lengths[INFLATE_END_OF_BLOCK] == 0) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  Status = InflateBuildHuffman (&State->LitLen, State->Lengths, LitCount);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return InflateBuildHuffman (&State->Dist, &State->Lengths[LitCount], DistCount);
+}
+
+/**
+  Skip a zero terminated string in the gzip header.
+
+  @param[in]  Stream    Decompress stream
+
+**/
+STATIC
+VOID
+GzipSkipString (
+  IN DECOMPRESS_STREAM  *Stream
+  )
+{
+  while ((InflateGetBits (Stream, 8) != 0) && !EFI_ERROR (Stream->Status)) {
+  }
+}
+
+/**
+  Decompress a gzip stream.
+
+  @param[in]  Stream    Decompress stream
+
+  @retval EFI_SUCCESS   Stream decompressed
+  @retval Others        Error decompressing the stream
+
+**/
+EFI_STATUS
+GzipDecompress (
+  IN DECOMPRESS_STREAM  *Stream
+  )
+{
+  EFI_STATUS     Status;
+  INFLATE_STATE  *State;
+  UINT32         Flags;
+  UINT32         Final;
+  UINT32         Type;
+  UINT32         Crc32;
+  UINT32         Size;
+
+  if ((InflateGetBits (Stream, 8) != GZIP_ID1) ||
+      (InflateGetBits (Stream, 8) != GZIP_ID2) ||
+      (InflateGetBits (Stream, 8) != GZIP_CM_DEFLATE))
+  {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  Flags = InflateGetBits (Stream, 8);
+  if ((Flags & GZIP_FRESERVED) != 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  // MTIME, XFL and OS
+  InflateGetBits (Stream, 32);
+  InflateGetBits (Stream, 16);
+
+  if ((Flags & GZIP_FEXTRA) != 0) {
+    Size = InflateGetBits (Stream, 16);
+    while ((Size-- > 0) && !EFI_ERROR (Stream->Status)) {
+      InflateGetBits (Stream, 8);
+    }
+  }
+
+  if ((Flags & GZIP_FNAME) != 0) {
+    GzipSkipString (Stream);
+  }
+
+  if ((Flags & GZIP_FCOMMENT) != 0) {
+    GzipSkipString (Stream);
+  }
+
+  if ((Flags & GZIP_FHCRC) != 0) {
+    InflateGetBits (Stream, 16);
+  }
+
+  State = AllocatePool (sizeof (INFLATE_STATE));
+  if (State == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  do {
+    if (EFI_ERROR (Stream->Status)) {
+      Status = Stream->Status;
+      break;
+    }
+
+    Final = InflateGetBits (Stream, 1);
+    Type  = InflateGetBits (Stream, 2);
+    switch (Type) {
+      case 0:
+        Status = InflateStored (Stream);
+        break;
+
+      case 1:
+        Status = InflateFixedTables (State);
+        if (!EFI_ERROR (Status)) {
+          Status = InflateCodes (Stream, State);
+        }
+
+        break;
+
+      case 2:
+        Status = InflateDynamicTables (Stream, State);
+        if (!EFI_ERROR (Status)) {
+          Status = InflateCodes (Stream, State);
+        }
+
+        break;
+
+      default:
+        Status = EFI_VOLUME_CORRUPTED;
+        break;
+    }
+  } while (!EFI_ERROR (Status) && (Final == 0));
+
+  FreePool (State);
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  InflateAlignToByte (Stream);
+  Crc32 = InflateGetBits (Stream, 32);
+  Size  = InflateGetBits (Stream, 32);
+
+  // Zero padding may only have been peeked, never consumed
+  if (EFI_ERROR (Stream->Status) || (Stream->Overrun * 8 > Stream->BitCount)) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  if (Size != (UINT32)Stream->OutputPosition) {
+    DEBUG ((DEBUG_ERROR, "%a: size mismatch 0x%x != 0x%x\n", __FUNCTION__, Size, Stream->OutputPosition));
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  if (Crc32 != CalculateCrc32 (Stream->Output, Stream->OutputPosition)) {
+    DEBUG ((DEBUG_ERROR, "%a: crc mismatch\n", __FUNCTION__));
+    return EFI_CRC_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,417 @@
+/** @file
+
+  Image Decompress Library
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "ImageDecompressLibPrivate.h"
+
+/**
+  Start reading the chunk after the current one in the background, if the
+  reader supports it.  Reads fall back to blocking if a read can't be started.
+
+  @param[in]  Stream    Decompress stream
+
+  @retval None
+
+**/
+STATIC
+VOID
+DecompressStreamReadAhead (
+  IN DECOMPRESS_STREAM  *Stream
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Size;
+
+  if ((Stream->ReadStart == NULL) || (Stream->InputOffset >= Stream->InputSize)) {
+    return;
+  }
+
+  Size   = (UINTN)MIN (Stream->InputSize - Stream->InputOffset, IMAGE_DECOMPRESS_CHUNK_SIZE);
+  Status = Stream->ReadStart (Stream->Context, Stream->InputOffset, Stream->NextChunk, Size);
+  if (EFI_ERROR (Status)) {
+    if (Status != EFI_UNSUPPORTED) {
+      DEBUG ((DEBUG_WARN, "%a: read ahead at 0x%llx failed, reads will block: %r\n", __FUNCTION__, Stream->InputOffset, Status));
+    }
+
+    Stream->ReadStart = NULL;
+    return;
+  }
+
+  Stream->NextChunkLength = Size;
+  Stream->Stats->ReadAheadCount++;
+}
+
+/**
+  Read the next chunk of the compressed input.
+
+  @param[in]  Stream    Decompress stream
+
+  @retval TRUE          Chunk read
+  @retval FALSE         End of input or read error
+
+**/
+STATIC
+BOOLEAN
+DecompressStreamRefill (
+  IN DECOMPRESS_STREAM  *Stream
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Size;
+  UINT8       *Chunk;
+
+  if (EFI_ERROR (Stream->Status) || (Stream->InputOffset >= Stream->InputSize)) {
+    return FALSE;
+  }
+
+  if (Stream->NextChunkLength != 0) {
+    // read ahead of the chunk just decoded, swap the buffers once it's done
+    Size                    = Stream->NextChunkLength;
+    Stream->NextChunkLength = 0;
+    Status                  = Stream->ReadWait (Stream->Context);
+    Chunk                   = Stream->NextChunk;
+    Stream->NextChunk       = Stream->Chunk;
+    Stream->Chunk           = Chunk;
+  } else {
+    Size   = (UINTN)MIN (Stream->InputSize - Stream->InputOffset, IMAGE_DECOMPRESS_CHUNK_SIZE);
+    Status = Stream->Read (Stream->Context, Stream->InputOffset, Stream->Chunk, Size);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: read of %u bytes at 0x%llx failed: %r\n", __FUNCTION__, Size, Stream->InputOffset, Status));
+    Stream->Status = Status;
+    return FALSE;
+  }
+
+  Stream->InputOffset  += Size;
+  Stream->ChunkLength   = Size;
+  Stream->ChunkPosition = 0;
+  Stream->Stats->ReadCount++;
+
+  DecompressStreamReadAhead (Stream);
+
+  return TRUE;
+}
+
+UINT8
+DecompressStreamGetByte (
+  IN DECOMPRESS_STREAM  *Stream
+  )
+{
+  if ((Stream->ChunkPosition < Stream->ChunkLength) || DecompressStreamRefill (Stream)) {
+    return Stream->Chunk[Stream->ChunkPosition++];
+  }
+
+  Stream->Overrun++;
+  if ((Stream->Overrun > DECOMPRESS_MAX_OVERRUN) && !EFI_ERROR (Stream->Status)) {
+    Stream->Status = EFI_VOLUME_CORRUPTED;
+  }
+
+  return 0;
+}
+
+EFI_STATUS
+DecompressStreamCopy (
+  IN DECOMPRESS_STREAM  *Stream,
+  IN UINTN              Length
+  )
+{
+  UINTN  Size;
+
+  if (Length > Stream->OutputSize - Stream->OutputPosition) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  while (Length > 0) {
+    if ((Stream->ChunkPosition == Stream->ChunkLength) && !DecompressStreamRefill (Stream)) {
+      return EFI_ERROR (Stream->Status) ? Stream->Status : EFI_VOLUME_CORRUPTED;
+    }
+
+    Size = MIN (Length, Stream->ChunkLength - Stream->ChunkPosition);
+    CopyMem (&Stream->Output[Stream->OutputPosition], &Stream->Chunk[Stream->ChunkPosition], Size);
+    Stream->OutputPosition += Size;
+    Stream->ChunkPosition  += Size;
+    Length                 -= Size;
+  }
+
+  return EFI_SUCCESS;
+}
+
+UINT32
+DecompressStreamGetUint32 (
+  IN DECOMPRESS_STREAM  *Stream
+  )
+{
+  UINT32  Value;
+
+  Value  = DecompressStreamGetByte (Stream);
+  Value |= (UINT32)DecompressStreamGetByte (Stream) << 8;
+  Value |= (UINT32)DecompressStreamGetByte (Stream) << 16;
+  Value |= (UINT32)DecompressStreamGetByte (Stream) << 24;
+
+  return Value;
+}
+
+UINT64
+DecompressStreamPosition (
+  IN DECOMPRESS_STREAM  *Stream
+  )
+{
+  return Stream->InputOffset - Stream->ChunkLength + Stream->ChunkPosition;
+}
+
+/**
+  Identify the compression format of an image from its first bytes.
+
+  @param[in]  Buffer        Start of the image
+  @param[in]  BufferSize    Number of bytes available in Buffer
+
+  @retval Compression type of the image, ImageCompressionNone if not recognized
+
+**/
+IMAGE_COMPRESSION_TYPE
+EFIAPI
+ImageDecompressGetType (
+  IN CONST VOID  *Buffer,
+  IN UINTN       BufferSize
+  )
+{
+  CONST UINT8  *Bytes;
+
+  Bytes = (CONST UINT8 *)Buffer;
+  if ((Bytes == NULL) || (BufferSize < sizeof (UINT32))) {
+    return ImageCompressionNone;
+  }
+
+  if ((Bytes[0] == GZIP_ID1) && (Bytes[1] == GZIP_ID2)) {
+    return ImageCompressionGzip;
+  }
+
+  if (ReadUnaligned32 ((CONST UINT32 *)Bytes) == LZ4_FRAME_MAGIC) {
+    return ImageCompressionLz4;
+  }
+
+  if (ReadUnaligned32 ((CONST UINT32 *)Bytes) == LZ4_LEGACY_MAGIC) {
+    return ImageCompressionLz4Legacy;
+  }
+
+  return ImageCompressionNone;
+}
+
+/**
+  Get the size of the buffer needed to decompress an image.
+
+  Formats that record the decompressed size return it exactly, otherwise an
+  upper bound derived from the block headers is returned.
+
+  @param[in]  Type              Compression type of the image
+  @param[in]  Read              Function to read the compressed image
+  @param[in]  Context           Context passed to Read
+  @param[in]  CompressedSize    Size of the compressed image
+  @param[out] DecompressedSize  Size of the buffer needed to decompress the image
+
+  @retval EFI_SUCCESS            Size returned
+  @retval EFI_INVALID_PARAMETER  Invalid parameter
+  @retval EFI_UNSUPPORTED        Compression type not supported
+  @retval EFI_VOLUME_CORRUPTED   Compressed image is malformed
+  @retval Others                 Error returned by Read
+
+**/
+EFI_STATUS
+EFIAPI
+ImageDecompressGetSize (
+  IN  IMAGE_COMPRESSION_TYPE  Type,
+  IN  IMAGE_DECOMPRESS_READ   Read,
+  IN  VOID                    *Context,
+  IN  UINT64                  CompressedSize,
+  OUT UINT64                  *DecompressedSize
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Size32;
+
+  if ((Read == NULL) || (DecompressedSize == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  switch (Type) {
+    case ImageCompressionGzip:
+      // ISIZE trailer holds the decompressed size modulo 2^32
+      if (CompressedSize < 18) {
+        return EFI_VOLUME_CORRUPTED;
+      }
+
+      Status = Read (Context, CompressedSize - sizeof (Size32), &Size32, sizeof (Size32));
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      *DecompressedSize = Size32;
+      return EFI_SUCCESS;
+
+    case ImageCompressionLz4:
+    case ImageCompressionLz4Legacy:
+      return Lz4GetSize (Read, Context, CompressedSize, Type == ImageCompressionLz4Legacy, DecompressedSize);
+
+    default:
+      return EFI_UNSUPPORTED;
+  }
+}
+
+/**
+  Decompress an image.
+
+  The compressed image is read through Read in IMAGE_DECOMPRESS_CHUNK_SIZE
+  chunks, and each chunk is decoded before the next one is requested, so the
+  compressed image never has to be resident in memory.
+
+  @param[in]  Type              Compression type of the image
+  @param[in]  Read              Function to read the compressed image
+  @param[in]  Context           Context passed to Read
+  @param[in]  CompressedSize    Size of the compressed image
+  @param[out] Destination       Buffer to decompress the image to
+  @param[in]  DestinationSize   Size of Destination
+  @param[out] Stats             Optional decompression statistics
+
+  @retval EFI_SUCCESS            Image decompressed, size in Stats
+  @retval EFI_INVALID_PARAMETER  Invalid parameter
+  @retval EFI_UNSUPPORTED        Compression type or feature not supported
+  @retval EFI_BUFFER_TOO_SMALL   Destination is too small for the image
+  @retval EFI_VOLUME_CORRUPTED   Compressed image is malformed
+  @retval EFI_CRC_ERROR          Decompressed data failed the integrity check
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the stream buffers
+  @retval Others                 Error returned by Read
+
+**/
+EFI_STATUS
+EFIAPI
+ImageDecompress (
+  IN  IMAGE_COMPRESSION_TYPE  Type,
+  IN  IMAGE_DECOMPRESS_READ   Read,
+  IN  VOID                    *Context,
+  IN  UINT64                  CompressedSize,
+  OUT VOID                    *Destination,
+  IN  UINTN                   DestinationSize,
+  OUT IMAGE_DECOMPRESS_STATS  *Stats OPTIONAL
+  )
+{
+  IMAGE_DECOMPRESS_READER  Reader;
+
+  Reader.Read      = Read;
+  Reader.ReadStart = NULL;
+  Reader.ReadWait  = NULL;
+
+  return ImageDecompressEx (Type, &Reader, Context, CompressedSize, Destination, DestinationSize, Stats);
+}
+
+/**
+  Decompress an image, overlapping reads with decoding.
+
+  Like ImageDecompress(), but if the reader can read in the background the
+  next IMAGE_DECOMPRESS_CHUNK_SIZE chunk is read into a second buffer while
+  the current chunk is decoded.
+
+  @param[in]  Type              Compression type of the image
+  @param[in]  Reader            Functions to read the compressed image
+  @param[in]  Context           Context passed to the Reader functions
+  @param[in]  CompressedSize    Size of the compressed image
+  @param[out] Destination       Buffer to decompress the image to
+  @param[in]  DestinationSize   Size of Destination
+  @param[out] Stats             Optional decompression statistics
+
+  @retval EFI_SUCCESS            Image decompressed, size in Stats
+  @retval EFI_INVALID_PARAMETER  Invalid parameter
+  @retval EFI_UNSUPPORTED        Compression type or feature not supported
+  @retval EFI_BUFFER_TOO_SMALL   Destination is too small for the image
+  @retval EFI_VOLUME_CORRUPTED   Compressed image is malformed
+  @retval EFI_CRC_ERROR          Decompressed data failed the integrity check
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the stream buffers
+  @retval Others                 Error returned by the Reader functions
+
+**/
+EFI_STATUS
+EFIAPI
+ImageDecompressEx (
+  IN  IMAGE_COMPRESSION_TYPE         Type,
+  IN  CONST IMAGE_DECOMPRESS_READER  *Reader,
+  IN  VOID                           *Context,
+  IN  UINT64                         CompressedSize,
+  OUT VOID                           *Destination,
+  IN  UINTN                          DestinationSize,
+  OUT IMAGE_DECOMPRESS_STATS         *Stats OPTIONAL
+  )
+{
+  EFI_STATUS              Status;
+  DECOMPRESS_STREAM       Stream;
+  IMAGE_DECOMPRESS_STATS  LocalStats;
+
+  if ((Reader == NULL) || (Reader->Read == NULL) || (Destination == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Type <= ImageCompressionNone) || (Type >= ImageCompressionMax)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ZeroMem (&Stream, sizeof (Stream));
+  ZeroMem (&LocalStats, sizeof (LocalStats));
+  Stream.Read       = Reader->Read;
+  Stream.Context    = Context;
+  Stream.InputSize  = CompressedSize;
+  Stream.Output     = (UINT8 *)Destination;
+  Stream.OutputSize = DestinationSize;
+  Stream.Status     = EFI_SUCCESS;
+  Stream.Stats      = &LocalStats;
+
+  Stream.Chunk = AllocatePool (IMAGE_DECOMPRESS_CHUNK_SIZE);
+  if (Stream.Chunk == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if ((Reader->ReadStart != NULL) && (Reader->ReadWait != NULL)) {
+    Stream.NextChunk = AllocatePool (IMAGE_DECOMPRESS_CHUNK_SIZE);
+    if (Stream.NextChunk != NULL) {
+      Stream.ReadStart = Reader->ReadStart;
+      Stream.ReadWait  = Reader->ReadWait;
+    }
+  }
+
+  if (Type == ImageCompressionGzip) {
+    Status = GzipDecompress (&Stream);
+  } else {
+    Status = Lz4Decompress (&Stream, Type == ImageCompressionLz4Legacy);
+  }
+
+  if (!EFI_ERROR (Status) && EFI_ERROR (Stream.Status)) {
+    Status = Stream.Status;
+  }
+
+  // the decoder may stop before consuming a chunk read ahead
+  if (Stream.NextChunkLength != 0) {
+    Stream.ReadWait (Stream.Context);
+  }
+
+  LocalStats.CompressedSize   = DecompressStreamPosition (&Stream);
+  LocalStats.DecompressedSize = Stream.OutputPosition;
+  if (Stats != NULL) {
+    CopyMem (Stats, &LocalStats, sizeof (LocalStats));
+  }
+
+  FreePool (Stream.Chunk);
+  if (Stream.NextChunk != NULL) {
+    FreePool (Stream.NextChunk);
+  }
+
+  return Status;
+}
@@ -0,0 +1,169 @@
+/** @file
+
+  Image Decompress Library private definitions
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __IMAGE_DECOMPRESS_LIB_PRIVATE_H__
+#define __IMAGE_DECOMPRESS_LIB_PRIVATE_H__
+
+#include <Library/ImageDecompressLib.h>
+
+#define GZIP_ID1  0x1f
+#define GZIP_ID2  0x8b
+
+#define LZ4_FRAME_MAGIC         0x184D2204
+#define LZ4_LEGACY_MAGIC        0x184C2102
+#define LZ4_LEGACY_BLOCK_SIZE   SIZE_8MB
+#define LZ4_COMPRESS_BOUND(n)   ((n) + ((n) / 255) + 16)
+#define LZ4_MIN_MATCH           4
+#define LZ4_BLOCK_UNCOMPRESSED  BIT31
+
+// Bytes of zero padding allowed past the end of the input while peeking bits
+#define DECOMPRESS_MAX_OVERRUN  8
+
+typedef struct {
+  IMAGE_DECOMPRESS_READ          Read;
+  IMAGE_DECOMPRESS_READ_START    ReadStart;
+  IMAGE_DECOMPRESS_READ_WAIT     ReadWait;
+  VOID                           *Context;
+  UINT64                         InputSize;
+  UINT64                         InputOffset;
+
+  UINT8                          *Chunk;
+  UINTN                          ChunkLength;
+  UINTN                          ChunkPosition;
+  UINTN                          Overrun;
+
+  // chunk being read in the background, NextChunkLength is 0 if none
+  UINT8                          *NextChunk;
+  UINTN                          NextChunkLength;
+
+  UINT64                         BitBuffer;
+  UINT32                         BitCount;
+
+  UINT8                          *Output;
+  UINTN                          OutputSize;
+  UINTN                          OutputPosition;
+
+  EFI_STATUS                     Status;
+  IMAGE_DECOMPRESS_STATS         *Stats;
+} DECOMPRESS_STREAM;
+
+/**
+  Return the next byte of the compressed input.
+
+  Past the end of the input zero bytes are returned so that bit readers can
+  peek, and the stream enters the error state once that exceeds
+  DECOMPRESS_MAX_OVERRUN.
+
+  @param[in]  Stream    Decompress stream
+
+  @retval Next byte of the input
+
+**/
+UINT8
+DecompressStreamGetByte (
+  IN DECOMPRESS_STREAM  *Stream
+  );
+
+/**
+  Copy bytes of the compressed input to the output buffer.
+
+  @param[in]  Stream    Decompress stream
+  @param[in]  Length    Number of bytes to copy
+
+  @retval EFI_SUCCESS           Bytes copied
+  @retval EFI_BUFFER_TOO_SMALL  Output buffer too small
+  @retval Others                Stream error
+
+**/
+EFI_STATUS
+DecompressStreamCopy (
+  IN DECOMPRESS_STREAM  *Stream,
+  IN UINTN              Length
+  );
+
+/**
+  Read a little endian 32-bit value from the compressed input.
+
+  @param[in]  Stream    Decompress stream
+
+  @retval Value read
+
+**/
+UINT32
+DecompressStreamGetUint32 (
+  IN DECOMPRESS_STREAM  *Stream
+  );
+
+/**
+  Return the offset in the compressed input of the next byte to be consumed.
+
+  @param[in]  Stream    Decompress stream
+
+  @retval Offset of the next input byte
+
+**/
+UINT64
+DecompressStreamPosition (
+  IN DECOMPRESS_STREAM  *Stream
+  );
+
+/**
+  Decompress a gzip stream.
+
+  @param[in]  Stream    Decompress stream
+
+  @retval EFI_SUCCESS   Stream decompressed
+  @retval Others        Error decompressing the stream
+
+**/
+EFI_STATUS
+GzipDecompress (
+  IN DECOMPRESS_STREAM  *Stream
+  );
+
+/**
+  Decompress an LZ4 frame or legacy stream.
+
+  @param[in]  Stream    Decompress stream
+  @param[in]  Legacy    TRUE for the legacy format
+
+  @retval EFI_SUCCESS   Stream decompressed
+  @retval Others        Error decompressing the stream
+
+**/
+EFI_STATUS
+Lz4Decompress (
+  IN DECOMPRESS_STREAM  *Stream,
+  IN BOOLEAN            Legacy
+  );
+
+/**
+  Get the decompressed size, or an upper bound of it, of an LZ4 stream.
+
+  @param[in]  Read              Function to read the compressed image
+  @param[in]  Context           Context passed to Read
+  @param[in]  CompressedSize    Size of the compressed image
+  @param[in]  Legacy            TRUE for the legacy format
+  @param[out] DecompressedSize  Size of the buffer needed to decompress the image
+
+  @retval EFI_SUCCESS   Size returned
+  @retval Others        Error parsing the stream
+
+**/
+EFI_STATUS
+Lz4GetSize (
+  IN  IMAGE_DECOMPRESS_READ  Read,
+  IN  VOID                   *Context,
+  IN  UINT64                 CompressedSize,
+  IN  BOOLEAN                Legacy,
+  OUT UINT64                 *DecompressedSize
+  );
+
+#endif
@@ -0,0 +1,436 @@
+/** @file
+
+  LZ4 frame and legacy format decoder
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+#include "ImageDecompressLibPrivate.h"
+
+#define LZ4_FLG_VERSION_MASK       (BIT7 | BIT6)
+#define LZ4_FLG_VERSION            BIT6
+#define LZ4_FLG_BLOCK_CHECKSUM     BIT4
+#define LZ4_FLG_CONTENT_SIZE       BIT3
+#define LZ4_FLG_CONTENT_CHECKSUM   BIT2
+#define LZ4_FLG_DICT_ID            BIT0
+#define LZ4_BD_BLOCK_MAX_SHIFT     4
+#define LZ4_BD_BLOCK_MAX_MASK      0x7
+#define LZ4_BD_BLOCK_MAX_MIN       4
+
+typedef struct {
+  UINT8     Flags;
+  UINT32    BlockMaxSize;
+  UINT64    ContentSize;
+  UINTN     HeaderSize;
+} LZ4_FRAME_DESCRIPTOR;
+
+/**
+  Parse the LZ4 frame descriptor following the magic number.
+
+  @param[in]  Header        Frame header, at least 19 bytes
+  @param[out] Descriptor    Parsed descriptor
+
+  @retval EFI_SUCCESS            Descriptor parsed
+  @retval EFI_UNSUPPORTED        Frame uses an unsupported feature
+  @retval EFI_VOLUME_CORRUPTED   Descriptor is malformed
+
+**/
+STATIC
+EFI_STATUS
+Lz4ParseFrameDescriptor (
+  IN  CONST UINT8           *Header,
+  OUT LZ4_FRAME_DESCRIPTOR  *Descriptor
+  )
+{
+  UINT32  BlockMax;
+
+  Descriptor->Flags = Header[4];
+  if ((Descriptor->Flags & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  if ((Descriptor->Flags & LZ4_FLG_DICT_ID) != 0) {
+    DEBUG ((DEBUG_ERROR, "%a: dictionary frames are not supported\n", __FUNCTION__));
+    return EFI_UNSUPPORTED;
+  }
+
+  BlockMax = (Header[5] >> LZ4_BD_BLOCK_MAX_SHIFT) & LZ4_BD_BLOCK_MAX_MASK;
+  if (BlockMax < LZ4_BD_BLOCK_MAX_MIN) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  Descriptor->BlockMaxSize = 1U << (2 * BlockMax + 8);
+  Descriptor->ContentSize  = 0;
+  Descriptor->HeaderSize   = 4 + 2 + 1;
+  if ((Descriptor->Flags & LZ4_FLG_CONTENT_SIZE) != 0) {
+    Descriptor->ContentSize = ReadUnaligned64 ((CONST UINT64 *)&Header[6]);
+    Descriptor->HeaderSize += sizeof (UINT64);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Decode one compressed LZ4 block.
+
+  @param[in]  Stream      Decompress stream
+  @param[in]  BlockSize   Compressed size of the block
+
+  @retval EFI_SUCCESS   Block decoded
+  @retval Others        Error decoding the block
+
+**/
+STATIC
+EFI_STATUS
+Lz4DecodeBlock (
+  IN DECOMPRESS_STREAM  *Stream,
+  IN UINT32             BlockSize
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      BlockEnd;
+  UINT8       Token;
+  UINT8       Byte;
+  UINTN       Length;
+  UINTN       Offset;
+  UINT8       *Output;
+
+  BlockEnd = DecompressStreamPosition (Stream) + BlockSize;
+  Output   = Stream->Output;
+
+  while (!EFI_ERROR (Stream->Status)) {
+    Token = DecompressStreamGetByte (Stream);
+
+    Length = Token >> 4;
+    if (Length == 0xF) {
+      do {
+        Byte    = DecompressStreamGetByte (Stream);
+        Length += Byte;
+      } while ((Byte == 0xFF) && !EFI_ERROR (Stream->Status));
+    }
+
+    Status = DecompressStreamCopy (Stream, Length);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    // The last sequence of a block only carries literals
+    if (DecompressStreamPosition (Stream) >= BlockEnd) {
+      break;
+    }
+
+    Offset  = DecompressStreamGetByte (Stream);
+    Offset |= (UINTN)DecompressStreamGetByte (Stream) << 8;
+    if ((Offset == 0) || (Offset > Stream->OutputPosition)) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    Length = Token & 0xF;
+    if (Length == 0xF) {
+      do {
+        Byte    = DecompressStreamGetByte (Stream);
+        Length += Byte;
+      } while ((Byte == 0xFF) && !EFI_ERROR (Stream->Status));
+    }
+
+    Length += LZ4_MIN_MATCH;
+    if (Length > Stream->OutputSize - Stream->OutputPosition) {
+      return EFI_BUFFER_TOO_SMALL;
+    }
+
+    if (Offset >= Length) {
+      CopyMem (&Output[Stream->OutputPosition], &Output[Stream->OutputPosition - Offset], Length);
+      Stream->OutputPosition += Length;
+    } else {
+      // Overlapping match repeats the last Offset bytes
+      while (Length-- > 0) {
+        Output[Stream->OutputPosition] = Output[Stream->OutputPosition - Offset];
+        Stream->OutputPosition++;
+      }
+    }
+  }
+
+  if (EFI_ERROR (Stream->Status)) {
+    return Stream->Status;
+  }
+
+  if (DecompressStreamPosition (Stream) != BlockEnd) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Decompress an LZ4 frame.
+
+  @param[in]  Stream    Decompress stream
+
+  @retval EFI_SUCCESS   Frame decompressed
+  @retval Others        Error decompressing the frame
+
+**/
+STATIC
+EFI_STATUS
+Lz4DecompressFrame (
+  IN DECOMPRESS_STREAM  *Stream
+  )
+{
+  EFI_STATUS            Status;
+  UINT8                 Header[4 + 2 + sizeof (UINT64) + 1];
+  LZ4_FRAME_DESCRIPTOR  Descriptor;
+  UINTN                 Index;
+  UINT32                BlockSize;
+
+  for (Index = 0; Index < 4 + 2; Index++) {
+    Header[Index] = DecompressStreamGetByte (Stream);
+  }
+
+  if ((Header[4] & LZ4_FLG_CONTENT_SIZE) != 0) {
+    for ( ; Index < 4 + 2 + sizeof (UINT64); Index++) {
+      Header[Index] = DecompressStreamGetByte (Stream);
+    }
+  }
+
+  Status = Lz4ParseFrameDescriptor (Header, &Descriptor);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  // Header checksum
+  DecompressStreamGetByte (Stream);
+
+  while (!EFI_ERROR (Stream->Status)) {
+    BlockSize = DecompressStreamGetUint32 (Stream);
+    if (BlockSize == 0) {
+      break;
+    }
+
+    if ((BlockSize & ~LZ4_BLOCK_UNCOMPRESSED) > Descriptor.BlockMaxSize) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    if ((BlockSize & LZ4_BLOCK_UNCOMPRESSED) != 0) {
+      Status = DecompressStreamCopy (Stream, BlockSize & ~LZ4_BLOCK_UNCOMPRESSED);
+    } else {
+      Status = Lz4DecodeBlock (Stream, BlockSize);
+    }
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if ((Descriptor.Flags & LZ4_FLG_BLOCK_CHECKSUM) != 0) {
+      DecompressStreamGetUint32 (Stream);
+    }
+  }
+
+  if ((Descriptor.Flags & LZ4_FLG_CONTENT_CHECKSUM) != 0) {
+    DecompressStreamGetUint32 (Stream);
+  }
+
+  if (EFI_ERROR (Stream->Status) || (Stream->Overrun != 0)) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  if (((Descriptor.Flags & LZ4_FLG_CONTENT_SIZE) != 0) &&
+      (Descriptor.ContentSize != Stream->OutputPosition))
+  {
+    DEBUG ((DEBUG_ERROR, "%a: size mismatch 0x%llx != 0x%llx\n", __FUNCTION__, Descriptor.ContentSize, (UINT64)Stream->OutputPosition));
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Decompress an LZ4 legacy stream.
+
+  The Linux kernel build appends the decompressed size as a trailing 32-bit
+  value which is recognized as the end of the stream.
+
+  @param[in]  Stream    Decompress stream
+
+  @retval EFI_SUCCESS   Stream decompressed
+  @retval Others        Error decompressing the stream
+
+**/
+STATIC
+EFI_STATUS
+Lz4DecompressLegacy (
+  IN DECOMPRESS_STREAM  *Stream
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      BlockSize;
+  UINTN       BlockStart;
+
+  if (DecompressStreamGetUint32 (Stream) != LZ4_LEGACY_MAGIC) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  while (DecompressStreamPosition (Stream) < Stream->InputSize) {
+    BlockSize = DecompressStreamGetUint32 (Stream);
+    if (BlockSize == LZ4_LEGACY_MAGIC) {
+      continue;
+    }
+
+    if (DecompressStreamPosition (Stream) >= Stream->InputSize) {
+      // Trailing size appended by the kernel build
+      if (BlockSize != (UINT32)Stream->OutputPosition) {
+        return EFI_VOLUME_CORRUPTED;
+      }
+
+      break;
+    }
+
+    if (BlockSize > LZ4_COMPRESS_BOUND (LZ4_LEGACY_BLOCK_SIZE)) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    BlockStart = Stream->OutputPosition;
+    Status     = Lz4DecodeBlock (Stream, BlockSize);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Stream->OutputPosition - BlockStart > LZ4_LEGACY_BLOCK_SIZE) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+  }
+
+  if (EFI_ERROR (Stream->Status) || (Stream->Overrun != 0)) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Decompress an LZ4 frame or legacy stream.
+
+  @param[in]  Stream    Decompress stream
+  @param[in]  Legacy    TRUE for the legacy format
+
+  @retval EFI_SUCCESS   Stream decompressed
+  @retval Others        Error decompressing the stream
+
+**/
+EFI_STATUS
+Lz4Decompress (
+  IN DECOMPRESS_STREAM  *Stream,
+  IN BOOLEAN            Legacy
+  )
+{
+  if (Legacy) {
+    return Lz4DecompressLegacy (Stream);
+  }
+
+  return Lz4DecompressFrame (Stream);
+}
+
+/**
+  Get the decompressed size, or an upper bound of it, of an LZ4 stream.
+
+  Only the frame and block headers are read.
+
+  @param[in]  Read              Function to read the compressed image
+  @param[in]  Context           Context passed to Read
+  @param[in]  CompressedSize    Size of the compressed image
+  @param[in]  Legacy            TRUE for the legacy format
+  @param[out] DecompressedSize  Size of the buffer needed to decompress the image
+
+  @retval EFI_SUCCESS   Size returned
+  @retval Others        Error parsing the stream
+
+**/
+EFI_STATUS
+Lz4GetSize (
+  IN  IMAGE_DECOMPRESS_READ  Read,
+  IN  VOID                   *Context,
+  IN  UINT64                 CompressedSize,
+  IN  BOOLEAN                Legacy,
+  OUT UINT64                 *DecompressedSize
+  )
+{
+  EFI_STATUS            Status;
+  UINT8                 Header[4 + 2 + sizeof (UINT64) + 1];
+  LZ4_FRAME_DESCRIPTOR  Descriptor;
+  UINT64                Offset;
+  UINT64                Size;
+  UINT32                BlockSize;
+  UINT32                BlockMaxSize;
+  UINT32                BlockTrailer;
+
+  if (CompressedSize < 2 * sizeof (UINT32)) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  if (Legacy) {
+    Offset       = sizeof (UINT32);
+    BlockMaxSize = LZ4_LEGACY_BLOCK_SIZE;
+    BlockTrailer = 0;
+  } else {
+    ZeroMem (Header, sizeof (Header));
+    Status = Read (Context, 0, Header, (UINTN)MIN (sizeof (Header), CompressedSize));
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = Lz4ParseFrameDescriptor (Header, &Descriptor);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if ((Descriptor.Flags & LZ4_FLG_CONTENT_SIZE) != 0) {
+      *DecompressedSize = Descriptor.ContentSize;
+      return EFI_SUCCESS;
+    }
+
+    Offset       = Descriptor.HeaderSize;
+    BlockMaxSize = Descriptor.BlockMaxSize;
+    BlockTrailer = ((Descriptor.Flags & LZ4_FLG_BLOCK_CHECKSUM) != 0) ? sizeof (UINT32) : 0;
+  }
+
+  Size = 0;
+  while (Offset + sizeof (BlockSize) <= CompressedSize) {
+    Status = Read (Context, Offset, &BlockSize, sizeof (BlockSize));
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Offset += sizeof (BlockSize);
+    if (Legacy) {
+      if (BlockSize == LZ4_LEGACY_MAGIC) {
+        continue;
+      }
+
+      if (Offset == CompressedSize) {
+        // Trailing size appended by the kernel build is exact
+        Size = BlockSize;
+        break;
+      }
+    } else if (BlockSize == 0) {
+      break;
+    }
+
+    if ((BlockSize & LZ4_BLOCK_UNCOMPRESSED) != 0) {
+      BlockSize &= ~LZ4_BLOCK_UNCOMPRESSED;
+      Size      += BlockSize;
+    } else {
+      Size += BlockMaxSize;
+    }
+
+    Offset += (UINT64)BlockSize + BlockTrailer;
+  }
+
+  *DecompressedSize = Size;
+  return EFI_SUCCESS;
+}
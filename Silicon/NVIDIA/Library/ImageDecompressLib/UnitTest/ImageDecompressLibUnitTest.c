@@ -0,0 +1,719 @@
+/** @file
+
+  Image Decompress Library Unit Test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/ImageDecompressLib.h>
+
+#define UNIT_TEST_NAME     "Image Decompress Lib Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_PLAIN_SIZE    2048
+#define TEST_LARGE_SIZE    (3 * IMAGE_DECOMPRESS_CHUNK_SIZE + 1234)
+#define TEST_STORED_BLOCK  0xffff
+
+typedef struct {
+  CONST UINT8    *Buffer;
+  UINTN          Size;
+  UINTN          ReadCount;
+
+  // read started by TestReadStart, completed by TestReadWait
+  UINT8          *PendingBuffer;
+  UINT64         PendingOffset;
+  UINTN          PendingSize;
+  UINTN          ReadAheadCount;
+  UINTN          OrderErrors;
+} TEST_READ_CONTEXT;
+
+typedef struct {
+  IMAGE_COMPRESSION_TYPE    Type;
+  CONST UINT8               *Image;
+  UINTN                     ImageSize;
+  BOOLEAN                   ExactSize;
+} TEST_VECTOR;
+
+////////////////////////////////////////////////////////////////////////////////
+// TEST VECTORS
+//
+// All vectors decompress to TestPlainFill (TEST_PLAIN_SIZE).
+////////////////////////////////////////////////////////////////////////////////
+
+STATIC CONST UINT8  mGzipDynamic[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x63, 0x48,
+  0x2d, 0x29, 0xce, 0xcf, 0x53, 0x48, 0xca, 0xcf, 0x2f, 0x51, 0xc8, 0xcc,
+  0x4d, 0x4c, 0x4f, 0x55, 0x28, 0x48, 0xac, 0xcc, 0xc9, 0x4f, 0x4c, 0x51,
+  0xf0, 0x22, 0x2c, 0x23, 0x49, 0x86, 0x1e, 0xb8, 0x8c, 0x11, 0x19, 0x7a,
+  0xe0, 0x32, 0xde, 0x14, 0xb8, 0x3a, 0x3f, 0x85, 0x02, 0x57, 0x17, 0xd4,
+  0x52, 0xe0, 0xea, 0xd4, 0x69, 0x14, 0xb8, 0xba, 0x64, 0x3d, 0x05, 0xae,
+  0x4e, 0x3c, 0x41, 0x81, 0xab, 0x4b, 0x1e, 0x52, 0xe0, 0x6a, 0x85, 0x5f,
+  0x14, 0xb8, 0xba, 0x52, 0x98, 0x02, 0x57, 0x17, 0xeb, 0x50, 0xe0, 0xea,
+  0x4c, 0x57, 0x0a, 0x5c, 0x9d, 0x13, 0x47, 0x81, 0xab, 0xf3, 0xcb, 0x29,
+  0x70, 0x75, 0xee, 0x04, 0x0a, 0x5c, 0x9d, 0xbf, 0x92, 0x02, 0x57, 0xe7,
+  0x1d, 0xa2, 0xc0, 0xd5, 0x89, 0xb7, 0x29, 0x70, 0x75, 0xe2, 0x17, 0x0a,
+  0x5c, 0xad, 0xc0, 0x4b, 0x81, 0xab, 0xd3, 0xd5, 0x28, 0x70, 0x75, 0x8a,
+  0x3d, 0x05, 0xae, 0x4e, 0x8a, 0xa0, 0xc0, 0xd5, 0xa9, 0x85, 0x14, 0xb8,
+  0x5a, 0xa1, 0x8b, 0x92, 0x1a, 0x63, 0x31, 0x25, 0x35, 0xc6, 0x1e, 0x4a,
+  0x6a, 0x8c, 0xab, 0x94, 0xd4, 0x18, 0xef, 0x28, 0xa9, 0x31, 0xd8, 0x29,
+  0xa9, 0x31, 0x14, 0x28, 0xa9, 0x31, 0x2c, 0x09, 0xeb, 0x01, 0x00, 0xfb,
+  0x6a, 0xb4, 0xc9, 0x00, 0x08, 0x00, 0x00,
+};
+
+STATIC CONST UINT8  mGzipFixedName[] = {
+  0x1f, 0x8b, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x49, 0x6d,
+  0x61, 0x67, 0x65, 0x00, 0x63, 0x48, 0x2d, 0x29, 0xce, 0xcf, 0x53, 0x48,
+  0xca, 0xcf, 0x2f, 0x51, 0xc8, 0xcc, 0x4d, 0x4c, 0x4f, 0x55, 0x28, 0x48,
+  0xac, 0xcc, 0xc9, 0x4f, 0x4c, 0x51, 0xf0, 0x22, 0x2c, 0x23, 0x49, 0x86,
+  0x1e, 0xb8, 0x8c, 0x11, 0x19, 0x7a, 0xe0, 0x32, 0xde, 0x14, 0xb8, 0x3a,
+  0x3f, 0x85, 0x02, 0x57, 0x17, 0xd4, 0x52, 0xe0, 0xea, 0xd4, 0x69, 0x14,
+  0xb8, 0xba, 0x64, 0x3d, 0x05, 0xae, 0x4e, 0x3c, 0x41, 0x81, 0xab, 0x4b,
+  0x1e, 0x52, 0xe0, 0x6a, 0x85, 0x5f, 0x14, 0xb8, 0xba, 0x52, 0x98, 0x02,
+  0x57, 0x17, 0xeb, 0x50, 0xe0, 0xea, 0x4c, 0x57, 0x0a, 0x5c, 0x9d, 0x13,
+  0x47, 0x81, 0xab, 0xf3, 0xcb, 0x29, 0x70, 0x75, 0xee, 0x04, 0x0a, 0x5c,
+  0x9d, 0xbf, 0x92, 0x02, 0x57, 0xe7, 0x1d, 0xa2, 0xc0, 0xd5, 0x89, 0xb7,
+  0x29, 0x70, 0x75, 0xe2, 0x17, 0x0a, 0x5c, 0xad, 0xc0, 0x4b, 0x81, 0xab,
+  0xd3, 0xd5, 0x28, 0x70, 0x75, 0x8a, 0x3d, 0x05, 0xae, 0x4e, 0x8a, 0xa0,
+  0xc0, 0xd5, 0xa9, 0x85, 0x14, 0xb8, 0x5a, 0xa1, 0x8b, 0x92, 0x1a, 0x63,
+  0x31, 0x25, 0x35, 0xc6, 0x1e, 0x4a, 0x6a, 0x8c, 0xab, 0x94, 0xd4, 0x18,
+  0xef, 0x28, 0xa9, 0x31, 0xd8, 0x29, 0xa9, 0x31, 0x14, 0x28, 0xa9, 0x31,
+  0x2c, 0x09, 0xeb, 0x01, 0x00, 0xfb, 0x6a, 0xb4, 0xc9, 0x00, 0x08, 0x00,
+  0x00,
+};
+
+STATIC CONST UINT8  mLz4Frame[] = {
+  0x04, 0x22, 0x4d, 0x18, 0x68, 0x40, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x4a, 0x01, 0x00, 0x00, 0xff, 0x0c, 0x00, 0x65, 0x74,
+  0x73, 0x6f, 0x6e, 0x20, 0x62, 0x6f, 0x6f, 0x74, 0x20, 0x69, 0x6d, 0x61,
+  0x67, 0x65, 0x20, 0x70, 0x61, 0x79, 0x6c, 0x6f, 0x61, 0x64, 0x20, 0x4a,
+  0x1a, 0x00, 0x0f, 0x1f, 0x19, 0x34, 0x00, 0x20, 0x05, 0x68, 0x00, 0x1f,
+  0x32, 0x68, 0x00, 0x17, 0x05, 0x34, 0x00, 0x05, 0x9c, 0x00, 0x1f, 0x4b,
+  0xb6, 0x00, 0x28, 0x2f, 0x6f, 0x64, 0xea, 0x00, 0x1f, 0x06, 0x82, 0x00,
+  0x1f, 0x7d, 0x1e, 0x01, 0x16, 0x06, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f,
+  0x96, 0x6c, 0x01, 0x27, 0x3f, 0x6f, 0x74, 0xaf, 0xa0, 0x01, 0x1e, 0x07,
+  0x82, 0x00, 0x1f, 0xc8, 0xd4, 0x01, 0x15, 0x07, 0x34, 0x00, 0x05, 0xea,
+  0x00, 0x1f, 0xe1, 0x22, 0x02, 0x26, 0x4f, 0x6f, 0x74, 0x20, 0xfa, 0x56,
+  0x02, 0x1d, 0x08, 0x82, 0x00, 0x1f, 0x13, 0x8a, 0x02, 0x14, 0x08, 0x34,
+  0x00, 0x05, 0xea, 0x00, 0x1f, 0x2c, 0xd8, 0x02, 0x25, 0x00, 0x4e, 0x00,
+  0x1f, 0x45, 0x0c, 0x03, 0x1c, 0x00, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f,
+  0x5e, 0x40, 0x03, 0x13, 0x09, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0x77,
+  0x8e, 0x03, 0x24, 0x01, 0x4e, 0x00, 0x1f, 0x90, 0xc2, 0x03, 0x1b, 0x01,
+  0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0xa9, 0xf6, 0x03, 0x12, 0x0a, 0x34,
+  0x00, 0x05, 0xea, 0x00, 0x1f, 0xc2, 0x44, 0x04, 0x23, 0x02, 0x4e, 0x00,
+  0x1f, 0xdb, 0x78, 0x04, 0x1a, 0x02, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f,
+  0xf4, 0xac, 0x04, 0x11, 0x0b, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0x0d,
+  0xfa, 0x04, 0x22, 0x03, 0x4e, 0x00, 0x1f, 0x26, 0x2e, 0x05, 0x19, 0x03,
+  0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0x3f, 0x62, 0x05, 0x10, 0x0c, 0x34,
+  0x00, 0x05, 0xea, 0x00, 0x1f, 0x58, 0x1a, 0x00, 0x06, 0x0f, 0xd0, 0x00,
+  0x10, 0x15, 0x71, 0x48, 0x05, 0x0f, 0xe4, 0x05, 0x0f, 0x0d, 0x68, 0x00,
+  0x1f, 0x8a, 0x34, 0x00, 0x20, 0x05, 0xea, 0x00, 0x1f, 0xa3, 0x32, 0x06,
+  0x29, 0x15, 0xbc, 0x48, 0x05, 0x0f, 0xfe, 0x05, 0x20, 0x1f, 0xd5, 0x34,
+  0x00, 0x20, 0x05, 0xea, 0x00, 0x1f, 0xee, 0x32, 0x06, 0x29, 0x15, 0x07,
+  0x48, 0x05, 0x0f, 0xfe, 0x05, 0x20, 0x1f, 0x20, 0x34, 0x00, 0x20, 0x05,
+  0xea, 0x00, 0x1f, 0x39, 0x32, 0x06, 0x0a, 0x50, 0x67, 0x65, 0x20, 0x70,
+  0x61, 0x00, 0x00, 0x00, 0x00,
+};
+
+STATIC CONST UINT8  mLz4FrameNoSize[] = {
+  0x04, 0x22, 0x4d, 0x18, 0x60, 0x40, 0x00, 0x4a, 0x01, 0x00, 0x00, 0xff,
+  0x0c, 0x00, 0x65, 0x74, 0x73, 0x6f, 0x6e, 0x20, 0x62, 0x6f, 0x6f, 0x74,
+  0x20, 0x69, 0x6d, 0x61, 0x67, 0x65, 0x20, 0x70, 0x61, 0x79, 0x6c, 0x6f,
+  0x61, 0x64, 0x20, 0x4a, 0x1a, 0x00, 0x0f, 0x1f, 0x19, 0x34, 0x00, 0x20,
+  0x05, 0x68, 0x00, 0x1f, 0x32, 0x68, 0x00, 0x17, 0x05, 0x34, 0x00, 0x05,
+  0x9c, 0x00, 0x1f, 0x4b, 0xb6, 0x00, 0x28, 0x2f, 0x6f, 0x64, 0xea, 0x00,
+  0x1f, 0x06, 0x82, 0x00, 0x1f, 0x7d, 0x1e, 0x01, 0x16, 0x06, 0x34, 0x00,
+  0x05, 0xea, 0x00, 0x1f, 0x96, 0x6c, 0x01, 0x27, 0x3f, 0x6f, 0x74, 0xaf,
+  0xa0, 0x01, 0x1e, 0x07, 0x82, 0x00, 0x1f, 0xc8, 0xd4, 0x01, 0x15, 0x07,
+  0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0xe1, 0x22, 0x02, 0x26, 0x4f, 0x6f,
+  0x74, 0x20, 0xfa, 0x56, 0x02, 0x1d, 0x08, 0x82, 0x00, 0x1f, 0x13, 0x8a,
+  0x02, 0x14, 0x08, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0x2c, 0xd8, 0x02,
+  0x25, 0x00, 0x4e, 0x00, 0x1f, 0x45, 0x0c, 0x03, 0x1c, 0x00, 0x34, 0x00,
+  0x05, 0xea, 0x00, 0x1f, 0x5e, 0x40, 0x03, 0x13, 0x09, 0x34, 0x00, 0x05,
+  0xea, 0x00, 0x1f, 0x77, 0x8e, 0x03, 0x24, 0x01, 0x4e, 0x00, 0x1f, 0x90,
+  0xc2, 0x03, 0x1b, 0x01, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0xa9, 0xf6,
+  0x03, 0x12, 0x0a, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0xc2, 0x44, 0x04,
+  0x23, 0x02, 0x4e, 0x00, 0x1f, 0xdb, 0x78, 0x04, 0x1a, 0x02, 0x34, 0x00,
+  0x05, 0xea, 0x00, 0x1f, 0xf4, 0xac, 0x04, 0x11, 0x0b, 0x34, 0x00, 0x05,
+  0xea, 0x00, 0x1f, 0x0d, 0xfa, 0x04, 0x22, 0x03, 0x4e, 0x00, 0x1f, 0x26,
+  0x2e, 0x05, 0x19, 0x03, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0x3f, 0x62,
+  0x05, 0x10, 0x0c, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0x58, 0x1a, 0x00,
+  0x06, 0x0f, 0xd0, 0x00, 0x10, 0x15, 0x71, 0x48, 0x05, 0x0f, 0xe4, 0x05,
+  0x0f, 0x0d, 0x68, 0x00, 0x1f, 0x8a, 0x34, 0x00, 0x20, 0x05, 0xea, 0x00,
+  0x1f, 0xa3, 0x32, 0x06, 0x29, 0x15, 0xbc, 0x48, 0x05, 0x0f, 0xfe, 0x05,
+  0x20, 0x1f, 0xd5, 0x34, 0x00, 0x20, 0x05, 0xea, 0x00, 0x1f, 0xee, 0x32,
+  0x06, 0x29, 0x15, 0x07, 0x48, 0x05, 0x0f, 0xfe, 0x05, 0x20, 0x1f, 0x20,
+  0x34, 0x00, 0x20, 0x05, 0xea, 0x00, 0x1f, 0x39, 0x32, 0x06, 0x0a, 0x50,
+  0x67, 0x65, 0x20, 0x70, 0x61, 0x00, 0x00, 0x00, 0x00,
+};
+
+STATIC CONST UINT8  mLz4Legacy[] = {
+  0x02, 0x21, 0x4c, 0x18, 0x4a, 0x01, 0x00, 0x00, 0xff, 0x0c, 0x00, 0x65,
+  0x74, 0x73, 0x6f, 0x6e, 0x20, 0x62, 0x6f, 0x6f, 0x74, 0x20, 0x69, 0x6d,
+  0x61, 0x67, 0x65, 0x20, 0x70, 0x61, 0x79, 0x6c, 0x6f, 0x61, 0x64, 0x20,
+  0x4a, 0x1a, 0x00, 0x0f, 0x1f, 0x19, 0x34, 0x00, 0x20, 0x05, 0x68, 0x00,
+  0x1f, 0x32, 0x68, 0x00, 0x17, 0x05, 0x34, 0x00, 0x05, 0x9c, 0x00, 0x1f,
+  0x4b, 0xb6, 0x00, 0x28, 0x2f, 0x6f, 0x64, 0xea, 0x00, 0x1f, 0x06, 0x82,
+  0x00, 0x1f, 0x7d, 0x1e, 0x01, 0x16, 0x06, 0x34, 0x00, 0x05, 0xea, 0x00,
+  0x1f, 0x96, 0x6c, 0x01, 0x27, 0x3f, 0x6f, 0x74, 0xaf, 0xa0, 0x01, 0x1e,
+  0x07, 0x82, 0x00, 0x1f, 0xc8, 0xd4, 0x01, 0x15, 0x07, 0x34, 0x00, 0x05,
+  0xea, 0x00, 0x1f, 0xe1, 0x22, 0x02, 0x26, 0x4f, 0x6f, 0x74, 0x20, 0xfa,
+  0x56, 0x02, 0x1d, 0x08, 0x82, 0x00, 0x1f, 0x13, 0x8a, 0x02, 0x14, 0x08,
+  0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0x2c, 0xd8, 0x02, 0x25, 0x00, 0x4e,
+  0x00, 0x1f, 0x45, 0x0c, 0x03, 0x1c, 0x00, 0x34, 0x00, 0x05, 0xea, 0x00,
+  0x1f, 0x5e, 0x40, 0x03, 0x13, 0x09, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f,
+  0x77, 0x8e, 0x03, 0x24, 0x01, 0x4e, 0x00, 0x1f, 0x90, 0xc2, 0x03, 0x1b,
+  0x01, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0xa9, 0xf6, 0x03, 0x12, 0x0a,
+  0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0xc2, 0x44, 0x04, 0x23, 0x02, 0x4e,
+  0x00, 0x1f, 0xdb, 0x78, 0x04, 0x1a, 0x02, 0x34, 0x00, 0x05, 0xea, 0x00,
+  0x1f, 0xf4, 0xac, 0x04, 0x11, 0x0b, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f,
+  0x0d, 0xfa, 0x04, 0x22, 0x03, 0x4e, 0x00, 0x1f, 0x26, 0x2e, 0x05, 0x19,
+  0x03, 0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0x3f, 0x62, 0x05, 0x10, 0x0c,
+  0x34, 0x00, 0x05, 0xea, 0x00, 0x1f, 0x58, 0x1a, 0x00, 0x06, 0x0f, 0xd0,
+  0x00, 0x10, 0x15, 0x71, 0x48, 0x05, 0x0f, 0xe4, 0x05, 0x0f, 0x0d, 0x68,
+  0x00, 0x1f, 0x8a, 0x34, 0x00, 0x20, 0x05, 0xea, 0x00, 0x1f, 0xa3, 0x32,
+  0x06, 0x29, 0x15, 0xbc, 0x48, 0x05, 0x0f, 0xfe, 0x05, 0x20, 0x1f, 0xd5,
+  0x34, 0x00, 0x20, 0x05, 0xea, 0x00, 0x1f, 0xee, 0x32, 0x06, 0x29, 0x15,
+  0x07, 0x48, 0x05, 0x0f, 0xfe, 0x05, 0x20, 0x1f, 0x20, 0x34, 0x00, 0x20,
+  0x05, 0xea, 0x00, 0x1f, 0x39, 0x32, 0x06, 0x0a, 0x50, 0x67, 0x65, 0x20,
+  0x70, 0x61, 0x00, 0x08, 0x00, 0x00,
+};
+
+STATIC TEST_VECTOR  mGzipDynamicVector    = { ImageCompressionGzip, mGzipDynamic, sizeof (mGzipDynamic), TRUE };
+STATIC TEST_VECTOR  mGzipFixedNameVector  = { ImageCompressionGzip, mGzipFixedName, sizeof (mGzipFixedName), TRUE };
+STATIC TEST_VECTOR  mLz4FrameVector       = { ImageCompressionLz4, mLz4Frame, sizeof (mLz4Frame), TRUE };
+STATIC TEST_VECTOR  mLz4FrameNoSizeVector = { ImageCompressionLz4, mLz4FrameNoSize, sizeof (mLz4FrameNoSize), FALSE };
+STATIC TEST_VECTOR  mLz4LegacyVector      = { ImageCompressionLz4Legacy, mLz4Legacy, sizeof (mLz4Legacy), TRUE };
+
+STATIC CONST CHAR8  mPhrase[] = "Jetson boot image payload ";
+
+/**
+  Fill a buffer with the plain text of the test vectors.
+
+  @param[out] Buffer    Buffer to fill
+  @param[in]  Size      Size of Buffer
+
+**/
+STATIC
+VOID
+TestPlainFill (
+  OUT UINT8  *Buffer,
+  IN  UINTN  Size
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Size; Index++) {
+    if ((Index % 61) == 0) {
+      Buffer[Index] = (UINT8)(Index * 13);
+    } else {
+      Buffer[Index] = mPhrase[Index % (sizeof (mPhrase) - 1)];
+    }
+  }
+}
+
+/**
+  Read callback over an in-memory image.
+
+  @param[in]  Context       TEST_READ_CONTEXT
+  @param[in]  Offset        Offset of the data in the image
+  @param[out] Buffer        Buffer to read the data into
+  @param[in]  Size          Number of bytes to read
+
+  @retval EFI_SUCCESS       Data read
+  @retval EFI_DEVICE_ERROR  Read past the end of the image
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestRead (
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  OUT VOID    *Buffer,
+  IN  UINTN   Size
+  )
+{
+  TEST_READ_CONTEXT  *ReadContext;
+
+  ReadContext = (TEST_READ_CONTEXT *)Context;
+  if ((Offset > ReadContext->Size) || (Size > ReadContext->Size - Offset)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (ReadContext->PendingBuffer != NULL) {
+    ReadContext->OrderErrors++;
+  }
+
+  CopyMem (Buffer, ReadContext->Buffer + Offset, Size);
+  ReadContext->ReadCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Read start callback over an in-memory image.  The data is only copied by
+  TestReadWait, and the buffer is poisoned until then.
+
+  @param[in]  Context       TEST_READ_CONTEXT
+  @param[in]  Offset        Offset of the data in the image
+  @param[out] Buffer        Buffer to read the data into
+  @param[in]  Size          Number of bytes to read
+
+  @retval EFI_SUCCESS       Read started
+  @retval EFI_DEVICE_ERROR  Read past the end of the image
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestReadStart (
+  IN  VOID    *Context,
+  IN  UINT64  Offset,
+  OUT VOID    *Buffer,
+  IN  UINTN   Size
+  )
+{
+  TEST_READ_CONTEXT  *ReadContext;
+
+  ReadContext = (TEST_READ_CONTEXT *)Context;
+  if ((Offset > ReadContext->Size) || (Size > ReadContext->Size - Offset)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (ReadContext->PendingBuffer != NULL) {
+    ReadContext->OrderErrors++;
+  }
+
+  SetMem (Buffer, Size, 0xA5);
+  ReadContext->PendingBuffer = Buffer;
+  ReadContext->PendingOffset = Offset;
+  ReadContext->PendingSize   = Size;
+  ReadContext->ReadAheadCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Read wait callback, completes the read started by TestReadStart.
+
+  @param[in]  Context       TEST_READ_CONTEXT
+
+  @retval EFI_SUCCESS       Data read
+  @retval EFI_NOT_STARTED   No read was started
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestReadWait (
+  IN  VOID  *Context
+  )
+{
+  TEST_READ_CONTEXT  *ReadContext;
+
+  ReadContext = (TEST_READ_CONTEXT *)Context;
+  if (ReadContext->PendingBuffer == NULL) {
+    ReadContext->OrderErrors++;
+    return EFI_NOT_STARTED;
+  }
+
+  CopyMem (ReadContext->PendingBuffer, ReadContext->Buffer + ReadContext->PendingOffset, ReadContext->PendingSize);
+  ReadContext->PendingBuffer = NULL;
+  ReadContext->ReadCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Build a gzip stream of stored blocks.
+
+  @param[in]  Plain       Data to store
+  @param[in]  PlainSize   Size of Plain
+  @param[out] ImageSize   Size of the gzip stream
+
+  @retval Gzip stream, to be freed by the caller
+
+**/
+STATIC
+UINT8 *
+TestBuildStoredGzip (
+  IN  CONST UINT8  *Plain,
+  IN  UINTN        PlainSize,
+  OUT UINTN        *ImageSize
+  )
+{
+  STATIC CONST UINT8  Header[] = { 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03 };
+  UINT8               *Image;
+  UINT8               *Pointer;
+  UINTN               Offset;
+  UINT16              Length;
+
+  Image = AllocatePool (PlainSize + (PlainSize / TEST_STORED_BLOCK + 1) * 5 + sizeof (Header) + 8);
+  if (Image == NULL) {
+    return NULL;
+  }
+
+  CopyMem (Image, Header, sizeof (Header));
+  Pointer = Image + sizeof (Header);
+  for (Offset = 0; Offset < PlainSize; Offset += Length) {
+    Length     = (UINT16)MIN (PlainSize - Offset, TEST_STORED_BLOCK);
+    *Pointer++ = (Offset + Length == PlainSize) ? 1 : 0;
+    WriteUnaligned16 ((UINT16 *)Pointer, Length);
+    WriteUnaligned16 ((UINT16 *)(Pointer + 2), (UINT16) ~Length);
+    CopyMem (Pointer + 4, Plain + Offset, Length);
+    Pointer += 4 + Length;
+  }
+
+  WriteUnaligned32 ((UINT32 *)Pointer, CalculateCrc32 ((VOID *)Plain, PlainSize));
+  WriteUnaligned32 ((UINT32 *)(Pointer + 4), (UINT32)PlainSize);
+  *ImageSize = (Pointer + 8) - Image;
+
+  return Image;
+}
+
+/**
+  Decompress a vector and compare it with the expected plain text.
+
+  @param[in]  Context   TEST_VECTOR to decompress
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DecompressVector (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_VECTOR             *Vector;
+  TEST_READ_CONTEXT       ReadContext;
+  IMAGE_DECOMPRESS_STATS  Stats;
+  UINT64                  Size;
+  UINT8                   Expected[TEST_PLAIN_SIZE];
+  UINT8                   *Output;
+  EFI_STATUS              Status;
+
+  Vector = (TEST_VECTOR *)Context;
+  TestPlainFill (Expected, sizeof (Expected));
+
+  UT_ASSERT_EQUAL (ImageDecompressGetType (Vector->Image, Vector->ImageSize), Vector->Type);
+
+  ZeroMem (&ReadContext, sizeof (ReadContext));
+  ReadContext.Buffer    = Vector->Image;
+  ReadContext.Size      = Vector->ImageSize;
+  ReadContext.ReadCount = 0;
+
+  Status = ImageDecompressGetSize (Vector->Type, TestRead, &ReadContext, Vector->ImageSize, &Size);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  if (Vector->ExactSize) {
+    UT_ASSERT_EQUAL (Size, TEST_PLAIN_SIZE);
+  } else {
+    UT_ASSERT_TRUE (Size >= TEST_PLAIN_SIZE);
+  }
+
+  Output = AllocateZeroPool ((UINTN)Size);
+  UT_ASSERT_NOT_NULL (Output);
+
+  Status = ImageDecompress (Vector->Type, TestRead, &ReadContext, Vector->ImageSize, Output, (UINTN)Size, &Stats);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Stats.DecompressedSize, TEST_PLAIN_SIZE);
+  UT_ASSERT_EQUAL (Stats.CompressedSize, Vector->ImageSize);
+  UT_ASSERT_MEM_EQUAL (Output, Expected, TEST_PLAIN_SIZE);
+
+  // The destination must be large enough for the whole image
+  Status = ImageDecompress (Vector->Type, TestRead, &ReadContext, Vector->ImageSize, Output, TEST_PLAIN_SIZE - 1, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+
+  FreePool (Output);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Corrupted and truncated images must fail cleanly.
+
+  @param[in]  Context   TEST_VECTOR to corrupt
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DecompressCorrupted (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_VECTOR        *Vector;
+  TEST_READ_CONTEXT  ReadContext;
+  UINT8              *Image;
+  UINT8              Output[TEST_PLAIN_SIZE];
+  UINTN              Index;
+  EFI_STATUS         Status;
+
+  Vector = (TEST_VECTOR *)Context;
+  Image  = AllocateCopyPool (Vector->ImageSize, Vector->Image);
+  UT_ASSERT_NOT_NULL (Image);
+
+  ZeroMem (&ReadContext, sizeof (ReadContext));
+  ReadContext.Buffer = Image;
+  ReadContext.Size   = Vector->ImageSize;
+
+  // Flipping any byte past the header must never overrun, and must fail when
+  // the format carries a checksum
+  for (Index = (Vector->Type == ImageCompressionGzip) ? 10 : sizeof (UINT32); Index < Vector->ImageSize; Index++) {
+    Image[Index] ^= 0x5a;
+    Status        = ImageDecompress (Vector->Type, TestRead, &ReadContext, Vector->ImageSize, Output, sizeof (Output), NULL);
+    if (!EFI_ERROR (Status)) {
+      // LZ4 carries no mandatory checksum, so only the content may differ
+      UT_ASSERT_TRUE (Vector->Type != ImageCompressionGzip);
+    }
+
+    Image[Index] ^= 0x5a;
+  }
+
+  // Truncated image
+  Status = ImageDecompress (Vector->Type, TestRead, &ReadContext, Vector->ImageSize / 2, Output, sizeof (Output), NULL);
+  UT_ASSERT_TRUE (EFI_ERROR (Status));
+
+  FreePool (Image);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Stored gzip image larger than several read chunks.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DecompressMultiChunk (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_READ_CONTEXT       ReadContext;
+  IMAGE_DECOMPRESS_STATS  Stats;
+  UINT8                   *Plain;
+  UINT8                   *Image;
+  UINT8                   *Output;
+  UINTN                   ImageSize;
+  UINT64                  Size;
+  EFI_STATUS              Status;
+
+  Plain  = AllocatePool (TEST_LARGE_SIZE);
+  Output = AllocatePool (TEST_LARGE_SIZE);
+  UT_ASSERT_NOT_NULL (Plain);
+  UT_ASSERT_NOT_NULL (Output);
+  TestPlainFill (Plain, TEST_LARGE_SIZE);
+
+  Image = TestBuildStoredGzip (Plain, TEST_LARGE_SIZE, &ImageSize);
+  UT_ASSERT_NOT_NULL (Image);
+
+  ZeroMem (&ReadContext, sizeof (ReadContext));
+  ReadContext.Buffer    = Image;
+  ReadContext.Size      = ImageSize;
+  ReadContext.ReadCount = 0;
+
+  Status = ImageDecompressGetSize (ImageCompressionGzip, TestRead, &ReadContext, ImageSize, &Size);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Size, TEST_LARGE_SIZE);
+
+  ReadContext.ReadCount = 0;
+  Status                = ImageDecompress (ImageCompressionGzip, TestRead, &ReadContext, ImageSize, Output, TEST_LARGE_SIZE, &Stats);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Stats.DecompressedSize, TEST_LARGE_SIZE);
+  UT_ASSERT_EQUAL (Stats.ReadCount, ReadContext.ReadCount);
+  UT_ASSERT_EQUAL (Stats.ReadCount, (ImageSize + IMAGE_DECOMPRESS_CHUNK_SIZE - 1) / IMAGE_DECOMPRESS_CHUNK_SIZE);
+  UT_ASSERT_MEM_EQUAL (Output, Plain, TEST_LARGE_SIZE);
+
+  // A bad CRC in the trailer is reported after the data is inflated
+  Image[ImageSize - 8] ^= 1;
+  Status                = ImageDecompress (ImageCompressionGzip, TestRead, &ReadContext, ImageSize, Output, TEST_LARGE_SIZE, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_CRC_ERROR);
+
+  FreePool (Image);
+  FreePool (Output);
+  FreePool (Plain);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Stored gzip image larger than several read chunks, read ahead while the
+  previous chunk is decoded.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DecompressReadAhead (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST IMAGE_DECOMPRESS_READER  Reader = { TestRead, TestReadStart, TestReadWait };
+  TEST_READ_CONTEXT                     ReadContext;
+  IMAGE_DECOMPRESS_STATS                Stats;
+  UINT8                                 *Plain;
+  UINT8                                 *Image;
+  UINT8                                 *Output;
+  UINTN                                 ImageSize;
+  UINTN                                 ChunkCount;
+  EFI_STATUS                            Status;
+
+  Plain  = AllocatePool (TEST_LARGE_SIZE);
+  Output = AllocatePool (TEST_LARGE_SIZE);
+  UT_ASSERT_NOT_NULL (Plain);
+  UT_ASSERT_NOT_NULL (Output);
+  TestPlainFill (Plain, TEST_LARGE_SIZE);
+
+  Image = TestBuildStoredGzip (Plain, TEST_LARGE_SIZE, &ImageSize);
+  UT_ASSERT_NOT_NULL (Image);
+  ChunkCount = (ImageSize + IMAGE_DECOMPRESS_CHUNK_SIZE - 1) / IMAGE_DECOMPRESS_CHUNK_SIZE;
+
+  // only the first chunk is read without overlap
+  ZeroMem (&ReadContext, sizeof (ReadContext));
+  ReadContext.Buffer = Image;
+  ReadContext.Size   = ImageSize;
+  Status             = ImageDecompressEx (ImageCompressionGzip, &Reader, &ReadContext, ImageSize, Output, TEST_LARGE_SIZE, &Stats);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Stats.DecompressedSize, TEST_LARGE_SIZE);
+  UT_ASSERT_EQUAL (Stats.ReadCount, ChunkCount);
+  UT_ASSERT_EQUAL (Stats.ReadAheadCount, ChunkCount - 1);
+  UT_ASSERT_EQUAL (ReadContext.ReadAheadCount, ChunkCount - 1);
+  UT_ASSERT_EQUAL (ReadContext.OrderErrors, 0);
+  UT_ASSERT_TRUE (ReadContext.PendingBuffer == NULL);
+  UT_ASSERT_MEM_EQUAL (Output, Plain, TEST_LARGE_SIZE);
+
+  // a decode that stops early completes the read ahead before returning
+  ZeroMem (&ReadContext, sizeof (ReadContext));
+  ReadContext.Buffer = Image;
+  ReadContext.Size   = ImageSize;
+  Status             = ImageDecompressEx (ImageCompressionGzip, &Reader, &ReadContext, ImageSize, Output, IMAGE_DECOMPRESS_CHUNK_SIZE / 2, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (ReadContext.OrderErrors, 0);
+  UT_ASSERT_TRUE (ReadContext.PendingBuffer == NULL);
+
+  FreePool (Image);
+  FreePool (Output);
+  FreePool (Plain);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unrecognized images and invalid parameters.
+
+  @param[in]  Context   Unused
+
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DecompressInvalid (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8              Plain[TEST_PLAIN_SIZE];
+  TEST_READ_CONTEXT  ReadContext;
+  UINT64             Size;
+
+  TestPlainFill (Plain, sizeof (Plain));
+  ZeroMem (&ReadContext, sizeof (ReadContext));
+  ReadContext.Buffer = Plain;
+  ReadContext.Size   = sizeof (Plain);
+
+  UT_ASSERT_EQUAL (ImageDecompressGetType (Plain, sizeof (Plain)), ImageCompressionNone);
+  UT_ASSERT_EQUAL (ImageDecompressGetType (mGzipDynamic, 1), ImageCompressionNone);
+  UT_ASSERT_EQUAL (ImageDecompressGetType (NULL, 0), ImageCompressionNone);
+
+  UT_ASSERT_STATUS_EQUAL (ImageDecompressGetSize (ImageCompressionNone, TestRead, &ReadContext, sizeof (Plain), &Size), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (ImageDecompressGetSize (ImageCompressionGzip, NULL, &ReadContext, sizeof (Plain), &Size), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ImageDecompress (ImageCompressionNone, TestRead, &ReadContext, sizeof (Plain), Plain, sizeof (Plain), NULL), EFI_UNSUPPORTED);
+  UT_ASSERT_STATUS_EQUAL (ImageDecompress (ImageCompressionLz4, TestRead, &ReadContext, sizeof (Plain), NULL, sizeof (Plain), NULL), EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the image
+  decompress library and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      DecompressTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&DecompressTests, Framework, "Image Decompress Tests", "UnitTest.ImageDecompress", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Image Decompress Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    return Status;
+  }
+
+  AddTestCase (DecompressTests, "Gzip with dynamic Huffman blocks", "GzipDynamic", DecompressVector, NULL, NULL, &mGzipDynamicVector);
+  AddTestCase (DecompressTests, "Gzip with fixed Huffman blocks and file name", "GzipFixedName", DecompressVector, NULL, NULL, &mGzipFixedNameVector);
+  AddTestCase (DecompressTests, "Gzip stored blocks across read chunks", "GzipMultiChunk", DecompressMultiChunk, NULL, NULL, NULL);
+  AddTestCase (DecompressTests, "Gzip read chunks overlapped with decode", "GzipReadAhead", DecompressReadAhead, NULL, NULL, NULL);
+  AddTestCase (DecompressTests, "LZ4 frame with content size", "Lz4Frame", DecompressVector, NULL, NULL, &mLz4FrameVector);
+  AddTestCase (DecompressTests, "LZ4 frame without content size", "Lz4FrameNoSize", DecompressVector, NULL, NULL, &mLz4FrameNoSizeVector);
+  AddTestCase (DecompressTests, "LZ4 legacy with size trailer", "Lz4Legacy", DecompressVector, NULL, NULL, &mLz4LegacyVector);
+  AddTestCase (DecompressTests, "Corrupted gzip", "GzipCorrupted", DecompressCorrupted, NULL, NULL, &mGzipDynamicVector);
+  AddTestCase (DecompressTests, "Corrupted LZ4 frame", "Lz4Corrupted", DecompressCorrupted, NULL, NULL, &mLz4FrameVector);
+  AddTestCase (DecompressTests, "Corrupted LZ4 legacy", "Lz4LegacyCorrupted", DecompressCorrupted, NULL, NULL, &mLz4LegacyVector);
+  AddTestCase (DecompressTests, "Unrecognized images and invalid parameters", "Invalid", DecompressInvalid, NULL, NULL, NULL);
+
+  // Execute the tests.
+  Status = RunAllTestSuites (Framework);
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
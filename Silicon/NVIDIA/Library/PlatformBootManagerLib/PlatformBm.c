@@ -19,6 +19,7 @@
 #include <Library/DxeServicesTableLib.h>
 #include <Library/HobLib.h>
 #include <Library/PcdLib.h>
+#include <Library/PerformanceLib.h>
 #include <Library/UefiBootManagerLib.h>
 #include <Library/UefiLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
@@ -199,6 +200,11 @@ FilterAndProcess (
   Perform the memory test base on the memory test intensive level,
   and update the memory resource.
 
+  The generic memory test protocol is only used to find out whether there is
+  untested memory and whether it needs ECC initialization, the memory itself
+  is tested in parallel by PlatformMemoryTest, which calls Finished and then
+  withholds the chunks that failed as reserved memory.
+
   @param  Level         The memory test intensive level.
 
   @retval EFI_STATUS    Success test all the system memory and update
@@ -213,15 +219,7 @@ MemoryTest (
   EFI_STATUS                        Status;
   BOOLEAN                           RequireSoftECCInit;
   EFI_GENERIC_MEMORY_TEST_PROTOCOL  *GenMemoryTest;
-  UINT64                            TestedMemorySize;
-  UINT64                            TotalMemorySize;
-  BOOLEAN                           ErrorOut;
-  BOOLEAN                           TestAbort;
-
-  TestedMemorySize = 0;
-  TotalMemorySize  = 0;
-  ErrorOut         = FALSE;
-  TestAbort        = FALSE;
+  PLATFORM_MEMORY_TEST_MODE         Mode;
 
   RequireSoftECCInit = FALSE;
 
@@ -231,39 +229,47 @@ MemoryTest (
                   (VOID **)&GenMemoryTest
                   );
   if (EFI_ERROR (Status)) {
-    return EFI_SUCCESS;
+    GenMemoryTest = NULL;
+  } else {
+    Status = GenMemoryTest->MemoryTestInit (
+                              GenMemoryTest,
+                              Level,
+                              &RequireSoftECCInit
+                              );
+    if (Status == EFI_NO_MEDIA) {
+      //
+      // The PEI codes also have the relevant memory test code to check the memory,
+      // it can select to test some range of the memory or all of them. If PEI code
+      // checks all the memory, this BDS memory test will has no not-test memory to
+      // do the test, and then the status of EFI_NO_MEDIA will be returned by
+      // "MemoryTestInit". So it does not need to test memory again, just return.
+      //
+      GenMemoryTest->Finished (GenMemoryTest);
+      return EFI_SUCCESS;
+    }
   }
 
-  Status = GenMemoryTest->MemoryTestInit (
-                            GenMemoryTest,
-                            Level,
-                            &RequireSoftECCInit
-                            );
-  if (Status == EFI_NO_MEDIA) {
-    //
-    // The PEI codes also have the relevant memory test code to check the memory,
-    // it can select to test some range of the memory or all of them. If PEI code
-    // checks all the memory, this BDS memory test will has no not-test memory to
-    // do the test, and then the status of EFI_NO_MEDIA will be returned by
-    // "MemoryTestInit". So it does not need to test memory again, just return.
-    //
+  // memory needing ECC initialization is scrubbed in full instead of tested
+  if (RequireSoftECCInit) {
+    Mode = PlatformMemoryTestScrub;
+  } else if (Level == QUICK) {
+    Mode = PlatformMemoryTestQuick;
+  } else if (Level == SPARSE) {
+    Mode = PlatformMemoryTestSparse;
+  } else if (Level == EXTENSIVE) {
+    Mode = PlatformMemoryTestExtensive;
+  } else {
+    if (GenMemoryTest != NULL) {
+      GenMemoryTest->Finished (GenMemoryTest);
+    }
+
     return EFI_SUCCESS;
   }
 
-  do {
-    Status = GenMemoryTest->PerformMemoryTest (
-                              GenMemoryTest,
-                              &TestedMemorySize,
-                              &TotalMemorySize,
-                              &ErrorOut,
-                              TestAbort
-                              );
-    if (ErrorOut && (Status == EFI_DEVICE_ERROR)) {
-      ASSERT (0);
-    }
-  } while (Status != EFI_NOT_FOUND);
-
-  Status = GenMemoryTest->Finished (GenMemoryTest);
+  Status = PlatformMemoryTest (Mode, GenMemoryTest);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: memory test failed: %r\n", __FUNCTION__, Status));
+  }
 
   return EFI_SUCCESS;
 }
@@ -1408,7 +1414,9 @@ PlatformBootManagerBeforeConsole (
   //
   // Check IPMI for BootOrder commands, and clear and reset CMOS here if requested
   //
+  PERF_INMODULE_BEGIN ("BM IpmiBootOrder");
   CheckIPMIForBootOrderUpdates ();
+  PERF_INMODULE_END ("BM IpmiBootOrder");
 
   //
   // Restore the BootOrder if we temporarily changed it during the previous boot and haven't restored it yet
@@ -1418,28 +1426,36 @@ PlatformBootManagerBeforeConsole (
   //
   // Signal EndOfDxe PI Event
   //
+  PERF_INMODULE_BEGIN ("BM EndOfDxe");
   EfiEventGroupSignal (&gEfiEndOfDxeEventGroupGuid);
+  PERF_INMODULE_END ("BM EndOfDxe");
 
   //
   // Dispatch deferred images after EndOfDxe event.
   // Call customized version of EfiBootManagerDispatchDeferredImages to bypass
   // pre-specified PCI option ROMs.
   //
+  PERF_INMODULE_BEGIN ("BM DeferredImages");
   VerifyAndDispatchDeferredImages ();
+  PERF_INMODULE_END ("BM DeferredImages");
 
   //
   // Locate the PCI root bridges and make the PCI bus driver connect each,
   // non-recursively. This will produce a number of child handles with PciIo on
   // them.
   //
+  PERF_INMODULE_BEGIN ("BM PciConnect");
   FilterAndProcess (&gEfiPciRootBridgeIoProtocolGuid, NULL, Connect);
+  PERF_INMODULE_END ("BM PciConnect");
 
   //
   // Find all display class PCI devices (using the handles from the previous
   // step), and connect them non-recursively. This should produce a number of
   // child handles with GOPs on them.
   //
+  PERF_INMODULE_BEGIN ("BM PciDisplay");
   FilterAndProcess (&gEfiPciIoProtocolGuid, IsPciDisplay, Connect);
+  PERF_INMODULE_END ("BM PciDisplay");
 
   //
   // Now add the device path of all handles with GOP on them to ConOut and
@@ -1457,12 +1473,16 @@ PlatformBootManagerBeforeConsole (
     //
     // Connect the rest of the devices.
     //
+    PERF_INMODULE_BEGIN ("BM ConnectAll");
     EfiBootManagerConnectAll ();
+    PERF_INMODULE_END ("BM ConnectAll");
 
     //
     // Enumerate all possible boot options.
     //
+    PERF_INMODULE_BEGIN ("BM RefreshBootOptions");
     EfiBootManagerRefreshAllBootOption ();
+    PERF_INMODULE_END ("BM RefreshBootOptions");
 
     //
     // Register platform-specific boot options and keyboard shortcuts.
@@ -1526,7 +1546,9 @@ PlatformBootManagerBeforeConsole (
   //
   // Process IPMI-directed BootOrder updates
   //
+  PERF_INMODULE_BEGIN ("BM IpmiBootOrderUpdate");
   ProcessIPMIBootOrderUpdates ();
+  PERF_INMODULE_END ("BM IpmiBootOrderUpdate");
 
   //
   // Add the hardcoded short-form USB keyboard device path to ConIn.
@@ -1540,12 +1562,16 @@ PlatformBootManagerBeforeConsole (
   //
   // Register all available consoles.
   //
+  PERF_INMODULE_BEGIN ("BM RegisterConsoles");
   PlatformRegisterConsoles ();
+  PERF_INMODULE_END ("BM RegisterConsoles");
 
   //
   // Signal BeforeConsoleEvent.
   //
+  PERF_INMODULE_BEGIN ("BM BeforeConsoleEvent");
   EfiEventGroupSignal (&gNVIDIABeforeConsoleEventGuid);
+  PERF_INMODULE_END ("BM BeforeConsoleEvent");
 
   // Install protocol to indicate that devices are connected
   gBS->InstallMultipleProtocolInterfaces (
@@ -1554,7 +1580,9 @@ PlatformBootManagerBeforeConsole (
          NULL,
          NULL
          );
+  PERF_INMODULE_BEGIN ("BM Dispatch");
   gDS->Dispatch ();
+  PERF_INMODULE_END ("BM Dispatch");
 }
 
 STATIC
@@ -1884,10 +1912,14 @@ PlatformBootManagerAfterConsole (
   //
   // Run Sparse memory test
   //
+  PERF_INMODULE_BEGIN ("BM MemoryTest");
   MemoryTest (SPARSE);
+  PERF_INMODULE_END ("BM MemoryTest");
 
   // Ipmi communication
+  PERF_INMODULE_BEGIN ("BM BmcIpAddresses");
   PrintBmcIpAddresses ();
+  PERF_INMODULE_END ("BM BmcIpAddresses");
 
   //
   // On ARM, there is currently no reason to use the phased capsule
@@ -1896,7 +1928,9 @@ PlatformBootManagerAfterConsole (
   // when the console is up and we can actually give the user some
   // feedback about what is going on.
   //
+  PERF_INMODULE_BEGIN ("BM Capsules");
   HandleCapsules ();
+  PERF_INMODULE_END ("BM Capsules");
 
   HandleBootChainUpdate ();
 
@@ -1,7 +1,7 @@
 /** @file
   Head file for BDS Platform specific code
 
-  Copyright (c) 2020-2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2020-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
   Copyright (C) 2015-2016, Red Hat, Inc.
   Copyright (c) 2004 - 2008, Intel Corporation. All rights reserved.<BR>
   Copyright (c) 2016, Linaro Ltd. All rights reserved.<BR>
@@ -21,6 +21,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
+#include <Protocol/GenericMemoryTest.h>
 
 #define UEFI_VERSION_STRING_SIZE  100
 
@@ -31,6 +32,13 @@ typedef enum {
   OS_USE_ACPI
 } OS_HARDWARE_DESCRIPTION;
 
+typedef enum {
+  PlatformMemoryTestScrub,
+  PlatformMemoryTestQuick,
+  PlatformMemoryTestSparse,
+  PlatformMemoryTestExtensive
+} PLATFORM_MEMORY_TEST_MODE;
+
 typedef struct {
   UINT8                      DtbHash[SHA256_DIGEST_SIZE];
   CHAR8                      UEFIVersion[UEFI_VERSION_STRING_SIZE];
@@ -77,4 +85,24 @@ BmGetBootDescription (
   IN EFI_HANDLE  Handle
   );
 
+/**
+  Test or scrub all untested system memory, splitting it across all enabled
+  CPUs when MP services are available.  All untested memory is added to the
+  GCD as tested system memory, through GenMemoryTest->Finished when it is
+  given, and chunks with errors are reported and withheld as reserved.
+
+  @param[in]  Mode            Memory test mode, PlatformMemoryTestScrub only
+                              zeroes memory and reads it back to initialize ECC
+  @param[in]  GenMemoryTest   Generic memory test protocol, or NULL
+
+  @retval EFI_SUCCESS         All untested memory passed
+  @retval EFI_DEVICE_ERROR    Errors were found in some chunks
+  @retval Others              Memory test could not run
+**/
+EFI_STATUS
+PlatformMemoryTest (
+  IN PLATFORM_MEMORY_TEST_MODE         Mode,
+  IN EFI_GENERIC_MEMORY_TEST_PROTOCOL  *GenMemoryTest OPTIONAL
+  );
+
 #endif // _PLATFORM_BM_H_
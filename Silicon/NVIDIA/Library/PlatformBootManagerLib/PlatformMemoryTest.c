@@ -0,0 +1,541 @@
+/** @file
+  Parallel memory test and ECC scrub for untested system memory.
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/DxeServicesTableLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/TimerLib.h>
+#include <Protocol/MpService.h>
+#include "PlatformBm.h"
+
+#define PLATFORM_MEMORY_TEST_CHUNK_SIZE     SIZE_256MB
+#define PLATFORM_MEMORY_TEST_BLOCK_SIZE     SIZE_4KB
+#define PLATFORM_MEMORY_TEST_QUICK_STRIDE   SIZE_1MB
+#define PLATFORM_MEMORY_TEST_SPARSE_STRIDE  SIZE_64KB
+#define PLATFORM_MEMORY_TEST_PATTERN        0x5A5AA5A5C3C33C3CULL
+#define PLATFORM_MEMORY_TEST_PATTERN_PASSES 2
+#define PLATFORM_MEMORY_TEST_POLL_INTERVAL  10000
+#define PLATFORM_MEMORY_TEST_CAPABILITIES   (EFI_MEMORY_PRESENT | EFI_MEMORY_INITIALIZED | EFI_MEMORY_TESTED)
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    BaseAddress;
+  UINT64                  Length;
+  UINT64                  Capabilities;
+} PLATFORM_MEMORY_TEST_RANGE;
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    BaseAddress;
+  UINT64                  Length;
+  UINT64                  Capabilities;
+
+  // written by the CPU that tested the chunk
+  EFI_PHYSICAL_ADDRESS    ErrorAddress;
+  UINT64                  ErrorCount;
+} PLATFORM_MEMORY_TEST_CHUNK;
+
+typedef struct {
+  PLATFORM_MEMORY_TEST_MODE     Mode;
+  UINT64                        Stride;
+  UINTN                         PassCount;
+  CONST UINT64                  *Reference[PLATFORM_MEMORY_TEST_PATTERN_PASSES];
+
+  PLATFORM_MEMORY_TEST_CHUNK    *Chunks;
+  UINT32                        ChunkCount;
+  volatile UINT32               NextChunk;
+  volatile UINT32               DoneChunks;
+} PLATFORM_MEMORY_TEST_CONTEXT;
+
+/**
+  Find the untested memory ranges in the GCD memory space map.
+
+  @param[out] Ranges        Allocated array of untested ranges
+  @param[out] RangeCount    Number of ranges in Ranges
+
+  @retval EFI_SUCCESS       Ranges found, RangeCount may be zero
+  @retval Others            Failed to get the memory space map
+**/
+STATIC
+EFI_STATUS
+PlatformMemoryTestGetRanges (
+  OUT PLATFORM_MEMORY_TEST_RANGE  **Ranges,
+  OUT UINTN                       *RangeCount
+  )
+{
+  EFI_STATUS                       Status;
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR  *MemorySpaceMap;
+  UINTN                            NumberOfDescriptors;
+  UINTN                            Index;
+
+  *Ranges     = NULL;
+  *RangeCount = 0;
+
+  Status = gDS->GetMemorySpaceMap (&NumberOfDescriptors, &MemorySpaceMap);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  *Ranges = AllocatePool (NumberOfDescriptors * sizeof (PLATFORM_MEMORY_TEST_RANGE));
+  if (*Ranges == NULL) {
+    FreePool (MemorySpaceMap);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // untested memory is reserved until tested, as in GenericMemoryTestDxe
+  for (Index = 0; Index < NumberOfDescriptors; Index++) {
+    if ((MemorySpaceMap[Index].GcdMemoryType == EfiGcdMemoryTypeReserved) &&
+        ((MemorySpaceMap[Index].Capabilities & PLATFORM_MEMORY_TEST_CAPABILITIES) ==
+         (EFI_MEMORY_PRESENT | EFI_MEMORY_INITIALIZED)))
+    {
+      (*Ranges)[*RangeCount].BaseAddress  = MemorySpaceMap[Index].BaseAddress;
+      (*Ranges)[*RangeCount].Length       = MemorySpaceMap[Index].Length;
+      (*Ranges)[*RangeCount].Capabilities = MemorySpaceMap[Index].Capabilities;
+      (*RangeCount)++;
+    }
+  }
+
+  FreePool (MemorySpaceMap);
+  return EFI_SUCCESS;
+}
+
+/**
+  Test one chunk of memory.  Runs on any CPU, so it may only use library
+  functions that do not call boot services.
+
+  Scrub mode zeroes the whole chunk and reads it back, which initializes ECC.
+  The other modes write a pattern to a block every Stride bytes and read the
+  blocks back, then do the same with the complement of the pattern so every
+  tested bit is checked both set and clear.  The library copy, zero and
+  compare functions use wide loads and stores, and DC ZVA to zero memory on
+  AArch64.
+
+  @param[in]      Context   Memory test context
+  @param[in, out] Chunk     Chunk to test, error fields updated
+**/
+STATIC
+VOID
+PlatformMemoryTestChunk (
+  IN     PLATFORM_MEMORY_TEST_CONTEXT  *Context,
+  IN OUT PLATFORM_MEMORY_TEST_CHUNK    *Chunk
+  )
+{
+  UINT8         *Base;
+  UINT64        Offset;
+  UINT64        Stride;
+  UINTN         Pass;
+  UINTN         Word;
+  CONST UINT64  *Expected;
+  CONST UINT64  *Actual;
+
+  Base   = (UINT8 *)(UINTN)Chunk->BaseAddress;
+  Stride = Context->Stride;
+
+  for (Pass = 0; Pass < Context->PassCount; Pass++) {
+    Expected = Context->Reference[Pass];
+    if (Context->Mode == PlatformMemoryTestScrub) {
+      ZeroMem (Base, Chunk->Length);
+      WriteBackInvalidateDataCacheRange (Base, Chunk->Length);
+    } else {
+      for (Offset = 0; Offset + PLATFORM_MEMORY_TEST_BLOCK_SIZE <= Chunk->Length; Offset += Stride) {
+        CopyMem (Base + Offset, Expected, PLATFORM_MEMORY_TEST_BLOCK_SIZE);
+      }
+
+      // read back from memory, not from the cache
+      for (Offset = 0; Offset + PLATFORM_MEMORY_TEST_BLOCK_SIZE <= Chunk->Length; Offset += Stride) {
+        WriteBackInvalidateDataCacheRange (Base + Offset, PLATFORM_MEMORY_TEST_BLOCK_SIZE);
+      }
+    }
+
+    for (Offset = 0; Offset + PLATFORM_MEMORY_TEST_BLOCK_SIZE <= Chunk->Length; Offset += Stride) {
+      if (CompareMem (Base + Offset, Expected, PLATFORM_MEMORY_TEST_BLOCK_SIZE) == 0) {
+        continue;
+      }
+
+      Actual = (CONST UINT64 *)(Base + Offset);
+      for (Word = 0; Word < PLATFORM_MEMORY_TEST_BLOCK_SIZE / sizeof (UINT64); Word++) {
+        if (Actual[Word] != Expected[Word]) {
+          if (Chunk->ErrorCount == 0) {
+            Chunk->ErrorAddress = (EFI_PHYSICAL_ADDRESS)(UINTN)&Actual[Word];
+          }
+
+          Chunk->ErrorCount++;
+        }
+      }
+    }
+  }
+}
+
+/**
+  Test chunks until none are left.  Started on every AP, and run on the BSP.
+
+  @param[in]  Buffer    Memory test context
+**/
+STATIC
+VOID
+EFIAPI
+PlatformMemoryTestWorker (
+  IN VOID  *Buffer
+  )
+{
+  PLATFORM_MEMORY_TEST_CONTEXT  *Context;
+  UINT32                        Index;
+
+  Context = (PLATFORM_MEMORY_TEST_CONTEXT *)Buffer;
+  while (TRUE) {
+    Index = InterlockedIncrement (&Context->NextChunk) - 1;
+    if (Index >= Context->ChunkCount) {
+      break;
+    }
+
+    PlatformMemoryTestChunk (Context, &Context->Chunks[Index]);
+    InterlockedIncrement (&Context->DoneChunks);
+  }
+}
+
+/**
+  Report memory test progress in 10 percent steps.
+
+  @param[in]      Context       Memory test context
+  @param[in, out] LastPercent   Last percentage reported
+**/
+STATIC
+VOID
+PlatformMemoryTestProgress (
+  IN     PLATFORM_MEMORY_TEST_CONTEXT  *Context,
+  IN OUT UINTN                         *LastPercent
+  )
+{
+  UINTN  Percent;
+
+  Percent = ((UINTN)Context->DoneChunks * 100 / Context->ChunkCount) / 10 * 10;
+  if (Percent != *LastPercent) {
+    *LastPercent = Percent;
+    Print (L"Memory test: %u%%\r", Percent);
+  }
+}
+
+/**
+  Split the ranges into chunks that CPUs take from a shared queue.
+
+  @param[in]      Ranges        Untested ranges
+  @param[in]      RangeCount    Number of ranges
+  @param[in, out] Context       Memory test context, Chunks and ChunkCount set
+
+  @retval EFI_SUCCESS           Chunks allocated
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the chunks
+**/
+STATIC
+EFI_STATUS
+PlatformMemoryTestBuildChunks (
+  IN     CONST PLATFORM_MEMORY_TEST_RANGE  *Ranges,
+  IN     UINTN                             RangeCount,
+  IN OUT PLATFORM_MEMORY_TEST_CONTEXT      *Context
+  )
+{
+  UINTN   Index;
+  UINT64  Offset;
+  UINT64  ChunkCount;
+
+  ChunkCount = 0;
+  for (Index = 0; Index < RangeCount; Index++) {
+    ChunkCount += DivU64x32 (Ranges[Index].Length + PLATFORM_MEMORY_TEST_CHUNK_SIZE - 1, PLATFORM_MEMORY_TEST_CHUNK_SIZE);
+  }
+
+  if (ChunkCount > MAX_UINT32) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Context->Chunks = AllocateZeroPool ((UINTN)ChunkCount * sizeof (PLATFORM_MEMORY_TEST_CHUNK));
+  if (Context->Chunks == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Context->ChunkCount = 0;
+  for (Index = 0; Index < RangeCount; Index++) {
+    for (Offset = 0; Offset < Ranges[Index].Length; Offset += PLATFORM_MEMORY_TEST_CHUNK_SIZE) {
+      Context->Chunks[Context->ChunkCount].BaseAddress  = Ranges[Index].BaseAddress + Offset;
+      Context->Chunks[Context->ChunkCount].Length       = MIN (PLATFORM_MEMORY_TEST_CHUNK_SIZE, Ranges[Index].Length - Offset);
+      Context->Chunks[Context->ChunkCount].Capabilities = Ranges[Index].Capabilities;
+      Context->ChunkCount++;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Make the untested ranges available as tested system memory, the same way
+  the generic memory test protocol's Finished does.
+
+  @param[in]  Ranges        Untested ranges
+  @param[in]  RangeCount    Number of ranges
+**/
+STATIC
+VOID
+PlatformMemoryTestAddRanges (
+  IN CONST PLATFORM_MEMORY_TEST_RANGE  *Ranges,
+  IN UINTN                             RangeCount
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < RangeCount; Index++) {
+    if (EFI_ERROR (gDS->RemoveMemorySpace (Ranges[Index].BaseAddress, Ranges[Index].Length)) ||
+        EFI_ERROR (
+          gDS->AddMemorySpace (
+                 EfiGcdMemoryTypeSystemMemory,
+                 Ranges[Index].BaseAddress,
+                 Ranges[Index].Length,
+                 Ranges[Index].Capabilities & ~(PLATFORM_MEMORY_TEST_CAPABILITIES | EFI_MEMORY_RUNTIME)
+                 )
+          ))
+    {
+      DEBUG ((DEBUG_ERROR, "%a: failed to add tested memory at 0x%016lx\n", __FUNCTION__, Ranges[Index].BaseAddress));
+    }
+  }
+}
+
+/**
+  Take a chunk that failed the test back out of system memory and leave it
+  reserved.  Called right after the ranges were added, before anything can
+  allocate from them.
+
+  @param[in]  Chunk     Chunk that failed
+**/
+STATIC
+VOID
+PlatformMemoryTestWithholdChunk (
+  IN CONST PLATFORM_MEMORY_TEST_CHUNK  *Chunk
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = gDS->RemoveMemorySpace (Chunk->BaseAddress, Chunk->Length);
+  if (!EFI_ERROR (Status)) {
+    Status = gDS->AddMemorySpace (
+                    EfiGcdMemoryTypeReserved,
+                    Chunk->BaseAddress,
+                    Chunk->Length,
+                    Chunk->Capabilities
+                    );
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: failed to withhold 0x%016lx: %r\n", __FUNCTION__, Chunk->BaseAddress, Status));
+  }
+}
+
+/**
+  Test or scrub all untested system memory, splitting it across all enabled
+  CPUs when MP services are available.  All untested memory is then added to
+  the GCD as tested system memory, through GenMemoryTest->Finished when the
+  protocol is present, and the chunks with errors are reported and taken
+  back out as reserved memory.
+
+  @param[in]  Mode            Memory test mode
+  @param[in]  GenMemoryTest   Generic memory test protocol, or NULL
+
+  @retval EFI_SUCCESS         All untested memory passed
+  @retval EFI_DEVICE_ERROR    Errors were found in some chunks
+  @retval Others              Memory test could not run
+**/
+EFI_STATUS
+PlatformMemoryTest (
+  IN PLATFORM_MEMORY_TEST_MODE         Mode,
+  IN EFI_GENERIC_MEMORY_TEST_PROTOCOL  *GenMemoryTest OPTIONAL
+  )
+{
+  EFI_STATUS                    Status;
+  PLATFORM_MEMORY_TEST_RANGE    *Ranges;
+  UINTN                         RangeCount;
+  PLATFORM_MEMORY_TEST_CONTEXT  Context;
+  PLATFORM_MEMORY_TEST_CHUNK    *Chunk;
+  EFI_MP_SERVICES_PROTOCOL      *MpServices;
+  EFI_EVENT                     ApDoneEvent;
+  UINT64                        *Reference;
+  UINTN                         LastPercent;
+  UINTN                         Index;
+  UINTN                         Words;
+  UINT64                        TotalLength;
+  UINT64                        StartTime;
+
+  ZeroMem (&Context, sizeof (Context));
+  Reference   = NULL;
+  ApDoneEvent = NULL;
+
+  Status = PlatformMemoryTestGetRanges (&Ranges, &RangeCount);
+  if (EFI_ERROR (Status) || (RangeCount == 0)) {
+    goto Done;
+  }
+
+  Context.Mode = Mode;
+  switch (Mode) {
+    case PlatformMemoryTestQuick:
+      Context.Stride = PLATFORM_MEMORY_TEST_QUICK_STRIDE;
+      break;
+    case PlatformMemoryTestSparse:
+      Context.Stride = PLATFORM_MEMORY_TEST_SPARSE_STRIDE;
+      break;
+    default:
+      Context.Stride = PLATFORM_MEMORY_TEST_BLOCK_SIZE;
+      break;
+  }
+
+  Reference = AllocateZeroPool (PLATFORM_MEMORY_TEST_PATTERN_PASSES * PLATFORM_MEMORY_TEST_BLOCK_SIZE);
+  if (Reference == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  // neighbouring words get complementary values, and the second pass writes
+  // the complement of the first
+  Words = PLATFORM_MEMORY_TEST_BLOCK_SIZE / sizeof (UINT64);
+  if (Mode == PlatformMemoryTestScrub) {
+    Context.PassCount = 1;
+  } else {
+    Context.PassCount = PLATFORM_MEMORY_TEST_PATTERN_PASSES;
+    for (Index = 0; Index < Words; Index++) {
+      Reference[Index]         = ((Index & 1) == 0) ? PLATFORM_MEMORY_TEST_PATTERN : ~PLATFORM_MEMORY_TEST_PATTERN;
+      Reference[Words + Index] = ~Reference[Index];
+    }
+  }
+
+  for (Index = 0; Index < PLATFORM_MEMORY_TEST_PATTERN_PASSES; Index++) {
+    Context.Reference[Index] = &Reference[Index * Words];
+  }
+
+  Status = PlatformMemoryTestBuildChunks (Ranges, RangeCount, &Context);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  TotalLength = 0;
+  for (Index = 0; Index < RangeCount; Index++) {
+    TotalLength += Ranges[Index].Length;
+  }
+
+  StartTime = GetTimeInNanoSecond (GetPerformanceCounter ());
+
+  // the APs take chunks from the same queue while the BSP reports progress
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &ApDoneEvent);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = MpServices->StartupAllAPs (
+                           MpServices,
+                           PlatformMemoryTestWorker,
+                           FALSE,
+                           ApDoneEvent,
+                           0,
+                           &Context,
+                           NULL
+                           );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "%a: testing on BSP only: %r\n", __FUNCTION__, Status));
+      gBS->CloseEvent (ApDoneEvent);
+      ApDoneEvent = NULL;
+    }
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: mode %u, %lu MB in %u ranges, %u chunks\n",
+    __FUNCTION__,
+    Mode,
+    TotalLength / SIZE_1MB,
+    RangeCount,
+    Context.ChunkCount
+    ));
+
+  LastPercent = MAX_UINTN;
+  while (TRUE) {
+    Index = InterlockedIncrement (&Context.NextChunk) - 1;
+    if (Index >= Context.ChunkCount) {
+      break;
+    }
+
+    PlatformMemoryTestChunk (&Context, &Context.Chunks[Index]);
+    InterlockedIncrement (&Context.DoneChunks);
+    PlatformMemoryTestProgress (&Context, &LastPercent);
+  }
+
+  if (ApDoneEvent != NULL) {
+    while (gBS->CheckEvent (ApDoneEvent) == EFI_NOT_READY) {
+      PlatformMemoryTestProgress (&Context, &LastPercent);
+      gBS->Stall (PLATFORM_MEMORY_TEST_POLL_INTERVAL);
+    }
+
+    gBS->CloseEvent (ApDoneEvent);
+  }
+
+  PlatformMemoryTestProgress (&Context, &LastPercent);
+  Print (L"\n");
+
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: %lu MB done in %lu ms\n",
+    __FUNCTION__,
+    TotalLength / SIZE_1MB,
+    (GetTimeInNanoSecond (GetPerformanceCounter ()) - StartTime) / 1000000
+    ));
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < Context.ChunkCount; Index++) {
+    Chunk = &Context.Chunks[Index];
+    if (Chunk->ErrorCount != 0) {
+      DEBUG ((
+        DEBUG_ERROR,
+        "%a: %lu errors in 0x%016lx-0x%016lx, first at 0x%016lx\n",
+        __FUNCTION__,
+        Chunk->ErrorCount,
+        Chunk->BaseAddress,
+        Chunk->BaseAddress + Chunk->Length - 1,
+        Chunk->ErrorAddress
+        ));
+      Print (
+        L"Memory test: %lu errors in 0x%016lx-0x%016lx, first at 0x%016lx\n",
+        Chunk->ErrorCount,
+        Chunk->BaseAddress,
+        Chunk->BaseAddress + Chunk->Length - 1,
+        Chunk->ErrorAddress
+        );
+      Status = EFI_DEVICE_ERROR;
+    }
+  }
+
+Done:
+  // untested memory is added even if the test could not run, as the generic
+  // memory test does, and only the chunks that failed are withheld
+  if (GenMemoryTest != NULL) {
+    GenMemoryTest->Finished (GenMemoryTest);
+  } else {
+    PlatformMemoryTestAddRanges (Ranges, RangeCount);
+  }
+
+  if (Context.Chunks != NULL) {
+    for (Index = 0; Index < Context.ChunkCount; Index++) {
+      if (Context.Chunks[Index].ErrorCount != 0) {
+        PlatformMemoryTestWithholdChunk (&Context.Chunks[Index]);
+      }
+    }
+
+    FreePool (Context.Chunks);
+  }
+
+  if (Reference != NULL) {
+    FreePool (Reference);
+  }
+
+  if (Ranges != NULL) {
+    FreePool (Ranges);
+  }
+
+  return Status;
+}
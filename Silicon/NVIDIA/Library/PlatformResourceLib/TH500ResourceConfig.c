@@ -427,6 +427,14 @@ TH500GetResourceConfig (
     for (Index = 0; Index < MAX_RETIRED_DRAM_PAGES; Index++) {
       if (DramPageRetirementInfo[Index] == 0) {
         break;
+      }
+
+      // extend the previous region for runs of adjacent retired pages
+      if ((CarveoutRegionsCount > 0) &&
+          (CarveoutRegions[CarveoutRegionsCount - 1].MemoryBaseAddress +
+           CarveoutRegions[CarveoutRegionsCount - 1].MemoryLength == DramPageRetirementInfo[Index]))
+      {
+        CarveoutRegions[CarveoutRegionsCount - 1].MemoryLength += SIZE_64KB;
       } else {
         CarveoutRegions[CarveoutRegionsCount].MemoryBaseAddress = DramPageRetirementInfo[Index];
         CarveoutRegions[CarveoutRegionsCount].MemoryLength      = SIZE_64KB;
@@ -19,14 +19,20 @@
 #include <Library/TimerLib.h>
 #include <Protocol/MctpProtocol.h>
 
+// FD chooses its transfer size and window up to these maximums
+#define PLDM_FW_TASK_MAX_OUTSTANDING_TRANSFER_REQUESTS  4
+#define PLDM_FW_TASK_MAX_TRANSFER_SIZE                  (16 * 1024)
+
 #define PLDM_FW_TASK_REQUEST_SIZE      128
-#define PLDM_FW_TASK_RESPONSE_SIZE     (4 * 1024)
+#define PLDM_FW_TASK_RESPONSE_SIZE     (OFFSET_OF (PLDM_FW_REQUEST_FW_DATA_RESPONSE, ImageData) +\
+                                        PLDM_FW_TASK_MAX_TRANSFER_SIZE)
 #define PLDM_FW_TASK_RECV_BUFFER_SIZE  1024
 #define PLDM_FW_TASK_FW_PARAMS_SIZE    512
 #define PLDM_FW_TASK_MS_TO_NS(ms)  ((ms) * 1000 * 1000)
 
-#define PLDM_FW_TASK_MAX_OUTSTANDING_TRANSFER_REQUESTS  1
-#define PLDM_FW_TASK_MAX_TRANSFER_SIZE                  PLDM_FW_TASK_RESPONSE_SIZE
+// receive wait when no task can make progress, shared when multiple tasks active
+#define PLDM_FW_TASK_RECV_WAIT_MS_MAX     100
+#define PLDM_FW_TASK_RECV_WAIT_MS_SHARED  1
 
 typedef enum {
   // IDLE state
@@ -117,6 +123,8 @@ typedef struct {
   UINT8                                          RecvBuffer[PLDM_FW_TASK_RECV_BUFFER_SIZE];
   UINTN                                          RecvLength;
   UINT8                                          RecvMsgTag;
+  UINTN                                          RecvTimeoutMs;
+  BOOLEAN                                        IsIdle;
 
   UINT8                                          Request[PLDM_FW_TASK_REQUEST_SIZE];
   UINTN                                          RequestLength;
@@ -140,6 +148,15 @@ typedef struct {
   UINTN                                          UpdateComponentIndex;
   UINTN                                          LastFwDataRequested;
 
+  // FW data transfer tracking
+  UINT32                                         FwDataRecentEnds[PLDM_FW_TASK_MAX_OUTSTANDING_TRANSFER_REQUESTS];
+  UINTN                                          FwDataRecentIndex;
+  UINT32                                         FwDataMaxLength;
+  UINT64                                         FwDataStartNs;
+  UINT64                                         FwDataComponentBytes;
+  UINT64                                         FwDataBytes;
+  UINT64                                         FwDataNs;
+
   // FD info
   UINT8                                          GetFwParamsResponseBuffer[PLDM_FW_TASK_FW_PARAMS_SIZE];
   CONST PLDM_FW_GET_FW_PARAMS_RESPONSE           *GetFwParamsResponse;
@@ -303,6 +320,56 @@ PldmFwTaskTimerIsExpired (
          FALSE;
 }
 
+/**
+  Get milliseconds remaining until task timer expires.
+
+  @param[in]  Timer                     Timer to check.
+
+  @retval UINTN                         Milliseconds remaining, MAX_UINTN if
+                                        timer is not enabled.
+
+**/
+STATIC
+UINTN
+EFIAPI
+PldmFwTaskTimerRemainingMs (
+  IN  PLDM_FW_TASK_TIMER  *Timer
+  )
+{
+  UINT64  NowNs;
+
+  if (!Timer->Enabled) {
+    return MAX_UINTN;
+  }
+
+  NowNs = GetTimeInNanoSecond (GetPerformanceCounter ());
+  if (Timer->EndNs <= NowNs) {
+    return 0;
+  }
+
+  return (UINTN)((Timer->EndNs - NowNs + PLDM_FW_TASK_MS_TO_NS (1) - 1) / PLDM_FW_TASK_MS_TO_NS (1));
+}
+
+/**
+  Compute transfer throughput.
+
+  @param[in]  Bytes                     Number of bytes transferred.
+  @param[in]  Ns                        Nanoseconds taken by transfer.
+
+  @retval UINT64                        Throughput in KiB per second.
+
+**/
+STATIC
+UINT64
+EFIAPI
+PldmFwTaskKBPerSecond (
+  IN  UINT64  Bytes,
+  IN  UINT64  Ns
+  )
+{
+  return (Bytes * 1000 * 1000 * 1000) / MAX (Ns, 1) / 1024;
+}
+
 /**
   Set Firmware Device state.
 
@@ -1003,6 +1070,11 @@ PldmFwTaskUpdateComponentProcessRsp (
     ));
 
   PldmFwTaskSetFDState (Task, FDStateDownload);
+  Task->LastFwDataRequested  = 0;
+  Task->FwDataRecentIndex    = 0;
+  Task->FwDataComponentBytes = 0;
+  Task->FwDataStartNs        = GetTimeInNanoSecond (GetPerformanceCounter ());
+  ZeroMem (Task->FwDataRecentEnds, sizeof (Task->FwDataRecentEnds));
   PldmFwTaskStartTimer (
     &Task->RequestFwDataTimer,
     (Response->TimeBeforeRequestFwData > 0) ?
@@ -1053,17 +1125,28 @@ PldmFwTaskRequestFwDataHandleReq (
   CONST PLDM_FW_PKG_COMPONENT_IMAGE_INFO  *ImageInfo;
   UINTN                                   Offset;
   UINT32                                  Length;
+  UINT32                                  End;
+  UINTN                                   Index;
   UINT8                                   CompletionCode;
   EFI_STATUS                              Status;
 
   Request = (PLDM_FW_REQUEST_FW_DATA_REQUEST *)Task->RecvBuffer;
 
+  // with multiple outstanding requests the FD may request windows out of
+  // order, only a repeat of a recently served window is a retry
   DEBUG ((DEBUG_VERBOSE, "%a: off=0x%x len=0x%x\n", __FUNCTION__, Request->Offset, Request->Length));
-  if (Request->Offset + Request->Length <= Task->LastFwDataRequested) {
-    DEBUG ((DEBUG_WARN, "%a: WARNING offset=0x%x length=0x%x retried last=0x%x\n", __FUNCTION__, Request->Offset, Request->Length, Task->LastFwDataRequested));
+  End = Request->Offset + Request->Length;
+  for (Index = 0; Index < PLDM_FW_TASK_MAX_OUTSTANDING_TRANSFER_REQUESTS; Index++) {
+    if ((End != 0) && (Task->FwDataRecentEnds[Index] == End)) {
+      DEBUG ((DEBUG_WARN, "%a: WARNING offset=0x%x length=0x%x retried last=0x%x\n", __FUNCTION__, Request->Offset, Request->Length, Task->LastFwDataRequested));
+      break;
+    }
   }
 
-  Task->LastFwDataRequested = Request->Offset + Request->Length;
+  Task->FwDataRecentEnds[Task->FwDataRecentIndex] = End;
+  Task->FwDataRecentIndex                         = (Task->FwDataRecentIndex + 1) % PLDM_FW_TASK_MAX_OUTSTANDING_TRANSFER_REQUESTS;
+
+  Task->LastFwDataRequested = MAX (Task->LastFwDataRequested, End);
   PldmFwTaskDataProgressCompute ();
 
   if (Task->FDState != FDStateDownload) {
@@ -1082,7 +1165,7 @@ PldmFwTaskRequestFwDataHandleReq (
   Length = Request->Length;
 
   ImageInfo = Task->ImageInfo;
-  if (Length > PLDM_FW_TASK_RESPONSE_SIZE) {
+  if (Length > PLDM_FW_TASK_MAX_TRANSFER_SIZE) {
     CompletionCode = PLDM_FW_INVALID_TRANSFER_LENGTH;
   } else if (Length + Offset > ImageInfo->Size + PLDM_FW_BASELINE_TRANSFER_SIZE) {
     CompletionCode = PLDM_FW_DATA_OUT_OF_RANGE;
@@ -1099,7 +1182,9 @@ SendResponse:
   Task->ResponseLength     = OFFSET_OF (PLDM_FW_REQUEST_FW_DATA_RESPONSE, ImageData);
   if (CompletionCode == PLDM_SUCCESS) {
     CopyMem (Response->ImageData, (CONST UINT8 *)Task->PkgHdr + Offset, Length);
-    Task->ResponseLength += Length;
+    Task->ResponseLength       += Length;
+    Task->FwDataComponentBytes += Length;
+    Task->FwDataMaxLength       = MAX (Task->FwDataMaxLength, Length);
   }
 
   Status = Task->FD->Send (
@@ -1136,6 +1221,7 @@ PldmFwTaskTransferCompleteHandleReq (
   PLDM_FW_TRANSFER_COMPLETE_REQUEST   *Request;
   PLDM_FW_TRANSFER_COMPLETE_RESPONSE  *Response;
   EFI_STATUS                          Status;
+  UINT64                              Ns;
 
   Response = (PLDM_FW_TRANSFER_COMPLETE_RESPONSE *)Task->Response;
   Request  = (PLDM_FW_TRANSFER_COMPLETE_REQUEST *)Task->RecvBuffer;
@@ -1169,6 +1255,20 @@ PldmFwTaskTransferCompleteHandleReq (
     return StateFatalError;
   }
 
+  Ns                = GetTimeInNanoSecond (GetPerformanceCounter ()) - Task->FwDataStartNs;
+  Task->FwDataBytes += Task->FwDataComponentBytes;
+  Task->FwDataNs    += Ns;
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: %s component %u: %llu bytes in %llums, %lluKB/s\n",
+    __FUNCTION__,
+    Task->DeviceName,
+    Task->ComponentImageIndex,
+    Task->FwDataComponentBytes,
+    Ns / PLDM_FW_TASK_MS_TO_NS (1),
+    PldmFwTaskKBPerSecond (Task->FwDataComponentBytes, Ns)
+    ));
+
   Task->LastFwDataRequested = Task->PkgLen;
   PldmFwTaskDataProgressCompute ();
   PldmFwTaskSetFDState (Task, FDStateVerify);
@@ -1450,7 +1550,7 @@ PldmFwTaskReceive (
   Task->RecvLength = PLDM_FW_TASK_RECV_BUFFER_SIZE;
   Status           = Task->FD->Recv (
                                  Task->FD,
-                                 0,
+                                 Task->RecvTimeoutMs,
                                  Task->RecvBuffer,
                                  &Task->RecvLength,
                                  &Task->RecvMsgTag
@@ -1468,6 +1568,7 @@ PldmFwTaskReceive (
       return StateRetryReq;
     }
 
+    Task->IsIdle = TRUE;
     return StateReceive;
   }
 
@@ -1833,6 +1934,51 @@ STATIC PLDM_FW_TASK_STATE_TABLE  mPldmFwTaskStateTable[] = {
 
 _Static_assert (sizeof (mPldmFwTaskStateTable) == StateMax * sizeof (mPldmFwTaskStateTable[0]), "bad table size");
 
+/**
+  Set receive timeouts of all active tasks for the next state machine pass.
+
+  When no task made progress in the last pass, each task waits in receive
+  for a message from its FD or until its next timer expires, rather than
+  polling.  With multiple tasks active the wait is kept short so that one
+  FD's messages do not wait behind another FD's receive.
+
+  @param[in]  Idle                      TRUE if no task made progress.
+
+  @retval None
+
+**/
+STATIC
+VOID
+EFIAPI
+PldmFwTaskSetRecvTimeouts (
+  IN  BOOLEAN  Idle
+  )
+{
+  PLDM_FW_UPDATE_TASK  *Task;
+  UINTN                Index;
+  UINTN                TimeoutMs;
+
+  for (Index = 0; Index < mNumTasks; Index++) {
+    Task = &mTasks[Index];
+    if (Task->Complete) {
+      continue;
+    }
+
+    if (!Idle) {
+      Task->RecvTimeoutMs = 0;
+      continue;
+    }
+
+    TimeoutMs = (mNumTasks - mNumTasksComplete == 1) ?
+                PLDM_FW_TASK_RECV_WAIT_MS_MAX :
+                PLDM_FW_TASK_RECV_WAIT_MS_SHARED;
+    TimeoutMs = MIN (TimeoutMs, PldmFwTaskTimerRemainingMs (&Task->RspTimer));
+    TimeoutMs = MIN (TimeoutMs, PldmFwTaskTimerRemainingMs (&Task->RequestFwDataTimer));
+
+    Task->RecvTimeoutMs = TimeoutMs;
+  }
+}
+
 /**
   Task state machine processing loop.
 
@@ -1850,8 +1996,11 @@ PldmFwTaskStateMachineLoop (
   UINTN                Index;
   PLDM_FW_TASK_STATE   State;
   UINT64               EndNs;
+  UINT64               Ns;
+  BOOLEAN              Idle;
 
   while (TRUE) {
+    Idle = TRUE;
     for (Index = 0; Index < mNumTasks; Index++) {
       Task = &mTasks[Index];
       if (Task->Complete) {
@@ -1862,18 +2011,31 @@ PldmFwTaskStateMachineLoop (
       ASSERT (State < StateMax);
 
       ASSERT (mPldmFwTaskStateTable[State].State == State);
+      Task->IsIdle    = FALSE;
       Task->TaskState = mPldmFwTaskStateTable[State].Func (Task);
+      Idle           &= Task->IsIdle;
       if (Task->Complete) {
         EndNs = GetTimeInNanoSecond (GetPerformanceCounter ());
+        Ns    = EndNs - Task->StartNs;
         DEBUG ((
           DEBUG_INFO,
           "%a: State machine %u %s complete %llums: %r\n",
           __FUNCTION__,
           Index,
           Task->DeviceName,
-          (EndNs - Task->StartNs) / PLDM_FW_TASK_MS_TO_NS (1),
+          Ns / PLDM_FW_TASK_MS_TO_NS (1),
           Task->Status
           ));
+        DEBUG ((
+          DEBUG_INFO,
+          "%a: %s transferred %llu bytes in %llums, %lluKB/s, max request %u\n",
+          __FUNCTION__,
+          Task->DeviceName,
+          Task->FwDataBytes,
+          Task->FwDataNs / PLDM_FW_TASK_MS_TO_NS (1),
+          PldmFwTaskKBPerSecond (Task->FwDataBytes, Task->FwDataNs),
+          Task->FwDataMaxLength
+          ));
 
         if (EFI_ERROR (Task->Status)) {
           mStatus = EFI_PROTOCOL_ERROR;
@@ -1888,6 +2050,8 @@ PldmFwTaskStateMachineLoop (
         }
       }
     }
+
+    PldmFwTaskSetRecvTimeouts (Idle);
   }
 }
 
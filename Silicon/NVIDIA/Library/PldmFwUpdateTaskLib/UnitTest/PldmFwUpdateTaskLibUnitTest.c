@@ -0,0 +1,848 @@
+/** @file
+
+  PLDM FW update task library unit test
+
+  Copyright (c) 2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PldmFwUpdateLib.h>
+#include <Library/PldmFwUpdatePkgLib.h>
+#include <Library/PldmFwUpdateTaskLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "PLDM FW Update Task Lib Test"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define FAKE_FD_QUEUE_SIZE     16
+#define FAKE_FD_MSG_SIZE       256
+#define FAKE_FD_IANA_ID        0x1647
+#define FAKE_FD_COMPONENT_ID   0x1
+#define FAKE_FD_MAX_WINDOW     8
+#define FAKE_FD_NS_PER_CALL    100
+#define FAKE_FD_MS_TO_NS(ms)   ((UINT64)(ms) * 1000 * 1000)
+#define FAKE_PKG_IMAGE_OFFSET  256
+
+//
+// Message queued by the fake FD for the update agent.
+//
+typedef struct {
+  UINT8     Data[FAKE_FD_MSG_SIZE];
+  UINTN     Length;
+  UINT8     MsgTag;
+  UINT64    ReadyNs;
+} FAKE_FD_MSG;
+
+//
+// Request FW data request outstanding at the fake FD.
+//
+typedef struct {
+  BOOLEAN    InUse;
+  UINT8      InstanceId;
+  UINT32     Offset;
+  UINT32     Length;
+} FAKE_FD_FW_DATA_REQ;
+
+//
+// Fake PLDM firmware device reached through the MCTP protocol.
+//
+typedef struct {
+  NVIDIA_MCTP_PROTOCOL    Protocol;
+  CONST CHAR16            *Name;
+
+  // capabilities and timing
+  UINT32                  MaxTransferSize;
+  UINTN                   MaxOutstanding;
+  UINT64                  LatencyNs;
+  UINT64                  NsPerByte;
+
+  // values negotiated with the update agent
+  UINT32                  TransferSize;
+  UINTN                   Window;
+
+  // component image download
+  CONST UINT8             *Image;
+  UINT32                  ImageSize;
+  UINT32                  NextOffset;
+  UINT32                  BytesVerified;
+  UINTN                   Outstanding;
+  UINTN                   MaxOutstandingSeen;
+  BOOLEAN                 DataError;
+  FAKE_FD_FW_DATA_REQ     Requests[FAKE_FD_MAX_WINDOW];
+  UINT8                   InstanceId;
+  UINT8                   MsgTag;
+  BOOLEAN                 Activated;
+
+  FAKE_FD_MSG             Queue[FAKE_FD_QUEUE_SIZE];
+  UINTN                   QueueHead;
+  UINTN                   QueueCount;
+
+  UINTN                   RecvCalls;
+  UINTN                   MessageCount;
+} FAKE_FD;
+
+STATIC UINT64  mNowNs;
+STATIC UINT8   *mPackage;
+STATIC UINTN   mPackageLength;
+STATIC UINTN   mCompletion;
+
+/**
+  Returns the simulated time, each call takes FAKE_FD_NS_PER_CALL.
+
+  @return The current value of the performance counter.
+**/
+UINT64
+EFIAPI
+__wrap_GetPerformanceCounter (
+  VOID
+  )
+{
+  mNowNs += FAKE_FD_NS_PER_CALL;
+  return mNowNs;
+}
+
+/**
+  Converts elapsed ticks of performance counter to time in nanoseconds.
+
+  @param  Ticks     The number of elapsed ticks of running performance counter.
+  @return The elapsed time in nanoseconds.
+**/
+UINT64
+EFIAPI
+__wrap_GetTimeInNanoSecond (
+  IN      UINT64  Ticks
+  )
+{
+  return Ticks;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeProgress (
+  IN UINTN  Completion
+  )
+{
+  mCompletion = Completion;
+  return EFI_SUCCESS;
+}
+
+/**
+  Queue a message from the fake FD to the update agent.
+
+  @param[in]  Fd            Fake FD.
+  @param[in]  Message       Message to queue.
+  @param[in]  Length        Message length.
+  @param[in]  MsgTag        MCTP message tag.
+
+**/
+STATIC
+VOID
+FakeFdQueue (
+  IN FAKE_FD     *Fd,
+  IN CONST VOID  *Message,
+  IN UINTN       Length,
+  IN UINT8       MsgTag
+  )
+{
+  FAKE_FD_MSG  *Msg;
+
+  assert_true (Fd->QueueCount < FAKE_FD_QUEUE_SIZE);
+  assert_true (Length <= FAKE_FD_MSG_SIZE);
+
+  Msg = &Fd->Queue[(Fd->QueueHead + Fd->QueueCount) % FAKE_FD_QUEUE_SIZE];
+  CopyMem (Msg->Data, Message, Length);
+  Msg->Length  = Length;
+  Msg->MsgTag  = MsgTag;
+  Msg->ReadyNs = mNowNs + Fd->LatencyNs;
+  Fd->QueueCount++;
+}
+
+/**
+  Queue a request from the fake FD to the update agent.
+
+  @param[in]  Fd            Fake FD.
+  @param[in]  Request       Request, header filled here.
+  @param[in]  Length        Request length.
+  @param[in]  Command       PLDM FW command.
+
+**/
+STATIC
+VOID
+FakeFdQueueRequest (
+  IN FAKE_FD  *Fd,
+  IN VOID     *Request,
+  IN UINTN    Length,
+  IN UINT8    Command
+  )
+{
+  PldmFwFillCommon ((MCTP_PLDM_COMMON *)Request, TRUE, ++Fd->InstanceId, Command);
+  FakeFdQueue (Fd, Request, Length, Fd->MsgTag++ & 0x7);
+}
+
+/**
+  Issue request FW data requests up to the negotiated window, or transfer
+  complete once the whole image has been received.
+
+  @param[in]  Fd            Fake FD.
+
+**/
+STATIC
+VOID
+FakeFdRequestData (
+  IN FAKE_FD  *Fd
+  )
+{
+  PLDM_FW_REQUEST_FW_DATA_REQUEST    Request;
+  PLDM_FW_TRANSFER_COMPLETE_REQUEST  Complete;
+  UINTN                              Index;
+
+  while ((Fd->Outstanding < Fd->Window) && (Fd->NextOffset < Fd->ImageSize)) {
+    for (Index = 0; Fd->Requests[Index].InUse; Index++) {
+    }
+
+    Request.Offset = Fd->NextOffset;
+    Request.Length = MIN (Fd->TransferSize, Fd->ImageSize - Fd->NextOffset);
+    FakeFdQueueRequest (Fd, &Request, sizeof (Request), PLDM_FW_REQUEST_FW_DATA);
+
+    Fd->Requests[Index].InUse      = TRUE;
+    Fd->Requests[Index].InstanceId = Request.Common.InstanceId & PLDM_INSTANCE_ID_MASK;
+    Fd->Requests[Index].Offset     = Request.Offset;
+    Fd->Requests[Index].Length     = Request.Length;
+
+    Fd->NextOffset        += Request.Length;
+    Fd->Outstanding       += 1;
+    Fd->MaxOutstandingSeen = MAX (Fd->MaxOutstandingSeen, Fd->Outstanding);
+  }
+
+  if ((Fd->Outstanding == 0) && (Fd->NextOffset == Fd->ImageSize)) {
+    Complete.TransferResult = (Fd->BytesVerified == Fd->ImageSize) ? 0 : 1;
+    FakeFdQueueRequest (Fd, &Complete, sizeof (Complete), PLDM_FW_TRANSFER_COMPLETE);
+    Fd->NextOffset++;
+  }
+}
+
+/**
+  Handle a request from the update agent.
+
+  @param[in]  Fd            Fake FD.
+  @param[in]  Request       Request message.
+  @param[in]  MsgTag        MCTP message tag.
+
+**/
+STATIC
+VOID
+FakeFdHandleRequest (
+  IN FAKE_FD       *Fd,
+  IN CONST UINT8   *Request,
+  IN UINT8         MsgTag
+  )
+{
+  UINT8                                    Buffer[FAKE_FD_MSG_SIZE];
+  CONST MCTP_PLDM_COMMON                   *Common;
+  MCTP_PLDM_RESPONSE_HEADER                *Response;
+  PLDM_FW_QUERY_DEVICE_IDS_RESPONSE        *QueryRsp;
+  PLDM_FW_DESCRIPTOR_IANA_ID               *Iana;
+  PLDM_FW_GET_FW_PARAMS_RESPONSE           *ParamsRsp;
+  PLDM_FW_COMPONENT_PARAMETER_TABLE_ENTRY  *Entry;
+  CONST PLDM_FW_REQUEST_UPDATE_REQUEST     *UpdateReq;
+  UINTN                                    Length;
+
+  ZeroMem (Buffer, sizeof (Buffer));
+  Common   = (CONST MCTP_PLDM_COMMON *)Request;
+  Response = (MCTP_PLDM_RESPONSE_HEADER *)Buffer;
+  PldmFwFillCommon (&Response->Common, FALSE, Common->InstanceId, Common->Command);
+  Response->CompletionCode = PLDM_SUCCESS;
+
+  switch (Common->Command) {
+    case PLDM_FW_QUERY_DEVICE_IDS:
+      QueryRsp         = (PLDM_FW_QUERY_DEVICE_IDS_RESPONSE *)Buffer;
+      QueryRsp->Length = sizeof (*Iana);
+      QueryRsp->Count  = 1;
+      Iana             = (PLDM_FW_DESCRIPTOR_IANA_ID *)QueryRsp->Descriptors;
+      Iana->Type       = PLDM_FW_DESCRIPTOR_TYPE_IANA_ENTERPRISE;
+      Iana->Length     = sizeof (Iana->Id);
+      Iana->Id         = FAKE_FD_IANA_ID;
+      Length           = OFFSET_OF (PLDM_FW_QUERY_DEVICE_IDS_RESPONSE, Descriptors) + sizeof (*Iana);
+      break;
+
+    case PLDM_FW_GET_FW_PARAMS:
+      ParamsRsp                 = (PLDM_FW_GET_FW_PARAMS_RESPONSE *)Buffer;
+      ParamsRsp->ComponentCount = 1;
+      Entry                     = (PLDM_FW_COMPONENT_PARAMETER_TABLE_ENTRY *)ParamsRsp->ImageSetActiveVersionString;
+      Entry->Classification     = PLDM_FW_COMPONENT_CLASS_FW;
+      Entry->Id                 = FAKE_FD_COMPONENT_ID;
+      Length                    = OFFSET_OF (PLDM_FW_GET_FW_PARAMS_RESPONSE, ImageSetActiveVersionString) +
+                                  OFFSET_OF (PLDM_FW_COMPONENT_PARAMETER_TABLE_ENTRY, ActiveVersionString);
+      break;
+
+    case PLDM_FW_REQUEST_UPDATE:
+      UpdateReq        = (CONST PLDM_FW_REQUEST_UPDATE_REQUEST *)Request;
+      Fd->TransferSize = MIN (Fd->MaxTransferSize, UpdateReq->MaxTransferSize);
+      Fd->Window       = MIN (Fd->MaxOutstanding, UpdateReq->MaxOutstandingTransferReqs);
+      Length           = sizeof (PLDM_FW_REQUEST_UPDATE_RESPONSE);
+      break;
+
+    case PLDM_FW_PASS_COMPONENT_TABLE:
+      Length = sizeof (PLDM_FW_PASS_COMPONENT_TABLE_RESPONSE);
+      break;
+
+    case PLDM_FW_UPDATE_COMPONENT:
+      Length = sizeof (PLDM_FW_UPDATE_COMPONENT_RESPONSE);
+      FakeFdQueue (Fd, Buffer, Length, MsgTag);
+      FakeFdRequestData (Fd);
+      return;
+
+    case PLDM_FW_ACTIVATE_FW:
+      Fd->Activated = TRUE;
+      Length        = sizeof (PLDM_FW_ACTIVATE_FW_RESPONSE);
+      break;
+
+    default:
+      Response->CompletionCode = PLDM_ERROR_UNSUPPORTED_PLDM_CMD;
+      Length                   = sizeof (*Response);
+      break;
+  }
+
+  FakeFdQueue (Fd, Buffer, Length, MsgTag);
+}
+
+/**
+  Handle a response from the update agent to a fake FD request.
+
+  @param[in]  Fd            Fake FD.
+  @param[in]  Message       Response message.
+  @param[in]  Length        Response length.
+
+**/
+STATIC
+VOID
+FakeFdHandleResponse (
+  IN FAKE_FD      *Fd,
+  IN CONST UINT8  *Message,
+  IN UINTN        Length
+  )
+{
+  CONST PLDM_FW_REQUEST_FW_DATA_RESPONSE  *DataRsp;
+  PLDM_FW_VERIFY_COMPLETE_REQUEST         Verify;
+  PLDM_FW_APPLY_COMPLETE_REQUEST          Apply;
+  FAKE_FD_FW_DATA_REQ                     *Req;
+  UINT8                                   InstanceId;
+  UINTN                                   Index;
+
+  DataRsp    = (CONST PLDM_FW_REQUEST_FW_DATA_RESPONSE *)Message;
+  InstanceId = DataRsp->Common.InstanceId & PLDM_INSTANCE_ID_MASK;
+
+  switch (DataRsp->Common.Command) {
+    case PLDM_FW_REQUEST_FW_DATA:
+      Req = NULL;
+      for (Index = 0; Index < FAKE_FD_MAX_WINDOW; Index++) {
+        if (Fd->Requests[Index].InUse && (Fd->Requests[Index].InstanceId == InstanceId)) {
+          Req = &Fd->Requests[Index];
+          break;
+        }
+      }
+
+      if ((Req == NULL) ||
+          (DataRsp->CompletionCode != PLDM_SUCCESS) ||
+          (Length != OFFSET_OF (PLDM_FW_REQUEST_FW_DATA_RESPONSE, ImageData) + Req->Length) ||
+          (CompareMem (DataRsp->ImageData, &Fd->Image[Req->Offset], Req->Length) != 0))
+      {
+        Fd->DataError = TRUE;
+      } else {
+        Fd->BytesVerified += Req->Length;
+      }
+
+      if (Req != NULL) {
+        Req->InUse = FALSE;
+        Fd->Outstanding--;
+      }
+
+      FakeFdRequestData (Fd);
+      break;
+
+    case PLDM_FW_TRANSFER_COMPLETE:
+      Verify.VerifyResult = 0;
+      FakeFdQueueRequest (Fd, &Verify, sizeof (Verify), PLDM_FW_VERIFY_COMPLETE);
+      break;
+
+    case PLDM_FW_VERIFY_COMPLETE:
+      Apply.ApplyResult                            = PLDM_FW_APPLY_RESULT_SUCCESS;
+      Apply.ComponentActivationMethodsModification = 0;
+      FakeFdQueueRequest (Fd, &Apply, sizeof (Apply), PLDM_FW_APPLY_COMPLETE);
+      break;
+
+    default:
+      break;
+  }
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeFdGetDeviceAttributes (
+  IN  NVIDIA_MCTP_PROTOCOL    *This,
+  OUT MCTP_DEVICE_ATTRIBUTES  *Attributes
+  )
+{
+  FAKE_FD  *Fd;
+
+  Fd = (FAKE_FD *)This;
+
+  Attributes->DeviceName = Fd->Name;
+  Attributes->DeviceType = 0;
+  Attributes->Socket     = 0;
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeFdSend (
+  IN  NVIDIA_MCTP_PROTOCOL  *This,
+  IN  BOOLEAN               IsRequest,
+  IN  CONST VOID            *Message,
+  IN  UINTN                 Length,
+  IN OUT UINT8              *MsgTag
+  )
+{
+  FAKE_FD  *Fd;
+
+  Fd                = (FAKE_FD *)This;
+  mNowNs           += Length * Fd->NsPerByte;
+  Fd->MessageCount += 1;
+
+  if (IsRequest) {
+    *MsgTag = Fd->MsgTag++ & 0x7;
+    FakeFdHandleRequest (Fd, Message, *MsgTag);
+  } else {
+    FakeFdHandleResponse (Fd, Message, Length);
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+FakeFdRecv (
+  IN  NVIDIA_MCTP_PROTOCOL  *This,
+  IN  UINTN                 TimeoutMs,
+  OUT VOID                  *Message,
+  IN OUT UINTN              *Length,
+  OUT UINT8                 *MsgTag
+  )
+{
+  FAKE_FD      *Fd;
+  FAKE_FD_MSG  *Msg;
+
+  Fd = (FAKE_FD *)This;
+  Fd->RecvCalls++;
+
+  // blocking receive returns when the message arrives or the timeout expires
+  Msg = &Fd->Queue[Fd->QueueHead];
+  if ((Fd->QueueCount == 0) || (Msg->ReadyNs > mNowNs + FAKE_FD_MS_TO_NS (TimeoutMs))) {
+    mNowNs += FAKE_FD_MS_TO_NS (TimeoutMs);
+    return EFI_TIMEOUT;
+  }
+
+  mNowNs = MAX (mNowNs, Msg->ReadyNs) + Msg->Length * Fd->NsPerByte;
+
+  assert_true (*Length >= Msg->Length);
+  CopyMem (Message, Msg->Data, Msg->Length);
+  *Length = Msg->Length;
+  *MsgTag = Msg->MsgTag;
+
+  Fd->QueueHead = (Fd->QueueHead + 1) % FAKE_FD_QUEUE_SIZE;
+  Fd->QueueCount--;
+  Fd->MessageCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Initialize a fake FD.
+
+  @param[out] Fd                Fake FD.
+  @param[in]  Name              Device name.
+  @param[in]  MaxTransferSize   Largest request FW data transfer FD uses.
+  @param[in]  MaxOutstanding    Most request FW data requests FD issues at once.
+  @param[in]  LatencyMs         FD latency to respond or issue a request.
+
+**/
+STATIC
+VOID
+FakeFdInit (
+  OUT FAKE_FD       *Fd,
+  IN  CONST CHAR16  *Name,
+  IN  UINT32        MaxTransferSize,
+  IN  UINTN         MaxOutstanding,
+  IN  UINTN         LatencyMs
+  )
+{
+  CONST PLDM_FW_PKG_COMPONENT_IMAGE_INFO  *ImageInfo;
+
+  ZeroMem (Fd, sizeof (*Fd));
+  Fd->Protocol.GetDeviceAttributes = FakeFdGetDeviceAttributes;
+  Fd->Protocol.Send                = FakeFdSend;
+  Fd->Protocol.Recv                = FakeFdRecv;
+  Fd->Name                         = Name;
+  Fd->MaxTransferSize              = MaxTransferSize;
+  Fd->MaxOutstanding               = MIN (MaxOutstanding, FAKE_FD_MAX_WINDOW);
+  Fd->LatencyNs                    = FAKE_FD_MS_TO_NS (LatencyMs);
+  Fd->NsPerByte                    = 80;
+
+  ImageInfo     = PldmFwPkgGetComponentImageInfoArea ((CONST PLDM_FW_PKG_HDR *)mPackage)->ImageInfo;
+  Fd->Image     = mPackage + ImageInfo->LocationOffset;
+  Fd->ImageSize = ImageInfo->Size;
+}
+
+/**
+  Build a single component PLDM package for the fake FD.
+
+  @param[in]  ImageSize         Size of the component image.
+
+**/
+STATIC
+VOID
+BuildPackage (
+  IN UINT32  ImageSize
+  )
+{
+  PLDM_FW_PKG_HDR                        *Hdr;
+  PLDM_FW_PKG_FW_DEVICE_ID_AREA          *DeviceIdArea;
+  PLDM_FW_PKG_DEVICE_ID_RECORD           *Record;
+  PLDM_FW_DESCRIPTOR_IANA_ID             *Iana;
+  PLDM_FW_PKG_COMPONENT_IMAGE_INFO_AREA  *ImageInfoArea;
+  PLDM_FW_PKG_COMPONENT_IMAGE_INFO       *ImageInfo;
+  CONST PLDM_UUID                        Uuid = PLDM_FW_PKG_UUID_V1_0;
+  UINT8                                  *Ptr;
+  UINTN                                  Index;
+
+  if (mPackage != NULL) {
+    FreePool (mPackage);
+  }
+
+  mPackageLength = FAKE_PKG_IMAGE_OFFSET + ImageSize;
+  mPackage       = AllocateZeroPool (mPackageLength);
+  assert_non_null (mPackage);
+
+  Hdr                           = (PLDM_FW_PKG_HDR *)mPackage;
+  Hdr->Identifier               = Uuid;
+  Hdr->FormatRevision           = PLDM_FW_PKG_FORMAT_REVISION_1;
+  Hdr->ComponentBitmapBitLength = 8;
+  Hdr->VersionStringType        = PLDM_FW_STRING_TYPE_ASCII;
+  Hdr->VersionStringLength      = 0;
+
+  DeviceIdArea                        = (PLDM_FW_PKG_FW_DEVICE_ID_AREA *)PldmFwPkgGetFwDeviceIdArea (Hdr);
+  DeviceIdArea->RecordCount           = 1;
+  Record                              = DeviceIdArea->Records;
+  Record->DescriptorCount             = 1;
+  Record->ImageSetVersionStringType   = PLDM_FW_STRING_TYPE_ASCII;
+  Record->ImageSetVersionStringLength = 0;
+  Record->ApplicableComponents[0]     = BIT0;
+  Iana                                = (PLDM_FW_DESCRIPTOR_IANA_ID *)PldmFwPkgGetFwDeviceIdRecordDescriptors (Hdr, Record);
+  Iana->Type                          = PLDM_FW_DESCRIPTOR_TYPE_IANA_ENTERPRISE;
+  Iana->Length                        = sizeof (Iana->Id);
+  Iana->Id                            = FAKE_FD_IANA_ID;
+  Record->Length                      = (UINT16)((UINT8 *)(Iana + 1) - (UINT8 *)Record);
+
+  ImageInfoArea                        = (PLDM_FW_PKG_COMPONENT_IMAGE_INFO_AREA *)PldmFwPkgGetComponentImageInfoArea (Hdr);
+  ImageInfoArea->ImageCount            = 1;
+  ImageInfo                            = ImageInfoArea->ImageInfo;
+  ImageInfo->Classification            = PLDM_FW_COMPONENT_CLASS_FW;
+  ImageInfo->Id                        = FAKE_FD_COMPONENT_ID;
+  ImageInfo->RequestedActivationMethod = PLDM_FW_ACTIVATION_SYSTEM_REBOOT;
+  ImageInfo->LocationOffset            = FAKE_PKG_IMAGE_OFFSET;
+  ImageInfo->Size                      = ImageSize;
+  ImageInfo->VersionStringType         = PLDM_FW_STRING_TYPE_ASCII;
+  ImageInfo->VersionStringLength       = 0;
+
+  Ptr       = (UINT8 *)PldmFwPkgGetNextComponentImage (ImageInfo) + sizeof (UINT32);
+  Hdr->Size = (UINT16)(Ptr - mPackage);
+  assert_true (Hdr->Size <= FAKE_PKG_IMAGE_OFFSET);
+
+  for (Index = 0; Index < ImageSize; Index++) {
+    mPackage[FAKE_PKG_IMAGE_OFFSET + Index] = (UINT8)(Index * 31 + (Index >> 8));
+  }
+}
+
+/**
+  Update a set of fake FDs.
+
+  @param[in]  Fds               Fake FDs.
+  @param[in]  Count             Number of fake FDs.
+
+  @retval EFI_STATUS            Status returned by the task library.
+
+**/
+STATIC
+EFI_STATUS
+UpdateFds (
+  IN FAKE_FD  *Fds,
+  IN UINTN    Count
+  )
+{
+  EFI_STATUS                 Status;
+  PLDM_FW_UPDATE_TASK_ERROR  Error;
+  UINT16                     ActivationMethod;
+  UINTN                      Index;
+
+  mNowNs      = 0;
+  mCompletion = 0;
+
+  Status = PldmFwUpdateTaskLibInit (Count, FakeProgress);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Status = PldmFwUpdateTaskCreate (&Fds[Index].Protocol, mPackage, mPackageLength);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Status = PldmFwUpdateTaskExecuteAll (&Error, &ActivationMethod);
+  if (!EFI_ERROR (Status) &&
+      ((Error != PLDM_FW_UPDATE_TASK_ERROR_NONE) || (ActivationMethod != PLDM_FW_ACTIVATION_SYSTEM_REBOOT)))
+  {
+    Status = EFI_PROTOCOL_ERROR;
+  }
+
+  return Status;
+}
+
+/**
+  Check a fake FD received its whole image and was activated.
+
+  @param[in]  Fd            Fake FD.
+
+  @retval UNIT_TEST_PASSED  FD updated.
+
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckFdUpdated (
+  IN FAKE_FD  *Fd
+  )
+{
+  UT_ASSERT_FALSE (Fd->DataError);
+  UT_ASSERT_EQUAL (Fd->BytesVerified, Fd->ImageSize);
+  UT_ASSERT_EQUAL (Fd->Outstanding, 0);
+  UT_ASSERT_TRUE (Fd->Activated);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verify the FD is offered and uses large transfers with multiple
+  outstanding requests.
+
+  @param[in]  Context       Unused.
+
+  @retval UNIT_TEST_PASSED  Test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+WindowedTransfer (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FAKE_FD  Fd;
+
+  BuildPackage (200 * 1024 + 123);
+  FakeFdInit (&Fd, L"FakeFd", 64 * 1024, FAKE_FD_MAX_WINDOW, 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (UpdateFds (&Fd, 1));
+  UT_ASSERT_EQUAL (CheckFdUpdated (&Fd), UNIT_TEST_PASSED);
+  UT_ASSERT_TRUE (Fd.TransferSize > 4 * 1024);
+  UT_ASSERT_TRUE (Fd.Window > 1);
+  UT_ASSERT_EQUAL (Fd.MaxOutstandingSeen, Fd.Window);
+  UT_ASSERT_EQUAL (mCompletion, 100);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verify an FD limited to single 4KB transfers is still updated, and compare
+  its transfer time with an FD using the full window.
+
+  @param[in]  Context       Unused.
+
+  @retval UNIT_TEST_PASSED  Test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+WindowedThroughput (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FAKE_FD  Fd;
+  UINT64   SingleNs;
+  UINT64   WindowedNs;
+
+  BuildPackage (512 * 1024);
+
+  FakeFdInit (&Fd, L"SingleFd", 4 * 1024, 1, 2);
+  UT_ASSERT_NOT_EFI_ERROR (UpdateFds (&Fd, 1));
+  UT_ASSERT_EQUAL (CheckFdUpdated (&Fd), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (Fd.TransferSize, 4 * 1024);
+  UT_ASSERT_EQUAL (Fd.MaxOutstandingSeen, 1);
+  SingleNs = mNowNs;
+
+  FakeFdInit (&Fd, L"WindowFd", 64 * 1024, FAKE_FD_MAX_WINDOW, 2);
+  UT_ASSERT_NOT_EFI_ERROR (UpdateFds (&Fd, 1));
+  UT_ASSERT_EQUAL (CheckFdUpdated (&Fd), UNIT_TEST_PASSED);
+  WindowedNs = mNowNs;
+
+  UT_LOG_INFO (
+    "512KB update: 4KB single request %llums, %uKB x %u window %llums\n",
+    SingleNs / FAKE_FD_MS_TO_NS (1),
+    Fd.TransferSize / 1024,
+    Fd.Window,
+    WindowedNs / FAKE_FD_MS_TO_NS (1)
+    );
+
+  UT_ASSERT_TRUE (WindowedNs * 2 < SingleNs);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verify the task waits in receive for a slow FD instead of polling.
+
+  @param[in]  Context       Unused.
+
+  @retval UNIT_TEST_PASSED  Test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IdleWait (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FAKE_FD  Fd;
+
+  BuildPackage (64 * 1024);
+  FakeFdInit (&Fd, L"SlowFd", 16 * 1024, 1, 50);
+
+  UT_ASSERT_NOT_EFI_ERROR (UpdateFds (&Fd, 1));
+  UT_ASSERT_EQUAL (CheckFdUpdated (&Fd), UNIT_TEST_PASSED);
+
+  UT_LOG_INFO ("%u messages, %u receive calls\n", Fd.MessageCount, Fd.RecvCalls);
+
+  // each message takes an immediate poll and at most one blocking receive
+  UT_ASSERT_TRUE (Fd.RecvCalls <= 2 * Fd.MessageCount);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verify several FDs with different capabilities are updated together.
+
+  @param[in]  Context       Unused.
+
+  @retval UNIT_TEST_PASSED  Test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MultipleDevices (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FAKE_FD  Fds[3];
+  UINTN    Index;
+
+  BuildPackage (96 * 1024 + 7);
+  FakeFdInit (&Fds[0], L"Fd0", 4 * 1024, 1, 1);
+  FakeFdInit (&Fds[1], L"Fd1", 64 * 1024, FAKE_FD_MAX_WINDOW, 5);
+  FakeFdInit (&Fds[2], L"Fd2", 1024, 2, 0);
+
+  UT_ASSERT_NOT_EFI_ERROR (UpdateFds (Fds, ARRAY_SIZE (Fds)));
+  for (Index = 0; Index < ARRAY_SIZE (Fds); Index++) {
+    UT_ASSERT_EQUAL (CheckFdUpdated (&Fds[Index]), UNIT_TEST_PASSED);
+  }
+
+  UT_ASSERT_EQUAL (mCompletion, 100);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  PLDM FW update task library and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+SetupAndRunUnitTests (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      TaskTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a: v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to setup Test Framework. Exiting with status = %r\n", Status));
+    ASSERT (FALSE);
+    return Status;
+  }
+
+  Status = CreateUnitTestSuite (&TaskTests, Framework, "PLDM FW Update Task Tests", "UnitTest.PldmFwUpdateTask", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for PLDM FW Update Task Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    return Status;
+  }
+
+  AddTestCase (TaskTests, "Large transfers with multiple outstanding requests", "WindowedTransfer", WindowedTransfer, NULL, NULL, NULL);
+  AddTestCase (TaskTests, "Windowed transfers are faster", "WindowedThroughput", WindowedThroughput, NULL, NULL, NULL);
+  AddTestCase (TaskTests, "Idle task waits in receive", "IdleWait", IdleWait, NULL, NULL, NULL);
+  AddTestCase (TaskTests, "Multiple devices updated together", "MultipleDevices", MultipleDevices, NULL, NULL, NULL);
+
+  // Execute the tests.
+  Status = RunAllTestSuites (Framework);
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return SetupAndRunUnitTests ();
+}
@@ -267,15 +267,31 @@ QspiPerformWaitCycleConfiguration (
   @param  QspiBaseAddress          Base Address for QSPI Controller in use.
   @param  PacketLen                Size of packets.
   @param  BlockLen                 Number of packets.
+  @param  BusWidth                 Number of lanes used for the packets.
 **/
 STATIC
 VOID
 QspiPerformTransactionConfiguration (
   IN EFI_PHYSICAL_ADDRESS  QspiBaseAddress,
   IN UINT32                PacketLen,
-  IN UINT32                BlockLen
+  IN UINT32                BlockLen,
+  IN QSPI_BUS_WIDTH        BusWidth
   )
 {
+  UINT32  InterfaceWidth;
+
+  switch (BusWidth) {
+    case QspiBusWidthDual:
+      InterfaceWidth = QSPI_COMMAND_0_INTERFACE_WIDTH_DUAL;
+      break;
+    case QspiBusWidthQuad:
+      InterfaceWidth = QSPI_COMMAND_0_INTERFACE_WIDTH_QUAD;
+      break;
+    default:
+      InterfaceWidth = QSPI_COMMAND_0_INTERFACE_WIDTH_SINGLE;
+      break;
+  }
+
   // Select Single Data Rate mode.
   MmioBitFieldWrite32 (
     QspiBaseAddress + QSPI_COMMAND_0,
@@ -283,12 +299,12 @@ QspiPerformTransactionConfiguration (
     QSPI_COMMAND_0_SDR_DDR_SEL_BIT,
     QSPI_COMMAND_0_SDR_DDR_SEL_SDR
     );
-  // Select single bit transfer mode.
+  // Select single, dual or quad bit transfer mode.
   MmioBitFieldWrite32 (
     QspiBaseAddress + QSPI_COMMAND_0,
     QSPI_COMMAND_0_INTERFACE_WIDTH_LSB,
     QSPI_COMMAND_0_INTERFACE_WIDTH_MSB,
-    QSPI_COMMAND_0_INTERFACE_WIDTH_SINGLE
+    InterfaceWidth
     );
   // Configure unpacked mode.
   MmioBitFieldWrite32 (
@@ -323,6 +339,7 @@ QspiPerformTransactionConfiguration (
                                    received.
   @param  Len                      Number of packets.
   @param  PacketLen                Size of individual packet.
+  @param  BusWidth                 Number of lanes to receive on.
 
   @retval EFI_SUCCESS              Data received successfully.
   @retval Others                   Data reception failed.
@@ -333,7 +350,8 @@ QspiPerformReceive (
   IN EFI_PHYSICAL_ADDRESS  QspiBaseAddress,
   IN VOID                  *Buffer,
   IN UINT32                Len,
-  IN UINT32                PacketLen
+  IN UINT32                PacketLen,
+  IN QSPI_BUS_WIDTH        BusWidth
   )
 {
   EFI_STATUS  Status;
@@ -347,7 +365,7 @@ QspiPerformReceive (
   // Clear transaction status
   QspiClearTransactionStatus (QspiBaseAddress);
   // Perform transaction packet width and size configuration
-  QspiPerformTransactionConfiguration (QspiBaseAddress, PacketLen, Len);
+  QspiPerformTransactionConfiguration (QspiBaseAddress, PacketLen, Len, BusWidth);
   // Enable RX
   MmioBitFieldWrite32 (
     QspiBaseAddress + QSPI_COMMAND_0,
@@ -426,6 +444,7 @@ QspiPerformReceive (
                                    be transmitted.
   @param  Len                      Number of packets.
   @param  PacketLen                Size of individual packet.
+  @param  BusWidth                 Number of lanes to transmit on.
 
   @retval EFI_SUCCESS              Data transmitted successfully.
   @retval Others                   Data transmission failed.
@@ -436,7 +455,8 @@ QspiPerformTransmit (
   IN EFI_PHYSICAL_ADDRESS  QspiBaseAddress,
   IN VOID                  *Buffer,
   IN UINT32                Len,
-  IN UINT32                PacketLen
+  IN UINT32                PacketLen,
+  IN QSPI_BUS_WIDTH        BusWidth
   )
 {
   EFI_STATUS  Status;
@@ -450,7 +470,7 @@ QspiPerformTransmit (
   // Clear transaction status
   QspiClearTransactionStatus (QspiBaseAddress);
   // Perform transaction packet width and size configuration
-  QspiPerformTransactionConfiguration (QspiBaseAddress, PacketLen, Len);
+  QspiPerformTransactionConfiguration (QspiBaseAddress, PacketLen, Len, BusWidth);
   // Enable TX
   MmioBitFieldWrite32 (
     QspiBaseAddress + QSPI_COMMAND_0,
@@ -519,6 +539,101 @@ QspiPerformTransmit (
   return EFI_SUCCESS;
 }
 
+/**
+  Transmit a phase of a transaction
+
+  Based on the length, calculate packet width and packets for each controller
+  transaction. Packet width can be 1B or 4B. Maximum number of packets in a
+  single controller transaction can be 64.
+
+  @param  QspiBaseAddress          Base Address for QSPI Controller in use.
+  @param  Buffer                   Data to be transmitted.
+  @param  Length                   Number of bytes to transmit.
+  @param  BusWidth                 Number of lanes to transmit on.
+  @param  WaitCycles               Number of wait cycles after the last
+                                   controller transaction of the phase.
+
+  @retval EFI_SUCCESS              Data transmitted successfully.
+  @retval Others                   Data transmission failed.
+**/
+STATIC
+EFI_STATUS
+QspiPerformTransmitPhase (
+  IN EFI_PHYSICAL_ADDRESS  QspiBaseAddress,
+  IN UINT8                 *Buffer,
+  IN UINT32                Length,
+  IN QSPI_BUS_WIDTH        BusWidth,
+  IN UINT8                 WaitCycles
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      TransactionWidth;
+  UINT32      TransactionCount;
+
+  while (Length > 0) {
+    TransactionWidth = (Length % sizeof (UINT32)) ? sizeof (UINT8) : sizeof (UINT32);
+    TransactionCount = MIN (MAX_FIFO_PACKETS, (Length / TransactionWidth));
+    if ((TransactionWidth * TransactionCount) == Length) {
+      QspiPerformWaitCycleConfiguration (QspiBaseAddress, WaitCycles);
+    }
+
+    DEBUG ((EFI_D_INFO, "QSPI Tx Transaction: Count: %d Width: %d Lanes: %d.\n", TransactionCount, TransactionWidth, 1 << BusWidth));
+    Status = QspiPerformTransmit (QspiBaseAddress, Buffer, TransactionCount, TransactionWidth, BusWidth);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Buffer += (TransactionWidth * TransactionCount);
+    Length -= (TransactionWidth * TransactionCount);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Receive a phase of a transaction
+
+  Based on the length, calculate packet width and packets for each controller
+  transaction. Packet width can be 1B or 4B. Maximum number of packets in a
+  single controller transaction can be 64.
+
+  @param  QspiBaseAddress          Base Address for QSPI Controller in use.
+  @param  Buffer                   Buffer to receive the data.
+  @param  Length                   Number of bytes to receive.
+  @param  BusWidth                 Number of lanes to receive on.
+
+  @retval EFI_SUCCESS              Data received successfully.
+  @retval Others                   Data reception failed.
+**/
+STATIC
+EFI_STATUS
+QspiPerformReceivePhase (
+  IN EFI_PHYSICAL_ADDRESS  QspiBaseAddress,
+  IN UINT8                 *Buffer,
+  IN UINT32                Length,
+  IN QSPI_BUS_WIDTH        BusWidth
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      TransactionWidth;
+  UINT32      TransactionCount;
+
+  while (Length > 0) {
+    TransactionWidth = (Length % sizeof (UINT32)) ? sizeof (UINT8) : sizeof (UINT32);
+    TransactionCount = MIN (MAX_FIFO_PACKETS, (Length / TransactionWidth));
+    DEBUG ((EFI_D_INFO, "QSPI Rx Transaction: Count: %d Width: %d Lanes: %d.\n", TransactionCount, TransactionWidth, 1 << BusWidth));
+    Status = QspiPerformReceive (QspiBaseAddress, Buffer, TransactionCount, TransactionWidth, BusWidth);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Buffer += (TransactionWidth * TransactionCount);
+    Length -= (TransactionWidth * TransactionCount);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Initialize the QSPI Driver
 
@@ -628,11 +743,12 @@ QspiPerformTransaction (
   IN QSPI_TRANSACTION_PACKET  *Packet
   )
 {
-  EFI_STATUS  Status;
-  UINT8       *Buffer;
-  UINT32      TransactionWidth;
-  UINT32      TransactionCount;
-  UINT32      Count;
+  EFI_STATUS      Status;
+  UINT8           *Buffer;
+  UINT32          TxSingleLen;
+  UINT32          TxMultiLen;
+  QSPI_BUS_WIDTH  TxBusWidth;
+  QSPI_BUS_WIDTH  RxBusWidth;
 
   // Check for invalid buffer address and size combinations.
   if (((Packet->TxBuf == NULL) &&
@@ -647,49 +763,57 @@ QspiPerformTransaction (
     return EFI_INVALID_PARAMETER;
   }
 
-  // Setup Wait Cycles.
-  QspiPerformWaitCycleConfiguration (QspiBaseAddress, Packet->WaitCycles);
+  // Lanes used for each phase.
+  TxSingleLen = Packet->TxLen;
+  TxBusWidth  = QspiBusWidthSingle;
+  RxBusWidth  = QspiBusWidthSingle;
+  if ((Packet->Control & QSPI_CONTROLLER_CONTROL_MULTI_LANE) != 0) {
+    if ((Packet->TxBusWidth >= QspiBusWidthMax) ||
+        (Packet->RxBusWidth >= QspiBusWidthMax) ||
+        (Packet->TxSingleLen > Packet->TxLen))
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    TxSingleLen = Packet->TxSingleLen;
+    TxBusWidth  = (QSPI_BUS_WIDTH)Packet->TxBusWidth;
+    RxBusWidth  = (QSPI_BUS_WIDTH)Packet->RxBusWidth;
+  }
+
+  TxMultiLen = Packet->TxLen - TxSingleLen;
+
+  // Setup Wait Cycles. They only follow the last transmit transaction, just
+  // before reception, not each command and address phase.
+  QspiPerformWaitCycleConfiguration (QspiBaseAddress, (Packet->TxBuf == NULL) ? Packet->WaitCycles : 0);
   // Enable CS
   QspiConfigureCS (QspiBaseAddress, Packet->ChipSelect, TRUE);
   // If transmission buffer address valid, start transmission
   if (Packet->TxBuf != NULL) {
     DEBUG ((EFI_D_INFO, "QSPI Tx Args: 0x%p %d.\n", Packet->TxBuf, Packet->TxLen));
     Buffer = Packet->TxBuf;
-    Count  = Packet->TxLen;
-    // Based on transmission buffer length, calculate packet width and packets in current transaction.
-    // Packet width can be 1B or 4B. Maximum number of packets in a single transaction can be 64.
-    while (Count > 0) {
-      TransactionWidth = (Count % sizeof (UINT32)) ? sizeof (UINT8) : sizeof (UINT32);
-      TransactionCount = MIN (MAX_FIFO_PACKETS, (Count / TransactionWidth));
-      DEBUG ((EFI_D_INFO, "QSPI Tx Transaction: Count: %d Width: %d.\n", TransactionCount, TransactionWidth));
-      Status = QspiPerformTransmit (QspiBaseAddress, Buffer, TransactionCount, TransactionWidth);
-      if (EFI_ERROR (Status)) {
-        return Status;
-      }
+    Status = QspiPerformTransmitPhase (
+               QspiBaseAddress,
+               Buffer,
+               TxSingleLen,
+               QspiBusWidthSingle,
+               (TxMultiLen == 0) ? Packet->WaitCycles : 0
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
 
-      Buffer += (TransactionWidth * TransactionCount);
-      Count  -= (TransactionWidth * TransactionCount);
+    Status = QspiPerformTransmitPhase (QspiBaseAddress, Buffer + TxSingleLen, TxMultiLen, TxBusWidth, Packet->WaitCycles);
+    if (EFI_ERROR (Status)) {
+      return Status;
     }
   }
 
   // If reception buffer address valid, start reception
   if (Packet->RxBuf != NULL) {
     DEBUG ((EFI_D_INFO, "QSPI Rx Args: 0x%p %d.\n", Packet->RxBuf, Packet->RxLen));
-    Buffer = Packet->RxBuf;
-    Count  = Packet->RxLen;
-    // Based on reception buffer length, calculate packet width and packets in current transaction.
-    // Packet width can be 1B or 4B. Maximum number of packets in a single transaction can be 64.
-    while (Count > 0) {
-      TransactionWidth = (Count % sizeof (UINT32)) ? sizeof (UINT8) : sizeof (UINT32);
-      TransactionCount = MIN (MAX_FIFO_PACKETS, (Count / TransactionWidth));
-      DEBUG ((EFI_D_INFO, "QSPI Rx Transaction: Count: %d Width: %d.\n", TransactionCount, TransactionWidth));
-      Status = QspiPerformReceive (QspiBaseAddress, Buffer, TransactionCount, TransactionWidth);
-      if (EFI_ERROR (Status)) {
-        return Status;
-      }
-
-      Buffer += (TransactionWidth * TransactionCount);
-      Count  -= (TransactionWidth * TransactionCount);
+    Status = QspiPerformReceivePhase (QspiBaseAddress, Packet->RxBuf, Packet->RxLen, RxBusWidth);
+    if (EFI_ERROR (Status)) {
+      return Status;
     }
   }
 
@@ -57,6 +57,8 @@
 #define QSPI_COMMAND_0_TX_EN_ENABLE            1
 #define QSPI_COMMAND_0_SDR_DDR_SEL_SDR         0
 #define QSPI_COMMAND_0_INTERFACE_WIDTH_SINGLE  0
+#define QSPI_COMMAND_0_INTERFACE_WIDTH_DUAL    1
+#define QSPI_COMMAND_0_INTERFACE_WIDTH_QUAD    2
 #define QSPI_COMMAND_0_PACKED_ENABLE           1
 
 #define QSPI_TRANSFER_STATUS_0  0x10
@@ -16,6 +16,8 @@
 #include <Library/UsbFalconLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/DmaLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiDecompressLib.h>
 
 /* Base Address of Xhci Controller's Configuration registers. These config
  * registers are used to access the Falcon Registers and for FW Loading.
@@ -157,6 +159,191 @@ Fpci2Write32 (
   return Value;
 }
 
+/*
+ * Firmware DMA buffer, kept across loads so a reload does not leak it.  The
+ * buffer is filled in again on every load: the caller's firmware pointer
+ * says nothing about the contents, which may change across a reconnect.
+ */
+STATIC UINT8   *mFirmwareBuffer          = NULL;
+STATIC UINTN   mFirmwareBufferPages      = 0;
+STATIC UINT64  mFirmwareBufferBusAddress = 0;
+STATIC VOID    *mFirmwareBufferMapping   = NULL;
+
+/**
+  Check the firmware image checksum.  The checksum is a CRC32 of the image
+  following the config table, up to fwimg_len, and is stored in fwimg_cksum
+  by the tool that compresses the image.
+
+  @param[in]  Image       Decompressed firmware image
+  @param[in]  ImageSize   Size of Image
+
+  @retval TRUE            Checksum matches
+  @retval FALSE           Image is truncated or corrupted
+**/
+STATIC
+BOOLEAN
+FalconFirmwareChecksumValid (
+  IN CONST UINT8  *Image,
+  IN UINT32       ImageSize
+  )
+{
+  CONST struct tegra_xhci_fw_cfgtbl  *FirmwareCfg;
+  UINT32                             Crc32;
+
+  FirmwareCfg = (CONST struct tegra_xhci_fw_cfgtbl *)Image;
+  if ((FirmwareCfg->fwimg_len < sizeof (*FirmwareCfg)) || (FirmwareCfg->fwimg_len > ImageSize)) {
+    return FALSE;
+  }
+
+  Crc32 = CalculateCrc32 (
+            (VOID *)(Image + sizeof (*FirmwareCfg)),
+            FirmwareCfg->fwimg_len - sizeof (*FirmwareCfg)
+            );
+  if (Crc32 != FirmwareCfg->fwimg_cksum) {
+    DEBUG ((EFI_D_ERROR, "%a: firmware checksum %x, expected %x\r\n", __FUNCTION__, Crc32, FirmwareCfg->fwimg_cksum));
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+  Get the firmware into a DMA buffer for the Falcon to load.
+
+  A firmware image that starts with FALCON_COMPRESSED_FIRMWARE_SIGNATURE is
+  UEFI-compressed.  It is decompressed directly into the DMA buffer, and the
+  result is checked against the size in its header and fwimg_cksum.  Any
+  other firmware is a raw image and is copied.
+
+  @param[in]  Firmware          Firmware as stored
+  @param[in]  FirmwareSize      Size of Firmware
+  @param[out] ImageSize         Size of the firmware image in the DMA buffer
+  @param[out] BusAddress        Bus address of the DMA buffer
+
+  @retval EFI_SUCCESS           Firmware is in the DMA buffer
+  @retval EFI_VOLUME_CORRUPTED  Firmware image is not valid
+  @retval others                Error occurred
+**/
+STATIC
+EFI_STATUS
+FalconFirmwarePrepare (
+  IN  CONST UINT8  *Firmware,
+  IN  UINT32       FirmwareSize,
+  OUT UINT32       *ImageSize,
+  OUT UINT64       *BusAddress
+  )
+{
+  EFI_STATUS                               Status;
+  CONST FALCON_COMPRESSED_FIRMWARE_HEADER  *CompressedHeader;
+  CONST UINT8                              *CompressedData;
+  UINT32                                   CompressedSize;
+  UINT32                                   DecompressedSize;
+  UINT32                                   ScratchSize;
+  VOID                                     *Scratch;
+  BOOLEAN                                  Compressed;
+  UINTN                                    Pages;
+  UINTN                                    BufferSize;
+  UINT8                                    *Buffer;
+  struct tegra_xhci_fw_cfgtbl              *FirmwareCfg;
+
+  CompressedData   = NULL;
+  ScratchSize      = 0;
+  CompressedHeader = (CONST FALCON_COMPRESSED_FIRMWARE_HEADER *)Firmware;
+  Compressed       = (FirmwareSize >= sizeof (*CompressedHeader)) &&
+                     (CompressedHeader->Signature == FALCON_COMPRESSED_FIRMWARE_SIGNATURE);
+  if (Compressed) {
+    CompressedData = Firmware + sizeof (*CompressedHeader);
+    CompressedSize = FirmwareSize - sizeof (*CompressedHeader);
+    Status         = UefiDecompressGetInfo (CompressedData, CompressedSize, &DecompressedSize, &ScratchSize);
+    if (EFI_ERROR (Status) ||
+        (DecompressedSize != CompressedHeader->ImageSize) ||
+        (DecompressedSize < sizeof (*FirmwareCfg)))
+    {
+      DEBUG ((EFI_D_ERROR, "%a: compressed firmware is not valid\r\n", __FUNCTION__));
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    *ImageSize = DecompressedSize;
+  } else {
+    if (FirmwareSize < sizeof (*FirmwareCfg)) {
+      DEBUG ((EFI_D_ERROR, "%a: firmware size %u too small\r\n", __FUNCTION__, FirmwareSize));
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    *ImageSize = FirmwareSize;
+  }
+
+  Pages = EFI_SIZE_TO_PAGES (*ImageSize);
+  if ((mFirmwareBuffer != NULL) && (mFirmwareBufferPages >= Pages)) {
+    Buffer = mFirmwareBuffer;
+  } else {
+    if (mFirmwareBuffer != NULL) {
+      DmaUnmap (mFirmwareBufferMapping);
+      DmaFreeBuffer (mFirmwareBufferPages, mFirmwareBuffer);
+      mFirmwareBuffer = NULL;
+    }
+
+    Status = DmaAllocateAlignedBuffer (EfiRuntimeServicesData, Pages, 256, (VOID **)&Buffer);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((EFI_D_ERROR, "%a: DmaAllocateAlignedBuffer Failed: %r\n", __FUNCTION__, Status));
+      return Status;
+    }
+
+    BufferSize = EFI_PAGES_TO_SIZE (Pages);
+    Status     = DmaMap (
+                   MapOperationBusMasterCommonBuffer,
+                   Buffer,
+                   &BufferSize,
+                   &mFirmwareBufferBusAddress,
+                   &mFirmwareBufferMapping
+                   );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((EFI_D_ERROR, "%a: DmaMap Failed: %r\n", __FUNCTION__, Status));
+      DmaFreeBuffer (Pages, Buffer);
+      return Status;
+    }
+
+    mFirmwareBuffer      = Buffer;
+    mFirmwareBufferPages = Pages;
+  }
+
+  if (Compressed) {
+    Scratch = AllocatePool (ScratchSize);
+    if (Scratch == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Status = UefiDecompress (CompressedData, Buffer, Scratch);
+    FreePool (Scratch);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((EFI_D_ERROR, "%a: failed to decompress firmware: %r\r\n", __FUNCTION__, Status));
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    if (!FalconFirmwareChecksumValid (Buffer, *ImageSize)) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+  } else {
+    CopyMem (Buffer, Firmware, FirmwareSize);
+  }
+
+  ZeroMem (Buffer + *ImageSize, EFI_PAGES_TO_SIZE (mFirmwareBufferPages) - *ImageSize);
+
+  FirmwareCfg = (struct tegra_xhci_fw_cfgtbl *)Buffer;
+  if ((FirmwareCfg->fwimg_len < sizeof (*FirmwareCfg)) || (FirmwareCfg->fwimg_len > *ImageSize)) {
+    DEBUG ((EFI_D_ERROR, "%a: firmware length %u exceeds image size %u\r\n", __FUNCTION__, FirmwareCfg->fwimg_len, *ImageSize));
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  MemoryFence ();
+
+  *BusAddress = mFirmwareBufferBusAddress;
+
+  DEBUG ((EFI_D_VERBOSE, "%a: Firmware %p size %x in buffer %p size %x\r\n", __FUNCTION__, Firmware, FirmwareSize, Buffer, *ImageSize));
+
+  return EFI_SUCCESS;
+}
+
 static VOID
 FalconDumpDMEM (
   VOID
@@ -181,12 +368,9 @@ FalconFirmwareIfrLoad (
 {
   EFI_STATUS  Status;
   UINT32      Value;
-  UINT32      Pages;
-  UINT32      RegVal, i;
-  UINTN       BufferSize;
-  UINT8       *FirmwareBuffer;
+  UINT32      RegVal;
+  UINT32      ImageSize;
   UINT64      FirmwareBufferBusAddress;
-  VOID        *FirmwareBufferMapping;
 
   Status = EFI_SUCCESS;
   Value  = 0;
@@ -202,40 +386,11 @@ FalconFirmwareIfrLoad (
     return Status;
   }
 
-  Pages  = EFI_SIZE_TO_PAGES (FirmwareSize);
-  Status = DmaAllocateAlignedBuffer (EfiRuntimeServicesData, Pages, 256, (void **)&FirmwareBuffer);
+  Status = FalconFirmwarePrepare (Firmware, FirmwareSize, &ImageSize, &FirmwareBufferBusAddress);
   if (EFI_ERROR (Status)) {
-    DEBUG ((EFI_D_ERROR, "%a: DmaAllocateAlignedBuffer Failed: %r\n", __FUNCTION__, Status));
     return Status;
   }
 
-  BufferSize = EFI_PAGES_TO_SIZE (Pages);
-  Status     = DmaMap (
-                 MapOperationBusMasterCommonBuffer,
-                 FirmwareBuffer,
-                 &BufferSize,
-                 &FirmwareBufferBusAddress,
-                 &FirmwareBufferMapping
-                 );
-  if (EFI_ERROR (Status)) {
-    DEBUG ((EFI_D_ERROR, "%a: DmaMap Failed: %r\n", __FUNCTION__, Status));
-    return Status;
-  }
-
-  DEBUG ((EFI_D_ERROR, "%a: Firmware %p FirmwareSize %x (unaligned)\r\n", __FUNCTION__, Firmware, FirmwareSize));
-  SetMem (FirmwareBuffer, BufferSize, 0xdf);
-  CopyMem (FirmwareBuffer, Firmware, FirmwareSize);
-  for (i = 0; i < FirmwareSize; i++) {
-    if (FirmwareBuffer[i] != Firmware[i]) {
-      DEBUG ((EFI_D_ERROR, "%a: FirmwareBuffer[%d] != Firmware[%d]\r\n", __FUNCTION__, i, i));
-      return Status;
-    }
-  }
-
-  MemoryFence ();
-  Firmware = FirmwareBuffer;
-  DEBUG ((EFI_D_ERROR, "%a: Firmware %p FirmwareSize %x (aligned)\r\n", __FUNCTION__, Firmware, FirmwareSize));
-
   #define XUSB_BAR2_ARU_IFRDMA_CFG0            0x1bc
   #define XUSB_BAR2_ARU_IFRDMA_CFG1            0x1c0
   #define XUSB_BAR2_ARU_IFRDMA_STREAMID_FIELD  0x1c4
@@ -253,6 +408,19 @@ FalconFirmwareIfrLoad (
   return Status;
 }
 
+/*
+ * The IMEM load below is synchronous on purpose, it is not started here and
+ * completed from a timer event:
+ * - XhciControllerDxe calls this from its DeviceDiscoveryDriverBindingStart
+ *   notification and then polls USBSTS.CNR for up to 200ms, failing the
+ *   start if the controller is not ready.
+ * - DeviceDiscoveryDriverLib installs the EDKII non-discoverable device
+ *   protocol as soon as that notification returns, and XhciDxe binds to it
+ *   and programs the operational registers straight away.
+ * - Every Falcon register access goes through the single CSBRANGE page
+ *   window in FalconMapReg, so a deferred load could not share it safely
+ *   with the driver's own Falcon accesses.
+ */
 EFI_STATUS
 FalconFirmwareLoad (
   IN  UINT8    *Firmware,
@@ -276,11 +444,8 @@ FalconFirmwareLoad (
   UINT32                       Value;
   UINTN                        i;
   EFI_STATUS                   Status = EFI_SUCCESS;
-  UINT32                       Pages;
-  UINTN                        BufferSize;
-  UINT8                        *FirmwareBuffer;
-  UINTN                        FirmwareBufferBusAddress;
-  VOID                         *FirmwareBufferMapping;
+  UINT32                       ImageSize;
+  UINT64                       FirmwareBufferBusAddress;
 
   DEBUG ((EFI_D_VERBOSE, "%a\r\n", __FUNCTION__));
 
@@ -297,39 +462,12 @@ FalconFirmwareLoad (
     return Status;
   }
 
-  Pages  = EFI_SIZE_TO_PAGES (FirmwareSize);
-  Status = DmaAllocateAlignedBuffer (EfiRuntimeServicesData, Pages, 256, (void **)&FirmwareBuffer);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((EFI_D_ERROR, "%a: DmaAllocateAlignedBuffer Failed: %r\n", __FUNCTION__, Status));
-    return Status;
-  }
-
-  BufferSize = EFI_PAGES_TO_SIZE (Pages);
-  Status     = DmaMap (
-                 MapOperationBusMasterCommonBuffer,
-                 FirmwareBuffer,
-                 &BufferSize,
-                 &FirmwareBufferBusAddress,
-                 &FirmwareBufferMapping
-                 );
+  Status = FalconFirmwarePrepare (Firmware, FirmwareSize, &ImageSize, &FirmwareBufferBusAddress);
   if (EFI_ERROR (Status)) {
-    DEBUG ((EFI_D_ERROR, "%a: DmaMap Failed: %r\n", __FUNCTION__, Status));
     return Status;
   }
 
-  DEBUG ((EFI_D_VERBOSE, "%a: Firmware %p FirmwareSize %x (unaligned)\r\n", __FUNCTION__, Firmware, FirmwareSize));
-  SetMem (FirmwareBuffer, BufferSize, 0xdf);
-  CopyMem (FirmwareBuffer, Firmware, FirmwareSize);
-  for (i = 0; i < FirmwareSize; i++) {
-    if (FirmwareBuffer[i] != Firmware[i]) {
-      DEBUG ((EFI_D_VERBOSE, "%a: FirmwareBuffer[%u] != Firmware[%u]\r\n", __FUNCTION__, i, i));
-      return Status;
-    }
-  }
-
-  MemoryFence ();
-  Firmware = FirmwareBuffer;
-  DEBUG ((EFI_D_VERBOSE, "%a: Firmware %p FirmwareSize %x (aligned)\r\n", __FUNCTION__, Firmware, FirmwareSize));
+  Firmware = mFirmwareBuffer;
 
   /* Configure FW */
   FirmwareCfg = (struct tegra_xhci_fw_cfgtbl *)Firmware;
@@ -341,13 +479,14 @@ FalconFirmwareLoad (
   DEBUG ((EFI_D_VERBOSE, "%a: FirmwareCfg %p num_hsic_port %x\r\n", __FUNCTION__, FirmwareCfg, FirmwareCfg->num_hsic_port));
   FirmwareCfg->num_hsic_port = 0;
   DEBUG ((EFI_D_VERBOSE, "%a: FirmwareCfg %p num_hsic_port %x\r\n", __FUNCTION__, FirmwareCfg, FirmwareCfg->num_hsic_port));
+  MemoryFence ();
   DEBUG ((EFI_D_VERBOSE, "%a: FirmwareCfg %p boot_codetag %x\r\n", __FUNCTION__, FirmwareCfg, FirmwareCfg->boot_codetag));
   DEBUG ((EFI_D_VERBOSE, "%a: FirmwareCfg %p boot_codesize %x\r\n", __FUNCTION__, FirmwareCfg, FirmwareCfg->boot_codesize));
   DEBUG ((EFI_D_VERBOSE, "%a: FirmwareCfg %p fwimg_len %x\r\n", __FUNCTION__, FirmwareCfg, FirmwareCfg->fwimg_len));
 
   /* program system memory address where FW code starts */
   FirmwareAddress = FirmwareBufferBusAddress + sizeof (*FirmwareCfg);
-  SIZE            = FirmwareSize / 256;
+  SIZE            = ImageSize / 256;
   DEBUG ((EFI_D_VERBOSE, "%a: SIZE %x\r\n", __FUNCTION__, SIZE));
   Value  = 0;
   Value |= ((SIZE & 0xfff)) << 8;
@@ -303,6 +303,231 @@ ErstEraseSpiNor (
   return Status;
 }
 
+// Offset of the summary header of the block, with the entries following it
+STATIC
+UINT32
+ErstSummaryOffset (
+  IN ERST_BLOCK_INFO  *BlockInfo
+  )
+{
+  return BlockInfo->Base + mErrorSerialization.DataSize;
+}
+
+// Offset of the given summary entry of the block
+STATIC
+UINT32
+ErstSummaryEntryOffset (
+  IN ERST_BLOCK_INFO  *BlockInfo,
+  IN UINT16           EntryIndex
+  )
+{
+  return ErstSummaryOffset (BlockInfo) + sizeof (ERST_BLOCK_SUMMARY_HEADER) +
+         EntryIndex * sizeof (ERST_BLOCK_SUMMARY_ENTRY);
+}
+
+// Starts tracking the summary of an empty block
+STATIC
+VOID
+ErstStartSummary (
+  IN ERST_BLOCK_INFO  *BlockInfo
+  )
+{
+  BlockInfo->DataSize     = mErrorSerialization.DataSize;
+  BlockInfo->SummaryCount = 0;
+  BlockInfo->HasSummary   = TRUE;
+}
+
+// Writes the summary header of an empty block. Writing it again is harmless, since the bits don't change.
+STATIC
+EFI_STATUS
+ErstWriteSummaryHeader (
+  IN ERST_BLOCK_INFO  *BlockInfo
+  )
+{
+  EFI_STATUS                 Status;
+  ERST_BLOCK_SUMMARY_HEADER  Header;
+
+  Header.Signature  = ERST_SUMMARY_SIGNATURE;
+  Header.Version    = ERST_SUMMARY_VERSION;
+  Header.State      = ERST_SUMMARY_STATE_ACTIVE;
+  Header.EntryCount = mErrorSerialization.SummaryEntries;
+  SetMem (Header.Reserved, sizeof (Header.Reserved), 0xFF);
+
+  Status = ErstWriteSpiNor (&Header, ErstSummaryOffset (BlockInfo), sizeof (Header));
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Unable to write the summary of block at 0x%x: %r\n", __FUNCTION__, BlockInfo->Base, Status));
+  }
+
+  return Status;
+}
+
+// Stops using the block summary, so that the next init scans the block instead
+STATIC
+VOID
+ErstAbandonSummary (
+  IN ERST_BLOCK_INFO  *BlockInfo
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       State;
+
+  DEBUG ((DEBUG_WARN, "%a: Abandoning the summary of block at 0x%x\n", __FUNCTION__, BlockInfo->Base));
+  BlockInfo->HasSummary = FALSE;
+
+  State  = ERST_SUMMARY_STATE_ABANDONED;
+  Status = ErstWriteSpiNor (
+             &State,
+             ErstSummaryOffset (BlockInfo) + OFFSET_OF (ERST_BLOCK_SUMMARY_HEADER, State),
+             1
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Unable to abandon the summary: %r\n", __FUNCTION__, Status));
+  }
+}
+
+// Finds the summary entry of the record at RecordOffset by walking the entry lengths.
+// EntryIndex is set to SummaryCount if RecordOffset is where the next entry goes.
+STATIC
+EFI_STATUS
+ErstFindSummaryEntry (
+  IN  ERST_BLOCK_INFO           *BlockInfo,
+  IN  UINT32                    RecordOffset,
+  OUT UINT16                    *EntryIndex,
+  OUT ERST_BLOCK_SUMMARY_ENTRY  *Entry
+  )
+{
+  EFI_STATUS                Status;
+  ERST_BLOCK_SUMMARY_ENTRY  Entries[16];
+  UINT16                    Index;
+  UINT16                    Count;
+  UINT16                    ChunkIndex;
+  UINT32                    Offset;
+
+  Offset = BlockInfo->Base;
+  for (Index = 0; Index < BlockInfo->SummaryCount; Index += Count) {
+    Count  = MIN (BlockInfo->SummaryCount - Index, ARRAY_SIZE (Entries));
+    Status = ErstReadSpiNor (Entries, ErstSummaryEntryOffset (BlockInfo, Index), Count * sizeof (ERST_BLOCK_SUMMARY_ENTRY));
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    for (ChunkIndex = 0; ChunkIndex < Count; ChunkIndex++) {
+      if (Offset == RecordOffset) {
+        *EntryIndex = Index + ChunkIndex;
+        CopyMem (Entry, &Entries[ChunkIndex], sizeof (ERST_BLOCK_SUMMARY_ENTRY));
+        return EFI_SUCCESS;
+      }
+
+      Offset += Entries[ChunkIndex].RecordLength;
+      if (Offset > RecordOffset) {
+        return EFI_NOT_FOUND;
+      }
+    }
+  }
+
+  if (Offset != RecordOffset) {
+    return EFI_NOT_FOUND;
+  }
+
+  *EntryIndex = BlockInfo->SummaryCount;
+  return EFI_SUCCESS;
+}
+
+// Adds the summary entry for a record that is about to be written INCOMING
+STATIC
+VOID
+ErstWriteSummaryEntry (
+  IN ERST_BLOCK_INFO  *BlockInfo,
+  IN ERST_CPER_INFO   *CperInfo
+  )
+{
+  EFI_STATUS                Status;
+  ERST_BLOCK_SUMMARY_ENTRY  Entry;
+  UINT16                    EntryIndex;
+
+  if (!BlockInfo->HasSummary) {
+    return;
+  }
+
+  Status = ErstFindSummaryEntry (BlockInfo, CperInfo->RecordOffset, &EntryIndex, &Entry);
+  if (EFI_ERROR (Status)) {
+    ErstAbandonSummary (BlockInfo);
+    return;
+  }
+
+  if (EntryIndex < BlockInfo->SummaryCount) {
+    // Rewriting an existing INCOMING record, such as when finishing the move of an OUTGOING one
+    if ((Entry.RecordId != CperInfo->RecordId) ||
+        (Entry.RecordLength != CperInfo->RecordLength))
+    {
+      ErstAbandonSummary (BlockInfo);
+    }
+
+    return;
+  }
+
+  if (EntryIndex >= mErrorSerialization.SummaryEntries) {
+    // GCOVR_EXCL_START - The summary has more entries than the block has space for records
+    ErstAbandonSummary (BlockInfo);
+    return;
+    // GCOVR_EXCL_STOP
+  }
+
+  // Empty blocks found at init don't have a header yet
+  if (EntryIndex == 0) {
+    Status = ErstWriteSummaryHeader (BlockInfo);
+    if (EFI_ERROR (Status)) {
+      ErstAbandonSummary (BlockInfo);
+      return;
+    }
+  }
+
+  SetMem (&Entry, sizeof (Entry), 0xFF);
+  Entry.RecordId     = CperInfo->RecordId;
+  Entry.RecordLength = CperInfo->RecordLength;
+
+  Status = ErstWriteSpiNor (&Entry, ErstSummaryEntryOffset (BlockInfo, EntryIndex), sizeof (Entry));
+  if (EFI_ERROR (Status)) {
+    ErstAbandonSummary (BlockInfo);
+    return;
+  }
+
+  BlockInfo->SummaryCount++;
+}
+
+// Updates the Status of the record's summary entry
+STATIC
+VOID
+ErstWriteSummaryStatus (
+  IN ERST_BLOCK_INFO  *BlockInfo,
+  IN ERST_CPER_INFO   *CperInfo,
+  IN UINT8            CperStatus
+  )
+{
+  EFI_STATUS                Status;
+  ERST_BLOCK_SUMMARY_ENTRY  Entry;
+  UINT16                    EntryIndex;
+
+  if (!BlockInfo->HasSummary) {
+    return;
+  }
+
+  Status = ErstFindSummaryEntry (BlockInfo, CperInfo->RecordOffset, &EntryIndex, &Entry);
+  if (EFI_ERROR (Status) || (EntryIndex >= BlockInfo->SummaryCount)) {
+    ErstAbandonSummary (BlockInfo);
+    return;
+  }
+
+  Status = ErstWriteSpiNor (
+             &CperStatus,
+             ErstSummaryEntryOffset (BlockInfo, EntryIndex) + OFFSET_OF (ERST_BLOCK_SUMMARY_ENTRY, Status),
+             1
+             );
+  if (EFI_ERROR (Status)) {
+    ErstAbandonSummary (BlockInfo);
+  }
+}
+
 // Locates Status field in the CPER and writes it, and updates the INCOMING/OUTGOING tracking
 EFI_STATUS
 EFIAPI
@@ -311,7 +536,8 @@ ErstWriteCperStatus (
   IN ERST_CPER_INFO  *CperInfo
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS       Status;
+  ERST_BLOCK_INFO  *BlockInfo;
 
   if ((*CperStatus == ERST_RECORD_STATUS_INCOMING) &&
       (mErrorSerialization.IncomingCperInfo != NULL) &&
@@ -331,6 +557,17 @@ ErstWriteCperStatus (
     goto ReturnStatus;
   }
 
+  // The summary entry is added before the record goes INCOMING and follows the record to VALID,
+  // but leads it for the later Status values, so a summary is never ahead of an incomplete record
+  BlockInfo = ErstGetBlockOfRecord (CperInfo);
+  if (BlockInfo != NULL) {
+    if (*CperStatus == ERST_RECORD_STATUS_INCOMING) {
+      ErstWriteSummaryEntry (BlockInfo, CperInfo);
+    } else if (*CperStatus != ERST_RECORD_STATUS_VALID) {
+      ErstWriteSummaryStatus (BlockInfo, CperInfo, *CperStatus);
+    }
+  }
+
   Status = ErstWriteSpiNor (
              CperStatus,
              CperInfo->RecordOffset +
@@ -339,9 +576,18 @@ ErstWriteCperStatus (
              1
              );
   if (EFI_ERROR (Status)) {
+    // The summary may already have moved on without the record
+    if ((BlockInfo != NULL) && BlockInfo->HasSummary) {
+      ErstAbandonSummary (BlockInfo);
+    }
+
     goto ReturnStatus;
   }
 
+  if ((BlockInfo != NULL) && (*CperStatus == ERST_RECORD_STATUS_VALID)) {
+    ErstWriteSummaryStatus (BlockInfo, CperInfo, *CperStatus);
+  }
+
   // Update Incoming/Outgoing tracking
   switch (*CperStatus) {
     case ERST_RECORD_STATUS_INCOMING:
@@ -417,6 +663,12 @@ ErstEraseBlock (
     BlockInfo->UsedSize     = 0;
     BlockInfo->WastedSize   = 0;
     BlockInfo->ValidEntries = 0;
+
+    // Write the summary header now, so that init doesn't need to scan the empty block
+    ErstStartSummary (BlockInfo);
+    if (EFI_ERROR (ErstWriteSummaryHeader (BlockInfo))) {
+      ErstAbandonSummary (BlockInfo);
+    }
   }
 
   return Status;
@@ -637,7 +889,7 @@ ErstFindFreeSpace (
     BlockInfo          = &mErrorSerialization.BlockInfo[AdjustedBlockIndex];
     DEBUG ((DEBUG_VERBOSE, "%a: Block %d has UsedSize 0x%x, WastedSize 0x%x\n", __FUNCTION__, AdjustedBlockIndex, BlockInfo->UsedSize, BlockInfo->WastedSize));
     if ((BlockInfo->ValidEntries > 0) &&
-        (BlockInfo->UsedSize + RecordLength <= mErrorSerialization.BlockSize))
+        (BlockInfo->UsedSize + RecordLength <= BlockInfo->DataSize))
     {
       FreeOffset = BlockInfo->UsedSize + BlockInfo->Base;
       Status     = EFI_SUCCESS;
@@ -658,7 +910,7 @@ ErstFindFreeSpace (
       if (WastedBlockInfo && ((WastedBlockInfo->UsedSize - WastedBlockInfo->WastedSize) < (BlockInfo->UsedSize - BlockInfo->WastedSize))) {
         // The current block has more waste than the previously wasted block, so set it as the wasted block
         WastedBlockInfo = BlockInfo;
-      } else if (BlockInfo->UsedSize - BlockInfo->WastedSize + RecordLength <= mErrorSerialization.BlockSize) {
+      } else if (BlockInfo->UsedSize - BlockInfo->WastedSize + RecordLength <= mErrorSerialization.DataSize) {
         // The current block is the first block found with usable waste
         WastedBlockInfo = BlockInfo;
       }
@@ -1227,6 +1479,152 @@ ErstGetNextRecordID (
   }
 }
 
+// Finds the index of the record a batch starts with, where ERST_FIRST_RECORD_ID is the first record
+STATIC
+EFI_STATUS
+ErstFindBatchStart (
+  IN  UINT64  RecordID,
+  OUT UINT32  *Index
+  )
+{
+  ERST_CPER_INFO  *Record;
+
+  if (RecordID == ERST_FIRST_RECORD_ID) {
+    *Index = 0;
+    return EFI_SUCCESS;
+  }
+
+  Record = ErstFindRecord (RecordID);
+  if (Record == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  *Index = Record - mErrorSerialization.CperInfo;
+  return EFI_SUCCESS;
+}
+
+// Read consecutive records, starting with RecordID, back to back into Buffer
+EFI_STATUS
+EFIAPI
+ErstReadRecordBatch (
+  IN     UINT64             RecordID,
+  IN OUT ERST_BATCH_HEADER  *Batch,
+  OUT    UINT8              *Buffer,
+  IN     UINT64             MaxLength,
+  OUT    UINT64             *NextRecordID
+  )
+{
+  EFI_STATUS      Status;
+  ERST_CPER_INFO  *Record;
+  UINT32          Index;
+  UINT32          Count;
+  UINT64          Length;
+
+  Count  = 0;
+  Length = 0;
+  Index  = mErrorSerialization.RecordCount;
+
+  Status = ErstFindBatchStart (RecordID, &Index);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: RecordId not found\n", __FUNCTION__));
+    goto ReturnStatus;
+  }
+
+  while ((Index < mErrorSerialization.RecordCount) &&
+         ((Batch->Count == 0) || (Count < Batch->Count)))
+  {
+    Record = &mErrorSerialization.CperInfo[Index];
+    if (Length + Record->RecordLength > MaxLength) {
+      break;
+    }
+
+    Status = ErstReadSpiNor (Buffer + Length, Record->RecordOffset, Record->RecordLength);
+    if (!EFI_ERROR (Status)) {
+      Status = ErstValidateRecord ((EFI_COMMON_ERROR_RECORD_HEADER *)(Buffer + Length), Record->RecordId, Record->RecordLength);
+    }
+
+    if (EFI_ERROR (Status)) {
+      goto ReturnStatus;
+    }
+
+    Length += Record->RecordLength;
+    Count++;
+    Index++;
+
+    if (Record->RecordId == Batch->LastRecordID) {
+      break;
+    }
+  }
+
+  if (Count == 0) {
+    DEBUG ((DEBUG_WARN, "%a: Record doesn't fit at offset\n", __FUNCTION__));
+    Status = EFI_OUT_OF_RESOURCES;
+  }
+
+ReturnStatus:
+  Batch->Count  = Count;
+  Batch->Length = (UINT32)Length;
+  if (Index < mErrorSerialization.RecordCount) {
+    *NextRecordID = mErrorSerialization.CperInfo[Index].RecordId;
+  } else {
+    *NextRecordID = ERST_INVALID_RECORD_ID;
+  }
+
+  return Status;
+}
+
+// Clear consecutive records, starting with RecordID
+EFI_STATUS
+EFIAPI
+ErstClearRecordBatch (
+  IN     UINT64             RecordID,
+  IN OUT ERST_BATCH_HEADER  *Batch,
+  OUT    UINT64             *NextRecordID
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      ClearedRecordID;
+  UINT32      Index;
+  UINT32      Count;
+
+  Count = 0;
+  Index = mErrorSerialization.RecordCount;
+
+  Status = ErstFindBatchStart (RecordID, &Index);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: RecordId not found\n", __FUNCTION__));
+    goto ReturnStatus;
+  }
+
+  // Clearing a record moves the following records down, so Index stays put
+  while ((Index < mErrorSerialization.RecordCount) &&
+         ((Batch->Count == 0) || (Count < Batch->Count)))
+  {
+    ClearedRecordID = mErrorSerialization.CperInfo[Index].RecordId;
+    Status          = ErstClearRecord (&mErrorSerialization.CperInfo[Index]);
+    if (EFI_ERROR (Status)) {
+      goto ReturnStatus;
+    }
+
+    Count++;
+
+    if (ClearedRecordID == Batch->LastRecordID) {
+      break;
+    }
+  }
+
+ReturnStatus:
+  Batch->Count  = Count;
+  Batch->Length = 0;
+  if (Index < mErrorSerialization.RecordCount) {
+    *NextRecordID = mErrorSerialization.CperInfo[Index].RecordId;
+  } else {
+    *NextRecordID = ERST_INVALID_RECORD_ID;
+  }
+
+  return Status;
+}
+
 // Clear the interrupt status bit that is used as a busy indicator to the OS
 VOID
 ErstClearBusy (
@@ -1327,9 +1725,13 @@ ErrorSerializationEventHandler (
   UINT64                          OSRecordLength;
   UINT64                          OSRecordOffset;
   UINT64                          OSRecordID;
+  UINT64                          OSOperation;
   UINT64                          MaxLength;
+  UINT64                          NextRecordID;
   ERST_CPER_INFO                  *Record;
   ERST_CPER_INFO                  NewRecord;
+  ERST_BATCH_HEADER               *BatchHeader;
+  ERST_BATCH_HEADER               Batch;
   BOOLEAN                         DummyOp;
   UINT64                          StartTime __attribute__ ((unused));
 
@@ -1377,9 +1779,10 @@ ErrorSerializationEventHandler (
   // Save off the inputs from OS before validating them, in case malicious code tries to change them after validation
   OSRecordOffset = ERSTComm->RecordOffset;
   OSRecordID     = ERSTComm->RecordID;
+  OSOperation    = ERSTComm->Operation;
 
   /* Parse the requested action */
-  switch (ERSTComm->Operation) {
+  switch (OSOperation) {
     case ERST_OPERATION_DUMMY_WRITE:
       DummyOp = TRUE;
     case ERST_OPERATION_WRITE:
@@ -1567,8 +1970,39 @@ ErrorSerializationEventHandler (
 
       break;
 
+    case ERST_OPERATION_READ_BATCH:
+    case ERST_OPERATION_CLEAR_BATCH:
+      /* Read or clear several records with a single MM call */
+      if (mErrorSerialization.RecordCount == 0) {
+        AcpiStatus = EFI_ACPI_6_4_ERST_STATUS_RECORD_STORE_EMPTY;
+        DEBUG ((DEBUG_WARN, "%a: Record Store Empty\n", __FUNCTION__));
+        break;
+      }
+
+      if (OSRecordOffset > (mErrorSerialization.BufferInfo.ErrorLogInfo.Length - sizeof (ERST_BATCH_HEADER))) {
+        DEBUG ((DEBUG_WARN, "%a: RecordOffset overflows ErrorLogBuffer\n", __FUNCTION__));
+        AcpiStatus = EFI_ACPI_6_4_ERST_STATUS_NOT_ENOUGH_SPACE;
+        break;
+      }
+
+      // Save off the batch request, the records are read after it
+      BatchHeader = (ERST_BATCH_HEADER *)(mErrorSerialization.BufferInfo.ErrorLogInfo.PhysicalBase + OSRecordOffset);
+      CopyMem (&Batch, BatchHeader, sizeof (Batch));
+
+      if (OSOperation == ERST_OPERATION_READ_BATCH) {
+        MaxLength = mErrorSerialization.BufferInfo.ErrorLogInfo.Length - OSRecordOffset - sizeof (ERST_BATCH_HEADER);
+        EfiStatus = ErstReadRecordBatch (OSRecordID, &Batch, (UINT8 *)(BatchHeader + 1), MaxLength, &NextRecordID);
+      } else {
+        EfiStatus = ErstClearRecordBatch (OSRecordID, &Batch, &NextRecordID);
+      }
+
+      BatchHeader->Count  = Batch.Count;
+      BatchHeader->Length = Batch.Length;
+      ERSTComm->RecordID  = NextRecordID;
+      break;
+
     default:
-      DEBUG ((DEBUG_WARN, "%a: Unknown operation %d\n", __FUNCTION__, ERSTComm->Operation));
+      DEBUG ((DEBUG_WARN, "%a: Unknown operation %d\n", __FUNCTION__, OSOperation));
       AcpiStatus = EFI_ACPI_6_4_ERST_STATUS_FAILED;
       break;
   }
@@ -1611,28 +2045,29 @@ ReturnStatus:
   return EFI_SUCCESS;
 }
 
+// Adds a record found at init to the tracking data
+STATIC
 EFI_STATUS
-EFIAPI
-ErstAddCperToList (
-  IN EFI_COMMON_ERROR_RECORD_HEADER  *Cper,
-  IN UINT32                          Offset
+ErstTrackRecord (
+  IN UINT64  RecordId,
+  IN UINT32  RecordLength,
+  IN UINT32  Offset,
+  IN UINT8   CperStatus
   )
 {
-  EFI_STATUS                  Status;
-  ERST_CPER_INFO              CperInfo;
-  CPER_ERST_PERSISTENCE_INFO  *CperPI;
+  EFI_STATUS      Status;
+  ERST_CPER_INFO  CperInfo;
 
-  CperInfo.RecordId     = Cper->RecordID;
-  CperInfo.RecordLength = Cper->RecordLength;
+  CperInfo.RecordId     = RecordId;
+  CperInfo.RecordLength = RecordLength;
   CperInfo.RecordOffset = Offset;
   Status                = ErstAllocateNewRecord (&CperInfo, NULL);
 
   if (!EFI_ERROR (Status)) {
-    CperPI = (CPER_ERST_PERSISTENCE_INFO *)&Cper->PersistenceInfo;
-    if (CperPI->Status == ERST_RECORD_STATUS_INCOMING) {
+    if (CperStatus == ERST_RECORD_STATUS_INCOMING) {
       ASSERT (mErrorSerialization.IncomingCperInfo == NULL);
       mErrorSerialization.IncomingCperInfo = &mErrorSerialization.CperInfo[mErrorSerialization.RecordCount-1];
-    } else if (CperPI->Status == ERST_RECORD_STATUS_OUTGOING) {
+    } else if (CperStatus == ERST_RECORD_STATUS_OUTGOING) {
       ASSERT (mErrorSerialization.OutgoingCperInfo == NULL);
       mErrorSerialization.OutgoingCperInfo = &mErrorSerialization.CperInfo[mErrorSerialization.RecordCount-1];
     }
@@ -1641,6 +2076,271 @@ ErstAddCperToList (
   return Status;
 }
 
+EFI_STATUS
+EFIAPI
+ErstAddCperToList (
+  IN EFI_COMMON_ERROR_RECORD_HEADER  *Cper,
+  IN UINT32                          Offset
+  )
+{
+  CPER_ERST_PERSISTENCE_INFO  *CperPI;
+
+  CperPI = (CPER_ERST_PERSISTENCE_INFO *)&Cper->PersistenceInfo;
+  return ErstTrackRecord (Cper->RecordID, Cper->RecordLength, Offset, CperPI->Status);
+}
+
+// Finishes the block tracking once its records are collected, and erases it if nothing in it is needed
+STATIC
+EFI_STATUS
+ErstFinishCollectBlock (
+  IN ERST_BLOCK_INFO  *BlockInfo,
+  IN UINT32           Offset,
+  IN UINT8            LastStatus
+  )
+{
+  EFI_STATUS  Status;
+  BOOLEAN     ReclaimBlock = FALSE;
+
+  Status = EFI_SUCCESS;
+
+  if (LastStatus == ERST_RECORD_STATUS_INVALID) {
+    // INVALID, so other info isn't valid, and goes to the end of a block
+    ReclaimBlock           = TRUE;
+    BlockInfo->UsedSize   += BlockInfo->DataSize-Offset;
+    BlockInfo->WastedSize += BlockInfo->DataSize-Offset;
+  }
+
+  if (ReclaimBlock) {
+    // Mark for reclaim
+    BlockInfo->ValidEntries = -BlockInfo->ValidEntries;
+  }
+
+  if ((BlockInfo->ValidEntries == 0) &&
+      ((BlockInfo->UsedSize != 0) ||
+       ReclaimBlock))
+  {
+    Status = ErstEraseBlock (BlockInfo);
+  } else if (BlockInfo->DataSize - Offset < sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) {
+    BlockInfo->WastedSize += BlockInfo->DataSize - Offset;
+  }
+
+  return Status;
+}
+
+// Collects the block from its summary alone. Returns EFI_NOT_FOUND when the block has no active
+// summary and EFI_COMPROMISED_DATA when the summary doesn't validate, in which case nothing has
+// been tracked and the caller should fall back to ErstCollectBlock.
+EFI_STATUS
+EFIAPI
+ErstCollectBlockSummary (
+  IN ERST_BLOCK_INFO  *BlockInfo,
+  IN UINT32           Base,
+  IN UINT32           BlockNum
+  )
+{
+  EFI_STATUS                 Status;
+  ERST_BLOCK_SUMMARY_HEADER  *Header;
+  ERST_BLOCK_SUMMARY_ENTRY   *Entries;
+  ERST_BLOCK_SUMMARY_ENTRY   *Entry;
+  UINT8                      *Summary;
+  UINT8                      CperStatus;
+  UINT8                      LastStatus;
+  UINT32                     SummarySize;
+  UINT32                     Offset;
+  UINT16                     EntryCount;
+  UINT16                     Index;
+
+  Summary = NULL;
+
+  if (BlockInfo == NULL) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ReturnStatus;
+  }
+
+  BlockInfo->ValidEntries = 0;
+  BlockInfo->UsedSize     = 0;
+  BlockInfo->WastedSize   = 0;
+  BlockInfo->Base         = Base;
+  BlockInfo->DataSize     = mErrorSerialization.DataSize;
+  BlockInfo->SummaryCount = 0;
+  BlockInfo->HasSummary   = FALSE;
+
+  SummarySize = mErrorSerialization.BlockSize - mErrorSerialization.DataSize;
+  Summary     = ErstAllocatePoolBlock (SummarySize);
+  if (Summary == NULL) {
+    // GCOVR_EXCL_START - won't test allocation errors
+    DEBUG ((DEBUG_ERROR, "%a: Unable to allocate space for reading a block summary\n", __FUNCTION__));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ReturnStatus;
+    // GCOVR_EXCL_STOP
+  }
+
+  Status = ErstReadSpiNor (Summary, Base + mErrorSerialization.DataSize, SummarySize);
+  if (EFI_ERROR (Status)) {
+    goto ReturnStatus;
+  }
+
+  Header  = (ERST_BLOCK_SUMMARY_HEADER *)Summary;
+  Entries = (ERST_BLOCK_SUMMARY_ENTRY *)(Header + 1);
+  if ((Header->Signature != ERST_SUMMARY_SIGNATURE) ||
+      (Header->Version != ERST_SUMMARY_VERSION) ||
+      (Header->EntryCount != mErrorSerialization.SummaryEntries) ||
+      (Header->State != ERST_SUMMARY_STATE_ACTIVE))
+  {
+    DEBUG ((DEBUG_INFO, "%a: Block %u has no active summary\n", __FUNCTION__, BlockNum));
+    Status = EFI_NOT_FOUND;
+    goto ReturnStatus;
+  }
+
+  // Validate all the entries before tracking any of them
+  Offset     = 0;
+  LastStatus = ERST_RECORD_STATUS_FREE;
+  for (EntryCount = 0; EntryCount < mErrorSerialization.SummaryEntries; EntryCount++) {
+    Entry = &Entries[EntryCount];
+    if (IsErasedBuffer ((UINT8 *)Entry, sizeof (ERST_BLOCK_SUMMARY_ENTRY), 0xFF)) {
+      break;
+    }
+
+    // INCOMING and INVALID are always the last record in a block
+    if ((LastStatus == ERST_RECORD_STATUS_INCOMING) ||
+        (LastStatus == ERST_RECORD_STATUS_INVALID) ||
+        (Entry->RecordLength < sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) ||
+        (Entry->RecordLength > mErrorSerialization.DataSize - Offset))
+    {
+      Status = EFI_COMPROMISED_DATA;
+      goto SummaryMismatch;
+    }
+
+    switch (Entry->Status) {
+      case ERST_RECORD_STATUS_FREE:
+        // The entry is written before the record goes INCOMING and only follows it to VALID,
+        // so the record itself may be a step further along
+        Status = ErstReadSpiNor (
+                   &CperStatus,
+                   Base + Offset +
+                   OFFSET_OF (EFI_COMMON_ERROR_RECORD_HEADER, PersistenceInfo) +
+                   OFFSET_OF (CPER_ERST_PERSISTENCE_INFO, Status),
+                   1
+                   );
+        if (EFI_ERROR (Status)) {
+          // GCOVR_EXCL_START - can't test flash errors after the first read succeeds
+          goto ReturnStatus;
+          // GCOVR_EXCL_STOP
+        }
+
+        if (CperStatus == ERST_RECORD_STATUS_VALID) {
+          Entry->Status = ERST_RECORD_STATUS_VALID;
+          Status        = ErstWriteSpiNor (
+                            &Entry->Status,
+                            Base + mErrorSerialization.DataSize + (UINT32)((UINT8 *)&Entry->Status - Summary),
+                            1
+                            );
+          if (EFI_ERROR (Status)) {
+            // GCOVR_EXCL_START - can't test flash errors after the first read succeeds
+            goto ReturnStatus;
+            // GCOVR_EXCL_STOP
+          }
+        } else if ((CperStatus == ERST_RECORD_STATUS_FREE) ||
+                   (CperStatus == ERST_RECORD_STATUS_INCOMING))
+        {
+          Entry->Status = ERST_RECORD_STATUS_INCOMING;
+        } else {
+          Status = EFI_COMPROMISED_DATA;
+          goto SummaryMismatch;
+        }
+
+        break;
+
+      case ERST_RECORD_STATUS_VALID:
+      case ERST_RECORD_STATUS_OUTGOING:
+        if ((Entry->RecordId == ERST_FIRST_RECORD_ID) || (Entry->RecordId == ERST_INVALID_RECORD_ID)) {
+          Status = EFI_COMPROMISED_DATA;
+          goto SummaryMismatch;
+        }
+
+        break;
+
+      case ERST_RECORD_STATUS_DELETED:
+      case ERST_RECORD_STATUS_INVALID:
+        break;
+
+      default:
+        Status = EFI_COMPROMISED_DATA;
+        goto SummaryMismatch;
+    }
+
+    LastStatus = Entry->Status;
+    Offset    += Entry->RecordLength;
+  }
+
+  if (!IsErasedBuffer (
+         (UINT8 *)&Entries[EntryCount],
+         (mErrorSerialization.SummaryEntries - EntryCount) * sizeof (ERST_BLOCK_SUMMARY_ENTRY),
+         0xFF
+         ))
+  {
+    Status = EFI_COMPROMISED_DATA;
+    goto SummaryMismatch;
+  }
+
+  // The summary is good, so track its records the way ErstCollectBlock would
+  Offset = 0;
+  for (Index = 0; Index < EntryCount; Index++) {
+    Entry = &Entries[Index];
+    if ((Entry->Status == ERST_RECORD_STATUS_INCOMING) ||
+        (Entry->Status == ERST_RECORD_STATUS_INVALID))
+    {
+      break; // INCOMING/INVALID is the last entry in the block
+    }
+
+    if ((Entry->Status == ERST_RECORD_STATUS_VALID) ||
+        (Entry->Status == ERST_RECORD_STATUS_OUTGOING))
+    {
+      Status = ErstTrackRecord (Entry->RecordId, Entry->RecordLength, Base + Offset, Entry->Status);
+      if (EFI_ERROR (Status)) {
+        goto ReturnStatus;
+      }
+
+      BlockInfo->ValidEntries++;
+    } else {
+      BlockInfo->WastedSize += Entry->RecordLength;
+    }
+
+    BlockInfo->UsedSize += Entry->RecordLength;
+    Offset              += Entry->RecordLength;
+  }
+
+  if ((Index < EntryCount) && (Entry->Status == ERST_RECORD_STATUS_INCOMING)) {
+    Status = ErstTrackRecord (Entry->RecordId, Entry->RecordLength, Base + Offset, Entry->Status);
+    if (!EFI_ERROR (Status)) {
+      BlockInfo->ValidEntries++;
+      BlockInfo->UsedSize += BlockInfo->DataSize-Offset;
+    }
+  }
+
+  BlockInfo->SummaryCount = EntryCount;
+  BlockInfo->HasSummary   = TRUE;
+
+  // Done with the summary, and erasing below may need the block pool
+  ErstFreePoolBlock (Summary);
+  Summary = NULL;
+
+  Status = ErstFinishCollectBlock (BlockInfo, Offset, LastStatus);
+  goto ReturnStatus;
+
+SummaryMismatch:
+  DEBUG ((DEBUG_ERROR, "%a: Summary of block %u doesn't validate at entry %u\n", __FUNCTION__, BlockNum, EntryCount));
+
+ReturnStatus:
+  if (Summary != NULL) {
+    ErstFreePoolBlock (Summary);
+    Summary = NULL;
+  }
+
+  return Status;
+}
+
+// Reads the block with a single SPINOR access and walks its CPER headers in memory
 EFI_STATUS
 EFIAPI
 ErstCollectBlock (
@@ -1652,12 +2352,14 @@ ErstCollectBlock (
   EFI_STATUS                      Status;
   EFI_COMMON_ERROR_RECORD_HEADER  *Cper;
   CPER_ERST_PERSISTENCE_INFO      *CperPI;
+  ERST_BLOCK_SUMMARY_HEADER       *Header;
   UINT8                           *BlockData;
-  BOOLEAN                         ReclaimBlock = FALSE;
-  UINT32                          Offset       = 0;
+  UINT8                           LastStatus;
+  BOOLEAN                         HasHeader;
+  BOOLEAN                         AbandonSummary;
+  UINT32                          Offset = 0;
 
   BlockData = NULL;
-  Cper      = NULL;
 
   if (BlockInfo == NULL) {
     Status = EFI_INVALID_PARAMETER;
@@ -1668,46 +2370,43 @@ ErstCollectBlock (
   BlockInfo->UsedSize     = 0;
   BlockInfo->WastedSize   = 0;
   BlockInfo->Base         = Base;
+  BlockInfo->SummaryCount = 0;
+  BlockInfo->HasSummary   = FALSE;
 
-  Cper = (EFI_COMMON_ERROR_RECORD_HEADER *)ErstAllocatePoolCperHeader (sizeof (EFI_COMMON_ERROR_RECORD_HEADER));
-  if (Cper == NULL) {
+  BlockData = ErstAllocatePoolBlock (mErrorSerialization.BlockSize);
+  if (BlockData == NULL) {
     // GCOVR_EXCL_START - won't test allocation errors
-    DEBUG ((DEBUG_ERROR, "%a: Unable to allocate space for reading a CPER header\n", __FUNCTION__));
+    DEBUG ((DEBUG_ERROR, "%a: Unable to allocate space for reading a block\n", __FUNCTION__));
     Status = EFI_OUT_OF_RESOURCES;
     goto ReturnStatus;
     // GCOVR_EXCL_STOP
   }
 
-  do {
-    Status = ErstReadSpiNor (Cper, Base + Offset, sizeof (EFI_COMMON_ERROR_RECORD_HEADER));
-    if (EFI_ERROR (Status)) {
-      goto ReturnStatus;
-    }
+  // One read per block instead of one read per CPER header plus one for the FREE space
+  Status = ErstReadSpiNor (BlockData, Base, mErrorSerialization.BlockSize);
+  if (EFI_ERROR (Status)) {
+    goto ReturnStatus;
+  }
+
+  // Blocks erased by this driver end with a summary, older ones use the whole block for records
+  Header    = (ERST_BLOCK_SUMMARY_HEADER *)(BlockData + mErrorSerialization.DataSize);
+  HasHeader = ((Header->Signature == ERST_SUMMARY_SIGNATURE) &&
+               (Header->Version == ERST_SUMMARY_VERSION) &&
+               (Header->EntryCount == mErrorSerialization.SummaryEntries));
+  AbandonSummary      = HasHeader && (Header->State != ERST_SUMMARY_STATE_ABANDONED);
+  BlockInfo->DataSize = HasHeader ? mErrorSerialization.DataSize : mErrorSerialization.BlockSize;
 
+  do {
+    Cper   = (EFI_COMMON_ERROR_RECORD_HEADER *)(BlockData + Offset);
     CperPI = (CPER_ERST_PERSISTENCE_INFO *)&Cper->PersistenceInfo;
 
     // FREE space doesn't have a valid header, and only comes at the end of a block
     if (CperPI->Status == ERST_RECORD_STATUS_FREE) {
       // verify that the rest of the space actually is free
-      BlockData = ErstAllocatePoolBlock (mErrorSerialization.BlockSize);
-      if (BlockData == NULL) {
-        Status = EFI_OUT_OF_RESOURCES;
-        DEBUG ((DEBUG_ERROR, "%a: Unable to allocate space for reading a block\n", __FUNCTION__));
-        goto ReturnStatus;
-      }
-
-      Status = ErstReadSpiNor (BlockData, Base + Offset, mErrorSerialization.BlockSize-Offset);
-      if (EFI_ERROR (Status)) {
-        goto ReturnStatus;
-      }
-
-      if (!IsErasedBuffer (BlockData, mErrorSerialization.BlockSize-Offset, 0xFF)) {
+      if (!IsErasedBuffer (BlockData + Offset, BlockInfo->DataSize-Offset, 0xFF)) {
         CperPI->Status = ERST_RECORD_STATUS_INVALID;
       }
 
-      ErstFreePoolBlock (BlockData);
-      BlockData = NULL;
-
       break; // FREE/INVALID is last entry in block
     }
 
@@ -1717,7 +2416,7 @@ ErstCollectBlock (
       Status = ErstAddCperToList (Cper, Base + Offset);
       if (!EFI_ERROR (Status)) {
         BlockInfo->ValidEntries++;
-        BlockInfo->UsedSize += mErrorSerialization.BlockSize-Offset;
+        BlockInfo->UsedSize += BlockInfo->DataSize-Offset;
       }
 
       break; // INCOMING is last entry in block
@@ -1761,40 +2460,31 @@ ErstCollectBlock (
     }
 
     Offset += Cper->RecordLength;
-  } while (Offset < (mErrorSerialization.BlockSize - sizeof (EFI_COMMON_ERROR_RECORD_HEADER)));
+  } while (Offset < (BlockInfo->DataSize - sizeof (EFI_COMMON_ERROR_RECORD_HEADER)));
 
-  if (CperPI->Status == ERST_RECORD_STATUS_INVALID) {
-    // INVALID, so other info isn't valid, and goes to the end of a block
-    ReclaimBlock           = TRUE;
-    BlockInfo->UsedSize   += mErrorSerialization.BlockSize-Offset;
-    BlockInfo->WastedSize += mErrorSerialization.BlockSize-Offset;
-  }
+  // Done with the block contents, and erasing below may need the block pool
+  LastStatus = CperPI->Status;
+  ErstFreePoolBlock (BlockData);
+  BlockData = NULL;
 
-  if (ReclaimBlock) {
-    // Mark for reclaim
-    BlockInfo->ValidEntries = -BlockInfo->ValidEntries;
+  // A summary that had to be scanned past can't be trusted from now on
+  if (AbandonSummary) {
+    ErstAbandonSummary (BlockInfo);
   }
 
-  if ((BlockInfo->ValidEntries == 0) &&
-      ((BlockInfo->UsedSize != 0) ||
-       ReclaimBlock))
-  {
-    Status = ErstEraseBlock (BlockInfo);
-    if (EFI_ERROR (Status)) {
-      // GCOVR_EXCL_START - can't test failing flash access after the first one succeeds
-      goto ReturnStatus;
-      // GCOVR_EXCL_STOP
-    }
-  } else if (mErrorSerialization.BlockSize - Offset < sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) {
-    BlockInfo->WastedSize += mErrorSerialization.BlockSize - Offset;
+  Status = ErstFinishCollectBlock (BlockInfo, Offset, LastStatus);
+  if (EFI_ERROR (Status)) {
+    // GCOVR_EXCL_START - can't test failing flash access after the first one succeeds
+    goto ReturnStatus;
+    // GCOVR_EXCL_STOP
   }
 
-ReturnStatus:
-  if (Cper) {
-    ErstFreePoolCperHeader (Cper);
-    Cper = NULL;
+  // An older block that turns out to be empty gets its summary header with its first record
+  if (!HasHeader && !BlockInfo->HasSummary && (BlockInfo->UsedSize == 0) && (LastStatus == ERST_RECORD_STATUS_FREE)) {
+    ErstStartSummary (BlockInfo);
   }
 
+ReturnStatus:
   if (BlockData) {
     ErstFreePoolBlock (BlockData);
     BlockData = NULL;
@@ -1887,7 +2577,7 @@ ErstCopyOutgoingToIncomingCper (
     // GCOVR_EXCL_STOP
   }
 
-  RemainingBlockSize = mErrorSerialization.BlockSize - ((IncomingCperInfo->RecordOffset - IncomingBlockInfo->Base) + OutgoingCperInfo->RecordLength);
+  RemainingBlockSize = IncomingBlockInfo->DataSize - ((IncomingCperInfo->RecordOffset - IncomingBlockInfo->Base) + OutgoingCperInfo->RecordLength);
   if (RemainingBlockSize > 0) {
     Space = ErstAllocatePoolBlock (RemainingBlockSize);
     if (Space == NULL) {
@@ -2010,9 +2700,13 @@ ErstCollectBlockInfo (
   ERST_CPER_INFO   *CperInfo;
   ERST_BLOCK_INFO  *BlockInfo;
 
-  // Get ERST block info
+  // Get ERST block info, only reading whole blocks when they don't have a usable summary
   for (BlockNum = 0; BlockNum < mErrorSerialization.NumBlocks; BlockNum++) {
-    Status = ErstCollectBlock (&ErstBlockInfo[BlockNum], BlockNum * mErrorSerialization.BlockSize, BlockNum);
+    Status = ErstCollectBlockSummary (&ErstBlockInfo[BlockNum], BlockNum * mErrorSerialization.BlockSize, BlockNum);
+    if ((Status == EFI_NOT_FOUND) || (Status == EFI_COMPROMISED_DATA)) {
+      Status = ErstCollectBlock (&ErstBlockInfo[BlockNum], BlockNum * mErrorSerialization.BlockSize, BlockNum);
+    }
+
     if (EFI_ERROR (Status)) {
       goto ReturnStatus;
     }
@@ -2217,6 +2911,12 @@ ErrorSerializationInitProtocol (
 
   mErrorSerialization.MaxRecords = mErrorSerialization.BlockSize*(mErrorSerialization.NumBlocks-1)/sizeof (ERST_CPER_INFO);
 
+  // Each block ends with a summary of its records, so init doesn't need to read whole blocks.
+  // It has an entry for every minimum-sized record, so it can't fill up before the block does.
+  mErrorSerialization.SummaryEntries = mErrorSerialization.BlockSize/sizeof (EFI_COMMON_ERROR_RECORD_HEADER) - 1;
+  mErrorSerialization.DataSize       = mErrorSerialization.BlockSize - sizeof (ERST_BLOCK_SUMMARY_HEADER) -
+                                       mErrorSerialization.SummaryEntries * sizeof (ERST_BLOCK_SUMMARY_ENTRY);
+
   Status = ErstPreAllocateRuntimeMemory (mErrorSerialization.BlockSize, mErrorSerialization.BufferInfo.ErrorLogInfo.Length);
   if (EFI_ERROR (Status)) {
     DEBUG ((
@@ -21,6 +21,9 @@
 
 #define ERST_MIN_BLOCK_SIZE  SIZE_16KB
 
+#define ERST_SUMMARY_SIGNATURE  SIGNATURE_32( 'E', 'R', 'S', 'M' )
+#define ERST_SUMMARY_VERSION    1
+
 #define MAX_NORFLASH_HANDLES  8
 
 #define ERST_SIZE_ASSERT(TypeName, ExpectedSize)          \
@@ -33,10 +36,13 @@
 extern EFI_GUID  gNVIDIAErrorSerializationProtocolGuid;
 
 typedef struct {
-  INT32     ValidEntries;
-  UINT32    UsedSize;
-  UINT32    WastedSize;
-  UINT32    Base;
+  INT32      ValidEntries;
+  UINT32     UsedSize;
+  UINT32     WastedSize;
+  UINT32     Base;
+  UINT32     DataSize;     // Space for records, the rest of the block holds the summary
+  UINT16     SummaryCount; // Number of entries written to the block summary
+  BOOLEAN    HasSummary;   // The block summary is kept up to date with the records
 } ERST_BLOCK_INFO;
 
 typedef struct {
@@ -68,6 +74,30 @@ typedef enum {
   ERST_RECORD_STATUS_INVALID  = 0x00
 } ERST_RECORD_STATUS;
 
+typedef enum {
+  ERST_SUMMARY_STATE_ACTIVE    = 0xFF,
+  ERST_SUMMARY_STATE_ABANDONED = 0x00
+} ERST_SUMMARY_STATE;
+
+// Start of the summary at the end of each ERST block, followed by the entries
+typedef struct {
+  UINT32    Signature;
+  UINT8     Version;
+  UINT8     State;
+  UINT16    EntryCount;
+  UINT8     Reserved[8];
+} ERST_BLOCK_SUMMARY_HEADER;
+ERST_SIZE_ASSERT (ERST_BLOCK_SUMMARY_HEADER, 16);
+
+// One entry per record in the block, in the order the records were written
+typedef struct {
+  UINT64    RecordId;
+  UINT32    RecordLength;
+  UINT8     Status;
+  UINT8     Reserved[3];
+} ERST_BLOCK_SUMMARY_ENTRY;
+ERST_SIZE_ASSERT (ERST_BLOCK_SUMMARY_ENTRY, 16);
+
 typedef struct {
   EFI_HANDLE                   Handle;                // Handle for ERST protocol
   NVIDIA_NOR_FLASH_PROTOCOL    *NorFlashProtocol;     // Protocol for writing the SPINOR
@@ -75,6 +105,8 @@ typedef struct {
   UINT32                       NorErstOffset;         // Offset to the start of the ERST region in the SPINOR
   UINT32                       BlockSize;             // Virtual block size
   UINT32                       NumBlocks;             // Number of Virtual Blocks
+  UINT32                       DataSize;              // Space for records in a block that has a summary
+  UINT16                       SummaryEntries;        // Number of entries in a block summary
   UINT32                       MaxRecords;            // Maximum number of records that can be stored
   UINT32                       RecordCount;           // Count of valid records on SPINOR
   UINT16                       MostRecentBlock;       // Index of most recently-written SPINOR block
@@ -190,6 +222,26 @@ ErstReadRecord (
   IN UINT64                          MaxLength
   );
 
+// Read consecutive records, starting with RecordID, back to back into Buffer
+EFI_STATUS
+EFIAPI
+ErstReadRecordBatch (
+  IN     UINT64             RecordID,
+  IN OUT ERST_BATCH_HEADER  *Batch,
+  OUT    UINT8              *Buffer,
+  IN     UINT64             MaxLength,
+  OUT    UINT64             *NextRecordID
+  );
+
+// Clear consecutive records, starting with RecordID
+EFI_STATUS
+EFIAPI
+ErstClearRecordBatch (
+  IN     UINT64             RecordID,
+  IN OUT ERST_BATCH_HEADER  *Batch,
+  OUT    UINT64             *NextRecordID
+  );
+
 EFI_STATUS
 EFIAPI
 ErstCopyOutgoingToIncomingCper (
@@ -210,6 +262,14 @@ ErstCollectBlock (
   IN UINT32           BlockNum
   );
 
+EFI_STATUS
+EFIAPI
+ErstCollectBlockSummary (
+  IN ERST_BLOCK_INFO  *BlockInfo,
+  IN UINT32           Base,
+  IN UINT32           BlockNum
+  );
+
 EFI_STATUS
 EFIAPI
 ErstCollectBlockInfo (
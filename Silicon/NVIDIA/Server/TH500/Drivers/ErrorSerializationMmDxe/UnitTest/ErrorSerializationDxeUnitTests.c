@@ -46,6 +46,11 @@ STATIC   STMM_COMM_BUFFERS_DATA  StmmCommBuffersData;
 #define ERROR_LOG_INFO_BUFFER_SIZE  SIZE_16KB
 #define ERST_BUFFER_SIZE            (sizeof(ERST_COMM_STRUCT) + ERROR_LOG_INFO_BUFFER_SIZE)
 
+#define BATCH_TEST_RECORDS       1000
+#define BATCH_TEST_PAYLOAD_SIZE  0x10
+#define BATCH_TEST_RECORD_SIZE   (sizeof (EFI_COMMON_ERROR_RECORD_HEADER) + BATCH_TEST_PAYLOAD_SIZE)
+#define BATCH_TEST_BUFFER_SIZE   ((ERROR_LOG_INFO_BUFFER_SIZE - sizeof (ERST_BATCH_HEADER)) / BATCH_TEST_RECORD_SIZE * BATCH_TEST_RECORD_SIZE)
+
 void
 PrintCper (
   EFI_COMMON_ERROR_RECORD_HEADER  *Cper,
@@ -128,7 +133,7 @@ STATIC CONST UINT32  PayloadSizes[MAX_PAYLOAD_SIZES] = {
   24,
   245,
   256,
-  3096,
+  2328,
   1,
   78,
   129,
@@ -919,6 +924,89 @@ GetLastEntryCperInfo (
   return LastEntryCperInfo;
 }
 
+// The tests below edit records directly in the flash to simulate a reset part way through an update.
+// The driver updates a block's summary before the record itself, so rewrite the active summaries to
+// match the records, the way they would have been when the reset happened.
+VOID
+SyncSummaries (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  COMMON_TEST_CONTEXT             *TestInfo;
+  ERST_BLOCK_SUMMARY_HEADER       *Header;
+  ERST_BLOCK_SUMMARY_ENTRY        *Entries;
+  EFI_COMMON_ERROR_RECORD_HEADER  *Cper;
+  CPER_ERST_PERSISTENCE_INFO      *CperPI;
+  UINT8                           *Block;
+  UINT32                          BlockNum;
+  UINT32                          Offset;
+  UINT16                          EntryIndex;
+
+  TestInfo = (COMMON_TEST_CONTEXT *)Context;
+  for (BlockNum = 0; BlockNum < mErrorSerialization.NumBlocks; BlockNum++) {
+    Block   = TestFlashStorage + TestInfo->ErstOffset + BlockNum * mErrorSerialization.BlockSize;
+    Header  = (ERST_BLOCK_SUMMARY_HEADER *)(Block + mErrorSerialization.DataSize);
+    Entries = (ERST_BLOCK_SUMMARY_ENTRY *)(Header + 1);
+    if ((Header->Signature != ERST_SUMMARY_SIGNATURE) || (Header->State != ERST_SUMMARY_STATE_ACTIVE)) {
+      continue;
+    }
+
+    SetMem (Entries, mErrorSerialization.SummaryEntries * sizeof (ERST_BLOCK_SUMMARY_ENTRY), 0xFF);
+    Offset     = 0;
+    EntryIndex = 0;
+    while ((Offset + sizeof (EFI_COMMON_ERROR_RECORD_HEADER) <= mErrorSerialization.DataSize) &&
+           (EntryIndex < mErrorSerialization.SummaryEntries))
+    {
+      Cper   = (EFI_COMMON_ERROR_RECORD_HEADER *)(Block + Offset);
+      CperPI = (CPER_ERST_PERSISTENCE_INFO *)&Cper->PersistenceInfo;
+      if (CperPI->Status == ERST_RECORD_STATUS_FREE) {
+        break;
+      }
+
+      // An incoming record's entry is written before the record, with its status left erased
+      Entries[EntryIndex].RecordId     = Cper->RecordID;
+      Entries[EntryIndex].RecordLength = Cper->RecordLength;
+      Entries[EntryIndex].Status       = (CperPI->Status == ERST_RECORD_STATUS_INCOMING) ? ERST_RECORD_STATUS_FREE : CperPI->Status;
+      EntryIndex++;
+      if ((CperPI->Status == ERST_RECORD_STATUS_INCOMING) ||
+          (CperPI->Status == ERST_RECORD_STATUS_INVALID) ||
+          (Cper->RecordLength < sizeof (EFI_COMMON_ERROR_RECORD_HEADER)))
+      {
+        break;
+      }
+
+      Offset += Cper->RecordLength;
+    }
+  }
+}
+
+// A block is erased if everything but the summary header is erased, and the header is
+// either erased or the empty summary written after erasing the block
+BOOLEAN
+IsBlockErased (
+  IN UINT8  *Block
+  )
+{
+  ERST_BLOCK_SUMMARY_HEADER  *Header;
+
+  Header = (ERST_BLOCK_SUMMARY_HEADER *)(Block + mErrorSerialization.DataSize);
+  if (!IsBufferValue (Block, mErrorSerialization.DataSize, 0xFF) ||
+      !IsBufferValue ((UINT8 *)(Header + 1), mErrorSerialization.SummaryEntries * sizeof (ERST_BLOCK_SUMMARY_ENTRY), 0xFF))
+  {
+    return FALSE;
+  }
+
+  if (IsBufferValue ((UINT8 *)Header, sizeof (*Header), 0xFF)) {
+    return TRUE;
+  }
+
+  return (Header->Signature == ERST_SUMMARY_SIGNATURE) &&
+         (Header->Version == ERST_SUMMARY_VERSION) &&
+         (Header->State == ERST_SUMMARY_STATE_ACTIVE) &&
+         (Header->EntryCount == mErrorSerialization.SummaryEntries) &&
+         IsBufferValue (Header->Reserved, sizeof (Header->Reserved), 0xFF);
+}
+
 UNIT_TEST_STATUS
 SanityCheckTracking (
   IN UNIT_TEST_CONTEXT  Context
@@ -929,10 +1017,13 @@ SanityCheckTracking (
   CPER_ERST_PERSISTENCE_INFO      *CperPI;
   ERST_COMM_STRUCT                *ErstComm;
   COMMON_TEST_CONTEXT             *TestInfo;
+  ERST_BLOCK_INFO                 *BlockInfo;
+  ERST_BLOCK_SUMMARY_ENTRY        *Entries;
   UINT32                          BlockOffset;
   UINT32                          BlockSizeLeft;
   UINT32                          RecordCount;
   UINT32                          BlockNum;
+  UINT32                          EntryIndex;
 
   TestInfo = (COMMON_TEST_CONTEXT *)Context;
   ErstComm = (ERST_COMM_STRUCT *)TestErstBuffer;
@@ -941,15 +1032,34 @@ SanityCheckTracking (
 
   // Read the flash and compare it to the tracking information
   BlockOffset   = 0;
-  BlockSizeLeft = mErrorSerialization.BlockSize;
   BlockNum      = 0;
+  BlockInfo     = &mErrorSerialization.BlockInfo[BlockNum];
+  BlockSizeLeft = BlockInfo->DataSize;
+  EntryIndex    = 0;
   RecordCount   = 0;
   do {
-    Cper   = (EFI_COMMON_ERROR_RECORD_HEADER *)(TestFlashStorage + TestInfo->ErstOffset + BlockOffset);
-    CperPI = (CPER_ERST_PERSISTENCE_INFO *)&Cper->PersistenceInfo;
+    Cper    = (EFI_COMMON_ERROR_RECORD_HEADER *)(TestFlashStorage + TestInfo->ErstOffset + BlockOffset);
+    CperPI  = (CPER_ERST_PERSISTENCE_INFO *)&Cper->PersistenceInfo;
+    Entries = (ERST_BLOCK_SUMMARY_ENTRY *)(TestFlashStorage + TestInfo->ErstOffset + BlockInfo->Base + mErrorSerialization.DataSize +
+                                           sizeof (ERST_BLOCK_SUMMARY_HEADER));
 
     DEBUG ((DEBUG_INFO, "Checking ID 0x%llx with status 0x%x\n", Cper->RecordID, CperPI->Status));
 
+    // The summary has an entry for each record in its block, which is never behind the record itself
+    if (BlockInfo->HasSummary &&
+        (CperPI->Status != ERST_RECORD_STATUS_FREE) &&
+        (CperPI->Status != ERST_RECORD_STATUS_INVALID))
+    {
+      UT_ASSERT_TRUE (EntryIndex < BlockInfo->SummaryCount);
+      UT_ASSERT_EQUAL (Entries[EntryIndex].RecordLength, Cper->RecordLength);
+      if (CperPI->Status != ERST_RECORD_STATUS_INCOMING) {
+        UT_ASSERT_EQUAL (Entries[EntryIndex].RecordId, Cper->RecordID);
+      }
+
+      UT_ASSERT_EQUAL (Entries[EntryIndex].Status & CperPI->Status, CperPI->Status);
+      EntryIndex++;
+    }
+
     switch (CperPI->Status) {
       case ERST_RECORD_STATUS_FREE:
         // Free space should fill the rest of the block
@@ -1032,9 +1142,18 @@ SanityCheckTracking (
 
     // Go to next block if not enough space for another header
     if (BlockSizeLeft < sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) {
-      BlockOffset += BlockSizeLeft;
+      if (BlockInfo->HasSummary && (CperPI->Status != ERST_RECORD_STATUS_INVALID)) {
+        UT_ASSERT_EQUAL (EntryIndex, BlockInfo->SummaryCount);
+        UT_ASSERT_TRUE (IsBufferValue ((UINT8 *)&Entries[EntryIndex], (mErrorSerialization.SummaryEntries - EntryIndex) * sizeof (ERST_BLOCK_SUMMARY_ENTRY), 0xFF));
+      }
+
       BlockNum++;
-      BlockSizeLeft = mErrorSerialization.BlockSize;
+      BlockOffset = BlockNum * mErrorSerialization.BlockSize;
+      if (BlockNum < mErrorSerialization.NumBlocks) {
+        BlockInfo     = &mErrorSerialization.BlockInfo[BlockNum];
+        BlockSizeLeft = BlockInfo->DataSize;
+        EntryIndex    = 0;
+      }
     }
   } while (BlockNum < mErrorSerialization.NumBlocks);
 
@@ -1457,7 +1576,7 @@ E2ESimpleFillTest (
   UT_ASSERT_EQUAL (mErrorSerialization.UnsyncedSpinorChanges, 0);
 
   RemainingBlocks      = ErstSize/mErrorSerialization.BlockSize;
-  RemainingSizeInBlock = mErrorSerialization.BlockSize;
+  RemainingSizeInBlock = mErrorSerialization.DataSize;
   RecordId             = SizeIndex + ErstSize; // Pseudo-random value
 
   while (RemainingBlocks > 1) {
@@ -1481,7 +1600,7 @@ E2ESimpleFillTest (
     }
 
     RemainingBlocks--;
-    RemainingSizeInBlock = mErrorSerialization.BlockSize;
+    RemainingSizeInBlock = mErrorSerialization.DataSize;
   }
 
   //  DEBUG ((DEBUG_INFO, "Remaining blocks: %d RemainingSizeInBlock: 0x%x\n", RemainingBlocks, RemainingSizeInBlock));
@@ -1816,6 +1935,159 @@ E2EClear (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  End2End batch test: writes many small records, then drains them with
+  READ_BATCH and removes them with a single CLEAR_BATCH
+
+  @param Context                      Used for the offsets and status value
+
+  @retval UNIT_TEST_PASSED            All assertions passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED An assertion failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+E2EBatchDrainTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ERST_COMM_STRUCT                *ErstComm;
+  ERST_BATCH_HEADER               *Batch;
+  EFI_COMMON_ERROR_RECORD_HEADER  *Cper;
+  UINT8                           *Payload;
+  UINT8                           *Expected;
+  UINT64                          RecordId;
+  UINT64                          NextRecordId;
+  UINT32                          Offset;
+  UINT32                          Index;
+  UINT32                          RecordsRead;
+  UINT32                          Calls;
+
+  ErstComm = (ERST_COMM_STRUCT *)TestErstBuffer;
+
+  for (RecordId = 1; RecordId <= BATCH_TEST_RECORDS; RecordId++) {
+    E2EWrite (
+      Context,
+      RecordId,
+      0,
+      BATCH_TEST_PAYLOAD_SIZE,
+      (UINT8)RecordId,
+      EFI_ACPI_6_4_ERST_STATUS_SUCCESS
+      );
+  }
+
+  UT_ASSERT_EQUAL (mErrorSerialization.RecordCount, BATCH_TEST_RECORDS);
+
+  // Should fail a batch that has an offset too large for the batch header
+  ErstComm->Operation    = ERST_OPERATION_READ_BATCH;
+  ErstComm->RecordOffset = ERROR_LOG_INFO_BUFFER_SIZE - sizeof (ERST_BATCH_HEADER) + 1;
+  ErstComm->RecordID     = ERST_FIRST_RECORD_ID;
+  MmioWrite32 (0, 0);
+  ErrorSerializationEventHandler (NULL, NULL, NULL, NULL);
+  UT_ASSERT_EQUAL (MmioRead32 (0), 1);
+  UT_ASSERT_STATUS_EQUAL (GetStatus (ErstComm), EFI_ACPI_6_4_ERST_STATUS_NOT_ENOUGH_SPACE);
+
+  Expected = AllocatePool (BATCH_TEST_PAYLOAD_SIZE);
+  UT_ASSERT_NOT_NULL (Expected);
+
+  // Drain every record, each call returning as many records as fit in the buffer
+  Batch        = (ERST_BATCH_HEADER *)ErstComm->ErrorLogAddressRange.PhysicalBase;
+  NextRecordId = ERST_FIRST_RECORD_ID;
+  RecordsRead  = 0;
+  Calls        = 0;
+  do {
+    Batch->Count           = 0;
+    Batch->Length          = 0;
+    Batch->LastRecordID    = ERST_INVALID_RECORD_ID;
+    ErstComm->Operation    = ERST_OPERATION_READ_BATCH;
+    ErstComm->RecordOffset = 0;
+    ErstComm->RecordID     = NextRecordId;
+    MmioWrite32 (0, 0);
+    ErrorSerializationEventHandler (NULL, NULL, NULL, NULL);
+    UT_ASSERT_EQUAL (MmioRead32 (0), 1);
+    UT_ASSERT_STATUS_EQUAL (GetStatus (ErstComm), EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+    UT_ASSERT_TRUE (Batch->Count > 0);
+    UT_ASSERT_EQUAL (Batch->Length, Batch->Count * BATCH_TEST_RECORD_SIZE);
+    Calls++;
+
+    Offset = 0;
+    for (Index = 0; Index < Batch->Count; Index++) {
+      RecordsRead++;
+      Cper    = (EFI_COMMON_ERROR_RECORD_HEADER *)((UINT8 *)(Batch + 1) + Offset);
+      Payload = (UINT8 *)(Cper + 1);
+      SetMem (Expected, BATCH_TEST_PAYLOAD_SIZE, (UINT8)RecordsRead);
+      UT_ASSERT_EQUAL (Cper->RecordID, RecordsRead);
+      UT_ASSERT_EQUAL (Cper->RecordLength, BATCH_TEST_RECORD_SIZE);
+      UT_ASSERT_MEM_EQUAL (Payload, Expected, BATCH_TEST_PAYLOAD_SIZE);
+      Offset += Cper->RecordLength;
+    }
+
+    NextRecordId = ErstComm->RecordID;
+  } while (NextRecordId != ERST_INVALID_RECORD_ID);
+
+  FreePool (Expected);
+
+  UT_ASSERT_EQUAL (RecordsRead, BATCH_TEST_RECORDS);
+  UT_ASSERT_EQUAL (
+    Calls,
+    (BATCH_TEST_RECORDS * BATCH_TEST_RECORD_SIZE + BATCH_TEST_BUFFER_SIZE - 1) / BATCH_TEST_BUFFER_SIZE
+    );
+
+  // A limited read stops at the requested count
+  Batch->Count           = 2;
+  Batch->Length          = 0;
+  Batch->LastRecordID    = ERST_INVALID_RECORD_ID;
+  ErstComm->Operation    = ERST_OPERATION_READ_BATCH;
+  ErstComm->RecordOffset = 0;
+  ErstComm->RecordID     = 10;
+  MmioWrite32 (0, 0);
+  ErrorSerializationEventHandler (NULL, NULL, NULL, NULL);
+  UT_ASSERT_EQUAL (MmioRead32 (0), 1);
+  UT_ASSERT_STATUS_EQUAL (GetStatus (ErstComm), EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+  UT_ASSERT_EQUAL (Batch->Count, 2);
+  UT_ASSERT_EQUAL (ErstComm->RecordID, 12);
+
+  // Clear up to and including record 10
+  Batch->Count           = 0;
+  Batch->LastRecordID    = 10;
+  ErstComm->Operation    = ERST_OPERATION_CLEAR_BATCH;
+  ErstComm->RecordOffset = 0;
+  ErstComm->RecordID     = ERST_FIRST_RECORD_ID;
+  MmioWrite32 (0, 0);
+  ErrorSerializationEventHandler (NULL, NULL, NULL, NULL);
+  UT_ASSERT_EQUAL (MmioRead32 (0), 1);
+  UT_ASSERT_STATUS_EQUAL (GetStatus (ErstComm), EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+  UT_ASSERT_EQUAL (Batch->Count, 10);
+  UT_ASSERT_EQUAL (ErstComm->RecordID, 11);
+  UT_ASSERT_EQUAL (mErrorSerialization.RecordCount, BATCH_TEST_RECORDS - 10);
+  UT_ASSERT_TRUE (ErstFindRecord (10) == NULL);
+
+  // Clear the rest with a single call
+  Batch->Count           = 0;
+  Batch->LastRecordID    = ERST_INVALID_RECORD_ID;
+  ErstComm->Operation    = ERST_OPERATION_CLEAR_BATCH;
+  ErstComm->RecordOffset = 0;
+  ErstComm->RecordID     = ERST_FIRST_RECORD_ID;
+  MmioWrite32 (0, 0);
+  ErrorSerializationEventHandler (NULL, NULL, NULL, NULL);
+  UT_ASSERT_EQUAL (MmioRead32 (0), 1);
+  UT_ASSERT_STATUS_EQUAL (GetStatus (ErstComm), EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+  UT_ASSERT_EQUAL (Batch->Count, BATCH_TEST_RECORDS - 10);
+  UT_ASSERT_EQUAL (ErstComm->RecordID, ERST_INVALID_RECORD_ID);
+  UT_ASSERT_EQUAL (mErrorSerialization.RecordCount, 0);
+
+  // Nothing left to read
+  ErstComm->Operation    = ERST_OPERATION_READ_BATCH;
+  ErstComm->RecordOffset = 0;
+  ErstComm->RecordID     = ERST_FIRST_RECORD_ID;
+  MmioWrite32 (0, 0);
+  ErrorSerializationEventHandler (NULL, NULL, NULL, NULL);
+  UT_ASSERT_EQUAL (MmioRead32 (0), 1);
+  UT_ASSERT_STATUS_EQUAL (GetStatus (ErstComm), EFI_ACPI_6_4_ERST_STATUS_RECORD_STORE_EMPTY);
+
+  return SanityCheckTracking (Context);
+}
+
 /**
   End2End Write, Read, Clear test
 
@@ -1850,7 +2122,7 @@ E2EWriteReadClearTest (
 
   // Since we recover cleared blocks,  we should never run out
   RemainingBlocks      = 2*ErstSize/mErrorSerialization.BlockSize;
-  RemainingSizeInBlock = mErrorSerialization.BlockSize;
+  RemainingSizeInBlock = mErrorSerialization.DataSize;
   RecordId             = SizeIndex + ErstSize; // Pseudo-random value
 
   while (RemainingBlocks > 0) {
@@ -1890,7 +2162,7 @@ E2EWriteReadClearTest (
     }
 
     RemainingBlocks--;
-    RemainingSizeInBlock = mErrorSerialization.BlockSize;
+    RemainingSizeInBlock = mErrorSerialization.DataSize;
   }
 
   //  DEBUG ((DEBUG_INFO, "Remaining blocks: %d RemainingSizeInBlock: 0x%x\n", RemainingBlocks, RemainingSizeInBlock));
@@ -2073,12 +2345,12 @@ E2ESimpleReadTest (
   UT_ASSERT_EQUAL (mErrorSerialization.UnsyncedSpinorChanges, 0);
 
   RemainingBlocks      = ErstSize/mErrorSerialization.BlockSize;
-  RemainingSizeInBlock = mErrorSerialization.BlockSize;
+  RemainingSizeInBlock = mErrorSerialization.DataSize;
   RecordId             = SizeIndex + ErstSize; // Pseudo-random value
 
   //  DEBUG ((DEBUG_INFO, "Reading Flash\n"));
   while (RemainingBlocks > 1) {
-    while (RemainingSizeInBlock >= PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES]) {
+    while (RemainingSizeInBlock >= (PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES] + sizeof (EFI_COMMON_ERROR_RECORD_HEADER))) {
       //      DEBUG ((DEBUG_INFO, "Remaining blocks: %d RemainingSizeInBlock: 0x%x\n", RemainingBlocks, RemainingSizeInBlock));
       PayloadSize  = PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES];
       OffsetMax    = ERROR_LOG_INFO_BUFFER_SIZE - PayloadSize - sizeof (EFI_COMMON_ERROR_RECORD_HEADER);
@@ -2098,7 +2370,7 @@ E2ESimpleReadTest (
     }
 
     RemainingBlocks--;
-    RemainingSizeInBlock = mErrorSerialization.BlockSize;
+    RemainingSizeInBlock = mErrorSerialization.DataSize;
   }
 
   //  DEBUG ((DEBUG_INFO, "Remaining blocks: %d RemainingSizeInBlock: 0x%x\n", RemainingBlocks, RemainingSizeInBlock));
@@ -2165,12 +2437,12 @@ E2ESimpleRecoveryReadTest (
   UT_ASSERT_STATUS_EQUAL (UTStatus, UNIT_TEST_PASSED);
 
   RemainingBlocks      = ErstSize/mErrorSerialization.BlockSize;
-  RemainingSizeInBlock = mErrorSerialization.BlockSize;
+  RemainingSizeInBlock = mErrorSerialization.DataSize;
   RecordId             = SizeIndex + ErstSize; // Pseudo-random value
 
   //  DEBUG ((DEBUG_INFO, "Reading Flash\n"));
   while (RemainingBlocks > 1) {
-    while (RemainingSizeInBlock >= PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES]) {
+    while (RemainingSizeInBlock >= (PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES] + sizeof (EFI_COMMON_ERROR_RECORD_HEADER))) {
       //      DEBUG ((DEBUG_INFO, "Remaining blocks: %d RemainingSizeInBlock: 0x%x\n", RemainingBlocks, RemainingSizeInBlock));
       PayloadSize  = PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES];
       OffsetMax    = ERROR_LOG_INFO_BUFFER_SIZE - PayloadSize - sizeof (EFI_COMMON_ERROR_RECORD_HEADER);
@@ -2190,7 +2462,7 @@ E2ESimpleRecoveryReadTest (
     }
 
     RemainingBlocks--;
-    RemainingSizeInBlock = mErrorSerialization.BlockSize;
+    RemainingSizeInBlock = mErrorSerialization.DataSize;
   }
 
   //  DEBUG ((DEBUG_INFO, "Remaining blocks: %d RemainingSizeInBlock: 0x%x\n", RemainingBlocks, RemainingSizeInBlock));
@@ -2254,13 +2526,13 @@ E2ESimpleBootTest (
   E2ESimpleFillTest (Context);
 
   RemainingBlocks      = ErstSize/mErrorSerialization.BlockSize;
-  RemainingSizeInBlock = mErrorSerialization.BlockSize;
+  RemainingSizeInBlock = mErrorSerialization.DataSize;
   RecordId             = SizeIndex + ErstSize; // Pseudo-random value
   ReadRecordId         = ERST_FIRST_RECORD_ID;
   FirstRecordId        = RecordId;
 
   while (RemainingBlocks > 1) {
-    while (RemainingSizeInBlock >= PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES]) {
+    while (RemainingSizeInBlock >= (PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES] + sizeof (EFI_COMMON_ERROR_RECORD_HEADER))) {
       //      DEBUG ((DEBUG_INFO, "Remaining blocks: %d RemainingSizeInBlock: 0x%x\n", RemainingBlocks, RemainingSizeInBlock));
       PayloadSize  = PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES];
       OffsetMax    = ERROR_LOG_INFO_BUFFER_SIZE - PayloadSize - sizeof (EFI_COMMON_ERROR_RECORD_HEADER);
@@ -2281,7 +2553,7 @@ E2ESimpleBootTest (
     }
 
     RemainingBlocks--;
-    RemainingSizeInBlock = mErrorSerialization.BlockSize;
+    RemainingSizeInBlock = mErrorSerialization.DataSize;
   }
 
   UT_ASSERT_EQUAL (ErstComm->RecordID, FirstRecordId);
@@ -2385,12 +2657,12 @@ E2ESimpleClearTest (
     );
 
   RemainingBlocks      = ErstSize/mErrorSerialization.BlockSize;
-  RemainingSizeInBlock = mErrorSerialization.BlockSize;
+  RemainingSizeInBlock = mErrorSerialization.DataSize;
   RecordId             = SizeIndex + ErstSize; // Pseudo-random value
 
   //  DEBUG ((DEBUG_INFO, "Clearing Flash\n"));
   while (RemainingBlocks > 1) {
-    while (RemainingSizeInBlock >= PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES]) {
+    while (RemainingSizeInBlock >= (PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES] + sizeof (EFI_COMMON_ERROR_RECORD_HEADER))) {
       //      DEBUG ((DEBUG_INFO, "Remaining blocks: %d RemainingSizeInBlock: 0x%x\n", RemainingBlocks, RemainingSizeInBlock));
       PayloadSize  = PayloadSizes[SizeIndex%MAX_PAYLOAD_SIZES];
       OffsetMax    = ERROR_LOG_INFO_BUFFER_SIZE - PayloadSize - sizeof (EFI_COMMON_ERROR_RECORD_HEADER);
@@ -2410,7 +2682,7 @@ E2ESimpleClearTest (
     }
 
     RemainingBlocks--;
-    RemainingSizeInBlock = mErrorSerialization.BlockSize;
+    RemainingSizeInBlock = mErrorSerialization.DataSize;
   }
 
   //  DEBUG ((DEBUG_INFO, "Remaining blocks: %d RemainingSizeInBlock: 0x%x\n", RemainingBlocks, RemainingSizeInBlock));
@@ -2461,14 +2733,222 @@ EraseBlockWhileCollectingTest (
   Status = ErrorSerializationReInit ();
   UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
 
-  SetMem (TestBuffer, BLOCK_SIZE, 0xFF);
   for (int i = 0; i < NUM_BLOCKS; i++) {
-    UT_ASSERT_MEM_EQUAL (TestBuffer, TestFlashStorage+ TestInfo->ErstOffset + i*BLOCK_SIZE, BLOCK_SIZE);
+    UT_ASSERT_TRUE (IsBlockErased (TestFlashStorage + TestInfo->ErstOffset + i*BLOCK_SIZE));
   }
 
   return UTStatus;
 }
 
+/**
+  Test that FREE space that isn't erased is found while collecting a block,
+  and that the valid records in the block are moved so it can be erased
+
+  @param Context                      Used for the offsets and status value
+
+  @retval UNIT_TEST_PASSED            All assertions passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED An assertion failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DirtyFreeSpaceWhileCollectingTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                 Status;
+  COMMON_TEST_CONTEXT        *TestInfo;
+  UNIT_TEST_STATUS           UTStatus;
+  ERST_CPER_INFO             *CperInfo;
+  UINT8                      *DirtyByte;
+  ERST_BLOCK_INFO            *BlockInfo;
+  ERST_BLOCK_SUMMARY_HEADER  *Header;
+
+  TestInfo = (COMMON_TEST_CONTEXT *)Context;
+
+  E2EWrite (Context, 0x1234, 0x0, 0x100, 0xaa, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+
+  // Program a byte in the FREE space after the record
+  CperInfo   = &mErrorSerialization.CperInfo[0];
+  DirtyByte  = TestFlashStorage + TestInfo->ErstOffset + CperInfo->RecordOffset + CperInfo->RecordLength + 0x10;
+  *DirtyByte = 0x0;
+
+  // FREE space is only read when scanning a block, so abandon its summary
+  BlockInfo     = ErstGetBlockOfRecord (CperInfo);
+  Header        = (ERST_BLOCK_SUMMARY_HEADER *)(TestFlashStorage + TestInfo->ErstOffset + BlockInfo->Base + mErrorSerialization.DataSize);
+  Header->State = ERST_SUMMARY_STATE_ABANDONED;
+
+  MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
+  UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
+  UT_ASSERT_STATUS_EQUAL (UTStatus, UNIT_TEST_PASSED);
+  Status = ErrorSerializationReInit ();
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+
+  // The record was moved and its old block was erased
+  UT_ASSERT_EQUAL (*DirtyByte, 0xFF);
+  E2ERead (Context, 0x1234, 0x0, 0x100, 0xaa, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+
+  return SanityCheckTracking (Context);
+}
+
+/**
+  Test that a block's summary tracks its records, and that init uses the
+  summary instead of reading the whole block
+
+  @param Context                      Used for the offsets and status value
+
+  @retval UNIT_TEST_PASSED            All assertions passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED An assertion failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SummaryTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                 Status;
+  COMMON_TEST_CONTEXT        *TestInfo;
+  UNIT_TEST_STATUS           UTStatus;
+  ERST_CPER_INFO             *CperInfo;
+  ERST_BLOCK_INFO            *BlockInfo;
+  ERST_BLOCK_SUMMARY_HEADER  *Header;
+  ERST_BLOCK_SUMMARY_ENTRY   *Entries;
+  UINT32                     RecordLength;
+  UINT8                      *DirtyByte;
+
+  TestInfo = (COMMON_TEST_CONTEXT *)Context;
+
+  E2EWrite (Context, 0x1234, 0x0, 0x100, 0xaa, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+  E2EWrite (Context, 0x1235, 0x0, 0x100, 0xbb, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+  E2EClear (Context, 0x1234, 0x0, 0x100, 0xaa, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+
+  // The summary has an entry per record, in the order they were written
+  CperInfo     = ErstFindRecord (0x1235);
+  BlockInfo    = ErstGetBlockOfRecord (CperInfo);
+  Header       = (ERST_BLOCK_SUMMARY_HEADER *)(TestFlashStorage + TestInfo->ErstOffset + BlockInfo->Base + mErrorSerialization.DataSize);
+  Entries      = (ERST_BLOCK_SUMMARY_ENTRY *)(Header + 1);
+  RecordLength = sizeof (EFI_COMMON_ERROR_RECORD_HEADER) + 0x100;
+  UT_ASSERT_TRUE (BlockInfo->HasSummary);
+  UT_ASSERT_EQUAL (BlockInfo->SummaryCount, 2);
+  UT_ASSERT_EQUAL (Header->Signature, ERST_SUMMARY_SIGNATURE);
+  UT_ASSERT_EQUAL (Header->Version, ERST_SUMMARY_VERSION);
+  UT_ASSERT_EQUAL (Header->State, ERST_SUMMARY_STATE_ACTIVE);
+  UT_ASSERT_EQUAL (Header->EntryCount, mErrorSerialization.SummaryEntries);
+  UT_ASSERT_EQUAL (Entries[0].RecordId, 0x1234);
+  UT_ASSERT_EQUAL (Entries[0].RecordLength, RecordLength);
+  UT_ASSERT_EQUAL (Entries[0].Status, ERST_RECORD_STATUS_DELETED);
+  UT_ASSERT_EQUAL (Entries[1].RecordId, 0x1235);
+  UT_ASSERT_EQUAL (Entries[1].RecordLength, RecordLength);
+  UT_ASSERT_EQUAL (Entries[1].Status, ERST_RECORD_STATUS_VALID);
+  UT_ASSERT_TRUE (IsBufferValue ((UINT8 *)&Entries[2], sizeof (ERST_BLOCK_SUMMARY_ENTRY), 0xFF));
+
+  // Init doesn't read the FREE space of a block with a summary, so doesn't notice it's dirty
+  DirtyByte  = TestFlashStorage + TestInfo->ErstOffset + CperInfo->RecordOffset + CperInfo->RecordLength + 0x10;
+  *DirtyByte = 0x0;
+
+  MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
+  UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
+  UT_ASSERT_STATUS_EQUAL (UTStatus, UNIT_TEST_PASSED);
+  Status = ErrorSerializationReInit ();
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+
+  UT_ASSERT_EQUAL (*DirtyByte, 0x0);
+  *DirtyByte = 0xFF;
+  UT_ASSERT_EQUAL (mErrorSerialization.RecordCount, 1);
+  E2ERead (Context, 0x1235, 0x0, 0x100, 0xbb, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+  UTStatus = SanityCheckTracking (Context);
+  UT_ASSERT_STATUS_EQUAL (UTStatus, UNIT_TEST_PASSED);
+
+  // A reset between the record and its summary entry going VALID is caught up by init
+  Entries[1].Status = ERST_RECORD_STATUS_FREE;
+
+  MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
+  UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
+  UT_ASSERT_STATUS_EQUAL (UTStatus, UNIT_TEST_PASSED);
+  Status = ErrorSerializationReInit ();
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+
+  UT_ASSERT_EQUAL (Entries[1].Status, ERST_RECORD_STATUS_VALID);
+  UT_ASSERT_EQUAL (Header->State, ERST_SUMMARY_STATE_ACTIVE);
+  E2ERead (Context, 0x1235, 0x0, 0x100, 0xbb, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+
+  return SanityCheckTracking (Context);
+}
+
+/**
+  Test that init scans blocks without a summary or with a summary that
+  doesn't validate, and stops using a summary that doesn't validate
+
+  @param Context                      Used for the offsets and status value
+
+  @retval UNIT_TEST_PASSED            All assertions passed.
+  @retval UNIT_TEST_ERROR_TEST_FAILED An assertion failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SummaryFallbackTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                 Status;
+  COMMON_TEST_CONTEXT        *TestInfo;
+  UNIT_TEST_STATUS           UTStatus;
+  ERST_CPER_INFO             *CperInfo;
+  ERST_BLOCK_INFO            *BlockInfo;
+  ERST_BLOCK_SUMMARY_HEADER  *Header;
+  ERST_BLOCK_SUMMARY_ENTRY   *Entries;
+
+  TestInfo = (COMMON_TEST_CONTEXT *)Context;
+
+  E2EWrite (Context, 0x1234, 0x0, 0x100, 0xaa, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+  E2EWrite (Context, 0x1235, 0x0, 0x100, 0xbb, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+
+  CperInfo  = ErstFindRecord (0x1235);
+  BlockInfo = ErstGetBlockOfRecord (CperInfo);
+  Header    = (ERST_BLOCK_SUMMARY_HEADER *)(TestFlashStorage + TestInfo->ErstOffset + BlockInfo->Base + mErrorSerialization.DataSize);
+  Entries   = (ERST_BLOCK_SUMMARY_ENTRY *)(Header + 1);
+
+  // A summary entry that doesn't fit in the block is caught, and the block is scanned instead
+  Entries[1].RecordLength = mErrorSerialization.BlockSize;
+
+  MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
+  UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
+  UT_ASSERT_STATUS_EQUAL (UTStatus, UNIT_TEST_PASSED);
+  Status = ErrorSerializationReInit ();
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+
+  CperInfo  = ErstFindRecord (0x1235);
+  BlockInfo = ErstGetBlockOfRecord (CperInfo);
+  UT_ASSERT_FALSE (BlockInfo->HasSummary);
+  UT_ASSERT_EQUAL (BlockInfo->DataSize, mErrorSerialization.DataSize);
+  UT_ASSERT_EQUAL (Header->State, ERST_SUMMARY_STATE_ABANDONED);
+  E2ERead (Context, 0x1234, 0x0, 0x100, 0xaa, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+  E2ERead (Context, 0x1235, 0x0, 0x100, 0xbb, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+  UTStatus = SanityCheckTracking (Context);
+  UT_ASSERT_STATUS_EQUAL (UTStatus, UNIT_TEST_PASSED);
+
+  // A block written before summaries existed has no summary, and its records can use the whole block
+  SetMem (Header, mErrorSerialization.BlockSize - mErrorSerialization.DataSize, 0xFF);
+
+  MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
+  UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
+  UT_ASSERT_STATUS_EQUAL (UTStatus, UNIT_TEST_PASSED);
+  Status = ErrorSerializationReInit ();
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+
+  CperInfo  = ErstFindRecord (0x1235);
+  BlockInfo = ErstGetBlockOfRecord (CperInfo);
+  UT_ASSERT_FALSE (BlockInfo->HasSummary);
+  UT_ASSERT_EQUAL (BlockInfo->DataSize, mErrorSerialization.BlockSize);
+  UT_ASSERT_TRUE (IsBufferValue ((UINT8 *)Header, mErrorSerialization.BlockSize - mErrorSerialization.DataSize, 0xFF));
+  E2ERead (Context, 0x1234, 0x0, 0x100, 0xaa, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+  E2ERead (Context, 0x1235, 0x0, 0x100, 0xbb, EFI_ACPI_6_4_ERST_STATUS_SUCCESS);
+
+  return SanityCheckTracking (Context);
+}
+
 /**
   Various invalid input tests
 
@@ -2902,6 +3382,7 @@ IncomingOutgoingInvalidTest (
   // Mark it as invalid, and out of sync
   CperPI->Status = ERST_RECORD_STATUS_INVALID;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
   UT_ASSERT_STATUS_EQUAL (UTStatus, UNIT_TEST_PASSED);
@@ -2932,6 +3413,7 @@ IncomingOutgoingInvalidTest (
   // Mark it as incoming, and out of sync
   CperPI->Status = ERST_RECORD_STATUS_INCOMING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.IncomingCperInfo = CperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -2961,6 +3443,7 @@ IncomingOutgoingInvalidTest (
   // Mark it as incoming, and out of sync
   CperPI->Status = ERST_RECORD_STATUS_INCOMING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.IncomingCperInfo = CperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -2991,6 +3474,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx\n", RecordId));
   CperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = CperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3017,6 +3501,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx\n", RecordId));
   CperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = CperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3043,6 +3528,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx\n", RecordId));
   CperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = CperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3067,6 +3553,7 @@ IncomingOutgoingInvalidTest (
   DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx\n", RecordId));
   CperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = CperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3082,6 +3569,7 @@ IncomingOutgoingInvalidTest (
   DEBUG ((DEBUG_INFO, "VALID entry had ID 0x%llx\n", Cper->RecordID));
   Cper->RecordID     = RecordId;
   CperInfo->RecordId = RecordId;
+  SyncSummaries (Context);
 
   // Confirm that we get the VALID rather than the OUTGOING data when reading
   // And that the OUTGOING record has been deleted
@@ -3106,6 +3594,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx\n", RecordId));
   CperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = CperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3120,6 +3609,7 @@ IncomingOutgoingInvalidTest (
   PayloadSize        = Cper->RecordLength - sizeof (EFI_COMMON_ERROR_RECORD_HEADER);
   Cper->RecordID     = RecordId;
   CperInfo->RecordId = RecordId;
+  SyncSummaries (Context);
 
   // Confirm that we get the VALID rather than the OUTGOING data when reading
   // And that the OUTGOING record has been deleted
@@ -3144,6 +3634,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx\n", RecordId));
   CperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = CperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3158,6 +3649,7 @@ IncomingOutgoingInvalidTest (
   PayloadSize        = Cper->RecordLength - sizeof (EFI_COMMON_ERROR_RECORD_HEADER);
   Cper->RecordID     = RecordId;
   CperInfo->RecordId = RecordId;
+  SyncSummaries (Context);
 
   // Confirm that we get the VALID rather than the OUTGOING data when reading
   // And that the OUTGOING record has been deleted
@@ -3181,6 +3673,7 @@ IncomingOutgoingInvalidTest (
   DEBUG ((DEBUG_INFO, "INCOMING entry has ID 0x%llx\n", RecordId));
   CperPI->Status = ERST_RECORD_STATUS_INCOMING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.IncomingCperInfo = CperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3198,6 +3691,7 @@ IncomingOutgoingInvalidTest (
   DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx\n", OutgoingRecordId));
   CperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = CperInfo;
 
   // Confirm that INCOMING was invalidated and OUTGOING was moved
@@ -3223,6 +3717,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx and length 0x%llx\n", OutgoingRecordId, OutgoingCper->RecordLength));
   OutgoingCperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = OutgoingCperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3244,6 +3739,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "INCOMING entry has ID 0x%llx and length 0x%llx\n", RecordId, Cper->RecordLength));
   CperPI->Status = ERST_RECORD_STATUS_INCOMING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.IncomingCperInfo = CperInfo;
 
   SanityCheckTracking (Context);
@@ -3271,6 +3767,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx and length 0x%llx\n", OutgoingRecordId, OutgoingCper->RecordLength));
   OutgoingCperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = OutgoingCperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3303,6 +3800,7 @@ IncomingOutgoingInvalidTest (
   // Mark it as INCOMING, and out of sync
   CperPI->Status = ERST_RECORD_STATUS_INCOMING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.IncomingCperInfo = CperInfo;
 
   SanityCheckTracking (Context);
@@ -3354,6 +3852,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx and length 0x%llx\n", OutgoingRecordId, OutgoingCper->RecordLength));
   OutgoingCperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = OutgoingCperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3374,6 +3873,7 @@ IncomingOutgoingInvalidTest (
   // Mark INCOMING as INCOMING, and out of sync
   CperPI->Status = ERST_RECORD_STATUS_INCOMING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.IncomingCperInfo = CperInfo;
 
   SanityCheckTracking (Context);
@@ -3425,6 +3925,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx and length 0x%llx\n", OutgoingRecordId, OutgoingCper->RecordLength));
   OutgoingCperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = OutgoingCperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3445,6 +3946,7 @@ IncomingOutgoingInvalidTest (
   // Mark INCOMING as INCOMING, and out of sync
   CperPI->Status = ERST_RECORD_STATUS_INCOMING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.IncomingCperInfo = CperInfo;
 
   SanityCheckTracking (Context);
@@ -3501,6 +4003,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx and length 0x%llx\n", OutgoingRecordId, OutgoingCper->RecordLength));
   OutgoingCperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = OutgoingCperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3523,6 +4026,7 @@ IncomingOutgoingInvalidTest (
   // Mark INCOMING as INCOMING, and out of sync
   CperPI->Status = ERST_RECORD_STATUS_INCOMING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.IncomingCperInfo = CperInfo;
 
   SanityCheckTracking (Context);
@@ -3578,6 +4082,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx and length 0x%llx\n", OutgoingRecordId, OutgoingCper->RecordLength));
   OutgoingCperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = OutgoingCperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3600,6 +4105,7 @@ IncomingOutgoingInvalidTest (
   // Mark INCOMING as INCOMING, and out of sync
   CperPI->Status = ERST_RECORD_STATUS_INCOMING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.IncomingCperInfo = CperInfo;
 
   SanityCheckTracking (Context);
@@ -3655,6 +4161,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING entry has ID 0x%llx and length 0x%llx\n", OutgoingRecordId, OutgoingCper->RecordLength));
   OutgoingCperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = OutgoingCperInfo;
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
   UTStatus = UnitTestMockNorFlashProtocol (TestNorFlashProtocol, MockNorErstOffset, MockNorErstSize);
@@ -3672,8 +4179,8 @@ IncomingOutgoingInvalidTest (
     UT_ASSERT_TRUE (0);
   }
 
-  // Corrupt the last byte in the block
-  UINT8  *LastByte = (UINT8 *)Cper + (mErrorSerialization.BlockSize - CperInfo->RecordOffset%mErrorSerialization.BlockSize - 1);
+  // Corrupt the last byte of record space in the block
+  UINT8  *LastByte = (UINT8 *)Cper + (mErrorSerialization.DataSize - CperInfo->RecordOffset%mErrorSerialization.BlockSize - 1);
 
   // DEBUG ((DEBUG_INFO, "Cper 0x%p, LastByte 0x%p\n", Cper, LastByte));
   *LastByte = ~*LastByte;
@@ -3681,6 +4188,7 @@ IncomingOutgoingInvalidTest (
   // Mark INCOMING as INCOMING, and out of sync
   CperPI->Status = ERST_RECORD_STATUS_INCOMING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.IncomingCperInfo = CperInfo;
 
   SanityCheckTracking (Context);
@@ -3702,6 +4210,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "INCOMING address 0x%p\n", CperInfo));
   CperPI->Status = ERST_RECORD_STATUS_INCOMING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.IncomingCperInfo = CperInfo;
   Status                               = ErstDeallocateRecord (&mErrorSerialization.CperInfo[0]);
   UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
@@ -3718,6 +4227,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING address 0x%p\n", CperInfo));
   CperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = CperInfo;
   Status                               = ErstDeallocateRecord (&mErrorSerialization.CperInfo[0]);
   UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
@@ -3734,6 +4244,7 @@ IncomingOutgoingInvalidTest (
   // DEBUG ((DEBUG_INFO, "OUTGOING address 0x%p\n", CperInfo));
   CperPI->Status = ERST_RECORD_STATUS_OUTGOING;
   mErrorSerialization.UnsyncedSpinorChanges++;
+  SyncSummaries (Context);
   mErrorSerialization.OutgoingCperInfo = CperInfo;
   Status                               = ErstWriteRecord (Cper, NULL, CperInfo, FALSE);
   UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
@@ -3849,6 +4360,7 @@ ReclaimTest (
   OutgoingOffset                       = CperInfo->RecordOffset;
   OutgoingRecordId                     = CperInfo->RecordId;
   mErrorSerialization.OutgoingCperInfo = CperInfo;
+  SyncSummaries (Context);
   // DEBUG ((DEBUG_INFO, "TestCase -  Outgoing=0x%p, ID=0x%llx, Len=0x%llx, Offset=0x%llx\n", CperInfo, CperInfo->RecordId, CperInfo->RecordLength, CperInfo->RecordOffset));
 
   RecordId     = ErstComm->RecordID;
@@ -3858,7 +4370,7 @@ ReclaimTest (
 
   // Make sure there's enough space to replace
   BlockInfo   = ErstGetBlockOfRecord (CperInfo);
-  PayloadSize = MIN (PayloadSize, mErrorSerialization.BlockSize - BlockInfo->UsedSize - sizeof (EFI_COMMON_ERROR_RECORD_HEADER));
+  PayloadSize = MIN (PayloadSize, BlockInfo->DataSize - BlockInfo->UsedSize - sizeof (EFI_COMMON_ERROR_RECORD_HEADER));
 
   // DEBUG ((DEBUG_INFO, "TestCase -   Writing=0x%p, ID=0x%llx, Len=0x%llx, Offset=0x%llx\n", CperInfo, CperInfo->RecordId, CperInfo->RecordLength, CperInfo->RecordOffset));
   MockGetFirstGuidHob (&gNVIDIAStMMBuffersGuid, &StmmCommBuffersData);
@@ -3950,6 +4462,7 @@ WriteCperStatusTest (
   UINTN                           CheckSize;
   UINTN                           UnwrittenBeginBytes;
   UINTN                           UnwrittenEndBytes;
+  UINT32                          Index;
 
   TestInfo   = (COMMON_TEST_CONTEXT *)Context;
   TestCper   = (EFI_COMMON_ERROR_RECORD_HEADER *)(TestFlashStorage + TestInfo->ErstOffset + TestInfo->Offset);
@@ -3967,6 +4480,11 @@ WriteCperStatusTest (
     mErrorSerialization.OutgoingCperInfo = &CperInfo;
   }
 
+  // Only the record's Status byte is checked here, the summary updates are checked by SummaryTest
+  for (Index = 0; Index < mErrorSerialization.NumBlocks; Index++) {
+    mErrorSerialization.BlockInfo[Index].HasSummary = FALSE;
+  }
+
   CperInfo.RecordOffset = TestInfo->Offset;
   Status                = ErstWriteCperStatus (&StatusVal, &CperInfo);
 
@@ -5708,6 +6226,36 @@ UnitTestingEntry (
     &E2E_e0_i0_s2Block
     );
 
+  AddTestCase (
+    EraseBlockTestSuite,
+    "DirtyFreeSpaceWhileCollecting Test",
+    "Dirty free space while collecting",
+    DirtyFreeSpaceWhileCollectingTest,
+    E2EEmptyFlashSetup,
+    DefaultUnitTestCleanup,
+    &E2E_e0_i0_s2Block
+    );
+
+  AddTestCase (
+    EraseBlockTestSuite,
+    "Summary Test",
+    "Init from summary",
+    SummaryTest,
+    E2EEmptyFlashSetup,
+    DefaultUnitTestCleanup,
+    &E2E_e0_i0_s2Block
+    );
+
+  AddTestCase (
+    EraseBlockTestSuite,
+    "SummaryFallback Test",
+    "Init without a valid summary",
+    SummaryFallbackTest,
+    E2EEmptyFlashSetup,
+    DefaultUnitTestCleanup,
+    &E2E_e0_i0_s2Block
+    );
+
   // Populate the InitProtocol Unit Test Suite.
   Status = CreateUnitTestSuite (
              &InitProtocolTestSuite,
@@ -6259,6 +6807,16 @@ UnitTestingEntry (
     &E2E_e0_i0_sMax
     );
 
+  AddTestCase (
+    E2ETestSuite,
+    "E2E BatchDrain erst offset 0 index 0 size Max",
+    "E2E_e0_i0_sMax",
+    E2EBatchDrainTest,
+    E2EEmptyFlashSetup,
+    DefaultUnitTestCleanup,
+    &E2E_e0_i0_sMax
+    );
+
   AddTestCase (
     E2ETestSuite,
     "E2E SimpleFill erst offset 0 index 1 size 2Block",
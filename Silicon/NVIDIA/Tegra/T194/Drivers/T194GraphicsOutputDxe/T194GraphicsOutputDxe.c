@@ -47,6 +47,319 @@ STATIC CONST CHAR8  *mFbCarveoutPaths[] = {
   "/reserved-memory/fb3_carveout"
 };
 
+/**
+  Add a region to the dirty rectangles of the shadow frame buffer.
+
+  Rectangles that overlap or touch the region are merged with it. If there
+  is no room for another rectangle, it is merged with an existing one.
+
+  @param [in]  Instance          GOP instance
+  @param [in]  X                 Left of the region
+  @param [in]  Y                 Top of the region
+  @param [in]  Width             Width of the region
+  @param [in]  Height            Height of the region
+**/
+STATIC
+VOID
+GraphicsShadowAddDirty (
+  IN GOP_INSTANCE  *Instance,
+  IN UINTN         X,
+  IN UINTN         Y,
+  IN UINTN         Width,
+  IN UINTN         Height
+  )
+{
+  GOP_DIRTY_RECT  *Dirty;
+  UINTN           Index;
+  UINTN           Right;
+  UINTN           Bottom;
+
+  if ((Width == 0) || (Height == 0)) {
+    return;
+  }
+
+  Right  = X + Width;
+  Bottom = Y + Height;
+
+  Index = 0;
+  while (Index < Instance->DirtyCount) {
+    Dirty = &Instance->Dirty[Index];
+    if ((Instance->DirtyCount < GOP_SHADOW_MAX_DIRTY_RECTS) &&
+        ((X > Dirty->X + Dirty->Width) || (Dirty->X > Right) ||
+         (Y > Dirty->Y + Dirty->Height) || (Dirty->Y > Bottom)))
+    {
+      Index++;
+      continue;
+    }
+
+    Right  = MAX (Right, Dirty->X + Dirty->Width);
+    Bottom = MAX (Bottom, Dirty->Y + Dirty->Height);
+    X      = MIN (X, Dirty->X);
+    Y      = MIN (Y, Dirty->Y);
+
+    //
+    // The grown region may now touch rectangles already checked
+    //
+    Instance->DirtyCount--;
+    CopyMem (Dirty, &Instance->Dirty[Instance->DirtyCount], sizeof (*Dirty));
+    Index = 0;
+  }
+
+  Dirty         = &Instance->Dirty[Instance->DirtyCount++];
+  Dirty->X      = X;
+  Dirty->Y      = Y;
+  Dirty->Width  = Right - X;
+  Dirty->Height = Bottom - Y;
+}
+
+/**
+  Copy the dirty rectangles of the shadow frame buffer to the frame buffer.
+
+  Must be called at TPL_NOTIFY.
+
+  @param [in]  Instance          GOP instance
+**/
+STATIC
+VOID
+GraphicsShadowFlush (
+  IN GOP_INSTANCE  *Instance
+  )
+{
+  GOP_DIRTY_RECT  *Dirty;
+  UINTN           Index;
+
+  for (Index = 0; Index < Instance->DirtyCount; Index++) {
+    Dirty = &Instance->Dirty[Index];
+    FrameBufferBlt (
+      Instance->Configure,
+      Instance->ShadowBuffer,
+      EfiBltBufferToVideo,
+      Dirty->X,
+      Dirty->Y,
+      Dirty->X,
+      Dirty->Y,
+      Dirty->Width,
+      Dirty->Height,
+      Instance->ShadowPitch
+      );
+  }
+
+  Instance->DirtyCount = 0;
+}
+
+/**
+  Flush the shadow frame buffer now instead of waiting for the timer.
+
+  @param [in]  Instance          GOP instance
+**/
+STATIC
+VOID
+GraphicsShadowSync (
+  IN GOP_INSTANCE  *Instance
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (Instance->ShadowConfigure != NULL) {
+    GraphicsShadowFlush (Instance);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Timer callback flushing the shadow frame buffer.
+
+  @param [in]  Event             Timer event
+  @param [in]  Context           GOP instance
+**/
+STATIC
+VOID
+EFIAPI
+GraphicsShadowFlushTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  GOP_INSTANCE  *Instance;
+
+  Instance = (GOP_INSTANCE *)Context;
+  if (Instance->ShadowConfigure != NULL) {
+    GraphicsShadowFlush (Instance);
+  }
+}
+
+/**
+  Exit boot services callback: the OS takes over the frame buffer, so
+  flush the shadow one last time and stop using it.
+
+  @param [in]  Event             Exit boot services event
+  @param [in]  Context           GOP instance
+**/
+STATIC
+VOID
+EFIAPI
+GraphicsShadowExitBootServices (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  GOP_INSTANCE  *Instance;
+
+  Instance = (GOP_INSTANCE *)Context;
+  if (Instance->ShadowConfigure != NULL) {
+    GraphicsShadowFlush (Instance);
+    gBS->SetTimer (Instance->ShadowFlushEvent, TimerCancel, 0);
+    Instance->ShadowConfigure = NULL;
+  }
+}
+
+/**
+  Free the shadow frame buffer of a GOP instance.
+
+  @param [in]  Instance          GOP instance
+**/
+STATIC
+VOID
+GraphicsShadowFree (
+  IN GOP_INSTANCE  *Instance
+  )
+{
+  if (Instance->ShadowFlushEvent != NULL) {
+    gBS->CloseEvent (Instance->ShadowFlushEvent);
+    Instance->ShadowFlushEvent = NULL;
+  }
+
+  if (Instance->ShadowExitBootServicesEvent != NULL) {
+    gBS->CloseEvent (Instance->ShadowExitBootServicesEvent);
+    Instance->ShadowExitBootServicesEvent = NULL;
+  }
+
+  if (Instance->ShadowConfigure != NULL) {
+    FreePool (Instance->ShadowConfigure);
+    Instance->ShadowConfigure = NULL;
+  }
+
+  if (Instance->ShadowBuffer != NULL) {
+    FreePool (Instance->ShadowBuffer);
+    Instance->ShadowBuffer = NULL;
+  }
+
+  Instance->DirtyCount = 0;
+}
+
+/**
+  Set up a cached shadow of the active head's frame buffer.
+
+  Blt operations are done on the shadow and the regions they change are
+  copied to the write-combined frame buffer on a timer, so console output
+  and scrolling do not run at frame buffer speed.
+
+  @param [in]  Instance          GOP instance
+  @param [in]  HeadIndex         Active head index
+
+  @retval EFI_SUCCESS            Shadow frame buffer set up
+  @retval others                 Error occurred, Blt uses the frame buffer directly
+**/
+STATIC
+EFI_STATUS
+GraphicsShadowInit (
+  IN GOP_INSTANCE  *Instance,
+  IN INTN          HeadIndex
+  )
+{
+  EFI_STATUS              Status;
+  UINTN                   ConfigureSize;
+  FRAME_BUFFER_CONFIGURE  *ShadowConfigure;
+
+  CopyMem (&Instance->ShadowModeInfo, &Instance->ModeInfo[HeadIndex], sizeof (Instance->ShadowModeInfo));
+  Instance->ShadowModeInfo.PixelFormat = PixelBlueGreenRedReserved8BitPerColor;
+  Instance->ShadowPitch                = Instance->ShadowModeInfo.PixelsPerScanLine * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
+
+  Instance->ShadowBuffer = AllocatePool (Instance->ShadowPitch * Instance->ShadowModeInfo.VerticalResolution);
+  if (Instance->ShadowBuffer == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto exit;
+  }
+
+  ConfigureSize = 0;
+  Status        = FrameBufferBltConfigure (Instance->ShadowBuffer, &Instance->ShadowModeInfo, NULL, &ConfigureSize);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    if (!EFI_ERROR (Status)) {
+      Status = EFI_DEVICE_ERROR;
+    }
+
+    goto exit;
+  }
+
+  ShadowConfigure = (FRAME_BUFFER_CONFIGURE *)AllocatePool (ConfigureSize);
+  if (ShadowConfigure == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto exit;
+  }
+
+  Status = FrameBufferBltConfigure (Instance->ShadowBuffer, &Instance->ShadowModeInfo, ShadowConfigure, &ConfigureSize);
+  if (EFI_ERROR (Status)) {
+    FreePool (ShadowConfigure);
+    goto exit;
+  }
+
+  // start from what is on the screen
+  Status = FrameBufferBlt (
+             Instance->Configure,
+             Instance->ShadowBuffer,
+             EfiBltVideoToBltBuffer,
+             0,
+             0,
+             0,
+             0,
+             Instance->ShadowModeInfo.HorizontalResolution,
+             Instance->ShadowModeInfo.VerticalResolution,
+             Instance->ShadowPitch
+             );
+  if (EFI_ERROR (Status)) {
+    FreePool (ShadowConfigure);
+    goto exit;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  GraphicsShadowFlushTimer,
+                  Instance,
+                  &Instance->ShadowFlushEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    FreePool (ShadowConfigure);
+    goto exit;
+  }
+
+  Status = gBS->CreateEventEx (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  GraphicsShadowExitBootServices,
+                  Instance,
+                  &gEfiEventExitBootServicesGuid,
+                  &Instance->ShadowExitBootServicesEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    FreePool (ShadowConfigure);
+    goto exit;
+  }
+
+  Instance->ShadowConfigure = ShadowConfigure;
+
+  Status = gBS->SetTimer (Instance->ShadowFlushEvent, TimerPeriodic, GOP_SHADOW_FLUSH_PERIOD);
+
+exit:
+  if (EFI_ERROR (Status)) {
+    GraphicsShadowFree (Instance);
+  }
+
+  return Status;
+}
+
 /** GraphicsOutput Protocol function, mapping to
   EFI_GRAPHICS_OUTPUT_PROTOCOL.QueryMode
 **/
@@ -104,6 +417,9 @@ GraphicsSetMode (
 {
   EFI_STATUS                     Status;
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL  FillColour;
+  GOP_INSTANCE                   *Instance;
+
+  Instance = GOP_INSTANCE_FROM_GOP_THIS (This);
 
   // Check if this mode is supported
   if (ModeNumber >= This->Mode->MaxMode) {
@@ -134,6 +450,9 @@ GraphicsSetMode (
                    0
                    );
 
+  // make the cleared screen visible right away
+  GraphicsShadowSync (Instance);
+
   return Status;
 }
 
@@ -159,21 +478,48 @@ GraphicsBlt (
   )
 {
   GOP_INSTANCE  *Instance;
+  EFI_STATUS    Status;
+  EFI_TPL       OldTpl;
 
   Instance = GOP_INSTANCE_FROM_GOP_THIS (This);
 
-  return FrameBufferBlt (
-           Instance->Configure,
-           BltBuffer,
-           BltOperation,
-           SourceX,
-           SourceY,
-           DestinationX,
-           DestinationY,
-           Width,
-           Height,
-           Delta
-           );
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  if (Instance->ShadowConfigure == NULL) {
+    Status = FrameBufferBlt (
+               Instance->Configure,
+               BltBuffer,
+               BltOperation,
+               SourceX,
+               SourceY,
+               DestinationX,
+               DestinationY,
+               Width,
+               Height,
+               Delta
+               );
+  } else {
+    // reads are served from the shadow, writes are flushed by the timer
+    Status = FrameBufferBlt (
+               Instance->ShadowConfigure,
+               BltBuffer,
+               BltOperation,
+               SourceX,
+               SourceY,
+               DestinationX,
+               DestinationY,
+               Width,
+               Height,
+               Delta
+               );
+    if (!EFI_ERROR (Status) && (BltOperation != EfiBltVideoToBltBuffer)) {
+      GraphicsShadowAddDirty (Instance, DestinationX, DestinationY, Width, Height);
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
 }
 
 /***************************************
@@ -924,6 +1270,12 @@ UpdateGopInfoForThisHead (
       Private->Gop.SetMode   = GraphicsSetMode;
       Private->Gop.Blt       = GraphicsBlt;
       Private->Gop.Mode      = &Private->Mode[HeadIndex];
+
+      Status = GraphicsShadowInit (Private, HeadIndex);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "%a: no shadow frame buffer, Blt will write the frame buffer directly: %r\n", __FUNCTION__, Status));
+        Status = EFI_SUCCESS;
+      }
     }
   }
 
@@ -1132,6 +1484,7 @@ DeviceDiscoveryNotify (
         Private->Mode[HeadIndex].FrameBufferSize = 0;
       }
 
+      GraphicsShadowFree (Private);
       FreePool (Private);
     }
   }
@@ -1,6 +1,6 @@
 /** @file
 
-  Copyright (c) 2022, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+  Copyright (c) 2022-2023, NVIDIA CORPORATION & AFFILIATES. All rights reserved.
   Copyright (c) 2011-2018, ARM Ltd. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -60,11 +60,21 @@
 #define WIN_CROPPED_SIZE_IN_MIN_WIDTH   800
 #define WIN_CROPPED_SIZE_IN_MIN_HEIGHT  600
 
+#define GOP_SHADOW_FLUSH_PERIOD     EFI_TIMER_PERIOD_MILLISECONDS (20)
+#define GOP_SHADOW_MAX_DIRTY_RECTS  8
+
 typedef enum _WindowState {
   WindowStateUsable,
   WindowStateEnabled
 } WindowState;
 
+typedef struct {
+  UINTN    X;
+  UINTN    Y;
+  UINTN    Width;
+  UINTN    Height;
+} GOP_DIRTY_RECT;
+
 typedef struct {
   UINT32                                  Signature;
   INTN                                    ActiveHeadIndex;
@@ -75,6 +85,18 @@ typedef struct {
   EFI_GRAPHICS_OUTPUT_PROTOCOL            Gop;
   FRAME_BUFFER_CONFIGURE                  *Configure;
   EFI_PHYSICAL_ADDRESS                    DcAddr[DC_HEAD_INDEX_MAX+1];
+
+  // cached shadow of the active frame buffer, in BLT pixel format
+  EFI_GRAPHICS_OUTPUT_MODE_INFORMATION    ShadowModeInfo;
+  FRAME_BUFFER_CONFIGURE                  *ShadowConfigure;
+  VOID                                    *ShadowBuffer;
+  UINTN                                   ShadowPitch;
+  EFI_EVENT                               ShadowFlushEvent;
+  EFI_EVENT                               ShadowExitBootServicesEvent;
+
+  // regions of the shadow not yet flushed to the frame buffer
+  UINTN                                   DirtyCount;
+  GOP_DIRTY_RECT                          Dirty[GOP_SHADOW_MAX_DIRTY_RECTS];
 } GOP_INSTANCE;
 
 #define GOP_INSTANCE_SIGNATURE  SIGNATURE_32('g', 'o', 'p', '0')